@@ -0,0 +1,90 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/checksum.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Compares fossil_net_checksum with the textbook RFC 1071 loop over a range
+ * of payload sizes. Prints ns/op and GB/s for both sides and the speedup.
+ */
+
+#define BYTES_PER_SIZE (256u * 1024u * 1024u)
+
+static volatile uint32_t bench_sink;
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint16_t bench_rfc1071(const uint8_t *p, size_t len)
+{
+    uint32_t sum = 0;
+    while (len > 1) {
+        sum += (uint32_t)((p[0] << 8) | p[1]);
+        p += 2;
+        len -= 2;
+    }
+    if (len) sum += (uint32_t)(p[0] << 8);
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+int main(void)
+{
+    static const size_t sizes[] = { 20, 64, 512, 1500, 9000, 65535 };
+    static uint8_t buf[65536];
+    uint32_t seed = 0x9e3779b9u;
+
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        size_t len = sizes[s];
+        uint32_t iterations = (uint32_t)(BYTES_PER_SIZE / len);
+        double t0, ours, ref;
+
+        t0 = bench_now_ns();
+        for (uint32_t i = 0; i < iterations; ++i)
+            bench_sink += fossil_net_checksum(buf + (i & 1), len);
+        ours = bench_now_ns() - t0;
+        t0 = bench_now_ns();
+        for (uint32_t i = 0; i < iterations; ++i)
+            bench_sink += bench_rfc1071(buf + (i & 1), len);
+        ref = bench_now_ns() - t0;
+
+        printf("%6zu bytes  fossil %8.1f ns/op %6.2f GB/s   rfc1071 %8.1f ns/op %6.2f GB/s   speedup %5.2fx\n",
+               len, ours / iterations, (double)BYTES_PER_SIZE / ours,
+               ref / iterations, (double)BYTES_PER_SIZE / ref, ref / ours);
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/inet.h"
+
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Compares the table-driven routines in inet.c with the libc calls they
+ * replace. Prints ns/op for both sides and the speedup.
+ */
+
+#define ITERATIONS 2000000u
+#define SAMPLES    256u
+
+static volatile uint32_t bench_sink;
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void bench_report(const char *name, double ours, double libc)
+{
+    printf("%-14s fossil %7.2f ns/op   libc %7.2f ns/op   speedup %5.2fx\n",
+           name, ours / ITERATIONS, libc / ITERATIONS, libc / ours);
+}
+
+int main(void)
+{
+    static uint8_t v4[SAMPLES][4], v6[SAMPLES][16], mac[SAMPLES][6];
+    static char v4s[SAMPLES][16], v6s[SAMPLES][46], macs[SAMPLES][18];
+    uint32_t seed = 0x9e3779b9u;
+
+    for (uint32_t i = 0; i < SAMPLES; ++i) {
+        for (int b = 0; b < 16; ++b) {
+            seed = seed * 1664525u + 1013904223u;
+            v6[i][b] = (seed >> 28) < 6 ? 0 : (uint8_t)(seed >> 16);
+        }
+        memcpy(v4[i], v6[i] + 4, 4);
+        memcpy(mac[i], v6[i] + 8, 6);
+        inet_ntop(AF_INET, v4[i], v4s[i], sizeof(v4s[i]));
+        inet_ntop(AF_INET6, v6[i], v6s[i], sizeof(v6s[i]));
+        fossil_net_inet_mac_format(mac[i], macs[i], sizeof(macs[i]));
+    }
+
+    char buf[64];
+    uint8_t out[16];
+    unsigned int b[6];
+    double t0, ours, libc;
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)fossil_net_inet_ipv4_format(v4[i % SAMPLES], buf, sizeof(buf));
+    ours = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)(uintptr_t)inet_ntop(AF_INET, v4[i % SAMPLES], buf, sizeof(buf));
+    libc = bench_now_ns() - t0;
+    bench_report("ipv4 format", ours, libc);
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)fossil_net_inet_ipv4_parse(v4s[i % SAMPLES], out);
+    ours = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)inet_pton(AF_INET, v4s[i % SAMPLES], out);
+    libc = bench_now_ns() - t0;
+    bench_report("ipv4 parse", ours, libc);
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)fossil_net_inet_ipv6_format(v6[i % SAMPLES], buf, sizeof(buf));
+    ours = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)(uintptr_t)inet_ntop(AF_INET6, v6[i % SAMPLES], buf, sizeof(buf));
+    libc = bench_now_ns() - t0;
+    bench_report("ipv6 format", ours, libc);
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)fossil_net_inet_ipv6_parse(v6s[i % SAMPLES], out);
+    ours = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)inet_pton(AF_INET6, v6s[i % SAMPLES], out);
+    libc = bench_now_ns() - t0;
+    bench_report("ipv6 parse", ours, libc);
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)fossil_net_inet_mac_format(mac[i % SAMPLES], buf, sizeof(buf));
+    ours = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i) {
+        const uint8_t *m = mac[i % SAMPLES];
+        bench_sink += (uint32_t)snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X",
+                                         m[0], m[1], m[2], m[3], m[4], m[5]);
+    }
+    libc = bench_now_ns() - t0;
+    bench_report("mac format", ours, libc);
+
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)fossil_net_inet_mac_parse(macs[i % SAMPLES], out);
+    ours = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        bench_sink += (uint32_t)sscanf(macs[i % SAMPLES], "%2x:%2x:%2x:%2x:%2x:%2x",
+                                       &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]);
+    libc = bench_now_ns() - t0;
+    bench_report("mac parse", ours, libc);
+
+    return 0;
+}
@@ -0,0 +1,280 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/builder.h"
+
+#include <string.h>
+
+#define FOSSIL__BUILDER_NONE 0xffffu
+#define FOSSIL__ETH_LEN      14u
+#define FOSSIL__IPV4_LEN     20u
+#define FOSSIL__IPV6_LEN     40u
+#define FOSSIL__UDP_LEN      8u
+#define FOSSIL__TCP_LEN      20u
+#define FOSSIL__ICMP_LEN     8u
+
+static void fossil__put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void fossil__put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint16_t fossil__get16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint8_t *fossil__builder_push(fossil_net_builder_t *b, uint32_t len) {
+    if (len > b->capacity - b->length) return NULL;
+    uint8_t *p = b->buffer + b->length;
+    memset(p, 0, len);
+    b->length += len;
+    b->finished = 0;
+    return p;
+}
+
+int fossil_net_builder_init(fossil_net_builder_t *builder, void *buffer, uint32_t capacity) {
+    if (!builder || !buffer) return -1;
+    memset(builder, 0, sizeof(*builder));
+    builder->buffer = buffer;
+    builder->capacity = capacity;
+    builder->l3_offset = FOSSIL__BUILDER_NONE;
+    builder->l4_offset = FOSSIL__BUILDER_NONE;
+    return 0;
+}
+
+int fossil_net_builder_ethernet(fossil_net_builder_t *builder, const fossil_net_mac_t *src, const fossil_net_mac_t *dst, uint16_t ethertype) {
+    if (!builder || !src || !dst || builder->length != 0) return -1;
+    uint8_t *p = fossil__builder_push(builder, FOSSIL__ETH_LEN);
+    if (!p) return -1;
+    memcpy(p, dst->bytes, 6);
+    memcpy(p + 6, src->bytes, 6);
+    fossil__put16(p + 12, ethertype);
+    builder->has_eth = 1;
+    return 0;
+}
+
+int fossil_net_builder_ip(fossil_net_builder_t *builder, const fossil_net_endpoint_t *src, const fossil_net_endpoint_t *dst, uint8_t proto, uint8_t ttl) {
+    if (!builder || !src || !dst || src->family != dst->family) return -1;
+    if (builder->l3_offset != FOSSIL__BUILDER_NONE) return -1;
+    if (builder->length != (builder->has_eth ? FOSSIL__ETH_LEN : 0)) return -1;
+
+    uint16_t ethertype;
+    uint8_t *p;
+    uint32_t at = builder->length;
+    if (src->family == FOSSIL_NET_SOCKET_FAMILY_IPV4) {
+        if (!(p = fossil__builder_push(builder, FOSSIL__IPV4_LEN))) return -1;
+        p[0] = 0x45;
+        fossil__put16(p + 6, 0x4000); // DF
+        p[8] = ttl;
+        p[9] = proto;
+        memcpy(p + 12, src->ip, 4);
+        memcpy(p + 16, dst->ip, 4);
+        builder->ip_version = 4;
+        ethertype = 0x0800;
+    } else if (src->family == FOSSIL_NET_SOCKET_FAMILY_IPV6) {
+        if (!(p = fossil__builder_push(builder, FOSSIL__IPV6_LEN))) return -1;
+        p[0] = 0x60;
+        p[6] = proto;
+        p[7] = ttl;
+        memcpy(p + 8, src->ip, 16);
+        memcpy(p + 24, dst->ip, 16);
+        builder->ip_version = 6;
+        ethertype = 0x86DD;
+    } else {
+        return -1;
+    }
+    builder->l3_offset = (uint16_t)at;
+    builder->ip_proto = proto;
+    if (builder->has_eth && fossil__get16(builder->buffer + 12) == 0)
+        fossil__put16(builder->buffer + 12, ethertype);
+    return 0;
+}
+
+/* Transport headers sit directly after the IP header and set its protocol. */
+static uint8_t *fossil__builder_l4(fossil_net_builder_t *b, uint8_t proto, uint32_t len) {
+    if (b->l3_offset == FOSSIL__BUILDER_NONE || b->l4_offset != FOSSIL__BUILDER_NONE) return NULL;
+    uint32_t l3_len = b->ip_version == 4 ? FOSSIL__IPV4_LEN : FOSSIL__IPV6_LEN;
+    if (b->length != b->l3_offset + l3_len) return NULL;
+    uint32_t at = b->length;
+    uint8_t *p = fossil__builder_push(b, len);
+    if (!p) return NULL;
+    b->l4_offset = (uint16_t)at;
+    b->ip_proto = proto;
+    b->buffer[b->l3_offset + (b->ip_version == 4 ? 9 : 6)] = proto;
+    return p;
+}
+
+int fossil_net_builder_udp(fossil_net_builder_t *builder, uint16_t src_port, uint16_t dst_port) {
+    if (!builder) return -1;
+    uint8_t *p = fossil__builder_l4(builder, 17, FOSSIL__UDP_LEN);
+    if (!p) return -1;
+    fossil__put16(p, src_port);
+    fossil__put16(p + 2, dst_port);
+    return 0;
+}
+
+int fossil_net_builder_tcp(fossil_net_builder_t *builder, uint16_t src_port, uint16_t dst_port, uint32_t seq, uint32_t ack, uint8_t flags, uint16_t window) {
+    if (!builder) return -1;
+    uint8_t *p = fossil__builder_l4(builder, 6, FOSSIL__TCP_LEN);
+    if (!p) return -1;
+    fossil__put16(p, src_port);
+    fossil__put16(p + 2, dst_port);
+    fossil__put32(p + 4, seq);
+    fossil__put32(p + 8, ack);
+    p[12] = (FOSSIL__TCP_LEN / 4) << 4;
+    p[13] = flags;
+    fossil__put16(p + 14, window);
+    return 0;
+}
+
+int fossil_net_builder_icmp(fossil_net_builder_t *builder, uint8_t type, uint8_t code, uint16_t identifier, uint16_t sequence) {
+    if (!builder || builder->l3_offset == FOSSIL__BUILDER_NONE) return -1;
+    uint8_t *p = fossil__builder_l4(builder, builder->ip_version == 4 ? 1 : 58, FOSSIL__ICMP_LEN);
+    if (!p) return -1;
+    p[0] = type;
+    p[1] = code;
+    fossil__put16(p + 4, identifier);
+    fossil__put16(p + 6, sequence);
+    return 0;
+}
+
+uint8_t *fossil_net_builder_payload(fossil_net_builder_t *builder, const void *data, uint32_t length) {
+    if (!builder) return NULL;
+    uint8_t *p = fossil__builder_push(builder, length);
+    if (p && data && length) memcpy(p, data, length);
+    return p;
+}
+
+/* Offset of the transport checksum within its header, 0 if it has none. */
+static uint32_t fossil__builder_l4_check(const fossil_net_builder_t *b) {
+    switch (b->ip_proto) {
+        case 6: return 16;
+        case 17: return 6;
+        case 1:
+        case 58: return 2;
+        default: return 0;
+    }
+}
+
+static int fossil__builder_l4_pseudo(const fossil_net_builder_t *b) {
+    return b->ip_proto == 6 || b->ip_proto == 17 || (b->ip_proto == 58 && b->ip_version == 6);
+}
+
+int fossil_net_builder_finish(fossil_net_builder_t *builder, uint32_t *length) {
+    if (!builder) return -1;
+    uint8_t *buf = builder->buffer;
+
+    if (builder->l3_offset != FOSSIL__BUILDER_NONE) {
+        uint8_t *ip = buf + builder->l3_offset;
+        uint32_t ip_len = builder->length - builder->l3_offset;
+        if (builder->ip_version == 4) {
+            if (ip_len > 0xffff) return -1;
+            fossil__put16(ip + 2, (uint16_t)ip_len);
+            fossil__put16(ip + 10, 0);
+            fossil__put16(ip + 10, fossil_net_checksum(ip, FOSSIL__IPV4_LEN));
+        } else {
+            if (ip_len - FOSSIL__IPV6_LEN > 0xffff) return -1;
+            fossil__put16(ip + 4, (uint16_t)(ip_len - FOSSIL__IPV6_LEN));
+        }
+    }
+
+    if (builder->l4_offset != FOSSIL__BUILDER_NONE) {
+        uint8_t *ip = buf + builder->l3_offset;
+        uint8_t *l4 = buf + builder->l4_offset;
+        uint32_t l4_len = builder->length - builder->l4_offset;
+        uint32_t check = fossil__builder_l4_check(builder);
+        uint32_t sum = 0;
+        if (builder->ip_proto == 17) fossil__put16(l4 + 4, (uint16_t)l4_len);
+        if (fossil__builder_l4_pseudo(builder)) {
+            sum = builder->ip_version == 4
+                ? fossil_net_checksum_pseudo_ipv4(ip + 12, ip + 16, builder->ip_proto, (uint16_t)l4_len)
+                : fossil_net_checksum_pseudo_ipv6(ip + 8, ip + 24, builder->ip_proto, l4_len);
+        }
+        fossil__put16(l4 + check, 0);
+        uint16_t csum = fossil_net_checksum_finish(fossil_net_checksum_partial(l4, l4_len, sum));
+        // A computed UDP checksum of zero is sent as all ones (RFC 768)
+        if (builder->ip_proto == 17 && csum == 0) csum = 0xffff;
+        fossil__put16(l4 + check, csum);
+    }
+
+    builder->finished = 1;
+    if (length) *length = builder->length;
+    return 0;
+}
+
+/* Apply a field change to the checksum at check_at; odd-aligned fields contribute byte swapped. */
+static void fossil__builder_adjust(fossil_net_builder_t *b, uint32_t check_at, uint32_t rel, uint16_t old_value, uint16_t new_value, int udp) {
+    uint8_t *c = b->buffer + check_at;
+    uint16_t check = fossil__get16(c);
+    if (udp && check == 0) return; // checksum disabled
+    if (rel & 1) {
+        old_value = (uint16_t)((old_value >> 8) | (old_value << 8));
+        new_value = (uint16_t)((new_value >> 8) | (new_value << 8));
+    }
+    check = fossil_net_checksum_update16(check, old_value, new_value);
+    if (udp && check == 0) check = 0xffff;
+    fossil__put16(c, check);
+}
+
+int fossil_net_builder_patch16(fossil_net_builder_t *builder, uint32_t offset, uint16_t value) {
+    if (!builder || !builder->finished || offset > builder->length || builder->length - offset < 2) return -1;
+
+    uint8_t *field = builder->buffer + offset;
+    uint16_t old_value = fossil__get16(field);
+    if (old_value == value) return 0;
+
+    uint32_t l3 = builder->l3_offset;
+    uint32_t l4 = builder->l4_offset;
+    uint32_t l4_check = l4 != FOSSIL__BUILDER_NONE ? l4 + fossil__builder_l4_check(builder) : 0;
+    uint32_t l3_end = l3 + (builder->ip_version == 4 ? FOSSIL__IPV4_LEN : FOSSIL__IPV6_LEN);
+    int udp = builder->ip_proto == 17;
+    if (udp && offset == l4 + 4) return -1; // also in the pseudo-header; rebuild with finish
+    fossil__put16(field, value);
+
+    if (l3 != FOSSIL__BUILDER_NONE && offset >= l3 && offset < l3_end) {
+        int in_pseudo = 0;
+        if (builder->ip_version == 4) {
+            if (offset == l3 + 10) return 0;
+            fossil__builder_adjust(builder, l3 + 10, offset - l3, old_value, value, 0);
+            in_pseudo = offset >= l3 + 12;
+        } else {
+            in_pseudo = offset >= l3 + 8;
+        }
+        if (in_pseudo && l4 != FOSSIL__BUILDER_NONE && fossil__builder_l4_pseudo(builder))
+            fossil__builder_adjust(builder, l4_check, offset - l3, old_value, value, udp);
+        return 0;
+    }
+
+    if (l4 != FOSSIL__BUILDER_NONE && offset >= l4 && l4_check != l4) {
+        if (offset == l4_check) return 0;
+        fossil__builder_adjust(builder, l4_check, offset - l4, old_value, value, udp);
+    }
+    return 0;
+}
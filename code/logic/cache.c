@@ -0,0 +1,655 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/cache.h"
+#include "fossil/network/socket.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef CRITICAL_SECTION fossil__cache_mutex_t;
+#define fossil__cache_mutex_init(m)    InitializeCriticalSection(m)
+#define fossil__cache_mutex_destroy(m) DeleteCriticalSection(m)
+#define fossil__cache_mutex_lock(m)    EnterCriticalSection(m)
+#define fossil__cache_mutex_unlock(m)  LeaveCriticalSection(m)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t fossil__cache_mutex_t;
+#define fossil__cache_mutex_init(m)    pthread_mutex_init(m, NULL)
+#define fossil__cache_mutex_destroy(m) pthread_mutex_destroy(m)
+#define fossil__cache_mutex_lock(m)    pthread_mutex_lock(m)
+#define fossil__cache_mutex_unlock(m)  pthread_mutex_unlock(m)
+#endif
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+#define FOSSIL__CACHE_MAX_BYTES (64ull * 1024u * 1024u)
+#define FOSSIL__CACHE_SHARDS    16u
+#define FOSSIL__CACHE_MAX_ENTRY (1024u * 1024u)
+#define FOSSIL__CACHE_MAX_VARY  8u
+#define FOSSIL__CACHE_ROWS      4u
+#define FOSSIL__CACHE_AVG_ENTRY 4096u  /* sizes the sketch from the budget */
+
+typedef struct fossil__cache_entry
+{
+    struct fossil__cache_entry *hnext;
+    struct fossil__cache_entry *prev;   /* LRU, most recent first */
+    struct fossil__cache_entry *next;
+    fossil_net_buf_t *buf;              /* 200 head, 304 head, body */
+    uint64_t hash;
+    uint64_t stored_ns;
+    uint64_t expires_ns;
+    uint64_t charge;
+    uint32_t head_len;
+    uint32_t nm_off;
+    uint32_t nm_len;
+    uint32_t body_off;
+    uint32_t body_len;
+    uint32_t key_len;
+    uint32_t etag_len;
+    uint32_t modified_len;
+    char key[];                         /* key, ETag, Last-Modified, each NUL-terminated */
+} fossil__cache_entry_t;
+
+typedef struct fossil__cache_shard
+{
+    fossil__cache_mutex_t lock;
+    fossil__cache_entry_t **buckets;
+    uint32_t mask;
+    uint32_t count;
+    uint64_t bytes;
+    fossil__cache_entry_t *lru_head;
+    fossil__cache_entry_t *lru_tail;
+    uint8_t *sketch;                    /* FOSSIL__CACHE_ROWS rows of 4-bit counters, one per byte */
+    uint32_t width;
+    uint32_t samples;                   /* increments since the last halving */
+    char pad[64];
+} fossil__cache_shard_t;
+
+struct fossil_net_cache
+{
+    fossil__cache_shard_t *shards;
+    uint32_t shard_count;
+    uint32_t max_entry;
+    uint64_t budget;                    /* per shard */
+    uint64_t default_ttl_ns;
+    uint32_t vary_count;
+    char *vary[FOSSIL__CACHE_MAX_VARY];
+    _Atomic uint64_t hits;
+    _Atomic uint64_t misses;
+    _Atomic uint64_t not_modified;
+    _Atomic uint64_t stores;
+    _Atomic uint64_t uncacheable;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t evictions;
+    _Atomic uint64_t expired;
+};
+
+static inline void fossil__cache_count(_Atomic uint64_t *c, uint64_t n) {
+    atomic_fetch_add_explicit(c, n, memory_order_relaxed);
+}
+
+static uint64_t fossil__cache_hash(const char *s, size_t n) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (uint8_t)s[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static inline char fossil__cache_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+static bool fossil__cache_ieq(const char *a, size_t alen, const char *b) {
+    size_t blen = strlen(b);
+    if (alen != blen) return false;
+    for (size_t i = 0; i < alen; i++)
+        if (fossil__cache_lower(a[i]) != fossil__cache_lower(b[i])) return false;
+    return true;
+}
+
+/*
+ * Find a directive in a comma-separated header value; *arg receives a
+ * numeric argument when there is one.
+ */
+static bool fossil__cache_directive(const char *v, size_t len, const char *name, uint64_t *arg) {
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && (v[i] == ' ' || v[i] == '\t' || v[i] == ',')) i++;
+        size_t s = i;
+        while (i < len && v[i] != ',' && v[i] != '=' && v[i] != ' ') i++;
+        bool match = fossil__cache_ieq(v + s, i - s, name);
+        while (i < len && v[i] == ' ') i++;
+        if (i < len && v[i] == '=') {
+            i++;
+            if (i < len && v[i] == '"') i++;
+            uint64_t n = 0;
+            bool digits = false;
+            while (i < len && v[i] >= '0' && v[i] <= '9') {
+                if (n < UINT64_MAX / 20u) n = n * 10u + (uint64_t)(v[i] - '0');
+                digits = true;
+                i++;
+            }
+            if (match && arg && digits) *arg = n;
+            while (i < len && v[i] != ',') i++;
+        }
+        if (match) return true;
+    }
+    return false;
+}
+
+/*=============================================================================
+ADMISSION SKETCH
+=============================================================================*/
+
+static inline uint32_t fossil__cache_slot(const fossil__cache_shard_t *s, uint64_t hash, uint32_t row) {
+    static const uint64_t seeds[FOSSIL__CACHE_ROWS] = {
+        0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full, 0x165667b19e3779f9ull, 0xd6e8feb86659fd93ull
+    };
+    return row * s->width + (uint32_t)((hash * seeds[row]) >> 40) % s->width;
+}
+
+static void fossil__cache_touch(fossil__cache_shard_t *s, uint64_t hash) {
+    for (uint32_t r = 0; r < FOSSIL__CACHE_ROWS; r++) {
+        uint8_t *c = &s->sketch[fossil__cache_slot(s, hash, r)];
+        if (*c < 15u) (*c)++;
+    }
+    /* Age: halve every counter so the sketch follows a moving window. */
+    if (++s->samples >= s->width * 10u) {
+        for (uint32_t i = 0; i < s->width * FOSSIL__CACHE_ROWS; i++)
+            s->sketch[i] >>= 1;
+        s->samples = 0;
+    }
+}
+
+static uint32_t fossil__cache_frequency(const fossil__cache_shard_t *s, uint64_t hash) {
+    uint32_t f = 15u;
+    for (uint32_t r = 0; r < FOSSIL__CACHE_ROWS; r++) {
+        uint8_t c = s->sketch[fossil__cache_slot(s, hash, r)];
+        if (c < f) f = c;
+    }
+    return f;
+}
+
+/*=============================================================================
+ENTRIES
+=============================================================================*/
+
+static fossil__cache_shard_t *fossil__cache_shard(fossil_net_cache_t *c, uint64_t hash) {
+    return &c->shards[(hash >> 32) & (c->shard_count - 1u)];
+}
+
+static fossil__cache_entry_t *fossil__cache_find(fossil__cache_shard_t *s, const char *key, uint32_t len, uint64_t hash) {
+    for (fossil__cache_entry_t *e = s->buckets[hash & s->mask]; e; e = e->hnext)
+        if (e->hash == hash && e->key_len == len && memcmp(e->key, key, len) == 0)
+            return e;
+    return NULL;
+}
+
+static void fossil__cache_lru_unlink(fossil__cache_shard_t *s, fossil__cache_entry_t *e) {
+    if (e->prev) e->prev->next = e->next;
+    else s->lru_head = e->next;
+    if (e->next) e->next->prev = e->prev;
+    else s->lru_tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void fossil__cache_lru_front(fossil__cache_shard_t *s, fossil__cache_entry_t *e) {
+    if (s->lru_head == e) return;
+    if (e->prev || e->next || s->lru_tail == e) fossil__cache_lru_unlink(s, e);
+    e->next = s->lru_head;
+    if (s->lru_head) s->lru_head->prev = e;
+    s->lru_head = e;
+    if (!s->lru_tail) s->lru_tail = e;
+}
+
+/* Unlink and free; the caller holds the shard lock. */
+static void fossil__cache_remove(fossil__cache_shard_t *s, fossil__cache_entry_t *e) {
+    fossil__cache_entry_t **pp = &s->buckets[e->hash & s->mask];
+    while (*pp != e) pp = &(*pp)->hnext;
+    *pp = e->hnext;
+    fossil__cache_lru_unlink(s, e);
+    s->count--;
+    s->bytes -= e->charge;
+    fossil_net_buf_unref(e->buf);
+    free(e);
+}
+
+/*=============================================================================
+CACHE
+=============================================================================*/
+
+fossil_net_cache_t *fossil_net_cache_create(const fossil_net_cache_config_t *config) {
+    fossil_net_cache_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    if (config) cfg = *config;
+    if (!cfg.max_bytes) cfg.max_bytes = FOSSIL__CACHE_MAX_BYTES;
+    if (!cfg.shards) cfg.shards = FOSSIL__CACHE_SHARDS;
+    if (!cfg.max_entry) cfg.max_entry = FOSSIL__CACHE_MAX_ENTRY;
+    if (cfg.shards > 1024u) return NULL;
+
+    fossil_net_cache_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->shard_count = 1u;
+    while (c->shard_count < cfg.shards) c->shard_count *= 2u;
+    c->budget = cfg.max_bytes / c->shard_count;
+    c->max_entry = cfg.max_entry;
+    c->default_ttl_ns = cfg.default_ttl_ns;
+
+    for (const char *p = cfg.vary; p && *p;) {
+        while (*p == ' ' || *p == ',') p++;
+        const char *e = p;
+        while (*e && *e != ',' && *e != ' ') e++;
+        if (e > p) {
+            if (c->vary_count == FOSSIL__CACHE_MAX_VARY || !(c->vary[c->vary_count] = malloc((size_t)(e - p) + 1u))) {
+                fossil_net_cache_destroy(c);
+                return NULL;
+            }
+            memcpy(c->vary[c->vary_count], p, (size_t)(e - p));
+            c->vary[c->vary_count++][e - p] = '\0';
+        }
+        p = e;
+    }
+
+    uint64_t entries = c->budget / FOSSIL__CACHE_AVG_ENTRY;
+    uint32_t width = 64u;
+    while (width < entries && width < (1u << 20)) width *= 2u;
+    c->shards = calloc(c->shard_count, sizeof(*c->shards));
+    if (!c->shards) {
+        fossil_net_cache_destroy(c);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < c->shard_count; i++) {
+        fossil__cache_shard_t *s = &c->shards[i];
+        s->mask = width - 1u;
+        s->width = width;
+        s->buckets = calloc(width, sizeof(*s->buckets));
+        s->sketch = calloc(width, FOSSIL__CACHE_ROWS);
+        fossil__cache_mutex_init(&s->lock);
+        if (!s->buckets || !s->sketch) {
+            fossil_net_cache_destroy(c);
+            return NULL;
+        }
+    }
+    return c;
+}
+
+void fossil_net_cache_destroy(fossil_net_cache_t *cache) {
+    if (!cache) return;
+    if (cache->shards) {
+        fossil_net_cache_clear(cache);
+        for (uint32_t i = 0; i < cache->shard_count; i++) {
+            fossil__cache_mutex_destroy(&cache->shards[i].lock);
+            free(cache->shards[i].buckets);
+            free(cache->shards[i].sketch);
+        }
+        free(cache->shards);
+    }
+    for (uint32_t i = 0; i < cache->vary_count; i++)
+        free(cache->vary[i]);
+    free(cache);
+}
+
+uint32_t fossil_net_cache_key(
+    const fossil_net_cache_t *cache,
+    const fossil_net_http_request_t *req,
+    char *key,
+    uint32_t size)
+{
+    if (!cache || !req || !key) return 0;
+    if (req->method != FOSSIL_NET_HTTP_GET && req->method != FOSSIL_NET_HTTP_HEAD) return 0;
+    fossil_net_slice_t v;
+    if (fossil_net_http_request_header(req, "Authorization", NULL)) return 0;
+    if (fossil_net_http_request_header(req, "Cache-Control", &v) &&
+        fossil__cache_directive(v.ptr, v.len, "no-store", NULL))
+        return 0;
+
+    fossil_net_slice_t host = { "", 0 };
+    fossil_net_http_request_header(req, "Host", &host);
+    uint64_t need = 4u + host.len + 1u + req->target.len;
+    for (uint32_t i = 0; i < cache->vary_count; i++) {
+        fossil_net_slice_t value = { "", 0 };
+        fossil_net_http_request_header(req, cache->vary[i], &value);
+        need += 1u + value.len;
+    }
+    if (need > size) return 0;
+
+    uint32_t n = 0;
+    memcpy(key, "GET ", 4);
+    n += 4;
+    memcpy(key + n, host.ptr, host.len);
+    n += (uint32_t)host.len;
+    key[n++] = ' ';
+    memcpy(key + n, req->target.ptr, req->target.len);
+    n += (uint32_t)req->target.len;
+    for (uint32_t i = 0; i < cache->vary_count; i++) {
+        fossil_net_slice_t value = { "", 0 };
+        fossil_net_http_request_header(req, cache->vary[i], &value);
+        key[n++] = '\n';
+        memcpy(key + n, value.ptr, value.len);
+        n += (uint32_t)value.len;
+    }
+    return n;
+}
+
+bool fossil_net_cache_lookup(
+    fossil_net_cache_t *cache,
+    const char *key,
+    uint32_t len,
+    const fossil_net_http_request_t *req,
+    fossil_net_cache_hit_t *hit)
+{
+    if (!cache || !key || !len || !req || !hit) return false;
+    fossil_net_slice_t v;
+    uint64_t max_age = 1;
+    bool refresh =
+        (fossil_net_http_request_header(req, "Cache-Control", &v) &&
+         (fossil__cache_directive(v.ptr, v.len, "no-cache", NULL) ||
+          (fossil__cache_directive(v.ptr, v.len, "max-age", &max_age) && max_age == 0))) ||
+        (fossil_net_http_request_header(req, "Pragma", &v) && fossil__cache_directive(v.ptr, v.len, "no-cache", NULL));
+
+    uint64_t hash = fossil__cache_hash(key, len);
+    fossil__cache_shard_t *s = fossil__cache_shard(cache, hash);
+    uint64_t now = fossil_net_socket_clock_ns();
+    bool expired = false;
+
+    fossil__cache_mutex_lock(&s->lock);
+    fossil__cache_touch(s, hash);
+    fossil__cache_entry_t *e = refresh ? NULL : fossil__cache_find(s, key, len, hash);
+    if (e && now >= e->expires_ns) {
+        fossil__cache_remove(s, e);
+        e = NULL;
+        expired = true;
+    }
+    if (e) {
+        const char *etag = e->key + e->key_len + 1;
+        const char *modified = etag + e->etag_len + 1;
+        bool nm = false;
+        if (fossil_net_http_request_header(req, "If-None-Match", &v))
+            nm = fossil_net_http_etag_match(v, etag);
+        else if (e->modified_len && fossil_net_http_request_header(req, "If-Modified-Since", &v))
+            nm = fossil_net_slice_eq(v, modified); /* exact: clients echo the stored value */
+        fossil__cache_lru_front(s, e);
+        hit->buf = fossil_net_buf_ref(e->buf);
+        hit->not_modified = nm;
+        hit->head_off = nm ? e->nm_off : 0;
+        hit->head_len = nm ? e->nm_len : e->head_len;
+        hit->body_off = e->body_off;
+        hit->body_len = nm ? 0 : e->body_len;
+        hit->age = (uint32_t)((now - e->stored_ns) / 1000000000ull);
+    }
+    fossil__cache_mutex_unlock(&s->lock);
+
+    if (expired) fossil__cache_count(&cache->expired, 1);
+    if (!e) {
+        fossil__cache_count(&cache->misses, 1);
+        return false;
+    }
+    fossil__cache_count(&cache->hits, 1);
+    if (hit->not_modified) fossil__cache_count(&cache->not_modified, 1);
+    return true;
+}
+
+void fossil_net_cache_release(fossil_net_cache_hit_t *hit) {
+    if (!hit) return;
+    fossil_net_buf_unref(hit->buf);
+    hit->buf = NULL;
+}
+
+/* Header lines that a 304 repeats from the full response. */
+static bool fossil__cache_nm_header(const char *name, size_t len) {
+    return fossil__cache_ieq(name, len, "Cache-Control") || fossil__cache_ieq(name, len, "Expires") ||
+           fossil__cache_ieq(name, len, "Vary") || fossil__cache_ieq(name, len, "Last-Modified") ||
+           fossil__cache_ieq(name, len, "Content-Location");
+}
+
+int fossil_net_cache_store(
+    fossil_net_cache_t *cache,
+    const char *key,
+    uint32_t len,
+    int status,
+    const char *content_type,
+    const char *headers,
+    uint32_t headers_len,
+    const void *body,
+    uint32_t body_len)
+{
+    if (!cache || !key || !len || (!headers && headers_len) || (!body && body_len)) return -1;
+    if (status != 200) return 1;
+
+    /* Read what the handler said about caching. */
+    uint64_t ttl = cache->default_ttl_ns;
+    bool cacheable = body_len <= cache->max_entry;
+    const char *etag = NULL, *modified = NULL;
+    size_t etag_len = 0, modified_len = 0, nm_extra = 0;
+    bool smax = false;
+    for (uint32_t i = 0; i < headers_len && cacheable;) {
+        const char *line = headers + i;
+        const char *eol = memchr(line, '\n', headers_len - i);
+        size_t line_len = eol ? (size_t)(eol - line) + 1u : headers_len - i;
+        i += (uint32_t)line_len;
+        const char *colon = memchr(line, ':', line_len);
+        if (!colon) continue;
+        size_t name_len = (size_t)(colon - line);
+        const char *v = colon + 1;
+        const char *ve = line + line_len;
+        while (v < ve && *v == ' ') v++;
+        while (ve > v && (ve[-1] == '\n' || ve[-1] == '\r' || ve[-1] == ' ')) ve--;
+        size_t vlen = (size_t)(ve - v);
+
+        if (fossil__cache_ieq(line, name_len, "Cache-Control")) {
+            uint64_t age = 0;
+            if (fossil__cache_directive(v, vlen, "no-store", NULL) || fossil__cache_directive(v, vlen, "private", NULL) ||
+                fossil__cache_directive(v, vlen, "no-cache", NULL))
+                cacheable = false;
+            if (fossil__cache_directive(v, vlen, "s-maxage", &age)) {
+                ttl = age * 1000000000ull;
+                smax = true;
+            } else if (!smax && fossil__cache_directive(v, vlen, "max-age", &age)) {
+                ttl = age * 1000000000ull;
+            }
+        } else if (fossil__cache_ieq(line, name_len, "Set-Cookie")) {
+            cacheable = false;
+        } else if (fossil__cache_ieq(line, name_len, "Vary")) {
+            for (size_t j = 0; j < vlen && cacheable;) {
+                while (j < vlen && (v[j] == ' ' || v[j] == ',')) j++;
+                size_t s = j;
+                while (j < vlen && v[j] != ',' && v[j] != ' ') j++;
+                if (j == s) break;
+                bool known = false;
+                for (uint32_t k = 0; k < cache->vary_count && !known; k++)
+                    known = fossil__cache_ieq(v + s, j - s, cache->vary[k]);
+                cacheable = known;
+            }
+        } else if (fossil__cache_ieq(line, name_len, "ETag")) {
+            etag = v;
+            etag_len = vlen;
+            continue;
+        } else if (fossil__cache_ieq(line, name_len, "Last-Modified")) {
+            modified = v;
+            modified_len = vlen;
+        }
+        if (fossil__cache_nm_header(line, name_len)) nm_extra += line_len;
+    }
+    if (!cacheable || ttl == 0) {
+        fossil__cache_count(&cache->uncacheable, 1);
+        return 1;
+    }
+
+    char gen[24];
+    if (!etag) {
+        etag_len = (size_t)snprintf(gen, sizeof(gen), "\"%016llx\"",
+                                    (unsigned long long)fossil__cache_hash(body, body_len));
+        etag = gen;
+    }
+
+    /* Preformat both responses: [200 head][304 head][body]. */
+    char line[96];
+    int n = snprintf(line, sizeof(line), "HTTP/1.1 200 OK\r\nContent-Length: %u\r\n", body_len);
+    uint64_t head = (uint64_t)n + headers_len + (content_type ? 16u + strlen(content_type) : 0u) +
+                    (etag == gen ? 8u + etag_len : 0u);
+    uint64_t nm = 27u + 8u + etag_len + nm_extra;
+    uint64_t total = head + nm + body_len;
+    if (total > UINT32_MAX) return 1;
+    fossil_net_buf_t *buf = fossil_net_buf_create((uint32_t)total);
+    if (!buf) return -1;
+    char *p = fossil_net_buf_data(buf);
+    char *w = p;
+#define FOSSIL__CACHE_PUT(src, size) do { if (size) memcpy(w, (src), (size)); w += (size); } while (0)
+    FOSSIL__CACHE_PUT(line, (size_t)n);
+    if (content_type) {
+        FOSSIL__CACHE_PUT("Content-Type: ", 14u);
+        FOSSIL__CACHE_PUT(content_type, strlen(content_type));
+        FOSSIL__CACHE_PUT("\r\n", 2u);
+    }
+    FOSSIL__CACHE_PUT(headers, headers_len);
+    if (etag == gen) {
+        FOSSIL__CACHE_PUT("ETag: ", 6u);
+        FOSSIL__CACHE_PUT(etag, etag_len);
+        FOSSIL__CACHE_PUT("\r\n", 2u);
+    }
+    uint32_t head_len = (uint32_t)(w - p);
+    FOSSIL__CACHE_PUT("HTTP/1.1 304 Not Modified\r\n", 27u);
+    FOSSIL__CACHE_PUT("ETag: ", 6u);
+    FOSSIL__CACHE_PUT(etag, etag_len);
+    FOSSIL__CACHE_PUT("\r\n", 2u);
+    for (uint32_t i = 0; i < headers_len;) {
+        const char *l = headers + i;
+        const char *eol = memchr(l, '\n', headers_len - i);
+        size_t line_len = eol ? (size_t)(eol - l) + 1u : headers_len - i;
+        const char *colon = memchr(l, ':', line_len);
+        if (colon && fossil__cache_nm_header(l, (size_t)(colon - l))) FOSSIL__CACHE_PUT(l, line_len);
+        i += (uint32_t)line_len;
+    }
+    uint32_t nm_len = (uint32_t)(w - p) - head_len;
+    FOSSIL__CACHE_PUT(body, body_len);
+#undef FOSSIL__CACHE_PUT
+    fossil_net_buf_set_size(buf, (uint32_t)(w - p));
+
+    fossil__cache_entry_t *e = malloc(sizeof(*e) + len + etag_len + modified_len + 3u);
+    if (!e) {
+        fossil_net_buf_unref(buf);
+        return -1;
+    }
+    memset(e, 0, sizeof(*e));
+    memcpy(e->key, key, len);
+    e->key[len] = '\0';
+    memcpy(e->key + len + 1, etag, etag_len);
+    e->key[len + 1 + etag_len] = '\0';
+    if (modified_len) memcpy(e->key + len + 2 + etag_len, modified, modified_len);
+    e->key[len + 2 + etag_len + modified_len] = '\0';
+    e->key_len = len;
+    e->etag_len = (uint32_t)etag_len;
+    e->modified_len = (uint32_t)modified_len;
+    e->buf = buf;
+    e->hash = fossil__cache_hash(key, len);
+    e->head_len = head_len;
+    e->nm_off = head_len;
+    e->nm_len = nm_len;
+    e->body_off = head_len + nm_len;
+    e->body_len = body_len;
+    e->charge = sizeof(*e) + len + etag_len + modified_len + 3u + total;
+    e->stored_ns = fossil_net_socket_clock_ns();
+    e->expires_ns = ttl > UINT64_MAX - e->stored_ns ? UINT64_MAX : e->stored_ns + ttl;
+
+    fossil__cache_shard_t *s = fossil__cache_shard(cache, e->hash);
+    uint32_t evicted = 0;
+    bool admitted = e->charge <= cache->budget;
+    fossil__cache_mutex_lock(&s->lock);
+    fossil__cache_entry_t *old = fossil__cache_find(s, key, len, e->hash);
+    if (old && admitted) fossil__cache_remove(s, old);
+    if (admitted && s->bytes + e->charge > cache->budget) {
+        /* Only displace victims asked for less often than the newcomer. */
+        uint32_t freq = fossil__cache_frequency(s, e->hash);
+        uint64_t room = cache->budget - s->bytes;
+        for (fossil__cache_entry_t *v = s->lru_tail; v && room < e->charge; v = v->prev) {
+            if (v->expires_ns > e->stored_ns && fossil__cache_frequency(s, v->hash) >= freq) {
+                admitted = false;
+                break;
+            }
+            room += v->charge;
+        }
+        while (admitted && s->bytes + e->charge > cache->budget) {
+            fossil__cache_remove(s, s->lru_tail);
+            evicted++;
+        }
+    }
+    if (admitted) {
+        e->hnext = s->buckets[e->hash & s->mask];
+        s->buckets[e->hash & s->mask] = e;
+        fossil__cache_lru_front(s, e);
+        s->count++;
+        s->bytes += e->charge;
+    }
+    fossil__cache_mutex_unlock(&s->lock);
+
+    if (evicted) fossil__cache_count(&cache->evictions, evicted);
+    if (!admitted) {
+        fossil__cache_count(&cache->rejected, 1);
+        fossil_net_buf_unref(buf);
+        free(e);
+        return 1;
+    }
+    fossil__cache_count(&cache->stores, 1);
+    return 0;
+}
+
+void fossil_net_cache_clear(fossil_net_cache_t *cache) {
+    if (!cache) return;
+    for (uint32_t i = 0; i < cache->shard_count; i++) {
+        fossil__cache_shard_t *s = &cache->shards[i];
+        fossil__cache_mutex_lock(&s->lock);
+        while (s->lru_head) fossil__cache_remove(s, s->lru_head);
+        fossil__cache_mutex_unlock(&s->lock);
+    }
+}
+
+int fossil_net_cache_get_stats(fossil_net_cache_t *cache, fossil_net_cache_stats_t *stats) {
+    if (!cache || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    stats->hits = atomic_load_explicit(&cache->hits, memory_order_relaxed);
+    stats->misses = atomic_load_explicit(&cache->misses, memory_order_relaxed);
+    stats->not_modified = atomic_load_explicit(&cache->not_modified, memory_order_relaxed);
+    stats->stores = atomic_load_explicit(&cache->stores, memory_order_relaxed);
+    stats->uncacheable = atomic_load_explicit(&cache->uncacheable, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&cache->rejected, memory_order_relaxed);
+    stats->evictions = atomic_load_explicit(&cache->evictions, memory_order_relaxed);
+    stats->expired = atomic_load_explicit(&cache->expired, memory_order_relaxed);
+    for (uint32_t i = 0; i < cache->shard_count; i++) {
+        fossil__cache_shard_t *s = &cache->shards[i];
+        fossil__cache_mutex_lock(&s->lock);
+        stats->entries += s->count;
+        stats->bytes += s->bytes;
+        fossil__cache_mutex_unlock(&s->lock);
+    }
+    return 0;
+}
@@ -0,0 +1,376 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/capture.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define FOSSIL__CAP_BLOCK_SIZE  (1u << 20)
+#define FOSSIL__CAP_BLOCK_COUNT 64u
+#define FOSSIL__CAP_RETIRE_MS   60u
+#define FOSSIL__CAP_FRAME_SIZE  2048u
+
+/* Offset of TX payload inside a frame: the aligned TPACKET_V3 header. */
+#define FOSSIL__CAP_TX_DATA TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+
+struct fossil_net_capture {
+    fossil_net_socket_t *sock;
+    uint8_t *map;
+    size_t map_len;
+
+    uint8_t *rx;
+    uint32_t rx_block_size;
+    uint32_t rx_block_count;
+    uint32_t rx_current;
+
+    uint8_t *tx;
+    uint32_t tx_block_size;
+    uint32_t tx_frame_size;
+    uint32_t tx_frame_count;
+    uint32_t tx_current;
+    uint32_t tx_queued;
+};
+
+static bool fossil__cap_pow2(uint32_t v) {
+    return v && !(v & (v - 1));
+}
+
+/* Undo a half-built capture: unmap first, since the kernel keeps mapped rings alive. */
+static void fossil__cap_abort(fossil_net_socket_t *sock, fossil_net_capture_t *cap) {
+    if (cap) {
+        if (cap->map) munmap(cap->map, cap->map_len);
+        free(cap);
+    }
+    struct tpacket_req3 none;
+    memset(&none, 0, sizeof(none));
+    setsockopt(sock->fd, SOL_PACKET, PACKET_TX_RING, &none, sizeof(none));
+    setsockopt(sock->fd, SOL_PACKET, PACKET_RX_RING, &none, sizeof(none));
+}
+
+fossil_net_capture_t *fossil_net_capture_create(fossil_net_socket_t *sock, const fossil_net_capture_config_t *config) {
+    if (!sock || sock->fd < 0 || sock->family != FOSSIL_NET_SOCKET_FAMILY_PACKET) return NULL;
+    fossil_net_capture_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    if (config) cfg = *config;
+
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) page = 4096;
+    uint32_t block_size = cfg.block_size ? cfg.block_size : FOSSIL__CAP_BLOCK_SIZE;
+    uint32_t block_count = cfg.block_count ? cfg.block_count : FOSSIL__CAP_BLOCK_COUNT;
+    if (!fossil__cap_pow2(block_size) || block_size < (uint32_t)page) return NULL;
+
+    uint32_t tx_frame_size = cfg.tx_frame_size ? cfg.tx_frame_size : FOSSIL__CAP_FRAME_SIZE;
+    uint32_t tx_frames = cfg.tx_frame_count;
+    if (tx_frames && (tx_frame_size < FOSSIL__CAP_TX_DATA + 64 || tx_frame_size % TPACKET_ALIGNMENT)) return NULL;
+
+    int version = TPACKET_V3;
+    if (setsockopt(sock->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) return NULL;
+
+    struct tpacket_req3 rx;
+    memset(&rx, 0, sizeof(rx));
+    rx.tp_block_size = block_size;
+    rx.tp_block_nr = block_count;
+    rx.tp_frame_size = FOSSIL__CAP_FRAME_SIZE; // only used for bookkeeping by V3
+    rx.tp_frame_nr = (block_size / rx.tp_frame_size) * block_count;
+    rx.tp_retire_blk_tov = cfg.retire_ms ? cfg.retire_ms : FOSSIL__CAP_RETIRE_MS;
+    rx.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+    if (setsockopt(sock->fd, SOL_PACKET, PACKET_RX_RING, &rx, sizeof(rx)) != 0) return NULL;
+
+    // TX blocks are sized to a whole number of pages and packed with frames
+    uint32_t tx_block_size = 0, tx_block_count = 0;
+    if (tx_frames) {
+        tx_block_size = (uint32_t)page;
+        while (tx_block_size < tx_frame_size) tx_block_size <<= 1;
+        uint32_t per_block = tx_block_size / tx_frame_size;
+        tx_block_count = (tx_frames + per_block - 1) / per_block;
+        tx_frames = tx_block_count * per_block;
+
+        struct tpacket_req3 tx;
+        memset(&tx, 0, sizeof(tx));
+        tx.tp_block_size = tx_block_size;
+        tx.tp_block_nr = tx_block_count;
+        tx.tp_frame_size = tx_frame_size;
+        tx.tp_frame_nr = tx_frames;
+        if (setsockopt(sock->fd, SOL_PACKET, PACKET_TX_RING, &tx, sizeof(tx)) != 0) {
+            fossil__cap_abort(sock, NULL);
+            return NULL;
+        }
+    }
+
+    fossil_net_capture_t *cap = calloc(1, sizeof(*cap));
+    if (!cap) {
+        fossil__cap_abort(sock, NULL);
+        return NULL;
+    }
+    cap->sock = sock;
+    cap->rx_block_size = block_size;
+    cap->rx_block_count = block_count;
+    cap->tx_block_size = tx_block_size;
+    cap->tx_frame_size = tx_frame_size;
+    cap->tx_frame_count = tx_frames;
+
+    size_t rx_len = (size_t)block_size * block_count;
+    cap->map_len = rx_len + (size_t)tx_block_size * tx_block_count;
+    void *map = mmap(NULL, cap->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, sock->fd, 0);
+    if (map == MAP_FAILED) {
+        fossil__cap_abort(sock, cap);
+        return NULL;
+    }
+    cap->map = map;
+    cap->rx = cap->map;
+    cap->tx = tx_frames ? cap->map + rx_len : NULL;
+
+    struct sockaddr_ll ll;
+    memset(&ll, 0, sizeof(ll));
+    ll.sll_family = AF_PACKET;
+    ll.sll_protocol = htons(ETH_P_ALL);
+    if (cfg.iface && *cfg.iface) {
+        ll.sll_ifindex = (int)if_nametoindex(cfg.iface);
+        if (ll.sll_ifindex == 0) {
+            fossil__cap_abort(sock, cap);
+            return NULL;
+        }
+    }
+    if (bind(sock->fd, (struct sockaddr*)&ll, sizeof(ll)) != 0) {
+        fossil__cap_abort(sock, cap);
+        return NULL;
+    }
+    sock->flags |= FOSSIL_NET_SOCKET_FLAG_BOUND;
+    return cap;
+}
+
+void fossil_net_capture_destroy(fossil_net_capture_t *cap) {
+    if (!cap) return;
+    if (cap->map) munmap(cap->map, cap->map_len);
+    free(cap);
+}
+
+int fossil_net_capture_set_fanout(fossil_net_capture_t *cap, uint16_t group, fossil_net_capture_fanout_t mode) {
+    if (!cap) return -1;
+    uint32_t native;
+    switch (mode) {
+        case FOSSIL_NET_CAPTURE_FANOUT_HASH:     native = PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG; break;
+        case FOSSIL_NET_CAPTURE_FANOUT_LB:       native = PACKET_FANOUT_LB; break;
+        case FOSSIL_NET_CAPTURE_FANOUT_CPU:      native = PACKET_FANOUT_CPU; break;
+        case FOSSIL_NET_CAPTURE_FANOUT_ROLLOVER: native = PACKET_FANOUT_ROLLOVER; break;
+        case FOSSIL_NET_CAPTURE_FANOUT_RANDOM:   native = PACKET_FANOUT_RND; break;
+        case FOSSIL_NET_CAPTURE_FANOUT_QUEUE:    native = PACKET_FANOUT_QM; break;
+        default: return -1;
+    }
+    uint32_t word = (uint32_t)group | (native << 16);
+    int arg = (int)word;
+    return setsockopt(cap->sock->fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) == 0 ? 0 : -1;
+}
+
+/*=============================================================================
+RECEIVE
+=============================================================================*/
+
+static struct tpacket_block_desc *fossil__cap_block(fossil_net_capture_t *cap, uint32_t index) {
+    return (struct tpacket_block_desc*)(cap->rx + (size_t)index * cap->rx_block_size);
+}
+
+int fossil_net_capture_next_block(fossil_net_capture_t *cap, fossil_net_capture_block_t *block, uint32_t timeout_ms) {
+    if (!cap || !block) return -1;
+    struct tpacket_block_desc *bd = fossil__cap_block(cap, cap->rx_current);
+    while (!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+        struct pollfd pfd = { .fd = cap->sock->fd, .events = POLLIN | POLLERR, .revents = 0 };
+        int rc = poll(&pfd, 1, (int)timeout_ms);
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc < 0) return -1;
+        if (rc == 0 && !(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+            return 0;
+        if (rc == 0) break;
+    }
+    block->desc = bd;
+    block->seq = bd->hdr.bh1.seq_num;
+    block->frame_count = bd->hdr.bh1.num_pkts;
+    block->frame_index = 0;
+    block->cursor = (const uint8_t*)bd + bd->hdr.bh1.offset_to_first_pkt;
+    return 1;
+}
+
+bool fossil_net_capture_next_frame(fossil_net_capture_block_t *block, fossil_net_capture_frame_t *frame) {
+    if (!block || !frame || block->frame_index >= block->frame_count) return false;
+    const struct tpacket3_hdr *h = (const struct tpacket3_hdr*)block->cursor;
+    const struct sockaddr_ll *ll = (const struct sockaddr_ll*)(block->cursor + TPACKET_ALIGN(sizeof(*h)));
+
+    frame->data = block->cursor + h->tp_mac;
+    frame->caplen = h->tp_snaplen;
+    frame->len = h->tp_len;
+    frame->timestamp_ns = (uint64_t)h->tp_sec * 1000000000ull + h->tp_nsec;
+    frame->ifindex = (uint32_t)ll->sll_ifindex;
+    frame->rxhash = h->hv1.tp_rxhash;
+    frame->protocol = ntohs(ll->sll_protocol);
+    frame->pkttype = ll->sll_pkttype;
+    frame->has_vlan = (h->tp_status & TP_STATUS_VLAN_VALID) != 0;
+    frame->vlan_tci = frame->has_vlan ? (uint16_t)h->hv1.tp_vlan_tci : 0;
+
+    block->frame_index++;
+    block->cursor += h->tp_next_offset;
+    return true;
+}
+
+void fossil_net_capture_release_block(fossil_net_capture_t *cap, fossil_net_capture_block_t *block) {
+    if (!cap || !block || !block->desc) return;
+    struct tpacket_block_desc *bd = block->desc;
+    __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    if (bd == fossil__cap_block(cap, cap->rx_current))
+        cap->rx_current = (cap->rx_current + 1) % cap->rx_block_count;
+    block->desc = NULL;
+    block->frame_count = 0;
+}
+
+int fossil_net_capture_get_stats(fossil_net_capture_t *cap, fossil_net_capture_stats_t *stats) {
+    if (!cap || !stats) return -1;
+    struct tpacket_stats_v3 st;
+    socklen_t len = sizeof(st);
+    memset(&st, 0, sizeof(st));
+    if (getsockopt(cap->sock->fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) != 0) return -1;
+    stats->packets = st.tp_packets;
+    stats->drops = st.tp_drops;
+    stats->freeze_count = st.tp_freeze_q_cnt;
+    return 0;
+}
+
+/*=============================================================================
+TRANSMIT
+=============================================================================*/
+
+static struct tpacket3_hdr *fossil__cap_tx_frame(fossil_net_capture_t *cap, uint32_t index) {
+    // Frames never straddle TX blocks; any slack sits at the end of each block
+    uint32_t per_block = cap->tx_block_size / cap->tx_frame_size;
+    size_t offset = (size_t)(index / per_block) * cap->tx_block_size + (size_t)(index % per_block) * cap->tx_frame_size;
+    return (struct tpacket3_hdr*)(cap->tx + offset);
+}
+
+int fossil_net_capture_flush(fossil_net_capture_t *cap) {
+    if (!cap || !cap->tx) return -1;
+    if (cap->tx_queued == 0) return 0;
+    ssize_t rc;
+    do {
+        rc = sendto(cap->sock->fd, NULL, 0, 0, NULL, 0);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0 && errno != EAGAIN && errno != ENOBUFS) return -1;
+    int sent = (int)cap->tx_queued;
+    cap->tx_queued = 0;
+    return sent;
+}
+
+int fossil_net_capture_send(fossil_net_capture_t *cap, const void *data, uint32_t size) {
+    if (!cap || !cap->tx || !data) return -1;
+    if (size > cap->tx_frame_size - FOSSIL__CAP_TX_DATA) return -1;
+
+    struct tpacket3_hdr *h = fossil__cap_tx_frame(cap, cap->tx_current);
+    if (__atomic_load_n(&h->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+        // Ring full: push what is queued and give the kernel one chance to drain
+        if (fossil_net_capture_flush(cap) < 0) return -1;
+        struct pollfd pfd = { .fd = cap->sock->fd, .events = POLLOUT, .revents = 0 };
+        (void)poll(&pfd, 1, (cap->sock->flags & FOSSIL_NET_SOCKET_FLAG_BLOCKING) ? 100 : 0);
+        if (__atomic_load_n(&h->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+            errno = EAGAIN;
+            return -1;
+        }
+    }
+    memcpy((uint8_t*)h + FOSSIL__CAP_TX_DATA, data, size);
+    h->tp_len = size;
+    h->tp_snaplen = size;
+    h->tp_next_offset = 0;
+    __atomic_store_n(&h->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+    cap->tx_current = (cap->tx_current + 1) % cap->tx_frame_count;
+    cap->tx_queued++;
+    return 0;
+}
+
+#else
+
+struct fossil_net_capture {
+    int unused;
+};
+
+fossil_net_capture_t *fossil_net_capture_create(fossil_net_socket_t *sock, const fossil_net_capture_config_t *config) {
+    (void)sock;
+    (void)config;
+    // Not supported on this platform
+    return NULL;
+}
+
+void fossil_net_capture_destroy(fossil_net_capture_t *cap) {
+    free(cap);
+}
+
+int fossil_net_capture_set_fanout(fossil_net_capture_t *cap, uint16_t group, fossil_net_capture_fanout_t mode) {
+    (void)cap; (void)group; (void)mode;
+    return -1;
+}
+
+int fossil_net_capture_next_block(fossil_net_capture_t *cap, fossil_net_capture_block_t *block, uint32_t timeout_ms) {
+    (void)cap; (void)block; (void)timeout_ms;
+    return -1;
+}
+
+bool fossil_net_capture_next_frame(fossil_net_capture_block_t *block, fossil_net_capture_frame_t *frame) {
+    (void)block; (void)frame;
+    return false;
+}
+
+void fossil_net_capture_release_block(fossil_net_capture_t *cap, fossil_net_capture_block_t *block) {
+    (void)cap; (void)block;
+}
+
+int fossil_net_capture_get_stats(fossil_net_capture_t *cap, fossil_net_capture_stats_t *stats) {
+    (void)cap; (void)stats;
+    return -1;
+}
+
+int fossil_net_capture_send(fossil_net_capture_t *cap, const void *data, uint32_t size) {
+    (void)cap; (void)data; (void)size;
+    return -1;
+}
+
+int fossil_net_capture_flush(fossil_net_capture_t *cap) {
+    (void)cap;
+    return -1;
+}
+
+#endif
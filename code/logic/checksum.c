@@ -0,0 +1,225 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/checksum.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FOSSIL__CSUM_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FOSSIL__CSUM_AVX2 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FOSSIL__CSUM_NEON 1
+#endif
+
+/*
+ * The one's-complement sum does not depend on byte order (RFC 1071 2.B), so
+ * everything is summed as native 16/32-bit words and only the folded result
+ * is swapped into host order of the big-endian field.
+ */
+
+static uint64_t fossil__csum_fold64(uint64_t sum) {
+    sum = (sum & 0xffffffffu) + (sum >> 32);
+    sum = (sum & 0xffffffffu) + (sum >> 32);
+    return sum;
+}
+
+static uint32_t fossil__csum_fold16(uint64_t sum) {
+    sum = fossil__csum_fold64(sum);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return (uint32_t)sum;
+}
+
+static uint64_t fossil__csum_scalar(const uint8_t *p, size_t len, uint64_t sum) {
+    while (len >= 16) {
+        uint32_t w[4];
+        memcpy(w, p, 16);
+        sum += (uint64_t)w[0] + w[1] + w[2] + w[3];
+        p += 16;
+        len -= 16;
+    }
+    while (len >= 4) {
+        uint32_t w;
+        memcpy(&w, p, 4);
+        sum += w;
+        p += 4;
+        len -= 4;
+    }
+    if (len >= 2) {
+        uint16_t w;
+        memcpy(&w, p, 2);
+        sum += w;
+        p += 2;
+        len -= 2;
+    }
+    if (len) {
+        // Odd byte is the high half of a zero-padded big-endian word
+        uint16_t w = 0;
+        memcpy(&w, p, 1);
+        sum += w;
+    }
+    return sum;
+}
+
+#if defined(FOSSIL__CSUM_AVX2)
+static uint64_t fossil__csum_simd(const uint8_t *p, size_t *len_io, uint64_t sum) {
+    size_t len = *len_io;
+    const __m256i zero = _mm256_setzero_si256();
+    while (len >= 32) {
+        // Each lane gains at most 2 * 0xffff per block; spill before 32-bit overflow
+        size_t blocks = len / 32;
+        if (blocks > 32768) blocks = 32768;
+        __m256i acc = zero;
+        for (size_t i = 0; i < blocks; ++i) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)p);
+            acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+            acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+            p += 32;
+        }
+        len -= blocks * 32;
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, acc);
+        for (int i = 0; i < 8; ++i) sum += lanes[i];
+    }
+    *len_io = len;
+    return sum;
+}
+#elif defined(FOSSIL__CSUM_SSE2)
+static uint64_t fossil__csum_simd(const uint8_t *p, size_t *len_io, uint64_t sum) {
+    size_t len = *len_io;
+    const __m128i zero = _mm_setzero_si128();
+    while (len >= 16) {
+        size_t blocks = len / 16;
+        if (blocks > 32768) blocks = 32768;
+        __m128i acc0 = zero, acc1 = zero;
+        for (size_t i = 0; i < blocks; ++i) {
+            __m128i v = _mm_loadu_si128((const __m128i*)p);
+            acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(v, zero));
+            acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(v, zero));
+            p += 16;
+        }
+        len -= blocks * 16;
+        uint32_t lanes[8];
+        _mm_storeu_si128((__m128i*)lanes, acc0);
+        _mm_storeu_si128((__m128i*)(lanes + 4), acc1);
+        for (int i = 0; i < 8; ++i) sum += lanes[i];
+    }
+    *len_io = len;
+    return sum;
+}
+#elif defined(FOSSIL__CSUM_NEON)
+static uint64_t fossil__csum_simd(const uint8_t *p, size_t *len_io, uint64_t sum) {
+    size_t len = *len_io;
+    while (len >= 16) {
+        size_t blocks = len / 16;
+        if (blocks > 32768) blocks = 32768;
+        uint32x4_t acc = vdupq_n_u32(0);
+        for (size_t i = 0; i < blocks; ++i) {
+            acc = vpadalq_u16(acc, vreinterpretq_u16_u8(vld1q_u8(p)));
+            p += 16;
+        }
+        len -= blocks * 16;
+        sum += vaddlvq_u32(acc);
+    }
+    *len_io = len;
+    return sum;
+}
+#endif
+
+uint32_t fossil_net_checksum_partial(const void *data, size_t length, uint32_t partial) {
+    const uint8_t *p = data;
+    uint64_t sum = partial;
+    if (!p) return partial;
+#if defined(FOSSIL__CSUM_AVX2) || defined(FOSSIL__CSUM_SSE2) || defined(FOSSIL__CSUM_NEON)
+    if (length >= 64) {
+        size_t rest = length;
+        sum = fossil__csum_simd(p, &rest, sum);
+        p += length - rest;
+        length = rest;
+    }
+#endif
+    return fossil__csum_fold16(fossil__csum_scalar(p, length, sum));
+}
+
+static uint16_t fossil__csum_host(uint32_t folded) {
+    // The native-order sum of big-endian words is itself byte swapped on LE hosts
+    const uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    uint16_t v = (uint16_t)folded;
+    return first ? (uint16_t)((v >> 8) | (v << 8)) : v;
+}
+
+uint16_t fossil_net_checksum_finish(uint32_t partial) {
+    return fossil__csum_host(~fossil__csum_fold16(partial) & 0xffffu);
+}
+
+uint16_t fossil_net_checksum(const void *data, size_t length) {
+    return fossil_net_checksum_finish(fossil_net_checksum_partial(data, length, 0));
+}
+
+uint32_t fossil_net_checksum_pseudo_ipv4(const uint8_t src[4], const uint8_t dst[4], uint8_t proto, uint16_t length) {
+    uint8_t ph[12];
+    memcpy(ph, src, 4);
+    memcpy(ph + 4, dst, 4);
+    ph[8] = 0;
+    ph[9] = proto;
+    ph[10] = (uint8_t)(length >> 8);
+    ph[11] = (uint8_t)length;
+    return fossil_net_checksum_partial(ph, sizeof(ph), 0);
+}
+
+uint32_t fossil_net_checksum_pseudo_ipv6(const uint8_t src[16], const uint8_t dst[16], uint8_t proto, uint32_t length) {
+    uint8_t ph[40];
+    memcpy(ph, src, 16);
+    memcpy(ph + 16, dst, 16);
+    ph[32] = (uint8_t)(length >> 24);
+    ph[33] = (uint8_t)(length >> 16);
+    ph[34] = (uint8_t)(length >> 8);
+    ph[35] = (uint8_t)length;
+    ph[36] = ph[37] = ph[38] = 0;
+    ph[39] = proto;
+    return fossil_net_checksum_partial(ph, sizeof(ph), 0);
+}
+
+/* Host-order arithmetic; the fold is the same in either byte order. */
+uint16_t fossil_net_checksum_update16(uint16_t check, uint16_t old_value, uint16_t new_value) {
+    uint32_t sum = (uint16_t)~check + (uint32_t)(uint16_t)~old_value + new_value;
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+uint16_t fossil_net_checksum_update32(uint16_t check, uint32_t old_value, uint32_t new_value) {
+    check = fossil_net_checksum_update16(check, (uint16_t)(old_value >> 16), (uint16_t)(new_value >> 16));
+    return fossil_net_checksum_update16(check, (uint16_t)old_value, (uint16_t)new_value);
+}
@@ -30,9 +30,11 @@
 #include <errno.h>
 
 typedef struct fossil_net_client {
+    /* hot: touched on every send/receive */
     fossil_net_socket_t sock;
     int last_error;
     bool connected;
+    /* cold: only read by the address getters */
     fossil_net_address_t local_addr;
     fossil_net_address_t remote_addr;
 } fossil_net_client_t;
@@ -125,10 +127,14 @@ int fossil_net_client_set_blocking(fossil_net_client_t *client, bool blocking) {
         client->last_error = fossil_net_socket_error_last();
         return -1;
     }
-    client->sock.blocking = blocking;
     return 0;
 }
 
+fossil_net_socket_t *fossil_net_client_socket(fossil_net_client_t *client) {
+    if (!client) return NULL;
+    return &client->sock;
+}
+
 int fossil_net_client_error_last(fossil_net_client_t *client) {
     if (!client) return 0;
     return client->last_error;
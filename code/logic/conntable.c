@@ -0,0 +1,208 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/conntable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+/* Slot header, followed by the object (16-byte aligned). */
+typedef struct fossil__ct_slot {
+    uint32_t generation; /* odd while live */
+    uint32_t link;       /* dense position while live, next free slot otherwise */
+    uint32_t index;
+    uint32_t reserved;
+} fossil__ct_slot_t;
+
+#define FOSSIL__CT_END   UINT32_MAX
+#define FOSSIL__CT_SHIFT 10u /* log2(FOSSIL_NET_CONNTABLE_CHUNK) */
+#define FOSSIL__CT_MASK  (FOSSIL_NET_CONNTABLE_CHUNK - 1u)
+
+struct fossil_net_conntable {
+    uint32_t stride;      /* header + object, rounded to 16 */
+    uint32_t max_chunks;
+    uint8_t **chunks;
+    uint32_t nchunks;
+    uint32_t free_head;
+    uint32_t *dense;      /* slot index of every live object */
+    uint32_t count;
+    uint64_t allocs;
+    uint64_t releases;
+    uint64_t stale;
+};
+
+static inline fossil__ct_slot_t *fossil__ct_slot(const fossil_net_conntable_t *t, uint32_t index) {
+    return (fossil__ct_slot_t *)(t->chunks[index >> FOSSIL__CT_SHIFT] + (size_t)(index & FOSSIL__CT_MASK) * t->stride);
+}
+
+static inline fossil_net_handle_t fossil__ct_handle(const fossil__ct_slot_t *s) {
+    return ((fossil_net_handle_t)s->generation << 32) | s->index;
+}
+
+/* Slot for a handle that is currently live, or NULL. */
+static fossil__ct_slot_t *fossil__ct_resolve(const fossil_net_conntable_t *t, fossil_net_handle_t h) {
+    uint32_t index = FOSSIL_NET_HANDLE_INDEX(h);
+    if ((index >> FOSSIL__CT_SHIFT) >= t->nchunks) return NULL;
+    fossil__ct_slot_t *s = fossil__ct_slot(t, index);
+    if (s->generation != (uint32_t)(h >> 32) || !(s->generation & 1u)) return NULL;
+    return s;
+}
+
+/* Carve a new chunk and thread its slots onto the free list in index order. */
+static int fossil__ct_grow(fossil_net_conntable_t *t) {
+    if (t->nchunks == t->max_chunks) return -1;
+    uint8_t *chunk = malloc((size_t)t->stride * FOSSIL_NET_CONNTABLE_CHUNK);
+    if (!chunk) return -1;
+    uint32_t *dense = realloc(t->dense, (size_t)(t->nchunks + 1) * FOSSIL_NET_CONNTABLE_CHUNK * sizeof(uint32_t));
+    if (!dense) {
+        free(chunk);
+        return -1;
+    }
+    t->dense = dense;
+    t->chunks[t->nchunks] = chunk;
+    uint32_t base = t->nchunks * FOSSIL_NET_CONNTABLE_CHUNK;
+    t->nchunks++;
+    for (uint32_t i = 0; i < FOSSIL_NET_CONNTABLE_CHUNK; i++) {
+        fossil__ct_slot_t *s = fossil__ct_slot(t, base + i);
+        s->generation = 0;
+        s->index = base + i;
+        s->reserved = 0;
+        s->link = i + 1 < FOSSIL_NET_CONNTABLE_CHUNK ? base + i + 1 : t->free_head;
+    }
+    t->free_head = base;
+    return 0;
+}
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+fossil_net_conntable_t *fossil_net_conntable_create(uint32_t object_size, uint32_t max_objects) {
+    if (object_size == 0 || object_size > (1u << 30)) return NULL;
+    if (max_objects == 0) max_objects = 1u << 24;
+    fossil_net_conntable_t *t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    t->stride = (uint32_t)((sizeof(fossil__ct_slot_t) + object_size + 15u) & ~15u);
+    t->max_chunks = (uint32_t)(((uint64_t)max_objects + FOSSIL__CT_MASK) >> FOSSIL__CT_SHIFT);
+    t->free_head = FOSSIL__CT_END;
+    t->chunks = calloc(t->max_chunks, sizeof(*t->chunks));
+    if (!t->chunks) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+void fossil_net_conntable_destroy(fossil_net_conntable_t *table) {
+    if (!table) return;
+    for (uint32_t i = 0; i < table->nchunks; i++) free(table->chunks[i]);
+    free(table->chunks);
+    free(table->dense);
+    free(table);
+}
+
+/*=============================================================================
+OBJECTS
+=============================================================================*/
+
+void *fossil_net_conntable_alloc(fossil_net_conntable_t *table, fossil_net_handle_t *handle) {
+    if (handle) *handle = FOSSIL_NET_HANDLE_NONE;
+    if (!table) return NULL;
+    if (table->free_head == FOSSIL__CT_END && fossil__ct_grow(table) != 0) return NULL;
+
+    fossil__ct_slot_t *s = fossil__ct_slot(table, table->free_head);
+    table->free_head = s->link;
+    s->generation++;
+    s->link = table->count;
+    table->dense[table->count++] = s->index;
+    table->allocs++;
+    memset(s + 1, 0, table->stride - sizeof(*s));
+    if (handle) *handle = fossil__ct_handle(s);
+    return s + 1;
+}
+
+int fossil_net_conntable_release(fossil_net_conntable_t *table, fossil_net_handle_t handle) {
+    if (!table) return -1;
+    fossil__ct_slot_t *s = fossil__ct_resolve(table, handle);
+    if (!s) {
+        table->stale++;
+        return -1;
+    }
+    uint32_t last = table->dense[--table->count];
+    table->dense[s->link] = last;
+    fossil__ct_slot(table, last)->link = s->link;
+
+    s->generation++; /* even: free, and every outstanding handle is now stale */
+    s->link = table->free_head;
+    table->free_head = s->index;
+    table->releases++;
+    return 0;
+}
+
+void *fossil_net_conntable_get(fossil_net_conntable_t *table, fossil_net_handle_t handle) {
+    if (!table) return NULL;
+    fossil__ct_slot_t *s = fossil__ct_resolve(table, handle);
+    if (!s) {
+        table->stale++;
+        return NULL;
+    }
+    return s + 1;
+}
+
+fossil_net_handle_t fossil_net_conntable_handle_of(const fossil_net_conntable_t *table, const void *object) {
+    if (!table || !object) return FOSSIL_NET_HANDLE_NONE;
+    const fossil__ct_slot_t *s = (const fossil__ct_slot_t *)object - 1;
+    return (s->generation & 1u) ? fossil__ct_handle(s) : FOSSIL_NET_HANDLE_NONE;
+}
+
+/*=============================================================================
+ITERATION
+=============================================================================*/
+
+uint32_t fossil_net_conntable_count(const fossil_net_conntable_t *table) {
+    return table ? table->count : 0;
+}
+
+void *fossil_net_conntable_at(fossil_net_conntable_t *table, uint32_t position, fossil_net_handle_t *handle) {
+    if (handle) *handle = FOSSIL_NET_HANDLE_NONE;
+    if (!table || position >= table->count) return NULL;
+    fossil__ct_slot_t *s = fossil__ct_slot(table, table->dense[position]);
+    if (handle) *handle = fossil__ct_handle(s);
+    return s + 1;
+}
+
+int fossil_net_conntable_get_stats(const fossil_net_conntable_t *table, fossil_net_conntable_stats_t *stats) {
+    if (!table || !stats) return -1;
+    stats->live = table->count;
+    stats->capacity = table->nchunks * FOSSIL_NET_CONNTABLE_CHUNK;
+    stats->chunks = table->nchunks;
+    stats->allocs = table->allocs;
+    stats->releases = table->releases;
+    stats->stale = table->stale;
+    return 0;
+}
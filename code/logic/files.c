@@ -0,0 +1,692 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+// Must be defined before any system header to expose O_CLOEXEC.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/files.h"
+#include "fossil/network/socket.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+typedef CRITICAL_SECTION fossil__files_mutex_t;
+#define fossil__files_mutex_init(m)    InitializeCriticalSection(m)
+#define fossil__files_mutex_destroy(m) DeleteCriticalSection(m)
+#define fossil__files_mutex_lock(m)    EnterCriticalSection(m)
+#define fossil__files_mutex_unlock(m)  LeaveCriticalSection(m)
+typedef struct _stat64 fossil__files_stat_t;
+#define fossil__files_open(p)       _open(p, _O_RDONLY | _O_BINARY)
+#define fossil__files_close(fd)     _close(fd)
+#define fossil__files_fstat(fd, st) _fstat64(fd, st)
+#define fossil__files_stat(p, st)   _stat64(p, st)
+#define FOSSIL__FILES_ISDIR(m)      (((m) & _S_IFMT) == _S_IFDIR)
+#define FOSSIL__FILES_ISREG(m)      (((m) & _S_IFMT) == _S_IFREG)
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_mutex_t fossil__files_mutex_t;
+#define fossil__files_mutex_init(m)    pthread_mutex_init(m, NULL)
+#define fossil__files_mutex_destroy(m) pthread_mutex_destroy(m)
+#define fossil__files_mutex_lock(m)    pthread_mutex_lock(m)
+#define fossil__files_mutex_unlock(m)  pthread_mutex_unlock(m)
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+typedef struct stat fossil__files_stat_t;
+#define fossil__files_open(p)       open(p, O_RDONLY | O_CLOEXEC)
+#define fossil__files_close(fd)     close(fd)
+#define fossil__files_fstat(fd, st) fstat(fd, st)
+#define fossil__files_stat(p, st)   stat(p, st)
+#define FOSSIL__FILES_ISDIR(m)      S_ISDIR(m)
+#define FOSSIL__FILES_ISREG(m)      S_ISREG(m)
+#endif
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+#define FOSSIL__FILES_MAX_OPEN   1024u
+#define FOSSIL__FILES_REVALIDATE 1000000000ull
+#define FOSSIL__FILES_MAX_PATH   4096u
+
+/*
+ * One open file. The cache and every response in flight each hold a
+ * reference to owner; the last one to drop it closes fd and frees the
+ * entry, so eviction never pulls a descriptor from under sendfile.
+ */
+typedef struct fossil__files_entry
+{
+    struct fossil__files_entry *hnext;
+    struct fossil__files_entry *prev;   /* LRU, most recent first */
+    struct fossil__files_entry *next;
+    fossil_net_buf_t *owner;
+    uint64_t hash;
+    uint64_t size;
+    int64_t mtime;
+    uint64_t ino;
+    uint64_t checked_ns;                /* last stat, under the lock */
+    int32_t fd;
+    uint32_t type_len;                  /* Content-Type line, left out of 304s */
+    uint32_t head_len;
+    char etag[48];
+    char modified[32];
+    char *head;                         /* header block sent with every response */
+    char path[];
+} fossil__files_entry_t;
+
+struct fossil_net_files
+{
+    fossil__files_mutex_t lock;
+    fossil__files_entry_t **buckets;
+    uint32_t mask;
+    uint32_t count;
+    fossil__files_entry_t *lru_head;
+    fossil__files_entry_t *lru_tail;
+    char *root;
+    char *index;
+    char *cache_control;
+    uint32_t root_len;
+    uint32_t max_open;
+    uint64_t revalidate_ns;
+    _Atomic uint64_t hits;
+    _Atomic uint64_t misses;
+    _Atomic uint64_t evictions;
+    _Atomic uint64_t revalidations;
+    _Atomic uint64_t not_found;
+    _Atomic uint64_t not_modified;
+    _Atomic uint64_t partial;
+    _Atomic uint64_t bytes;
+};
+
+static inline void fossil__files_count(_Atomic uint64_t *c, uint64_t n) {
+    atomic_fetch_add_explicit(c, n, memory_order_relaxed);
+}
+
+static uint64_t fossil__files_hash(const char *s, size_t n) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (uint8_t)s[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static char *fossil__files_strdup(const char *s) {
+    size_t n = strlen(s) + 1;
+    char *p = malloc(n);
+    if (p) memcpy(p, s, n);
+    return p;
+}
+
+/*=============================================================================
+DATES AND TYPES
+=============================================================================*/
+
+static const char fossil__files_months[12][4] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+/* Days since 1970-01-01 of a proleptic Gregorian date. */
+static int64_t fossil__files_days(int64_t y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+/* IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT". */
+static void fossil__files_format_date(int64_t t, char out[32]) {
+    static const char wdays[7][4] = { "Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed" };
+    int64_t days = t / 86400;
+    int64_t secs = t % 86400;
+    if (secs < 0) {
+        secs += 86400;
+        days--;
+    }
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int d = (int)(doy - (153 * mp + 2) / 5 + 1);
+    int m = (int)(mp < 10 ? mp + 3 : mp - 9);
+    int64_t y = yoe + era * 400 + (m <= 2);
+    snprintf(out, 32, "%s, %02d %s %04d %02d:%02d:%02d GMT",
+             wdays[((days % 7) + 7) % 7], d, fossil__files_months[m - 1], (int)y,
+             (int)(secs / 3600), (int)(secs / 60 % 60), (int)(secs % 60));
+}
+
+static bool fossil__files_digits(const char *s, int n, int *out) {
+    int v = 0;
+    for (int i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9') return false;
+        v = v * 10 + (s[i] - '0');
+    }
+    *out = v;
+    return true;
+}
+
+/* Parse an IMF-fixdate; the obsolete formats are not accepted. */
+static bool fossil__files_parse_date(fossil_net_slice_t v, int64_t *t) {
+    if (v.len != 29 || v.ptr[3] != ',' || memcmp(v.ptr + 25, " GMT", 4) != 0) return false;
+    const char *s = v.ptr + 5;
+    int d, y, hh, mm, ss, m = -1;
+    for (int i = 0; i < 12; i++)
+        if (memcmp(s + 3, fossil__files_months[i], 3) == 0) m = i + 1;
+    if (m < 0 || s[2] != ' ' || s[6] != ' ' || s[11] != ' ' || s[14] != ':' || s[17] != ':' ||
+        !fossil__files_digits(s, 2, &d) || !fossil__files_digits(s + 7, 4, &y) ||
+        !fossil__files_digits(s + 12, 2, &hh) || !fossil__files_digits(s + 15, 2, &mm) ||
+        !fossil__files_digits(s + 18, 2, &ss))
+        return false;
+    *t = fossil__files_days(y, m, d) * 86400 + hh * 3600 + mm * 60 + ss;
+    return true;
+}
+
+static const char *fossil__files_mime(const char *path) {
+    static const struct { const char *ext; const char *type; } types[] = {
+        { "html", "text/html; charset=utf-8" },
+        { "htm", "text/html; charset=utf-8" },
+        { "css", "text/css; charset=utf-8" },
+        { "js", "text/javascript; charset=utf-8" },
+        { "mjs", "text/javascript; charset=utf-8" },
+        { "json", "application/json" },
+        { "map", "application/json" },
+        { "txt", "text/plain; charset=utf-8" },
+        { "xml", "application/xml" },
+        { "svg", "image/svg+xml" },
+        { "png", "image/png" },
+        { "jpg", "image/jpeg" },
+        { "jpeg", "image/jpeg" },
+        { "gif", "image/gif" },
+        { "webp", "image/webp" },
+        { "avif", "image/avif" },
+        { "ico", "image/x-icon" },
+        { "woff", "font/woff" },
+        { "woff2", "font/woff2" },
+        { "wasm", "application/wasm" },
+        { "pdf", "application/pdf" },
+        { "mp4", "video/mp4" },
+        { "webm", "video/webm" },
+        { "mp3", "audio/mpeg" }
+    };
+    const char *slash = strrchr(path, '/');
+    const char *dot = strrchr(path, '.');
+    if (dot && (!slash || dot > slash)) {
+        dot++;
+        for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+            const char *a = dot;
+            const char *b = types[i].ext;
+            while (*a && *b && (*a | 0x20) == *b) {
+                a++;
+                b++;
+            }
+            if (!*a && !*b) return types[i].type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+/*=============================================================================
+CACHE
+=============================================================================*/
+
+static void fossil__files_entry_free(void *data, void *ctx) {
+    (void)ctx;
+    fossil__files_entry_t *e = data;
+    fossil__files_close(e->fd);
+    free(e);
+}
+
+static fossil__files_entry_t *fossil__files_entry_new(
+    const fossil_net_files_t *f,
+    const char *path,
+    size_t path_len,
+    int32_t fd,
+    const fossil__files_stat_t *st)
+{
+    char modified[32];
+    char etag[48];
+    char head[512];
+    const char *type = fossil__files_mime(path);
+    fossil__files_format_date((int64_t)st->st_mtime, modified);
+    snprintf(etag, sizeof(etag), "\"%llx-%llx\"",
+             (unsigned long long)st->st_size, (unsigned long long)st->st_mtime);
+    int type_len = snprintf(head, sizeof(head), "Content-Type: %s\r\n", type);
+    int n = snprintf(head + type_len, sizeof(head) - (size_t)type_len,
+                     "Last-Modified: %s\r\nETag: %s\r\nAccept-Ranges: bytes\r\n%s%s%s",
+                     modified, etag,
+                     f->cache_control ? "Cache-Control: " : "",
+                     f->cache_control ? f->cache_control : "",
+                     f->cache_control ? "\r\n" : "");
+    if (n < 0 || (size_t)(type_len + n) >= sizeof(head)) return NULL;
+
+    fossil__files_entry_t *e = calloc(1, sizeof(*e) + path_len + 1u + (size_t)(type_len + n));
+    if (!e) return NULL;
+    memcpy(e->path, path, path_len);
+    e->head = e->path + path_len + 1;
+    memcpy(e->head, head, (size_t)(type_len + n));
+    e->head_len = (uint32_t)(type_len + n);
+    e->type_len = (uint32_t)type_len;
+    memcpy(e->etag, etag, sizeof(etag));
+    memcpy(e->modified, modified, sizeof(modified));
+    e->hash = fossil__files_hash(path, path_len);
+    e->size = (uint64_t)st->st_size;
+    e->mtime = (int64_t)st->st_mtime;
+    e->ino = (uint64_t)st->st_ino;
+    e->fd = fd;
+    e->owner = fossil_net_buf_wrap(e, 0, fossil__files_entry_free, NULL);
+    if (!e->owner) {
+        free(e);
+        return NULL;
+    }
+    return e;
+}
+
+static fossil__files_entry_t *fossil__files_find(fossil_net_files_t *f, const char *path, size_t len, uint64_t hash) {
+    for (fossil__files_entry_t *e = f->buckets[hash & f->mask]; e; e = e->hnext)
+        if (e->hash == hash && strncmp(e->path, path, len) == 0 && e->path[len] == '\0')
+            return e;
+    return NULL;
+}
+
+static void fossil__files_lru_unlink(fossil_net_files_t *f, fossil__files_entry_t *e) {
+    if (e->prev) e->prev->next = e->next;
+    else f->lru_head = e->next;
+    if (e->next) e->next->prev = e->prev;
+    else f->lru_tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void fossil__files_lru_front(fossil_net_files_t *f, fossil__files_entry_t *e) {
+    if (f->lru_head == e) return;
+    if (e->prev || e->next || f->lru_tail == e) fossil__files_lru_unlink(f, e);
+    e->next = f->lru_head;
+    if (f->lru_head) f->lru_head->prev = e;
+    f->lru_head = e;
+    if (!f->lru_tail) f->lru_tail = e;
+}
+
+/* Drop the cache's reference; the caller holds the lock. */
+static void fossil__files_remove(fossil_net_files_t *f, fossil__files_entry_t *e) {
+    fossil__files_entry_t **pp = &f->buckets[e->hash & f->mask];
+    while (*pp && *pp != e) pp = &(*pp)->hnext;
+    if (!*pp) return;
+    *pp = e->hnext;
+    fossil__files_lru_unlink(f, e);
+    f->count--;
+    fossil_net_buf_unref(e->owner);
+}
+
+static bool fossil__files_same(const fossil__files_entry_t *e, const fossil__files_stat_t *st) {
+    return FOSSIL__FILES_ISREG(st->st_mode) && e->size == (uint64_t)st->st_size &&
+           e->mtime == (int64_t)st->st_mtime && e->ino == (uint64_t)st->st_ino;
+}
+
+/*
+ * Look up or open path; returns an entry holding a reference for the
+ * caller, or NULL with the status to answer (301 for a directory).
+ */
+static fossil__files_entry_t *fossil__files_acquire(fossil_net_files_t *f, const char *path, size_t len, int *status) {
+    uint64_t hash = fossil__files_hash(path, len);
+    uint64_t now = fossil_net_socket_clock_ns();
+
+    fossil__files_mutex_lock(&f->lock);
+    fossil__files_entry_t *e = fossil__files_find(f, path, len, hash);
+    bool fresh = false;
+    if (e) {
+        fossil_net_buf_ref(e->owner);
+        fresh = now - e->checked_ns < f->revalidate_ns;
+        if (fresh) fossil__files_lru_front(f, e);
+    }
+    fossil__files_mutex_unlock(&f->lock);
+
+    if (e && !fresh) {
+        /* Stat outside the lock; the reference keeps e alive meanwhile. */
+        fossil__files_stat_t st;
+        bool same = fossil__files_stat(path, &st) == 0 && fossil__files_same(e, &st);
+        fossil__files_mutex_lock(&f->lock);
+        if (fossil__files_find(f, path, len, hash) == e) {
+            if (same) {
+                e->checked_ns = now;
+                fossil__files_lru_front(f, e);
+            } else {
+                fossil__files_remove(f, e);
+            }
+        }
+        fossil__files_mutex_unlock(&f->lock);
+        if (same) {
+            fossil__files_count(&f->revalidations, 1);
+        } else {
+            fossil_net_buf_unref(e->owner);
+            e = NULL;
+        }
+    }
+    if (e) {
+        fossil__files_count(&f->hits, 1);
+        return e;
+    }
+
+    fossil__files_count(&f->misses, 1);
+    *status = 404;
+    int fd = fossil__files_open(path);
+    if (fd < 0) return NULL;
+    fossil__files_stat_t st;
+    if (fossil__files_fstat(fd, &st) != 0) {
+        fossil__files_close(fd);
+        return NULL;
+    }
+    if (!FOSSIL__FILES_ISREG(st.st_mode)) {
+        if (FOSSIL__FILES_ISDIR(st.st_mode)) *status = 301;
+        fossil__files_close(fd);
+        return NULL;
+    }
+    e = fossil__files_entry_new(f, path, len, fd, &st);
+    if (!e) {
+        fossil__files_close(fd);
+        *status = 500;
+        return NULL;
+    }
+    e->checked_ns = now;
+
+    fossil__files_mutex_lock(&f->lock);
+    fossil__files_entry_t *raced = fossil__files_find(f, path, len, hash);
+    if (raced) {
+        /* Another loop opened it first; keep theirs. */
+        fossil_net_buf_ref(raced->owner);
+        fossil__files_lru_front(f, raced);
+        fossil__files_mutex_unlock(&f->lock);
+        fossil_net_buf_unref(e->owner);
+        return raced;
+    }
+    e->hnext = f->buckets[hash & f->mask];
+    f->buckets[hash & f->mask] = e;
+    fossil__files_lru_front(f, e);
+    f->count++;
+    fossil_net_buf_ref(e->owner);
+    uint32_t evicted = 0;
+    while (f->count > f->max_open) {
+        fossil__files_remove(f, f->lru_tail);
+        evicted++;
+    }
+    fossil__files_mutex_unlock(&f->lock);
+    if (evicted) fossil__files_count(&f->evictions, evicted);
+    return e;
+}
+
+/*=============================================================================
+REQUESTS
+=============================================================================*/
+
+static int fossil__files_hex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = (char)(c | 0x20);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* Percent-decode a URL path and refuse anything that could leave the root. */
+static int fossil__files_decode(const char *in, uint32_t len, char *out, size_t cap) {
+    size_t n = 0;
+    if (len == 0 || in[0] != '/') out[n++] = '/';
+    for (uint32_t i = 0; i < len; i++) {
+        char c = in[i];
+        if (c == '%') {
+            int hi = i + 2 < len ? fossil__files_hex(in[i + 1]) : -1;
+            int lo = i + 2 < len ? fossil__files_hex(in[i + 2]) : -1;
+            if (hi < 0 || lo < 0) return -1;
+            c = (char)(hi << 4 | lo);
+            i += 2;
+        }
+        if (c == '\0' || c == '\\' || n + 1 >= cap) return -1;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    for (const char *s = out; (s = strstr(s, "/..")) != NULL; s += 3)
+        if (s[3] == '/' || s[3] == '\0') return -1;
+    return (int)n;
+}
+
+static bool fossil__files_number(const char **p, const char *end, uint64_t *out) {
+    const char *s = *p;
+    uint64_t v = 0;
+    while (*p < end && **p >= '0' && **p <= '9') {
+        if (v > (UINT64_MAX - 9u) / 10u) return false;
+        v = v * 10u + (uint64_t)(**p - '0');
+        (*p)++;
+    }
+    *out = v;
+    return *p > s;
+}
+
+/* 1: one satisfiable range, 0: ignore the header, -1: unsatisfiable. */
+static int fossil__files_range(fossil_net_slice_t v, uint64_t size, uint64_t *start, uint64_t *len) {
+    const char *p = v.ptr;
+    const char *end = v.ptr + v.len;
+    if (v.len < 6 || memcmp(p, "bytes=", 6) != 0 || memchr(p, ',', v.len)) return 0;
+    p += 6;
+    while (p < end && *p == ' ') p++;
+    while (end > p && end[-1] == ' ') end--;
+    uint64_t a = 0, b = 0;
+    if (p < end && *p == '-') {
+        p++;
+        if (!fossil__files_number(&p, end, &b) || p != end) return 0;
+        if (b == 0 || size == 0) return -1;
+        if (b > size) b = size;
+        *start = size - b;
+        *len = b;
+        return 1;
+    }
+    if (!fossil__files_number(&p, end, &a) || p == end || *p++ != '-') return 0;
+    if (p == end) b = UINT64_MAX;
+    else if (!fossil__files_number(&p, end, &b) || p != end || b < a) return 0;
+    if (a >= size) return -1;
+    if (b >= size) b = size - 1u;
+    *start = a;
+    *len = b - a + 1u;
+    return 1;
+}
+
+static int fossil__files_redirect(
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req)
+{
+    char location[FOSSIL__FILES_MAX_PATH + 2];
+    int n = snprintf(location, sizeof(location), "%.*s/%s%.*s",
+                     (int)req->path.len, req->path.ptr, req->query.len ? "?" : "",
+                     (int)req->query.len, req->query.ptr);
+    if (n < 0 || (size_t)n >= sizeof(location) || fossil_net_http_add_header(ex, "Location", location) != 0)
+        return fossil_net_http_respond(ex, 404, "text/plain", "Not Found", 9);
+    return fossil_net_http_respond(ex, 301, "text/plain", "Moved Permanently", 17);
+}
+
+static int fossil__files_send(
+    fossil_net_files_t *f,
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req,
+    fossil__files_entry_t *e)
+{
+    fossil_net_slice_t v;
+    bool not_modified = false;
+    int64_t since;
+    if (fossil_net_http_request_header(req, "If-None-Match", &v))
+        not_modified = fossil_net_http_etag_match(v, e->etag);
+    else if (fossil_net_http_request_header(req, "If-Modified-Since", &v) && fossil__files_parse_date(v, &since))
+        not_modified = e->mtime <= since;
+    if (not_modified) {
+        fossil__files_count(&f->not_modified, 1);
+        return fossil_net_http_respond_file(ex, 304, e->head + e->type_len, e->head_len - e->type_len,
+                                            NULL, -1, 0, 0);
+    }
+
+    uint64_t start = 0;
+    uint64_t len = e->size;
+    int status = 200;
+    if (req->method == FOSSIL_NET_HTTP_GET && fossil_net_http_request_header(req, "Range", &v)) {
+        fossil_net_slice_t cond;
+        bool current = !fossil_net_http_request_header(req, "If-Range", &cond) ||
+                       fossil_net_slice_eq(cond, e->etag) || fossil_net_slice_eq(cond, e->modified);
+        int rc = current ? fossil__files_range(v, e->size, &start, &len) : 0;
+        char range[64];
+        if (rc < 0) {
+            snprintf(range, sizeof(range), "bytes */%llu", (unsigned long long)e->size);
+            fossil_net_http_add_header(ex, "Content-Range", range);
+            return fossil_net_http_respond(ex, 416, "text/plain", "Range Not Satisfiable", 21);
+        }
+        if (rc > 0) {
+            snprintf(range, sizeof(range), "bytes %llu-%llu/%llu", (unsigned long long)start,
+                     (unsigned long long)(start + len - 1u), (unsigned long long)e->size);
+            if (fossil_net_http_add_header(ex, "Content-Range", range) != 0) return -1;
+            status = 206;
+            fossil__files_count(&f->partial, 1);
+        }
+    }
+    if (req->method != FOSSIL_NET_HTTP_HEAD) fossil__files_count(&f->bytes, len);
+    return fossil_net_http_respond_file(ex, status, e->head, e->head_len, e->owner, e->fd, start, len);
+}
+
+/*=============================================================================
+FILES
+=============================================================================*/
+
+fossil_net_files_t *fossil_net_files_create(const fossil_net_files_config_t *config) {
+    if (!config || !config->root || !config->root[0]) return NULL;
+    if (config->cache_control && strpbrk(config->cache_control, "\r\n")) return NULL;
+    if (config->index && (strchr(config->index, '/') || strchr(config->index, '\\'))) return NULL;
+    fossil_net_files_t *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    f->max_open = config->max_open ? config->max_open : FOSSIL__FILES_MAX_OPEN;
+    f->revalidate_ns = config->revalidate_ns ? config->revalidate_ns : FOSSIL__FILES_REVALIDATE;
+    uint32_t buckets = 16u;
+    while (buckets < f->max_open * 2u && buckets < (1u << 24)) buckets *= 2u;
+    f->mask = buckets - 1u;
+    f->buckets = calloc(buckets, sizeof(*f->buckets));
+    f->root = fossil__files_strdup(config->root);
+    f->index = fossil__files_strdup(config->index ? config->index : "index.html");
+    f->cache_control = config->cache_control ? fossil__files_strdup(config->cache_control) : NULL;
+    if (!f->buckets || !f->root || !f->index || (config->cache_control && !f->cache_control)) {
+        free(f->buckets);
+        free(f->root);
+        free(f->index);
+        free(f->cache_control);
+        free(f);
+        return NULL;
+    }
+    f->root_len = (uint32_t)strlen(f->root);
+    while (f->root_len > 1 && f->root[f->root_len - 1] == '/') f->root[--f->root_len] = '\0';
+    fossil__files_mutex_init(&f->lock);
+    return f;
+}
+
+void fossil_net_files_destroy(fossil_net_files_t *files) {
+    if (!files) return;
+    while (files->lru_head) fossil__files_remove(files, files->lru_head);
+    fossil__files_mutex_destroy(&files->lock);
+    free(files->buckets);
+    free(files->root);
+    free(files->index);
+    free(files->cache_control);
+    free(files);
+}
+
+void fossil_net_files_handler(
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req,
+    void *user)
+{
+    fossil_net_slice_t path;
+    if (!fossil_net_http_param(ex, "path", &path)) path = req->path;
+    if (fossil_net_files_serve(user, ex, req, path.ptr, (uint32_t)path.len) != 0)
+        fossil_net_http_respond(ex, 500, "text/plain", "Internal Server Error", 21);
+}
+
+int fossil_net_files_serve(
+    fossil_net_files_t *files,
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req,
+    const char *path,
+    uint32_t len)
+{
+    if (!files || !ex || !req || (!path && len)) return -1;
+    if (req->method != FOSSIL_NET_HTTP_GET && req->method != FOSSIL_NET_HTTP_HEAD) {
+        fossil_net_http_add_header(ex, "Allow", "GET, HEAD");
+        return fossil_net_http_respond(ex, 405, "text/plain", "Method Not Allowed", 18);
+    }
+
+    char fs[FOSSIL__FILES_MAX_PATH];
+    size_t index_len = strlen(files->index);
+    memcpy(fs, files->root, files->root_len);
+    int n = fossil__files_decode(path, len, fs + files->root_len,
+                                 sizeof(fs) - files->root_len - index_len);
+    if (n < 0) {
+        fossil__files_count(&files->not_found, 1);
+        return fossil_net_http_respond(ex, 404, "text/plain", "Not Found", 9);
+    }
+    size_t fs_len = files->root_len + (size_t)n;
+    bool dir = fs[fs_len - 1] == '/';
+    if (dir) {
+        memcpy(fs + fs_len, files->index, index_len + 1u);
+        fs_len += index_len;
+    }
+
+    int status = 404;
+    fossil__files_entry_t *e = fossil__files_acquire(files, fs, fs_len, &status);
+    if (!e) {
+        if (status == 301 && !dir) return fossil__files_redirect(ex, req);
+        if (status == 500) return -1;
+        fossil__files_count(&files->not_found, 1);
+        return fossil_net_http_respond(ex, 404, "text/plain", "Not Found", 9);
+    }
+    int rc = fossil__files_send(files, ex, req, e);
+    fossil_net_buf_unref(e->owner);
+    return rc;
+}
+
+int fossil_net_files_get_stats(fossil_net_files_t *files, fossil_net_files_stats_t *stats) {
+    if (!files || !stats) return -1;
+    stats->hits = atomic_load_explicit(&files->hits, memory_order_relaxed);
+    stats->misses = atomic_load_explicit(&files->misses, memory_order_relaxed);
+    stats->evictions = atomic_load_explicit(&files->evictions, memory_order_relaxed);
+    stats->revalidations = atomic_load_explicit(&files->revalidations, memory_order_relaxed);
+    stats->not_found = atomic_load_explicit(&files->not_found, memory_order_relaxed);
+    stats->not_modified = atomic_load_explicit(&files->not_modified, memory_order_relaxed);
+    stats->partial = atomic_load_explicit(&files->partial, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&files->bytes, memory_order_relaxed);
+    return 0;
+}
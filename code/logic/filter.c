@@ -0,0 +1,699 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/filter.h"
+#include "fossil/network/inet.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <linux/filter.h>
+#endif
+
+/*=============================================================================
+CLASSIC BPF ENCODING
+=============================================================================*/
+
+/* Opcode fields, as in <linux/bpf_common.h>; spelled out for portability. */
+enum {
+    FBPF_LD = 0x00, FBPF_LDX = 0x01, FBPF_ST = 0x02, FBPF_STX = 0x03,
+    FBPF_ALU = 0x04, FBPF_JMP = 0x05, FBPF_RET = 0x06, FBPF_MISC = 0x07,
+
+    FBPF_W = 0x00, FBPF_H = 0x08, FBPF_B = 0x10,
+
+    FBPF_IMM = 0x00, FBPF_ABS = 0x20, FBPF_IND = 0x40, FBPF_MEM = 0x60,
+    FBPF_LEN = 0x80, FBPF_MSH = 0xa0,
+
+    FBPF_ADD = 0x00, FBPF_SUB = 0x10, FBPF_MUL = 0x20, FBPF_DIV = 0x30,
+    FBPF_OR = 0x40, FBPF_AND = 0x50, FBPF_LSH = 0x60, FBPF_RSH = 0x70,
+    FBPF_NEG = 0x80, FBPF_MOD = 0x90, FBPF_XOR = 0xa0,
+
+    FBPF_JA = 0x00, FBPF_JEQ = 0x10, FBPF_JGT = 0x20, FBPF_JGE = 0x30, FBPF_JSET = 0x40,
+
+    FBPF_K = 0x00, FBPF_X = 0x08, FBPF_A = 0x10,
+
+    FBPF_TAX = 0x00, FBPF_TXA = 0x80
+};
+
+/* Negative load offsets understood by the kernel. */
+#define FOSSIL__SKF_AD_OFF  (-0x1000)
+#define FOSSIL__SKF_NET_OFF (-0x100000)
+#define FOSSIL__SKF_LL_OFF  (-0x200000)
+#define FOSSIL__NET(off)    ((uint32_t)(FOSSIL__SKF_NET_OFF + (off)))
+
+#define FOSSIL__FILTER_MEMWORDS 16
+
+struct fossil_net_filter {
+    uint32_t count;
+    fossil_net_filter_insn_t insns[];
+};
+
+fossil_net_filter_t *fossil_net_filter_create(const fossil_net_filter_insn_t *insns, uint32_t count) {
+    if (!insns || count == 0 || count > FOSSIL_NET_FILTER_MAX_INSNS) return NULL;
+    fossil_net_filter_t *f = malloc(sizeof(*f) + (size_t)count * sizeof(*insns));
+    if (!f) return NULL;
+    f->count = count;
+    memcpy(f->insns, insns, (size_t)count * sizeof(*insns));
+    return f;
+}
+
+void fossil_net_filter_destroy(fossil_net_filter_t *filter) {
+    free(filter);
+}
+
+const fossil_net_filter_insn_t *fossil_net_filter_program(const fossil_net_filter_t *filter, uint32_t *count) {
+    if (count) *count = filter ? filter->count : 0;
+    return filter ? filter->insns : NULL;
+}
+
+#define FOSSIL__SKF_AD_CPU 36
+#define FOSSIL__REUSEPORT_MAX_CPUS 254u  /* jumps over the table must fit in jt */
+
+fossil_net_filter_t *fossil_net_filter_reuseport_cpu(const int32_t *cpus, uint32_t count) {
+    if (!cpus || count == 0 || count > FOSSIL__REUSEPORT_MAX_CPUS) return NULL;
+    /* ld cpu; jeq cpus[i] -> ret i; otherwise ret cpu % count */
+    fossil_net_filter_insn_t insns[FOSSIL__REUSEPORT_MAX_CPUS * 2 + 3];
+    uint32_t n = 0;
+    insns[n++] = (fossil_net_filter_insn_t){FBPF_LD | FBPF_W | FBPF_ABS, 0, 0, (uint32_t)(FOSSIL__SKF_AD_OFF + FOSSIL__SKF_AD_CPU)};
+    for (uint32_t i = 0; i < count; i++) {
+        if (cpus[i] < 0) return NULL;
+        insns[n++] = (fossil_net_filter_insn_t){FBPF_JMP | FBPF_JEQ | FBPF_K, (uint8_t)(count + 1), 0, (uint32_t)cpus[i]};
+    }
+    insns[n++] = (fossil_net_filter_insn_t){FBPF_ALU | FBPF_MOD | FBPF_K, 0, 0, count};
+    insns[n++] = (fossil_net_filter_insn_t){FBPF_RET | FBPF_A, 0, 0, 0};
+    for (uint32_t i = 0; i < count; i++)
+        insns[n++] = (fossil_net_filter_insn_t){FBPF_RET | FBPF_K, 0, 0, i};
+    return fossil_net_filter_create(insns, n);
+}
+
+/*=============================================================================
+EXPRESSION PARSER
+=============================================================================*/
+
+typedef enum {
+    FOSSIL__FN_AND,
+    FOSSIL__FN_OR,
+    FOSSIL__FN_NOT,
+    FOSSIL__FN_IP,
+    FOSSIL__FN_IP6,
+    FOSSIL__FN_PROTO,
+    FOSSIL__FN_HOST, /* host and net share one node; host is a full-length prefix */
+    FOSSIL__FN_PORT
+} fossil__fnode_kind_t;
+
+typedef enum { FOSSIL__DIR_ANY, FOSSIL__DIR_SRC, FOSSIL__DIR_DST } fossil__fdir_t;
+
+typedef struct fossil__fnode {
+    uint8_t kind;
+    uint8_t dir;
+    uint8_t family;  /* FOSSIL_NET_SOCKET_FAMILY_* for host/net */
+    uint8_t prefix;
+    uint16_t value;  /* protocol number or port */
+    uint8_t addr[16];
+    int16_t left, right;
+} fossil__fnode_t;
+
+#define FOSSIL__FILTER_NODES 128
+
+typedef struct fossil__fparser {
+    const char *p;
+    char tok[64];
+    fossil__fnode_t nodes[FOSSIL__FILTER_NODES];
+    int count;
+    bool error;
+} fossil__fparser_t;
+
+/* Read the next token into ps->tok; returns false at end of input. */
+static bool fossil__fpeek(fossil__fparser_t *ps, char *out, size_t size, const char **after) {
+    const char *p = ps->p;
+    while (*p && isspace((unsigned char)*p)) ++p;
+    if (!*p) return false;
+    size_t n = 0;
+    if (*p == '(' || *p == ')' || *p == '!') {
+        n = 1;
+    } else if ((p[0] == '&' && p[1] == '&') || (p[0] == '|' && p[1] == '|')) {
+        n = 2;
+    } else {
+        while (p[n] && !isspace((unsigned char)p[n]) && p[n] != '(' && p[n] != ')' &&
+               p[n] != '!' && p[n] != '&' && p[n] != '|') ++n;
+    }
+    if (n == 0 || n >= size) return false;
+    memcpy(out, p, n);
+    out[n] = '\0';
+    *after = p + n;
+    return true;
+}
+
+static bool fossil__fnext(fossil__fparser_t *ps) {
+    const char *after;
+    if (!fossil__fpeek(ps, ps->tok, sizeof(ps->tok), &after)) {
+        ps->tok[0] = '\0';
+        return false;
+    }
+    ps->p = after;
+    return true;
+}
+
+static bool fossil__fis(const fossil__fparser_t *ps, const char *a, const char *b) {
+    return !strcmp(ps->tok, a) || (b && !strcmp(ps->tok, b));
+}
+
+static int fossil__fnode(fossil__fparser_t *ps, uint8_t kind, int left, int right) {
+    if (ps->count >= FOSSIL__FILTER_NODES) {
+        ps->error = true;
+        return -1;
+    }
+    fossil__fnode_t *n = &ps->nodes[ps->count];
+    memset(n, 0, sizeof(*n));
+    n->kind = kind;
+    n->left = (int16_t)left;
+    n->right = (int16_t)right;
+    return ps->count++;
+}
+
+static bool fossil__fparse_number(const char *s, uint32_t max, uint32_t *out) {
+    if (!*s) return false;
+    uint32_t v = 0;
+    for (; *s; ++s) {
+        if (*s < '0' || *s > '9') return false;
+        v = v * 10 + (uint32_t)(*s - '0');
+        if (v > max) return false;
+    }
+    *out = v;
+    return true;
+}
+
+static bool fossil__fparse_addr(fossil__fnode_t *n, const char *s, bool allow_prefix) {
+    char ip[64];
+    const char *slash = strchr(s, '/');
+    size_t len = slash ? (size_t)(slash - s) : strlen(s);
+    if (len == 0 || len >= sizeof(ip) || (slash && !allow_prefix)) return false;
+    memcpy(ip, s, len);
+    ip[len] = '\0';
+    if (fossil_net_inet_ipv4_parse(ip, n->addr) == 0) {
+        n->family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+        n->prefix = 32;
+    } else if (fossil_net_inet_ipv6_parse(ip, n->addr) == 0) {
+        n->family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        n->prefix = 128;
+    } else {
+        return false;
+    }
+    if (slash) {
+        uint32_t prefix;
+        if (!fossil__fparse_number(slash + 1, n->prefix, &prefix)) return false;
+        n->prefix = (uint8_t)prefix;
+    }
+    return true;
+}
+
+static int fossil__fparse_or(fossil__fparser_t *ps);
+
+static int fossil__fparse_primary(fossil__fparser_t *ps) {
+    if (fossil__fis(ps, "not", "!")) {
+        fossil__fnext(ps);
+        int inner = fossil__fparse_primary(ps);
+        return inner < 0 ? -1 : fossil__fnode(ps, FOSSIL__FN_NOT, inner, -1);
+    }
+    if (fossil__fis(ps, "(", NULL)) {
+        fossil__fnext(ps);
+        int inner = fossil__fparse_or(ps);
+        if (inner < 0 || !fossil__fis(ps, ")", NULL)) return -1;
+        fossil__fnext(ps);
+        return inner;
+    }
+
+    static const struct { const char *name; uint8_t kind; uint16_t proto; } protos[] = {
+        { "ip", FOSSIL__FN_IP, 0 }, { "ip6", FOSSIL__FN_IP6, 0 },
+        { "tcp", FOSSIL__FN_PROTO, 6 }, { "udp", FOSSIL__FN_PROTO, 17 },
+        { "icmp", FOSSIL__FN_PROTO, 1 }, { "icmp6", FOSSIL__FN_PROTO, 58 }
+    };
+    for (size_t i = 0; i < sizeof(protos) / sizeof(protos[0]); ++i) {
+        if (fossil__fis(ps, protos[i].name, NULL)) {
+            fossil__fnext(ps);
+            int n = fossil__fnode(ps, protos[i].kind, -1, -1);
+            if (n >= 0) ps->nodes[n].value = protos[i].proto;
+            return n;
+        }
+    }
+
+    uint8_t dir = FOSSIL__DIR_ANY;
+    if (fossil__fis(ps, "src", NULL)) dir = FOSSIL__DIR_SRC;
+    else if (fossil__fis(ps, "dst", NULL)) dir = FOSSIL__DIR_DST;
+    if (dir != FOSSIL__DIR_ANY) fossil__fnext(ps);
+
+    bool is_host = fossil__fis(ps, "host", NULL);
+    bool is_net = fossil__fis(ps, "net", NULL);
+    bool is_port = fossil__fis(ps, "port", NULL);
+    if (!is_host && !is_net && !is_port) return -1;
+    if (!fossil__fnext(ps)) return -1;
+
+    int n = fossil__fnode(ps, is_port ? FOSSIL__FN_PORT : FOSSIL__FN_HOST, -1, -1);
+    if (n < 0) return -1;
+    fossil__fnode_t *node = &ps->nodes[n];
+    node->dir = dir;
+    if (is_port) {
+        uint32_t port;
+        if (!fossil__fparse_number(ps->tok, 65535, &port)) return -1;
+        node->value = (uint16_t)port;
+    } else if (!fossil__fparse_addr(node, ps->tok, is_net)) {
+        return -1;
+    }
+    fossil__fnext(ps);
+    return n;
+}
+
+static int fossil__fparse_and(fossil__fparser_t *ps) {
+    int left = fossil__fparse_primary(ps);
+    while (left >= 0 && ps->tok[0] && !fossil__fis(ps, ")", NULL) && !fossil__fis(ps, "or", "||")) {
+        if (fossil__fis(ps, "and", "&&")) fossil__fnext(ps);
+        int right = fossil__fparse_primary(ps);
+        if (right < 0) return -1;
+        left = fossil__fnode(ps, FOSSIL__FN_AND, left, right);
+    }
+    return left;
+}
+
+static int fossil__fparse_or(fossil__fparser_t *ps) {
+    int left = fossil__fparse_and(ps);
+    while (left >= 0 && fossil__fis(ps, "or", "||")) {
+        fossil__fnext(ps);
+        int right = fossil__fparse_and(ps);
+        if (right < 0) return -1;
+        left = fossil__fnode(ps, FOSSIL__FN_OR, left, right);
+    }
+    return left;
+}
+
+/*=============================================================================
+CODE GENERATION
+=============================================================================*/
+
+/*
+ * Code is generated with symbolic jump targets and resolved at the end.
+ * Every predicate is compiled against a "true" and a "false" label, so
+ * and/or/not cost no instructions of their own. Classic BPF only jumps
+ * forward, which this scheme never violates.
+ */
+#define FOSSIL__FGEN_MAX    512
+#define FOSSIL__FGEN_LABELS 256
+#define FOSSIL__NEXT        (-1)
+
+typedef struct fossil__fgen {
+    fossil_net_filter_insn_t insns[FOSSIL__FGEN_MAX];
+    int16_t jt[FOSSIL__FGEN_MAX];
+    int16_t jf[FOSSIL__FGEN_MAX];
+    uint32_t count;
+    int32_t label_pos[FOSSIL__FGEN_LABELS];
+    int labels;
+    bool error;
+} fossil__fgen_t;
+
+static int fossil__flabel(fossil__fgen_t *g) {
+    if (g->labels >= FOSSIL__FGEN_LABELS) {
+        g->error = true;
+        return 0;
+    }
+    g->label_pos[g->labels] = -1;
+    return g->labels++;
+}
+
+static void fossil__fplace(fossil__fgen_t *g, int label) {
+    g->label_pos[label] = (int32_t)g->count;
+}
+
+static void fossil__femit(fossil__fgen_t *g, uint16_t code, uint32_t k, int jt, int jf) {
+    if (g->count >= FOSSIL__FGEN_MAX) {
+        g->error = true;
+        return;
+    }
+    fossil_net_filter_insn_t *i = &g->insns[g->count];
+    i->code = code;
+    i->k = k;
+    i->jt = 0;
+    i->jf = 0;
+    g->jt[g->count] = (int16_t)jt;
+    g->jf[g->count] = (int16_t)jf;
+    g->count++;
+}
+
+#define FOSSIL__STMT(g, code, k) fossil__femit((g), (uint16_t)(code), (k), FOSSIL__NEXT, FOSSIL__NEXT)
+
+/* A = IP version; branch on it. */
+static void fossil__fgen_version(fossil__fgen_t *g, uint32_t version, int yes, int no) {
+    FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(0));
+    FOSSIL__STMT(g, FBPF_ALU | FBPF_RSH | FBPF_K, 4);
+    fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, version, yes, no);
+}
+
+/* Compare the address at network offset off against node's address/prefix. */
+static void fossil__fgen_addr(fossil__fgen_t *g, const fossil__fnode_t *n, uint32_t off, int yes, int no) {
+    uint32_t words = n->family == FOSSIL_NET_SOCKET_FAMILY_IPV4 ? 1 : 4;
+    int last = -1;
+    for (uint32_t w = 0; w < words; ++w) {
+        if (n->prefix > w * 32) last = (int)w;
+    }
+    if (last < 0) {
+        fossil__femit(g, FBPF_JMP | FBPF_JA, 0, yes, FOSSIL__NEXT);
+        return;
+    }
+    for (int w = 0; w <= last; ++w) {
+        uint32_t bits = n->prefix - (uint32_t)w * 32;
+        uint32_t mask = bits >= 32 ? 0xffffffffu : ~(0xffffffffu >> bits);
+        uint32_t value = ((uint32_t)n->addr[w * 4] << 24) | ((uint32_t)n->addr[w * 4 + 1] << 16) |
+                         ((uint32_t)n->addr[w * 4 + 2] << 8) | (uint32_t)n->addr[w * 4 + 3];
+        FOSSIL__STMT(g, FBPF_LD | FBPF_W | FBPF_ABS, FOSSIL__NET(off + (uint32_t)w * 4));
+        if (mask != 0xffffffffu) FOSSIL__STMT(g, FBPF_ALU | FBPF_AND | FBPF_K, mask);
+        fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, value & mask, w == last ? yes : FOSSIL__NEXT, no);
+    }
+}
+
+/* X holds the transport header offset; compare its ports. */
+static void fossil__fgen_ports(fossil__fgen_t *g, const fossil__fnode_t *n, int yes, int no) {
+    if (n->dir != FOSSIL__DIR_DST) {
+        FOSSIL__STMT(g, FBPF_LD | FBPF_H | FBPF_IND, FOSSIL__NET(0));
+        fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, n->value, yes, n->dir == FOSSIL__DIR_SRC ? no : FOSSIL__NEXT);
+    }
+    if (n->dir != FOSSIL__DIR_SRC) {
+        FOSSIL__STMT(g, FBPF_LD | FBPF_H | FBPF_IND, FOSSIL__NET(2));
+        fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, n->value, yes, no);
+    }
+}
+
+static void fossil__fgen(fossil__fgen_t *g, const fossil__fparser_t *ps, int index, int yes, int no) {
+    const fossil__fnode_t *n = &ps->nodes[index];
+    switch (n->kind) {
+        case FOSSIL__FN_AND: {
+            int mid = fossil__flabel(g);
+            fossil__fgen(g, ps, n->left, mid, no);
+            fossil__fplace(g, mid);
+            fossil__fgen(g, ps, n->right, yes, no);
+            break;
+        }
+        case FOSSIL__FN_OR: {
+            int mid = fossil__flabel(g);
+            fossil__fgen(g, ps, n->left, yes, mid);
+            fossil__fplace(g, mid);
+            fossil__fgen(g, ps, n->right, yes, no);
+            break;
+        }
+        case FOSSIL__FN_NOT:
+            fossil__fgen(g, ps, n->left, no, yes);
+            break;
+        case FOSSIL__FN_IP:
+            fossil__fgen_version(g, 4, yes, no);
+            break;
+        case FOSSIL__FN_IP6:
+            fossil__fgen_version(g, 6, yes, no);
+            break;
+        case FOSSIL__FN_PROTO: {
+            if (n->value == 1 || n->value == 58) {
+                bool v4 = n->value == 1;
+                fossil__fgen_version(g, v4 ? 4 : 6, FOSSIL__NEXT, no);
+                FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(v4 ? 9 : 6));
+                fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, n->value, yes, no);
+                break;
+            }
+            int v6 = fossil__flabel(g);
+            fossil__fgen_version(g, 4, FOSSIL__NEXT, v6);
+            FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(9));
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, n->value, yes, no);
+            fossil__fplace(g, v6); // A still holds the version
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, 6, FOSSIL__NEXT, no);
+            FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(6));
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, n->value, yes, no);
+            break;
+        }
+        case FOSSIL__FN_HOST: {
+            bool v4 = n->family == FOSSIL_NET_SOCKET_FAMILY_IPV4;
+            uint32_t src = v4 ? 12 : 8, dst = v4 ? 16 : 24;
+            fossil__fgen_version(g, v4 ? 4 : 6, FOSSIL__NEXT, no);
+            if (n->dir == FOSSIL__DIR_SRC) {
+                fossil__fgen_addr(g, n, src, yes, no);
+            } else if (n->dir == FOSSIL__DIR_DST) {
+                fossil__fgen_addr(g, n, dst, yes, no);
+            } else {
+                int alt = fossil__flabel(g);
+                fossil__fgen_addr(g, n, src, yes, alt);
+                fossil__fplace(g, alt);
+                fossil__fgen_addr(g, n, dst, yes, no);
+            }
+            break;
+        }
+        case FOSSIL__FN_PORT: {
+            int v6 = fossil__flabel(g), v4ok = fossil__flabel(g), v6ok = fossil__flabel(g);
+            fossil__fgen_version(g, 4, FOSSIL__NEXT, v6);
+            FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(9));
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, 6, v4ok, FOSSIL__NEXT);
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, 17, v4ok, no);
+            fossil__fplace(g, v4ok);
+            // Only the first fragment carries the transport header
+            FOSSIL__STMT(g, FBPF_LD | FBPF_H | FBPF_ABS, FOSSIL__NET(6));
+            fossil__femit(g, FBPF_JMP | FBPF_JSET | FBPF_K, 0x1fff, no, FOSSIL__NEXT);
+            FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(0));
+            FOSSIL__STMT(g, FBPF_ALU | FBPF_AND | FBPF_K, 0x0f);
+            FOSSIL__STMT(g, FBPF_ALU | FBPF_LSH | FBPF_K, 2);
+            FOSSIL__STMT(g, FBPF_MISC | FBPF_TAX, 0);
+            fossil__fgen_ports(g, n, yes, no);
+            fossil__fplace(g, v6);
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, 6, FOSSIL__NEXT, no);
+            FOSSIL__STMT(g, FBPF_LD | FBPF_B | FBPF_ABS, FOSSIL__NET(6));
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, 6, v6ok, FOSSIL__NEXT);
+            fossil__femit(g, FBPF_JMP | FBPF_JEQ | FBPF_K, 17, v6ok, no);
+            fossil__fplace(g, v6ok);
+            FOSSIL__STMT(g, FBPF_LDX | FBPF_W | FBPF_IMM, 40);
+            fossil__fgen_ports(g, n, yes, no);
+            break;
+        }
+        default:
+            g->error = true;
+            break;
+    }
+}
+
+static bool fossil__fresolve(fossil__fgen_t *g) {
+    for (uint32_t i = 0; i < g->count; ++i) {
+        fossil_net_filter_insn_t *insn = &g->insns[i];
+        int16_t targets[2] = { g->jt[i], g->jf[i] };
+        for (int t = 0; t < 2; ++t) {
+            if (targets[t] == FOSSIL__NEXT) continue;
+            int32_t pos = g->label_pos[targets[t]];
+            if (pos < 0) return false;
+            int32_t off = pos - (int32_t)(i + 1);
+            if (insn->code == (FBPF_JMP | FBPF_JA)) {
+                if (off < 0) return false;
+                insn->k = (uint32_t)off;
+                continue;
+            }
+            if (off < 0 || off > 255) return false;
+            if (t == 0) insn->jt = (uint8_t)off;
+            else insn->jf = (uint8_t)off;
+        }
+    }
+    return true;
+}
+
+fossil_net_filter_t *fossil_net_filter_compile(const char *expression) {
+    if (!expression) return NULL;
+    fossil__fparser_t *ps = calloc(1, sizeof(*ps));
+    fossil__fgen_t *g = calloc(1, sizeof(*g));
+    fossil_net_filter_t *f = NULL;
+    if (!ps || !g) goto done;
+
+    ps->p = expression;
+    fossil__fnext(ps);
+    if (!ps->tok[0]) {
+        FOSSIL__STMT(g, FBPF_RET | FBPF_K, 0xffffffffu);
+    } else {
+        int root = fossil__fparse_or(ps);
+        if (root < 0 || ps->error || ps->tok[0]) goto done;
+        int accept = fossil__flabel(g), reject = fossil__flabel(g);
+        fossil__fgen(g, ps, root, accept, reject);
+        fossil__fplace(g, accept);
+        FOSSIL__STMT(g, FBPF_RET | FBPF_K, 0xffffffffu);
+        fossil__fplace(g, reject);
+        FOSSIL__STMT(g, FBPF_RET | FBPF_K, 0);
+    }
+    if (g->error || !fossil__fresolve(g)) goto done;
+    f = fossil_net_filter_create(g->insns, g->count);
+
+done:
+    free(ps);
+    free(g);
+    return f;
+}
+
+/*=============================================================================
+INTERPRETER
+=============================================================================*/
+
+static bool fossil__fload(const uint8_t *pkt, uint32_t size, uint32_t net, int64_t k, uint32_t width, uint32_t *out) {
+    int64_t off;
+    if (k >= 0) off = k;
+    else if (k >= FOSSIL__SKF_AD_OFF) return false; // ancillary data is kernel-only
+    else if (k >= FOSSIL__SKF_NET_OFF) off = (int64_t)net + (k - FOSSIL__SKF_NET_OFF);
+    else if (k >= FOSSIL__SKF_LL_OFF) off = k - FOSSIL__SKF_LL_OFF;
+    else return false;
+    if (off < 0 || off + width > size) return false;
+    const uint8_t *p = pkt + off;
+    switch (width) {
+        case 1: *out = p[0]; break;
+        case 2: *out = ((uint32_t)p[0] << 8) | p[1]; break;
+        default: *out = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]; break;
+    }
+    return true;
+}
+
+uint32_t fossil_net_filter_run(const fossil_net_filter_t *filter, const void *packet, uint32_t size, uint32_t net_offset) {
+    if (!filter || (!packet && size)) return 0;
+    const uint8_t *pkt = packet;
+    uint32_t A = 0, X = 0, mem[FOSSIL__FILTER_MEMWORDS] = {0};
+
+    for (uint32_t pc = 0; pc < filter->count; ++pc) {
+        const fossil_net_filter_insn_t *i = &filter->insns[pc];
+        uint32_t cls = i->code & 0x07;
+        uint32_t width = (i->code & 0x18) == FBPF_B ? 1 : (i->code & 0x18) == FBPF_H ? 2 : 4;
+        uint32_t src = (i->code & FBPF_X) ? X : i->k;
+        switch (cls) {
+            case FBPF_LD:
+                switch (i->code & 0xe0) {
+                    case FBPF_IMM: A = i->k; break;
+                    case FBPF_ABS: if (!fossil__fload(pkt, size, net_offset, (int32_t)i->k, width, &A)) return 0; break;
+                    case FBPF_IND: if (!fossil__fload(pkt, size, net_offset, (int32_t)(X + i->k), width, &A)) return 0; break;
+                    case FBPF_MEM: if (i->k >= FOSSIL__FILTER_MEMWORDS) return 0; A = mem[i->k]; break;
+                    case FBPF_LEN: A = size; break;
+                    default: return 0;
+                }
+                break;
+            case FBPF_LDX:
+                switch (i->code & 0xe0) {
+                    case FBPF_IMM: X = i->k; break;
+                    case FBPF_MEM: if (i->k >= FOSSIL__FILTER_MEMWORDS) return 0; X = mem[i->k]; break;
+                    case FBPF_LEN: X = size; break;
+                    case FBPF_MSH: {
+                        uint32_t b;
+                        if (!fossil__fload(pkt, size, net_offset, (int32_t)i->k, 1, &b)) return 0;
+                        X = (b & 0x0f) << 2;
+                        break;
+                    }
+                    default: return 0;
+                }
+                break;
+            case FBPF_ST:
+            case FBPF_STX:
+                if (i->k >= FOSSIL__FILTER_MEMWORDS) return 0;
+                mem[i->k] = cls == FBPF_ST ? A : X;
+                break;
+            case FBPF_ALU:
+                switch (i->code & 0xf0) {
+                    case FBPF_ADD: A += src; break;
+                    case FBPF_SUB: A -= src; break;
+                    case FBPF_MUL: A *= src; break;
+                    case FBPF_DIV: if (!src) return 0; A /= src; break;
+                    case FBPF_MOD: if (!src) return 0; A %= src; break;
+                    case FBPF_OR:  A |= src; break;
+                    case FBPF_AND: A &= src; break;
+                    case FBPF_XOR: A ^= src; break;
+                    case FBPF_LSH: A = src < 32 ? A << src : 0; break;
+                    case FBPF_RSH: A = src < 32 ? A >> src : 0; break;
+                    case FBPF_NEG: A = (uint32_t)-(int64_t)A; break;
+                    default: return 0;
+                }
+                break;
+            case FBPF_JMP: {
+                bool taken;
+                switch (i->code & 0xf0) {
+                    case FBPF_JA:   pc += i->k; continue;
+                    case FBPF_JEQ:  taken = A == src; break;
+                    case FBPF_JGT:  taken = A > src; break;
+                    case FBPF_JGE:  taken = A >= src; break;
+                    case FBPF_JSET: taken = (A & src) != 0; break;
+                    default: return 0;
+                }
+                pc += taken ? i->jt : i->jf;
+                break;
+            }
+            case FBPF_RET: {
+                uint32_t keep = (i->code & 0x18) == FBPF_A ? A : i->k;
+                return keep < size ? keep : size;
+            }
+            case FBPF_MISC:
+                if ((i->code & 0xf8) == FBPF_TXA) A = X;
+                else X = A;
+                break;
+            default:
+                return 0;
+        }
+    }
+    return 0;
+}
+
+/*=============================================================================
+SOCKET ATTACHMENT
+=============================================================================*/
+
+int fossil_net_filter_attach(fossil_net_socket_t *sock, const fossil_net_filter_t *filter) {
+    if (!sock || sock->fd < 0 || !filter) return -1;
+#if defined(__linux__)
+    struct sock_fprog prog;
+    prog.len = (unsigned short)filter->count;
+    prog.filter = (struct sock_filter*)filter->insns;
+    return setsockopt(sock->fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) == 0 ? 0 : -1;
+#else
+    // Not supported on this platform
+    return -1;
+#endif
+}
+
+int fossil_net_filter_attach_reuseport(fossil_net_socket_t *sock, const fossil_net_filter_t *filter) {
+    if (!sock || sock->fd < 0 || !filter) return -1;
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    struct sock_fprog prog;
+    prog.len = (unsigned short)filter->count;
+    prog.filter = (struct sock_filter*)filter->insns;
+    return setsockopt(sock->fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0 ? 0 : -1;
+#else
+    // Not supported on this platform
+    return -1;
+#endif
+}
+
+int fossil_net_filter_detach(fossil_net_socket_t *sock) {
+    if (!sock || sock->fd < 0) return -1;
+#if defined(__linux__)
+    int dummy = 0;
+    return setsockopt(sock->fd, SOL_SOCKET, SO_DETACH_FILTER, &dummy, sizeof(dummy)) == 0 ? 0 : -1;
+#else
+    return -1;
+#endif
+}
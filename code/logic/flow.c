@@ -0,0 +1,408 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/flow.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*
+ * Each shard is a linear-probing array guarded by a spinlock that only
+ * writers (update, expire) take. Slots are published through a per-slot
+ * sequence counter (odd while being written) so snapshot readers can copy
+ * them without the lock and retry torn reads. Expiry uses backward-shift
+ * deletion instead of tombstones; because that moves slots, the shard
+ * generation is odd while it runs and snapshots retry the shard.
+ */
+
+#define FOSSIL__FLOW_KEY_WORDS (sizeof(fossil_net_flow_key_t) / sizeof(uint64_t))
+
+typedef struct fossil__flow_slot {
+    _Atomic uint32_t seq;        /* odd while being written */
+    _Atomic uint32_t tag;        /* 0 = empty, else high hash bits | 1 */
+    _Atomic uint32_t home;       /* low hash bits, locates the home slot */
+    _Atomic uint32_t tcp_flags;
+    _Atomic uint64_t key[FOSSIL__FLOW_KEY_WORDS];
+    _Atomic uint64_t packets;
+    _Atomic uint64_t bytes;
+    _Atomic uint64_t first_ns;
+    _Atomic uint64_t last_ns;
+} fossil__flow_slot_t;
+
+typedef struct fossil__flow_shard {
+    atomic_flag lock;
+    _Atomic uint32_t gen;        /* odd while expiry moves slots */
+    _Atomic uint32_t live;
+    _Atomic uint64_t inserts;
+    _Atomic uint64_t expired;
+    _Atomic uint64_t dropped;
+    fossil__flow_slot_t *slots;
+    char pad[16];                /* keep neighbouring locks off one line */
+} fossil__flow_shard_t;
+
+struct fossil_net_flow_table {
+    uint32_t shard_count;
+    uint32_t shard_shift;
+    uint32_t mask;               /* slots per shard - 1 */
+    uint32_t limit;              /* max live flows per shard */
+    uint64_t seed;
+    fossil__flow_shard_t *shards;
+};
+
+_Static_assert(sizeof(fossil_net_flow_key_t) == 40, "flow key must pack into 64-bit words");
+
+static uint32_t fossil__flow_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v && p < 0x80000000u) p <<= 1;
+    return p;
+}
+
+static void fossil__flow_words(const fossil_net_flow_key_t *key, uint64_t w[FOSSIL__FLOW_KEY_WORDS]) {
+    memcpy(w, key, sizeof(*key));
+}
+
+static uint64_t fossil__flow_hash(const fossil_net_flow_table_t *t, const uint64_t w[FOSSIL__FLOW_KEY_WORDS]) {
+    uint64_t h = t->seed;
+    for (size_t i = 0; i < FOSSIL__FLOW_KEY_WORDS; ++i) {
+        h = (h ^ w[i]) * 0x9e3779b97f4a7c15ull;
+        h ^= h >> 29;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+static void fossil__flow_lock(fossil__flow_shard_t *s) {
+    while (atomic_flag_test_and_set_explicit(&s->lock, memory_order_acquire)) { }
+}
+
+static void fossil__flow_unlock(fossil__flow_shard_t *s) {
+    atomic_flag_clear_explicit(&s->lock, memory_order_release);
+}
+
+/* Seqlock writer side; the caller holds the shard lock. */
+static void fossil__flow_write_begin(fossil__flow_slot_t *slot) {
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void fossil__flow_write_end(fossil__flow_slot_t *slot) {
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_release);
+}
+
+static int fossil__flow_key_equal(fossil__flow_slot_t *slot, const uint64_t w[FOSSIL__FLOW_KEY_WORDS]) {
+    for (size_t i = 0; i < FOSSIL__FLOW_KEY_WORDS; ++i)
+        if (atomic_load_explicit(&slot->key[i], memory_order_relaxed) != w[i]) return 0;
+    return 1;
+}
+
+/* Returns the slot holding the key, or the empty slot ending its probe run. */
+static fossil__flow_slot_t *fossil__flow_probe(const fossil_net_flow_table_t *t, fossil__flow_shard_t *s,
+                                               uint64_t h, const uint64_t w[FOSSIL__FLOW_KEY_WORDS]) {
+    uint32_t tag = (uint32_t)(h >> 32) | 1u;
+    uint32_t i = (uint32_t)h & t->mask;
+    for (;;) {
+        fossil__flow_slot_t *slot = &s->slots[i];
+        uint32_t st = atomic_load_explicit(&slot->tag, memory_order_relaxed);
+        if (st == 0 || (st == tag && fossil__flow_key_equal(slot, w))) return slot;
+        i = (i + 1) & t->mask;
+    }
+}
+
+/* Lock-free copy of one slot; returns 0 if it held a flow. */
+static int fossil__flow_read(fossil__flow_slot_t *slot, fossil_net_flow_record_t *rec) {
+    for (;;) {
+        uint32_t s1 = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (s1 & 1u) continue;
+        uint32_t tag = atomic_load_explicit(&slot->tag, memory_order_relaxed);
+        uint64_t w[FOSSIL__FLOW_KEY_WORDS];
+        for (size_t i = 0; i < FOSSIL__FLOW_KEY_WORDS; ++i)
+            w[i] = atomic_load_explicit(&slot->key[i], memory_order_relaxed);
+        rec->packets = atomic_load_explicit(&slot->packets, memory_order_relaxed);
+        rec->bytes = atomic_load_explicit(&slot->bytes, memory_order_relaxed);
+        rec->first_ns = atomic_load_explicit(&slot->first_ns, memory_order_relaxed);
+        rec->last_ns = atomic_load_explicit(&slot->last_ns, memory_order_relaxed);
+        rec->tcp_flags = (uint8_t)atomic_load_explicit(&slot->tcp_flags, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != s1) continue;
+        if (tag == 0) return -1;
+        memcpy(&rec->key, w, sizeof(rec->key));
+        return 0;
+    }
+}
+
+fossil_net_flow_table_t *fossil_net_flow_create(uint32_t capacity, uint32_t shards) {
+    if (capacity == 0) return NULL;
+    if (shards == 0) shards = 64;
+    shards = fossil__flow_pow2(shards);
+    if (shards > capacity) shards = fossil__flow_pow2(capacity);
+
+    // Keep each shard at most 7/8 full so probe runs stay short
+    uint32_t per_shard = (capacity + shards - 1) / shards;
+    uint64_t slots = fossil__flow_pow2(per_shard + per_shard / 7 + 1);
+    if (slots > 0x40000000u) return NULL;
+
+    fossil_net_flow_table_t *t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    t->shard_count = shards;
+    t->shard_shift = 0;
+    while ((1u << t->shard_shift) < shards) t->shard_shift++;
+    t->mask = (uint32_t)slots - 1;
+    t->limit = per_shard;
+    t->seed = fossil_net_socket_clock_ns() ^ (uint64_t)(uintptr_t)t ^ 0x243f6a8885a308d3ull;
+    t->shards = calloc(shards, sizeof(*t->shards));
+    if (!t->shards) {
+        free(t);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < shards; ++i) {
+        atomic_flag_clear(&t->shards[i].lock);
+        t->shards[i].slots = calloc((size_t)slots, sizeof(fossil__flow_slot_t));
+        if (!t->shards[i].slots) {
+            fossil_net_flow_destroy(t);
+            return NULL;
+        }
+    }
+    return t;
+}
+
+void fossil_net_flow_destroy(fossil_net_flow_table_t *table) {
+    if (!table) return;
+    if (table->shards) {
+        for (uint32_t i = 0; i < table->shard_count; ++i) free(table->shards[i].slots);
+        free(table->shards);
+    }
+    free(table);
+}
+
+static fossil__flow_shard_t *fossil__flow_shard(fossil_net_flow_table_t *t, uint64_t h) {
+    // Shard from the top bits, slot from the bottom bits
+    return &t->shards[t->shard_shift ? (uint32_t)(h >> (64 - t->shard_shift)) : 0];
+}
+
+int fossil_net_flow_update(fossil_net_flow_table_t *table, const fossil_net_flow_key_t *key,
+                           uint32_t bytes, uint8_t tcp_flags, uint64_t now_ns) {
+    if (!table || !key) return -1;
+    if (now_ns == 0) now_ns = fossil_net_socket_clock_ns();
+
+    uint64_t w[FOSSIL__FLOW_KEY_WORDS];
+    fossil__flow_words(key, w);
+    uint64_t h = fossil__flow_hash(table, w);
+    fossil__flow_shard_t *s = fossil__flow_shard(table, h);
+
+    fossil__flow_lock(s);
+    fossil__flow_slot_t *slot = fossil__flow_probe(table, s, h, w);
+    if (atomic_load_explicit(&slot->tag, memory_order_relaxed) == 0) {
+        if (atomic_load_explicit(&s->live, memory_order_relaxed) >= table->limit) {
+            atomic_fetch_add_explicit(&s->dropped, 1, memory_order_relaxed);
+            fossil__flow_unlock(s);
+            return -1;
+        }
+        fossil__flow_write_begin(slot);
+        for (size_t i = 0; i < FOSSIL__FLOW_KEY_WORDS; ++i)
+            atomic_store_explicit(&slot->key[i], w[i], memory_order_relaxed);
+        atomic_store_explicit(&slot->home, (uint32_t)h, memory_order_relaxed);
+        atomic_store_explicit(&slot->tag, (uint32_t)(h >> 32) | 1u, memory_order_relaxed);
+        atomic_store_explicit(&slot->packets, 1, memory_order_relaxed);
+        atomic_store_explicit(&slot->bytes, bytes, memory_order_relaxed);
+        atomic_store_explicit(&slot->first_ns, now_ns, memory_order_relaxed);
+        atomic_store_explicit(&slot->last_ns, now_ns, memory_order_relaxed);
+        atomic_store_explicit(&slot->tcp_flags, tcp_flags, memory_order_relaxed);
+        fossil__flow_write_end(slot);
+        atomic_fetch_add_explicit(&s->live, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&s->inserts, 1, memory_order_relaxed);
+    } else {
+        // Single writer under the lock: plain read-modify-write, no RMW atomics
+        fossil__flow_write_begin(slot);
+        atomic_store_explicit(&slot->packets, atomic_load_explicit(&slot->packets, memory_order_relaxed) + 1, memory_order_relaxed);
+        atomic_store_explicit(&slot->bytes, atomic_load_explicit(&slot->bytes, memory_order_relaxed) + bytes, memory_order_relaxed);
+        if (now_ns > atomic_load_explicit(&slot->last_ns, memory_order_relaxed))
+            atomic_store_explicit(&slot->last_ns, now_ns, memory_order_relaxed);
+        atomic_store_explicit(&slot->tcp_flags, atomic_load_explicit(&slot->tcp_flags, memory_order_relaxed) | tcp_flags, memory_order_relaxed);
+        fossil__flow_write_end(slot);
+    }
+    fossil__flow_unlock(s);
+    return 0;
+}
+
+int fossil_net_flow_key_from_packet(const fossil_net_packet_t *pkt, fossil_net_flow_key_t *key) {
+    if (!pkt || !key) return -1;
+    const uint8_t *ip = fossil_net_packet_l3(pkt);
+    if (!ip) return -1;
+    memset(key, 0, sizeof(*key));
+    if (pkt->layers & FOSSIL_NET_PACKET_HAS_IPV4) {
+        key->family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+        memcpy(key->src, ip + 12, 4);
+        memcpy(key->dst, ip + 16, 4);
+    } else if (pkt->layers & FOSSIL_NET_PACKET_HAS_IPV6) {
+        key->family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        memcpy(key->src, ip + 8, 16);
+        memcpy(key->dst, ip + 24, 16);
+    } else {
+        return -1;
+    }
+    key->proto = pkt->ip_proto;
+    if (pkt->layers & (FOSSIL_NET_PACKET_HAS_ICMP | FOSSIL_NET_PACKET_HAS_ICMPV6)) {
+        key->dst_port = (uint16_t)((pkt->icmp_type << 8) | pkt->icmp_code);
+    } else {
+        key->src_port = pkt->src_port;
+        key->dst_port = pkt->dst_port;
+    }
+    return 0;
+}
+
+int fossil_net_flow_account(fossil_net_flow_table_t *table, const fossil_net_packet_t *pkt, uint64_t now_ns) {
+    fossil_net_flow_key_t key;
+    if (fossil_net_flow_key_from_packet(pkt, &key) != 0) return -1;
+
+    // Bytes from the IP header, so snaplen-truncated captures still count in full
+    const uint8_t *ip = fossil_net_packet_l3(pkt);
+    uint32_t bytes = (key.family == FOSSIL_NET_SOCKET_FAMILY_IPV4)
+        ? (uint32_t)((ip[2] << 8) | ip[3])
+        : 40u + (uint32_t)((ip[4] << 8) | ip[5]);
+    return fossil_net_flow_update(table, &key, bytes, pkt->tcp_flags, now_ns);
+}
+
+int fossil_net_flow_lookup(fossil_net_flow_table_t *table, const fossil_net_flow_key_t *key, fossil_net_flow_record_t *record) {
+    if (!table || !key || !record) return -1;
+    uint64_t w[FOSSIL__FLOW_KEY_WORDS];
+    fossil__flow_words(key, w);
+    uint64_t h = fossil__flow_hash(table, w);
+    fossil__flow_shard_t *s = fossil__flow_shard(table, h);
+
+    fossil__flow_lock(s);
+    int rc = fossil__flow_read(fossil__flow_probe(table, s, h, w), record);
+    fossil__flow_unlock(s);
+    return rc;
+}
+
+uint32_t fossil_net_flow_snapshot(fossil_net_flow_table_t *table, fossil_net_flow_record_t *records, uint32_t max) {
+    if (!table || !records) return 0;
+    uint32_t n = 0;
+    for (uint32_t si = 0; si < table->shard_count && n < max; ++si) {
+        fossil__flow_shard_t *s = &table->shards[si];
+        uint32_t start = n;
+        for (;;) {
+            uint32_t g1 = atomic_load_explicit(&s->gen, memory_order_acquire);
+            if (g1 & 1u) continue;
+            n = start;
+            for (uint32_t i = 0; i <= table->mask && n < max; ++i)
+                if (fossil__flow_read(&s->slots[i], &records[n]) == 0) n++;
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&s->gen, memory_order_relaxed) == g1) break;
+        }
+    }
+    return n;
+}
+
+static void fossil__flow_move(fossil__flow_slot_t *dst, fossil__flow_slot_t *src) {
+    fossil__flow_write_begin(dst);
+    for (size_t i = 0; i < FOSSIL__FLOW_KEY_WORDS; ++i)
+        atomic_store_explicit(&dst->key[i], atomic_load_explicit(&src->key[i], memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->tag, atomic_load_explicit(&src->tag, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->home, atomic_load_explicit(&src->home, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->packets, atomic_load_explicit(&src->packets, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->bytes, atomic_load_explicit(&src->bytes, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->first_ns, atomic_load_explicit(&src->first_ns, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->last_ns, atomic_load_explicit(&src->last_ns, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&dst->tcp_flags, atomic_load_explicit(&src->tcp_flags, memory_order_relaxed), memory_order_relaxed);
+    fossil__flow_write_end(dst);
+}
+
+/* Backward-shift deletion: pull later members of the probe run into the hole. */
+static void fossil__flow_remove(const fossil_net_flow_table_t *t, fossil__flow_shard_t *s, uint32_t hole) {
+    uint32_t j = hole;
+    for (;;) {
+        j = (j + 1) & t->mask;
+        fossil__flow_slot_t *next = &s->slots[j];
+        if (atomic_load_explicit(&next->tag, memory_order_relaxed) == 0) break;
+        uint32_t home = atomic_load_explicit(&next->home, memory_order_relaxed) & t->mask;
+        // Leave entries whose home lies cyclically in (hole, j]
+        int stays = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (stays) continue;
+        fossil__flow_move(&s->slots[hole], next);
+        hole = j;
+    }
+    fossil__flow_slot_t *slot = &s->slots[hole];
+    fossil__flow_write_begin(slot);
+    atomic_store_explicit(&slot->tag, 0, memory_order_relaxed);
+    fossil__flow_write_end(slot);
+}
+
+uint32_t fossil_net_flow_expire(fossil_net_flow_table_t *table, uint64_t now_ns, uint64_t idle_ns,
+                                fossil_net_flow_record_t *records, uint32_t max) {
+    if (!table || (max && !records)) return 0;
+    if (now_ns == 0) now_ns = fossil_net_socket_clock_ns();
+
+    uint32_t removed = 0;
+    for (uint32_t si = 0; si < table->shard_count; ++si) {
+        fossil__flow_shard_t *s = &table->shards[si];
+        int moving = 0;
+        fossil__flow_lock(s);
+        for (uint32_t i = 0; i <= table->mask; ++i) {
+            if (max && removed == max) break;
+            fossil__flow_slot_t *slot = &s->slots[i];
+            if (atomic_load_explicit(&slot->tag, memory_order_relaxed) == 0) continue;
+            uint64_t last = atomic_load_explicit(&slot->last_ns, memory_order_relaxed);
+            if (last > now_ns || now_ns - last < idle_ns) continue;
+
+            if (max) fossil__flow_read(slot, &records[removed]);
+            if (!moving) {
+                uint32_t g = atomic_load_explicit(&s->gen, memory_order_relaxed);
+                atomic_store_explicit(&s->gen, g + 1, memory_order_relaxed);
+                atomic_thread_fence(memory_order_release);
+                moving = 1;
+            }
+            fossil__flow_remove(table, s, i);
+            removed++;
+            atomic_fetch_sub_explicit(&s->live, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&s->expired, 1, memory_order_relaxed);
+            --i; // a later entry may have shifted into this slot
+        }
+        if (moving) {
+            uint32_t g = atomic_load_explicit(&s->gen, memory_order_relaxed);
+            atomic_store_explicit(&s->gen, g + 1, memory_order_release);
+        }
+        fossil__flow_unlock(s);
+        if (max && removed == max) break;
+    }
+    return removed;
+}
+
+int fossil_net_flow_get_stats(fossil_net_flow_table_t *table, fossil_net_flow_stats_t *stats) {
+    if (!table || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < table->shard_count; ++i) {
+        fossil__flow_shard_t *s = &table->shards[i];
+        stats->flows += atomic_load_explicit(&s->live, memory_order_relaxed);
+        stats->inserts += atomic_load_explicit(&s->inserts, memory_order_relaxed);
+        stats->expired += atomic_load_explicit(&s->expired, memory_order_relaxed);
+        stats->dropped += atomic_load_explicit(&s->dropped, memory_order_relaxed);
+    }
+    return 0;
+}
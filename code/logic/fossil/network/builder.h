@@ -0,0 +1,320 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_BUILDER_H
+#define FOSSIL_NETWORK_BUILDER_H
+
+#include "socket.h"
+#include "checksum.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Packet builder writing headers into a caller-provided buffer.
+ *
+ * Layers are pushed outermost first (Ethernet, IP, transport, payload);
+ * fossil_net_builder_finish() then fills in length fields and checksums.
+ * The builder never allocates, so one buffer can be reused as a template and
+ * mutated per packet with fossil_net_builder_patch16().
+ */
+typedef struct fossil_net_builder
+{
+    uint8_t *buffer;      /* caller storage */
+    uint32_t capacity;    /* size of buffer */
+    uint32_t length;      /* bytes written so far */
+    uint16_t l3_offset;   /* IP header, 0xffff if none */
+    uint16_t l4_offset;   /* transport header, 0xffff if none */
+    uint8_t ip_version;   /* 4, 6 or 0 */
+    uint8_t ip_proto;     /* protocol of the transport header */
+    uint8_t has_eth;      /* an Ethernet header starts the frame */
+    uint8_t finished;     /* lengths and checksums are valid */
+} fossil_net_builder_t;
+
+/* TCP flag bits for fossil_net_builder_tcp() */
+#define FOSSIL_NET_BUILDER_TCP_FIN 0x01u
+#define FOSSIL_NET_BUILDER_TCP_SYN 0x02u
+#define FOSSIL_NET_BUILDER_TCP_RST 0x04u
+#define FOSSIL_NET_BUILDER_TCP_PSH 0x08u
+#define FOSSIL_NET_BUILDER_TCP_ACK 0x10u
+
+/*=============================================================================
+LAYERS
+=============================================================================*/
+
+/**
+ * @brief Start building into a buffer.
+ *
+ * @param builder  Builder to initialize.
+ * @param buffer   Destination storage.
+ * @param capacity Size of buffer in bytes.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_net_builder_init(
+    fossil_net_builder_t *builder,
+    void *buffer,
+    uint32_t capacity);
+
+/**
+ * @brief Append an Ethernet II header.
+ *
+ * @param builder   Builder.
+ * @param src       Source MAC.
+ * @param dst       Destination MAC.
+ * @param ethertype EtherType, or 0 to take it from the following IP layer.
+ * @return 0 on success, -1 if out of space or out of order.
+ */
+int fossil_net_builder_ethernet(
+    fossil_net_builder_t *builder,
+    const fossil_net_mac_t *src,
+    const fossil_net_mac_t *dst,
+    uint16_t ethertype);
+
+/**
+ * @brief Append an IPv4 or IPv6 header; the family comes from the endpoints.
+ *
+ * Ports in the endpoints are ignored. IPv4 headers get the DF bit and no
+ * options; the total length and header checksum are filled in by finish.
+ *
+ * @param builder Builder.
+ * @param src     Source address.
+ * @param dst     Destination address (same family as src).
+ * @param proto   Transport protocol number (e.g. 6, 17, 1, 58).
+ * @param ttl     TTL or hop limit.
+ * @return 0 on success, -1 on mismatch, out of space or out of order.
+ */
+int fossil_net_builder_ip(
+    fossil_net_builder_t *builder,
+    const fossil_net_endpoint_t *src,
+    const fossil_net_endpoint_t *dst,
+    uint8_t proto,
+    uint8_t ttl);
+
+/**
+ * @brief Append a UDP header.
+ *
+ * @param builder  Builder.
+ * @param src_port Source port.
+ * @param dst_port Destination port.
+ * @return 0 on success, -1 if out of space or out of order.
+ */
+int fossil_net_builder_udp(
+    fossil_net_builder_t *builder,
+    uint16_t src_port,
+    uint16_t dst_port);
+
+/**
+ * @brief Append a TCP header without options.
+ *
+ * @param builder  Builder.
+ * @param src_port Source port.
+ * @param dst_port Destination port.
+ * @param seq      Sequence number.
+ * @param ack      Acknowledgement number.
+ * @param flags    FOSSIL_NET_BUILDER_TCP_* bits.
+ * @param window   Receive window.
+ * @return 0 on success, -1 if out of space or out of order.
+ */
+int fossil_net_builder_tcp(
+    fossil_net_builder_t *builder,
+    uint16_t src_port,
+    uint16_t dst_port,
+    uint32_t seq,
+    uint32_t ack,
+    uint8_t flags,
+    uint16_t window);
+
+/**
+ * @brief Append an ICMP (over IPv4) or ICMPv6 (over IPv6) echo-style header.
+ *
+ * @param builder    Builder.
+ * @param type       ICMP type.
+ * @param code       ICMP code.
+ * @param identifier Identifier field.
+ * @param sequence   Sequence field.
+ * @return 0 on success, -1 if out of space or out of order.
+ */
+int fossil_net_builder_icmp(
+    fossil_net_builder_t *builder,
+    uint8_t type,
+    uint8_t code,
+    uint16_t identifier,
+    uint16_t sequence);
+
+/**
+ * @brief Append payload bytes.
+ *
+ * @param builder Builder.
+ * @param data    Bytes to copy, or NULL to reserve zeroed space.
+ * @param length  Number of bytes.
+ * @return Pointer to the payload in the buffer, NULL if out of space.
+ */
+uint8_t *fossil_net_builder_payload(
+    fossil_net_builder_t *builder,
+    const void *data,
+    uint32_t length);
+
+/**
+ * @brief Fill in length fields and checksums.
+ *
+ * IPv4 header, TCP, UDP, ICMP and ICMPv6 checksums are computed in full with
+ * the accelerated checksum. Calling it again after changing the payload
+ * recomputes everything.
+ *
+ * @param builder Builder.
+ * @param length  Optional total frame length out.
+ * @return 0 on success, -1 on error.
+ */
+int fossil_net_builder_finish(
+    fossil_net_builder_t *builder,
+    uint32_t *length);
+
+/*=============================================================================
+INCREMENTAL REWRITE
+=============================================================================*/
+
+/**
+ * @brief Overwrite a 16-bit big-endian field in a finished packet.
+ *
+ * Affected checksums (the IPv4 header checksum, and the transport checksum
+ * for transport fields, payload bytes and pseudo-header addresses) are
+ * adjusted per RFC 1624 instead of being recomputed. The offset must be even
+ * relative to the start of its header, as all standard fields are.
+ *
+ * @param builder Finished builder.
+ * @param offset  Byte offset of the field within the frame.
+ * @param value   New value in host order.
+ * @return 0 on success, -1 if not finished or out of range.
+ */
+int fossil_net_builder_patch16(
+    fossil_net_builder_t *builder,
+    uint32_t offset,
+    uint16_t value);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Builder
+    {
+    private:
+        fossil_net_builder_t builder_;
+
+    public:
+        /**
+         * @brief Build into caller storage. Wraps fossil_net_builder_init.
+         */
+        Builder(void *buffer, uint32_t capacity)
+        {
+            if (fossil_net_builder_init(&builder_, buffer, capacity) != 0)
+                builder_ = fossil_net_builder_t{};
+        }
+
+        /**
+         * @brief Append Ethernet. Wraps fossil_net_builder_ethernet.
+         */
+        bool ethernet(const fossil_net_mac_t &src, const fossil_net_mac_t &dst, uint16_t ethertype = 0)
+        {
+            return fossil_net_builder_ethernet(&builder_, &src, &dst, ethertype) == 0;
+        }
+
+        /**
+         * @brief Append IPv4/IPv6. Wraps fossil_net_builder_ip.
+         */
+        bool ip(const fossil_net_endpoint_t &src, const fossil_net_endpoint_t &dst, uint8_t proto, uint8_t ttl = 64)
+        {
+            return fossil_net_builder_ip(&builder_, &src, &dst, proto, ttl) == 0;
+        }
+
+        /**
+         * @brief Append UDP. Wraps fossil_net_builder_udp.
+         */
+        bool udp(uint16_t src_port, uint16_t dst_port)
+        {
+            return fossil_net_builder_udp(&builder_, src_port, dst_port) == 0;
+        }
+
+        /**
+         * @brief Append TCP. Wraps fossil_net_builder_tcp.
+         */
+        bool tcp(uint16_t src_port, uint16_t dst_port, uint32_t seq, uint32_t ack, uint8_t flags, uint16_t window = 65535)
+        {
+            return fossil_net_builder_tcp(&builder_, src_port, dst_port, seq, ack, flags, window) == 0;
+        }
+
+        /**
+         * @brief Append ICMP/ICMPv6. Wraps fossil_net_builder_icmp.
+         */
+        bool icmp(uint8_t type, uint8_t code, uint16_t identifier, uint16_t sequence)
+        {
+            return fossil_net_builder_icmp(&builder_, type, code, identifier, sequence) == 0;
+        }
+
+        /**
+         * @brief Append payload. Wraps fossil_net_builder_payload.
+         */
+        uint8_t *payload(const void *data, uint32_t length)
+        {
+            return fossil_net_builder_payload(&builder_, data, length);
+        }
+
+        /**
+         * @brief Fill lengths and checksums; returns the frame length or 0.
+         */
+        uint32_t finish()
+        {
+            uint32_t length = 0;
+            return fossil_net_builder_finish(&builder_, &length) == 0 ? length : 0;
+        }
+
+        /**
+         * @brief Rewrite a field with incremental checksums. Wraps fossil_net_builder_patch16.
+         */
+        bool patch16(uint32_t offset, uint16_t value)
+        {
+            return fossil_net_builder_patch16(&builder_, offset, value) == 0;
+        }
+
+        /**
+         * @brief Access the underlying builder.
+         */
+        fossil_net_builder_t *get()
+        {
+            return &builder_;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_BUILDER_H */
@@ -0,0 +1,291 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_CACHE_H
+#define FOSSIL_NETWORK_CACHE_H
+
+#include "fossil/network/parser.h"
+#include "fossil/network/writeq.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Size-bounded cache of serialized HTTP responses.
+ *
+ * Entries are keyed by method (HEAD shares GET's entries), Host, request
+ * target and the values of the request headers named in the vary
+ * setting. Each entry holds the response preformatted: a hit costs one
+ * lookup and a header copy, with larger bodies sent by reference. A
+ * conditional GET whose If-None-Match (or, without it, an exact
+ * If-Modified-Since) matches is answered with 304 from the entry.
+ *
+ * Only 200 responses to GET are stored, and only when they allow it:
+ * Cache-Control no-store, private or no-cache, Set-Cookie, or a Vary on
+ * a header outside the vary setting keep a response out. Lifetime comes
+ * from s-maxage or max-age, else default_ttl_ns. Responses without an
+ * ETag get one derived from the body.
+ *
+ * The cache is split into shards, each with its own lock, LRU list and
+ * byte budget. Admission follows TinyLFU: a count-min sketch of recent
+ * lookups, halved periodically, estimates how often each key is asked
+ * for, and a new entry only displaces LRU victims that are asked for
+ * less often. A burst of one-off URLs therefore cannot flush the hot set.
+ *
+ * Thread-safe.
+ */
+typedef struct fossil_net_cache fossil_net_cache_t;
+
+/**
+ * @brief Cache configuration; zero fields take the defaults.
+ */
+typedef struct fossil_net_cache_config
+{
+    uint64_t max_bytes;       /* total budget, default 64 MiB */
+    uint64_t default_ttl_ns;  /* lifetime without max-age; 0 stores only those with one */
+    uint32_t shards;          /* rounded up to a power of two, default 16 */
+    uint32_t max_entry;       /* largest response stored, default 1 MiB */
+    const char *vary;         /* comma-separated request headers in the key, e.g. "Accept-Encoding" */
+} fossil_net_cache_config_t;
+
+/**
+ * @brief Cache counters.
+ */
+typedef struct fossil_net_cache_stats
+{
+    uint64_t hits;          /* served from the cache, 304s included */
+    uint64_t misses;
+    uint64_t not_modified;  /* hits answered with 304 */
+    uint64_t stores;
+    uint64_t uncacheable;   /* responses the headers kept out */
+    uint64_t rejected;      /* refused by admission */
+    uint64_t evictions;
+    uint64_t expired;
+    uint64_t entries;       /* current */
+    uint64_t bytes;         /* current, entry overhead included */
+} fossil_net_cache_stats_t;
+
+/**
+ * @brief A response found by fossil_net_cache_lookup.
+ */
+typedef struct fossil_net_cache_hit
+{
+    fossil_net_buf_t *buf;  /* holds the response until released */
+    uint32_t head_off;      /* status line and headers, without the blank line */
+    uint32_t head_len;
+    uint32_t body_off;
+    uint32_t body_len;      /* 0 for a 304 */
+    uint32_t age;           /* seconds since the response was stored */
+    bool not_modified;
+} fossil_net_cache_hit_t;
+
+/*=============================================================================
+CACHE
+=============================================================================*/
+
+/**
+ * @brief Create a cache.
+ *
+ * @param config Configuration, or NULL for the defaults.
+ * @return Cache, or NULL on failure.
+ */
+fossil_net_cache_t *fossil_net_cache_create(const fossil_net_cache_config_t *config);
+
+/**
+ * @brief Destroy a cache. Hits not yet released stay valid.
+ *
+ * @param cache Cache.
+ */
+void fossil_net_cache_destroy(fossil_net_cache_t *cache);
+
+/**
+ * @brief Build the cache key of a request.
+ *
+ * @param cache Cache.
+ * @param req   Parsed request.
+ * @param key   Receives the key.
+ * @param size  Size of key.
+ * @return Key length, 0 if the request is not cacheable (not GET or
+ *         HEAD, Authorization, Cache-Control: no-store) or the key does
+ *         not fit.
+ */
+uint32_t fossil_net_cache_key(
+    const fossil_net_cache_t *cache,
+    const fossil_net_http_request_t *req,
+    char *key,
+    uint32_t size);
+
+/**
+ * @brief Look up a response, evaluating the request's conditionals.
+ *
+ * Requests with Cache-Control no-cache or max-age=0, or Pragma: no-cache,
+ * always miss so the handler refreshes the entry.
+ *
+ * @param cache Cache.
+ * @param key   Key from fossil_net_cache_key.
+ * @param len   Key length.
+ * @param req   Request.
+ * @param hit   Receives the response on a hit.
+ * @return true on a hit; release it with fossil_net_cache_release.
+ */
+bool fossil_net_cache_lookup(
+    fossil_net_cache_t *cache,
+    const char *key,
+    uint32_t len,
+    const fossil_net_http_request_t *req,
+    fossil_net_cache_hit_t *hit);
+
+/**
+ * @brief Release a hit.
+ *
+ * @param hit Hit from fossil_net_cache_lookup.
+ */
+void fossil_net_cache_release(fossil_net_cache_hit_t *hit);
+
+/**
+ * @brief Offer a response for storage.
+ *
+ * @param cache        Cache.
+ * @param key          Key from fossil_net_cache_key.
+ * @param len          Key length.
+ * @param status       Status code; only 200 is stored.
+ * @param content_type Content-Type, or NULL.
+ * @param headers      Other header lines, each ending in CRLF.
+ * @param headers_len  Length of headers.
+ * @param body         Body bytes.
+ * @param body_len     Body length.
+ * @return 0 if stored, 1 if not cacheable or not admitted, -1 on failure.
+ */
+int fossil_net_cache_store(
+    fossil_net_cache_t *cache,
+    const char *key,
+    uint32_t len,
+    int status,
+    const char *content_type,
+    const char *headers,
+    uint32_t headers_len,
+    const void *body,
+    uint32_t body_len);
+
+/**
+ * @brief Drop every entry.
+ *
+ * @param cache Cache.
+ */
+void fossil_net_cache_clear(fossil_net_cache_t *cache);
+
+/**
+ * @brief Read counters.
+ *
+ * @param cache Cache.
+ * @param stats Receives the counters.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_net_cache_get_stats(fossil_net_cache_t *cache, fossil_net_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Cache
+    {
+    private:
+        fossil_net_cache_t *handle_;
+
+    public:
+        /**
+         * @brief Create a cache. Wraps fossil_net_cache_create.
+         */
+        explicit Cache(const fossil_net_cache_config_t *config = nullptr)
+            : handle_(fossil_net_cache_create(config))
+        {
+        }
+
+        ~Cache()
+        {
+            if (handle_)
+                fossil_net_cache_destroy(handle_);
+        }
+
+        /**
+         * @brief Drop every entry. Wraps fossil_net_cache_clear.
+         */
+        void clear()
+        {
+            fossil_net_cache_clear(handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_cache_get_stats.
+         */
+        fossil_net_cache_stats_t stats() const
+        {
+            fossil_net_cache_stats_t s{};
+            fossil_net_cache_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying cache.
+         */
+        fossil_net_cache_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Cache(const Cache &) = delete;
+        Cache &operator=(const Cache &) = delete;
+
+        // Allow move
+        Cache(Cache &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Cache &operator=(Cache &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_cache_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_CACHE_H */
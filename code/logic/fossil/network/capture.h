@@ -0,0 +1,333 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_CAPTURE_H
+#define FOSSIL_NETWORK_CAPTURE_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Opaque memory-mapped packet ring (Linux TPACKET_V3).
+ *
+ * The kernel fills fixed-size blocks of frames in a ring shared with user
+ * space and hands a block over when it is full or its retire timeout
+ * expires, so one wakeup delivers many packets without a copy. An optional
+ * TX ring queues frames that are sent with a single system call on flush.
+ */
+typedef struct fossil_net_capture fossil_net_capture_t;
+
+typedef enum fossil_net_capture_fanout
+{
+    FOSSIL_NET_CAPTURE_FANOUT_HASH = 0, /* by flow hash, keeps flows on one member */
+    FOSSIL_NET_CAPTURE_FANOUT_LB,       /* round robin */
+    FOSSIL_NET_CAPTURE_FANOUT_CPU,      /* by receiving CPU */
+    FOSSIL_NET_CAPTURE_FANOUT_ROLLOVER, /* fill one member, spill to the next */
+    FOSSIL_NET_CAPTURE_FANOUT_RANDOM,
+    FOSSIL_NET_CAPTURE_FANOUT_QUEUE     /* by NIC receive queue */
+} fossil_net_capture_fanout_t;
+
+typedef struct fossil_net_capture_config
+{
+    const char *iface;     /* interface to bind, NULL for all (RX only) */
+    uint32_t block_size;   /* RX block size, a power-of-two multiple of the page size; 0 = 1 MiB */
+    uint32_t block_count;  /* RX blocks; 0 = 64 */
+    uint32_t retire_ms;    /* hand over a partly filled block after this long; 0 = 60 */
+    uint32_t tx_frame_size; /* TX frame size; 0 = 2048 */
+    uint32_t tx_frame_count; /* TX frames; 0 disables the TX ring */
+} fossil_net_capture_config_t;
+
+/**
+ * @brief One block handed over by the kernel, and an iterator over its frames.
+ */
+typedef struct fossil_net_capture_block
+{
+    void *desc;            /* kernel block descriptor */
+    uint64_t seq;          /* kernel block sequence number */
+    uint32_t frame_count;  /* frames in the block */
+    uint32_t frame_index;  /* iterator position */
+    const uint8_t *cursor; /* next frame header */
+} fossil_net_capture_block_t;
+
+/**
+ * @brief One captured frame. Points into the ring; valid until the block is released.
+ */
+typedef struct fossil_net_capture_frame
+{
+    const uint8_t *data;   /* link-layer frame */
+    uint32_t caplen;       /* bytes captured */
+    uint32_t len;          /* bytes on the wire */
+    uint64_t timestamp_ns; /* kernel receive time, CLOCK_REALTIME */
+    uint32_t ifindex;      /* receiving interface */
+    uint32_t rxhash;       /* flow hash computed by the kernel/NIC, 0 if none */
+    uint16_t protocol;     /* EtherType, host order */
+    uint16_t vlan_tci;     /* VLAN tag, valid when has_vlan is set */
+    uint8_t pkttype;       /* PACKET_HOST, PACKET_OUTGOING, ... */
+    bool has_vlan;
+} fossil_net_capture_frame_t;
+
+typedef struct fossil_net_capture_stats
+{
+    uint64_t packets;     /* frames received by the socket */
+    uint64_t drops;       /* frames dropped because the ring was full */
+    uint64_t freeze_count; /* times the ring stalled waiting for user space */
+} fossil_net_capture_stats_t;
+
+/*=============================================================================
+RING SETUP
+=============================================================================*/
+
+/**
+ * @brief Set up RX (and optionally TX) rings on a "packet" socket.
+ *
+ * The socket must come from fossil_net_socket_create(&sock, "raw", "packet")
+ * and outlive the ring. For a multi-threaded capture give each thread its
+ * own socket and ring and join them to one fanout group.
+ *
+ * @param sock   Pointer to a packet socket.
+ * @param config Ring configuration, or NULL for defaults.
+ * @return Pointer to capture ring, or NULL on failure or on non-Linux systems.
+ */
+fossil_net_capture_t *fossil_net_capture_create(
+    fossil_net_socket_t *sock,
+    const fossil_net_capture_config_t *config);
+
+/**
+ * @brief Unmap the rings. The socket is not closed.
+ *
+ * @param cap Pointer to capture ring.
+ */
+void fossil_net_capture_destroy(fossil_net_capture_t *cap);
+
+/**
+ * @brief Join a PACKET_FANOUT group so the kernel spreads packets over its members.
+ *
+ * @param cap   Pointer to capture ring.
+ * @param group Group ID shared by all members (per network namespace).
+ * @param mode  Distribution policy.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_capture_set_fanout(
+    fossil_net_capture_t *cap,
+    uint16_t group,
+    fossil_net_capture_fanout_t mode);
+
+/*=============================================================================
+RECEIVE
+=============================================================================*/
+
+/**
+ * @brief Wait for the next retired block.
+ *
+ * @param cap        Pointer to capture ring.
+ * @param block      Pointer to block to fill.
+ * @param timeout_ms Maximum wait; 0 polls without blocking.
+ * @return 1 if a block is ready, 0 on timeout, -1 on error.
+ */
+int fossil_net_capture_next_block(
+    fossil_net_capture_t *cap,
+    fossil_net_capture_block_t *block,
+    uint32_t timeout_ms);
+
+/**
+ * @brief Advance the frame iterator of a block.
+ *
+ * @param block Pointer to block from fossil_net_capture_next_block.
+ * @param frame Pointer to frame to fill.
+ * @return True if a frame was returned, false when the block is exhausted.
+ */
+bool fossil_net_capture_next_frame(
+    fossil_net_capture_block_t *block,
+    fossil_net_capture_frame_t *frame);
+
+/**
+ * @brief Give a block back to the kernel. Its frames must no longer be used.
+ *
+ * Blocks must be released in the order they were obtained.
+ *
+ * @param cap   Pointer to capture ring.
+ * @param block Pointer to block.
+ */
+void fossil_net_capture_release_block(
+    fossil_net_capture_t *cap,
+    fossil_net_capture_block_t *block);
+
+/**
+ * @brief Read the kernel packet and drop counters (reset on every read).
+ *
+ * @param cap   Pointer to capture ring.
+ * @param stats Pointer to stats structure to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_capture_get_stats(
+    fossil_net_capture_t *cap,
+    fossil_net_capture_stats_t *stats);
+
+/*=============================================================================
+TRANSMIT
+=============================================================================*/
+
+/**
+ * @brief Queue a link-layer frame in the TX ring.
+ *
+ * Requires a TX ring and a bound interface. Queued frames are sent by
+ * fossil_net_capture_flush, or implicitly when the ring is full.
+ *
+ * @param cap  Pointer to capture ring.
+ * @param data Complete frame including the link-layer header.
+ * @param size Frame length in bytes.
+ * @return 0 on success, non-zero on failure (EAGAIN if the ring stays full).
+ */
+int fossil_net_capture_send(
+    fossil_net_capture_t *cap,
+    const void *data,
+    uint32_t size);
+
+/**
+ * @brief Hand all queued TX frames to the kernel.
+ *
+ * @param cap Pointer to capture ring.
+ * @return Number of frames handed over, or -1 on failure.
+ */
+int fossil_net_capture_flush(fossil_net_capture_t *cap);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Capture
+    {
+    private:
+        fossil_net_capture_t *handle_;
+
+    public:
+        /**
+         * @brief Set up the rings. Wraps fossil_net_capture_create.
+         */
+        explicit Capture(fossil_net_socket_t *sock, const fossil_net_capture_config_t *config = nullptr)
+            : handle_(fossil_net_capture_create(sock, config))
+        {}
+
+        /**
+         * @brief Unmap the rings. Wraps fossil_net_capture_destroy.
+         */
+        ~Capture()
+        {
+            if (handle_)
+                fossil_net_capture_destroy(handle_);
+        }
+
+        /**
+         * @brief Join a fanout group. Wraps fossil_net_capture_set_fanout.
+         */
+        int set_fanout(uint16_t group, fossil_net_capture_fanout_t mode)
+        {
+            return fossil_net_capture_set_fanout(handle_, group, mode);
+        }
+
+        /**
+         * @brief Wait for a block. Wraps fossil_net_capture_next_block.
+         */
+        int next_block(fossil_net_capture_block_t *block, uint32_t timeout_ms)
+        {
+            return fossil_net_capture_next_block(handle_, block, timeout_ms);
+        }
+
+        /**
+         * @brief Iterate frames of a block. Wraps fossil_net_capture_next_frame.
+         */
+        static bool next_frame(fossil_net_capture_block_t *block, fossil_net_capture_frame_t *frame)
+        {
+            return fossil_net_capture_next_frame(block, frame);
+        }
+
+        /**
+         * @brief Return a block to the kernel. Wraps fossil_net_capture_release_block.
+         */
+        void release_block(fossil_net_capture_block_t *block)
+        {
+            fossil_net_capture_release_block(handle_, block);
+        }
+
+        /**
+         * @brief Queue a frame for transmit. Wraps fossil_net_capture_send.
+         */
+        int send(const void *data, uint32_t size)
+        {
+            return fossil_net_capture_send(handle_, data, size);
+        }
+
+        /**
+         * @brief Transmit queued frames. Wraps fossil_net_capture_flush.
+         */
+        int flush()
+        {
+            return fossil_net_capture_flush(handle_);
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_capture_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Capture(const Capture &) = delete;
+        Capture &operator=(const Capture &) = delete;
+
+        // Allow move
+        Capture(Capture &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Capture &operator=(Capture &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_capture_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_CAPTURE_H */
@@ -0,0 +1,182 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_CHECKSUM_H
+#define FOSSIL_NETWORK_CHECKSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+INTERNET CHECKSUM (RFC 1071)
+=============================================================================*/
+
+/*
+ * Checksums are returned as host-order integers; write them into a header
+ * big-endian like any other 16-bit field. Partial sums are opaque values
+ * that can be chained across buffers; every buffer but the last must have
+ * an even length.
+ */
+
+/**
+ * @brief Add a buffer to a partial one's-complement sum.
+ *
+ * Large buffers are summed 16 or 32 bytes at a time with SSE2/AVX2 on x86
+ * and NEON on ARM; other targets use a 64-bit scalar loop.
+ *
+ * @param data    Buffer to add.
+ * @param length  Length in bytes.
+ * @param partial Previous partial sum, 0 to start.
+ * @return New partial sum.
+ */
+uint32_t fossil_net_checksum_partial(
+    const void *data,
+    size_t length,
+    uint32_t partial);
+
+/**
+ * @brief Fold and complement a partial sum into the final checksum.
+ *
+ * @param partial Partial sum.
+ * @return Checksum in host order.
+ */
+uint16_t fossil_net_checksum_finish(uint32_t partial);
+
+/**
+ * @brief Checksum a buffer in one call.
+ *
+ * @param data   Buffer.
+ * @param length Length in bytes.
+ * @return Checksum in host order.
+ */
+uint16_t fossil_net_checksum(
+    const void *data,
+    size_t length);
+
+/**
+ * @brief Partial sum of the IPv4 pseudo-header used by TCP and UDP.
+ *
+ * @param src    Source address.
+ * @param dst    Destination address.
+ * @param proto  Transport protocol number.
+ * @param length Transport header plus payload length.
+ * @return Partial sum to continue with the transport segment.
+ */
+uint32_t fossil_net_checksum_pseudo_ipv4(
+    const uint8_t src[4],
+    const uint8_t dst[4],
+    uint8_t proto,
+    uint16_t length);
+
+/**
+ * @brief Partial sum of the IPv6 pseudo-header used by TCP, UDP and ICMPv6.
+ *
+ * @param src    Source address.
+ * @param dst    Destination address.
+ * @param proto  Upper-layer protocol number.
+ * @param length Upper-layer packet length.
+ * @return Partial sum to continue with the upper-layer packet.
+ */
+uint32_t fossil_net_checksum_pseudo_ipv6(
+    const uint8_t src[16],
+    const uint8_t dst[16],
+    uint8_t proto,
+    uint32_t length);
+
+/*=============================================================================
+INCREMENTAL UPDATE (RFC 1624)
+=============================================================================*/
+
+/**
+ * @brief Update a checksum after one 16-bit field changed.
+ *
+ * Computes HC' = ~(~HC + ~m + m') without touching the rest of the data.
+ *
+ * @param check     Current checksum (host order).
+ * @param old_value Previous field value (host order).
+ * @param new_value New field value (host order).
+ * @return Updated checksum.
+ */
+uint16_t fossil_net_checksum_update16(
+    uint16_t check,
+    uint16_t old_value,
+    uint16_t new_value);
+
+/**
+ * @brief Update a checksum after one 32-bit field (e.g. an IPv4 address) changed.
+ *
+ * @param check     Current checksum (host order).
+ * @param old_value Previous field value (host order).
+ * @param new_value New field value (host order).
+ * @return Updated checksum.
+ */
+uint16_t fossil_net_checksum_update32(
+    uint16_t check,
+    uint32_t old_value,
+    uint32_t new_value);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Checksum
+    {
+    public:
+        /**
+         * @brief Checksum a buffer. Wraps fossil_net_checksum.
+         */
+        static uint16_t compute(const void *data, size_t length)
+        {
+            return fossil_net_checksum(data, length);
+        }
+
+        /**
+         * @brief Incremental 16-bit update. Wraps fossil_net_checksum_update16.
+         */
+        static uint16_t update16(uint16_t check, uint16_t old_value, uint16_t new_value)
+        {
+            return fossil_net_checksum_update16(check, old_value, new_value);
+        }
+
+        /**
+         * @brief Incremental 32-bit update. Wraps fossil_net_checksum_update32.
+         */
+        static uint16_t update32(uint16_t check, uint32_t old_value, uint32_t new_value)
+        {
+            return fossil_net_checksum_update32(check, old_value, new_value);
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_CHECKSUM_H */
@@ -125,6 +125,17 @@ int fossil_net_client_get_remote_address(fossil_net_client_t *client, fossil_net
  */
 int fossil_net_client_set_blocking(fossil_net_client_t *client, bool blocking);
 
+/**
+ * @brief Get the client's socket.
+ *
+ * The socket stays owned by the client; it is exposed so a write queue
+ * (fossil_net_writeq_create) or an event loop can drive it directly.
+ *
+ * @param client Pointer to client handle.
+ * @return Pointer to the socket, or NULL if client is NULL.
+ */
+fossil_net_socket_t *fossil_net_client_socket(fossil_net_client_t *client);
+
 /**
  * @brief Get the last error code for the client.
  *
@@ -234,6 +245,16 @@ namespace fossil::net
             return fossil_net_client_set_blocking(handle_, blocking);
         }
 
+        /**
+         * @brief Get the client's socket.
+         *
+         * Wraps fossil_net_client_socket.
+         */
+        fossil_net_socket_t *socket()
+        {
+            return fossil_net_client_socket(handle_);
+        }
+
         /**
          * @brief Get the last error code for the client.
          */
@@ -0,0 +1,291 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_CONNTABLE_H
+#define FOSSIL_NETWORK_CONNTABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/*
+ * 64-bit object handle: slot index in the low 32 bits, slot generation in
+ * the high 32. Generations are odd while a slot is live and bump on every
+ * release, so a handle to a released (or reused) slot never resolves.
+ */
+typedef uint64_t fossil_net_handle_t;
+
+#define FOSSIL_NET_HANDLE_NONE ((fossil_net_handle_t)0)
+#define FOSSIL_NET_HANDLE_INDEX(h) ((uint32_t)((h) & 0xffffffffu))
+
+#define FOSSIL_NET_CONNTABLE_CHUNK 1024u /* slots per slab chunk */
+
+/**
+ * @brief Slab-allocated object table with generation-checked handles.
+ *
+ * Objects live in fixed-size slots carved from chunks of
+ * FOSSIL_NET_CONNTABLE_CHUNK slots; chunks are never moved or freed before
+ * the table, so object pointers stay valid for as long as the object is
+ * live. Allocation and release are O(1) through a free list, and live
+ * objects are also kept in a dense array for O(live) iteration.
+ *
+ * Not thread-safe: the reactor keeps one table per event loop.
+ */
+typedef struct fossil_net_conntable fossil_net_conntable_t;
+
+/**
+ * @brief Table counters.
+ */
+typedef struct fossil_net_conntable_stats
+{
+    uint32_t live;
+    uint32_t capacity;  /* slots carved so far */
+    uint32_t chunks;
+    uint64_t allocs;
+    uint64_t releases;
+    uint64_t stale;     /* lookups or releases with an outdated handle */
+} fossil_net_conntable_stats_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create an empty table. No slots are allocated until first use.
+ *
+ * @param object_size Bytes per object; objects are 16-byte aligned.
+ * @param max_objects Capacity limit, rounded up to whole chunks (0: 2^24).
+ * @return Table, or NULL on failure.
+ */
+fossil_net_conntable_t *fossil_net_conntable_create(
+    uint32_t object_size,
+    uint32_t max_objects);
+
+/**
+ * @brief Free the table and every object in it.
+ *
+ * @param table Table to destroy.
+ */
+void fossil_net_conntable_destroy(fossil_net_conntable_t *table);
+
+/*=============================================================================
+OBJECTS
+=============================================================================*/
+
+/**
+ * @brief Allocate a zeroed object.
+ *
+ * @param table  Table.
+ * @param handle Receives the object's handle.
+ * @return Object, or NULL when the table is full.
+ */
+void *fossil_net_conntable_alloc(
+    fossil_net_conntable_t *table,
+    fossil_net_handle_t *handle);
+
+/**
+ * @brief Release an object; its handle and pointer become invalid.
+ *
+ * @param table  Table.
+ * @param handle Handle from fossil_net_conntable_alloc().
+ * @return 0 on success, -1 if the handle is stale or invalid.
+ */
+int fossil_net_conntable_release(
+    fossil_net_conntable_t *table,
+    fossil_net_handle_t handle);
+
+/**
+ * @brief Resolve a handle in O(1).
+ *
+ * @param table  Table.
+ * @param handle Handle to resolve.
+ * @return Object, or NULL if the handle is stale or invalid.
+ */
+void *fossil_net_conntable_get(
+    fossil_net_conntable_t *table,
+    fossil_net_handle_t handle);
+
+/**
+ * @brief Handle of a live object.
+ *
+ * @param table  Table.
+ * @param object Object pointer from this table.
+ * @return Handle, or FOSSIL_NET_HANDLE_NONE if not live.
+ */
+fossil_net_handle_t fossil_net_conntable_handle_of(
+    const fossil_net_conntable_t *table,
+    const void *object);
+
+/*=============================================================================
+ITERATION
+=============================================================================*/
+
+/**
+ * @brief Number of live objects.
+ *
+ * @param table Table.
+ * @return Live count.
+ */
+uint32_t fossil_net_conntable_count(const fossil_net_conntable_t *table);
+
+/**
+ * @brief Live object by dense position.
+ *
+ * Positions are [0, count). Releasing an object moves the last one into its
+ * position, so iterate from count - 1 down to 0 when releasing on the way.
+ *
+ * @param table    Table.
+ * @param position Dense position.
+ * @param handle   Receives the handle (may be NULL).
+ * @return Object, or NULL if position is out of range.
+ */
+void *fossil_net_conntable_at(
+    fossil_net_conntable_t *table,
+    uint32_t position,
+    fossil_net_handle_t *handle);
+
+/**
+ * @brief Read counters.
+ *
+ * @param table Table.
+ * @param stats Output counters.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_conntable_get_stats(
+    const fossil_net_conntable_t *table,
+    fossil_net_conntable_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class ConnTable
+    {
+    private:
+        fossil_net_conntable_t *handle_;
+
+    public:
+        /**
+         * @brief Create a table. Wraps fossil_net_conntable_create.
+         */
+        explicit ConnTable(uint32_t object_size, uint32_t max_objects = 0)
+            : handle_(fossil_net_conntable_create(object_size, max_objects))
+        {
+        }
+
+        ~ConnTable()
+        {
+            if (handle_)
+                fossil_net_conntable_destroy(handle_);
+        }
+
+        /**
+         * @brief Allocate a zeroed object. Wraps fossil_net_conntable_alloc.
+         */
+        template <typename T>
+        T *alloc(fossil_net_handle_t *handle)
+        {
+            return static_cast<T *>(fossil_net_conntable_alloc(handle_, handle));
+        }
+
+        /**
+         * @brief Release an object. Wraps fossil_net_conntable_release.
+         */
+        int release(fossil_net_handle_t handle)
+        {
+            return fossil_net_conntable_release(handle_, handle);
+        }
+
+        /**
+         * @brief Resolve a handle. Wraps fossil_net_conntable_get.
+         */
+        template <typename T>
+        T *get(fossil_net_handle_t handle)
+        {
+            return static_cast<T *>(fossil_net_conntable_get(handle_, handle));
+        }
+
+        /**
+         * @brief Number of live objects. Wraps fossil_net_conntable_count.
+         */
+        uint32_t count() const
+        {
+            return fossil_net_conntable_count(handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_conntable_get_stats.
+         */
+        fossil_net_conntable_stats_t stats() const
+        {
+            fossil_net_conntable_stats_t s{};
+            fossil_net_conntable_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_conntable_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        ConnTable(const ConnTable &) = delete;
+        ConnTable &operator=(const ConnTable &) = delete;
+
+        // Allow move
+        ConnTable(ConnTable &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        ConnTable &operator=(ConnTable &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_conntable_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_CONNTABLE_H */
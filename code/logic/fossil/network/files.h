@@ -0,0 +1,232 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_FILES_H
+#define FOSSIL_NETWORK_FILES_H
+
+#include "fossil/network/httpd.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Static file handler with a cache of open descriptors.
+ *
+ * URL paths map to files below a root directory. Each file served keeps
+ * its descriptor open in an LRU cache together with its size, modification
+ * time and a header block (Content-Type, Last-Modified, ETag) built once,
+ * so a hit costs no open, no stat and no formatting. Entries are checked
+ * against the file system again at most every revalidate_ns. Bodies go
+ * out with sendfile through the connection's write queue.
+ *
+ * GET and HEAD are served, with If-None-Match / If-Modified-Since (304)
+ * and single byte ranges (206, 416), honouring If-Range. Requests for
+ * several ranges get the whole file.
+ *
+ * Thread-safe: every loop of a server may share one instance. A file
+ * evicted or replaced while being sent stays open until the last
+ * response using it has gone out.
+ */
+typedef struct fossil_net_files fossil_net_files_t;
+
+/**
+ * @brief Handler configuration; zero fields take the defaults.
+ */
+typedef struct fossil_net_files_config
+{
+    const char *root;          /* directory served, required */
+    const char *index;         /* file served for paths ending in '/', default "index.html" */
+    const char *cache_control; /* Cache-Control value, NULL for none */
+    uint32_t max_open;         /* cached descriptors, default 1024 */
+    uint64_t revalidate_ns;    /* stat again after this long, default 1 s */
+} fossil_net_files_config_t;
+
+/**
+ * @brief Handler counters.
+ */
+typedef struct fossil_net_files_stats
+{
+    uint64_t hits;          /* served from a cached descriptor */
+    uint64_t misses;        /* opened */
+    uint64_t evictions;     /* dropped for space */
+    uint64_t revalidations; /* stale entries found unchanged */
+    uint64_t not_found;
+    uint64_t not_modified;  /* 304 */
+    uint64_t partial;       /* 206 */
+    uint64_t bytes;         /* body bytes queued */
+} fossil_net_files_stats_t;
+
+/*=============================================================================
+FILES
+=============================================================================*/
+
+/**
+ * @brief Create a handler.
+ *
+ * @param config Configuration; root is required.
+ * @return Handler, or NULL on failure.
+ */
+fossil_net_files_t *fossil_net_files_create(const fossil_net_files_config_t *config);
+
+/**
+ * @brief Destroy a handler and close its cached descriptors.
+ *
+ * Descriptors still referenced by queued responses close once sent.
+ *
+ * @param files Handler.
+ */
+void fossil_net_files_destroy(fossil_net_files_t *files);
+
+/**
+ * @brief Route handler; pass the fossil_net_files_t as user.
+ *
+ * Serves the "path" route parameter when the route has one (a final
+ * "*path" segment), otherwise the whole request path.
+ *
+ * @param ex   Exchange.
+ * @param req  Request.
+ * @param user Handler from fossil_net_files_create.
+ */
+void fossil_net_files_handler(
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req,
+    void *user);
+
+/**
+ * @brief Serve a URL path, still percent-encoded.
+ *
+ * Paths with ".." segments, backslashes or NUL bytes get 404, as do
+ * missing and non-regular files. A directory requested without a
+ * trailing slash is redirected to the slash form.
+ *
+ * @param files Handler.
+ * @param ex    Exchange.
+ * @param req   Request.
+ * @param path  URL path below the root.
+ * @param len   Length of path.
+ * @return 0 once a response was sent, -1 on failure.
+ */
+int fossil_net_files_serve(
+    fossil_net_files_t *files,
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req,
+    const char *path,
+    uint32_t len);
+
+/**
+ * @brief Read counters.
+ *
+ * @param files Handler.
+ * @param stats Receives the counters.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_net_files_get_stats(fossil_net_files_t *files, fossil_net_files_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#include <string>
+
+namespace fossil::net
+{
+
+    class Files
+    {
+    private:
+        fossil_net_files_t *handle_;
+
+    public:
+        /**
+         * @brief Create a handler. Wraps fossil_net_files_create.
+         */
+        explicit Files(const fossil_net_files_config_t &config)
+            : handle_(fossil_net_files_create(&config))
+        {
+        }
+
+        ~Files()
+        {
+            if (handle_)
+                fossil_net_files_destroy(handle_);
+        }
+
+        /**
+         * @brief Mount on a server. Registers fossil_net_files_handler
+         *        for GET, which HEAD falls back to.
+         */
+        bool mount(Httpd &httpd, const std::string &pattern)
+        {
+            return handle_ && httpd.route(FOSSIL_NET_HTTP_GET, pattern, fossil_net_files_handler, handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_files_get_stats.
+         */
+        fossil_net_files_stats_t stats() const
+        {
+            fossil_net_files_stats_t s{};
+            fossil_net_files_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying handler.
+         */
+        fossil_net_files_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Files(const Files &) = delete;
+        Files &operator=(const Files &) = delete;
+
+        // Allow move
+        Files(Files &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Files &operator=(Files &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_files_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_FILES_H */
@@ -0,0 +1,283 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_FILTER_H
+#define FOSSIL_NETWORK_FILTER_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief One classic BPF instruction, layout compatible with struct sock_filter.
+ */
+typedef struct fossil_net_filter_insn
+{
+    uint16_t code;
+    uint8_t jt;
+    uint8_t jf;
+    uint32_t k;
+} fossil_net_filter_insn_t;
+
+/**
+ * @brief Opaque classic BPF program.
+ */
+typedef struct fossil_net_filter fossil_net_filter_t;
+
+/** Largest program accepted, in instructions (the kernel limit is 4096). */
+#define FOSSIL_NET_FILTER_MAX_INSNS 4096
+
+/*=============================================================================
+PROGRAMS
+=============================================================================*/
+
+/**
+ * @brief Create a filter from hand-written instructions.
+ *
+ * @param insns Instructions (copied).
+ * @param count Number of instructions.
+ * @return Pointer to filter, or NULL on failure.
+ */
+fossil_net_filter_t *fossil_net_filter_create(
+    const fossil_net_filter_insn_t *insns,
+    uint32_t count);
+
+/**
+ * @brief Compile a filter expression into classic BPF.
+ *
+ * The language is a small subset of pcap-filter(7):
+ *   - protocols: ip, ip6, tcp, udp, icmp, icmp6
+ *   - [src|dst] host ADDR, [src|dst] net ADDR/LEN, [src|dst] port N
+ *   - and (&&), or (||), not (!), parentheses; juxtaposition means "and"
+ *
+ * Header fields are addressed relative to the network header, so the same
+ * program works on "packet", "raw" and "udp" sockets. IPv6 extension
+ * headers are not followed. An empty expression accepts everything.
+ *
+ * @param expression Filter expression, e.g. "udp and dst port 53".
+ * @return Pointer to filter, or NULL on a syntax error.
+ */
+fossil_net_filter_t *fossil_net_filter_compile(const char *expression);
+
+/**
+ * @brief Build a SO_REUSEPORT group program that picks a socket by CPU.
+ *
+ * The program returns the index i of the first cpus[i] equal to the CPU
+ * processing the packet (the one serving the NIC receive queue it came
+ * in on), and that CPU modulo count otherwise. With socket i of the group
+ * served by a thread pinned to cpus[i], a flow is handled on the CPU its
+ * packets arrive on. Positions count every member, so attach it only to
+ * a group whose members you created, in order. Uses the SKF_AD_CPU
+ * ancillary load, so fossil_net_filter_run rejects every packet.
+ *
+ * @param cpus  CPU of each socket, in the order they joined the group.
+ * @param count Number of sockets, at most 254.
+ * @return Pointer to filter, or NULL on failure.
+ */
+fossil_net_filter_t *fossil_net_filter_reuseport_cpu(const int32_t *cpus, uint32_t count);
+
+/**
+ * @brief Destroy a filter. Attached copies in the kernel are unaffected.
+ *
+ * @param filter Pointer to filter.
+ */
+void fossil_net_filter_destroy(fossil_net_filter_t *filter);
+
+/**
+ * @brief Get the instructions of a filter.
+ *
+ * @param filter Pointer to filter.
+ * @param count  Pointer to variable to receive the instruction count.
+ * @return Pointer to the instructions, owned by the filter.
+ */
+const fossil_net_filter_insn_t *fossil_net_filter_program(
+    const fossil_net_filter_t *filter,
+    uint32_t *count);
+
+/**
+ * @brief Run a filter over a packet in user space.
+ *
+ * Useful for testing and on platforms without socket filters. Loads
+ * relative to the network header (SKF_NET_OFF) use net_offset; ancillary
+ * loads are not supported and reject the packet.
+ *
+ * @param filter     Pointer to filter.
+ * @param packet     Packet bytes.
+ * @param size       Packet length.
+ * @param net_offset Offset of the network header within packet (14 for Ethernet).
+ * @return Number of bytes to keep; 0 means the packet is rejected.
+ */
+uint32_t fossil_net_filter_run(
+    const fossil_net_filter_t *filter,
+    const void *packet,
+    uint32_t size,
+    uint32_t net_offset);
+
+/*=============================================================================
+SOCKET ATTACHMENT
+=============================================================================*/
+
+/**
+ * @brief Attach a filter to a socket (SO_ATTACH_FILTER).
+ *
+ * Rejected packets are dropped by the kernel before they are queued to
+ * the socket. Replaces any filter already attached. Linux only.
+ *
+ * @param sock   Pointer to socket structure.
+ * @param filter Pointer to filter.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_filter_attach(
+    fossil_net_socket_t *sock,
+    const fossil_net_filter_t *filter);
+
+/**
+ * @brief Attach a socket selection program to a SO_REUSEPORT group
+ *        (SO_ATTACH_REUSEPORT_CBPF).
+ *
+ * The program's return value is the index of the socket, in the order
+ * the sockets joined the group, that receives the packet or connection;
+ * out of range values fall back to the kernel's hash. Attaching to any
+ * member applies to the whole group. Linux 4.5 and later.
+ *
+ * @param sock   Pointer to a bound SO_REUSEPORT socket.
+ * @param filter Pointer to filter, e.g. from fossil_net_filter_reuseport_cpu.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_filter_attach_reuseport(
+    fossil_net_socket_t *sock,
+    const fossil_net_filter_t *filter);
+
+/**
+ * @brief Remove the filter attached to a socket.
+ *
+ * @param sock Pointer to socket structure.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_filter_detach(fossil_net_socket_t *sock);
+
+#ifdef __cplusplus
+}
+
+#include <string>
+
+namespace fossil::net
+{
+
+    class Filter
+    {
+    private:
+        fossil_net_filter_t *handle_;
+
+    public:
+        /**
+         * @brief Compile an expression. Wraps fossil_net_filter_compile.
+         */
+        explicit Filter(const std::string &expression)
+            : handle_(fossil_net_filter_compile(expression.c_str()))
+        {}
+
+        /**
+         * @brief Destroy the filter. Wraps fossil_net_filter_destroy.
+         */
+        ~Filter()
+        {
+            if (handle_)
+                fossil_net_filter_destroy(handle_);
+        }
+
+        /**
+         * @brief Check that compilation succeeded.
+         */
+        bool valid() const
+        {
+            return handle_ != nullptr;
+        }
+
+        /**
+         * @brief Run over a packet in user space. Wraps fossil_net_filter_run.
+         */
+        uint32_t run(const void *packet, uint32_t size, uint32_t net_offset) const
+        {
+            return fossil_net_filter_run(handle_, packet, size, net_offset);
+        }
+
+        /**
+         * @brief Attach to a socket. Wraps fossil_net_filter_attach.
+         */
+        int attach(fossil_net_socket_t *sock) const
+        {
+            return fossil_net_filter_attach(sock, handle_);
+        }
+
+        /**
+         * @brief Attach to a SO_REUSEPORT group. Wraps fossil_net_filter_attach_reuseport.
+         */
+        int attach_reuseport(fossil_net_socket_t *sock) const
+        {
+            return fossil_net_filter_attach_reuseport(sock, handle_);
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_filter_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Filter(const Filter &) = delete;
+        Filter &operator=(const Filter &) = delete;
+
+        // Allow move
+        Filter(Filter &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Filter &operator=(Filter &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_filter_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_FILTER_H */
@@ -0,0 +1,329 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_FLOW_H
+#define FOSSIL_NETWORK_FLOW_H
+
+#include "packet.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Unidirectional 5-tuple. Addresses are zero-padded to 16 bytes for
+ *        IPv4; ICMP flows carry type << 8 | code in dst_port like NetFlow.
+ */
+typedef struct fossil_net_flow_key
+{
+    uint8_t src[16];
+    uint8_t dst[16];
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint8_t proto;
+    uint8_t family;      /* FOSSIL_NET_SOCKET_FAMILY_IPV4 or _IPV6 */
+    uint8_t reserved[2]; /* must be zero */
+} fossil_net_flow_key_t;
+
+/**
+ * @brief Accounting state of one flow.
+ */
+typedef struct fossil_net_flow_record
+{
+    fossil_net_flow_key_t key;
+    uint64_t packets;
+    uint64_t bytes;      /* IP-layer bytes */
+    uint64_t first_ns;   /* first packet timestamp */
+    uint64_t last_ns;    /* latest packet timestamp */
+    uint8_t tcp_flags;   /* OR of all TCP flags seen */
+} fossil_net_flow_record_t;
+
+/**
+ * @brief Table counters, summed over shards.
+ */
+typedef struct fossil_net_flow_stats
+{
+    uint64_t flows;    /* live flows */
+    uint64_t inserts;  /* flows created */
+    uint64_t expired;  /* flows aged out */
+    uint64_t dropped;  /* new flows refused because a shard was full */
+} fossil_net_flow_stats_t;
+
+/**
+ * @brief Opaque flow table.
+ *
+ * Flows are spread over independently locked shards, each an open-addressed
+ * linear-probing array, so writers on different shards never contend (with
+ * FANOUT_HASH capture a flow always lands on the same thread and its shard
+ * lock is uncontended). Every slot carries a sequence counter; snapshots
+ * read it seqlock-style and never take a lock, so they do not pause writers.
+ */
+typedef struct fossil_net_flow_table fossil_net_flow_table_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create a flow table.
+ *
+ * @param capacity Maximum number of flows, rounded up per shard.
+ * @param shards   Number of shards, rounded up to a power of two (0 = 64).
+ * @return Table, or NULL on failure.
+ */
+fossil_net_flow_table_t *fossil_net_flow_create(
+    uint32_t capacity,
+    uint32_t shards);
+
+/**
+ * @brief Destroy a flow table. No other thread may be using it.
+ *
+ * @param table Table to destroy.
+ */
+void fossil_net_flow_destroy(fossil_net_flow_table_t *table);
+
+/*=============================================================================
+ACCOUNTING
+=============================================================================*/
+
+/**
+ * @brief Build a flow key from a decoded packet.
+ *
+ * @param pkt Decoded packet with an IPv4 or IPv6 layer.
+ * @param key Key out.
+ * @return 0 on success, -1 if the packet has no IP layer.
+ */
+int fossil_net_flow_key_from_packet(
+    const fossil_net_packet_t *pkt,
+    fossil_net_flow_key_t *key);
+
+/**
+ * @brief Account one packet to a flow, creating it if needed.
+ *
+ * @param table     Table.
+ * @param key       Flow key.
+ * @param bytes     Bytes to add.
+ * @param tcp_flags TCP flags to OR in.
+ * @param now_ns    Packet timestamp, 0 for fossil_net_socket_clock_ns().
+ * @return 0 on success, -1 if the flow is new and its shard is full.
+ */
+int fossil_net_flow_update(
+    fossil_net_flow_table_t *table,
+    const fossil_net_flow_key_t *key,
+    uint32_t bytes,
+    uint8_t tcp_flags,
+    uint64_t now_ns);
+
+/**
+ * @brief Account a decoded packet (key, IP length and TCP flags from the headers).
+ *
+ * @param table  Table.
+ * @param pkt    Decoded packet.
+ * @param now_ns Packet timestamp, 0 for fossil_net_socket_clock_ns().
+ * @return 0 on success, -1 if not IP or the shard is full.
+ */
+int fossil_net_flow_account(
+    fossil_net_flow_table_t *table,
+    const fossil_net_packet_t *pkt,
+    uint64_t now_ns);
+
+/**
+ * @brief Look up one flow.
+ *
+ * @param table  Table.
+ * @param key    Flow key.
+ * @param record Record out.
+ * @return 0 if found, -1 otherwise.
+ */
+int fossil_net_flow_lookup(
+    fossil_net_flow_table_t *table,
+    const fossil_net_flow_key_t *key,
+    fossil_net_flow_record_t *record);
+
+/*=============================================================================
+EXPORT
+=============================================================================*/
+
+/**
+ * @brief Copy live flows without locking.
+ *
+ * Each record is internally consistent; the set is consistent per shard.
+ *
+ * @param table   Table.
+ * @param records Output array.
+ * @param max     Capacity of records.
+ * @return Number of records written.
+ */
+uint32_t fossil_net_flow_snapshot(
+    fossil_net_flow_table_t *table,
+    fossil_net_flow_record_t *records,
+    uint32_t max);
+
+/**
+ * @brief Remove flows idle for at least idle_ns and return them for export.
+ *
+ * Stops once max records were collected; remaining idle flows are picked up
+ * by the next call.
+ *
+ * @param table   Table.
+ * @param now_ns  Current time, 0 for fossil_net_socket_clock_ns().
+ * @param idle_ns Idle timeout.
+ * @param records Output array, may be NULL when max is 0 to only count.
+ * @param max     Capacity of records, 0 for no limit without output.
+ * @return Number of flows removed.
+ */
+uint32_t fossil_net_flow_expire(
+    fossil_net_flow_table_t *table,
+    uint64_t now_ns,
+    uint64_t idle_ns,
+    fossil_net_flow_record_t *records,
+    uint32_t max);
+
+/**
+ * @brief Read table counters.
+ *
+ * @param table Table.
+ * @param stats Stats out.
+ * @return 0 on success, -1 on error.
+ */
+int fossil_net_flow_get_stats(
+    fossil_net_flow_table_t *table,
+    fossil_net_flow_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class FlowTable
+    {
+    private:
+        fossil_net_flow_table_t *handle_;
+
+    public:
+        /**
+         * @brief Create a table. Wraps fossil_net_flow_create.
+         */
+        explicit FlowTable(uint32_t capacity, uint32_t shards = 0)
+            : handle_(fossil_net_flow_create(capacity, shards))
+        {
+        }
+
+        ~FlowTable()
+        {
+            if (handle_)
+                fossil_net_flow_destroy(handle_);
+        }
+
+        /**
+         * @brief Account a packet. Wraps fossil_net_flow_update.
+         */
+        bool update(const fossil_net_flow_key_t &key, uint32_t bytes, uint8_t tcp_flags = 0, uint64_t now_ns = 0)
+        {
+            return fossil_net_flow_update(handle_, &key, bytes, tcp_flags, now_ns) == 0;
+        }
+
+        /**
+         * @brief Account a decoded packet. Wraps fossil_net_flow_account.
+         */
+        bool account(const fossil_net_packet_t &pkt, uint64_t now_ns = 0)
+        {
+            return fossil_net_flow_account(handle_, &pkt, now_ns) == 0;
+        }
+
+        /**
+         * @brief Look up a flow. Wraps fossil_net_flow_lookup.
+         */
+        bool lookup(const fossil_net_flow_key_t &key, fossil_net_flow_record_t &record)
+        {
+            return fossil_net_flow_lookup(handle_, &key, &record) == 0;
+        }
+
+        /**
+         * @brief Copy live flows. Wraps fossil_net_flow_snapshot.
+         */
+        uint32_t snapshot(fossil_net_flow_record_t *records, uint32_t max)
+        {
+            return fossil_net_flow_snapshot(handle_, records, max);
+        }
+
+        /**
+         * @brief Age out idle flows. Wraps fossil_net_flow_expire.
+         */
+        uint32_t expire(uint64_t now_ns, uint64_t idle_ns, fossil_net_flow_record_t *records = nullptr, uint32_t max = 0)
+        {
+            return fossil_net_flow_expire(handle_, now_ns, idle_ns, records, max);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_flow_get_stats.
+         */
+        fossil_net_flow_stats_t stats()
+        {
+            fossil_net_flow_stats_t s{};
+            fossil_net_flow_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_flow_table_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        FlowTable(const FlowTable &) = delete;
+        FlowTable &operator=(const FlowTable &) = delete;
+
+        // Allow move
+        FlowTable(FlowTable &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        FlowTable &operator=(FlowTable &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_flow_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_FLOW_H */
@@ -26,8 +26,31 @@
 #define FOSSIL_NETWORK_FRAMEWORK_H
 
 #include "socket.h"
+#include "inet.h"
+#include "ratelimit.h"
+#include "multicast.h"
+#include "zerocopy.h"
+#include "capture.h"
+#include "filter.h"
+#include "packet.h"
+#include "checksum.h"
+#include "builder.h"
+#include "flow.h"
+#include "probe.h"
+#include "tap.h"
 #include "client.h"
 #include "server.h"
 #include "request.h"
+#include "reactor.h"
+#include "pool.h"
+#include "conntable.h"
+#include "writeq.h"
+#include "shed.h"
+#include "parser.h"
+#include "router.h"
+#include "httpd.h"
+#include "files.h"
+#include "cache.h"
+#include "metrics.h"
 
 #endif /* FOSSIL_NETWORK_FRAMEWORK_H */
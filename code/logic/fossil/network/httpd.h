@@ -0,0 +1,503 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_HTTPD_H
+#define FOSSIL_NETWORK_HTTPD_H
+
+#include "fossil/network/reactor.h"
+#include "fossil/network/router.h"
+#include "fossil/network/shed.h"
+#include "fossil/network/cache.h"
+#include "fossil/network/metrics.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief HTTP/1.1 server on top of the reactor.
+ *
+ * Connections are persistent: a connection carries requests until the
+ * client asks to close, an error response is sent, or max_requests is
+ * reached. Requests that arrive together (pipelined) are parsed from the
+ * same read and dispatched in order; their responses are written in
+ * request order and each batch leaves in a single buffered write.
+ */
+typedef struct fossil_net_httpd fossil_net_httpd_t;
+
+/**
+ * @brief One request/response pair on a connection.
+ *
+ * Valid until it is responded to or the connection closes. A handler
+ * that returns without responding defers the response: later responses
+ * on the connection are held back until it is sent. Deferred responses
+ * must be sent from the connection's loop, e.g. from a task posted with
+ * fossil_net_reactor_post_conn, which also tells whether the connection
+ * (and with it the exchange) is still there.
+ */
+typedef struct fossil_net_http_exchange fossil_net_http_exchange_t;
+
+/**
+ * @brief Request handler.
+ *
+ * The request and everything it points to are only valid during the call.
+ */
+typedef void (*fossil_net_http_handler_fn)(
+    fossil_net_http_exchange_t *ex,
+    const fossil_net_http_request_t *req,
+    void *user);
+
+/**
+ * @brief Server settings; zero fields take the defaults.
+ */
+typedef struct fossil_net_httpd_config
+{
+    fossil_net_reactor_config_t reactor;
+    uint32_t max_head;      /* request line + headers, default 16 KiB */
+    uint32_t max_body;      /* larger bodies get 413, default 1 MiB */
+    uint32_t max_pipeline;  /* requests in flight per connection, default 16 */
+    uint32_t max_requests;  /* per connection before closing, 0 for no limit */
+} fossil_net_httpd_config_t;
+
+/**
+ * @brief Server counters, summed over the loops.
+ */
+typedef struct fossil_net_httpd_stats
+{
+    uint64_t requests;
+    uint64_t reused;        /* requests on a connection that served one before */
+    uint64_t pipelined;     /* requests that arrived behind another in one read */
+    uint64_t flushes;       /* buffered writes of response batches */
+    uint64_t errors;        /* malformed requests answered with 4xx/5xx */
+    uint64_t shed;          /* answered with the shedder's canned response */
+} fossil_net_httpd_stats_t;
+
+/*=============================================================================
+SERVER
+=============================================================================*/
+
+/**
+ * @brief Create a server on a TCP server socket.
+ *
+ * @param server TCP server from fossil_net_server_create(); must outlive
+ *               the httpd.
+ * @param config Settings, or NULL for defaults.
+ * @return Server, or NULL on failure.
+ */
+fossil_net_httpd_t *fossil_net_httpd_create(
+    fossil_net_server_t *server,
+    const fossil_net_httpd_config_t *config);
+
+/**
+ * @brief Stop the server if running and release it.
+ *
+ * @param httpd Server.
+ */
+void fossil_net_httpd_destroy(fossil_net_httpd_t *httpd);
+
+/**
+ * @brief Register a handler; call before fossil_net_httpd_start().
+ *
+ * Unmatched paths get 404, paths matched for other methods 405 with an
+ * Allow header.
+ *
+ * @param httpd   Server.
+ * @param method  Method.
+ * @param pattern Route pattern, see fossil_net_router_t.
+ * @param handler Handler.
+ * @param user    Passed to the handler.
+ * @return 0 on success, -1 on an invalid or conflicting route.
+ */
+int fossil_net_httpd_route(
+    fossil_net_httpd_t *httpd,
+    fossil_net_http_method_t method,
+    const char *pattern,
+    fossil_net_http_handler_fn handler,
+    void *user);
+
+/**
+ * @brief Attach an overload shedder; call before fossil_net_httpd_start().
+ *
+ * Besides connection admission (see fossil_net_reactor_set_shed) the
+ * server records how long each request waited after being read and asks
+ * fossil_net_shed_admit before running it; refused requests get the
+ * canned response and the connection is closed.
+ *
+ * @param httpd Server.
+ * @param shed  Shedder that outlives the server, or NULL to detach.
+ * @return 0 on success, non-zero if the server is running.
+ */
+int fossil_net_httpd_set_shed(
+    fossil_net_httpd_t *httpd,
+    fossil_net_shed_t *shed);
+
+/**
+ * @brief Attach a response cache; call before fossil_net_httpd_start().
+ *
+ * GET and HEAD requests are looked up before routing; hits, and 304s for
+ * matching conditionals, are answered without running a handler, even
+ * while shedding. On a miss, a 200 sent with fossil_net_http_respond is
+ * offered to the cache together with its headers.
+ *
+ * @param httpd Server.
+ * @param cache Cache that outlives the server, or NULL to detach.
+ * @return 0 on success, non-zero if the server is running.
+ */
+int fossil_net_httpd_set_cache(
+    fossil_net_httpd_t *httpd,
+    fossil_net_cache_t *cache);
+
+/**
+ * @brief Export metrics to a registry; call before fossil_net_httpd_start().
+ *
+ * Adds the reactor's counters (see fossil_net_metrics_attach_reactor),
+ * the server's request counters, and a latency histogram per route,
+ * fossil_net_http_request_duration_seconds with method and route labels,
+ * timed from parsing a request to queueing its response. Cache hits are
+ * recorded under route "(cache)", 404s and 405s under route "". Requests
+ * refused by the shedder are only counted.
+ *
+ * @param httpd   Server.
+ * @param metrics Registry that outlives the server, or NULL to detach.
+ * @param labels  Label pairs added to every series, or NULL.
+ * @return 0 on success, non-zero on failure or if the server is running.
+ */
+int fossil_net_httpd_set_metrics(
+    fossil_net_httpd_t *httpd,
+    fossil_net_metrics_t *metrics,
+    const char *labels);
+
+/**
+ * @brief Start the event loops.
+ *
+ * @param httpd Server.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_httpd_start(fossil_net_httpd_t *httpd);
+
+/**
+ * @brief Stop the event loops; open connections are closed.
+ *
+ * @param httpd Server.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_httpd_stop(fossil_net_httpd_t *httpd);
+
+/**
+ * @brief Graceful shutdown: stop accepting and finish in-flight requests.
+ *
+ * Idle keep-alive connections are closed at once. A connection with a
+ * request in progress answers what it has already received, with
+ * Connection: close on any request parsed from now on, and closes after
+ * the last response is sent. Wait with fossil_net_reactor_wait_drained()
+ * on fossil_net_httpd_reactor(), then stop.
+ *
+ * @param httpd Server.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_httpd_drain(fossil_net_httpd_t *httpd);
+
+/**
+ * @brief Reactor running the server, e.g. for posting tasks.
+ *
+ * @param httpd Server.
+ * @return Reactor.
+ */
+fossil_net_reactor_t *fossil_net_httpd_reactor(fossil_net_httpd_t *httpd);
+
+/**
+ * @brief Read counters.
+ *
+ * @param httpd Server.
+ * @param stats Receives the counters.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_httpd_get_stats(
+    fossil_net_httpd_t *httpd,
+    fossil_net_httpd_stats_t *stats);
+
+/*=============================================================================
+EXCHANGES
+=============================================================================*/
+
+/**
+ * @brief Add a response header; call before responding.
+ *
+ * @param ex    Exchange.
+ * @param name  Header name.
+ * @param value Header value.
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_net_http_add_header(
+    fossil_net_http_exchange_t *ex,
+    const char *name,
+    const char *value);
+
+/**
+ * @brief Send the response.
+ *
+ * Content-Length is added, and Connection as needed. The body is copied
+ * and omitted for HEAD requests, 1xx, 204 and 304.
+ *
+ * @param ex           Exchange; invalid after this returns.
+ * @param status       Status code.
+ * @param content_type Content-Type, or NULL for none.
+ * @param body         Body bytes.
+ * @param len          Body length.
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_net_http_respond(
+    fossil_net_http_exchange_t *ex,
+    int status,
+    const char *content_type,
+    const void *body,
+    uint32_t len);
+
+/**
+ * @brief Send a response whose body is a range of an open file.
+ *
+ * The body goes out with fossil_net_conn_write_file, so it is never
+ * copied into the server. headers is a block of complete header lines,
+ * each ending in CRLF, typically precomputed per file.
+ *
+ * @param ex          Exchange; invalid after this returns.
+ * @param status      Status code.
+ * @param headers     Extra header lines (may be NULL).
+ * @param headers_len Length of headers.
+ * @param owner       Buffer keeping fd open; referenced until sent.
+ * @param fd          Open file descriptor.
+ * @param offset      First byte of the body in the file.
+ * @param len         Body length.
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_net_http_respond_file(
+    fossil_net_http_exchange_t *ex,
+    int status,
+    const char *headers,
+    uint32_t headers_len,
+    fossil_net_buf_t *owner,
+    int32_t fd,
+    uint64_t offset,
+    uint64_t len);
+
+/**
+ * @brief Close the connection after this response.
+ *
+ * @param ex Exchange, before responding.
+ */
+void fossil_net_http_close_after(fossil_net_http_exchange_t *ex);
+
+/**
+ * @brief Request body, de-chunked; only valid during the handler call.
+ *
+ * @param ex Exchange.
+ * @return Body slice, empty if none.
+ */
+fossil_net_slice_t fossil_net_http_body(const fossil_net_http_exchange_t *ex);
+
+/**
+ * @brief Route parameter by name; only valid during the handler call.
+ *
+ * @param ex    Exchange.
+ * @param name  Parameter name.
+ * @param value Receives the value (may be NULL).
+ * @return true if present.
+ */
+bool fossil_net_http_param(
+    const fossil_net_http_exchange_t *ex,
+    const char *name,
+    fossil_net_slice_t *value);
+
+/**
+ * @brief Connection carrying the exchange.
+ *
+ * @param ex Exchange.
+ * @return Connection.
+ */
+fossil_net_conn_t *fossil_net_http_conn(fossil_net_http_exchange_t *ex);
+
+/**
+ * @brief Standard reason phrase for a status code.
+ *
+ * @param status Status code.
+ * @return Static string, "Unknown" if not recognised.
+ */
+const char *fossil_net_http_reason(int status);
+
+#ifdef __cplusplus
+}
+#include <string>
+
+namespace fossil::net
+{
+
+    class Httpd
+    {
+    private:
+        fossil_net_httpd_t *handle_;
+
+    public:
+        /**
+         * @brief Create a server. Wraps fossil_net_httpd_create.
+         */
+        explicit Httpd(fossil_net_server_t *server, const fossil_net_httpd_config_t *config = nullptr)
+            : handle_(fossil_net_httpd_create(server, config))
+        {
+        }
+
+        ~Httpd()
+        {
+            if (handle_)
+                fossil_net_httpd_destroy(handle_);
+        }
+
+        /**
+         * @brief Register a handler. Wraps fossil_net_httpd_route.
+         */
+        bool route(fossil_net_http_method_t method, const std::string &pattern,
+                   fossil_net_http_handler_fn handler, void *user = nullptr)
+        {
+            return fossil_net_httpd_route(handle_, method, pattern.c_str(), handler, user) == 0;
+        }
+
+        /**
+         * @brief Attach an overload shedder. Wraps fossil_net_httpd_set_shed.
+         */
+        int set_shed(fossil_net_shed_t *shed)
+        {
+            return fossil_net_httpd_set_shed(handle_, shed);
+        }
+
+        /**
+         * @brief Attach a response cache. Wraps fossil_net_httpd_set_cache.
+         */
+        int set_cache(fossil_net_cache_t *cache)
+        {
+            return fossil_net_httpd_set_cache(handle_, cache);
+        }
+
+        /**
+         * @brief Export metrics to a registry. Wraps fossil_net_httpd_set_metrics.
+         */
+        int set_metrics(fossil_net_metrics_t *metrics, const std::string &labels = std::string())
+        {
+            return fossil_net_httpd_set_metrics(handle_, metrics, labels.c_str());
+        }
+
+        /**
+         * @brief Start the event loops. Wraps fossil_net_httpd_start.
+         */
+        int start()
+        {
+            return fossil_net_httpd_start(handle_);
+        }
+
+        /**
+         * @brief Stop the event loops. Wraps fossil_net_httpd_stop.
+         */
+        int stop()
+        {
+            return fossil_net_httpd_stop(handle_);
+        }
+
+        /**
+         * @brief Stop accepting and finish in-flight requests.
+         *
+         * Wraps fossil_net_httpd_drain.
+         */
+        int drain()
+        {
+            return fossil_net_httpd_drain(handle_);
+        }
+
+        /**
+         * @brief Wait until every connection has closed.
+         *
+         * Wraps fossil_net_reactor_wait_drained.
+         */
+        int wait_drained(uint64_t timeout_ns)
+        {
+            return fossil_net_reactor_wait_drained(fossil_net_httpd_reactor(handle_), timeout_ns);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_httpd_get_stats.
+         */
+        fossil_net_httpd_stats_t stats() const
+        {
+            fossil_net_httpd_stats_t s{};
+            fossil_net_httpd_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Send a response. Wraps fossil_net_http_respond.
+         */
+        static int respond(fossil_net_http_exchange_t *ex, int status,
+                           const std::string &content_type, const std::string &body)
+        {
+            return fossil_net_http_respond(ex, status, content_type.empty() ? nullptr : content_type.c_str(),
+                                           body.data(), static_cast<uint32_t>(body.size()));
+        }
+
+        /**
+         * @brief Get the underlying server handle.
+         */
+        fossil_net_httpd_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Httpd(const Httpd &) = delete;
+        Httpd &operator=(const Httpd &) = delete;
+
+        // Allow move
+        Httpd(Httpd &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Httpd &operator=(Httpd &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_httpd_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_HTTPD_H */
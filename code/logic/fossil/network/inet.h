@@ -0,0 +1,288 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_INET_H
+#define FOSSIL_NETWORK_INET_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CONSTANTS
+=============================================================================*/
+
+/* Buffer sizes (including the terminating NUL) large enough for any output */
+#define FOSSIL_NET_INET_IPV4_STRLEN     16  /* 255.255.255.255 */
+#define FOSSIL_NET_INET_IPV6_STRLEN     46  /* ffff:...:255.255.255.255 */
+#define FOSSIL_NET_INET_MAC_STRLEN      18  /* AA:BB:CC:DD:EE:FF */
+#define FOSSIL_NET_INET_ENDPOINT_STRLEN 54  /* [ipv6]:65535 */
+
+/*=============================================================================
+IPV4 / IPV6
+=============================================================================*/
+
+/*
+ * These routines are table-driven and locale independent; they never
+ * allocate and never call into libc formatting. Output matches inet_ntop,
+ * and input rules match inet_pton (dotted-quad only for IPv4).
+ */
+
+/**
+ * @brief Parse a dotted-quad IPv4 address.
+ *
+ * @param string NUL-terminated address string.
+ * @param out    Receives the 4 address bytes in network order.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_inet_ipv4_parse(
+    const char *string,
+    uint8_t out[4]);
+
+/**
+ * @brief Format an IPv4 address as a dotted quad.
+ *
+ * @param ip     Address bytes in network order.
+ * @param buffer Output buffer.
+ * @param size   Size of output buffer (FOSSIL_NET_INET_IPV4_STRLEN is always enough).
+ * @return Number of characters written (excluding NUL), or -1 on failure.
+ */
+int fossil_net_inet_ipv4_format(
+    const uint8_t ip[4],
+    char *buffer,
+    uint32_t size);
+
+/**
+ * @brief Parse an IPv6 address, including "::" compression and an embedded IPv4 tail.
+ *
+ * @param string NUL-terminated address string.
+ * @param out    Receives the 16 address bytes in network order.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_inet_ipv6_parse(
+    const char *string,
+    uint8_t out[16]);
+
+/**
+ * @brief Format an IPv6 address in RFC 5952 form.
+ *
+ * @param ip     Address bytes in network order.
+ * @param buffer Output buffer.
+ * @param size   Size of output buffer (FOSSIL_NET_INET_IPV6_STRLEN is always enough).
+ * @return Number of characters written (excluding NUL), or -1 on failure.
+ */
+int fossil_net_inet_ipv6_format(
+    const uint8_t ip[16],
+    char *buffer,
+    uint32_t size);
+
+/*=============================================================================
+MAC ADDRESS
+=============================================================================*/
+
+/**
+ * @brief Parse a MAC address of the form "AA:BB:CC:DD:EE:FF" (':' or '-' separated).
+ *
+ * @param string NUL-terminated MAC string.
+ * @param out    Receives the 6 address bytes.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_inet_mac_parse(
+    const char *string,
+    uint8_t out[6]);
+
+/**
+ * @brief Format a MAC address as upper-case "AA:BB:CC:DD:EE:FF".
+ *
+ * @param bytes  The 6 address bytes.
+ * @param buffer Output buffer.
+ * @param size   Size of output buffer (at least FOSSIL_NET_INET_MAC_STRLEN).
+ * @return Number of characters written (excluding NUL), or -1 on failure.
+ */
+int fossil_net_inet_mac_format(
+    const uint8_t bytes[6],
+    char *buffer,
+    uint32_t size);
+
+/*=============================================================================
+ENDPOINTS
+=============================================================================*/
+
+/**
+ * @brief Parse an IP string and port into a binary endpoint.
+ *
+ * @param ep   Pointer to endpoint structure to fill.
+ * @param ip   IPv4 or IPv6 address string.
+ * @param port Port number.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_endpoint_parse(
+    fossil_net_endpoint_t *ep,
+    const char *ip,
+    uint16_t port);
+
+/**
+ * @brief Format an endpoint as "a.b.c.d:port" or "[v6]:port".
+ *
+ * @param ep     Pointer to endpoint structure.
+ * @param buffer Output buffer.
+ * @param size   Size of output buffer.
+ * @return Number of characters written (excluding NUL), or -1 on failure.
+ */
+int fossil_net_endpoint_format(
+    const fossil_net_endpoint_t *ep,
+    char *buffer,
+    uint32_t size);
+
+/**
+ * @brief Format only the IP part of an endpoint.
+ *
+ * @param ep     Pointer to endpoint structure.
+ * @param buffer Output buffer.
+ * @param size   Size of output buffer.
+ * @return Number of characters written (excluding NUL), or -1 on failure.
+ */
+int fossil_net_endpoint_format_ip(
+    const fossil_net_endpoint_t *ep,
+    char *buffer,
+    uint32_t size);
+
+/**
+ * @brief Materialize the string form of an endpoint into an address structure.
+ *
+ * @param ep   Pointer to endpoint structure.
+ * @param addr Pointer to address structure to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_endpoint_to_address(
+    const fossil_net_endpoint_t *ep,
+    fossil_net_address_t *addr);
+
+/**
+ * @brief Convert an address structure into a binary endpoint.
+ *
+ * Uses addr->addr when set, otherwise addr->ip, like fossil_net_socket_address_to_string.
+ *
+ * @param ep   Pointer to endpoint structure to fill.
+ * @param addr Pointer to address structure.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_endpoint_from_address(
+    fossil_net_endpoint_t *ep,
+    const fossil_net_address_t *addr);
+
+/**
+ * @brief Compare two endpoints (family, address and port).
+ *
+ * @param a First endpoint.
+ * @param b Second endpoint.
+ * @return true if equal, false otherwise.
+ */
+bool fossil_net_endpoint_equal(
+    const fossil_net_endpoint_t *a,
+    const fossil_net_endpoint_t *b);
+
+#ifdef __cplusplus
+}
+#include <string>
+
+namespace fossil::net
+{
+
+    class Inet
+    {
+    public:
+        /**
+         * @brief Parse an IPv4 address. Wraps fossil_net_inet_ipv4_parse.
+         */
+        static int ipv4_parse(const std::string &string, uint8_t out[4])
+        {
+            return fossil_net_inet_ipv4_parse(string.c_str(), out);
+        }
+
+        /**
+         * @brief Format an IPv4 address. Wraps fossil_net_inet_ipv4_format.
+         */
+        static std::string ipv4_format(const uint8_t ip[4])
+        {
+            char buf[FOSSIL_NET_INET_IPV4_STRLEN];
+            int n = fossil_net_inet_ipv4_format(ip, buf, sizeof(buf));
+            return n < 0 ? std::string() : std::string(buf, (size_t)n);
+        }
+
+        /**
+         * @brief Parse an IPv6 address. Wraps fossil_net_inet_ipv6_parse.
+         */
+        static int ipv6_parse(const std::string &string, uint8_t out[16])
+        {
+            return fossil_net_inet_ipv6_parse(string.c_str(), out);
+        }
+
+        /**
+         * @brief Format an IPv6 address. Wraps fossil_net_inet_ipv6_format.
+         */
+        static std::string ipv6_format(const uint8_t ip[16])
+        {
+            char buf[FOSSIL_NET_INET_IPV6_STRLEN];
+            int n = fossil_net_inet_ipv6_format(ip, buf, sizeof(buf));
+            return n < 0 ? std::string() : std::string(buf, (size_t)n);
+        }
+
+        /**
+         * @brief Parse a MAC address. Wraps fossil_net_inet_mac_parse.
+         */
+        static int mac_parse(const std::string &string, uint8_t out[6])
+        {
+            return fossil_net_inet_mac_parse(string.c_str(), out);
+        }
+
+        /**
+         * @brief Format a MAC address. Wraps fossil_net_inet_mac_format.
+         */
+        static std::string mac_format(const uint8_t bytes[6])
+        {
+            char buf[FOSSIL_NET_INET_MAC_STRLEN];
+            int n = fossil_net_inet_mac_format(bytes, buf, sizeof(buf));
+            return n < 0 ? std::string() : std::string(buf, (size_t)n);
+        }
+
+        /**
+         * @brief Format an endpoint. Wraps fossil_net_endpoint_format.
+         */
+        static std::string endpoint_format(const fossil_net_endpoint_t &ep)
+        {
+            char buf[FOSSIL_NET_INET_ENDPOINT_STRLEN];
+            int n = fossil_net_endpoint_format(&ep, buf, sizeof(buf));
+            return n < 0 ? std::string() : std::string(buf, (size_t)n);
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_INET_H */
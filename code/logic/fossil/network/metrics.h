@@ -0,0 +1,452 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_METRICS_H
+#define FOSSIL_NETWORK_METRICS_H
+
+#include "fossil/network/reactor.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Registry of counters, gauges and latency histograms.
+ *
+ * Metrics are registered by name and label set and rendered in the
+ * Prometheus text exposition format, either on demand or served over a
+ * separate listener with fossil_net_metrics_serve.
+ *
+ * Updates never lock. Counters and histograms are split into shards,
+ * each on its own cache lines, and a thread always updates the same
+ * shard with relaxed atomic adds; readers sum the shards. Histograms are
+ * log-linear: every power of two of nanoseconds is split into 8 buckets,
+ * so a recorded latency is off by at most 1/16 of its value, from 1 ns
+ * up to about 18 minutes.
+ *
+ * Collectors add samples computed at render time, such as the counters
+ * a reactor already keeps (see fossil_net_metrics_attach_reactor).
+ *
+ * Thread-safe.
+ */
+typedef struct fossil_net_metrics fossil_net_metrics_t;
+
+/**
+ * @brief One time series of a registry; valid until the registry is destroyed.
+ */
+typedef struct fossil_net_metric fossil_net_metric_t;
+
+/**
+ * @brief Output of a collector during rendering.
+ */
+typedef struct fossil_net_metrics_sink fossil_net_metrics_sink_t;
+
+/**
+ * @brief Metric types.
+ */
+typedef enum fossil_net_metric_type
+{
+    FOSSIL_NET_METRIC_COUNTER = 0,
+    FOSSIL_NET_METRIC_GAUGE,
+    FOSSIL_NET_METRIC_HISTOGRAM
+} fossil_net_metric_type_t;
+
+/**
+ * @brief Registry configuration; zero fields take the defaults.
+ */
+typedef struct fossil_net_metrics_config
+{
+    uint32_t shards;    /* per counter and histogram, rounded up to a power of two, default online CPUs (max 64) */
+} fossil_net_metrics_config_t;
+
+/**
+ * @brief Collector callback; adds samples with fossil_net_metrics_emit.
+ *
+ * Runs on the rendering thread with the registry locked, so it must not
+ * register metrics or collectors.
+ */
+typedef void (*fossil_net_metrics_collect_fn)(fossil_net_metrics_sink_t *sink, void *arg);
+
+/*=============================================================================
+REGISTRY
+=============================================================================*/
+
+/**
+ * @brief Create a registry.
+ *
+ * @param config Configuration, or NULL for the defaults.
+ * @return Registry, or NULL on failure.
+ */
+fossil_net_metrics_t *fossil_net_metrics_create(const fossil_net_metrics_config_t *config);
+
+/**
+ * @brief Stop serving and release the registry and its metrics.
+ *
+ * @param metrics Registry.
+ */
+void fossil_net_metrics_destroy(fossil_net_metrics_t *metrics);
+
+/**
+ * @brief Get or register a counter.
+ *
+ * @param metrics Registry.
+ * @param name    Metric name, e.g. "app_jobs_total".
+ * @param help    Help text, used when the name is first registered.
+ * @param labels  Label pairs as rendered, e.g. "queue=\"io\"", or NULL.
+ * @return Metric, or NULL on failure or if the name has another type.
+ */
+fossil_net_metric_t *fossil_net_metrics_counter(
+    fossil_net_metrics_t *metrics,
+    const char *name,
+    const char *help,
+    const char *labels);
+
+/**
+ * @brief Get or register a gauge; see fossil_net_metrics_counter.
+ */
+fossil_net_metric_t *fossil_net_metrics_gauge(
+    fossil_net_metrics_t *metrics,
+    const char *name,
+    const char *help,
+    const char *labels);
+
+/**
+ * @brief Get or register a latency histogram; see fossil_net_metrics_counter.
+ *
+ * Observations are in nanoseconds and rendered in seconds, with buckets
+ * at every power of two from 2^10 ns (about 1 us) to 2^36 ns (about 69 s).
+ * By convention the name ends in "_seconds".
+ */
+fossil_net_metric_t *fossil_net_metrics_histogram(
+    fossil_net_metrics_t *metrics,
+    const char *name,
+    const char *help,
+    const char *labels);
+
+/**
+ * @brief Append a label pair, escaping the value.
+ *
+ * @param buf   NUL-terminated label string to extend.
+ * @param cap   Size of buf.
+ * @param name  Label name.
+ * @param value Label value.
+ * @return 0 on success, -1 if it does not fit.
+ */
+int fossil_net_metrics_label(char *buf, size_t cap, const char *name, const char *value);
+
+/*=============================================================================
+RECORDING
+=============================================================================*/
+
+/**
+ * @brief Add to a counter.
+ *
+ * @param metric Counter.
+ * @param n      Amount.
+ */
+void fossil_net_metric_add(fossil_net_metric_t *metric, uint64_t n);
+
+/**
+ * @brief Set a gauge.
+ *
+ * @param metric Gauge.
+ * @param value  Value.
+ */
+void fossil_net_metric_set(fossil_net_metric_t *metric, int64_t value);
+
+/**
+ * @brief Add to a gauge.
+ *
+ * @param metric Gauge.
+ * @param delta  Amount, may be negative.
+ */
+void fossil_net_metric_gauge_add(fossil_net_metric_t *metric, int64_t delta);
+
+/**
+ * @brief Record a latency.
+ *
+ * @param metric Histogram.
+ * @param ns     Latency in nanoseconds.
+ */
+void fossil_net_metric_observe(fossil_net_metric_t *metric, uint64_t ns);
+
+/**
+ * @brief Current value: a counter's total, a gauge, or a histogram's count.
+ *
+ * @param metric Metric.
+ * @return Value.
+ */
+int64_t fossil_net_metric_value(const fossil_net_metric_t *metric);
+
+/**
+ * @brief Estimate a quantile of a histogram.
+ *
+ * @param metric Histogram.
+ * @param q      Quantile in [0, 1], e.g. 0.99.
+ * @return Latency in nanoseconds (the middle of its bucket), 0 if empty.
+ */
+uint64_t fossil_net_metric_quantile(const fossil_net_metric_t *metric, double q);
+
+/*=============================================================================
+COLLECTORS
+=============================================================================*/
+
+/**
+ * @brief Add a collector, run on every render.
+ *
+ * @param metrics Registry.
+ * @param labels  Label pairs added to every sample it emits, or NULL.
+ * @param fn      Collector.
+ * @param arg     Passed to fn.
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_net_metrics_add_collector(
+    fossil_net_metrics_t *metrics,
+    const char *labels,
+    fossil_net_metrics_collect_fn fn,
+    void *arg);
+
+/**
+ * @brief Remove a collector; waits for a render in progress.
+ *
+ * @param metrics Registry.
+ * @param fn      Collector.
+ * @param arg     Its argument.
+ * @return 0 on success, -1 if not found.
+ */
+int fossil_net_metrics_remove_collector(
+    fossil_net_metrics_t *metrics,
+    fossil_net_metrics_collect_fn fn,
+    void *arg);
+
+/**
+ * @brief Add a sample from a collector.
+ *
+ * Samples are grouped by name over all collectors, so several reactors
+ * can share names with different labels; HELP and TYPE come from the
+ * first sample of a name.
+ *
+ * @param sink   Sink passed to the collector.
+ * @param type   FOSSIL_NET_METRIC_COUNTER or FOSSIL_NET_METRIC_GAUGE.
+ * @param name   Metric name.
+ * @param help   Help text.
+ * @param labels Label pairs, or NULL.
+ * @param value  Value.
+ */
+void fossil_net_metrics_emit(
+    fossil_net_metrics_sink_t *sink,
+    fossil_net_metric_type_t type,
+    const char *name,
+    const char *help,
+    const char *labels,
+    double value);
+
+/**
+ * @brief Export a reactor's counters: accepts, active connections,
+ *        closes, bytes, shed and datagram counts.
+ *
+ * The counters are read from the reactor at render time, so recording
+ * costs nothing extra. Detach before destroying the reactor.
+ *
+ * @param metrics Registry.
+ * @param reactor Reactor.
+ * @param labels  Label pairs telling reactors apart, or NULL.
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_net_metrics_attach_reactor(
+    fossil_net_metrics_t *metrics,
+    fossil_net_reactor_t *reactor,
+    const char *labels);
+
+/**
+ * @brief Stop exporting a reactor's counters.
+ *
+ * @param metrics Registry.
+ * @param reactor Reactor.
+ * @return 0 on success, -1 if not attached.
+ */
+int fossil_net_metrics_detach_reactor(
+    fossil_net_metrics_t *metrics,
+    fossil_net_reactor_t *reactor);
+
+/*=============================================================================
+EXPOSITION
+=============================================================================*/
+
+/**
+ * @brief Render every metric in the Prometheus text format.
+ *
+ * @param metrics Registry.
+ * @param text    Receives the NUL-terminated text; release with free().
+ * @param len     Receives its length (may be NULL).
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_net_metrics_render(fossil_net_metrics_t *metrics, char **text, uint32_t *len);
+
+/**
+ * @brief Serve GET /metrics on a server of its own.
+ *
+ * Runs a single-loop HTTP server, so scrapes never compete with the
+ * application's loops. It stops when the registry is destroyed.
+ *
+ * @param metrics Registry.
+ * @param server  TCP server that outlives the registry.
+ * @return 0 on success, -1 on failure or if already serving.
+ */
+int fossil_net_metrics_serve(fossil_net_metrics_t *metrics, fossil_net_server_t *server);
+
+#ifdef __cplusplus
+}
+#include <cstdlib>
+#include <string>
+
+namespace fossil::net
+{
+
+    class Metrics
+    {
+    private:
+        fossil_net_metrics_t *handle_;
+
+    public:
+        /**
+         * @brief Create a registry. Wraps fossil_net_metrics_create.
+         */
+        explicit Metrics(const fossil_net_metrics_config_t *config = nullptr)
+            : handle_(fossil_net_metrics_create(config))
+        {
+        }
+
+        ~Metrics()
+        {
+            if (handle_)
+                fossil_net_metrics_destroy(handle_);
+        }
+
+        /**
+         * @brief Get or register a counter. Wraps fossil_net_metrics_counter.
+         */
+        fossil_net_metric_t *counter(const std::string &name, const std::string &help,
+                                     const std::string &labels = std::string())
+        {
+            return fossil_net_metrics_counter(handle_, name.c_str(), help.c_str(), labels.c_str());
+        }
+
+        /**
+         * @brief Get or register a gauge. Wraps fossil_net_metrics_gauge.
+         */
+        fossil_net_metric_t *gauge(const std::string &name, const std::string &help,
+                                   const std::string &labels = std::string())
+        {
+            return fossil_net_metrics_gauge(handle_, name.c_str(), help.c_str(), labels.c_str());
+        }
+
+        /**
+         * @brief Get or register a histogram. Wraps fossil_net_metrics_histogram.
+         */
+        fossil_net_metric_t *histogram(const std::string &name, const std::string &help,
+                                       const std::string &labels = std::string())
+        {
+            return fossil_net_metrics_histogram(handle_, name.c_str(), help.c_str(), labels.c_str());
+        }
+
+        /**
+         * @brief Export a reactor's counters. Wraps fossil_net_metrics_attach_reactor.
+         */
+        int attach(fossil_net_reactor_t *reactor, const std::string &labels = std::string())
+        {
+            return fossil_net_metrics_attach_reactor(handle_, reactor, labels.c_str());
+        }
+
+        /**
+         * @brief Stop exporting a reactor's counters. Wraps fossil_net_metrics_detach_reactor.
+         */
+        int detach(fossil_net_reactor_t *reactor)
+        {
+            return fossil_net_metrics_detach_reactor(handle_, reactor);
+        }
+
+        /**
+         * @brief Render in the Prometheus text format. Wraps fossil_net_metrics_render.
+         */
+        std::string render() const
+        {
+            char *text = nullptr;
+            uint32_t len = 0;
+            if (fossil_net_metrics_render(handle_, &text, &len) != 0)
+                return std::string();
+            std::string out(text, len);
+            std::free(text);
+            return out;
+        }
+
+        /**
+         * @brief Serve GET /metrics. Wraps fossil_net_metrics_serve.
+         */
+        int serve(fossil_net_server_t *server)
+        {
+            return fossil_net_metrics_serve(handle_, server);
+        }
+
+        /**
+         * @brief Get the underlying registry.
+         */
+        fossil_net_metrics_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Metrics(const Metrics &) = delete;
+        Metrics &operator=(const Metrics &) = delete;
+
+        // Allow move
+        Metrics(Metrics &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Metrics &operator=(Metrics &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_metrics_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_METRICS_H */
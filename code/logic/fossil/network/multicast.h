@@ -0,0 +1,316 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_MULTICAST_H
+#define FOSSIL_NETWORK_MULTICAST_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Largest batch accepted by fossil_net_multicast_receive in one call.
+ */
+#define FOSSIL_NET_MULTICAST_BATCH_MAX 64
+
+/**
+ * @brief Set in fossil_net_multicast_msg_t.flags when the datagram did not fit.
+ */
+#define FOSSIL_NET_MULTICAST_MSG_TRUNCATED 0x1u
+
+/**
+ * @brief One received datagram and its addressing metadata.
+ *
+ * The caller fills buffer and size; the receive call fills the rest.
+ * group and ifindex are only known when packet info was enabled with
+ * fossil_net_multicast_enable_pktinfo; otherwise they are zero.
+ */
+typedef struct fossil_net_multicast_msg
+{
+    void *buffer;                 /* caller-owned payload buffer */
+    uint32_t size;                /* capacity of buffer in bytes */
+    uint32_t length;              /* bytes received */
+    fossil_net_endpoint_t source; /* sender address and port */
+    fossil_net_endpoint_t group;  /* destination address (the group), port 0 */
+    uint32_t ifindex;             /* receiving interface index, 0 if unknown */
+    uint32_t flags;               /* FOSSIL_NET_MULTICAST_MSG_* */
+} fossil_net_multicast_msg_t;
+
+/*=============================================================================
+GROUP MEMBERSHIP
+=============================================================================*/
+
+/*
+ * Interfaces are named by string throughout this module: an interface name
+ * ("eth0"), a numeric index ("3"), or for IPv4 the address of a local
+ * interface ("192.168.1.10"). NULL or "" lets the kernel choose by route.
+ */
+
+/**
+ * @brief Join a multicast group on a "udp" socket.
+ *
+ * Several groups may be joined on one socket; bind it to the wildcard
+ * address and the group port first.
+ *
+ * @param sock  Pointer to socket structure.
+ * @param group IPv4 or IPv6 multicast group address.
+ * @param iface Interface to join on, or NULL for the default.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_join(
+    fossil_net_socket_t *sock,
+    const char *group,
+    const char *iface);
+
+/**
+ * @brief Leave a multicast group previously joined with fossil_net_multicast_join.
+ *
+ * @param sock  Pointer to socket structure.
+ * @param group Group address.
+ * @param iface Interface used when joining.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_leave(
+    fossil_net_socket_t *sock,
+    const char *group,
+    const char *iface);
+
+/**
+ * @brief Join a source-specific multicast (SSM) channel.
+ *
+ * Only datagrams from source sent to group are delivered. Several sources
+ * may be joined for the same group.
+ *
+ * @param sock   Pointer to socket structure.
+ * @param group  Group address.
+ * @param source Source address (same family as group).
+ * @param iface  Interface to join on, or NULL for the default.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_join_source(
+    fossil_net_socket_t *sock,
+    const char *group,
+    const char *source,
+    const char *iface);
+
+/**
+ * @brief Leave a source-specific multicast channel.
+ *
+ * @param sock   Pointer to socket structure.
+ * @param group  Group address.
+ * @param source Source address.
+ * @param iface  Interface used when joining.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_leave_source(
+    fossil_net_socket_t *sock,
+    const char *group,
+    const char *source,
+    const char *iface);
+
+/*=============================================================================
+SEND OPTIONS
+=============================================================================*/
+
+/**
+ * @brief Set the TTL (IPv4) or hop limit (IPv6) of outgoing multicast datagrams.
+ *
+ * @param sock Pointer to socket structure.
+ * @param ttl  Time to live; 1 keeps traffic on the local network.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_set_ttl(
+    fossil_net_socket_t *sock,
+    uint8_t ttl);
+
+/**
+ * @brief Enable or disable local loopback of outgoing multicast datagrams.
+ *
+ * @param sock    Pointer to socket structure.
+ * @param enabled True to deliver own datagrams to local members.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_set_loopback(
+    fossil_net_socket_t *sock,
+    bool enabled);
+
+/**
+ * @brief Select the interface outgoing multicast datagrams leave from.
+ *
+ * IPv4 interface names need Linux or Windows; elsewhere pass the interface
+ * address instead.
+ *
+ * @param sock  Pointer to socket structure.
+ * @param iface Interface, or NULL to restore the default.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_set_interface(
+    fossil_net_socket_t *sock,
+    const char *iface);
+
+/*=============================================================================
+RECEIVE
+=============================================================================*/
+
+/**
+ * @brief Request per-datagram destination address and interface metadata.
+ *
+ * Enables IP_PKTINFO / IPV6_RECVPKTINFO so fossil_net_multicast_receive can
+ * report which group each datagram was sent to when several groups share
+ * one socket.
+ *
+ * @param sock    Pointer to socket structure.
+ * @param enabled True to enable.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_multicast_enable_pktinfo(
+    fossil_net_socket_t *sock,
+    bool enabled);
+
+/**
+ * @brief Receive a batch of datagrams with their addressing metadata.
+ *
+ * Waits (on a blocking socket) for the first datagram, then takes whatever
+ * else is already queued, up to count, in the same call. On Linux this is a
+ * single recvmmsg system call. Windows reports no group or interface.
+ *
+ * @param sock     Pointer to socket structure.
+ * @param msgs     Array of messages with buffer and size filled in.
+ * @param count    Number of entries in msgs (at most FOSSIL_NET_MULTICAST_BATCH_MAX are used).
+ * @param received Pointer to variable to receive the number of datagrams filled.
+ * @return 0 on success, non-zero on failure (including nothing queued on a
+ *         non-blocking socket).
+ */
+int fossil_net_multicast_receive(
+    fossil_net_socket_t *sock,
+    fossil_net_multicast_msg_t *msgs,
+    uint32_t count,
+    uint32_t *received);
+
+/**
+ * @brief Resolve an interface string to an interface index.
+ *
+ * @param iface Interface name or numeric index.
+ * @return Interface index, or 0 if unknown.
+ */
+uint32_t fossil_net_multicast_if_index(const char *iface);
+
+#ifdef __cplusplus
+}
+
+#include <string>
+
+namespace fossil::net
+{
+
+    class Multicast
+    {
+    public:
+        /**
+         * @brief Join a group. Wraps fossil_net_multicast_join.
+         */
+        static int join(fossil_net_socket_t *sock, const std::string &group, const std::string &iface = std::string())
+        {
+            return fossil_net_multicast_join(sock, group.c_str(), iface.c_str());
+        }
+
+        /**
+         * @brief Leave a group. Wraps fossil_net_multicast_leave.
+         */
+        static int leave(fossil_net_socket_t *sock, const std::string &group, const std::string &iface = std::string())
+        {
+            return fossil_net_multicast_leave(sock, group.c_str(), iface.c_str());
+        }
+
+        /**
+         * @brief Join a source-specific channel. Wraps fossil_net_multicast_join_source.
+         */
+        static int join_source(fossil_net_socket_t *sock, const std::string &group, const std::string &source,
+                               const std::string &iface = std::string())
+        {
+            return fossil_net_multicast_join_source(sock, group.c_str(), source.c_str(), iface.c_str());
+        }
+
+        /**
+         * @brief Leave a source-specific channel. Wraps fossil_net_multicast_leave_source.
+         */
+        static int leave_source(fossil_net_socket_t *sock, const std::string &group, const std::string &source,
+                                const std::string &iface = std::string())
+        {
+            return fossil_net_multicast_leave_source(sock, group.c_str(), source.c_str(), iface.c_str());
+        }
+
+        /**
+         * @brief Set the multicast TTL. Wraps fossil_net_multicast_set_ttl.
+         */
+        static int set_ttl(fossil_net_socket_t *sock, uint8_t ttl)
+        {
+            return fossil_net_multicast_set_ttl(sock, ttl);
+        }
+
+        /**
+         * @brief Enable or disable loopback. Wraps fossil_net_multicast_set_loopback.
+         */
+        static int set_loopback(fossil_net_socket_t *sock, bool enabled)
+        {
+            return fossil_net_multicast_set_loopback(sock, enabled);
+        }
+
+        /**
+         * @brief Select the outgoing interface. Wraps fossil_net_multicast_set_interface.
+         */
+        static int set_interface(fossil_net_socket_t *sock, const std::string &iface)
+        {
+            return fossil_net_multicast_set_interface(sock, iface.c_str());
+        }
+
+        /**
+         * @brief Enable packet info. Wraps fossil_net_multicast_enable_pktinfo.
+         */
+        static int enable_pktinfo(fossil_net_socket_t *sock, bool enabled = true)
+        {
+            return fossil_net_multicast_enable_pktinfo(sock, enabled);
+        }
+
+        /**
+         * @brief Receive a batch. Wraps fossil_net_multicast_receive.
+         */
+        static int receive(fossil_net_socket_t *sock, fossil_net_multicast_msg_t *msgs, uint32_t count, uint32_t *received)
+        {
+            return fossil_net_multicast_receive(sock, msgs, count, received);
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_MULTICAST_H */
@@ -0,0 +1,280 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_PACKET_H
+#define FOSSIL_NETWORK_PACKET_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Where decoding starts in a frame.
+ */
+typedef enum fossil_net_packet_link
+{
+    FOSSIL_NET_PACKET_LINK_ETHERNET = 0, /* "raw"/"packet" sockets, capture rings */
+    FOSSIL_NET_PACKET_LINK_IP            /* "raw" IPv4/IPv6 sockets: starts at the IP header */
+} fossil_net_packet_link_t;
+
+/* Layers found, kept in fossil_net_packet_t::layers */
+#define FOSSIL_NET_PACKET_HAS_ETH       0x0001u
+#define FOSSIL_NET_PACKET_HAS_VLAN      0x0002u
+#define FOSSIL_NET_PACKET_HAS_IPV4      0x0004u
+#define FOSSIL_NET_PACKET_HAS_IPV6      0x0008u
+#define FOSSIL_NET_PACKET_HAS_TCP       0x0010u
+#define FOSSIL_NET_PACKET_HAS_UDP       0x0020u
+#define FOSSIL_NET_PACKET_HAS_ICMP      0x0040u
+#define FOSSIL_NET_PACKET_HAS_ICMPV6    0x0080u
+#define FOSSIL_NET_PACKET_FRAGMENT      0x0100u /* IP fragment; L4 only present in the first */
+#define FOSSIL_NET_PACKET_TRUNCATED     0x0200u /* a header ran past the captured length */
+
+/**
+ * @brief Decoded view of one frame.
+ *
+ * Nothing is copied: offsets index into data, which must stay valid while
+ * the view is used. Multi-byte fields are converted to host order. An
+ * offset is only meaningful when the matching layer bit is set.
+ */
+typedef struct fossil_net_packet
+{
+    const uint8_t *data;     /* start of frame */
+    uint32_t length;         /* captured length */
+    uint32_t layers;         /* FOSSIL_NET_PACKET_* bits */
+    uint16_t l3_offset;      /* IP header */
+    uint16_t l4_offset;      /* TCP/UDP/ICMP header */
+    uint16_t payload_offset; /* first byte after the transport header */
+    uint16_t payload_length; /* payload bytes within the IP packet and the capture */
+    uint16_t ethertype;      /* innermost EtherType */
+    uint16_t vlan_tci;       /* outer VLAN tag when HAS_VLAN */
+    uint8_t ip_proto;        /* transport protocol number */
+    uint8_t ttl;             /* TTL or hop limit */
+    uint8_t tcp_flags;       /* FIN=0x01 SYN=0x02 RST=0x04 PSH=0x08 ACK=0x10 ... */
+    uint8_t icmp_type;
+    uint8_t icmp_code;
+    uint16_t src_port;
+    uint16_t dst_port;
+} fossil_net_packet_t;
+
+/** Capacity of one decode batch. */
+#define FOSSIL_NET_PACKET_BATCH_MAX 64
+
+/**
+ * @brief Column-oriented batch of frames for bulk decoding.
+ *
+ * The caller fills data, length and count; fossil_net_packet_decode_batch
+ * fills the remaining columns. Each decoding stage runs as a tight loop
+ * over one column at a time, which keeps the common path branch-light
+ * and friendly to auto-vectorisation. Frames outside the common shapes
+ * (stacked VLANs, IPv6 extension headers, fragments, truncation) are
+ * decoded with fossil_net_packet_decode and give identical results.
+ */
+typedef struct fossil_net_packet_batch
+{
+    uint32_t count;
+    const uint8_t *data[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint32_t length[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint32_t layers[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t ethertype[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t l3_offset[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t l4_offset[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t payload_offset[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t payload_length[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint8_t ip_proto[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t src_port[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t dst_port[FOSSIL_NET_PACKET_BATCH_MAX];
+} fossil_net_packet_batch_t;
+
+/*=============================================================================
+DECODING
+=============================================================================*/
+
+/**
+ * @brief Decode the headers of one frame.
+ *
+ * Decoding stops at the first layer that is unknown, malformed or
+ * truncated; the layers found up to that point remain valid.
+ *
+ * @param data   Frame bytes.
+ * @param length Captured length (frames longer than 65535 bytes are cut).
+ * @param link   Where the frame starts.
+ * @param pkt    Pointer to view to fill.
+ * @return 0 on success, non-zero on invalid arguments.
+ */
+int fossil_net_packet_decode(
+    const void *data,
+    uint32_t length,
+    fossil_net_packet_link_t link,
+    fossil_net_packet_t *pkt);
+
+/**
+ * @brief Decode every frame of a batch.
+ *
+ * @param batch Pointer to batch with data, length and count filled in.
+ * @param link  Where the frames start.
+ * @return 0 on success, non-zero on invalid arguments.
+ */
+int fossil_net_packet_decode_batch(
+    fossil_net_packet_batch_t *batch,
+    fossil_net_packet_link_t link);
+
+/*=============================================================================
+VIEWS
+=============================================================================*/
+
+/**
+ * @brief Get the IP header of a decoded frame.
+ *
+ * @param pkt Pointer to decoded view.
+ * @return Pointer into the frame, or NULL if there is no IP layer.
+ */
+const uint8_t *fossil_net_packet_l3(const fossil_net_packet_t *pkt);
+
+/**
+ * @brief Get the transport header of a decoded frame.
+ *
+ * @param pkt Pointer to decoded view.
+ * @return Pointer into the frame, or NULL if there is no transport layer.
+ */
+const uint8_t *fossil_net_packet_l4(const fossil_net_packet_t *pkt);
+
+/**
+ * @brief Get the payload of a decoded frame.
+ *
+ * @param pkt    Pointer to decoded view.
+ * @param length Pointer to variable to receive the payload length.
+ * @return Pointer into the frame, or NULL if there is no transport layer.
+ */
+const uint8_t *fossil_net_packet_payload(
+    const fossil_net_packet_t *pkt,
+    uint32_t *length);
+
+/**
+ * @brief Get the Ethernet addresses of a decoded frame.
+ *
+ * @param pkt Pointer to decoded view.
+ * @param src Pointer to MAC structure for the source (may be NULL).
+ * @param dst Pointer to MAC structure for the destination (may be NULL).
+ * @return 0 on success, non-zero if the frame has no Ethernet header.
+ */
+int fossil_net_packet_eth_addrs(
+    const fossil_net_packet_t *pkt,
+    fossil_net_mac_t *src,
+    fossil_net_mac_t *dst);
+
+/**
+ * @brief Get the IP addresses and ports of a decoded frame as endpoints.
+ *
+ * @param pkt Pointer to decoded view.
+ * @param src Pointer to endpoint for the source (may be NULL).
+ * @param dst Pointer to endpoint for the destination (may be NULL).
+ * @return 0 on success, non-zero if the frame has no IP layer.
+ */
+int fossil_net_packet_endpoints(
+    const fossil_net_packet_t *pkt,
+    fossil_net_endpoint_t *src,
+    fossil_net_endpoint_t *dst);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Packet
+    {
+    private:
+        fossil_net_packet_t pkt_;
+
+    public:
+        /**
+         * @brief Decode a frame. Wraps fossil_net_packet_decode.
+         */
+        Packet(const void *data, uint32_t length, fossil_net_packet_link_t link = FOSSIL_NET_PACKET_LINK_ETHERNET)
+        {
+            if (fossil_net_packet_decode(data, length, link, &pkt_) != 0)
+                pkt_ = fossil_net_packet_t{};
+        }
+
+        /**
+         * @brief Check for a layer bit.
+         */
+        bool has(uint32_t layer) const
+        {
+            return (pkt_.layers & layer) != 0;
+        }
+
+        /**
+         * @brief Source port (TCP/UDP), 0 if none.
+         */
+        uint16_t src_port() const
+        {
+            return pkt_.src_port;
+        }
+
+        /**
+         * @brief Destination port (TCP/UDP), 0 if none.
+         */
+        uint16_t dst_port() const
+        {
+            return pkt_.dst_port;
+        }
+
+        /**
+         * @brief Get the payload. Wraps fossil_net_packet_payload.
+         */
+        const uint8_t *payload(uint32_t *length) const
+        {
+            return fossil_net_packet_payload(&pkt_, length);
+        }
+
+        /**
+         * @brief Get the endpoints. Wraps fossil_net_packet_endpoints.
+         */
+        int endpoints(fossil_net_endpoint_t *src, fossil_net_endpoint_t *dst) const
+        {
+            return fossil_net_packet_endpoints(&pkt_, src, dst);
+        }
+
+        /**
+         * @brief Get the decoded C view.
+         */
+        const fossil_net_packet_t *native_handle() const
+        {
+            return &pkt_;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_PACKET_H */
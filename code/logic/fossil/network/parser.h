@@ -0,0 +1,308 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_PARSER_H
+#define FOSSIL_NETWORK_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+#define FOSSIL_NET_PARSER_MAX_HEADERS 64
+#define FOSSIL_NET_PARSER_MAX_HEAD    (16u * 1024u) /* default request line + headers limit */
+
+/*
+ * Byte range inside the caller's buffer. Not NUL-terminated: the parser
+ * never copies or writes to the data it parses.
+ */
+typedef struct fossil_net_slice
+{
+    const char *ptr;
+    uint32_t len;
+} fossil_net_slice_t;
+
+typedef enum fossil_net_http_method
+{
+    FOSSIL_NET_HTTP_GET = 0,
+    FOSSIL_NET_HTTP_HEAD,
+    FOSSIL_NET_HTTP_POST,
+    FOSSIL_NET_HTTP_PUT,
+    FOSSIL_NET_HTTP_DELETE,
+    FOSSIL_NET_HTTP_PATCH,
+    FOSSIL_NET_HTTP_OPTIONS,
+    FOSSIL_NET_HTTP_CONNECT,
+    FOSSIL_NET_HTTP_TRACE,
+    FOSSIL_NET_HTTP_OTHER,   /* valid token, see method_name */
+    FOSSIL_NET_HTTP_METHODS
+} fossil_net_http_method_t;
+
+typedef struct fossil_net_http_header
+{
+    fossil_net_slice_t name;
+    fossil_net_slice_t value;   /* surrounding whitespace trimmed */
+} fossil_net_http_header_t;
+
+/*
+ * Parsed request head. Every slice points into the buffer passed to
+ * fossil_net_parser_parse and is valid while that buffer is.
+ */
+typedef struct fossil_net_http_request
+{
+    fossil_net_http_method_t method;
+    fossil_net_slice_t method_name;
+    fossil_net_slice_t target;      /* request-target as sent */
+    fossil_net_slice_t path;        /* target up to '?' */
+    fossil_net_slice_t query;       /* after '?', empty if none */
+    uint8_t version_minor;          /* HTTP/1.x */
+    bool keep_alive;                /* from version and Connection */
+    bool chunked;                   /* Transfer-Encoding ends in chunked */
+    bool expect_continue;           /* Expect: 100-continue */
+    bool upgrade;                   /* Connection: upgrade */
+    uint64_t content_length;        /* 0 when absent or chunked */
+    uint32_t head_len;              /* bytes up to and including the blank line */
+    fossil_net_http_header_t headers[FOSSIL_NET_PARSER_MAX_HEADERS];
+    uint32_t header_count;
+} fossil_net_http_request_t;
+
+/**
+ * @brief Incremental request parser, one per connection; no allocation.
+ *
+ * Feed the whole buffered input on every call. The parser remembers how
+ * far it has already searched for the end of the head, so a head that
+ * arrives in many small reads is scanned once in total; the request line
+ * and headers are then tokenised in a single pass.
+ */
+typedef struct fossil_net_parser
+{
+    uint32_t max_head;
+    uint32_t start;         /* first byte after leading blank lines */
+    uint32_t scanned;       /* bytes searched for the end of the head */
+    int status;             /* HTTP status for the last error, 0 if none */
+    /* chunked body decoder */
+    uint8_t chunk_state;
+    uint8_t chunk_digits;
+    uint64_t chunk_left;
+} fossil_net_parser_t;
+
+/*=============================================================================
+PARSING
+=============================================================================*/
+
+/**
+ * @brief Initialise a parser.
+ *
+ * @param parser   Parser.
+ * @param max_head Limit on request line plus headers, 0 for the default.
+ */
+void fossil_net_parser_init(fossil_net_parser_t *parser, uint32_t max_head);
+
+/**
+ * @brief Prepare for the next request on the same connection.
+ *
+ * @param parser Parser.
+ */
+void fossil_net_parser_reset(fossil_net_parser_t *parser);
+
+/**
+ * @brief Parse a request head.
+ *
+ * Rejects what request smuggling relies on: Content-Length together
+ * with Transfer-Encoding, conflicting Content-Length values, whitespace
+ * before a header colon and obsolete line folding. HTTP/1.1 requests
+ * without Host are rejected too.
+ *
+ * @param parser Parser.
+ * @param buf    Bytes received so far for this request.
+ * @param len    Number of bytes.
+ * @param req    Filled in when the head is complete.
+ * @return Head length (> 0) when complete, 0 if more data is needed, -1 on
+ *         a malformed request; parser->status then holds 400, 414, 431,
+ *         501 or 505.
+ */
+int fossil_net_parser_parse(
+    fossil_net_parser_t *parser,
+    const char *buf,
+    uint32_t len,
+    fossil_net_http_request_t *req);
+
+/**
+ * @brief Decode a chunked body in place.
+ *
+ * Call repeatedly with the body bytes received so far, starting right
+ * after the head. Decoded data is compacted to the front of buf and
+ * *len is set to its size; undecoded input is dropped, so pass only new
+ * bytes on the next call. Trailers are skipped.
+ *
+ * @param parser Parser.
+ * @param buf    Body bytes; rewritten in place.
+ * @param len    In: bytes in buf. Out: decoded bytes at the front of buf.
+ * @return Number of bytes after the end of the body (they follow the
+ *         decoded data, at buf + *len) once complete, -2 if more input is
+ *         needed, -1 on malformed framing.
+ */
+int fossil_net_parser_decode_chunked(
+    fossil_net_parser_t *parser,
+    char *buf,
+    uint32_t *len);
+
+/*=============================================================================
+ACCESSORS
+=============================================================================*/
+
+/**
+ * @brief Look up a header by name, case-insensitively.
+ *
+ * @param req   Parsed request.
+ * @param name  Header name.
+ * @param value Receives the first matching value (may be NULL).
+ * @return true if present.
+ */
+bool fossil_net_http_request_header(
+    const fossil_net_http_request_t *req,
+    const char *name,
+    fossil_net_slice_t *value);
+
+/**
+ * @brief Wire name of a method ("GET"); "" for FOSSIL_NET_HTTP_OTHER.
+ *
+ * @param method Method.
+ * @return Static string.
+ */
+const char *fossil_net_http_method_name(fossil_net_http_method_t method);
+
+/**
+ * @brief Method from its wire name (case-sensitive, as on the wire).
+ *
+ * @param name Method token.
+ * @param len  Token length.
+ * @return Method, FOSSIL_NET_HTTP_OTHER if unknown.
+ */
+fossil_net_http_method_t fossil_net_http_method_parse(const char *name, uint32_t len);
+
+/**
+ * @brief Compare a slice to a NUL-terminated string.
+ *
+ * @param slice Slice.
+ * @param str   String.
+ * @return true if equal.
+ */
+bool fossil_net_slice_eq(fossil_net_slice_t slice, const char *str);
+
+/**
+ * @brief Whether an If-None-Match value matches an entity tag.
+ *
+ * Uses the weak comparison RFC 9110 asks for: "W/" prefixes are ignored
+ * and "*" matches anything.
+ *
+ * @param list Header value, a comma-separated list of entity tags.
+ * @param etag Current entity tag, quotes included.
+ * @return true on a match.
+ */
+bool fossil_net_http_etag_match(fossil_net_slice_t list, const char *etag);
+
+#ifdef __cplusplus
+}
+#include <string>
+
+namespace fossil::net
+{
+
+    class Parser
+    {
+    public:
+        /**
+         * @brief Construct a parser. Wraps fossil_net_parser_init.
+         */
+        explicit Parser(uint32_t max_head = 0)
+        {
+            fossil_net_parser_init(&parser_, max_head);
+        }
+
+        /**
+         * @brief Parse a request head. Wraps fossil_net_parser_parse.
+         */
+        int parse(const char *buf, uint32_t len, fossil_net_http_request_t *req)
+        {
+            return fossil_net_parser_parse(&parser_, buf, len, req);
+        }
+
+        /**
+         * @brief Decode chunked data in place.
+         *
+         * Wraps fossil_net_parser_decode_chunked.
+         */
+        int decode_chunked(char *buf, uint32_t *len)
+        {
+            return fossil_net_parser_decode_chunked(&parser_, buf, len);
+        }
+
+        /**
+         * @brief Prepare for the next request. Wraps fossil_net_parser_reset.
+         */
+        void reset()
+        {
+            fossil_net_parser_reset(&parser_);
+        }
+
+        /**
+         * @brief HTTP status describing the last error.
+         */
+        int status() const
+        {
+            return parser_.status;
+        }
+
+        /**
+         * @brief Copy a slice into a string.
+         */
+        static std::string str(fossil_net_slice_t slice)
+        {
+            return std::string(slice.ptr ? slice.ptr : "", slice.len);
+        }
+
+        /**
+         * @brief Get a pointer to the underlying parser state.
+         */
+        fossil_net_parser_t *native_handle()
+        {
+            return &parser_;
+        }
+
+    private:
+        fossil_net_parser_t parser_;
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_PARSER_H */
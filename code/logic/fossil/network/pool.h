@@ -0,0 +1,263 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_POOL_H
+#define FOSSIL_NETWORK_POOL_H
+
+#include "reactor.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+#define FOSSIL_NET_POOL_MAX_THREADS 256
+
+/**
+ * @brief Work-stealing task pool for CPU-heavy handler work.
+ *
+ * Every worker owns a Chase-Lev deque: it pushes and pops at the bottom
+ * without contention while idle workers steal from the top. Tasks submitted
+ * from outside the pool land in a per-worker lock-free inbox. Workers park
+ * on a condition variable only after a round of failed steals.
+ */
+typedef struct fossil_net_pool fossil_net_pool_t;
+
+/**
+ * @brief Task run on a pool worker.
+ */
+typedef void (*fossil_net_pool_fn)(void *arg);
+
+/**
+ * @brief Pool settings; zero fields take the defaults.
+ */
+typedef struct fossil_net_pool_config
+{
+    uint32_t threads;    /* workers, default: online CPUs */
+    uint32_t deque_size; /* initial deque slots (power of two), default 1024; deques grow */
+    uint32_t spin;       /* steal rounds before parking, default 64 */
+} fossil_net_pool_config_t;
+
+/**
+ * @brief Pool counters.
+ */
+typedef struct fossil_net_pool_stats
+{
+    uint64_t submitted;
+    uint64_t executed;
+    uint64_t stolen;     /* tasks taken from another worker's deque */
+    uint64_t replies;    /* completions posted back to an event loop */
+    uint64_t parks;      /* times a worker went to sleep */
+} fossil_net_pool_stats_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create a pool and start its workers.
+ *
+ * @param config Settings, or NULL for defaults.
+ * @return Pool, or NULL on failure.
+ */
+fossil_net_pool_t *fossil_net_pool_create(const fossil_net_pool_config_t *config);
+
+/**
+ * @brief Run every queued task, then stop the workers and free the pool.
+ *
+ * Must not be called from a worker of the same pool.
+ *
+ * @param pool Pool to destroy.
+ */
+void fossil_net_pool_destroy(fossil_net_pool_t *pool);
+
+/*=============================================================================
+SUBMISSION
+=============================================================================*/
+
+/**
+ * @brief Queue a task. Safe from any thread.
+ *
+ * From a worker of this pool the task goes to that worker's own deque, so
+ * nested work stays local until someone steals it.
+ *
+ * @param pool Pool.
+ * @param fn   Task function.
+ * @param arg  Task argument.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_pool_submit(
+    fossil_net_pool_t *pool,
+    fossil_net_pool_fn fn,
+    void *arg);
+
+/**
+ * @brief Run work on the pool, then done on the submitting event loop.
+ *
+ * Meant for reactor callbacks: the handler offloads work and its completion
+ * comes back through the loop's lock-free task queue, so it may touch the
+ * loop's connections without locks. Outside a loop thread, or if the loop is
+ * stopping by then, done runs on the worker with a NULL loop so it can
+ * release arg.
+ *
+ * @param pool Pool.
+ * @param work Function run on a worker.
+ * @param done Function run on the originating loop afterwards.
+ * @param arg  Argument for both.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_pool_submit_reply(
+    fossil_net_pool_t *pool,
+    fossil_net_pool_fn work,
+    fossil_net_loop_task_fn done,
+    void *arg);
+
+/**
+ * @brief Index of the pool worker running the calling thread.
+ *
+ * @param pool Pool.
+ * @return Worker index, or -1 outside the pool's workers.
+ */
+int fossil_net_pool_worker_index(const fossil_net_pool_t *pool);
+
+/**
+ * @brief Number of workers.
+ *
+ * @param pool Pool.
+ * @return Worker count.
+ */
+uint32_t fossil_net_pool_thread_count(const fossil_net_pool_t *pool);
+
+/**
+ * @brief Read counters.
+ *
+ * @param pool  Pool.
+ * @param stats Output counters.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_pool_get_stats(
+    fossil_net_pool_t *pool,
+    fossil_net_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Pool
+    {
+    private:
+        fossil_net_pool_t *handle_;
+
+    public:
+        /**
+         * @brief Start a pool. Wraps fossil_net_pool_create.
+         */
+        explicit Pool(const fossil_net_pool_config_t *config = nullptr)
+            : handle_(fossil_net_pool_create(config))
+        {
+        }
+
+        ~Pool()
+        {
+            if (handle_)
+                fossil_net_pool_destroy(handle_);
+        }
+
+        /**
+         * @brief Queue a task. Wraps fossil_net_pool_submit.
+         */
+        int submit(fossil_net_pool_fn fn, void *arg)
+        {
+            return fossil_net_pool_submit(handle_, fn, arg);
+        }
+
+        /**
+         * @brief Queue work with a completion on the current loop.
+         *
+         * Wraps fossil_net_pool_submit_reply.
+         */
+        int submit_reply(fossil_net_pool_fn work, fossil_net_loop_task_fn done, void *arg)
+        {
+            return fossil_net_pool_submit_reply(handle_, work, done, arg);
+        }
+
+        /**
+         * @brief Number of workers. Wraps fossil_net_pool_thread_count.
+         */
+        uint32_t thread_count() const
+        {
+            return fossil_net_pool_thread_count(handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_pool_get_stats.
+         */
+        fossil_net_pool_stats_t stats()
+        {
+            fossil_net_pool_stats_t s{};
+            fossil_net_pool_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_pool_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Pool(const Pool &) = delete;
+        Pool &operator=(const Pool &) = delete;
+
+        // Allow move
+        Pool(Pool &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Pool &operator=(Pool &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_pool_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_POOL_H */
@@ -0,0 +1,319 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_PROBE_H
+#define FOSSIL_NETWORK_PROBE_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+#define FOSSIL_NET_PROBE_HIST_BUCKETS 24 /* bucket i: RTT in [2^i, 2^(i+1)) us */
+
+/**
+ * @brief Prober settings; zero fields take the defaults.
+ */
+typedef struct fossil_net_probe_config
+{
+    uint32_t max_targets;  /* default 1024 */
+    uint32_t timeout_ms;   /* reply deadline, default 1000 */
+    uint16_t payload_size; /* echo data after the ICMP header, default 56 */
+    uint16_t identifier;   /* echo identifier on raw sockets, default from the clock */
+} fossil_net_probe_config_t;
+
+/**
+ * @brief Per-target counters and RTT histogram.
+ */
+typedef struct fossil_net_probe_target_stats
+{
+    fossil_net_endpoint_t target;
+    uint64_t sent;
+    uint64_t received;
+    uint64_t lost;        /* no reply within the timeout */
+    uint64_t rtt_min_ns;
+    uint64_t rtt_max_ns;
+    uint64_t rtt_sum_ns;
+    uint32_t histogram[FOSSIL_NET_PROBE_HIST_BUCKETS];
+} fossil_net_probe_target_stats_t;
+
+/**
+ * @brief Prober-wide counters.
+ */
+typedef struct fossil_net_probe_stats
+{
+    uint64_t sent;
+    uint64_t received;
+    uint64_t lost;
+    uint64_t late;         /* replies after their probe timed out */
+    uint64_t ignored;      /* ICMP that is not a reply to this prober */
+    uint64_t send_errors;  /* probes refused by the stack (e.g. no route) */
+} fossil_net_probe_stats_t;
+
+/**
+ * @brief Opaque ICMP/ICMPv6 echo prober bound to one socket.
+ *
+ * Outstanding probes live in a table indexed by the 16-bit echo sequence,
+ * so a reply is matched with one lookup plus an identifier and source check.
+ * Sends and receives are batched (sendmmsg/recvmmsg on Linux).
+ */
+typedef struct fossil_net_probe fossil_net_probe_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create a prober on an ICMP socket.
+ *
+ * The socket must come from fossil_net_socket_create() with type "raw"
+ * (privileged) or "icmp" (unprivileged ping socket) and family "ipv4" or
+ * "ipv6". It is switched to non-blocking mode and must outlive the prober.
+ * On ping sockets the kernel assigns the identifier.
+ *
+ * @param sock   ICMP socket.
+ * @param config Settings, or NULL for defaults.
+ * @return Prober, or NULL on failure.
+ */
+fossil_net_probe_t *fossil_net_probe_create(
+    fossil_net_socket_t *sock,
+    const fossil_net_probe_config_t *config);
+
+/**
+ * @brief Destroy a prober. The socket is left open.
+ *
+ * @param probe Prober to destroy.
+ */
+void fossil_net_probe_destroy(fossil_net_probe_t *probe);
+
+/**
+ * @brief Register a target.
+ *
+ * @param probe  Prober.
+ * @param target Address in the socket's family; the port is ignored.
+ * @return Target index, or -1 if full or the family does not match.
+ */
+int fossil_net_probe_add_target(
+    fossil_net_probe_t *probe,
+    const fossil_net_endpoint_t *target);
+
+/**
+ * @brief Number of registered targets.
+ *
+ * @param probe Prober.
+ * @return Target count.
+ */
+uint32_t fossil_net_probe_target_count(const fossil_net_probe_t *probe);
+
+/*=============================================================================
+PROBING
+=============================================================================*/
+
+/**
+ * @brief Send one echo request to each target in [first, first + count).
+ *
+ * Stops early when the socket buffer is full or the socket rate limit
+ * (fossil_net_socket_set_ratelimit) has no tokens; call again from
+ * first + *processed to continue. Interleave sends with
+ * fossil_net_probe_poll() so replies do not overflow the receive buffer.
+ *
+ * @param probe     Prober.
+ * @param first     First target index.
+ * @param count     Number of targets.
+ * @param processed Targets handled (sent or refused by the stack).
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_net_probe_send(
+    fossil_net_probe_t *probe,
+    uint32_t first,
+    uint32_t count,
+    uint32_t *processed);
+
+/**
+ * @brief Drain pending replies and time out overdue probes.
+ *
+ * Never blocks; wait for readability on the socket between calls.
+ *
+ * @param probe   Prober.
+ * @param replies Optional count of matched replies.
+ * @return 0 on success, -1 on socket error.
+ */
+int fossil_net_probe_poll(
+    fossil_net_probe_t *probe,
+    uint32_t *replies);
+
+/*=============================================================================
+RESULTS
+=============================================================================*/
+
+/**
+ * @brief Read one target's counters.
+ *
+ * @param probe Prober.
+ * @param index Target index.
+ * @param stats Stats out.
+ * @return 0 on success, -1 on bad index.
+ */
+int fossil_net_probe_target_stats(
+    const fossil_net_probe_t *probe,
+    uint32_t index,
+    fossil_net_probe_target_stats_t *stats);
+
+/**
+ * @brief Read prober-wide counters.
+ *
+ * @param probe Prober.
+ * @param stats Stats out.
+ * @return 0 on success, -1 on error.
+ */
+int fossil_net_probe_get_stats(
+    const fossil_net_probe_t *probe,
+    fossil_net_probe_stats_t *stats);
+
+/**
+ * @brief Estimate an RTT quantile from a target histogram.
+ *
+ * @param stats    Target stats.
+ * @param quantile Quantile in [0, 1], e.g. 0.99.
+ * @return Upper bound of the bucket holding the quantile in ns, 0 if no replies.
+ */
+uint64_t fossil_net_probe_rtt_quantile_ns(
+    const fossil_net_probe_target_stats_t *stats,
+    double quantile);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Probe
+    {
+    private:
+        fossil_net_probe_t *handle_;
+
+    public:
+        /**
+         * @brief Create a prober on an ICMP socket. Wraps fossil_net_probe_create.
+         */
+        explicit Probe(fossil_net_socket_t *sock, const fossil_net_probe_config_t *config = nullptr)
+            : handle_(fossil_net_probe_create(sock, config))
+        {
+        }
+
+        ~Probe()
+        {
+            if (handle_)
+                fossil_net_probe_destroy(handle_);
+        }
+
+        /**
+         * @brief Register a target. Wraps fossil_net_probe_add_target.
+         */
+        int add_target(const fossil_net_endpoint_t &target)
+        {
+            return fossil_net_probe_add_target(handle_, &target);
+        }
+
+        /**
+         * @brief Send to every target, returning how many were handled.
+         */
+        uint32_t send_all()
+        {
+            uint32_t processed = 0;
+            fossil_net_probe_send(handle_, 0, fossil_net_probe_target_count(handle_), &processed);
+            return processed;
+        }
+
+        /**
+         * @brief Drain replies. Wraps fossil_net_probe_poll.
+         */
+        uint32_t poll()
+        {
+            uint32_t replies = 0;
+            fossil_net_probe_poll(handle_, &replies);
+            return replies;
+        }
+
+        /**
+         * @brief Per-target counters. Wraps fossil_net_probe_target_stats.
+         */
+        fossil_net_probe_target_stats_t target_stats(uint32_t index) const
+        {
+            fossil_net_probe_target_stats_t s{};
+            fossil_net_probe_target_stats(handle_, index, &s);
+            return s;
+        }
+
+        /**
+         * @brief Prober-wide counters. Wraps fossil_net_probe_get_stats.
+         */
+        fossil_net_probe_stats_t stats() const
+        {
+            fossil_net_probe_stats_t s{};
+            fossil_net_probe_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_probe_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Probe(const Probe &) = delete;
+        Probe &operator=(const Probe &) = delete;
+
+        // Allow move
+        Probe(Probe &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Probe &operator=(Probe &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_probe_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_PROBE_H */
@@ -0,0 +1,312 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_RATELIMIT_H
+#define FOSSIL_NETWORK_RATELIMIT_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Opaque token-bucket limiter handle.
+ *
+ * A limiter may be attached to one socket (per-socket limit) or shared by
+ * several sockets (group limit); all operations are lock-free and safe to
+ * call from multiple threads.
+ */
+typedef struct fossil_net_ratelimit fossil_net_ratelimit_t;
+
+typedef struct fossil_net_ratelimit_stats
+{
+    uint64_t bytes_granted;   /* bytes allowed through */
+    uint64_t throttle_events; /* number of sends that had to wait or were refused */
+    uint64_t throttled_ns;    /* time spent waiting (or told to wait) for tokens */
+} fossil_net_ratelimit_stats_t;
+
+/*=============================================================================
+LIMITER
+=============================================================================*/
+
+/**
+ * @brief Create a token-bucket limiter.
+ *
+ * @param rate  Sustained rate in bytes per second (must be non-zero).
+ * @param burst Bucket depth in bytes; also the largest single grant.
+ * @return Pointer to limiter, or NULL on failure.
+ */
+fossil_net_ratelimit_t *fossil_net_ratelimit_create(
+    uint64_t rate,
+    uint64_t burst);
+
+/**
+ * @brief Destroy a limiter. Detach it from all sockets first.
+ *
+ * @param limiter Pointer to limiter.
+ */
+void fossil_net_ratelimit_destroy(fossil_net_ratelimit_t *limiter);
+
+/**
+ * @brief Change the rate and burst of a limiter.
+ *
+ * @param limiter Pointer to limiter.
+ * @param rate    Sustained rate in bytes per second (must be non-zero).
+ * @param burst   Bucket depth in bytes.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_ratelimit_set_rate(
+    fossil_net_ratelimit_t *limiter,
+    uint64_t rate,
+    uint64_t burst);
+
+/**
+ * @brief Get the bucket depth (largest single grant) in bytes.
+ *
+ * @param limiter Pointer to limiter.
+ * @return Burst size in bytes, 0 if limiter is NULL.
+ */
+uint64_t fossil_net_ratelimit_burst(const fossil_net_ratelimit_t *limiter);
+
+/**
+ * @brief Try to take tokens for a send.
+ *
+ * Requests larger than the burst size are never granted; callers should
+ * split them (the socket send paths do this automatically).
+ *
+ * @param limiter Pointer to limiter.
+ * @param bytes   Number of bytes about to be sent.
+ * @return 0 if granted, otherwise the number of nanoseconds until the
+ *         request could be granted.
+ */
+uint64_t fossil_net_ratelimit_acquire(
+    fossil_net_ratelimit_t *limiter,
+    uint32_t bytes);
+
+/**
+ * @brief Return tokens that were acquired but not used (e.g. on a short write).
+ *
+ * @param limiter Pointer to limiter.
+ * @param bytes   Number of unused bytes.
+ */
+void fossil_net_ratelimit_release(
+    fossil_net_ratelimit_t *limiter,
+    uint32_t bytes);
+
+/**
+ * @brief Get the delay before a send of the given size would be granted.
+ *
+ * Does not consume tokens. Intended as the timeout of a poll loop that has
+ * a throttled socket waiting to write.
+ *
+ * @param limiter Pointer to limiter.
+ * @param bytes   Number of bytes about to be sent.
+ * @return Delay in milliseconds, rounded up; 0 if a send would be granted now.
+ */
+uint32_t fossil_net_ratelimit_delay_ms(
+    const fossil_net_ratelimit_t *limiter,
+    uint32_t bytes);
+
+/**
+ * @brief Add a throttle event to the limiter counters.
+ *
+ * @param limiter Pointer to limiter.
+ * @param ns      Nanoseconds spent throttled.
+ */
+void fossil_net_ratelimit_record_throttle(
+    fossil_net_ratelimit_t *limiter,
+    uint64_t ns);
+
+/**
+ * @brief Read the limiter counters.
+ *
+ * @param limiter Pointer to limiter.
+ * @param stats   Pointer to stats structure to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_ratelimit_get_stats(
+    const fossil_net_ratelimit_t *limiter,
+    fossil_net_ratelimit_stats_t *stats);
+
+/*=============================================================================
+SOCKET INTEGRATION
+=============================================================================*/
+
+/**
+ * @brief Attach a limiter to a socket, or detach with NULL.
+ *
+ * Once attached, fossil_net_socket_send (and the other send paths) split
+ * stream writes to the burst size and wait for tokens. Datagrams are
+ * charged whole; one larger than the burst fails with EMSGSIZE/WSAEMSGSIZE
+ * instead of being truncated. While waiting, a blocking socket sleeps,
+ * a non-blocking socket fails with EAGAIN/WSAEWOULDBLOCK and the caller can
+ * use fossil_net_ratelimit_delay_ms as its poll timeout. The same limiter
+ * can be attached to several sockets to enforce a shared group limit.
+ *
+ * The limiter is recorded against the descriptor and flagged in this
+ * socket structure; copies made before attaching are not throttled.
+ *
+ * @param sock    Pointer to socket structure.
+ * @param limiter Pointer to limiter, or NULL to detach.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_set_ratelimit(
+    fossil_net_socket_t *sock,
+    fossil_net_ratelimit_t *limiter);
+
+/**
+ * @brief Get the limiter attached to a socket.
+ *
+ * @param sock Pointer to socket structure.
+ * @return Pointer to limiter, or NULL if none is attached.
+ */
+fossil_net_ratelimit_t *fossil_net_socket_get_ratelimit(
+    const fossil_net_socket_t *sock);
+
+/**
+ * @brief Set the kernel pacing rate (SO_MAX_PACING_RATE) of a socket.
+ *
+ * Kernel pacing spreads packets evenly instead of sending them in bursts.
+ * TCP paces internally; UDP needs the fq qdisc on the egress interface.
+ * Only supported on Linux.
+ *
+ * @param sock Pointer to socket structure.
+ * @param rate Rate in bytes per second, 0 for unlimited.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_set_pacing_rate(
+    fossil_net_socket_t *sock,
+    uint64_t rate);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class RateLimit
+    {
+    private:
+        fossil_net_ratelimit_t *handle_;
+
+    public:
+        /**
+         * @brief Construct a limiter. Wraps fossil_net_ratelimit_create.
+         */
+        RateLimit(uint64_t rate, uint64_t burst)
+            : handle_(fossil_net_ratelimit_create(rate, burst))
+        {}
+
+        /**
+         * @brief Destroy the limiter. Wraps fossil_net_ratelimit_destroy.
+         */
+        ~RateLimit()
+        {
+            if (handle_)
+                fossil_net_ratelimit_destroy(handle_);
+        }
+
+        /**
+         * @brief Change the rate and burst. Wraps fossil_net_ratelimit_set_rate.
+         */
+        int set_rate(uint64_t rate, uint64_t burst)
+        {
+            return fossil_net_ratelimit_set_rate(handle_, rate, burst);
+        }
+
+        /**
+         * @brief Try to take tokens. Wraps fossil_net_ratelimit_acquire.
+         */
+        uint64_t acquire(uint32_t bytes)
+        {
+            return fossil_net_ratelimit_acquire(handle_, bytes);
+        }
+
+        /**
+         * @brief Delay before a send would be granted. Wraps fossil_net_ratelimit_delay_ms.
+         */
+        uint32_t delay_ms(uint32_t bytes) const
+        {
+            return fossil_net_ratelimit_delay_ms(handle_, bytes);
+        }
+
+        /**
+         * @brief Attach to a socket. Wraps fossil_net_socket_set_ratelimit.
+         */
+        int attach(fossil_net_socket_t *sock)
+        {
+            return fossil_net_socket_set_ratelimit(sock, handle_);
+        }
+
+        /**
+         * @brief Read the counters. Wraps fossil_net_ratelimit_get_stats.
+         */
+        fossil_net_ratelimit_stats_t stats() const
+        {
+            fossil_net_ratelimit_stats_t s = {0, 0, 0};
+            fossil_net_ratelimit_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_ratelimit_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        RateLimit(const RateLimit &) = delete;
+        RateLimit &operator=(const RateLimit &) = delete;
+
+        // Allow move
+        RateLimit(RateLimit &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        RateLimit &operator=(RateLimit &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_ratelimit_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_RATELIMIT_H */
@@ -0,0 +1,780 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_REACTOR_H
+#define FOSSIL_NETWORK_REACTOR_H
+
+#include "server.h"
+#include "writeq.h"
+#include "shed.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+#define FOSSIL_NET_REACTOR_MAX_LOOPS 256
+
+/**
+ * @brief Multi-threaded server runtime.
+ *
+ * Runs N event loops, one per thread, each with its own poller (epoll,
+ * kqueue, or poll/WSAPoll elsewhere). Connections are accepted either by
+ * loop 0 and handed off round-robin, or by every loop on its own
+ * SO_REUSEPORT listener. A connection stays on one loop for its lifetime,
+ * so its callbacks never run concurrently. Work from other threads reaches
+ * a loop through a lock-free queue and an eventfd (pipe elsewhere) wakeup.
+ */
+typedef struct fossil_net_reactor fossil_net_reactor_t;
+
+/**
+ * @brief One event loop of a reactor.
+ */
+typedef struct fossil_net_loop fossil_net_loop_t;
+
+/**
+ * @brief Accepted connection, owned by one loop.
+ *
+ * Every fossil_net_conn_* call must be made on the owning loop's thread,
+ * normally from inside a callback; other threads post to the loop instead.
+ */
+typedef struct fossil_net_conn fossil_net_conn_t;
+
+/*
+ * Connection ID, stable for the connection's lifetime and never reused for
+ * another live connection: slab slot and loop index in the low 32 bits,
+ * slot generation in the high 32. 0 is never a valid ID.
+ */
+typedef uint64_t fossil_net_conn_id_t;
+
+/**
+ * @brief Task run on a loop's thread.
+ */
+typedef void (*fossil_net_loop_task_fn)(fossil_net_loop_t *loop, void *arg);
+
+/**
+ * @brief Task run on a connection's loop; conn is NULL if it has closed.
+ */
+typedef void (*fossil_net_conn_task_fn)(fossil_net_conn_t *conn, void *arg);
+
+/**
+ * @brief One received datagram, handed to on_datagram.
+ *
+ * data points into the loop's receive batch and may be edited in place.
+ * To answer, point reply at the bytes to send back to peer and set
+ * reply_size: either into reply_buf (reply_capacity bytes reserved for
+ * this datagram), into data itself, or at memory that outlives the batch.
+ * Replies are not copied; the loop sends all of a batch's replies with
+ * one sendmmsg (sendto elsewhere) after the last handler returns.
+ */
+typedef struct fossil_net_datagram
+{
+    uint8_t *data;
+    uint32_t size;
+    uint8_t truncated;             /* longer than max_datagram, the tail is lost */
+    fossil_net_endpoint_t peer;
+    const void *reply;             /* NULL for no reply */
+    uint32_t reply_size;
+    uint8_t *reply_buf;
+    uint32_t reply_capacity;
+} fossil_net_datagram_t;
+
+/**
+ * @brief Connection callbacks; any of them may be NULL.
+ *
+ * Readiness is level-triggered: on_readable fires again while unread data
+ * remains, and must close the connection once the peer has closed.
+ * Without on_readable, connections are closed when the peer hangs up.
+ * A reactor serving a UDP server has no connections and only calls
+ * on_datagram, which it requires.
+ */
+typedef struct fossil_net_reactor_callbacks
+{
+    int (*on_accept)(fossil_net_conn_t *conn, void *user); /* non-zero rejects */
+    void (*on_readable)(fossil_net_conn_t *conn, void *user);
+    void (*on_writable)(fossil_net_conn_t *conn, void *user); /* see fossil_net_conn_want_write */
+    void (*on_close)(fossil_net_conn_t *conn, void *user);
+    void (*on_watermark)(fossil_net_conn_t *conn, bool above, void *user); /* see fossil_net_conn_write */
+    void (*on_datagram)(fossil_net_loop_t *loop, fossil_net_datagram_t *dgram, void *user);
+} fossil_net_reactor_callbacks_t;
+
+/**
+ * @brief Reactor settings; zero fields take the defaults.
+ */
+typedef struct fossil_net_reactor_config
+{
+    uint32_t threads;      /* event loops, default: online CPUs */
+    uint32_t max_events;   /* readiness events per poll, default 256 */
+    uint32_t accept_batch; /* accepts per listener wakeup, default 64 */
+    int32_t backlog;       /* listen backlog, default 1024 */
+    uint8_t reuseport;     /* one SO_REUSEPORT listener per loop, no handoff */
+    uint8_t tcp_nodelay;   /* set TCP_NODELAY on accepted connections */
+    uint64_t write_high_watermark; /* per-connection write queue, default 1 MiB */
+    uint64_t write_low_watermark;  /* default high / 4 */
+    uint64_t write_limit;          /* pending bytes before writes fail, 0 for none */
+    uint32_t recv_batch;   /* datagrams per receive call, default 32 */
+    uint32_t max_datagram; /* receive and reply_buf size per datagram, default 2048 */
+    uint8_t pin_cpus;      /* bind each loop thread to one CPU, see cpus */
+    const int32_t *cpus;   /* loop i runs on cpus[i % cpu_count]; copied */
+    uint32_t cpu_count;    /* 0: the CPUs the process may run on, in order */
+} fossil_net_reactor_config_t;
+
+/**
+ * @brief Reactor-wide counters, summed over the loops.
+ */
+typedef struct fossil_net_reactor_stats
+{
+    uint64_t accepted;
+    uint64_t rejected;      /* refused by on_accept */
+    uint64_t closed;
+    uint64_t active;        /* open connections */
+    uint64_t handoffs;      /* connections passed to another loop */
+    uint64_t accept_errors; /* e.g. out of descriptors */
+    uint64_t tasks;         /* posted tasks run */
+    uint64_t wakeups;       /* cross-thread wakeups consumed */
+    uint64_t shed;          /* refused by admission control (counted as accepted and closed) */
+    uint64_t idle_closed;   /* idle connections closed to shed load */
+    uint64_t datagrams;     /* received in datagram mode */
+    uint64_t recv_calls;    /* receive calls that returned datagrams */
+    uint64_t replies;       /* replies the kernel accepted */
+    uint64_t reply_drops;   /* replies lost to a full socket buffer or a send error */
+    uint64_t truncated;     /* datagrams longer than max_datagram */
+    uint64_t bytes_in;      /* received on connections and as datagrams */
+    uint64_t bytes_out;     /* sent, or queued with fossil_net_conn_write and co. */
+} fossil_net_reactor_stats_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create a reactor serving a TCP or UDP server.
+ *
+ * The server socket is switched to non-blocking mode and put into the
+ * listening state; in reuseport mode it gets SO_REUSEPORT and one more
+ * listener per extra loop is bound to the same address. The server must
+ * outlive the reactor. No thread runs until fossil_net_reactor_start().
+ *
+ * A UDP server runs in datagram mode, always with one SO_REUSEPORT socket
+ * per loop so the kernel spreads peers over the loops. Each loop drains
+ * its socket recv_batch datagrams per recvmmsg (recvfrom elsewhere) and
+ * calls on_datagram for each. A rate limiter or tap attached to the
+ * server socket before create is shared by every loop's socket; their
+ * datagrams then go one at a time through fossil_net_socket_receive_from
+ * and fossil_net_socket_send_to, and a reply the limiter refuses is
+ * counted in reply_drops.
+ *
+ * With pin_cpus each loop thread is bound to its CPU before it runs
+ * (Linux and Windows; elsewhere the setting is ignored). A pinned loop
+ * allocates its poll and datagram buffers again on its own thread, and
+ * connection slots, write queues and per-connection buffers are always
+ * allocated there, so under the default first-touch policy a loop's
+ * memory comes from its own NUMA node. Listener sharding follows the
+ * CPUs too: in reuseport and datagram mode a program attached to the
+ * SO_REUSEPORT group (fossil_net_filter_reuseport_cpu) sends each flow to
+ * the loop pinned to the CPU its packets are received on, and in handoff
+ * mode each connection goes to the loop on its SO_INCOMING_CPU when there
+ * is one. Spread the NIC's receive queue interrupts over the same CPUs
+ * for the full effect. The program picks sockets by their position in
+ * the group, so it is only attached when the server's socket did not have
+ * SO_REUSEPORT yet: a listener inherited from a reuseport predecessor
+ * shares a group that begins with the predecessor's sockets, and there
+ * the kernel's hash spreads flows instead. A program attached by a
+ * predecessor stays on the group after it exits.
+ *
+ * @param server    TCP or UDP server from fossil_net_server_create().
+ * @param config    Settings, or NULL for defaults.
+ * @param callbacks Connection callbacks (copied).
+ * @param user      Passed to every callback.
+ * @return Reactor, or NULL on failure.
+ */
+fossil_net_reactor_t *fossil_net_reactor_create(
+    fossil_net_server_t *server,
+    const fossil_net_reactor_config_t *config,
+    const fossil_net_reactor_callbacks_t *callbacks,
+    void *user);
+
+/**
+ * @brief Stop the reactor if running and release it.
+ *
+ * @param reactor Reactor to destroy.
+ */
+void fossil_net_reactor_destroy(fossil_net_reactor_t *reactor);
+
+/**
+ * @brief Start one thread per loop.
+ *
+ * @param reactor Reactor.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_reactor_start(fossil_net_reactor_t *reactor);
+
+/**
+ * @brief Stop all loops and wait for their threads.
+ *
+ * Open connections are closed on their own loops (on_close runs) before the
+ * threads exit. Must not be called from a loop thread.
+ *
+ * @param reactor Reactor.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_reactor_stop(fossil_net_reactor_t *reactor);
+
+/**
+ * @brief Attach an overload shedder; call before fossil_net_reactor_start().
+ *
+ * The reactor records accept-queue sojourn times and applies the level:
+ * at FOSSIL_NET_SHED_REJECT new connections get the canned response and
+ * are closed, at FOSSIL_NET_SHED_PAUSE_ACCEPT listeners are taken out of
+ * the poller for an interval at a time, and at FOSSIL_NET_SHED_CLOSE_IDLE
+ * each loop closes up to close_batch connections that have been idle for
+ * an interval, oldest first. max_connections is enforced at every level
+ * by refusing the same way. Refused connections never reach on_accept.
+ * Request queues are the application's to record. In datagram mode,
+ * datagrams are read and dropped unseen from FOSSIL_NET_SHED_REJECT on
+ * and reading pauses at FOSSIL_NET_SHED_PAUSE_ACCEPT.
+ *
+ * @param reactor Reactor.
+ * @param shed    Shedder that outlives the reactor, or NULL to detach.
+ * @return 0 on success, non-zero if the reactor is running.
+ */
+int fossil_net_reactor_set_shed(
+    fossil_net_reactor_t *reactor,
+    fossil_net_shed_t *shed);
+
+/**
+ * @brief Stop accepting for good and let open connections finish.
+ *
+ * Safe from any thread. Each loop takes its listener out of the poller,
+ * then runs fn on every open connection, and on any connection handed
+ * to it afterwards, so the protocol can close idle ones and end the rest
+ * after their current work. The server's socket stays open until
+ * destroy, so a successor that inherited it keeps its accept queue. In
+ * reuseport mode the extra per-loop listeners are private: each loop
+ * accepts what is queued on its own, then closes it so the kernel sends
+ * new peers to the rest of the group. A handshake that completes in
+ * between is reset unless net.ipv4.tcp_migrate_req is set (Linux 5.14+).
+ * In datagram mode the extra sockets are read empty and closed the same
+ * way, and reading from the server's socket stops. Repeated calls are
+ * ignored.
+ *
+ * @param reactor Reactor.
+ * @param fn      Per-connection task, or NULL to only stop accepting.
+ * @param arg     Task argument.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_reactor_drain(
+    fossil_net_reactor_t *reactor,
+    fossil_net_conn_task_fn fn,
+    void *arg);
+
+/**
+ * @brief Wait for a draining reactor to have no open connections.
+ *
+ * @param reactor    Reactor after fossil_net_reactor_drain().
+ * @param timeout_ns Longest wait.
+ * @return 0 once drained, 1 on timeout, -1 if the reactor is not draining.
+ */
+int fossil_net_reactor_wait_drained(
+    fossil_net_reactor_t *reactor,
+    uint64_t timeout_ns);
+
+/**
+ * @brief Number of event loops.
+ *
+ * @param reactor Reactor.
+ * @return Loop count.
+ */
+uint32_t fossil_net_reactor_loop_count(const fossil_net_reactor_t *reactor);
+
+/**
+ * @brief Get a loop by index.
+ *
+ * @param reactor Reactor.
+ * @param index   Loop index below fossil_net_reactor_loop_count().
+ * @return Loop, or NULL if out of range.
+ */
+fossil_net_loop_t *fossil_net_reactor_loop(
+    fossil_net_reactor_t *reactor,
+    uint32_t index);
+
+/**
+ * @brief Read counters.
+ *
+ * @param reactor Reactor.
+ * @param stats   Output counters.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_reactor_get_stats(
+    fossil_net_reactor_t *reactor,
+    fossil_net_reactor_stats_t *stats);
+
+/*=============================================================================
+LOOPS
+=============================================================================*/
+
+/**
+ * @brief Run a task on a loop's thread. Safe from any thread.
+ *
+ * Tasks run in posting order per producer, after the current batch of I/O
+ * events. Tasks queued before fossil_net_reactor_stop() still run; posting
+ * fails once the reactor is stopping.
+ *
+ * @param loop Target loop.
+ * @param fn   Task function.
+ * @param arg  Task argument.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_loop_post(
+    fossil_net_loop_t *loop,
+    fossil_net_loop_task_fn fn,
+    void *arg);
+
+/**
+ * @brief Loop running on the calling thread.
+ *
+ * @return Loop, or NULL when called outside a loop thread.
+ */
+fossil_net_loop_t *fossil_net_loop_current(void);
+
+/**
+ * @brief Index of a loop within its reactor.
+ *
+ * @param loop Loop.
+ * @return Loop index.
+ */
+uint32_t fossil_net_loop_index(const fossil_net_loop_t *loop);
+
+/**
+ * @brief CPU a loop's thread is bound to.
+ *
+ * @param loop Loop.
+ * @return CPU number, or -1 if the loop is not running pinned.
+ */
+int32_t fossil_net_loop_cpu(const fossil_net_loop_t *loop);
+
+/**
+ * @brief Reactor owning a loop.
+ *
+ * @param loop Loop.
+ * @return Reactor.
+ */
+fossil_net_reactor_t *fossil_net_loop_reactor(fossil_net_loop_t *loop);
+
+/**
+ * @brief Resolve a connection ID on the calling loop in O(1).
+ *
+ * @param loop Loop running on the calling thread.
+ * @param id   Connection ID.
+ * @return Connection, or NULL if it has closed or belongs to another loop.
+ */
+fossil_net_conn_t *fossil_net_loop_find_conn(
+    fossil_net_loop_t *loop,
+    fossil_net_conn_id_t id);
+
+/**
+ * @brief Number of open connections on a loop (loop thread only).
+ *
+ * @param loop Loop.
+ * @return Connection count.
+ */
+uint32_t fossil_net_loop_conn_count(const fossil_net_loop_t *loop);
+
+/**
+ * @brief Visit every open connection of a loop (loop thread only).
+ *
+ * fn may close the connection it is given. Meant for idle sweeps and
+ * metrics; cost is proportional to the live connections.
+ *
+ * @param loop Loop.
+ * @param fn   Visitor.
+ * @param arg  Visitor argument.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_loop_foreach_conn(
+    fossil_net_loop_t *loop,
+    fossil_net_conn_task_fn fn,
+    void *arg);
+
+/**
+ * @brief Run fn on a connection's own loop. Safe from any thread.
+ *
+ * The ID is resolved on the loop, so a connection that closed in the
+ * meantime is detected: fn then receives NULL and should only release arg.
+ *
+ * @param reactor Reactor.
+ * @param id      Connection ID from fossil_net_conn_id().
+ * @param fn      Task function.
+ * @param arg     Task argument.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_reactor_post_conn(
+    fossil_net_reactor_t *reactor,
+    fossil_net_conn_id_t id,
+    fossil_net_conn_task_fn fn,
+    void *arg);
+
+/*=============================================================================
+CONNECTIONS
+=============================================================================*/
+
+/**
+ * @brief Receive without blocking.
+ *
+ * @param conn     Connection.
+ * @param buffer   Destination buffer.
+ * @param size     Buffer size in bytes.
+ * @param received Bytes received; 0 with a 0 return means the peer closed.
+ * @return 0 on success, 1 if no data is available yet, -1 on error.
+ */
+int fossil_net_conn_receive(
+    fossil_net_conn_t *conn,
+    void *buffer,
+    uint32_t size,
+    uint32_t *received);
+
+/**
+ * @brief Send without blocking; a short count means the socket buffer is full.
+ *
+ * Never raises SIGPIPE.
+ *
+ * @param conn Connection.
+ * @param data Data to send.
+ * @param size Size in bytes.
+ * @param sent Bytes accepted by the kernel.
+ * @return 0 on success, 1 if nothing could be sent yet, -1 on error.
+ */
+int fossil_net_conn_send(
+    fossil_net_conn_t *conn,
+    const void *data,
+    uint32_t size,
+    uint32_t *sent);
+
+/**
+ * @brief Pause or resume on_readable callbacks.
+ *
+ * While paused, incoming data stays in the kernel buffer and TCP flow
+ * control pushes back on the peer. A connection whose peer hangs up
+ * while paused is closed.
+ *
+ * @param conn    Connection.
+ * @param enabled false to stop reading, true to resume.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_conn_want_read(
+    fossil_net_conn_t *conn,
+    bool enabled);
+
+/**
+ * @brief Ask for (or stop) on_writable callbacks.
+ *
+ * @param conn    Connection.
+ * @param enabled true while there is data waiting to be sent.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_conn_want_write(
+    fossil_net_conn_t *conn,
+    bool enabled);
+
+/**
+ * @brief Buffered write: send what the socket takes now, queue the rest.
+ *
+ * The queue is flushed by the loop whenever the socket becomes writable.
+ * Once pending bytes reach write_high_watermark, on_watermark(conn, true)
+ * asks the producer to pause; on_watermark(conn, false) follows when a
+ * flush brings them down to write_low_watermark. Do not mix with
+ * fossil_net_conn_send while data is pending, or bytes go out of order.
+ * Closing the connection drops unsent data.
+ *
+ * @param conn Connection.
+ * @param data Data to send.
+ * @param size Size in bytes.
+ * @return 0 on success, -1 on a socket error or when write_limit would be
+ *         exceeded.
+ */
+int fossil_net_conn_write(
+    fossil_net_conn_t *conn,
+    const void *data,
+    uint32_t size);
+
+/**
+ * @brief Buffered write of a shared buffer without copying.
+ *
+ * @param conn   Connection.
+ * @param buf    Buffer; the queue takes its own reference.
+ * @param offset First byte.
+ * @param size   Number of bytes.
+ * @return 0 on success, -1 on failure as for fossil_net_conn_write.
+ */
+int fossil_net_conn_write_buf(
+    fossil_net_conn_t *conn,
+    fossil_net_buf_t *buf,
+    uint32_t offset,
+    uint32_t size);
+
+/**
+ * @brief Buffered write of a file range, sent with sendfile where
+ *        available. See fossil_net_writeq_append_file.
+ *
+ * @param conn   Connection.
+ * @param owner  Buffer keeping fd open; the queue takes its own reference.
+ * @param fd     Open file descriptor.
+ * @param offset First byte in the file.
+ * @param size   Number of bytes.
+ * @return 0 on success, -1 on failure as for fossil_net_conn_write.
+ */
+int fossil_net_conn_write_file(
+    fossil_net_conn_t *conn,
+    fossil_net_buf_t *owner,
+    int32_t fd,
+    uint64_t offset,
+    uint64_t size);
+
+/**
+ * @brief Bytes queued by fossil_net_conn_write and not yet sent.
+ *
+ * @param conn Connection.
+ * @return Pending bytes.
+ */
+uint64_t fossil_net_conn_pending(const fossil_net_conn_t *conn);
+
+/**
+ * @brief Close a connection.
+ *
+ * on_close runs before this returns; the handle stays readable until the
+ * current callback returns. Repeated calls are ignored.
+ *
+ * @param conn Connection.
+ */
+void fossil_net_conn_close(fossil_net_conn_t *conn);
+
+/**
+ * @brief Close once data queued by fossil_net_conn_write has been sent.
+ *
+ * Reading stops at once; the write side is shut down after the last byte
+ * so the peer sees a clean end of stream. Closes immediately when nothing
+ * is pending.
+ *
+ * @param conn Connection.
+ */
+void fossil_net_conn_close_flushed(fossil_net_conn_t *conn);
+
+/**
+ * @brief ID of a connection, for use from other threads.
+ *
+ * @param conn Connection.
+ * @return Connection ID.
+ */
+fossil_net_conn_id_t fossil_net_conn_id(const fossil_net_conn_t *conn);
+
+/**
+ * @brief Socket of a connection (non-blocking, owned by the reactor).
+ *
+ * @param conn Connection.
+ * @return Socket.
+ */
+fossil_net_socket_t *fossil_net_conn_socket(fossil_net_conn_t *conn);
+
+/**
+ * @brief Peer address recorded at accept time.
+ *
+ * @param conn Connection.
+ * @return Peer endpoint.
+ */
+const fossil_net_endpoint_t *fossil_net_conn_peer(const fossil_net_conn_t *conn);
+
+/**
+ * @brief Loop owning a connection.
+ *
+ * @param conn Connection.
+ * @return Loop.
+ */
+fossil_net_loop_t *fossil_net_conn_loop(fossil_net_conn_t *conn);
+
+/**
+ * @brief Attach caller data to a connection.
+ *
+ * @param conn Connection.
+ * @param data Caller data.
+ */
+void fossil_net_conn_set_user(
+    fossil_net_conn_t *conn,
+    void *data);
+
+/**
+ * @brief Caller data attached with fossil_net_conn_set_user().
+ *
+ * @param conn Connection.
+ * @return Caller data, or NULL.
+ */
+void *fossil_net_conn_get_user(const fossil_net_conn_t *conn);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Reactor
+    {
+    private:
+        fossil_net_reactor_t *handle_;
+
+    public:
+        /**
+         * @brief Create a reactor. Wraps fossil_net_reactor_create.
+         */
+        Reactor(fossil_net_server_t *server, const fossil_net_reactor_callbacks_t &callbacks,
+                void *user = nullptr, const fossil_net_reactor_config_t *config = nullptr)
+            : handle_(fossil_net_reactor_create(server, config, &callbacks, user))
+        {
+        }
+
+        ~Reactor()
+        {
+            if (handle_)
+                fossil_net_reactor_destroy(handle_);
+        }
+
+        /**
+         * @brief Start the loop threads. Wraps fossil_net_reactor_start.
+         */
+        int start()
+        {
+            return fossil_net_reactor_start(handle_);
+        }
+
+        /**
+         * @brief Stop and join the loops. Wraps fossil_net_reactor_stop.
+         */
+        int stop()
+        {
+            return fossil_net_reactor_stop(handle_);
+        }
+
+        /**
+         * @brief Number of loops. Wraps fossil_net_reactor_loop_count.
+         */
+        uint32_t loop_count() const
+        {
+            return fossil_net_reactor_loop_count(handle_);
+        }
+
+        /**
+         * @brief Post a task to a loop. Wraps fossil_net_loop_post.
+         */
+        int post(uint32_t index, fossil_net_loop_task_fn fn, void *arg)
+        {
+            return fossil_net_loop_post(fossil_net_reactor_loop(handle_, index), fn, arg);
+        }
+
+        /**
+         * @brief Attach an overload shedder.
+         *
+         * Wraps fossil_net_reactor_set_shed.
+         */
+        int set_shed(fossil_net_shed_t *shed)
+        {
+            return fossil_net_reactor_set_shed(handle_, shed);
+        }
+
+        /**
+         * @brief Stop accepting and let connections finish.
+         *
+         * Wraps fossil_net_reactor_drain.
+         */
+        int drain(fossil_net_conn_task_fn fn = nullptr, void *arg = nullptr)
+        {
+            return fossil_net_reactor_drain(handle_, fn, arg);
+        }
+
+        /**
+         * @brief Wait until no connection is open.
+         *
+         * Wraps fossil_net_reactor_wait_drained.
+         */
+        int wait_drained(uint64_t timeout_ns)
+        {
+            return fossil_net_reactor_wait_drained(handle_, timeout_ns);
+        }
+
+        /**
+         * @brief Run a task on a connection's loop.
+         *
+         * Wraps fossil_net_reactor_post_conn.
+         */
+        int post_conn(fossil_net_conn_id_t id, fossil_net_conn_task_fn fn, void *arg)
+        {
+            return fossil_net_reactor_post_conn(handle_, id, fn, arg);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_reactor_get_stats.
+         */
+        fossil_net_reactor_stats_t stats()
+        {
+            fossil_net_reactor_stats_t s{};
+            fossil_net_reactor_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_reactor_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Reactor(const Reactor &) = delete;
+        Reactor &operator=(const Reactor &) = delete;
+
+        // Allow move
+        Reactor(Reactor &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Reactor &operator=(Reactor &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_reactor_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_REACTOR_H */
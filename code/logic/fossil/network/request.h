@@ -170,7 +170,11 @@ EXECUTION
  * @brief Send a request over an existing socket and receive a response.
  *
  * Serializes the request, sends it through the provided socket, and waits for a response.
- * Populates the response structure with the received data.
+ * Populates the response structure with the received data. The connection is left
+ * open (HTTP/1.1 keep-alive) unless a "Connection: close" header is set, so further
+ * requests can reuse the socket. Responses are read by their framing: up to their
+ * Content-Length, to the last chunk of a chunked body (decoded into res->body), or
+ * until the server closes when neither is present.
  *
  * @param sock Pointer to an initialized and connected socket.
  * @param req Pointer to the request structure to send.
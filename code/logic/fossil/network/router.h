@@ -0,0 +1,249 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_ROUTER_H
+#define FOSSIL_NETWORK_ROUTER_H
+
+#include "fossil/network/parser.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+#define FOSSIL_NET_ROUTER_MAX_PARAMS 8
+
+#define FOSSIL_NET_ROUTER_NOT_FOUND   (-1)
+#define FOSSIL_NET_ROUTER_NOT_ALLOWED (-2)
+
+/**
+ * @brief Radix-tree request router.
+ *
+ * Patterns are paths made of static text, ":name" segments matching one
+ * path segment and a final "*name" segment matching the rest of the path
+ * (possibly empty), e.g. "/users/:id/posts/:post". Static text wins over
+ * a parameter, which wins over a wildcard; matching backtracks when a
+ * more specific branch dead-ends. Routes are added up front; matching
+ * does not allocate and may run concurrently from any number of threads
+ * once no more routes are being added.
+ */
+typedef struct fossil_net_router fossil_net_router_t;
+
+typedef struct fossil_net_route_param
+{
+    fossil_net_slice_t name;    /* points into the router */
+    fossil_net_slice_t value;   /* points into the matched path */
+} fossil_net_route_param_t;
+
+typedef struct fossil_net_route_match
+{
+    void *handler;
+    const char *pattern;        /* pattern the handler was added with */
+    fossil_net_route_param_t params[FOSSIL_NET_ROUTER_MAX_PARAMS];
+    uint32_t param_count;
+    uint32_t allowed;           /* on NOT_ALLOWED: bit per method with a handler */
+} fossil_net_route_match_t;
+
+/*=============================================================================
+ROUTER
+=============================================================================*/
+
+/**
+ * @brief Create an empty router.
+ *
+ * @return Router handle, NULL on allocation failure.
+ */
+fossil_net_router_t *fossil_net_router_create(void);
+
+/**
+ * @brief Destroy a router.
+ *
+ * @param router Router handle.
+ */
+void fossil_net_router_destroy(fossil_net_router_t *router);
+
+/**
+ * @brief Register a handler.
+ *
+ * @param router  Router handle.
+ * @param method  Method the handler serves.
+ * @param pattern Route pattern; copied.
+ * @param handler Opaque handler returned by fossil_net_router_match.
+ * @return 0 on success, -1 if the pattern is invalid, already has a
+ *         handler for this method, or names a parameter differently from
+ *         an existing route at the same position.
+ */
+int fossil_net_router_add(
+    fossil_net_router_t *router,
+    fossil_net_http_method_t method,
+    const char *pattern,
+    void *handler);
+
+/**
+ * @brief Find the handler for a request path.
+ *
+ * HEAD requests fall back to the GET handler.
+ *
+ * @param router Router handle.
+ * @param method Request method.
+ * @param path   Request path (no query string).
+ * @param len    Path length.
+ * @param match  Receives handler and parameters.
+ * @return 0 on match, FOSSIL_NET_ROUTER_NOT_FOUND, or
+ *         FOSSIL_NET_ROUTER_NOT_ALLOWED if the path matches but not for
+ *         this method (match->allowed lists the methods that would).
+ */
+int fossil_net_router_match(
+    const fossil_net_router_t *router,
+    fossil_net_http_method_t method,
+    const char *path,
+    uint32_t len,
+    fossil_net_route_match_t *match);
+
+/**
+ * @brief Look up a matched parameter by name.
+ *
+ * @param match Result of a successful match.
+ * @param name  Parameter name without ':' or '*'.
+ * @param value Receives the value (may be NULL).
+ * @return true if present.
+ */
+bool fossil_net_route_param(
+    const fossil_net_route_match_t *match,
+    const char *name,
+    fossil_net_slice_t *value);
+
+/**
+ * @brief Number of routes (pattern and method pairs) registered.
+ *
+ * @param router Router handle.
+ * @return Route count.
+ */
+uint32_t fossil_net_router_count(const fossil_net_router_t *router);
+
+#ifdef __cplusplus
+}
+#include <string>
+#include <utility>
+
+namespace fossil::net
+{
+
+    class Router
+    {
+    public:
+        /**
+         * @brief Construct an empty router. Wraps fossil_net_router_create.
+         */
+        Router() : handle_(fossil_net_router_create()) {}
+
+        /**
+         * @brief Destroy the router. Wraps fossil_net_router_destroy.
+         */
+        ~Router()
+        {
+            fossil_net_router_destroy(handle_);
+        }
+
+        /**
+         * @brief Register a handler. Wraps fossil_net_router_add.
+         */
+        bool add(fossil_net_http_method_t method, const std::string &pattern, void *handler)
+        {
+            return fossil_net_router_add(handle_, method, pattern.c_str(), handler) == 0;
+        }
+
+        /**
+         * @brief Find the handler for a path. Wraps fossil_net_router_match.
+         *
+         * The matched parameters point into path, which must outlive them;
+         * temporaries are rejected for that reason.
+         */
+        int match(fossil_net_http_method_t method, const std::string &path, fossil_net_route_match_t *match) const
+        {
+            return fossil_net_router_match(handle_, method, path.data(), static_cast<uint32_t>(path.size()), match);
+        }
+
+        int match(fossil_net_http_method_t method, std::string &&path, fossil_net_route_match_t *match) const = delete;
+
+        /**
+         * @brief Find the handler for a parsed request's path.
+         *
+         * Wraps fossil_net_router_match.
+         */
+        int match(const fossil_net_http_request_t &req, fossil_net_route_match_t *match) const
+        {
+            return fossil_net_router_match(handle_, req.method, req.path.ptr, req.path.len, match);
+        }
+
+        /**
+         * @brief Number of routes. Wraps fossil_net_router_count.
+         */
+        uint32_t count() const
+        {
+            return fossil_net_router_count(handle_);
+        }
+
+        /**
+         * @brief Get the underlying router handle.
+         */
+        fossil_net_router_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Router(const Router &) = delete;
+        Router &operator=(const Router &) = delete;
+
+        // Allow move
+        Router(Router &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Router &operator=(Router &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_router_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+
+    private:
+        fossil_net_router_t *handle_;
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_ROUTER_H */
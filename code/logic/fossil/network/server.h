@@ -113,6 +113,83 @@ int fossil_net_server_set_blocking(
     fossil_net_server_t *server,
     bool blocking);
 
+/**
+ * @brief Get the server's listening socket.
+ *
+ * The socket stays owned by the server; it is exposed so runtimes such as
+ * the reactor can register it with their own pollers.
+ *
+ * @param server Pointer to server instance.
+ * @return Pointer to the socket, or NULL if server is NULL.
+ */
+fossil_net_socket_t *fossil_net_server_socket(
+    fossil_net_server_t *server);
+
+/*=============================================================================
+INHERITED LISTENERS
+=============================================================================*/
+
+/* Most listeners fossil_net_server_inherit accepts in one handoff. */
+#define FOSSIL_NET_SERVER_MAX_INHERIT 64
+
+/**
+ * @brief Wrap an already bound (and possibly listening) socket in a server.
+ * Type and address are read back from the kernel, so a listener inherited
+ * across exec keeps its accept queue. Only TCP and UDP over IPv4/IPv6 are
+ * accepted. On success the server owns fd.
+ * @param fd Socket descriptor.
+ * @return Pointer to server instance, or NULL on failure.
+ */
+fossil_net_server_t *fossil_net_server_adopt(int32_t fd);
+
+/**
+ * @brief Adopt the listeners of systemd-style socket activation.
+ * Honors LISTEN_FDS only when LISTEN_PID names this process, then unsets
+ * LISTEN_PID, LISTEN_FDS and LISTEN_FDNAMES so children do not inherit
+ * them. servers[i] receives descriptor 3 + i, or NULL when that one is not
+ * a TCP/UDP socket (it is then left open), which keeps the order of
+ * LISTEN_FDNAMES. Always returns 0 on Windows.
+ * @param servers Output array.
+ * @param max     Capacity of servers; extra descriptors are left open.
+ * @return Number of entries stored, 0 when not socket-activated.
+ */
+int fossil_net_server_listen_fds(
+    fossil_net_server_t **servers,
+    uint32_t max);
+
+/**
+ * @brief Pass listeners to a successor process (old side of a restart).
+ * Binds a unix socket at path, waits for one connection from
+ * fossil_net_server_inherit and sends every descriptor in one SCM_RIGHTS
+ * message. Where supported, a peer running as another user is refused.
+ * The servers stay usable here, so keep accepting until the successor is
+ * up, then drain and destroy them; the shared sockets and their accept
+ * queues live on in the successor. Not available on Windows.
+ * @param path       Filesystem path for the rendezvous socket; replaced if it exists.
+ * @param servers    Servers to pass, in the order the successor will see.
+ * @param count      Number of servers, at most FOSSIL_NET_SERVER_MAX_INHERIT.
+ * @param timeout_ms How long to wait for the successor.
+ * @return 0 on success, non-zero on failure or timeout.
+ */
+int fossil_net_server_handoff(
+    const char *path,
+    fossil_net_server_t *const *servers,
+    uint32_t count,
+    uint32_t timeout_ms);
+
+/**
+ * @brief Receive listeners from fossil_net_server_handoff (new side).
+ * servers[i] is NULL for a descriptor that could not be adopted.
+ * @param path    Rendezvous socket path given to the old process.
+ * @param servers Output array.
+ * @param max     Capacity of servers; extra descriptors are closed.
+ * @return Number of entries stored, or -1 on failure.
+ */
+int fossil_net_server_inherit(
+    const char *path,
+    fossil_net_server_t **servers,
+    uint32_t max);
+
 #ifdef __cplusplus
 }
 #include <string>
@@ -138,6 +215,25 @@ namespace fossil::net
             server_ = fossil_net_server_create(type.c_str(), family.c_str(), addr.empty() ? nullptr : addr.c_str(), port);
         }
 
+        /**
+         * @brief Take ownership of an existing server handle, e.g. one from
+         *        fossil_net_server_adopt or fossil_net_server_inherit.
+         */
+        explicit Server(fossil_net_server_t *server) noexcept
+            : server_(server)
+        {
+        }
+
+        /**
+         * @brief Wrap an inherited socket.
+         *
+         * Wraps fossil_net_server_adopt.
+         */
+        static Server adopt(int32_t fd)
+        {
+            return Server(fossil_net_server_adopt(fd));
+        }
+
         /**
          * @brief Destructor. Releases server resources.
          *
@@ -189,6 +285,16 @@ namespace fossil::net
             return fossil_net_server_set_blocking(server_, blocking);
         }
 
+        /**
+         * @brief Get the server's listening socket.
+         *
+         * Wraps fossil_net_server_socket.
+         */
+        fossil_net_socket_t *socket()
+        {
+            return fossil_net_server_socket(server_);
+        }
+
         /**
          * @brief Check if the server is valid.
          */
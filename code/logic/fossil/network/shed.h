@@ -0,0 +1,303 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_SHED_H
+#define FOSSIL_NETWORK_SHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Shedding levels, cumulative: each level also applies the ones below.
+ */
+typedef enum fossil_net_shed_level
+{
+    FOSSIL_NET_SHED_NONE = 0,
+    FOSSIL_NET_SHED_REJECT = 1,       /* answer new work with the canned response */
+    FOSSIL_NET_SHED_PAUSE_ACCEPT = 2, /* leave new connections in the backlog */
+    FOSSIL_NET_SHED_CLOSE_IDLE = 3    /* also close the longest-idle connections */
+} fossil_net_shed_level_t;
+
+/**
+ * @brief Queues whose sojourn time is tracked.
+ */
+typedef enum fossil_net_shed_queue
+{
+    FOSSIL_NET_SHED_ACCEPT = 0,  /* handshake done until the loop owns the connection */
+    FOSSIL_NET_SHED_REQUEST = 1, /* request parsed until a handler starts on it */
+    FOSSIL_NET_SHED_QUEUES
+} fossil_net_shed_queue_t;
+
+/**
+ * @brief Queue-delay based overload detector (CoDel style).
+ *
+ * Queue length says little about overload; time spent queued does. Each
+ * sample is a sojourn time. While every sample of a queue stays above
+ * target for a whole interval, the level rises by one; once samples fall
+ * below target, or none arrive, it drops by one per interval. A standing
+ * queue therefore escalates shedding step by step, while a burst that
+ * drains within an interval triggers nothing.
+ *
+ * Thread-safe: loops record and read concurrently without locks.
+ */
+typedef struct fossil_net_shed fossil_net_shed_t;
+
+/**
+ * @brief Shedder configuration; zero fields take the defaults.
+ */
+typedef struct fossil_net_shed_config
+{
+    uint64_t target_ns;       /* acceptable standing delay, default 5 ms */
+    uint64_t interval_ns;     /* sliding window, default 100 ms */
+    uint32_t max_connections; /* global cap enforced by the reactor, 0 for none */
+    uint32_t close_batch;     /* idle connections closed per loop and interval, default 16 */
+    const void *canned;       /* reject response, default an HTTP 503 */
+    uint32_t canned_len;
+} fossil_net_shed_config_t;
+
+/**
+ * @brief Shedder counters.
+ */
+typedef struct fossil_net_shed_stats
+{
+    uint32_t level;
+    uint64_t samples[FOSSIL_NET_SHED_QUEUES];
+    uint64_t above_target[FOSSIL_NET_SHED_QUEUES];
+    uint64_t max_sojourn_ns[FOSSIL_NET_SHED_QUEUES];
+    uint64_t escalations;
+    uint64_t deescalations;
+    uint64_t admitted;
+    uint64_t rejected;
+} fossil_net_shed_stats_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create a shedder.
+ *
+ * @param config Configuration (may be NULL). The canned response is copied.
+ * @return Shedder, or NULL on failure.
+ */
+fossil_net_shed_t *fossil_net_shed_create(const fossil_net_shed_config_t *config);
+
+/**
+ * @brief Destroy a shedder. Detach it from any reactor first.
+ *
+ * @param shed Shedder (may be NULL).
+ */
+void fossil_net_shed_destroy(fossil_net_shed_t *shed);
+
+/*=============================================================================
+DETECTION
+=============================================================================*/
+
+/**
+ * @brief Record how long one item waited in a queue.
+ *
+ * @param shed       Shedder.
+ * @param queue      Queue the item left.
+ * @param sojourn_ns Time it spent queued.
+ * @param now_ns     Current fossil_net_socket_clock_ns(), or 0 to read it.
+ */
+void fossil_net_shed_record(
+    fossil_net_shed_t *shed,
+    fossil_net_shed_queue_t queue,
+    uint64_t sojourn_ns,
+    uint64_t now_ns);
+
+/**
+ * @brief Current level, applying time-based decay first.
+ *
+ * @param shed   Shedder.
+ * @param now_ns Current fossil_net_socket_clock_ns(), or 0 to read it.
+ * @return fossil_net_shed_level_t value.
+ */
+int fossil_net_shed_level(fossil_net_shed_t *shed, uint64_t now_ns);
+
+/**
+ * @brief Pin the level, e.g. from an operator command or a test.
+ *
+ * @param shed  Shedder.
+ * @param level Level to hold, or -1 to return to automatic detection.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_shed_force(fossil_net_shed_t *shed, int level);
+
+/*=============================================================================
+ADMISSION
+=============================================================================*/
+
+/**
+ * @brief Decide whether to run a new request.
+ *
+ * @param shed Shedder.
+ * @return true to serve it, false to answer with the canned response.
+ */
+bool fossil_net_shed_admit(fossil_net_shed_t *shed);
+
+/**
+ * @brief Canned reject response.
+ *
+ * @param shed Shedder.
+ * @param len  Receives the length in bytes.
+ * @return Response bytes, valid until the shedder is destroyed.
+ */
+const void *fossil_net_shed_canned(const fossil_net_shed_t *shed, uint32_t *len);
+
+/**
+ * @brief Effective configuration, defaults filled in.
+ *
+ * @param shed   Shedder.
+ * @param config Output configuration.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_shed_get_config(
+    const fossil_net_shed_t *shed,
+    fossil_net_shed_config_t *config);
+
+/**
+ * @brief Read counters.
+ *
+ * @param shed  Shedder.
+ * @param stats Output counters.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_shed_get_stats(
+    const fossil_net_shed_t *shed,
+    fossil_net_shed_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Shed
+    {
+    private:
+        fossil_net_shed_t *handle_;
+
+    public:
+        /**
+         * @brief Create a shedder. Wraps fossil_net_shed_create.
+         */
+        explicit Shed(const fossil_net_shed_config_t *config = nullptr)
+            : handle_(fossil_net_shed_create(config))
+        {
+        }
+
+        ~Shed()
+        {
+            if (handle_)
+                fossil_net_shed_destroy(handle_);
+        }
+
+        /**
+         * @brief Record a sojourn time. Wraps fossil_net_shed_record.
+         */
+        void record(fossil_net_shed_queue_t queue, uint64_t sojourn_ns, uint64_t now_ns = 0)
+        {
+            fossil_net_shed_record(handle_, queue, sojourn_ns, now_ns);
+        }
+
+        /**
+         * @brief Current level. Wraps fossil_net_shed_level.
+         */
+        int level(uint64_t now_ns = 0)
+        {
+            return fossil_net_shed_level(handle_, now_ns);
+        }
+
+        /**
+         * @brief Pin the level. Wraps fossil_net_shed_force.
+         */
+        int force(int level)
+        {
+            return fossil_net_shed_force(handle_, level);
+        }
+
+        /**
+         * @brief Admission decision. Wraps fossil_net_shed_admit.
+         */
+        bool admit()
+        {
+            return fossil_net_shed_admit(handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_shed_get_stats.
+         */
+        fossil_net_shed_stats_t stats() const
+        {
+            fossil_net_shed_stats_t s{};
+            fossil_net_shed_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_shed_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Shed(const Shed &) = delete;
+        Shed &operator=(const Shed &) = delete;
+
+        // Allow move
+        Shed(Shed &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Shed &operator=(Shed &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_shed_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_SHED_H */
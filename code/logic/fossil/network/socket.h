@@ -52,13 +52,43 @@ Address Families:
 CORE STRUCTURES
 =============================================================================*/
 
+typedef enum fossil_net_socket_type
+{
+    FOSSIL_NET_SOCKET_TYPE_NONE = 0,
+    FOSSIL_NET_SOCKET_TYPE_TCP,
+    FOSSIL_NET_SOCKET_TYPE_UDP,
+    FOSSIL_NET_SOCKET_TYPE_RAW,
+    FOSSIL_NET_SOCKET_TYPE_ICMP  /* unprivileged ping socket */
+} fossil_net_socket_type_t;
+
+typedef enum fossil_net_socket_family
+{
+    FOSSIL_NET_SOCKET_FAMILY_NONE = 0,
+    FOSSIL_NET_SOCKET_FAMILY_IPV4,
+    FOSSIL_NET_SOCKET_FAMILY_IPV6,
+    FOSSIL_NET_SOCKET_FAMILY_PACKET  /* link layer (AF_PACKET), Linux only */
+} fossil_net_socket_family_t;
+
+/* Socket state bits kept in fossil_net_socket_t::flags */
+#define FOSSIL_NET_SOCKET_FLAG_BLOCKING  0x0001u
+#define FOSSIL_NET_SOCKET_FLAG_BOUND     0x0002u
+#define FOSSIL_NET_SOCKET_FLAG_LISTENING 0x0004u
+#define FOSSIL_NET_SOCKET_FLAG_CONNECTED 0x0008u
+#define FOSSIL_NET_SOCKET_FLAG_RATELIMIT 0x0010u /* a limiter is attached */
+#define FOSSIL_NET_SOCKET_FLAG_TAP       0x0020u /* a pcapng tap is attached */
+
+/*
+ * Compact socket handle (8 bytes). Only the fields touched on every I/O call
+ * live here; the string IDs are derived from the enums on request and the
+ * user-defined ID lives in a side table keyed by descriptor, allocated the
+ * first time fossil_net_socket_set_id is called.
+ */
 typedef struct fossil_net_socket
 {
-    void *handle;    /* OS-specific socket */
-    char id[64];     /* user-defined ID */
-    char type[32];   /* socket type string ID */
-    char family[32]; /* address family string ID */
-    bool blocking;
+    int32_t fd;      /* OS socket handle, -1 when closed */
+    uint8_t type;    /* fossil_net_socket_type_t */
+    uint8_t family;  /* fossil_net_socket_family_t */
+    uint16_t flags;  /* FOSSIL_NET_SOCKET_FLAG_* bits */
 } fossil_net_socket_t;
 
 typedef struct fossil_net_address
@@ -69,6 +99,19 @@ typedef struct fossil_net_address
     char family[32];
 } fossil_net_address_t;
 
+/*
+ * Binary form of an address and port. Cheap to fill from the kernel and to
+ * compare; the string form is only produced when asked for (see inet.h).
+ */
+typedef struct fossil_net_endpoint
+{
+    uint8_t family;    /* fossil_net_socket_family_t */
+    uint8_t reserved;
+    uint16_t port;     /* host byte order */
+    uint32_t scope_id; /* IPv6 scope ID, 0 otherwise */
+    uint8_t ip[16];    /* network byte order, IPv4 uses the first 4 bytes */
+} fossil_net_endpoint_t;
+
 typedef struct fossil_net_mac
 {
     uint8_t bytes[6];
@@ -107,8 +150,14 @@ SOCKET MANAGEMENT
  * @brief Create a new socket.
  *
  * Initializes a socket structure with the specified type and address family.
- * Supported types: "tcp", "udp", "raw".
- * Supported families: "ipv4", "ipv6".
+ * Supported types: "tcp", "udp", "raw", "icmp".
+ * Supported families: "ipv4", "ipv6", "packet".
+ *
+ * The "packet" family opens a Linux AF_PACKET socket receiving all
+ * protocols; "raw" gives whole link-layer frames and "udp" cooked frames.
+ * With "ipv4"/"ipv6", "raw" opens an ICMP/ICMPv6 raw socket (needs
+ * privileges; IPv4 reads include the IP header) and "icmp" an unprivileged
+ * datagram ping socket where available (Linux, macOS).
  *
  * @param sock   Pointer to socket structure to initialize.
  * @param type   Socket type string ID.
@@ -144,6 +193,64 @@ int fossil_net_socket_set_blocking(
     fossil_net_socket_t *sock,
     bool blocking);
 
+/**
+ * @brief Check whether a socket is in blocking mode.
+ *
+ * @param sock Pointer to socket structure.
+ * @return true if blocking, false if non-blocking or sock is NULL.
+ */
+bool fossil_net_socket_is_blocking(
+    const fossil_net_socket_t *sock);
+
+/*=============================================================================
+STRING ID ACCESSORS
+=============================================================================*/
+
+/**
+ * @brief Get the socket type string ID.
+ *
+ * @param sock Pointer to socket structure.
+ * @return "tcp", "udp", "raw", "icmp", or an empty string if unknown.
+ */
+const char *fossil_net_socket_type_id(
+    const fossil_net_socket_t *sock);
+
+/**
+ * @brief Get the address family string ID.
+ *
+ * @param sock Pointer to socket structure.
+ * @return "ipv4", "ipv6", or an empty string if unknown.
+ */
+const char *fossil_net_socket_family_id(
+    const fossil_net_socket_t *sock);
+
+/**
+ * @brief Attach a user-defined ID string to a socket.
+ *
+ * The ID is stored outside the socket structure, keyed by descriptor, and is
+ * dropped when the socket is closed. Passing NULL or "" removes it.
+ *
+ * @param sock Pointer to socket structure.
+ * @param id   ID string (truncated to 63 characters).
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_set_id(
+    fossil_net_socket_t *sock,
+    const char *id);
+
+/**
+ * @brief Copy the user-defined ID string of a socket.
+ *
+ * @param sock   Pointer to socket structure.
+ * @param buffer Output buffer for the ID (empty string if none is set).
+ * @param size   Size of output buffer.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_get_id(
+    const fossil_net_socket_t *sock,
+    char *buffer,
+    uint32_t size);
+
 /*=============================================================================
 CONNECTION
 =============================================================================*/
@@ -203,6 +310,45 @@ int fossil_net_socket_connect(
     fossil_net_socket_t *sock,
     const fossil_net_address_t *addr);
 
+/**
+ * @brief Bind a socket to a binary endpoint.
+ *
+ * @param sock Pointer to socket structure.
+ * @param ep   Pointer to local endpoint.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_bind_endpoint(
+    fossil_net_socket_t *sock,
+    const fossil_net_endpoint_t *ep);
+
+/**
+ * @brief Connect a socket to a binary endpoint.
+ *
+ * @param sock Pointer to socket structure.
+ * @param ep   Pointer to remote endpoint.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_connect_endpoint(
+    fossil_net_socket_t *sock,
+    const fossil_net_endpoint_t *ep);
+
+/**
+ * @brief Accept an incoming connection, reporting the peer in binary form.
+ *
+ * Same as fossil_net_socket_accept but never formats the peer address; call
+ * fossil_net_endpoint_format or fossil_net_endpoint_to_address when the
+ * string is actually needed.
+ *
+ * @param server Pointer to listening socket structure.
+ * @param client Pointer to client socket structure to initialize.
+ * @param peer   Pointer to endpoint to receive peer info (optional).
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_accept_endpoint(
+    fossil_net_socket_t *server,
+    fossil_net_socket_t *client,
+    fossil_net_endpoint_t *peer);
+
 /*=============================================================================
 DATA TRANSFER
 =============================================================================*/
@@ -241,6 +387,43 @@ int fossil_net_socket_receive(
     uint32_t size,
     uint32_t *received);
 
+/**
+ * @brief Send a datagram to a specific endpoint.
+ *
+ * Intended for unconnected "udp" sockets, including sends to a multicast
+ * group. An attached rate limiter is honoured as for fossil_net_socket_send.
+ *
+ * @param sock Pointer to socket structure.
+ * @param data Pointer to data buffer to send.
+ * @param size Size of data buffer in bytes.
+ * @param to   Destination endpoint.
+ * @param sent Pointer to variable to receive number of bytes sent.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_send_to(
+    fossil_net_socket_t *sock,
+    const void *data,
+    uint32_t size,
+    const fossil_net_endpoint_t *to,
+    uint32_t *sent);
+
+/**
+ * @brief Receive a datagram and the endpoint it came from.
+ *
+ * @param sock     Pointer to socket structure.
+ * @param buffer   Pointer to buffer to receive data.
+ * @param size     Size of buffer in bytes.
+ * @param received Pointer to variable to receive number of bytes received.
+ * @param from     Pointer to endpoint to fill with the sender (may be NULL).
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_receive_from(
+    fossil_net_socket_t *sock,
+    void *buffer,
+    uint32_t size,
+    uint32_t *received,
+    fossil_net_endpoint_t *from);
+
 /*=============================================================================
 ADDRESS UTILITIES
 =============================================================================*/
@@ -288,6 +471,55 @@ int fossil_net_socket_get_local_address(
     fossil_net_socket_t *sock,
     fossil_net_address_t *addr);
 
+/**
+ * @brief Get the local endpoint of a socket in binary form.
+ *
+ * @param sock Pointer to socket structure.
+ * @param ep   Pointer to endpoint structure to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_get_local_endpoint(
+    fossil_net_socket_t *sock,
+    fossil_net_endpoint_t *ep);
+
+/**
+ * @brief Get the peer endpoint of a connected socket in binary form.
+ *
+ * @param sock Pointer to socket structure.
+ * @param ep   Pointer to endpoint structure to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_get_peer_endpoint(
+    fossil_net_socket_t *sock,
+    fossil_net_endpoint_t *ep);
+
+/**
+ * @brief Size of a buffer large enough for any native socket address.
+ */
+#define FOSSIL_NET_SOCKADDR_MAX 128
+
+/**
+ * @brief Convert an endpoint to a native socket address.
+ *
+ * @param ep     Pointer to endpoint.
+ * @param native Buffer of at least FOSSIL_NET_SOCKADDR_MAX bytes (struct sockaddr_storage).
+ * @return Length of the native address, or 0 if the endpoint family is invalid.
+ */
+uint32_t fossil_net_endpoint_to_sockaddr(
+    const fossil_net_endpoint_t *ep,
+    void *native);
+
+/**
+ * @brief Convert a native socket address to an endpoint.
+ *
+ * @param ep     Pointer to endpoint structure to fill.
+ * @param native Pointer to a struct sockaddr_in or sockaddr_in6.
+ * @return 0 on success, non-zero if the address family is not IPv4/IPv6.
+ */
+int fossil_net_endpoint_from_sockaddr(
+    fossil_net_endpoint_t *ep,
+    const void *native);
+
 /*=============================================================================
 DNS / HOST
 =============================================================================*/
@@ -331,6 +563,21 @@ int fossil_net_socket_set_reuseaddr(
     fossil_net_socket_t *sock,
     bool enabled);
 
+/**
+ * @brief Enable or disable the SO_REUSEPORT option on a socket.
+ *
+ * Lets several sockets bind the same address and port so the kernel can
+ * spread incoming connections or datagrams across them. Must be set on every
+ * socket in the group before it is bound. Fails where unsupported (Windows).
+ *
+ * @param sock    Pointer to socket structure.
+ * @param enabled true to enable, false to disable.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_set_reuseport(
+    fossil_net_socket_t *sock,
+    bool enabled);
+
 /**
  * @brief Get the peer (remote) address of a connected socket.
  *
@@ -502,6 +749,16 @@ UTILITY
  */
 int fossil_net_socket_sleep(uint32_t ms);
 
+/**
+ * @brief Read a monotonic clock.
+ *
+ * Used for timeouts, rate limiting and latency measurement. The epoch is
+ * unspecified; only differences are meaningful.
+ *
+ * @return Current monotonic time in nanoseconds.
+ */
+uint64_t fossil_net_socket_clock_ns(void);
+
 #ifdef __cplusplus
 }
 #include <string>
@@ -521,6 +778,7 @@ namespace fossil::net
         Socket()
         {
             std::memset(&sock_, 0, sizeof(sock_));
+            sock_.fd = -1;
         }
 
         /**
@@ -594,6 +852,60 @@ namespace fossil::net
             return fossil_net_socket_set_blocking(&sock_, blocking);
         }
 
+        /**
+         * @brief Check whether the socket is in blocking mode.
+         *
+         * @return true if blocking, false otherwise.
+         */
+        bool socket_is_blocking() const
+        {
+            return fossil_net_socket_is_blocking(&sock_);
+        }
+
+        /**
+         * @brief Get the socket type string ID ("tcp", "udp", "raw", "icmp").
+         *
+         * @return Socket type string ID.
+         */
+        std::string socket_type() const
+        {
+            return fossil_net_socket_type_id(&sock_);
+        }
+
+        /**
+         * @brief Get the address family string ID ("ipv4", "ipv6").
+         *
+         * @return Address family string ID.
+         */
+        std::string socket_family() const
+        {
+            return fossil_net_socket_family_id(&sock_);
+        }
+
+        /**
+         * @brief Attach a user-defined ID string to the socket.
+         *
+         * @param id ID string.
+         * @return 0 on success, non-zero on failure.
+         */
+        int socket_set_id(const std::string &id)
+        {
+            return fossil_net_socket_set_id(&sock_, id.c_str());
+        }
+
+        /**
+         * @brief Get the user-defined ID string of the socket.
+         *
+         * @return ID string, empty if none is set.
+         */
+        std::string socket_id() const
+        {
+            char buf[64];
+            if (fossil_net_socket_get_id(&sock_, buf, sizeof(buf)) != 0)
+                return std::string();
+            return buf;
+        }
+
         /**
          * @brief Set SO_REUSEADDR option on the socket.
          *
@@ -607,6 +919,19 @@ namespace fossil::net
             return fossil_net_socket_set_reuseaddr(&sock_, enabled);
         }
 
+        /**
+         * @brief Set SO_REUSEPORT option on the socket.
+         *
+         * Lets several sockets share one address and port.
+         *
+         * @param enabled true to enable, false to disable.
+         * @return 0 on success, non-zero on failure.
+         */
+        int socket_set_reuseport(bool enabled)
+        {
+            return fossil_net_socket_set_reuseport(&sock_, enabled);
+        }
+
         /**
          * @brief Get the local address of the socket.
          *
@@ -674,6 +999,29 @@ namespace fossil::net
             return fossil_net_socket_accept(&sock_, &client.sock_, addr);
         }
 
+        /**
+         * @brief Accept an incoming connection without formatting the peer address.
+         *
+         * @param client Reference to client socket to initialize.
+         * @param peer   Pointer to endpoint to receive peer info (optional).
+         * @return 0 on success, non-zero on failure.
+         */
+        int socket_accept_endpoint(Socket &client, fossil_net_endpoint_t *peer)
+        {
+            return fossil_net_socket_accept_endpoint(&sock_, &client.sock_, peer);
+        }
+
+        /**
+         * @brief Get the peer endpoint of the connected socket in binary form.
+         *
+         * @param ep Pointer to endpoint structure to fill.
+         * @return 0 on success, non-zero on failure.
+         */
+        int socket_get_peer_endpoint(fossil_net_endpoint_t *ep)
+        {
+            return fossil_net_socket_get_peer_endpoint(&sock_, ep);
+        }
+
         /**
          * @brief Connect the socket to a remote address.
          *
@@ -717,6 +1065,22 @@ namespace fossil::net
             return fossil_net_socket_receive(&sock_, buffer, size, received);
         }
 
+        /**
+         * @brief Send a datagram to an endpoint. Wraps fossil_net_socket_send_to.
+         */
+        int socket_send_to(const void *data, uint32_t size, const fossil_net_endpoint_t *to, uint32_t *sent)
+        {
+            return fossil_net_socket_send_to(&sock_, data, size, to, sent);
+        }
+
+        /**
+         * @brief Receive a datagram and its sender. Wraps fossil_net_socket_receive_from.
+         */
+        int socket_receive_from(void *buffer, uint32_t size, uint32_t *received, fossil_net_endpoint_t *from)
+        {
+            return fossil_net_socket_receive_from(&sock_, buffer, size, received, from);
+        }
+
         /**
          * @brief Get a pointer to the native socket structure.
          *
@@ -0,0 +1,286 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_TAP_H
+#define FOSSIL_NETWORK_TAP_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Tap settings; zero fields take the defaults.
+ */
+typedef struct fossil_net_tap_config
+{
+    uint32_t ring_size;   /* bytes per recording thread, default 1 MiB */
+    uint32_t snaplen;     /* max bytes kept per record, default 65535 */
+    uint32_t max_threads; /* recording threads, default 64 */
+    uint32_t flush_ms;    /* longest time data waits in the write buffer, default 200 */
+} fossil_net_tap_config_t;
+
+typedef enum fossil_net_tap_direction
+{
+    FOSSIL_NET_TAP_INBOUND = 1,
+    FOSSIL_NET_TAP_OUTBOUND = 2
+} fossil_net_tap_direction_t;
+
+/**
+ * @brief Tap counters.
+ */
+typedef struct fossil_net_tap_stats
+{
+    uint64_t records;      /* records accepted by the rings */
+    uint64_t dropped;      /* records lost to full rings or too many threads */
+    uint64_t packets;      /* packet blocks written */
+    uint64_t bytes;        /* bytes written to the file */
+    uint64_t write_errors;
+} fossil_net_tap_stats_t;
+
+/**
+ * @brief Opaque pcapng tap.
+ *
+ * Each recording thread gets its own single-producer ring, so recording is
+ * a timestamp, a bounds check and a memcpy with no lock or syscall. A
+ * background thread drains the rings into a large write buffer and turns
+ * socket payloads into synthetic IPv4/IPv6 + TCP/UDP packets (interface 0,
+ * LINKTYPE_RAW) so Wireshark dissects the application protocol; raw frames
+ * go to interface 1 (LINKTYPE_ETHERNET). Timestamps are in nanoseconds.
+ */
+typedef struct fossil_net_tap fossil_net_tap_t;
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+/**
+ * @brief Create a pcapng file and start its writer thread.
+ *
+ * @param path   Output file, truncated if it exists.
+ * @param config Settings, or NULL for defaults.
+ * @return Tap, or NULL on failure.
+ */
+fossil_net_tap_t *fossil_net_tap_create(
+    const char *path,
+    const fossil_net_tap_config_t *config);
+
+/**
+ * @brief Drain all rings, close the file and free the tap.
+ *
+ * Detach the tap from every socket first.
+ *
+ * @param tap Tap to destroy.
+ */
+void fossil_net_tap_destroy(fossil_net_tap_t *tap);
+
+/**
+ * @brief Wait until everything recorded so far is written to the file.
+ *
+ * @param tap Tap.
+ * @return 0 on success, -1 on error.
+ */
+int fossil_net_tap_flush(fossil_net_tap_t *tap);
+
+/*=============================================================================
+RECORDING
+=============================================================================*/
+
+/**
+ * @brief Record a socket payload.
+ *
+ * @param tap       Tap.
+ * @param direction Inbound or outbound relative to local.
+ * @param proto     6 (TCP) or 17 (UDP), used for the synthetic header.
+ * @param local     Local endpoint.
+ * @param remote    Remote endpoint (same family as local).
+ * @param data      Payload.
+ * @param length    Payload length.
+ * @return 0 if recorded, -1 if dropped.
+ */
+int fossil_net_tap_record(
+    fossil_net_tap_t *tap,
+    fossil_net_tap_direction_t direction,
+    uint8_t proto,
+    const fossil_net_endpoint_t *local,
+    const fossil_net_endpoint_t *remote,
+    const void *data,
+    uint32_t length);
+
+/**
+ * @brief Record a whole Ethernet frame (e.g. from a capture ring).
+ *
+ * @param tap       Tap.
+ * @param direction Inbound or outbound.
+ * @param frame     Frame bytes.
+ * @param length    Frame length.
+ * @return 0 if recorded, -1 if dropped.
+ */
+int fossil_net_tap_record_frame(
+    fossil_net_tap_t *tap,
+    fossil_net_tap_direction_t direction,
+    const void *frame,
+    uint32_t length);
+
+/**
+ * @brief Read tap counters.
+ *
+ * @param tap   Tap.
+ * @param stats Stats out.
+ * @return 0 on success, -1 on error.
+ */
+int fossil_net_tap_get_stats(
+    fossil_net_tap_t *tap,
+    fossil_net_tap_stats_t *stats);
+
+/*=============================================================================
+SOCKET ATTACHMENT
+=============================================================================*/
+
+/**
+ * @brief Tap a socket's traffic, or stop with NULL.
+ *
+ * Successful sends and receives on TCP and UDP sockets are recorded as
+ * payloads; "packet" family sockets are recorded as frames. The local and
+ * peer addresses are looked up once here, so attach after connect/accept;
+ * send_to/receive_from record their explicit peer.
+ *
+ * @param sock Pointer to socket structure.
+ * @param tap  Tap, or NULL to detach.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_socket_set_tap(
+    fossil_net_socket_t *sock,
+    fossil_net_tap_t *tap);
+
+/**
+ * @brief Get the tap attached to a socket.
+ *
+ * @param sock Pointer to socket structure.
+ * @return Pointer to tap, or NULL if none is attached.
+ */
+fossil_net_tap_t *fossil_net_socket_get_tap(
+    const fossil_net_socket_t *sock);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class Tap
+    {
+    private:
+        fossil_net_tap_t *handle_;
+
+    public:
+        /**
+         * @brief Create a pcapng file. Wraps fossil_net_tap_create.
+         */
+        explicit Tap(const char *path, const fossil_net_tap_config_t *config = nullptr)
+            : handle_(fossil_net_tap_create(path, config))
+        {
+        }
+
+        ~Tap()
+        {
+            if (handle_)
+                fossil_net_tap_destroy(handle_);
+        }
+
+        /**
+         * @brief Tap a socket. Wraps fossil_net_socket_set_tap.
+         */
+        int attach(fossil_net_socket_t *sock)
+        {
+            return fossil_net_socket_set_tap(sock, handle_);
+        }
+
+        /**
+         * @brief Record a frame. Wraps fossil_net_tap_record_frame.
+         */
+        int record_frame(fossil_net_tap_direction_t direction, const void *frame, uint32_t length)
+        {
+            return fossil_net_tap_record_frame(handle_, direction, frame, length);
+        }
+
+        /**
+         * @brief Write out pending records. Wraps fossil_net_tap_flush.
+         */
+        int flush()
+        {
+            return fossil_net_tap_flush(handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_tap_get_stats.
+         */
+        fossil_net_tap_stats_t stats()
+        {
+            fossil_net_tap_stats_t s{};
+            fossil_net_tap_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_tap_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        Tap(const Tap &) = delete;
+        Tap &operator=(const Tap &) = delete;
+
+        // Allow move
+        Tap(Tap &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        Tap &operator=(Tap &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_tap_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_TAP_H */
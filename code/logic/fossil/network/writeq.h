@@ -0,0 +1,413 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_WRITEQ_H
+#define FOSSIL_NETWORK_WRITEQ_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Reference-counted byte buffer.
+ *
+ * A buffer queued on one or more write queues is shared, not copied: each
+ * queue holds a reference until the bytes it covers are on the wire. The
+ * count is atomic, so one buffer (a cached response, say) may be queued on
+ * connections owned by different threads. Do not modify a buffer's bytes
+ * once it has been queued.
+ */
+typedef struct fossil_net_buf fossil_net_buf_t;
+
+/**
+ * @brief Release function for memory wrapped by fossil_net_buf_wrap().
+ */
+typedef void (*fossil_net_buf_free_fn)(void *data, void *ctx);
+
+/**
+ * @brief Ordered queue of unsent bytes for one non-blocking socket.
+ *
+ * Data is held as a chain of (buffer, offset, length) segments and flushed
+ * with one gathered send per call where the platform allows it (sendmsg,
+ * WSASend). Writes on an empty queue go straight to the socket; only what
+ * the kernel does not take is queued. Small copied writes are coalesced
+ * into the tail block.
+ *
+ * Not thread-safe: a queue belongs to the thread that owns its socket.
+ */
+typedef struct fossil_net_writeq fossil_net_writeq_t;
+
+/**
+ * @brief Watermark notification.
+ *
+ * Called with above = true when pending bytes reach the high watermark and
+ * with above = false once a flush brings them down to the low watermark.
+ * Producers pause between the two.
+ */
+typedef void (*fossil_net_writeq_watermark_fn)(fossil_net_writeq_t *queue, bool above, void *arg);
+
+/**
+ * @brief Queue configuration. Zero fields select the defaults.
+ */
+typedef struct fossil_net_writeq_config
+{
+    uint64_t high_watermark;  /* default 1 MiB */
+    uint64_t low_watermark;   /* default high / 4 */
+    uint64_t limit;           /* hard cap on pending bytes, 0 for none */
+    uint32_t block_size;      /* copy block size, default 16 KiB */
+} fossil_net_writeq_config_t;
+
+/**
+ * @brief Queue counters.
+ */
+typedef struct fossil_net_writeq_stats
+{
+    uint64_t pending;       /* bytes queued right now */
+    uint64_t peak;          /* highest pending seen */
+    uint64_t written;       /* bytes accepted by write/append */
+    uint64_t direct;        /* bytes sent without being queued */
+    uint64_t sent;          /* bytes sent by flushes */
+    uint64_t syscalls;      /* send calls made by flushes */
+    uint64_t high_events;
+    uint64_t low_events;
+    uint64_t rejected;      /* writes refused by the limit */
+    uint64_t file_bytes;    /* bytes sent from file segments */
+} fossil_net_writeq_stats_t;
+
+/*=============================================================================
+BUFFERS
+=============================================================================*/
+
+/**
+ * @brief Allocate a buffer with inline storage.
+ *
+ * @param capacity Storage size in bytes.
+ * @return Buffer with one reference and size 0, or NULL on failure.
+ */
+fossil_net_buf_t *fossil_net_buf_create(uint32_t capacity);
+
+/**
+ * @brief Wrap caller-owned memory without copying.
+ *
+ * @param data    Bytes to wrap.
+ * @param size    Number of bytes.
+ * @param free_fn Called with (data, ctx) when the last reference drops;
+ *                NULL for memory that outlives every queue.
+ * @param ctx     Release context.
+ * @return Buffer with one reference, or NULL on failure.
+ */
+fossil_net_buf_t *fossil_net_buf_wrap(
+    const void *data,
+    uint32_t size,
+    fossil_net_buf_free_fn free_fn,
+    void *ctx);
+
+/**
+ * @brief Take a reference.
+ *
+ * @param buf Buffer.
+ * @return buf.
+ */
+fossil_net_buf_t *fossil_net_buf_ref(fossil_net_buf_t *buf);
+
+/**
+ * @brief Drop a reference; the buffer is freed with the last one.
+ *
+ * @param buf Buffer (may be NULL).
+ */
+void fossil_net_buf_unref(fossil_net_buf_t *buf);
+
+/**
+ * @brief Buffer bytes.
+ *
+ * @param buf Buffer.
+ * @return Pointer to the first byte.
+ */
+void *fossil_net_buf_data(fossil_net_buf_t *buf);
+
+/**
+ * @brief Number of valid bytes.
+ *
+ * @param buf Buffer.
+ * @return Size in bytes.
+ */
+uint32_t fossil_net_buf_size(const fossil_net_buf_t *buf);
+
+/**
+ * @brief Set the number of valid bytes of an inline buffer.
+ *
+ * @param buf  Buffer from fossil_net_buf_create().
+ * @param size New size, at most the capacity.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_buf_set_size(fossil_net_buf_t *buf, uint32_t size);
+
+/*=============================================================================
+QUEUES
+=============================================================================*/
+
+/**
+ * @brief Create a write queue for a socket.
+ *
+ * The socket should be non-blocking; on a blocking socket a flush waits
+ * for the kernel like fossil_net_socket_send. Sockets with a rate limiter
+ * or tap attached are flushed through fossil_net_socket_send, one segment
+ * per call, so both keep seeing every byte.
+ *
+ * @param sock   Connected socket; must outlive the queue.
+ * @param config Configuration (may be NULL).
+ * @param fn     Watermark callback (may be NULL).
+ * @param arg    Callback argument.
+ * @return Queue, or NULL on failure.
+ */
+fossil_net_writeq_t *fossil_net_writeq_create(
+    fossil_net_socket_t *sock,
+    const fossil_net_writeq_config_t *config,
+    fossil_net_writeq_watermark_fn fn,
+    void *arg);
+
+/**
+ * @brief Destroy a queue, dropping unsent data. The socket is not closed.
+ *
+ * @param queue Queue (may be NULL).
+ */
+void fossil_net_writeq_destroy(fossil_net_writeq_t *queue);
+
+/**
+ * @brief Write bytes, sending what the socket takes now and copying the rest.
+ *
+ * @param queue Queue.
+ * @param data  Bytes to write.
+ * @param size  Number of bytes.
+ * @return 0 on success, -1 on a socket error or when the limit would be
+ *         exceeded (nothing is written then).
+ */
+int fossil_net_writeq_write(
+    fossil_net_writeq_t *queue,
+    const void *data,
+    uint32_t size);
+
+/**
+ * @brief Queue part of a buffer without copying; takes its own reference.
+ *
+ * @param queue  Queue.
+ * @param buf    Buffer.
+ * @param offset First byte.
+ * @param size   Number of bytes; offset + size must not exceed the buffer.
+ * @return 0 on success, -1 on failure as for fossil_net_writeq_write.
+ */
+int fossil_net_writeq_append(
+    fossil_net_writeq_t *queue,
+    fossil_net_buf_t *buf,
+    uint32_t offset,
+    uint32_t size);
+
+/**
+ * @brief Queue a byte range of an open file, sent without copying it
+ *        through user space where the platform allows (sendfile).
+ *
+ * File bytes count towards pending and the watermarks but not towards
+ * the limit, which bounds memory.
+ *
+ * @param queue  Queue.
+ * @param owner  Buffer whose lifetime keeps fd open; the queue holds a
+ *               reference until the range is sent (may be NULL if the
+ *               caller keeps fd open longer than the queue).
+ * @param fd     Open file descriptor, read with positional reads only.
+ * @param offset First byte in the file.
+ * @param size   Number of bytes.
+ * @return 0 on success, -1 on failure as for fossil_net_writeq_write.
+ */
+int fossil_net_writeq_append_file(
+    fossil_net_writeq_t *queue,
+    fossil_net_buf_t *owner,
+    int32_t fd,
+    uint64_t offset,
+    uint64_t size);
+
+/**
+ * @brief Send queued bytes until the queue is empty or the socket is full.
+ *
+ * @param queue Queue.
+ * @return 0 if the queue is empty, 1 if data remains (wait for writable),
+ *         -1 on a socket error. Errors are sticky.
+ */
+int fossil_net_writeq_flush(fossil_net_writeq_t *queue);
+
+/**
+ * @brief Number of bytes waiting to be sent.
+ *
+ * @param queue Queue.
+ * @return Pending bytes.
+ */
+uint64_t fossil_net_writeq_pending(const fossil_net_writeq_t *queue);
+
+/**
+ * @brief Whether the queue is between its high and low watermark.
+ *
+ * @param queue Queue.
+ * @return True while producers should pause.
+ */
+bool fossil_net_writeq_is_above(const fossil_net_writeq_t *queue);
+
+/**
+ * @brief Read counters.
+ *
+ * @param queue Queue.
+ * @param stats Output counters.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_writeq_get_stats(
+    const fossil_net_writeq_t *queue,
+    fossil_net_writeq_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class WriteQueue
+    {
+    private:
+        fossil_net_writeq_t *handle_;
+
+    public:
+        /**
+         * @brief Create a queue. Wraps fossil_net_writeq_create.
+         */
+        explicit WriteQueue(fossil_net_socket_t *sock,
+                            const fossil_net_writeq_config_t *config = nullptr,
+                            fossil_net_writeq_watermark_fn fn = nullptr,
+                            void *arg = nullptr)
+            : handle_(fossil_net_writeq_create(sock, config, fn, arg))
+        {
+        }
+
+        ~WriteQueue()
+        {
+            if (handle_)
+                fossil_net_writeq_destroy(handle_);
+        }
+
+        /**
+         * @brief Write bytes. Wraps fossil_net_writeq_write.
+         */
+        int write(const void *data, uint32_t size)
+        {
+            return fossil_net_writeq_write(handle_, data, size);
+        }
+
+        /**
+         * @brief Queue a shared buffer. Wraps fossil_net_writeq_append.
+         */
+        int append(fossil_net_buf_t *buf, uint32_t offset, uint32_t size)
+        {
+            return fossil_net_writeq_append(handle_, buf, offset, size);
+        }
+
+        /**
+         * @brief Queue a file range. Wraps fossil_net_writeq_append_file.
+         */
+        int append_file(fossil_net_buf_t *owner, int32_t fd, uint64_t offset, uint64_t size)
+        {
+            return fossil_net_writeq_append_file(handle_, owner, fd, offset, size);
+        }
+
+        /**
+         * @brief Send queued bytes. Wraps fossil_net_writeq_flush.
+         */
+        int flush()
+        {
+            return fossil_net_writeq_flush(handle_);
+        }
+
+        /**
+         * @brief Pending bytes. Wraps fossil_net_writeq_pending.
+         */
+        uint64_t pending() const
+        {
+            return fossil_net_writeq_pending(handle_);
+        }
+
+        /**
+         * @brief Watermark state. Wraps fossil_net_writeq_is_above.
+         */
+        bool is_above() const
+        {
+            return fossil_net_writeq_is_above(handle_);
+        }
+
+        /**
+         * @brief Read counters. Wraps fossil_net_writeq_get_stats.
+         */
+        fossil_net_writeq_stats_t stats() const
+        {
+            fossil_net_writeq_stats_t s{};
+            fossil_net_writeq_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_writeq_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        WriteQueue(const WriteQueue &) = delete;
+        WriteQueue &operator=(const WriteQueue &) = delete;
+
+        // Allow move
+        WriteQueue(WriteQueue &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        WriteQueue &operator=(WriteQueue &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_writeq_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_WRITEQ_H */
@@ -0,0 +1,217 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_NETWORK_ZEROCOPY_H
+#define FOSSIL_NETWORK_ZEROCOPY_H
+
+#include "socket.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+CORE STRUCTURES
+=============================================================================*/
+
+/**
+ * @brief Opaque zero-copy receiver bound to one connected "tcp" socket.
+ *
+ * On Linux the receiver maps the socket's receive queue pages into a
+ * read-only window with TCP_ZEROCOPY_RECEIVE instead of copying them. Data
+ * that is not page aligned (the head or tail of a run) and platforms
+ * without the feature fall back to an ordinary copy into an internal buffer.
+ */
+typedef struct fossil_net_zerocopy fossil_net_zerocopy_t;
+
+/**
+ * @brief Data returned by one receive, in stream order: mapped bytes first,
+ * then copied bytes. Both pointers stay valid until the next receive or
+ * until the receiver is destroyed.
+ */
+typedef struct fossil_net_zerocopy_chunk
+{
+    const void *mapped;   /* pages mapped from the receive queue, or NULL */
+    uint32_t mapped_len;  /* bytes at mapped */
+    const void *copied;   /* copied tail in the receiver's buffer, or NULL */
+    uint32_t copied_len;  /* bytes at copied */
+} fossil_net_zerocopy_chunk_t;
+
+typedef struct fossil_net_zerocopy_stats
+{
+    uint64_t bytes_mapped; /* bytes delivered without a copy */
+    uint64_t bytes_copied; /* bytes delivered through the copy fallback */
+    uint64_t map_calls;    /* successful TCP_ZEROCOPY_RECEIVE calls that mapped data */
+} fossil_net_zerocopy_stats_t;
+
+/*=============================================================================
+RECEIVER
+=============================================================================*/
+
+/**
+ * @brief Create a zero-copy receiver for a connected TCP socket.
+ *
+ * @param sock      Pointer to a connected "tcp" socket; must outlive the receiver.
+ * @param window    Size of the mapping window in bytes, rounded up to whole
+ *                  pages; 0 selects 256 KiB.
+ * @param copy_size Size of the copy buffer for unaligned data; 0 selects 64 KiB.
+ * @return Pointer to receiver, or NULL on failure.
+ */
+fossil_net_zerocopy_t *fossil_net_zerocopy_create(
+    fossil_net_socket_t *sock,
+    uint32_t window,
+    uint32_t copy_size);
+
+/**
+ * @brief Destroy a receiver and unmap its window. The socket is not closed.
+ *
+ * @param zc Pointer to receiver.
+ */
+void fossil_net_zerocopy_destroy(fossil_net_zerocopy_t *zc);
+
+/**
+ * @brief Check whether the receiver maps pages or only copies.
+ *
+ * @param zc Pointer to receiver.
+ * @return True if a mapping window is active.
+ */
+bool fossil_net_zerocopy_is_mapped(const fossil_net_zerocopy_t *zc);
+
+/**
+ * @brief Receive the next run of stream data.
+ *
+ * Previously returned data is released (the window is remapped) first.
+ * When nothing can be mapped the call behaves like fossil_net_socket_receive
+ * into the copy buffer, including blocking on a blocking socket. Both
+ * lengths are zero after the peer closed the connection.
+ *
+ * @param zc    Pointer to receiver.
+ * @param chunk Pointer to chunk to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_zerocopy_receive(
+    fossil_net_zerocopy_t *zc,
+    fossil_net_zerocopy_chunk_t *chunk);
+
+/**
+ * @brief Read the receiver counters.
+ *
+ * @param zc    Pointer to receiver.
+ * @param stats Pointer to stats structure to fill.
+ * @return 0 on success, non-zero on failure.
+ */
+int fossil_net_zerocopy_get_stats(
+    const fossil_net_zerocopy_t *zc,
+    fossil_net_zerocopy_stats_t *stats);
+
+#ifdef __cplusplus
+}
+
+namespace fossil::net
+{
+
+    class ZeroCopy
+    {
+    private:
+        fossil_net_zerocopy_t *handle_;
+
+    public:
+        /**
+         * @brief Construct a receiver. Wraps fossil_net_zerocopy_create.
+         */
+        explicit ZeroCopy(fossil_net_socket_t *sock, uint32_t window = 0, uint32_t copy_size = 0)
+            : handle_(fossil_net_zerocopy_create(sock, window, copy_size))
+        {}
+
+        /**
+         * @brief Destroy the receiver. Wraps fossil_net_zerocopy_destroy.
+         */
+        ~ZeroCopy()
+        {
+            if (handle_)
+                fossil_net_zerocopy_destroy(handle_);
+        }
+
+        /**
+         * @brief Receive the next run. Wraps fossil_net_zerocopy_receive.
+         */
+        int receive(fossil_net_zerocopy_chunk_t *chunk)
+        {
+            return fossil_net_zerocopy_receive(handle_, chunk);
+        }
+
+        /**
+         * @brief Check for an active mapping window. Wraps fossil_net_zerocopy_is_mapped.
+         */
+        bool is_mapped() const
+        {
+            return fossil_net_zerocopy_is_mapped(handle_);
+        }
+
+        /**
+         * @brief Read the counters. Wraps fossil_net_zerocopy_get_stats.
+         */
+        fossil_net_zerocopy_stats_t stats() const
+        {
+            fossil_net_zerocopy_stats_t s = {0, 0, 0};
+            fossil_net_zerocopy_get_stats(handle_, &s);
+            return s;
+        }
+
+        /**
+         * @brief Get the underlying C handle.
+         */
+        fossil_net_zerocopy_t *native_handle() const
+        {
+            return handle_;
+        }
+
+        // Disable copy
+        ZeroCopy(const ZeroCopy &) = delete;
+        ZeroCopy &operator=(const ZeroCopy &) = delete;
+
+        // Allow move
+        ZeroCopy(ZeroCopy &&other) noexcept : handle_(other.handle_)
+        {
+            other.handle_ = nullptr;
+        }
+        ZeroCopy &operator=(ZeroCopy &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    fossil_net_zerocopy_destroy(handle_);
+                handle_ = other.handle_;
+                other.handle_ = nullptr;
+            }
+            return *this;
+        }
+    };
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_NETWORK_ZEROCOPY_H */
@@ -0,0 +1,990 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/httpd.h"
+#include "fossil/network/socket.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+#define FOSSIL__HTTPD_MAX_HEAD     (16u * 1024u)
+#define FOSSIL__HTTPD_MAX_BODY     (1024u * 1024u)
+#define FOSSIL__HTTPD_MAX_PIPELINE 16u
+#define FOSSIL__HTTPD_READ_CHUNK   (16u * 1024u)
+#define FOSSIL__HTTPD_MAX_KEY      2048u
+#define FOSSIL__HTTPD_COPY_MAX     (16u * 1024u) /* larger cached bodies go by reference */
+#define FOSSIL__HTTPD_MAX_LABELS   512u
+#define FOSSIL__HTTPD_LATENCY      "fossil_net_http_request_duration_seconds"
+
+enum
+{
+    FOSSIL__EX_FREE = 0,
+    FOSSIL__EX_ACTIVE,
+    FOSSIL__EX_DONE
+};
+
+typedef struct fossil__http_route
+{
+    fossil_net_http_handler_fn fn;
+    void *user;
+    struct fossil__http_route *next;
+    fossil_net_metric_t *latency;   /* set while metrics are attached */
+    fossil_net_http_method_t method;
+    char pattern[];
+} fossil__http_route_t;
+
+typedef struct fossil__http_buf
+{
+    char *p;
+    uint32_t len;
+    uint32_t cap;
+} fossil__http_buf_t;
+
+/*
+ * A range sent by reference after the first at bytes of its output: a
+ * file range, or with fd -1 a range of owner's memory.
+ */
+typedef struct fossil__http_seg
+{
+    uint32_t at;
+    int32_t fd;
+    fossil_net_buf_t *owner;
+    uint64_t offset;
+    uint64_t len;
+} fossil__http_seg_t;
+
+typedef struct fossil__http_out
+{
+    fossil__http_buf_t bytes;
+    fossil__http_seg_t *segs;
+    uint32_t nsegs;
+    uint32_t cap_segs;
+} fossil__http_out_t;
+
+/* Written by one loop thread only; padded to keep loops off each other's lines. */
+typedef struct fossil__httpd_counters
+{
+    _Atomic uint64_t requests;
+    _Atomic uint64_t reused;
+    _Atomic uint64_t pipelined;
+    _Atomic uint64_t flushes;
+    _Atomic uint64_t errors;
+    _Atomic uint64_t shed;
+    char pad[16];
+} fossil__httpd_counters_t;
+
+typedef struct fossil__http_conn fossil__http_conn_t;
+
+struct fossil_net_http_exchange
+{
+    fossil__http_conn_t *hc;
+    fossil_net_slice_t body;
+    fossil_net_route_match_t match;
+    fossil__http_buf_t headers;     /* added response headers */
+    fossil__http_out_t resp;        /* response finished ahead of its turn */
+    fossil__http_buf_t cache_key;   /* set on a cache miss worth storing */
+    fossil_net_metric_t *latency;   /* observed when the exchange finishes */
+    uint64_t start_ns;
+    uint8_t state;
+    uint8_t version_minor;
+    bool head;                      /* HEAD: send headers only */
+    bool keep_alive;
+};
+
+struct fossil__http_conn
+{
+    fossil_net_httpd_t *httpd;
+    fossil_net_conn_t *conn;
+    fossil__httpd_counters_t *stats;
+    fossil_net_parser_t parser;
+    fossil_net_http_request_t req;
+    fossil__http_buf_t in;
+    uint32_t in_off;                /* start of the request being parsed */
+    uint32_t head_len;              /* its head length once parsed, else 0 */
+    uint32_t body_len;              /* body bytes; de-chunked so far if chunked */
+    fossil__http_out_t out;         /* responses of the current batch */
+    fossil_net_http_exchange_t *slots; /* ring of max_pipeline, request order */
+    uint32_t slot_head;
+    uint32_t slot_count;
+    uint32_t served;
+    uint32_t batch;                 /* requests dispatched since the last read */
+    uint64_t read_ns;               /* last read, tracked while shedding */
+    bool in_batch;
+    bool stop;                      /* parse no further requests */
+    bool closing;                   /* a closing response is queued */
+    bool eof;
+    bool wm_above;                  /* write queue above its high watermark */
+    bool paused;
+    bool draining;                  /* close once nothing is in progress */
+};
+
+struct fossil_net_httpd
+{
+    fossil_net_reactor_t *reactor;
+    fossil_net_router_t *router;
+    fossil__http_route_t *routes;
+    fossil_net_shed_t *shed;
+    fossil_net_cache_t *cache;
+    fossil_net_metrics_t *metrics;
+    fossil_net_metric_t *cached_latency;    /* answered from the cache */
+    fossil_net_metric_t *unmatched_latency; /* answered with 404 or 405 */
+    char *metric_labels;
+    fossil__httpd_counters_t *counters;
+    uint32_t loops;
+    bool running;
+    fossil_net_httpd_config_t config;
+};
+
+static inline void fossil__hcount(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static int fossil__buf_reserve(fossil__http_buf_t *b, uint64_t extra) {
+    if ((uint64_t)b->cap - b->len >= extra) return 0;
+    uint64_t need = (uint64_t)b->len + extra;
+    if (need > UINT32_MAX) return -1;
+    uint64_t cap = b->cap ? b->cap : 256u;
+    while (cap < need) cap *= 2u;
+    if (cap > UINT32_MAX) cap = need;
+    char *p = realloc(b->p, (size_t)cap);
+    if (!p) return -1;
+    b->p = p;
+    b->cap = (uint32_t)cap;
+    return 0;
+}
+
+static void fossil__buf_put(fossil__http_buf_t *b, const void *data, uint32_t n) {
+    if (n) memcpy(b->p + b->len, data, n);
+    b->len += n;
+}
+
+static void fossil__buf_puts(fossil__http_buf_t *b, const char *s) {
+    fossil__buf_put(b, s, (uint32_t)strlen(s));
+}
+
+static bool fossil__out_empty(const fossil__http_out_t *o) {
+    return o->bytes.len == 0 && o->nsegs == 0;
+}
+
+static int fossil__out_seg(fossil__http_out_t *o, fossil_net_buf_t *owner, int32_t fd, uint64_t offset, uint64_t len) {
+    if (o->nsegs == o->cap_segs) {
+        uint32_t cap = o->cap_segs ? o->cap_segs * 2u : 4u;
+        fossil__http_seg_t *f = realloc(o->segs, cap * sizeof(*f));
+        if (!f) return -1;
+        o->segs = f;
+        o->cap_segs = cap;
+    }
+    fossil__http_seg_t *f = &o->segs[o->nsegs++];
+    f->at = o->bytes.len;
+    f->fd = fd;
+    f->owner = fossil_net_buf_ref(owner);
+    f->offset = offset;
+    f->len = len;
+    return 0;
+}
+
+static void fossil__out_clear(fossil__http_out_t *o) {
+    for (uint32_t i = 0; i < o->nsegs; i++)
+        fossil_net_buf_unref(o->segs[i].owner);
+    o->nsegs = 0;
+    o->bytes.len = 0;
+}
+
+static void fossil__out_free(fossil__http_out_t *o) {
+    fossil__out_clear(o);
+    free(o->segs);
+    free(o->bytes.p);
+}
+
+/* Append src to dst and empty src; file references move with it. */
+static int fossil__out_move(fossil__http_out_t *dst, fossil__http_out_t *src) {
+    uint32_t base = dst->bytes.len;
+    if (fossil__buf_reserve(&dst->bytes, src->bytes.len) != 0) return -1;
+    for (uint32_t i = 0; i < src->nsegs; i++) {
+        const fossil__http_seg_t *f = &src->segs[i];
+        if (fossil__out_seg(dst, f->owner, f->fd, f->offset, f->len) != 0) {
+            while (i--) fossil_net_buf_unref(dst->segs[--dst->nsegs].owner);
+            return -1;
+        }
+        dst->segs[dst->nsegs - 1u].at = base + f->at;
+    }
+    fossil__buf_put(&dst->bytes, src->bytes.p, src->bytes.len);
+    fossil__out_clear(src);
+    return 0;
+}
+
+/*=============================================================================
+RESPONSES
+=============================================================================*/
+
+static void fossil__http_run(fossil__http_conn_t *hc);
+
+static bool fossil__http_turn(const fossil_net_http_exchange_t *ex) {
+    return ex == &ex->hc->slots[ex->hc->slot_head];
+}
+
+/* Move finished responses to the batch in request order. */
+static void fossil__http_complete(fossil__http_conn_t *hc) {
+    uint32_t max = hc->httpd->config.max_pipeline;
+    while (hc->slot_count && !hc->closing) {
+        fossil_net_http_exchange_t *ex = &hc->slots[hc->slot_head];
+        if (ex->state != FOSSIL__EX_DONE) break;
+        if (!fossil__out_empty(&ex->resp) && fossil__out_move(&hc->out, &ex->resp) != 0) {
+            fossil__out_clear(&ex->resp);
+            ex->keep_alive = false;
+        }
+        ex->state = FOSSIL__EX_FREE;
+        hc->slot_head = (hc->slot_head + 1u) % max;
+        hc->slot_count--;
+        /* Anything after a closing response is never sent. */
+        if (!ex->keep_alive) hc->closing = true;
+    }
+}
+
+/*
+ * Write the status line and headers for a body of length bytes, with room
+ * reserved for extra more; returns where the body goes, or NULL.
+ */
+static fossil__http_out_t *fossil__http_emit_head(
+    fossil_net_http_exchange_t *ex,
+    int status,
+    const char *content_type,
+    const char *extra,
+    uint32_t extra_len,
+    uint64_t length,
+    uint32_t more)
+{
+    fossil__http_conn_t *hc = ex->hc;
+    fossil__http_out_t *dst = fossil__http_turn(ex) ? &hc->out : &ex->resp;
+    const char *conn = !ex->keep_alive ? "Connection: close\r\n"
+                     : ex->version_minor == 0 ? "Connection: keep-alive\r\n" : "";
+    char line[96];
+    int n = snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", status, fossil_net_http_reason(status));
+    if (!(status < 200 || status == 204 || status == 304))
+        n += snprintf(line + n, sizeof(line) - (size_t)n, "Content-Length: %llu\r\n", (unsigned long long)length);
+
+    uint64_t total = (uint64_t)n + extra_len + ex->headers.len + strlen(conn) + 2u + more;
+    if (content_type) total += 16u + strlen(content_type);
+    if (fossil__buf_reserve(&dst->bytes, total) != 0) return NULL;
+
+    fossil__http_buf_t *b = &dst->bytes;
+    fossil__buf_put(b, line, (uint32_t)n);
+    if (content_type) {
+        fossil__buf_puts(b, "Content-Type: ");
+        fossil__buf_puts(b, content_type);
+        fossil__buf_puts(b, "\r\n");
+    }
+    fossil__buf_put(b, extra, extra_len);
+    fossil__buf_put(b, ex->headers.p, ex->headers.len);
+    fossil__buf_puts(b, conn);
+    fossil__buf_puts(b, "\r\n");
+    return dst;
+}
+
+static bool fossil__http_bodiless(const fossil_net_http_exchange_t *ex, int status) {
+    return ex->head || status < 200 || status == 204 || status == 304;
+}
+
+static int fossil__http_emit(
+    fossil_net_http_exchange_t *ex,
+    int status,
+    const char *content_type,
+    const void *body,
+    uint32_t len)
+{
+    uint32_t send = fossil__http_bodiless(ex, status) ? 0u : len;
+    fossil__http_out_t *dst = fossil__http_emit_head(ex, status, content_type, NULL, 0, len, send);
+    if (!dst) return -1;
+    fossil__buf_put(&dst->bytes, body, send);
+    return 0;
+}
+
+/* Send a cached response; small bodies are copied, larger ones referenced. */
+static int fossil__http_emit_cached(fossil_net_http_exchange_t *ex, const fossil_net_cache_hit_t *hit) {
+    fossil__http_conn_t *hc = ex->hc;
+    fossil__http_out_t *dst = fossil__http_turn(ex) ? &hc->out : &ex->resp;
+    const char *conn = !ex->keep_alive ? "Connection: close\r\n"
+                     : ex->version_minor == 0 ? "Connection: keep-alive\r\n" : "";
+    const char *data = fossil_net_buf_data(hit->buf);
+    uint32_t body = ex->head ? 0u : hit->body_len;
+    uint32_t copy = body <= FOSSIL__HTTPD_COPY_MAX ? body : 0u;
+    char age[32];
+    int n = snprintf(age, sizeof(age), "Age: %u\r\n", hit->age);
+    uint32_t mark = dst->bytes.len;
+    if (fossil__buf_reserve(&dst->bytes, (uint64_t)hit->head_len + (uint32_t)n + strlen(conn) + 2u + copy) != 0)
+        return -1;
+    fossil__buf_put(&dst->bytes, data + hit->head_off, hit->head_len);
+    fossil__buf_put(&dst->bytes, age, (uint32_t)n);
+    fossil__buf_puts(&dst->bytes, conn);
+    fossil__buf_puts(&dst->bytes, "\r\n");
+    fossil__buf_put(&dst->bytes, data + hit->body_off, copy);
+    if (body > copy && fossil__out_seg(dst, hit->buf, -1, hit->body_off, body) != 0) {
+        dst->bytes.len = mark;
+        return -1;
+    }
+    return 0;
+}
+
+/* Finish an exchange; sends the batch unless a read batch is in progress. */
+static void fossil__http_finish(fossil_net_http_exchange_t *ex) {
+    fossil__http_conn_t *hc = ex->hc;
+    if (ex->latency) {
+        fossil_net_metric_observe(ex->latency, fossil_net_socket_clock_ns() - ex->start_ns);
+        ex->latency = NULL;
+    }
+    ex->state = FOSSIL__EX_DONE;
+    ex->headers.len = 0;
+    fossil__http_complete(hc);
+    if (!hc->in_batch) fossil__http_run(hc);
+}
+
+/*=============================================================================
+REQUESTS
+=============================================================================*/
+
+static fossil_net_http_exchange_t *fossil__http_slot(fossil__http_conn_t *hc) {
+    uint32_t max = hc->httpd->config.max_pipeline;
+    fossil_net_http_exchange_t *ex = &hc->slots[(hc->slot_head + hc->slot_count) % max];
+    hc->slot_count++;
+    ex->state = FOSSIL__EX_ACTIVE;
+    ex->headers.len = 0;
+    ex->cache_key.len = 0;
+    ex->latency = NULL;
+    ex->body.ptr = NULL;
+    ex->body.len = 0;
+    ex->match.param_count = 0;
+    ex->version_minor = 1;
+    ex->head = false;
+    ex->keep_alive = false;
+    return ex;
+}
+
+/* Answer a request that cannot be served and stop reading the connection. */
+static void fossil__http_fail(fossil__http_conn_t *hc, int status) {
+    fossil__hcount(&hc->stats->errors, 1);
+    hc->stop = true;
+    fossil_net_http_exchange_t *ex = fossil__http_slot(hc);
+    const char *reason = fossil_net_http_reason(status);
+    fossil_net_http_respond(ex, status, "text/plain", reason, (uint32_t)strlen(reason));
+}
+
+static void fossil__http_dispatch(fossil__http_conn_t *hc, const char *buf) {
+    fossil_net_httpd_t *h = hc->httpd;
+    const fossil_net_http_request_t *req = &hc->req;
+    fossil_net_http_exchange_t *ex = fossil__http_slot(hc);
+    ex->body.ptr = buf + hc->head_len;
+    ex->body.len = hc->body_len;
+    ex->version_minor = req->version_minor;
+    ex->head = req->method == FOSSIL_NET_HTTP_HEAD;
+
+    hc->served++;
+    ex->keep_alive = req->keep_alive && !hc->draining &&
+                     !(h->config.max_requests && hc->served >= h->config.max_requests);
+    if (!ex->keep_alive) hc->stop = true;
+    fossil__hcount(&hc->stats->requests, 1);
+    if (hc->served > 1) fossil__hcount(&hc->stats->reused, 1);
+    if (hc->batch++ > 0) fossil__hcount(&hc->stats->pipelined, 1);
+
+    uint64_t now = h->shed || h->metrics ? fossil_net_socket_clock_ns() : 0;
+    ex->start_ns = now;
+    if (h->shed)
+        fossil_net_shed_record(h->shed, FOSSIL_NET_SHED_REQUEST, now > hc->read_ns ? now - hc->read_ns : 0, now);
+
+    if (h->cache) {
+        char key[FOSSIL__HTTPD_MAX_KEY];
+        uint32_t n = fossil_net_cache_key(h->cache, req, key, sizeof(key));
+        fossil_net_cache_hit_t hit;
+        if (n && fossil_net_cache_lookup(h->cache, key, n, req, &hit)) {
+            if (fossil__http_emit_cached(ex, &hit) != 0) ex->keep_alive = false;
+            fossil_net_cache_release(&hit);
+            ex->latency = h->cached_latency;
+            fossil__http_finish(ex);
+            return;
+        }
+        /* HEAD responses carry no body to store. */
+        if (n && req->method == FOSSIL_NET_HTTP_GET && fossil__buf_reserve(&ex->cache_key, n) == 0)
+            fossil__buf_put(&ex->cache_key, key, n);
+    }
+
+    if (h->shed) {
+        if (!fossil_net_shed_admit(h->shed)) {
+            uint32_t len = 0;
+            const void *canned = fossil_net_shed_canned(h->shed, &len);
+            fossil__http_buf_t *dst = fossil__http_turn(ex) ? &hc->out.bytes : &ex->resp.bytes;
+            if (fossil__buf_reserve(dst, len) == 0) fossil__buf_put(dst, canned, len);
+            fossil__hcount(&hc->stats->shed, 1);
+            ex->keep_alive = false;
+            hc->stop = true;
+            fossil__http_finish(ex);
+            return;
+        }
+    }
+
+    int rc = fossil_net_router_match(h->router, req->method, req->path.ptr, req->path.len, &ex->match);
+    if (rc == 0) {
+        const fossil__http_route_t *route = ex->match.handler;
+        ex->latency = route->latency;
+        route->fn(ex, req, route->user);
+        return;
+    }
+    ex->latency = h->unmatched_latency;
+    if (rc == FOSSIL_NET_ROUTER_NOT_ALLOWED) {
+        char allow[96];
+        size_t n = 0;
+        allow[0] = '\0';
+        for (int m = 0; m < FOSSIL_NET_HTTP_OTHER; m++) {
+            if (!(ex->match.allowed & (1u << m))) continue;
+            n += (size_t)snprintf(allow + n, sizeof(allow) - n, "%s%s", n ? ", " : "",
+                                  fossil_net_http_method_name((fossil_net_http_method_t)m));
+        }
+        fossil_net_http_add_header(ex, "Allow", allow);
+        fossil_net_http_respond(ex, 405, "text/plain", "Method Not Allowed", 18);
+        return;
+    }
+    fossil_net_http_respond(ex, 404, "text/plain", "Not Found", 9);
+}
+
+/* Parse and dispatch every complete request in the input buffer. */
+static void fossil__http_process(fossil__http_conn_t *hc) {
+    const fossil_net_httpd_config_t *cfg = &hc->httpd->config;
+    while (!hc->stop && !hc->closing && !hc->wm_above && hc->slot_count < cfg->max_pipeline) {
+        char *buf = hc->in.p + hc->in_off;
+        uint32_t len = hc->in.len - hc->in_off;
+        if (hc->head_len == 0) {
+            if (len == 0) break;
+            int rc = fossil_net_parser_parse(&hc->parser, buf, len, &hc->req);
+            if (rc == 0) break;
+            if (rc < 0) {
+                fossil__http_fail(hc, hc->parser.status);
+                break;
+            }
+            hc->head_len = (uint32_t)rc;
+            hc->body_len = 0;
+            if (!hc->req.chunked && hc->req.content_length > cfg->max_body) {
+                fossil__http_fail(hc, 413);
+                break;
+            }
+            /* Only when it cannot overtake an earlier response. */
+            if (hc->req.expect_continue && hc->slot_count == 0 && fossil__out_empty(&hc->out) &&
+                len == hc->head_len && (hc->req.chunked || hc->req.content_length) &&
+                fossil__buf_reserve(&hc->out.bytes, 25) == 0)
+                fossil__buf_puts(&hc->out.bytes, "HTTP/1.1 100 Continue\r\n\r\n");
+        }
+
+        uint32_t total;
+        if (hc->req.chunked) {
+            uint32_t n = len - hc->head_len - hc->body_len;
+            if (n == 0) break;
+            int rc = fossil_net_parser_decode_chunked(&hc->parser, buf + hc->head_len + hc->body_len, &n);
+            if (rc == -1) {
+                fossil__http_fail(hc, 400);
+                break;
+            }
+            hc->body_len += n;
+            if (hc->body_len > cfg->max_body) {
+                fossil__http_fail(hc, 413);
+                break;
+            }
+            /* Framing bytes were consumed; what follows the decoded data is new input. */
+            hc->in.len = hc->in_off + hc->head_len + hc->body_len + (rc > 0 ? (uint32_t)rc : 0u);
+            if (rc == -2) break;
+        } else {
+            if ((uint64_t)len < hc->head_len + hc->req.content_length) break;
+            hc->body_len = (uint32_t)hc->req.content_length;
+        }
+        total = hc->head_len + hc->body_len;
+
+        fossil__http_dispatch(hc, buf);
+        hc->in_off += total;
+        hc->head_len = 0;
+        fossil_net_parser_reset(&hc->parser);
+    }
+    if (hc->in_off == hc->in.len) hc->in_off = hc->in.len = 0;
+}
+
+/* Send the batch, then close or throttle reading as the state requires. */
+static void fossil__http_flush(fossil__http_conn_t *hc) {
+    fossil_net_conn_t *conn = hc->conn;
+    fossil__http_out_t *out = &hc->out;
+    if (!fossil__out_empty(out)) {
+        int rc = 0;
+        uint32_t at = 0;
+        for (uint32_t i = 0; i < out->nsegs && rc == 0; i++) {
+            const fossil__http_seg_t *f = &out->segs[i];
+            if (f->at > at) rc = fossil_net_conn_write(conn, out->bytes.p + at, f->at - at);
+            if (rc == 0)
+                rc = f->fd >= 0 ? fossil_net_conn_write_file(conn, f->owner, f->fd, f->offset, f->len)
+                                : fossil_net_conn_write_buf(conn, f->owner, (uint32_t)f->offset, (uint32_t)f->len);
+            at = f->at;
+        }
+        if (rc == 0 && out->bytes.len > at) rc = fossil_net_conn_write(conn, out->bytes.p + at, out->bytes.len - at);
+        fossil__out_clear(out);
+        fossil__hcount(&hc->stats->flushes, 1);
+        if (rc != 0) {
+            fossil_net_conn_close(conn);
+            return;
+        }
+    }
+    bool idle = hc->slot_count == 0 && hc->in_off == hc->in.len;
+    if (hc->closing || (hc->eof && hc->slot_count == 0) || (hc->draining && idle)) {
+        fossil_net_conn_close_flushed(conn);
+        return;
+    }
+    bool pause = hc->stop || hc->eof || hc->wm_above || hc->slot_count >= hc->httpd->config.max_pipeline;
+    if (pause != hc->paused) {
+        hc->paused = pause;
+        fossil_net_conn_want_read(conn, !pause);
+    }
+}
+
+static void fossil__http_run(fossil__http_conn_t *hc) {
+    hc->in_batch = true;
+    fossil__http_process(hc);
+    hc->in_batch = false;
+    fossil__http_flush(hc); /* may free hc */
+}
+
+/*=============================================================================
+REACTOR CALLBACKS
+=============================================================================*/
+
+static int fossil__httpd_on_accept(fossil_net_conn_t *conn, void *user) {
+    fossil_net_httpd_t *h = user;
+    fossil__http_conn_t *hc = calloc(1, sizeof(*hc));
+    if (!hc) return -1;
+    hc->slots = calloc(h->config.max_pipeline, sizeof(*hc->slots));
+    if (!hc->slots) {
+        free(hc);
+        return -1;
+    }
+    for (uint32_t i = 0; i < h->config.max_pipeline; i++)
+        hc->slots[i].hc = hc;
+    hc->httpd = h;
+    hc->conn = conn;
+    hc->stats = &h->counters[fossil_net_loop_index(fossil_net_conn_loop(conn))];
+    fossil_net_parser_init(&hc->parser, h->config.max_head);
+    fossil_net_conn_set_user(conn, hc);
+    return 0;
+}
+
+static void fossil__httpd_on_readable(fossil_net_conn_t *conn, void *user) {
+    fossil_net_httpd_t *h = user;
+    fossil__http_conn_t *hc = fossil_net_conn_get_user(conn);
+    if (!hc) {
+        fossil_net_conn_close(conn);
+        return;
+    }
+
+    if (hc->in_off && hc->in.cap - hc->in.len < FOSSIL__HTTPD_READ_CHUNK) {
+        memmove(hc->in.p, hc->in.p + hc->in_off, hc->in.len - hc->in_off);
+        hc->in.len -= hc->in_off;
+        hc->in_off = 0;
+    }
+    uint64_t limit = (uint64_t)h->config.max_head + h->config.max_body + FOSSIL__HTTPD_READ_CHUNK;
+    if (hc->in.cap - hc->in.len < FOSSIL__HTTPD_READ_CHUNK && hc->in.cap < limit)
+        fossil__buf_reserve(&hc->in, FOSSIL__HTTPD_READ_CHUNK);
+    uint32_t room = hc->in.cap - hc->in.len;
+    if (room == 0) {
+        hc->batch = 0;
+        hc->in_batch = true;
+        fossil__http_fail(hc, 413);
+        hc->in_batch = false;
+        fossil__http_flush(hc);
+        return;
+    }
+
+    uint32_t got = 0;
+    int rc = fossil_net_conn_receive(conn, hc->in.p + hc->in.len, room, &got);
+    if (rc < 0) {
+        fossil_net_conn_close(conn);
+        return;
+    }
+    if (rc == 1) return;
+    if (got == 0) {
+        hc->eof = true;
+    } else {
+        hc->in.len += got;
+        if (h->shed) hc->read_ns = fossil_net_socket_clock_ns();
+    }
+    hc->batch = 0;
+    fossil__http_run(hc);
+}
+
+static void fossil__httpd_resume(fossil_net_conn_t *conn, void *arg) {
+    (void)arg;
+    fossil__http_conn_t *hc = conn ? fossil_net_conn_get_user(conn) : NULL;
+    if (hc && !hc->in_batch && !hc->wm_above) fossil__http_run(hc);
+}
+
+static void fossil__httpd_drain_conn(fossil_net_conn_t *conn, void *arg) {
+    (void)arg;
+    fossil__http_conn_t *hc = fossil_net_conn_get_user(conn);
+    if (!hc || hc->draining) return;
+    hc->draining = true;
+    if (!hc->in_batch) fossil__http_flush(hc); /* closes it now if idle */
+}
+
+static void fossil__httpd_on_watermark(fossil_net_conn_t *conn, bool above, void *user) {
+    fossil_net_httpd_t *h = user;
+    fossil__http_conn_t *hc = fossil_net_conn_get_user(conn);
+    if (!hc) return;
+    hc->wm_above = above;
+    /* Below: resume from a task, not from inside the queue's flush. */
+    if (!above) fossil_net_reactor_post_conn(h->reactor, fossil_net_conn_id(conn), fossil__httpd_resume, NULL);
+}
+
+static void fossil__httpd_on_close(fossil_net_conn_t *conn, void *user) {
+    (void)user;
+    fossil__http_conn_t *hc = fossil_net_conn_get_user(conn);
+    if (!hc) return;
+    fossil_net_conn_set_user(conn, NULL);
+    for (uint32_t i = 0; i < hc->httpd->config.max_pipeline; i++) {
+        free(hc->slots[i].headers.p);
+        free(hc->slots[i].cache_key.p);
+        fossil__out_free(&hc->slots[i].resp);
+    }
+    free(hc->slots);
+    free(hc->in.p);
+    fossil__out_free(&hc->out);
+    free(hc);
+}
+
+/*=============================================================================
+METRICS
+=============================================================================*/
+
+static void fossil__httpd_collect(fossil_net_metrics_sink_t *sink, void *arg) {
+    fossil_net_httpd_stats_t st;
+    if (fossil_net_httpd_get_stats(arg, &st) != 0) return;
+    const fossil_net_metric_type_t c = FOSSIL_NET_METRIC_COUNTER;
+    fossil_net_metrics_emit(sink, c, "fossil_net_http_requests_total", "Requests parsed.", NULL, (double)st.requests);
+    fossil_net_metrics_emit(sink, c, "fossil_net_http_pipelined_total", "Requests that arrived behind another in one read.", NULL, (double)st.pipelined);
+    fossil_net_metrics_emit(sink, c, "fossil_net_http_errors_total", "Malformed requests.", NULL, (double)st.errors);
+    fossil_net_metrics_emit(sink, c, "fossil_net_http_shed_total", "Requests answered with the shedder's canned response.", NULL, (double)st.shed);
+}
+
+/* Latency histogram of one route; NULL if its labels do not fit. */
+static fossil_net_metric_t *fossil__httpd_latency(fossil_net_httpd_t *h, const char *method, const char *route) {
+    char labels[FOSSIL__HTTPD_MAX_LABELS];
+    snprintf(labels, sizeof(labels), "%s", h->metric_labels);
+    if (fossil_net_metrics_label(labels, sizeof(labels), "method", method) != 0 ||
+        fossil_net_metrics_label(labels, sizeof(labels), "route", route) != 0)
+        return NULL;
+    return fossil_net_metrics_histogram(h->metrics, FOSSIL__HTTPD_LATENCY,
+                                        "Time from parsing a request to queueing its response.", labels);
+}
+
+static void fossil__httpd_route_latency(fossil_net_httpd_t *h, fossil__http_route_t *route) {
+    route->latency = h->metrics ? fossil__httpd_latency(h, fossil_net_http_method_name(route->method), route->pattern) : NULL;
+}
+
+static void fossil__httpd_unset_metrics(fossil_net_httpd_t *h) {
+    if (!h->metrics) return;
+    fossil_net_metrics_remove_collector(h->metrics, fossil__httpd_collect, h);
+    fossil_net_metrics_detach_reactor(h->metrics, h->reactor);
+    h->metrics = NULL;
+    h->cached_latency = NULL;
+    h->unmatched_latency = NULL;
+    for (fossil__http_route_t *r = h->routes; r; r = r->next)
+        r->latency = NULL;
+    free(h->metric_labels);
+    h->metric_labels = NULL;
+}
+
+/*=============================================================================
+SERVER
+=============================================================================*/
+
+fossil_net_httpd_t *fossil_net_httpd_create(
+    fossil_net_server_t *server,
+    const fossil_net_httpd_config_t *config)
+{
+    if (!server) return NULL;
+    fossil_net_httpd_t *h = calloc(1, sizeof(*h));
+    if (!h) return NULL;
+    if (config) h->config = *config;
+    if (!h->config.max_head) h->config.max_head = FOSSIL__HTTPD_MAX_HEAD;
+    if (!h->config.max_body) h->config.max_body = FOSSIL__HTTPD_MAX_BODY;
+    if (!h->config.max_pipeline) h->config.max_pipeline = FOSSIL__HTTPD_MAX_PIPELINE;
+
+    fossil_net_reactor_callbacks_t cb = {
+        fossil__httpd_on_accept,
+        fossil__httpd_on_readable,
+        NULL,
+        fossil__httpd_on_close,
+        fossil__httpd_on_watermark,
+        NULL
+    };
+    h->router = fossil_net_router_create();
+    h->reactor = h->router ? fossil_net_reactor_create(server, &h->config.reactor, &cb, h) : NULL;
+    if (h->reactor) {
+        h->loops = fossil_net_reactor_loop_count(h->reactor);
+        h->counters = calloc(h->loops, sizeof(*h->counters));
+    }
+    if (!h->counters) {
+        fossil_net_reactor_destroy(h->reactor);
+        fossil_net_router_destroy(h->router);
+        free(h);
+        return NULL;
+    }
+    return h;
+}
+
+void fossil_net_httpd_destroy(fossil_net_httpd_t *httpd) {
+    if (!httpd) return;
+    fossil__httpd_unset_metrics(httpd);
+    fossil_net_reactor_destroy(httpd->reactor);
+    fossil_net_router_destroy(httpd->router);
+    while (httpd->routes) {
+        fossil__http_route_t *next = httpd->routes->next;
+        free(httpd->routes);
+        httpd->routes = next;
+    }
+    free(httpd->counters);
+    free(httpd);
+}
+
+int fossil_net_httpd_route(
+    fossil_net_httpd_t *httpd,
+    fossil_net_http_method_t method,
+    const char *pattern,
+    fossil_net_http_handler_fn handler,
+    void *user)
+{
+    if (!httpd || !handler || !pattern || httpd->running) return -1;
+    size_t n = strlen(pattern) + 1;
+    fossil__http_route_t *route = calloc(1, sizeof(*route) + n);
+    if (!route) return -1;
+    route->fn = handler;
+    route->user = user;
+    route->method = method;
+    memcpy(route->pattern, pattern, n);
+    if (fossil_net_router_add(httpd->router, method, pattern, route) != 0) {
+        free(route);
+        return -1;
+    }
+    route->next = httpd->routes;
+    httpd->routes = route;
+    fossil__httpd_route_latency(httpd, route);
+    return 0;
+}
+
+int fossil_net_httpd_set_shed(fossil_net_httpd_t *httpd, fossil_net_shed_t *shed) {
+    if (!httpd || httpd->running) return -1;
+    if (fossil_net_reactor_set_shed(httpd->reactor, shed) != 0) return -1;
+    httpd->shed = shed;
+    return 0;
+}
+
+int fossil_net_httpd_set_cache(fossil_net_httpd_t *httpd, fossil_net_cache_t *cache) {
+    if (!httpd || httpd->running) return -1;
+    httpd->cache = cache;
+    return 0;
+}
+
+int fossil_net_httpd_set_metrics(fossil_net_httpd_t *httpd, fossil_net_metrics_t *metrics, const char *labels) {
+    if (!httpd || httpd->running) return -1;
+    fossil__httpd_unset_metrics(httpd);
+    if (!metrics) return 0;
+    if (!labels) labels = "";
+    size_t n = strlen(labels) + 1;
+    if (!(httpd->metric_labels = malloc(n))) return -1;
+    memcpy(httpd->metric_labels, labels, n);
+    httpd->metrics = metrics;
+    if (fossil_net_metrics_add_collector(metrics, labels, fossil__httpd_collect, httpd) != 0 ||
+        fossil_net_metrics_attach_reactor(metrics, httpd->reactor, labels) != 0) {
+        fossil__httpd_unset_metrics(httpd);
+        return -1;
+    }
+    httpd->cached_latency = fossil__httpd_latency(httpd, "", "(cache)");
+    httpd->unmatched_latency = fossil__httpd_latency(httpd, "", "");
+    for (fossil__http_route_t *r = httpd->routes; r; r = r->next)
+        fossil__httpd_route_latency(httpd, r);
+    return 0;
+}
+
+int fossil_net_httpd_start(fossil_net_httpd_t *httpd) {
+    if (!httpd || httpd->running) return -1;
+    if (fossil_net_reactor_start(httpd->reactor) != 0) return -1;
+    httpd->running = true;
+    return 0;
+}
+
+int fossil_net_httpd_stop(fossil_net_httpd_t *httpd) {
+    if (!httpd) return -1;
+    int rc = fossil_net_reactor_stop(httpd->reactor);
+    httpd->running = false;
+    return rc;
+}
+
+int fossil_net_httpd_drain(fossil_net_httpd_t *httpd) {
+    if (!httpd) return -1;
+    return fossil_net_reactor_drain(httpd->reactor, fossil__httpd_drain_conn, NULL);
+}
+
+fossil_net_reactor_t *fossil_net_httpd_reactor(fossil_net_httpd_t *httpd) {
+    return httpd ? httpd->reactor : NULL;
+}
+
+int fossil_net_httpd_get_stats(fossil_net_httpd_t *httpd, fossil_net_httpd_stats_t *stats) {
+    if (!httpd || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < httpd->loops; i++) {
+        const fossil__httpd_counters_t *c = &httpd->counters[i];
+        stats->requests += atomic_load_explicit(&c->requests, memory_order_relaxed);
+        stats->reused += atomic_load_explicit(&c->reused, memory_order_relaxed);
+        stats->pipelined += atomic_load_explicit(&c->pipelined, memory_order_relaxed);
+        stats->flushes += atomic_load_explicit(&c->flushes, memory_order_relaxed);
+        stats->errors += atomic_load_explicit(&c->errors, memory_order_relaxed);
+        stats->shed += atomic_load_explicit(&c->shed, memory_order_relaxed);
+    }
+    return 0;
+}
+
+/*=============================================================================
+EXCHANGES
+=============================================================================*/
+
+int fossil_net_http_add_header(fossil_net_http_exchange_t *ex, const char *name, const char *value) {
+    if (!ex || !name || !value || ex->state != FOSSIL__EX_ACTIVE) return -1;
+    size_t n = strlen(name);
+    size_t v = strlen(value);
+    if (strpbrk(name, "\r\n:") || strpbrk(value, "\r\n")) return -1;
+    if (fossil__buf_reserve(&ex->headers, (uint64_t)n + v + 4u) != 0) return -1;
+    fossil__buf_put(&ex->headers, name, (uint32_t)n);
+    fossil__buf_puts(&ex->headers, ": ");
+    fossil__buf_put(&ex->headers, value, (uint32_t)v);
+    fossil__buf_puts(&ex->headers, "\r\n");
+    return 0;
+}
+
+int fossil_net_http_respond(
+    fossil_net_http_exchange_t *ex,
+    int status,
+    const char *content_type,
+    const void *body,
+    uint32_t len)
+{
+    if (!ex || ex->state != FOSSIL__EX_ACTIVE || (!body && len) || status < 100 || status > 999)
+        return -1;
+    if (content_type && strpbrk(content_type, "\r\n")) return -1;
+    if (!ex->hc->closing && fossil__http_emit(ex, status, content_type, body, len) != 0)
+        return -1;
+    if (ex->cache_key.len)
+        fossil_net_cache_store(ex->hc->httpd->cache, ex->cache_key.p, ex->cache_key.len, status,
+                               content_type, ex->headers.p, ex->headers.len, body, len);
+    fossil__http_finish(ex);
+    return 0;
+}
+
+int fossil_net_http_respond_file(
+    fossil_net_http_exchange_t *ex,
+    int status,
+    const char *headers,
+    uint32_t headers_len,
+    fossil_net_buf_t *owner,
+    int32_t fd,
+    uint64_t offset,
+    uint64_t len)
+{
+    if (!ex || ex->state != FOSSIL__EX_ACTIVE || (!headers && headers_len) || (fd < 0 && len) ||
+        status < 100 || status > 999)
+        return -1;
+    if (!ex->hc->closing) {
+        fossil__http_out_t *dst = fossil__http_turn(ex) ? &ex->hc->out : &ex->resp;
+        uint32_t mark = dst->bytes.len;
+        if (!fossil__http_emit_head(ex, status, NULL, headers, headers_len, len, 0)) return -1;
+        if (len && !fossil__http_bodiless(ex, status) &&
+            fossil__out_seg(dst, owner, fd, offset, len) != 0) {
+            dst->bytes.len = mark;
+            return -1;
+        }
+    }
+    fossil__http_finish(ex);
+    return 0;
+}
+
+void fossil_net_http_close_after(fossil_net_http_exchange_t *ex) {
+    if (!ex || ex->state != FOSSIL__EX_ACTIVE) return;
+    ex->keep_alive = false;
+    ex->hc->stop = true;
+}
+
+fossil_net_slice_t fossil_net_http_body(const fossil_net_http_exchange_t *ex) {
+    fossil_net_slice_t none = { "", 0 };
+    return ex ? ex->body : none;
+}
+
+bool fossil_net_http_param(const fossil_net_http_exchange_t *ex, const char *name, fossil_net_slice_t *value) {
+    return ex && fossil_net_route_param(&ex->match, name, value);
+}
+
+fossil_net_conn_t *fossil_net_http_conn(fossil_net_http_exchange_t *ex) {
+    return ex ? ex->hc->conn : NULL;
+}
+
+const char *fossil_net_http_reason(int status) {
+    switch (status) {
+        case 100: return "Continue";
+        case 101: return "Switching Protocols";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 307: return "Temporary Redirect";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 411: return "Length Required";
+        case 412: return "Precondition Failed";
+        case 413: return "Content Too Large";
+        case 414: return "URI Too Long";
+        case 416: return "Range Not Satisfiable";
+        case 417: return "Expectation Failed";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        case 505: return "HTTP Version Not Supported";
+        default: return "Unknown";
+    }
+}
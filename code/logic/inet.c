@@ -0,0 +1,429 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/inet.h"
+
+#include <string.h>
+
+/*=============================================================================
+INTERNAL HELPERS
+=============================================================================*/
+
+static const char fossil__hex_lower[] = "0123456789abcdef";
+static const char fossil__hex_upper[] = "0123456789ABCDEF";
+
+static inline int fossil__hex_value(unsigned char c)
+{
+    if ((unsigned)(c - '0') < 10u) return c - '0';
+    c |= 0x20;
+    if ((unsigned)(c - 'a') < 6u) return c - 'a' + 10;
+    return -1;
+}
+
+/* Writes 1-3 decimal digits for a byte, returns the count. */
+static inline uint32_t fossil__put_u8(char *out, uint8_t v)
+{
+    if (v >= 100) {
+        out[0] = (char)('0' + v / 100);
+        out[1] = (char)('0' + (v / 10) % 10);
+        out[2] = (char)('0' + v % 10);
+        return 3;
+    }
+    if (v >= 10) {
+        out[0] = (char)('0' + v / 10);
+        out[1] = (char)('0' + v % 10);
+        return 2;
+    }
+    out[0] = (char)('0' + v);
+    return 1;
+}
+
+/* Writes 1-5 decimal digits for a port, returns the count. */
+static inline uint32_t fossil__put_u16(char *out, uint16_t v)
+{
+    char tmp[5];
+    uint32_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (uint32_t i = 0; i < n; ++i)
+        out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+/* Writes a 16-bit group in lower-case hex without leading zeros. */
+static inline uint32_t fossil__put_hex16(char *out, uint16_t v)
+{
+    uint32_t n = 0;
+    if (v >= 0x1000) out[n++] = fossil__hex_lower[v >> 12];
+    if (v >= 0x100)  out[n++] = fossil__hex_lower[(v >> 8) & 0xf];
+    if (v >= 0x10)   out[n++] = fossil__hex_lower[(v >> 4) & 0xf];
+    out[n++] = fossil__hex_lower[v & 0xf];
+    return n;
+}
+
+static uint32_t fossil__ipv4_format_raw(const uint8_t ip[4], char *out)
+{
+    uint32_t n = fossil__put_u8(out, ip[0]);
+    out[n++] = '.';
+    n += fossil__put_u8(out + n, ip[1]);
+    out[n++] = '.';
+    n += fossil__put_u8(out + n, ip[2]);
+    out[n++] = '.';
+    n += fossil__put_u8(out + n, ip[3]);
+    return n;
+}
+
+static uint32_t fossil__ipv6_format_raw(const uint8_t ip[16], char *out)
+{
+    uint16_t words[8];
+    for (int i = 0; i < 8; ++i)
+        words[i] = (uint16_t)((ip[2 * i] << 8) | ip[2 * i + 1]);
+
+    /* Longest run of zero groups (first one wins a tie), same as inet_ntop */
+    int best_base = -1, best_len = 0, cur_base = -1, cur_len = 0;
+    for (int i = 0; i < 8; ++i) {
+        if (words[i] == 0) {
+            if (cur_base < 0) { cur_base = i; cur_len = 1; }
+            else cur_len++;
+        } else if (cur_base >= 0) {
+            if (cur_len > best_len) { best_base = cur_base; best_len = cur_len; }
+            cur_base = -1;
+        }
+    }
+    if (cur_base >= 0 && cur_len > best_len) { best_base = cur_base; best_len = cur_len; }
+    if (best_len < 2) best_base = -1;
+
+    uint32_t n = 0;
+    for (int i = 0; i < 8; ++i) {
+        if (best_base >= 0 && i >= best_base && i < best_base + best_len) {
+            if (i == best_base) out[n++] = ':';
+            continue;
+        }
+        if (i != 0) out[n++] = ':';
+        /* IPv4-compatible and IPv4-mapped addresses keep a dotted tail */
+        if (i == 6 && best_base == 0 &&
+            (best_len == 6 ||
+             (best_len == 7 && words[7] != 0x0001) ||
+             (best_len == 5 && words[5] == 0xffff))) {
+            n += fossil__ipv4_format_raw(ip + 12, out + n);
+            return n;
+        }
+        n += fossil__put_hex16(out + n, words[i]);
+    }
+    if (best_base >= 0 && best_base + best_len == 8) out[n++] = ':';
+    return n;
+}
+
+/*=============================================================================
+IPV4 / IPV6
+=============================================================================*/
+
+int fossil_net_inet_ipv4_parse(
+    const char *string,
+    uint8_t out[4])
+{
+    if (!string || !out) return -1;
+
+    uint8_t tmp[4];
+    uint32_t octets = 0;
+    const unsigned char *p = (const unsigned char *)string;
+
+    for (;;) {
+        if ((unsigned)(*p - '0') >= 10u) return -1;
+        uint32_t val = 0;
+        uint32_t digits = 0;
+        /* no leading zeros, at most three digits, value <= 255 */
+        if (*p == '0' && (unsigned)(p[1] - '0') < 10u) return -1;
+        while ((unsigned)(*p - '0') < 10u) {
+            val = val * 10 + (uint32_t)(*p - '0');
+            if (++digits > 3 || val > 255) return -1;
+            p++;
+        }
+        tmp[octets++] = (uint8_t)val;
+        if (octets == 4) break;
+        if (*p != '.') return -1;
+        p++;
+    }
+    if (*p != '\0') return -1;
+
+    memcpy(out, tmp, 4);
+    return 0;
+}
+
+int fossil_net_inet_ipv4_format(
+    const uint8_t ip[4],
+    char *buffer,
+    uint32_t size)
+{
+    if (!ip || !buffer) return -1;
+    char tmp[FOSSIL_NET_INET_IPV4_STRLEN];
+    uint32_t n = fossil__ipv4_format_raw(ip, tmp);
+    if (n >= size) return -1;
+    memcpy(buffer, tmp, n);
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+int fossil_net_inet_ipv6_parse(
+    const char *string,
+    uint8_t out[16])
+{
+    if (!string || !out) return -1;
+
+    uint8_t tmp[16];
+    uint32_t tp = 0;
+    int colonp = -1;
+    const char *p = string;
+    const char *curtok;
+    uint32_t val = 0;
+    uint32_t digits = 0;
+    int saw_xdigit = 0;
+
+    memset(tmp, 0, sizeof(tmp));
+
+    /* a leading ':' is only valid as part of "::" */
+    if (*p == ':' && *++p != ':') return -1;
+    curtok = p;
+
+    char ch;
+    while ((ch = *p++) != '\0') {
+        int h = fossil__hex_value((unsigned char)ch);
+        if (h >= 0) {
+            if (++digits > 4) return -1;
+            val = (val << 4) | (uint32_t)h;
+            saw_xdigit = 1;
+            continue;
+        }
+        if (ch == ':') {
+            curtok = p;
+            if (!saw_xdigit) {
+                if (colonp >= 0) return -1;
+                colonp = (int)tp;
+                continue;
+            }
+            if (*p == '\0') return -1;
+            if (tp + 2 > 16) return -1;
+            tmp[tp++] = (uint8_t)(val >> 8);
+            tmp[tp++] = (uint8_t)val;
+            saw_xdigit = 0;
+            digits = 0;
+            val = 0;
+            continue;
+        }
+        if (ch == '.' && tp + 4 <= 16 && fossil_net_inet_ipv4_parse(curtok, tmp + tp) == 0) {
+            tp += 4;
+            saw_xdigit = 0;
+            break;
+        }
+        return -1;
+    }
+    if (saw_xdigit) {
+        if (tp + 2 > 16) return -1;
+        tmp[tp++] = (uint8_t)(val >> 8);
+        tmp[tp++] = (uint8_t)val;
+    }
+    if (colonp >= 0) {
+        if (tp == 16) return -1;
+        uint32_t n = tp - (uint32_t)colonp;
+        memmove(tmp + 16 - n, tmp + colonp, n);
+        memset(tmp + colonp, 0, 16 - n - (uint32_t)colonp);
+        tp = 16;
+    }
+    if (tp != 16) return -1;
+
+    memcpy(out, tmp, 16);
+    return 0;
+}
+
+int fossil_net_inet_ipv6_format(
+    const uint8_t ip[16],
+    char *buffer,
+    uint32_t size)
+{
+    if (!ip || !buffer) return -1;
+    char tmp[FOSSIL_NET_INET_IPV6_STRLEN];
+    uint32_t n = fossil__ipv6_format_raw(ip, tmp);
+    if (n >= size) return -1;
+    memcpy(buffer, tmp, n);
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+/*=============================================================================
+MAC ADDRESS
+=============================================================================*/
+
+int fossil_net_inet_mac_parse(
+    const char *string,
+    uint8_t out[6])
+{
+    if (!string || !out) return -1;
+
+    uint8_t tmp[6];
+    const unsigned char *p = (const unsigned char *)string;
+    for (int i = 0; i < 6; ++i) {
+        int hi = fossil__hex_value(*p);
+        if (hi < 0) return -1;
+        p++;
+        int lo = fossil__hex_value(*p);
+        if (lo >= 0) {
+            tmp[i] = (uint8_t)((hi << 4) | lo);
+            p++;
+        } else {
+            tmp[i] = (uint8_t)hi;
+        }
+        if (i < 5) {
+            if (*p != ':' && *p != '-') return -1;
+            p++;
+        }
+    }
+    if (fossil__hex_value(*p) >= 0) return -1;
+
+    memcpy(out, tmp, 6);
+    return 0;
+}
+
+int fossil_net_inet_mac_format(
+    const uint8_t bytes[6],
+    char *buffer,
+    uint32_t size)
+{
+    if (!bytes || !buffer || size < FOSSIL_NET_INET_MAC_STRLEN) return -1;
+    char *out = buffer;
+    for (int i = 0; i < 6; ++i) {
+        *out++ = fossil__hex_upper[bytes[i] >> 4];
+        *out++ = fossil__hex_upper[bytes[i] & 0xf];
+        if (i < 5) *out++ = ':';
+    }
+    *out = '\0';
+    return FOSSIL_NET_INET_MAC_STRLEN - 1;
+}
+
+/*=============================================================================
+ENDPOINTS
+=============================================================================*/
+
+int fossil_net_endpoint_parse(
+    fossil_net_endpoint_t *ep,
+    const char *ip,
+    uint16_t port)
+{
+    if (!ep || !ip) return -1;
+    memset(ep, 0, sizeof(*ep));
+    ep->port = port;
+    if (fossil_net_inet_ipv4_parse(ip, ep->ip) == 0) {
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+        return 0;
+    }
+    if (fossil_net_inet_ipv6_parse(ip, ep->ip) == 0) {
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        return 0;
+    }
+    return -1;
+}
+
+int fossil_net_endpoint_format_ip(
+    const fossil_net_endpoint_t *ep,
+    char *buffer,
+    uint32_t size)
+{
+    if (!ep) return -1;
+    if (ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV4)
+        return fossil_net_inet_ipv4_format(ep->ip, buffer, size);
+    if (ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV6)
+        return fossil_net_inet_ipv6_format(ep->ip, buffer, size);
+    return -1;
+}
+
+int fossil_net_endpoint_format(
+    const fossil_net_endpoint_t *ep,
+    char *buffer,
+    uint32_t size)
+{
+    if (!ep || !buffer) return -1;
+
+    char tmp[FOSSIL_NET_INET_ENDPOINT_STRLEN];
+    uint32_t n = 0;
+    if (ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV4) {
+        n = fossil__ipv4_format_raw(ep->ip, tmp);
+    } else if (ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV6) {
+        tmp[n++] = '[';
+        n += fossil__ipv6_format_raw(ep->ip, tmp + n);
+        tmp[n++] = ']';
+    } else {
+        return -1;
+    }
+    tmp[n++] = ':';
+    n += fossil__put_u16(tmp + n, ep->port);
+
+    if (n >= size) return -1;
+    memcpy(buffer, tmp, n);
+    buffer[n] = '\0';
+    return (int)n;
+}
+
+int fossil_net_endpoint_to_address(
+    const fossil_net_endpoint_t *ep,
+    fossil_net_address_t *addr)
+{
+    if (!ep || !addr) return -1;
+    memset(addr, 0, sizeof(*addr));
+    int n = fossil_net_endpoint_format_ip(ep, addr->ip, sizeof(addr->ip));
+    if (n < 0) return -1;
+    memcpy(addr->addr, addr->ip, (size_t)n + 1);
+    addr->port = ep->port;
+    memcpy(addr->family, ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV4 ? "ipv4" : "ipv6", 5);
+    return 0;
+}
+
+int fossil_net_endpoint_from_address(
+    fossil_net_endpoint_t *ep,
+    const fossil_net_address_t *addr)
+{
+    if (!ep || !addr) return -1;
+    const char *ipstr = addr->addr[0] ? addr->addr : addr->ip;
+    memset(ep, 0, sizeof(*ep));
+    ep->port = addr->port;
+    if (!strcmp(addr->family, "ipv4")) {
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+        return fossil_net_inet_ipv4_parse(ipstr, ep->ip);
+    }
+    if (!strcmp(addr->family, "ipv6")) {
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        return fossil_net_inet_ipv6_parse(ipstr, ep->ip);
+    }
+    return -1;
+}
+
+bool fossil_net_endpoint_equal(
+    const fossil_net_endpoint_t *a,
+    const fossil_net_endpoint_t *b)
+{
+    if (!a || !b) return false;
+    if (a->family != b->family || a->port != b->port) return false;
+    size_t len = a->family == FOSSIL_NET_SOCKET_FAMILY_IPV4 ? 4 : 16;
+    return memcmp(a->ip, b->ip, len) == 0;
+}
@@ -0,0 +1,714 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/metrics.h"
+#include "fossil/network/httpd.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+PLATFORM
+=============================================================================*/
+
+#if defined(_WIN32)
+#include <windows.h>
+#define FOSSIL__METRICS_TLS __declspec(thread)
+typedef CRITICAL_SECTION fossil__metrics_mutex_t;
+#define fossil__metrics_mutex_init(m)    InitializeCriticalSection(m)
+#define fossil__metrics_mutex_destroy(m) DeleteCriticalSection(m)
+#define fossil__metrics_mutex_lock(m)    EnterCriticalSection(m)
+#define fossil__metrics_mutex_unlock(m)  LeaveCriticalSection(m)
+#else
+#include <pthread.h>
+#include <unistd.h>
+#define FOSSIL__METRICS_TLS _Thread_local
+typedef pthread_mutex_t fossil__metrics_mutex_t;
+#define fossil__metrics_mutex_init(m)    pthread_mutex_init(m, NULL)
+#define fossil__metrics_mutex_destroy(m) pthread_mutex_destroy(m)
+#define fossil__metrics_mutex_lock(m)    pthread_mutex_lock(m)
+#define fossil__metrics_mutex_unlock(m)  pthread_mutex_unlock(m)
+#endif
+
+static uint32_t fossil__metrics_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors ? (uint32_t)si.dwNumberOfProcessors : 1u;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1u;
+#endif
+}
+
+static uint32_t fossil__metrics_msb(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - (uint32_t)__builtin_clzll(v);
+#else
+    uint32_t n = 0;
+    while (v >>= 1) n++;
+    return n;
+#endif
+}
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+#define FOSSIL__METRICS_MAX_SHARDS 64u
+#define FOSSIL__METRICS_SUB_BITS   3u
+#define FOSSIL__METRICS_SUB        (1u << FOSSIL__METRICS_SUB_BITS) /* buckets per power of two */
+#define FOSSIL__METRICS_MAX_MSB    40u  /* 2^41 ns and above share the last bucket */
+#define FOSSIL__METRICS_BUCKETS    ((FOSSIL__METRICS_MAX_MSB - FOSSIL__METRICS_SUB_BITS + 2u) * FOSSIL__METRICS_SUB)
+#define FOSSIL__METRICS_LE_FIRST   10u  /* rendered bucket bounds: 2^10 .. 2^36 ns */
+#define FOSSIL__METRICS_LE_LAST    36u
+#define FOSSIL__METRICS_MAX_NAME   128u
+#define FOSSIL__METRICS_MAX_LABELS 512u
+#define FOSSIL__METRICS_CONTENT_TYPE "text/plain; version=0.0.4; charset=utf-8"
+
+/* One counter shard, alone on its cache line. */
+typedef struct fossil__metrics_cell
+{
+    _Atomic uint64_t value;
+    char pad[56];
+} fossil__metrics_cell_t;
+
+/* One histogram shard; the count is the sum of the buckets. */
+typedef struct fossil__metrics_hshard
+{
+    _Atomic uint64_t sum;
+    _Atomic uint64_t buckets[FOSSIL__METRICS_BUCKETS];
+    char pad[56];
+} fossil__metrics_hshard_t;
+
+typedef struct fossil__metrics_family
+{
+    struct fossil__metrics_family *next;
+    fossil_net_metric_t *series;    /* registration order */
+    fossil_net_metric_type_t type;
+    char *help;
+    char name[];
+} fossil__metrics_family_t;
+
+struct fossil_net_metric
+{
+    struct fossil_net_metric *next;
+    fossil__metrics_family_t *family;
+    uint32_t mask;                  /* shards - 1 */
+    _Atomic int64_t gauge;
+    fossil__metrics_cell_t *cells;  /* counters */
+    fossil__metrics_hshard_t *hist; /* histograms */
+    char labels[];
+};
+
+typedef struct fossil__metrics_collector
+{
+    struct fossil__metrics_collector *next;
+    fossil_net_metrics_collect_fn fn;
+    void *arg;
+    char labels[];
+} fossil__metrics_collector_t;
+
+/* A collector sample, kept until every collector has run so names can be grouped. */
+typedef struct fossil__metrics_sample
+{
+    fossil_net_metric_type_t type;
+    double value;
+    const char *name;
+    const char *help;
+    const char *labels;
+    bool done;
+} fossil__metrics_sample_t;
+
+typedef struct fossil__metrics_text
+{
+    char *p;
+    size_t len;
+    size_t cap;
+    bool failed;
+} fossil__metrics_text_t;
+
+struct fossil_net_metrics_sink
+{
+    const fossil__metrics_collector_t *collector;
+    fossil__metrics_sample_t *samples;
+    uint32_t count;
+    uint32_t cap;
+    bool failed;
+};
+
+struct fossil_net_metrics
+{
+    fossil__metrics_mutex_t lock;
+    fossil__metrics_family_t *families;
+    fossil__metrics_collector_t *collectors;
+    fossil_net_httpd_t *httpd;      /* set by fossil_net_metrics_serve */
+    uint32_t shards;
+};
+
+/* 1 + a number unique to the thread, 0 until its first update. */
+static _Atomic uint32_t fossil__metrics_threads;
+static FOSSIL__METRICS_TLS uint32_t fossil__metrics_slot;
+
+static inline uint32_t fossil__metrics_shard(const fossil_net_metric_t *m) {
+    uint32_t slot = fossil__metrics_slot;
+    if (!slot)
+        slot = fossil__metrics_slot = atomic_fetch_add_explicit(&fossil__metrics_threads, 1, memory_order_relaxed) + 1;
+    return (slot - 1) & m->mask;
+}
+
+/*=============================================================================
+HISTOGRAM BUCKETS
+=============================================================================*/
+
+/* Values below SUB get a bucket each; above, each power of two is split SUB ways. */
+static inline uint32_t fossil__metrics_bucket(uint64_t v) {
+    if (v < FOSSIL__METRICS_SUB) return (uint32_t)v;
+    uint32_t msb = fossil__metrics_msb(v);
+    if (msb > FOSSIL__METRICS_MAX_MSB) return FOSSIL__METRICS_BUCKETS - 1;
+    uint32_t shift = msb - FOSSIL__METRICS_SUB_BITS;
+    return (shift + 1) * FOSSIL__METRICS_SUB + (uint32_t)((v >> shift) & (FOSSIL__METRICS_SUB - 1));
+}
+
+/* Smallest value of a bucket. */
+static uint64_t fossil__metrics_bucket_low(uint32_t i) {
+    if (i < FOSSIL__METRICS_SUB) return i;
+    uint32_t shift = i / FOSSIL__METRICS_SUB - 1;
+    return (uint64_t)(FOSSIL__METRICS_SUB + i % FOSSIL__METRICS_SUB) << shift;
+}
+
+/* Sum the shards of a histogram; returns the count. */
+static uint64_t fossil__metrics_hist_read(const fossil_net_metric_t *m, uint64_t *buckets, uint64_t *sum) {
+    uint64_t count = 0;
+    if (sum) *sum = 0;
+    memset(buckets, 0, FOSSIL__METRICS_BUCKETS * sizeof(*buckets));
+    for (uint32_t s = 0; s <= m->mask; s++) {
+        const fossil__metrics_hshard_t *h = &m->hist[s];
+        for (uint32_t i = 0; i < FOSSIL__METRICS_BUCKETS; i++) {
+            uint64_t n = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+            buckets[i] += n;
+            count += n;
+        }
+        if (sum) *sum += atomic_load_explicit(&h->sum, memory_order_relaxed);
+    }
+    return count;
+}
+
+/*=============================================================================
+TEXT
+=============================================================================*/
+
+static void fossil__text_printf(fossil__metrics_text_t *t, const char *fmt, ...) {
+    if (t->failed) return;
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(t->p ? t->p + t->len : NULL, t->p ? t->cap - t->len : 0, fmt, ap);
+        va_end(ap);
+        if (n < 0) {
+            t->failed = true;
+            return;
+        }
+        if (t->p && t->len + (size_t)n < t->cap) {
+            t->len += (size_t)n;
+            return;
+        }
+        size_t cap = t->cap ? t->cap : 4096;
+        while (cap <= t->len + (size_t)n) cap *= 2;
+        char *p = realloc(t->p, cap);
+        if (!p) {
+            t->failed = true;
+            return;
+        }
+        t->p = p;
+        t->cap = cap;
+    }
+}
+
+/* Write s with backslash and newline escaped, and double quotes too if quoted. */
+static void fossil__text_escaped(fossil__metrics_text_t *t, const char *s, bool quoted) {
+    for (; *s; s++) {
+        if (*s == '\\') fossil__text_printf(t, "\\\\");
+        else if (*s == '\n') fossil__text_printf(t, "\\n");
+        else if (*s == '"' && quoted) fossil__text_printf(t, "\\\"");
+        else fossil__text_printf(t, "%c", *s);
+    }
+}
+
+static void fossil__text_header(fossil__metrics_text_t *t, const char *name, const char *help, fossil_net_metric_type_t type) {
+    static const char *const types[] = {"counter", "gauge", "histogram"};
+    fossil__text_printf(t, "# HELP %s ", name);
+    fossil__text_escaped(t, help ? help : "", false);
+    fossil__text_printf(t, "\n# TYPE %s %s\n", name, types[type]);
+}
+
+/* name{labels,extra} with the braces left out when there are no labels. */
+static void fossil__text_series(fossil__metrics_text_t *t, const char *name, const char *suffix,
+                                const char *labels, const char *extra) {
+    fossil__text_printf(t, "%s%s", name, suffix);
+    bool l = labels && *labels, e = extra && *extra;
+    if (l || e) fossil__text_printf(t, "{%s%s%s}", l ? labels : "", l && e ? "," : "", e ? extra : "");
+}
+
+static void fossil__render_metric(fossil__metrics_text_t *t, const fossil_net_metric_t *m) {
+    const fossil__metrics_family_t *f = m->family;
+    if (f->type != FOSSIL_NET_METRIC_HISTOGRAM) {
+        fossil__text_series(t, f->name, "", m->labels, NULL);
+        fossil__text_printf(t, " %lld\n", (long long)fossil_net_metric_value(m));
+        return;
+    }
+    uint64_t buckets[FOSSIL__METRICS_BUCKETS], sum;
+    uint64_t count = fossil__metrics_hist_read(m, buckets, &sum);
+    uint64_t below = 0;
+    uint32_t i = 0;
+    for (uint32_t k = FOSSIL__METRICS_LE_FIRST; k <= FOSSIL__METRICS_LE_LAST; k++) {
+        /* 2^k starts a bucket, so the buckets before it hold exactly the smaller values. */
+        uint32_t end = fossil__metrics_bucket(1ull << k);
+        for (; i < end; i++) below += buckets[i];
+        char le[48];
+        snprintf(le, sizeof(le), "le=\"%.12g\"", (double)(1ull << k) / 1e9);
+        fossil__text_series(t, f->name, "_bucket", m->labels, le);
+        fossil__text_printf(t, " %llu\n", (unsigned long long)below);
+    }
+    fossil__text_series(t, f->name, "_bucket", m->labels, "le=\"+Inf\"");
+    fossil__text_printf(t, " %llu\n", (unsigned long long)count);
+    fossil__text_series(t, f->name, "_sum", m->labels, NULL);
+    fossil__text_printf(t, " %llu.%09llu\n", (unsigned long long)(sum / 1000000000ull),
+                        (unsigned long long)(sum % 1000000000ull));
+    fossil__text_series(t, f->name, "_count", m->labels, NULL);
+    fossil__text_printf(t, " %llu\n", (unsigned long long)count);
+}
+
+/*=============================================================================
+REGISTRY
+=============================================================================*/
+
+static bool fossil__metrics_valid_name(const char *name) {
+    if (!name || !*name || strlen(name) >= FOSSIL__METRICS_MAX_NAME) return false;
+    for (const char *p = name; *p; p++) {
+        char c = *p;
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        if (!alpha && !(p != name && c >= '0' && c <= '9')) return false;
+    }
+    return true;
+}
+
+static bool fossil__metrics_valid_labels(const char *labels) {
+    return strlen(labels) < FOSSIL__METRICS_MAX_LABELS && !strchr(labels, '\n');
+}
+
+static void fossil__metrics_free_metric(fossil_net_metric_t *m) {
+    free(m->cells);
+    free(m->hist);
+    free(m);
+}
+
+fossil_net_metrics_t *fossil_net_metrics_create(const fossil_net_metrics_config_t *config) {
+    fossil_net_metrics_t *m = calloc(1, sizeof(*m));
+    if (!m) return NULL;
+    uint32_t want = config && config->shards ? config->shards : fossil__metrics_cpus();
+    if (want > FOSSIL__METRICS_MAX_SHARDS) want = FOSSIL__METRICS_MAX_SHARDS;
+    m->shards = 1;
+    while (m->shards < want) m->shards <<= 1;
+    fossil__metrics_mutex_init(&m->lock);
+    return m;
+}
+
+void fossil_net_metrics_destroy(fossil_net_metrics_t *metrics) {
+    if (!metrics) return;
+    fossil_net_httpd_destroy(metrics->httpd);
+    while (metrics->families) {
+        fossil__metrics_family_t *f = metrics->families;
+        metrics->families = f->next;
+        while (f->series) {
+            fossil_net_metric_t *next = f->series->next;
+            fossil__metrics_free_metric(f->series);
+            f->series = next;
+        }
+        free(f->help);
+        free(f);
+    }
+    while (metrics->collectors) {
+        fossil__metrics_collector_t *next = metrics->collectors->next;
+        free(metrics->collectors);
+        metrics->collectors = next;
+    }
+    fossil__metrics_mutex_destroy(&metrics->lock);
+    free(metrics);
+}
+
+static fossil_net_metric_t *fossil__metrics_register(
+    fossil_net_metrics_t *metrics,
+    fossil_net_metric_type_t type,
+    const char *name,
+    const char *help,
+    const char *labels)
+{
+    if (!labels) labels = "";
+    if (!metrics || !fossil__metrics_valid_name(name) || !fossil__metrics_valid_labels(labels)) return NULL;
+    fossil__metrics_mutex_lock(&metrics->lock);
+    fossil__metrics_family_t **fp = &metrics->families;
+    while (*fp && strcmp((*fp)->name, name) != 0) fp = &(*fp)->next;
+    fossil__metrics_family_t *f = *fp;
+    fossil_net_metric_t *m = NULL;
+    if (f && f->type != type) goto out;
+    if (!f) {
+        size_t n = strlen(name) + 1, h = strlen(help ? help : "") + 1;
+        f = calloc(1, sizeof(*f) + n);
+        if (!f || !(f->help = malloc(h))) {
+            free(f);
+            goto out;
+        }
+        memcpy(f->name, name, n);
+        memcpy(f->help, help ? help : "", h);
+        f->type = type;
+        *fp = f;
+    }
+    fossil_net_metric_t **mp = &f->series;
+    while (*mp && strcmp((*mp)->labels, labels) != 0) mp = &(*mp)->next;
+    if (*mp) {
+        m = *mp;
+        goto out;
+    }
+    size_t n = strlen(labels) + 1;
+    m = calloc(1, sizeof(*m) + n);
+    if (!m) goto out;
+    memcpy(m->labels, labels, n);
+    m->family = f;
+    m->mask = metrics->shards - 1;
+    if (type == FOSSIL_NET_METRIC_COUNTER) m->cells = calloc(metrics->shards, sizeof(*m->cells));
+    if (type == FOSSIL_NET_METRIC_HISTOGRAM) m->hist = calloc(metrics->shards, sizeof(*m->hist));
+    if (type != FOSSIL_NET_METRIC_GAUGE && !m->cells && !m->hist) {
+        fossil__metrics_free_metric(m);
+        m = NULL;
+        goto out;
+    }
+    *mp = m;
+out:
+    fossil__metrics_mutex_unlock(&metrics->lock);
+    return m;
+}
+
+fossil_net_metric_t *fossil_net_metrics_counter(
+    fossil_net_metrics_t *metrics, const char *name, const char *help, const char *labels)
+{
+    return fossil__metrics_register(metrics, FOSSIL_NET_METRIC_COUNTER, name, help, labels);
+}
+
+fossil_net_metric_t *fossil_net_metrics_gauge(
+    fossil_net_metrics_t *metrics, const char *name, const char *help, const char *labels)
+{
+    return fossil__metrics_register(metrics, FOSSIL_NET_METRIC_GAUGE, name, help, labels);
+}
+
+fossil_net_metric_t *fossil_net_metrics_histogram(
+    fossil_net_metrics_t *metrics, const char *name, const char *help, const char *labels)
+{
+    return fossil__metrics_register(metrics, FOSSIL_NET_METRIC_HISTOGRAM, name, help, labels);
+}
+
+int fossil_net_metrics_label(char *buf, size_t cap, const char *name, const char *value) {
+    if (!buf || !cap || !fossil__metrics_valid_name(name) || !value) return -1;
+    size_t len = strlen(buf);
+    if (len >= cap) return -1;
+    size_t at = len;
+    int n = snprintf(buf + at, cap - at, "%s%s=\"", len ? "," : "", name);
+    if (n < 0 || (size_t)n >= cap - at) goto fail;
+    at += (size_t)n;
+    for (const char *p = value; *p; p++) {
+        const char *esc = *p == '\\' ? "\\\\" : *p == '"' ? "\\\"" : *p == '\n' ? "\\n" : NULL;
+        size_t k = esc ? 2 : 1;
+        if (at + k >= cap) goto fail;
+        if (esc) memcpy(buf + at, esc, 2);
+        else buf[at] = *p;
+        at += k;
+    }
+    if (at + 1 >= cap) goto fail;
+    buf[at++] = '"';
+    buf[at] = '\0';
+    return 0;
+fail:
+    buf[len] = '\0';
+    return -1;
+}
+
+/*=============================================================================
+RECORDING
+=============================================================================*/
+
+void fossil_net_metric_add(fossil_net_metric_t *metric, uint64_t n) {
+    if (!metric || !metric->cells) return;
+    atomic_fetch_add_explicit(&metric->cells[fossil__metrics_shard(metric)].value, n, memory_order_relaxed);
+}
+
+void fossil_net_metric_set(fossil_net_metric_t *metric, int64_t value) {
+    if (!metric || metric->family->type != FOSSIL_NET_METRIC_GAUGE) return;
+    atomic_store_explicit(&metric->gauge, value, memory_order_relaxed);
+}
+
+void fossil_net_metric_gauge_add(fossil_net_metric_t *metric, int64_t delta) {
+    if (!metric || metric->family->type != FOSSIL_NET_METRIC_GAUGE) return;
+    atomic_fetch_add_explicit(&metric->gauge, delta, memory_order_relaxed);
+}
+
+void fossil_net_metric_observe(fossil_net_metric_t *metric, uint64_t ns) {
+    if (!metric || !metric->hist) return;
+    fossil__metrics_hshard_t *h = &metric->hist[fossil__metrics_shard(metric)];
+    atomic_fetch_add_explicit(&h->buckets[fossil__metrics_bucket(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum, ns, memory_order_relaxed);
+}
+
+int64_t fossil_net_metric_value(const fossil_net_metric_t *metric) {
+    if (!metric) return 0;
+    if (metric->family->type == FOSSIL_NET_METRIC_GAUGE)
+        return atomic_load_explicit(&metric->gauge, memory_order_relaxed);
+    uint64_t total = 0;
+    if (metric->cells) {
+        for (uint32_t s = 0; s <= metric->mask; s++)
+            total += atomic_load_explicit(&metric->cells[s].value, memory_order_relaxed);
+    } else {
+        uint64_t buckets[FOSSIL__METRICS_BUCKETS];
+        total = fossil__metrics_hist_read(metric, buckets, NULL);
+    }
+    return (int64_t)total;
+}
+
+uint64_t fossil_net_metric_quantile(const fossil_net_metric_t *metric, double q) {
+    if (!metric || !metric->hist) return 0;
+    uint64_t buckets[FOSSIL__METRICS_BUCKETS];
+    uint64_t count = fossil__metrics_hist_read(metric, buckets, NULL);
+    if (!count) return 0;
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+    uint64_t rank = (uint64_t)(q * (double)count);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    uint64_t seen = 0;
+    uint32_t i = 0;
+    for (; i < FOSSIL__METRICS_BUCKETS - 1; i++) {
+        seen += buckets[i];
+        if (seen >= rank) break;
+    }
+    uint64_t low = fossil__metrics_bucket_low(i);
+    return low + (fossil__metrics_bucket_low(i + 1) - low) / 2;
+}
+
+/*=============================================================================
+COLLECTORS
+=============================================================================*/
+
+int fossil_net_metrics_add_collector(
+    fossil_net_metrics_t *metrics,
+    const char *labels,
+    fossil_net_metrics_collect_fn fn,
+    void *arg)
+{
+    if (!labels) labels = "";
+    if (!metrics || !fn || !fossil__metrics_valid_labels(labels)) return -1;
+    size_t n = strlen(labels) + 1;
+    fossil__metrics_collector_t *c = calloc(1, sizeof(*c) + n);
+    if (!c) return -1;
+    c->fn = fn;
+    c->arg = arg;
+    memcpy(c->labels, labels, n);
+    fossil__metrics_mutex_lock(&metrics->lock);
+    fossil__metrics_collector_t **cp = &metrics->collectors;
+    while (*cp) cp = &(*cp)->next;
+    *cp = c;
+    fossil__metrics_mutex_unlock(&metrics->lock);
+    return 0;
+}
+
+int fossil_net_metrics_remove_collector(
+    fossil_net_metrics_t *metrics,
+    fossil_net_metrics_collect_fn fn,
+    void *arg)
+{
+    if (!metrics) return -1;
+    fossil__metrics_mutex_lock(&metrics->lock);
+    fossil__metrics_collector_t **cp = &metrics->collectors;
+    while (*cp && ((*cp)->fn != fn || (*cp)->arg != arg)) cp = &(*cp)->next;
+    fossil__metrics_collector_t *c = *cp;
+    if (c) *cp = c->next;
+    fossil__metrics_mutex_unlock(&metrics->lock);
+    free(c);
+    return c ? 0 : -1;
+}
+
+void fossil_net_metrics_emit(
+    fossil_net_metrics_sink_t *sink,
+    fossil_net_metric_type_t type,
+    const char *name,
+    const char *help,
+    const char *labels,
+    double value)
+{
+    if (!sink || sink->failed || type == FOSSIL_NET_METRIC_HISTOGRAM || !fossil__metrics_valid_name(name)) return;
+    if (!help) help = "";
+    if (!labels) labels = "";
+    const char *base = sink->collector->labels;
+    if (sink->count == sink->cap) {
+        uint32_t cap = sink->cap ? sink->cap * 2 : 64;
+        fossil__metrics_sample_t *s = realloc(sink->samples, cap * sizeof(*s));
+        if (!s) {
+            sink->failed = true;
+            return;
+        }
+        sink->samples = s;
+        sink->cap = cap;
+    }
+    /* Strings live in one block behind the sample's name. */
+    size_t n = strlen(name) + 1, h = strlen(help) + 1, b = strlen(base), l = strlen(labels);
+    char *p = malloc(n + h + b + l + 2);
+    if (!p) {
+        sink->failed = true;
+        return;
+    }
+    fossil__metrics_sample_t *s = &sink->samples[sink->count++];
+    s->type = type;
+    s->value = value;
+    s->done = false;
+    s->name = memcpy(p, name, n);
+    s->help = memcpy(p + n, help, h);
+    char *lp = p + n + h;
+    memcpy(lp, base, b);
+    if (b && l) lp[b++] = ',';
+    memcpy(lp + b, labels, l);
+    lp[b + l] = '\0';
+    s->labels = lp;
+}
+
+static void fossil__metrics_render_samples(fossil__metrics_text_t *t, fossil_net_metrics_sink_t *sink) {
+    for (uint32_t i = 0; i < sink->count; i++) {
+        fossil__metrics_sample_t *first = &sink->samples[i];
+        if (first->done) continue;
+        fossil__text_header(t, first->name, first->help, first->type);
+        for (uint32_t j = i; j < sink->count; j++) {
+            fossil__metrics_sample_t *s = &sink->samples[j];
+            if (s->done || strcmp(s->name, first->name) != 0) continue;
+            s->done = true;
+            fossil__text_series(t, s->name, "", s->labels, NULL);
+            fossil__text_printf(t, " %.17g\n", s->value);
+        }
+    }
+}
+
+static void fossil__metrics_reactor_collect(fossil_net_metrics_sink_t *sink, void *arg) {
+    fossil_net_reactor_stats_t st;
+    if (fossil_net_reactor_get_stats(arg, &st) != 0) return;
+    const fossil_net_metric_type_t c = FOSSIL_NET_METRIC_COUNTER;
+    fossil_net_metrics_emit(sink, c, "fossil_net_accepted_total", "Connections accepted.", NULL, (double)st.accepted);
+    fossil_net_metrics_emit(sink, c, "fossil_net_rejected_total", "Connections refused by the accept callback.", NULL, (double)st.rejected);
+    fossil_net_metrics_emit(sink, c, "fossil_net_closed_total", "Connections closed.", NULL, (double)st.closed);
+    fossil_net_metrics_emit(sink, FOSSIL_NET_METRIC_GAUGE, "fossil_net_connections_active", "Open connections.", NULL, (double)st.active);
+    fossil_net_metrics_emit(sink, c, "fossil_net_accept_errors_total", "Failed accepts.", NULL, (double)st.accept_errors);
+    fossil_net_metrics_emit(sink, c, "fossil_net_shed_total", "Connections and datagrams refused by admission control.", NULL, (double)st.shed);
+    fossil_net_metrics_emit(sink, c, "fossil_net_idle_closed_total", "Idle connections closed to shed load.", NULL, (double)st.idle_closed);
+    fossil_net_metrics_emit(sink, c, "fossil_net_received_bytes_total", "Bytes received.", NULL, (double)st.bytes_in);
+    fossil_net_metrics_emit(sink, c, "fossil_net_sent_bytes_total", "Bytes sent or queued for sending.", NULL, (double)st.bytes_out);
+    fossil_net_metrics_emit(sink, c, "fossil_net_datagrams_total", "Datagrams received.", NULL, (double)st.datagrams);
+    fossil_net_metrics_emit(sink, c, "fossil_net_datagram_replies_total", "Datagram replies sent.", NULL, (double)st.replies);
+    fossil_net_metrics_emit(sink, c, "fossil_net_datagram_reply_drops_total", "Datagram replies dropped.", NULL, (double)st.reply_drops);
+}
+
+int fossil_net_metrics_attach_reactor(
+    fossil_net_metrics_t *metrics,
+    fossil_net_reactor_t *reactor,
+    const char *labels)
+{
+    if (!reactor) return -1;
+    return fossil_net_metrics_add_collector(metrics, labels, fossil__metrics_reactor_collect, reactor);
+}
+
+int fossil_net_metrics_detach_reactor(fossil_net_metrics_t *metrics, fossil_net_reactor_t *reactor) {
+    return fossil_net_metrics_remove_collector(metrics, fossil__metrics_reactor_collect, reactor);
+}
+
+/*=============================================================================
+EXPOSITION
+=============================================================================*/
+
+int fossil_net_metrics_render(fossil_net_metrics_t *metrics, char **text, uint32_t *len) {
+    if (text) *text = NULL;
+    if (len) *len = 0;
+    if (!metrics || !text) return -1;
+    fossil__metrics_text_t t = {0};
+    fossil_net_metrics_sink_t sink = {0};
+    fossil__metrics_mutex_lock(&metrics->lock);
+    for (const fossil__metrics_family_t *f = metrics->families; f; f = f->next) {
+        if (!f->series) continue;
+        fossil__text_header(&t, f->name, f->help, f->type);
+        for (const fossil_net_metric_t *m = f->series; m; m = m->next)
+            fossil__render_metric(&t, m);
+    }
+    for (const fossil__metrics_collector_t *c = metrics->collectors; c; c = c->next) {
+        sink.collector = c;
+        c->fn(&sink, c->arg);
+    }
+    fossil__metrics_mutex_unlock(&metrics->lock);
+    fossil__metrics_render_samples(&t, &sink);
+    for (uint32_t i = 0; i < sink.count; i++)
+        free((void*)sink.samples[i].name);
+    free(sink.samples);
+
+    /* An empty registry still renders as an empty document. */
+    if (!t.p && !t.failed && !(t.p = calloc(1, 1))) t.failed = true;
+    if (t.failed || sink.failed || t.len > UINT32_MAX) {
+        free(t.p);
+        return -1;
+    }
+    *text = t.p;
+    if (len) *len = (uint32_t)t.len;
+    return 0;
+}
+
+static void fossil__metrics_handle(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    char *text;
+    uint32_t len;
+    if (fossil_net_metrics_render(user, &text, &len) != 0) {
+        fossil_net_http_respond(ex, 500, "text/plain", "Internal Server Error", 21);
+        return;
+    }
+    fossil_net_http_respond(ex, 200, FOSSIL__METRICS_CONTENT_TYPE, text, len);
+    free(text);
+}
+
+int fossil_net_metrics_serve(fossil_net_metrics_t *metrics, fossil_net_server_t *server) {
+    if (!metrics || !server || metrics->httpd) return -1;
+    fossil_net_httpd_config_t cfg = {0};
+    cfg.reactor.threads = 1;
+    fossil_net_httpd_t *h = fossil_net_httpd_create(server, &cfg);
+    if (!h) return -1;
+    if (fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/metrics", fossil__metrics_handle, metrics) != 0 ||
+        fossil_net_httpd_start(h) != 0) {
+        fossil_net_httpd_destroy(h);
+        return -1;
+    }
+    metrics->httpd = h;
+    return 0;
+}
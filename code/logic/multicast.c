@@ -0,0 +1,416 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+// Must be defined before any system header for in6_pktinfo, recvmmsg & co.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#elif defined(__APPLE__)
+#ifndef _DARWIN_C_SOURCE
+#define _DARWIN_C_SOURCE
+#endif
+#endif
+
+#include "fossil/network/multicast.h"
+#include "fossil/network/inet.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <net/if.h>
+#include <errno.h>
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+
+/*=============================================================================
+HELPERS
+=============================================================================*/
+
+#if defined(_WIN32)
+typedef SOCKET fossil__mc_fd_t;
+#define FOSSIL__MC_FD(sock) ((SOCKET)(intptr_t)(sock)->fd)
+#else
+typedef int fossil__mc_fd_t;
+#define FOSSIL__MC_FD(sock) ((sock)->fd)
+#endif
+
+static int fossil__mc_setopt(const fossil_net_socket_t *sock, int level, int name, const void *val, size_t len) {
+    return setsockopt(FOSSIL__MC_FD(sock), level, name, (const char*)val, (socklen_t)len) == 0 ? 0 : -1;
+}
+
+static bool fossil__mc_is_ipv6(const fossil_net_socket_t *sock) {
+    return sock->family == FOSSIL_NET_SOCKET_FAMILY_IPV6;
+}
+
+uint32_t fossil_net_multicast_if_index(const char *iface) {
+    if (!iface || !*iface) return 0;
+    if (iface[0] >= '0' && iface[0] <= '9' && !strchr(iface, '.') && !strchr(iface, ':')) {
+        char *end = NULL;
+        unsigned long v = strtoul(iface, &end, 10);
+        return (end && *end == '\0' && v <= UINT32_MAX) ? (uint32_t)v : 0;
+    }
+    return (uint32_t)if_nametoindex(iface);
+}
+
+/* Resolve the iface argument: either an IPv4 address or an interface index. */
+static int fossil__mc_iface(const char *iface, uint32_t *index, struct in_addr *addr4, bool *is_addr) {
+    *index = 0;
+    *is_addr = false;
+    addr4->s_addr = htonl(INADDR_ANY);
+    if (!iface || !*iface) return 0;
+    uint8_t ip[4];
+    if (fossil_net_inet_ipv4_parse(iface, ip) == 0) {
+        memcpy(addr4, ip, 4);
+        *is_addr = true;
+        return 0;
+    }
+    *index = fossil_net_multicast_if_index(iface);
+    return *index ? 0 : -1;
+}
+
+static int fossil__mc_parse(const char *string, fossil_net_endpoint_t *ep) {
+    if (!string) return -1;
+    return fossil_net_endpoint_parse(ep, string, 0);
+}
+
+/*=============================================================================
+GROUP MEMBERSHIP
+=============================================================================*/
+
+/*
+ * IPv4 joins by address or default use the classic IP_ADD_MEMBERSHIP /
+ * IP_ADD_SOURCE_MEMBERSHIP; joins on a named interface and all IPv6 joins
+ * use the protocol-independent MCAST_* options, which take an index.
+ */
+static int fossil__mc_membership(fossil_net_socket_t *sock, const char *group, const char *source,
+                                 const char *iface, bool join) {
+    if (!sock || sock->fd < 0) return -1;
+    fossil_net_endpoint_t g, s;
+    if (fossil__mc_parse(group, &g) != 0) return -1;
+    if (source && (fossil__mc_parse(source, &s) != 0 || s.family != g.family)) return -1;
+
+    uint32_t index;
+    struct in_addr addr4;
+    bool is_addr;
+    if (fossil__mc_iface(iface, &index, &addr4, &is_addr) != 0) return -1;
+
+    if (g.family == FOSSIL_NET_SOCKET_FAMILY_IPV4 && (is_addr || index == 0)) {
+        if (!source) {
+            struct ip_mreq mreq;
+            memset(&mreq, 0, sizeof(mreq));
+            memcpy(&mreq.imr_multiaddr, g.ip, 4);
+            mreq.imr_interface = addr4;
+            return fossil__mc_setopt(sock, IPPROTO_IP, join ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP,
+                                     &mreq, sizeof(mreq));
+        }
+#if defined(IP_ADD_SOURCE_MEMBERSHIP)
+        struct ip_mreq_source mreq;
+        memset(&mreq, 0, sizeof(mreq));
+        memcpy(&mreq.imr_multiaddr, g.ip, 4);
+        memcpy(&mreq.imr_sourceaddr, s.ip, 4);
+        mreq.imr_interface = addr4;
+        return fossil__mc_setopt(sock, IPPROTO_IP, join ? IP_ADD_SOURCE_MEMBERSHIP : IP_DROP_SOURCE_MEMBERSHIP,
+                                 &mreq, sizeof(mreq));
+#else
+        return -1;
+#endif
+    }
+    if (is_addr) return -1; // an IPv4 interface address cannot select an IPv6 interface
+
+#if defined(MCAST_JOIN_GROUP) && defined(MCAST_JOIN_SOURCE_GROUP)
+    int level = g.family == FOSSIL_NET_SOCKET_FAMILY_IPV6 ? IPPROTO_IPV6 : IPPROTO_IP;
+    if (!source) {
+        struct group_req req;
+        memset(&req, 0, sizeof(req));
+        req.gr_interface = index;
+        fossil_net_endpoint_to_sockaddr(&g, &req.gr_group);
+        return fossil__mc_setopt(sock, level, join ? MCAST_JOIN_GROUP : MCAST_LEAVE_GROUP, &req, sizeof(req));
+    }
+    struct group_source_req req;
+    memset(&req, 0, sizeof(req));
+    req.gsr_interface = index;
+    fossil_net_endpoint_to_sockaddr(&g, &req.gsr_group);
+    fossil_net_endpoint_to_sockaddr(&s, &req.gsr_source);
+    return fossil__mc_setopt(sock, level, join ? MCAST_JOIN_SOURCE_GROUP : MCAST_LEAVE_SOURCE_GROUP,
+                             &req, sizeof(req));
+#else
+    if (source || g.family != FOSSIL_NET_SOCKET_FAMILY_IPV6) return -1;
+    struct ipv6_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    memcpy(&mreq.ipv6mr_multiaddr, g.ip, 16);
+    mreq.ipv6mr_interface = index;
+    return fossil__mc_setopt(sock, IPPROTO_IPV6, join ? IPV6_JOIN_GROUP : IPV6_LEAVE_GROUP, &mreq, sizeof(mreq));
+#endif
+}
+
+int fossil_net_multicast_join(fossil_net_socket_t *sock, const char *group, const char *iface) {
+    return fossil__mc_membership(sock, group, NULL, iface, true);
+}
+
+int fossil_net_multicast_leave(fossil_net_socket_t *sock, const char *group, const char *iface) {
+    return fossil__mc_membership(sock, group, NULL, iface, false);
+}
+
+int fossil_net_multicast_join_source(fossil_net_socket_t *sock, const char *group, const char *source, const char *iface) {
+    if (!source) return -1;
+    return fossil__mc_membership(sock, group, source, iface, true);
+}
+
+int fossil_net_multicast_leave_source(fossil_net_socket_t *sock, const char *group, const char *source, const char *iface) {
+    if (!source) return -1;
+    return fossil__mc_membership(sock, group, source, iface, false);
+}
+
+/*=============================================================================
+SEND OPTIONS
+=============================================================================*/
+
+/* IPv4 byte-sized options are u_char on the BSDs and int on Linux/Windows. */
+static int fossil__mc_setopt_byte(fossil_net_socket_t *sock, int name, unsigned value) {
+#if defined(__linux__) || defined(_WIN32)
+    int v = (int)value;
+#else
+    unsigned char v = (unsigned char)value;
+#endif
+    return fossil__mc_setopt(sock, IPPROTO_IP, name, &v, sizeof(v));
+}
+
+int fossil_net_multicast_set_ttl(fossil_net_socket_t *sock, uint8_t ttl) {
+    if (!sock || sock->fd < 0) return -1;
+    if (fossil__mc_is_ipv6(sock)) {
+        int hops = ttl;
+        return fossil__mc_setopt(sock, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops, sizeof(hops));
+    }
+    return fossil__mc_setopt_byte(sock, IP_MULTICAST_TTL, ttl);
+}
+
+int fossil_net_multicast_set_loopback(fossil_net_socket_t *sock, bool enabled) {
+    if (!sock || sock->fd < 0) return -1;
+    if (fossil__mc_is_ipv6(sock)) {
+        unsigned int loop = enabled ? 1u : 0u;
+        return fossil__mc_setopt(sock, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    return fossil__mc_setopt_byte(sock, IP_MULTICAST_LOOP, enabled ? 1u : 0u);
+}
+
+int fossil_net_multicast_set_interface(fossil_net_socket_t *sock, const char *iface) {
+    if (!sock || sock->fd < 0) return -1;
+    uint32_t index;
+    struct in_addr addr4;
+    bool is_addr;
+    if (fossil__mc_iface(iface, &index, &addr4, &is_addr) != 0) return -1;
+
+    if (fossil__mc_is_ipv6(sock)) {
+        if (is_addr) return -1;
+        unsigned int idx = index;
+        return fossil__mc_setopt(sock, IPPROTO_IPV6, IPV6_MULTICAST_IF, &idx, sizeof(idx));
+    }
+    if (is_addr || index == 0)
+        return fossil__mc_setopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &addr4, sizeof(addr4));
+#if defined(__linux__)
+    struct ip_mreqn mreqn;
+    memset(&mreqn, 0, sizeof(mreqn));
+    mreqn.imr_ifindex = (int)index;
+    return fossil__mc_setopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &mreqn, sizeof(mreqn));
+#elif defined(_WIN32)
+    // Windows takes an index in network order when the first octet is zero
+    DWORD idx = htonl(index);
+    return fossil__mc_setopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &idx, sizeof(idx));
+#else
+    return -1;
+#endif
+}
+
+/*=============================================================================
+RECEIVE
+=============================================================================*/
+
+int fossil_net_multicast_enable_pktinfo(fossil_net_socket_t *sock, bool enabled) {
+    if (!sock || sock->fd < 0) return -1;
+    int on = enabled ? 1 : 0;
+    if (fossil__mc_is_ipv6(sock)) {
+#if defined(IPV6_RECVPKTINFO)
+        if (fossil__mc_setopt(sock, IPPROTO_IPV6, IPV6_RECVPKTINFO, &on, sizeof(on)) != 0) return -1;
+#elif defined(IPV6_PKTINFO)
+        if (fossil__mc_setopt(sock, IPPROTO_IPV6, IPV6_PKTINFO, &on, sizeof(on)) != 0) return -1;
+#else
+        return -1;
+#endif
+#if defined(IP_PKTINFO)
+        // Dual-stack sockets also see IPv4 groups; failure here is harmless
+        (void)fossil__mc_setopt(sock, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on));
+#endif
+        return 0;
+    }
+#if defined(IP_PKTINFO)
+    return fossil__mc_setopt(sock, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on));
+#else
+    return -1;
+#endif
+}
+
+#if !defined(_WIN32)
+
+/* Room for either pktinfo control message (IPv4 and IPv6 on dual-stack). */
+#define FOSSIL__MC_CMSG_SPACE 128
+
+typedef union fossil__mc_cmsg {
+    char buf[FOSSIL__MC_CMSG_SPACE];
+    struct cmsghdr align;
+} fossil__mc_cmsg_t;
+
+static void fossil__mc_prepare(fossil_net_multicast_msg_t *m, struct msghdr *hdr, struct iovec *iov,
+                               struct sockaddr_storage *from, fossil__mc_cmsg_t *ctl) {
+    iov->iov_base = m->buffer;
+    iov->iov_len = m->size;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->msg_name = from;
+    hdr->msg_namelen = sizeof(*from);
+    hdr->msg_iov = iov;
+    hdr->msg_iovlen = 1;
+    hdr->msg_control = ctl->buf;
+    hdr->msg_controllen = sizeof(ctl->buf);
+}
+
+static void fossil__mc_finish(fossil_net_multicast_msg_t *m, struct msghdr *hdr,
+                              const struct sockaddr_storage *from, size_t length) {
+    m->length = (uint32_t)length;
+    m->flags = (hdr->msg_flags & MSG_TRUNC) ? FOSSIL_NET_MULTICAST_MSG_TRUNCATED : 0;
+    m->ifindex = 0;
+    memset(&m->group, 0, sizeof(m->group));
+    if (fossil_net_endpoint_from_sockaddr(&m->source, from) != 0)
+        memset(&m->source, 0, sizeof(m->source));
+
+    for (struct cmsghdr *c = CMSG_FIRSTHDR(hdr); c; c = CMSG_NXTHDR(hdr, c)) {
+#if defined(IP_PKTINFO)
+        if (c->cmsg_level == IPPROTO_IP && c->cmsg_type == IP_PKTINFO) {
+            struct in_pktinfo pi;
+            memcpy(&pi, CMSG_DATA(c), sizeof(pi));
+            m->group.family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+            memcpy(m->group.ip, &pi.ipi_addr, 4);
+            m->ifindex = (uint32_t)pi.ipi_ifindex;
+        }
+#endif
+#if defined(IPV6_PKTINFO)
+        if (c->cmsg_level == IPPROTO_IPV6 && c->cmsg_type == IPV6_PKTINFO) {
+            struct in6_pktinfo pi;
+            memcpy(&pi, CMSG_DATA(c), sizeof(pi));
+            m->group.family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+            memcpy(m->group.ip, &pi.ipi6_addr, 16);
+            m->ifindex = (uint32_t)pi.ipi6_ifindex;
+        }
+#endif
+    }
+}
+
+#endif
+
+int fossil_net_multicast_receive(fossil_net_socket_t *sock, fossil_net_multicast_msg_t *msgs,
+                                 uint32_t count, uint32_t *received) {
+    if (received) *received = 0;
+    if (!sock || sock->fd < 0 || !msgs || count == 0) return -1;
+    if (count > FOSSIL_NET_MULTICAST_BATCH_MAX) count = FOSSIL_NET_MULTICAST_BATCH_MAX;
+
+#if defined(_WIN32)
+    // WSARecvMsg needs an extension lookup per socket; report addresses only.
+    uint32_t n = 0;
+    for (; n < count; ++n) {
+        fossil_net_multicast_msg_t *m = &msgs[n];
+        if (n > 0) {
+            u_long avail = 0;
+            if (ioctlsocket(FOSSIL__MC_FD(sock), FIONREAD, &avail) != 0 || avail == 0) break;
+        }
+        struct sockaddr_storage from;
+        int fromlen = sizeof(from);
+        int r = recvfrom(FOSSIL__MC_FD(sock), (char*)m->buffer, (int)m->size, 0, (struct sockaddr*)&from, &fromlen);
+        if (r < 0) {
+            if (n > 0) break;
+            if (WSAGetLastError() == WSAEMSGSIZE) { r = (int)m->size; m->flags = FOSSIL_NET_MULTICAST_MSG_TRUNCATED; }
+            else return -1;
+        } else {
+            m->flags = 0;
+        }
+        m->length = (uint32_t)r;
+        m->ifindex = 0;
+        memset(&m->group, 0, sizeof(m->group));
+        if (fossil_net_endpoint_from_sockaddr(&m->source, &from) != 0)
+            memset(&m->source, 0, sizeof(m->source));
+    }
+    if (received) *received = n;
+    return 0;
+#elif defined(__linux__)
+    struct mmsghdr hdrs[FOSSIL_NET_MULTICAST_BATCH_MAX];
+    struct iovec iovs[FOSSIL_NET_MULTICAST_BATCH_MAX];
+    struct sockaddr_storage from[FOSSIL_NET_MULTICAST_BATCH_MAX];
+    fossil__mc_cmsg_t ctl[FOSSIL_NET_MULTICAST_BATCH_MAX];
+    for (uint32_t i = 0; i < count; ++i) {
+        fossil__mc_prepare(&msgs[i], &hdrs[i].msg_hdr, &iovs[i], &from[i], &ctl[i]);
+        hdrs[i].msg_len = 0;
+    }
+    int n;
+    do {
+        n = recvmmsg(sock->fd, hdrs, count, MSG_WAITFORONE, NULL);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return -1;
+    for (int i = 0; i < n; ++i)
+        fossil__mc_finish(&msgs[i], &hdrs[i].msg_hdr, &from[i], hdrs[i].msg_len);
+    if (received) *received = (uint32_t)n;
+    return 0;
+#else
+    uint32_t n = 0;
+    for (; n < count; ++n) {
+        struct msghdr hdr;
+        struct iovec iov;
+        struct sockaddr_storage from;
+        fossil__mc_cmsg_t ctl;
+        fossil__mc_prepare(&msgs[n], &hdr, &iov, &from, &ctl);
+        int flags = 0;
+#if defined(MSG_DONTWAIT)
+        if (n > 0) flags = MSG_DONTWAIT;
+#else
+        if (n > 0) break;
+#endif
+        ssize_t r;
+        do {
+            r = recvmsg(sock->fd, &hdr, flags);
+        } while (r < 0 && errno == EINTR);
+        if (r < 0) {
+            if (n > 0) break;
+            return -1;
+        }
+        fossil__mc_finish(&msgs[n], &hdr, &from, (size_t)r);
+    }
+    if (received) *received = n;
+    return 0;
+#endif
+}
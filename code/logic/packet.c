@@ -0,0 +1,396 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/packet.h"
+#include "fossil/network/inet.h"
+
+#include <string.h>
+
+#define FOSSIL__ETH_HLEN      14
+#define FOSSIL__ETHERTYPE_IP  0x0800
+#define FOSSIL__ETHERTYPE_IP6 0x86dd
+#define FOSSIL__ETHERTYPE_VLAN 0x8100
+#define FOSSIL__ETHERTYPE_QINQ 0x88a8
+#define FOSSIL__IPV6_MAX_EXT  8
+
+static inline uint16_t fossil__rd16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline bool fossil__is_vlan(uint16_t et) {
+    return et == FOSSIL__ETHERTYPE_VLAN || et == FOSSIL__ETHERTYPE_QINQ;
+}
+
+/*=============================================================================
+SCALAR DECODER
+=============================================================================*/
+
+static void fossil__decode_l4(fossil_net_packet_t *pkt, uint32_t off, uint32_t end) {
+    const uint8_t *d = pkt->data;
+    uint32_t hlen;
+    switch (pkt->ip_proto) {
+        case 6: // TCP
+            if (off + 20 > end) goto truncated;
+            hlen = (uint32_t)(d[off + 12] >> 4) * 4;
+            if (hlen < 20 || off + hlen > end) goto truncated;
+            pkt->layers |= FOSSIL_NET_PACKET_HAS_TCP;
+            pkt->src_port = fossil__rd16(d + off);
+            pkt->dst_port = fossil__rd16(d + off + 2);
+            pkt->tcp_flags = d[off + 13];
+            break;
+        case 17: // UDP
+            if (off + 8 > end) goto truncated;
+            hlen = 8;
+            pkt->layers |= FOSSIL_NET_PACKET_HAS_UDP;
+            pkt->src_port = fossil__rd16(d + off);
+            pkt->dst_port = fossil__rd16(d + off + 2);
+            break;
+        case 1:  // ICMP
+        case 58: // ICMPv6
+            if (off + 8 > end) goto truncated;
+            hlen = 8;
+            pkt->layers |= pkt->ip_proto == 1 ? FOSSIL_NET_PACKET_HAS_ICMP : FOSSIL_NET_PACKET_HAS_ICMPV6;
+            pkt->icmp_type = d[off];
+            pkt->icmp_code = d[off + 1];
+            break;
+        default:
+            return;
+    }
+    pkt->l4_offset = (uint16_t)off;
+    pkt->payload_offset = (uint16_t)(off + hlen);
+    pkt->payload_length = (uint16_t)(end - off - hlen);
+    return;
+
+truncated:
+    pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+}
+
+static void fossil__decode_ipv4(fossil_net_packet_t *pkt, uint32_t off) {
+    const uint8_t *d = pkt->data;
+    if (off + 20 > pkt->length || (d[off] >> 4) != 4) goto bad;
+    uint32_t hlen = (uint32_t)(d[off] & 0x0f) * 4;
+    uint32_t total = fossil__rd16(d + off + 2);
+    if (hlen < 20 || off + hlen > pkt->length || total < hlen) goto bad;
+
+    pkt->layers |= FOSSIL_NET_PACKET_HAS_IPV4;
+    pkt->l3_offset = (uint16_t)off;
+    pkt->ttl = d[off + 8];
+    pkt->ip_proto = d[off + 9];
+
+    // Trailing link-layer padding is not part of the packet
+    uint32_t end = off + total;
+    if (end > pkt->length) {
+        end = pkt->length;
+        pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+    }
+    uint16_t frag = fossil__rd16(d + off + 6);
+    if (frag & 0x3fff) {
+        pkt->layers |= FOSSIL_NET_PACKET_FRAGMENT;
+        if (frag & 0x1fff) return; // not the first fragment
+    }
+    fossil__decode_l4(pkt, off + hlen, end);
+    return;
+
+bad:
+    pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+}
+
+static void fossil__decode_ipv6(fossil_net_packet_t *pkt, uint32_t off) {
+    const uint8_t *d = pkt->data;
+    if (off + 40 > pkt->length || (d[off] >> 4) != 6) {
+        pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+        return;
+    }
+    pkt->layers |= FOSSIL_NET_PACKET_HAS_IPV6;
+    pkt->l3_offset = (uint16_t)off;
+    pkt->ttl = d[off + 7];
+
+    uint32_t end = off + 40 + fossil__rd16(d + off + 4);
+    if (end > pkt->length) {
+        end = pkt->length;
+        pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+    }
+    uint8_t next = d[off + 6];
+    uint32_t pos = off + 40;
+    for (int n = 0; n < FOSSIL__IPV6_MAX_EXT; ++n) {
+        uint32_t len;
+        switch (next) {
+            case 0:  // hop-by-hop
+            case 43: // routing
+            case 60: // destination options
+                if (pos + 8 > end) goto truncated;
+                len = ((uint32_t)d[pos + 1] + 1) * 8;
+                break;
+            case 44: // fragment
+                if (pos + 8 > end) goto truncated;
+                pkt->layers |= FOSSIL_NET_PACKET_FRAGMENT;
+                if (fossil__rd16(d + pos + 2) & 0xfff8) {
+                    pkt->ip_proto = d[pos];
+                    return;
+                }
+                len = 8;
+                break;
+            case 51: // authentication header
+                if (pos + 8 > end) goto truncated;
+                len = ((uint32_t)d[pos + 1] + 2) * 4;
+                break;
+            default:
+                pkt->ip_proto = next;
+                fossil__decode_l4(pkt, pos, end);
+                return;
+        }
+        if (pos + len > end) goto truncated;
+        next = d[pos];
+        pos += len;
+    }
+    pkt->ip_proto = next; // too many extension headers to follow
+    return;
+
+truncated:
+    pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+}
+
+int fossil_net_packet_decode(const void *data, uint32_t length, fossil_net_packet_link_t link, fossil_net_packet_t *pkt) {
+    if (!pkt || (!data && length)) return -1;
+    memset(pkt, 0, sizeof(*pkt));
+    pkt->data = data;
+    pkt->length = length > 0xffff ? 0xffff : length;
+
+    uint32_t off = 0;
+    uint16_t et;
+    if (link == FOSSIL_NET_PACKET_LINK_ETHERNET) {
+        if (pkt->length < FOSSIL__ETH_HLEN) {
+            pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+            return 0;
+        }
+        pkt->layers |= FOSSIL_NET_PACKET_HAS_ETH;
+        et = fossil__rd16(pkt->data + 12);
+        off = FOSSIL__ETH_HLEN;
+        // Up to two stacked tags (802.1ad outer, 802.1Q inner)
+        for (int tags = 0; tags < 2 && fossil__is_vlan(et); ++tags) {
+            if (off + 4 > pkt->length) {
+                pkt->layers |= FOSSIL_NET_PACKET_TRUNCATED;
+                return 0;
+            }
+            if (tags == 0) {
+                pkt->layers |= FOSSIL_NET_PACKET_HAS_VLAN;
+                pkt->vlan_tci = fossil__rd16(pkt->data + off);
+            }
+            et = fossil__rd16(pkt->data + off + 2);
+            off += 4;
+        }
+    } else if (link == FOSSIL_NET_PACKET_LINK_IP) {
+        if (pkt->length == 0) return 0;
+        uint8_t version = pkt->data[0] >> 4;
+        et = version == 4 ? FOSSIL__ETHERTYPE_IP : version == 6 ? FOSSIL__ETHERTYPE_IP6 : 0;
+    } else {
+        return -1;
+    }
+
+    pkt->ethertype = et;
+    if (et == FOSSIL__ETHERTYPE_IP) fossil__decode_ipv4(pkt, off);
+    else if (et == FOSSIL__ETHERTYPE_IP6) fossil__decode_ipv6(pkt, off);
+    return 0;
+}
+
+/*=============================================================================
+BATCH DECODER
+=============================================================================*/
+
+/*
+ * Stage by stage over the columns. Each stage only does the checks for the
+ * common shapes (at most one VLAN tag, IPv4 with options or IPv6 without
+ * extension headers, unfragmented, fully captured TCP/UDP/ICMP) and flags
+ * everything else for the scalar decoder at the end.
+ */
+int fossil_net_packet_decode_batch(fossil_net_packet_batch_t *b, fossil_net_packet_link_t link) {
+    if (!b || b->count > FOSSIL_NET_PACKET_BATCH_MAX) return -1;
+    if (link != FOSSIL_NET_PACKET_LINK_ETHERNET && link != FOSSIL_NET_PACKET_LINK_IP) return -1;
+    const uint32_t n = b->count;
+    uint8_t slow[FOSSIL_NET_PACKET_BATCH_MAX];
+    uint16_t end[FOSSIL_NET_PACKET_BATCH_MAX];
+
+    // Stage 1: link layer -> EtherType and L3 offset
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint8_t *d = b->data[i];
+        uint32_t len = b->length[i];
+        uint32_t layers = 0, l3 = 0;
+        uint16_t et = 0;
+        uint8_t s = (len > 0xffff) | (d == NULL);
+        if (link == FOSSIL_NET_PACKET_LINK_ETHERNET) {
+            s |= len < FOSSIL__ETH_HLEN + 4;
+            if (!s) {
+                uint16_t outer = fossil__rd16(d + 12);
+                uint8_t tagged = fossil__is_vlan(outer);
+                et = tagged ? fossil__rd16(d + 16) : outer;
+                l3 = FOSSIL__ETH_HLEN + (tagged ? 4u : 0u);
+                layers = FOSSIL_NET_PACKET_HAS_ETH | (tagged ? FOSSIL_NET_PACKET_HAS_VLAN : 0u);
+                s |= fossil__is_vlan(et);
+            }
+        } else {
+            s |= len == 0;
+            if (!s) {
+                uint8_t v = d[0] >> 4;
+                et = v == 4 ? FOSSIL__ETHERTYPE_IP : v == 6 ? FOSSIL__ETHERTYPE_IP6 : 0;
+            }
+        }
+        b->ethertype[i] = et;
+        b->l3_offset[i] = (uint16_t)l3;
+        b->layers[i] = layers;
+        slow[i] = s;
+    }
+
+    // Stage 2: IP header -> protocol, L4 offset and packet end
+    for (uint32_t i = 0; i < n; ++i) {
+        b->ip_proto[i] = 0;
+        b->l4_offset[i] = 0;
+        end[i] = 0;
+        if (slow[i]) continue;
+        const uint8_t *d = b->data[i];
+        uint32_t len = b->length[i], l3 = b->l3_offset[i];
+        if (b->ethertype[i] == FOSSIL__ETHERTYPE_IP) {
+            if (l3 + 20 > len) { slow[i] = 1; continue; }
+            const uint8_t *ip = d + l3;
+            uint32_t hlen = (uint32_t)(ip[0] & 0x0f) * 4, total = fossil__rd16(ip + 2);
+            slow[i] = (ip[0] >> 4) != 4 || hlen < 20 || total < hlen || l3 + total > len ||
+                      (fossil__rd16(ip + 6) & 0x3fff) != 0;
+            b->ip_proto[i] = ip[9];
+            b->l4_offset[i] = (uint16_t)(l3 + hlen);
+            end[i] = (uint16_t)(l3 + total);
+            b->layers[i] |= FOSSIL_NET_PACKET_HAS_IPV4;
+        } else if (b->ethertype[i] == FOSSIL__ETHERTYPE_IP6) {
+            if (l3 + 40 > len) { slow[i] = 1; continue; }
+            const uint8_t *ip = d + l3;
+            uint32_t total = 40u + fossil__rd16(ip + 4);
+            uint8_t next = ip[6];
+            slow[i] = (ip[0] >> 4) != 6 || l3 + total > len ||
+                      !(next == 6 || next == 17 || next == 58 || next == 1);
+            b->ip_proto[i] = next;
+            b->l4_offset[i] = (uint16_t)(l3 + 40);
+            end[i] = (uint16_t)(l3 + total);
+            b->layers[i] |= FOSSIL_NET_PACKET_HAS_IPV6;
+        } else {
+            b->l3_offset[i] = 0;
+        }
+    }
+
+    // Stage 3: transport header -> ports and payload
+    for (uint32_t i = 0; i < n; ++i) {
+        b->src_port[i] = 0;
+        b->dst_port[i] = 0;
+        b->payload_offset[i] = 0;
+        b->payload_length[i] = 0;
+        if (slow[i] || !(b->layers[i] & (FOSSIL_NET_PACKET_HAS_IPV4 | FOSSIL_NET_PACKET_HAS_IPV6))) continue;
+        const uint8_t *l4 = b->data[i] + b->l4_offset[i];
+        uint32_t off = b->l4_offset[i], e = end[i], hlen;
+        uint8_t proto = b->ip_proto[i];
+        if (proto == 6) {
+            if (off + 20 > e || (hlen = (uint32_t)(l4[12] >> 4) * 4) < 20 || off + hlen > e) { slow[i] = 1; continue; }
+            b->layers[i] |= FOSSIL_NET_PACKET_HAS_TCP;
+        } else if (proto == 17 || proto == 1 || proto == 58) {
+            hlen = 8;
+            if (off + 8 > e) { slow[i] = 1; continue; }
+            b->layers[i] |= proto == 17 ? FOSSIL_NET_PACKET_HAS_UDP
+                          : proto == 1 ? FOSSIL_NET_PACKET_HAS_ICMP : FOSSIL_NET_PACKET_HAS_ICMPV6;
+        } else {
+            b->l4_offset[i] = 0;
+            continue;
+        }
+        if (proto == 6 || proto == 17) {
+            b->src_port[i] = fossil__rd16(l4);
+            b->dst_port[i] = fossil__rd16(l4 + 2);
+        }
+        b->payload_offset[i] = (uint16_t)(off + hlen);
+        b->payload_length[i] = (uint16_t)(e - off - hlen);
+    }
+
+    // Everything unusual goes through the scalar decoder
+    for (uint32_t i = 0; i < n; ++i) {
+        if (!slow[i]) continue;
+        fossil_net_packet_t pkt;
+        if (fossil_net_packet_decode(b->data[i], b->length[i], link, &pkt) != 0) memset(&pkt, 0, sizeof(pkt));
+        b->layers[i] = pkt.layers;
+        b->ethertype[i] = pkt.ethertype;
+        b->l3_offset[i] = pkt.l3_offset;
+        b->l4_offset[i] = pkt.l4_offset;
+        b->payload_offset[i] = pkt.payload_offset;
+        b->payload_length[i] = pkt.payload_length;
+        b->ip_proto[i] = pkt.ip_proto;
+        b->src_port[i] = pkt.src_port;
+        b->dst_port[i] = pkt.dst_port;
+    }
+    return 0;
+}
+
+/*=============================================================================
+VIEWS
+=============================================================================*/
+
+const uint8_t *fossil_net_packet_l3(const fossil_net_packet_t *pkt) {
+    if (!pkt || !(pkt->layers & (FOSSIL_NET_PACKET_HAS_IPV4 | FOSSIL_NET_PACKET_HAS_IPV6))) return NULL;
+    return pkt->data + pkt->l3_offset;
+}
+
+const uint8_t *fossil_net_packet_l4(const fossil_net_packet_t *pkt) {
+    const uint32_t l4 = FOSSIL_NET_PACKET_HAS_TCP | FOSSIL_NET_PACKET_HAS_UDP |
+                        FOSSIL_NET_PACKET_HAS_ICMP | FOSSIL_NET_PACKET_HAS_ICMPV6;
+    if (!pkt || !(pkt->layers & l4)) return NULL;
+    return pkt->data + pkt->l4_offset;
+}
+
+const uint8_t *fossil_net_packet_payload(const fossil_net_packet_t *pkt, uint32_t *length) {
+    if (length) *length = 0;
+    if (!fossil_net_packet_l4(pkt)) return NULL;
+    if (length) *length = pkt->payload_length;
+    return pkt->data + pkt->payload_offset;
+}
+
+static void fossil__packet_mac(const uint8_t *bytes, fossil_net_mac_t *mac) {
+    memcpy(mac->bytes, bytes, 6);
+    fossil_net_inet_mac_format(mac->bytes, mac->string, sizeof(mac->string));
+}
+
+int fossil_net_packet_eth_addrs(const fossil_net_packet_t *pkt, fossil_net_mac_t *src, fossil_net_mac_t *dst) {
+    if (!pkt || !(pkt->layers & FOSSIL_NET_PACKET_HAS_ETH)) return -1;
+    if (dst) fossil__packet_mac(pkt->data, dst);
+    if (src) fossil__packet_mac(pkt->data + 6, src);
+    return 0;
+}
+
+int fossil_net_packet_endpoints(const fossil_net_packet_t *pkt, fossil_net_endpoint_t *src, fossil_net_endpoint_t *dst) {
+    const uint8_t *ip = fossil_net_packet_l3(pkt);
+    if (!ip) return -1;
+    bool v4 = (pkt->layers & FOSSIL_NET_PACKET_HAS_IPV4) != 0;
+    uint32_t alen = v4 ? 4 : 16, soff = v4 ? 12 : 8;
+    fossil_net_endpoint_t *eps[2] = { src, dst };
+    uint16_t ports[2] = { pkt->src_port, pkt->dst_port };
+    for (int i = 0; i < 2; ++i) {
+        if (!eps[i]) continue;
+        memset(eps[i], 0, sizeof(*eps[i]));
+        eps[i]->family = v4 ? FOSSIL_NET_SOCKET_FAMILY_IPV4 : FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        eps[i]->port = ports[i];
+        memcpy(eps[i]->ip, ip + soff + (uint32_t)i * alen, alen);
+    }
+    return 0;
+}
@@ -0,0 +1,566 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/parser.h"
+
+#include <string.h>
+
+/*=============================================================================
+INTERNAL HELPERS
+=============================================================================*/
+
+enum
+{
+    FOSSIL__CHUNK_SIZE = 0,
+    FOSSIL__CHUNK_EXT,
+    FOSSIL__CHUNK_DATA,
+    FOSSIL__CHUNK_DATA_CR,
+    FOSSIL__CHUNK_DATA_LF,
+    FOSSIL__CHUNK_TRAILER,
+    FOSSIL__CHUNK_TRAILER_LINE,
+    FOSSIL__CHUNK_TRAILER_LF,
+    FOSSIL__CHUNK_DONE
+};
+
+static const char *const fossil__method_names[FOSSIL_NET_HTTP_METHODS] = {
+    "GET", "HEAD", "POST", "PUT", "DELETE", "PATCH", "OPTIONS", "CONNECT", "TRACE", ""
+};
+
+/* RFC 9110 tchar */
+static int fossil__is_tchar(unsigned char c)
+{
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+        return 1;
+    return c != '\0' && strchr("!#$%&'*+-.^_`|~", c) != NULL;
+}
+
+static int fossil__lower(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static int fossil__ieq(fossil_net_slice_t s, const char *str)
+{
+    size_t n = strlen(str);
+    if (s.len != n)
+        return 0;
+    for (size_t i = 0; i < n; i++) {
+        if (fossil__lower((unsigned char)s.ptr[i]) != (unsigned char)str[i])
+            return 0;
+    }
+    return 1;
+}
+
+static int fossil__hexval(unsigned char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    c = (unsigned char)fossil__lower(c);
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+static int fossil__fail(fossil_net_parser_t *p, int status)
+{
+    p->status = status;
+    return -1;
+}
+
+/* Split a comma-separated list; returns the next trimmed element. */
+static int fossil__next_token(fossil_net_slice_t *list, fossil_net_slice_t *tok)
+{
+    const char *s = list->ptr;
+    const char *e = s + list->len;
+    while (s < e && (*s == ' ' || *s == '\t' || *s == ','))
+        s++;
+    if (s == e)
+        return 0;
+    const char *t = s;
+    while (t < e && *t != ',')
+        t++;
+    const char *te = t;
+    while (te > s && (te[-1] == ' ' || te[-1] == '\t'))
+        te--;
+    tok->ptr = s;
+    tok->len = (uint32_t)(te - s);
+    list->ptr = t;
+    list->len = (uint32_t)(e - t);
+    return 1;
+}
+
+/*
+ * Search for the blank line ending the head, resuming where the previous
+ * call stopped. Returns the offset just past it, or 0 if not seen yet.
+ */
+static uint32_t fossil__find_end(fossil_net_parser_t *p, const char *buf, uint32_t len)
+{
+    uint32_t i = p->scanned;
+    while (i < len) {
+        const char *nl = memchr(buf + i, '\n', len - i);
+        if (!nl) {
+            p->scanned = len;
+            return 0;
+        }
+        i = (uint32_t)(nl - buf);
+        if (i + 1 >= len) {
+            p->scanned = i;
+            return 0;
+        }
+        if (buf[i + 1] == '\n')
+            return i + 2;
+        if (buf[i + 1] == '\r') {
+            if (i + 2 >= len) {
+                p->scanned = i;
+                return 0;
+            }
+            if (buf[i + 2] == '\n')
+                return i + 3;
+        }
+        i++;
+    }
+    p->scanned = len;
+    return 0;
+}
+
+/* Consume a line terminator (CRLF or bare LF) at *i. */
+static int fossil__eol(const char *buf, uint32_t *i)
+{
+    if (buf[*i] == '\r') {
+        if (buf[*i + 1] != '\n')
+            return -1;
+        *i += 2;
+        return 0;
+    }
+    if (buf[*i] == '\n') {
+        *i += 1;
+        return 0;
+    }
+    return -1;
+}
+
+static int fossil__request_line(fossil_net_parser_t *p, const char *buf, uint32_t *pos, uint32_t end, fossil_net_http_request_t *req)
+{
+    uint32_t i = *pos;
+
+    uint32_t m = i;
+    while (fossil__is_tchar((unsigned char)buf[i]))
+        i++;
+    if (i == m || buf[i] != ' ')
+        return fossil__fail(p, 400);
+    req->method_name.ptr = buf + m;
+    req->method_name.len = i - m;
+    req->method = fossil_net_http_method_parse(buf + m, i - m);
+    i++;
+
+    uint32_t t = i;
+    uint32_t q = 0;
+    while ((unsigned char)buf[i] > ' ' && (unsigned char)buf[i] != 0x7f) {
+        if (buf[i] == '?' && q == 0)
+            q = i;
+        i++;
+    }
+    if (i == t || buf[i] != ' ')
+        return fossil__fail(p, 400);
+    req->target.ptr = buf + t;
+    req->target.len = i - t;
+    req->path.ptr = buf + t;
+    req->path.len = (q ? q : i) - t;
+    req->query.ptr = q ? buf + q + 1 : buf + i;
+    req->query.len = q ? i - q - 1 : 0;
+    i++;
+
+    if (end - i < 9 || memcmp(buf + i, "HTTP/", 5) != 0)
+        return fossil__fail(p, 400);
+    i += 5;
+    if (buf[i] < '0' || buf[i] > '9' || buf[i + 1] != '.' || buf[i + 2] < '0' || buf[i + 2] > '9')
+        return fossil__fail(p, 400);
+    if (buf[i] != '1')
+        return fossil__fail(p, 505);
+    req->version_minor = (uint8_t)(buf[i + 2] - '0');
+    i += 3;
+    if (fossil__eol(buf, &i) != 0)
+        return fossil__fail(p, 400);
+
+    *pos = i;
+    return 0;
+}
+
+static int fossil__headers(fossil_net_parser_t *p, const char *buf, uint32_t *pos, fossil_net_http_request_t *req)
+{
+    uint32_t i = *pos;
+
+    while (buf[i] != '\r' && buf[i] != '\n') {
+        if (buf[i] == ' ' || buf[i] == '\t')
+            return fossil__fail(p, 400); /* obs-fold */
+        if (req->header_count == FOSSIL_NET_PARSER_MAX_HEADERS)
+            return fossil__fail(p, 431);
+
+        uint32_t n = i;
+        while (fossil__is_tchar((unsigned char)buf[i]))
+            i++;
+        if (i == n || buf[i] != ':')
+            return fossil__fail(p, 400); /* includes whitespace before ':' */
+        fossil_net_http_header_t *h = &req->headers[req->header_count++];
+        h->name.ptr = buf + n;
+        h->name.len = i - n;
+        i++;
+
+        while (buf[i] == ' ' || buf[i] == '\t')
+            i++;
+        uint32_t v = i;
+        for (;;) {
+            unsigned char c = (unsigned char)buf[i];
+            if (c == '\r' || c == '\n')
+                break;
+            if ((c < ' ' && c != '\t') || c == 0x7f)
+                return fossil__fail(p, 400);
+            i++;
+        }
+        uint32_t ve = i;
+        while (ve > v && (buf[ve - 1] == ' ' || buf[ve - 1] == '\t'))
+            ve--;
+        h->value.ptr = buf + v;
+        h->value.len = ve - v;
+        if (fossil__eol(buf, &i) != 0)
+            return fossil__fail(p, 400);
+    }
+
+    *pos = i;
+    return 0;
+}
+
+/* Apply the headers that affect framing and connection reuse. */
+static int fossil__semantics(fossil_net_parser_t *p, fossil_net_http_request_t *req)
+{
+    bool have_cl = false;
+    bool have_te = false;
+    bool have_host = false;
+    bool ka = req->version_minor >= 1;
+
+    for (uint32_t k = 0; k < req->header_count; k++) {
+        const fossil_net_http_header_t *h = &req->headers[k];
+        if (fossil__ieq(h->name, "content-length")) {
+            uint64_t v = 0;
+            if (h->value.len == 0 || h->value.len > 19)
+                return fossil__fail(p, 400);
+            for (uint32_t j = 0; j < h->value.len; j++) {
+                char c = h->value.ptr[j];
+                if (c < '0' || c > '9')
+                    return fossil__fail(p, 400);
+                v = v * 10 + (uint64_t)(c - '0');
+            }
+            if (have_cl && v != req->content_length)
+                return fossil__fail(p, 400);
+            have_cl = true;
+            req->content_length = v;
+        } else if (fossil__ieq(h->name, "transfer-encoding")) {
+            fossil_net_slice_t list = h->value;
+            fossil_net_slice_t tok;
+            have_te = true;
+            while (fossil__next_token(&list, &tok)) {
+                /* chunked must be the final coding and appear once */
+                if (req->chunked)
+                    return fossil__fail(p, 400);
+                req->chunked = fossil__ieq(tok, "chunked");
+            }
+        } else if (fossil__ieq(h->name, "connection")) {
+            fossil_net_slice_t list = h->value;
+            fossil_net_slice_t tok;
+            while (fossil__next_token(&list, &tok)) {
+                if (fossil__ieq(tok, "close"))
+                    ka = false;
+                else if (fossil__ieq(tok, "keep-alive"))
+                    ka = true;
+                else if (fossil__ieq(tok, "upgrade"))
+                    req->upgrade = true;
+            }
+        } else if (fossil__ieq(h->name, "expect")) {
+            if (fossil__ieq(h->value, "100-continue"))
+                req->expect_continue = true;
+        } else if (fossil__ieq(h->name, "host")) {
+            if (have_host)
+                return fossil__fail(p, 400);
+            have_host = true;
+        }
+    }
+
+    if (have_te) {
+        if (have_cl || req->version_minor == 0)
+            return fossil__fail(p, 400);
+        if (!req->chunked)
+            return fossil__fail(p, 501);
+        req->content_length = 0;
+    }
+    if (req->version_minor >= 1 && !have_host)
+        return fossil__fail(p, 400);
+
+    req->keep_alive = ka;
+    return 0;
+}
+
+/*=============================================================================
+PARSING
+=============================================================================*/
+
+void fossil_net_parser_init(fossil_net_parser_t *parser, uint32_t max_head)
+{
+    if (!parser)
+        return;
+    memset(parser, 0, sizeof(*parser));
+    parser->max_head = max_head ? max_head : FOSSIL_NET_PARSER_MAX_HEAD;
+}
+
+void fossil_net_parser_reset(fossil_net_parser_t *parser)
+{
+    if (!parser)
+        return;
+    fossil_net_parser_init(parser, parser->max_head);
+}
+
+int fossil_net_parser_parse(
+    fossil_net_parser_t *parser,
+    const char *buf,
+    uint32_t len,
+    fossil_net_http_request_t *req)
+{
+    if (!parser || !buf || !req)
+        return -1;
+    if (parser->status)
+        return -1;
+
+    /* RFC 9112 2.2: ignore at least one empty line before the request */
+    while (parser->start < len && (buf[parser->start] == '\r' || buf[parser->start] == '\n')) {
+        if (parser->start >= parser->max_head)
+            return fossil__fail(parser, 400);
+        parser->start++;
+    }
+    if (parser->scanned < parser->start)
+        parser->scanned = parser->start;
+
+    uint32_t end = fossil__find_end(parser, buf, len);
+    if (end == 0 || end - parser->start > parser->max_head) {
+        uint32_t seen = end ? end - parser->start : len - parser->start;
+        if (seen <= parser->max_head)
+            return 0;
+        const char *nl = memchr(buf + parser->start, '\n', parser->max_head);
+        return fossil__fail(parser, nl ? 431 : 414);
+    }
+
+    memset(req, 0, sizeof(*req));
+    uint32_t i = parser->start;
+    if (fossil__request_line(parser, buf, &i, end, req) != 0)
+        return -1;
+    if (fossil__headers(parser, buf, &i, req) != 0)
+        return -1;
+    if (fossil__eol(buf, &i) != 0 || i != end)
+        return fossil__fail(parser, 400);
+    if (fossil__semantics(parser, req) != 0)
+        return -1;
+
+    req->head_len = end;
+    return (int)end;
+}
+
+int fossil_net_parser_decode_chunked(
+    fossil_net_parser_t *parser,
+    char *buf,
+    uint32_t *len)
+{
+    if (!parser || !len || (!buf && *len))
+        return -1;
+
+    uint32_t n = *len;
+    uint32_t i = 0;
+    uint32_t o = 0;
+
+    while (i < n && parser->chunk_state != FOSSIL__CHUNK_DONE) {
+        unsigned char c = (unsigned char)buf[i];
+        switch (parser->chunk_state) {
+        case FOSSIL__CHUNK_SIZE: {
+            int v = fossil__hexval(c);
+            i++;
+            if (v >= 0) {
+                if (++parser->chunk_digits > 15)
+                    return -1;
+                parser->chunk_left = (parser->chunk_left << 4) | (uint64_t)v;
+                break;
+            }
+            if (parser->chunk_digits == 0)
+                return -1;
+            if (c == ';' || c == ' ' || c == '\t' || c == '\r') {
+                parser->chunk_state = FOSSIL__CHUNK_EXT;
+                break;
+            }
+            if (c != '\n')
+                return -1;
+            parser->chunk_state = parser->chunk_left ? FOSSIL__CHUNK_DATA : FOSSIL__CHUNK_TRAILER;
+            break;
+        }
+        case FOSSIL__CHUNK_EXT:
+            i++;
+            if (c == '\n')
+                parser->chunk_state = parser->chunk_left ? FOSSIL__CHUNK_DATA : FOSSIL__CHUNK_TRAILER;
+            break;
+        case FOSSIL__CHUNK_DATA: {
+            uint64_t take = n - i;
+            if (take > parser->chunk_left)
+                take = parser->chunk_left;
+            if (o != i)
+                memmove(buf + o, buf + i, (size_t)take);
+            o += (uint32_t)take;
+            i += (uint32_t)take;
+            parser->chunk_left -= take;
+            if (parser->chunk_left == 0)
+                parser->chunk_state = FOSSIL__CHUNK_DATA_CR;
+            break;
+        }
+        case FOSSIL__CHUNK_DATA_CR:
+            i++;
+            if (c == '\r')
+                parser->chunk_state = FOSSIL__CHUNK_DATA_LF;
+            else if (c == '\n')
+                parser->chunk_state = FOSSIL__CHUNK_SIZE, parser->chunk_digits = 0;
+            else
+                return -1;
+            break;
+        case FOSSIL__CHUNK_DATA_LF:
+            i++;
+            if (c != '\n')
+                return -1;
+            parser->chunk_state = FOSSIL__CHUNK_SIZE;
+            parser->chunk_digits = 0;
+            break;
+        case FOSSIL__CHUNK_TRAILER:
+            i++;
+            if (c == '\n')
+                parser->chunk_state = FOSSIL__CHUNK_DONE;
+            else if (c == '\r')
+                parser->chunk_state = FOSSIL__CHUNK_TRAILER_LF;
+            else
+                parser->chunk_state = FOSSIL__CHUNK_TRAILER_LINE;
+            break;
+        case FOSSIL__CHUNK_TRAILER_LINE:
+            i++;
+            if (c == '\n')
+                parser->chunk_state = FOSSIL__CHUNK_TRAILER;
+            break;
+        case FOSSIL__CHUNK_TRAILER_LF:
+            i++;
+            if (c != '\n')
+                return -1;
+            parser->chunk_state = FOSSIL__CHUNK_DONE;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    *len = o;
+    if (parser->chunk_state != FOSSIL__CHUNK_DONE)
+        return -2;
+    if (i < n && o != i)
+        memmove(buf + o, buf + i, n - i);
+    return (int)(n - i);
+}
+
+/*=============================================================================
+ACCESSORS
+=============================================================================*/
+
+bool fossil_net_http_request_header(
+    const fossil_net_http_request_t *req,
+    const char *name,
+    fossil_net_slice_t *value)
+{
+    if (!req || !name)
+        return false;
+    size_t n = strlen(name);
+    for (uint32_t k = 0; k < req->header_count; k++) {
+        const fossil_net_http_header_t *h = &req->headers[k];
+        if (h->name.len != n)
+            continue;
+        uint32_t j = 0;
+        while (j < n && fossil__lower((unsigned char)h->name.ptr[j]) == fossil__lower((unsigned char)name[j]))
+            j++;
+        if (j == n) {
+            if (value)
+                *value = h->value;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *fossil_net_http_method_name(fossil_net_http_method_t method)
+{
+    if ((unsigned)method >= FOSSIL_NET_HTTP_METHODS)
+        return "";
+    return fossil__method_names[method];
+}
+
+fossil_net_http_method_t fossil_net_http_method_parse(const char *name, uint32_t len)
+{
+    if (!name)
+        return FOSSIL_NET_HTTP_OTHER;
+    for (int m = 0; m < FOSSIL_NET_HTTP_OTHER; m++) {
+        const char *s = fossil__method_names[m];
+        if (strlen(s) == len && memcmp(s, name, len) == 0)
+            return (fossil_net_http_method_t)m;
+    }
+    return FOSSIL_NET_HTTP_OTHER;
+}
+
+bool fossil_net_slice_eq(fossil_net_slice_t slice, const char *str)
+{
+    if (!str)
+        return false;
+    size_t n = strlen(str);
+    return slice.len == n && (n == 0 || memcmp(slice.ptr, str, n) == 0);
+}
+
+bool fossil_net_http_etag_match(fossil_net_slice_t list, const char *etag)
+{
+    if (!etag || (!list.ptr && list.len))
+        return false;
+    size_t elen = strlen(etag);
+    size_t i = 0;
+    while (i < list.len) {
+        while (i < list.len && (list.ptr[i] == ' ' || list.ptr[i] == '\t' || list.ptr[i] == ','))
+            i++;
+        size_t s = i;
+        while (i < list.len && list.ptr[i] != ',')
+            i++;
+        size_t e = i;
+        while (e > s && (list.ptr[e - 1] == ' ' || list.ptr[e - 1] == '\t'))
+            e--;
+        if (e - s == 1 && list.ptr[s] == '*')
+            return true;
+        if (e - s > 2 && list.ptr[s] == 'W' && list.ptr[s + 1] == '/')
+            s += 2;
+        if (e - s == elen && memcmp(list.ptr + s, etag, elen) == 0)
+            return true;
+    }
+    return false;
+}
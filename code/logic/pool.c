@@ -0,0 +1,534 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/pool.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+PLATFORM
+=============================================================================*/
+
+#if defined(_WIN32)
+#define FOSSIL__POOL_TLS __declspec(thread)
+typedef HANDLE fossil__pool_thread_t;
+typedef CRITICAL_SECTION fossil__pool_mutex_t;
+typedef CONDITION_VARIABLE fossil__pool_cond_t;
+#define fossil__pool_mutex_init(m)    InitializeCriticalSection(m)
+#define fossil__pool_mutex_destroy(m) DeleteCriticalSection(m)
+#define fossil__pool_mutex_lock(m)    EnterCriticalSection(m)
+#define fossil__pool_mutex_unlock(m)  LeaveCriticalSection(m)
+#define fossil__pool_cond_init(c)     InitializeConditionVariable(c)
+#define fossil__pool_cond_destroy(c)  ((void)(c))
+#define fossil__pool_cond_wait(c, m)  SleepConditionVariableCS(c, m, INFINITE)
+#define fossil__pool_cond_signal(c)   WakeConditionVariable(c)
+#define fossil__pool_cond_broadcast(c) WakeAllConditionVariable(c)
+#define fossil__pool_yield()          SwitchToThread()
+#else
+#define FOSSIL__POOL_TLS _Thread_local
+typedef pthread_t fossil__pool_thread_t;
+typedef pthread_mutex_t fossil__pool_mutex_t;
+typedef pthread_cond_t fossil__pool_cond_t;
+#define fossil__pool_mutex_init(m)    pthread_mutex_init(m, NULL)
+#define fossil__pool_mutex_destroy(m) pthread_mutex_destroy(m)
+#define fossil__pool_mutex_lock(m)    pthread_mutex_lock(m)
+#define fossil__pool_mutex_unlock(m)  pthread_mutex_unlock(m)
+#define fossil__pool_cond_init(c)     pthread_cond_init(c, NULL)
+#define fossil__pool_cond_destroy(c)  pthread_cond_destroy(c)
+#define fossil__pool_cond_wait(c, m)  pthread_cond_wait(c, m)
+#define fossil__pool_cond_signal(c)   pthread_cond_signal(c)
+#define fossil__pool_cond_broadcast(c) pthread_cond_broadcast(c)
+#define fossil__pool_yield()          sched_yield()
+#endif
+
+static uint32_t fossil__pool_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors ? (uint32_t)si.dwNumberOfProcessors : 1u;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1u;
+#endif
+}
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+typedef struct fossil__pool_task {
+    _Atomic(struct fossil__pool_task *) next; /* inbox link */
+    fossil_net_pool_fn fn;
+    fossil_net_loop_task_fn done;
+    fossil_net_loop_t *origin;
+    void *arg;
+} fossil__pool_task_t;
+
+/* Ring of task pointers; replaced by a twice larger one when full. */
+typedef struct fossil__deque_array {
+    struct fossil__deque_array *retired; /* older arrays, freed with the worker */
+    int64_t mask;
+    _Atomic(fossil__pool_task_t *) slot[];
+} fossil__deque_array_t;
+
+typedef struct fossil__pool_worker {
+    /* Chase-Lev deque: the owner works at bottom, thieves CAS top. */
+    _Atomic int64_t top;
+    char pad0[64 - sizeof(int64_t)];
+    _Atomic int64_t bottom;
+    _Atomic(fossil__deque_array_t *) array;
+    char pad1[64 - sizeof(int64_t) - sizeof(void*)];
+
+    /* Inbox for submissions from outside the pool (Vyukov MPSC). */
+    _Atomic(fossil__pool_task_t *) inbox_head;
+    _Atomic uint32_t inbox_count;
+    char pad2[64 - sizeof(void*) - sizeof(uint32_t)];
+    fossil__pool_task_t *inbox_tail;
+    fossil__pool_task_t inbox_stub;
+
+    fossil_net_pool_t *pool;
+    uint32_t index;
+    uint64_t rng;
+    fossil__pool_thread_t thread;
+    bool started;
+
+    /* written by the owning worker only */
+    _Atomic uint64_t executed;
+    _Atomic uint64_t stolen;
+    _Atomic uint64_t replies;
+    _Atomic uint64_t parks;
+} fossil__pool_worker_t;
+
+struct fossil_net_pool {
+    uint32_t nworkers;
+    uint32_t spin;
+    fossil__pool_worker_t **workers;
+    atomic_bool stopping;
+    _Atomic uint32_t sleepers;
+    _Atomic uint32_t next_inbox;
+    _Atomic uint64_t submitted;
+    fossil__pool_mutex_t lock;
+    fossil__pool_cond_t wake;
+};
+
+static FOSSIL__POOL_TLS fossil__pool_worker_t *fossil__pool_self;
+
+static inline void fossil__pool_count(_Atomic uint64_t *c) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/*=============================================================================
+CHASE-LEV DEQUE
+=============================================================================*/
+
+/* Result of a steal that lost a race; the deque may still hold work. */
+#define FOSSIL__POOL_ABORT ((fossil__pool_task_t *)(uintptr_t)1)
+
+static fossil__deque_array_t *fossil__deque_array_new(int64_t size) {
+    fossil__deque_array_t *a = malloc(sizeof(*a) + (size_t)size * sizeof(a->slot[0]));
+    if (!a) return NULL;
+    a->retired = NULL;
+    a->mask = size - 1;
+    for (int64_t i = 0; i < size; i++) atomic_init(&a->slot[i], NULL);
+    return a;
+}
+
+/* Owner only. */
+static int fossil__deque_push(fossil__pool_worker_t *w, fossil__pool_task_t *t) {
+    int64_t b = atomic_load_explicit(&w->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&w->top, memory_order_acquire);
+    fossil__deque_array_t *a = atomic_load_explicit(&w->array, memory_order_relaxed);
+    if (b - top > a->mask) {
+        fossil__deque_array_t *grown = fossil__deque_array_new((a->mask + 1) * 2);
+        if (!grown) return -1;
+        for (int64_t i = top; i < b; i++)
+            atomic_store_explicit(&grown->slot[i & grown->mask],
+                                  atomic_load_explicit(&a->slot[i & a->mask], memory_order_relaxed),
+                                  memory_order_relaxed);
+        /* Thieves may still read the old array, so keep it until destroy. */
+        grown->retired = a;
+        atomic_store_explicit(&w->array, grown, memory_order_release);
+        a = grown;
+    }
+    atomic_store_explicit(&a->slot[b & a->mask], t, memory_order_relaxed);
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_release);
+    return 0;
+}
+
+/* Owner only. */
+static fossil__pool_task_t *fossil__deque_take(fossil__pool_worker_t *w) {
+    int64_t b = atomic_load_explicit(&w->bottom, memory_order_relaxed) - 1;
+    fossil__deque_array_t *a = atomic_load_explicit(&w->array, memory_order_relaxed);
+    atomic_store_explicit(&w->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&w->top, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+    fossil__pool_task_t *x = atomic_load_explicit(&a->slot[b & a->mask], memory_order_relaxed);
+    if (t == b) {
+        /* Last element: race the thieves for it. */
+        if (!atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed))
+            x = NULL;
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    }
+    return x;
+}
+
+/* Any thread. */
+static fossil__pool_task_t *fossil__deque_steal(fossil__pool_worker_t *w) {
+    int64_t t = atomic_load_explicit(&w->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+    fossil__deque_array_t *a = atomic_load_explicit(&w->array, memory_order_acquire);
+    fossil__pool_task_t *x = atomic_load_explicit(&a->slot[t & a->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&w->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+        return FOSSIL__POOL_ABORT;
+    return x;
+}
+
+/*=============================================================================
+INBOX
+=============================================================================*/
+
+static void fossil__inbox_push(fossil__pool_worker_t *w, fossil__pool_task_t *t) {
+    atomic_store_explicit(&t->next, NULL, memory_order_relaxed);
+    fossil__pool_task_t *prev = atomic_exchange_explicit(&w->inbox_head, t, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, t, memory_order_release);
+    atomic_fetch_add_explicit(&w->inbox_count, 1, memory_order_seq_cst);
+}
+
+/* Owner only; NULL when empty or when a producer is mid-push. */
+static fossil__pool_task_t *fossil__inbox_pop(fossil__pool_worker_t *w) {
+    fossil__pool_task_t *tail = w->inbox_tail;
+    fossil__pool_task_t *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (tail == &w->inbox_stub) {
+        if (!next) return NULL;
+        w->inbox_tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+    if (!next) {
+        if (tail != atomic_load_explicit(&w->inbox_head, memory_order_acquire)) return NULL;
+        atomic_store_explicit(&w->inbox_stub.next, NULL, memory_order_relaxed);
+        fossil__pool_task_t *prev = atomic_exchange_explicit(&w->inbox_head, &w->inbox_stub, memory_order_acq_rel);
+        atomic_store_explicit(&prev->next, &w->inbox_stub, memory_order_release);
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+        if (!next) return NULL;
+    }
+    w->inbox_tail = next;
+    atomic_fetch_sub_explicit(&w->inbox_count, 1, memory_order_relaxed);
+    return tail;
+}
+
+/*=============================================================================
+WORKERS
+=============================================================================*/
+
+static bool fossil__pool_has_work(fossil_net_pool_t *pool) {
+    for (uint32_t i = 0; i < pool->nworkers; i++) {
+        fossil__pool_worker_t *w = pool->workers[i];
+        if (atomic_load_explicit(&w->inbox_count, memory_order_seq_cst) ||
+            atomic_load_explicit(&w->top, memory_order_seq_cst) <
+            atomic_load_explicit(&w->bottom, memory_order_seq_cst))
+            return true;
+    }
+    return false;
+}
+
+static void fossil__pool_notify(fossil_net_pool_t *pool) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&pool->sleepers, memory_order_seq_cst) == 0) return;
+    fossil__pool_mutex_lock(&pool->lock);
+    fossil__pool_cond_signal(&pool->wake);
+    fossil__pool_mutex_unlock(&pool->lock);
+}
+
+static void fossil__pool_run(fossil__pool_worker_t *w, fossil__pool_task_t *t) {
+    t->fn(t->arg);
+    if (t->done) {
+        if (t->origin && fossil_net_loop_post(t->origin, t->done, t->arg) == 0)
+            fossil__pool_count(&w->replies);
+        else
+            t->done(NULL, t->arg);
+    }
+    free(t);
+    fossil__pool_count(&w->executed);
+}
+
+/* Move the inbox into the deque so the tasks become stealable. */
+static void fossil__pool_drain_inbox(fossil__pool_worker_t *w) {
+    fossil__pool_task_t *t;
+    while ((t = fossil__inbox_pop(w)) != NULL) {
+        if (fossil__deque_push(w, t) != 0) {
+            fossil__pool_run(w, t);
+            continue;
+        }
+    }
+}
+
+static fossil__pool_task_t *fossil__pool_steal(fossil__pool_worker_t *w, bool *contended) {
+    fossil_net_pool_t *pool = w->pool;
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 7;
+    w->rng ^= w->rng << 17;
+    uint32_t start = (uint32_t)(w->rng % pool->nworkers);
+    for (uint32_t k = 0; k < pool->nworkers; k++) {
+        fossil__pool_worker_t *v = pool->workers[(start + k) % pool->nworkers];
+        if (v == w) continue;
+        fossil__pool_task_t *t = fossil__deque_steal(v);
+        if (t == FOSSIL__POOL_ABORT) {
+            *contended = true;
+            continue;
+        }
+        if (t) {
+            fossil__pool_count(&w->stolen);
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static void fossil__pool_main(fossil__pool_worker_t *w) {
+    fossil_net_pool_t *pool = w->pool;
+    uint32_t idle = 0;
+    fossil__pool_self = w;
+    for (;;) {
+        fossil__pool_drain_inbox(w);
+        fossil__pool_task_t *t = fossil__deque_take(w);
+        bool contended = false;
+        if (!t) t = fossil__pool_steal(w, &contended);
+        if (t) {
+            idle = 0;
+            fossil__pool_run(w, t);
+            continue;
+        }
+        if (contended || ++idle < pool->spin) {
+            fossil__pool_yield();
+            continue;
+        }
+        idle = 0;
+
+        fossil__pool_mutex_lock(&pool->lock);
+        atomic_fetch_add_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+        if (fossil__pool_has_work(pool)) {
+            atomic_fetch_sub_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+            fossil__pool_mutex_unlock(&pool->lock);
+            continue;
+        }
+        if (atomic_load_explicit(&pool->stopping, memory_order_acquire)) {
+            atomic_fetch_sub_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+            fossil__pool_mutex_unlock(&pool->lock);
+            break;
+        }
+        fossil__pool_count(&w->parks);
+        fossil__pool_cond_wait(&pool->wake, &pool->lock);
+        atomic_fetch_sub_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+        fossil__pool_mutex_unlock(&pool->lock);
+    }
+    fossil__pool_self = NULL;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI fossil__pool_thread(LPVOID arg) {
+    fossil__pool_main((fossil__pool_worker_t*)arg);
+    return 0;
+}
+#else
+static void *fossil__pool_thread(void *arg) {
+    fossil__pool_main((fossil__pool_worker_t*)arg);
+    return NULL;
+}
+#endif
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+static void fossil__pool_worker_free(fossil__pool_worker_t *w) {
+    if (!w) return;
+    fossil__deque_array_t *a = atomic_load_explicit(&w->array, memory_order_relaxed);
+    while (a) {
+        fossil__deque_array_t *older = a->retired;
+        free(a);
+        a = older;
+    }
+    free(w);
+}
+
+fossil_net_pool_t *fossil_net_pool_create(const fossil_net_pool_config_t *config) {
+    fossil_net_pool_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    if (config) cfg = *config;
+    if (!cfg.threads) cfg.threads = fossil__pool_cpus();
+    if (cfg.threads > FOSSIL_NET_POOL_MAX_THREADS) cfg.threads = FOSSIL_NET_POOL_MAX_THREADS;
+    if (!cfg.deque_size) cfg.deque_size = 1024;
+    if (!cfg.spin) cfg.spin = 64;
+    uint32_t size = 16;
+    while (size < cfg.deque_size && size < (1u << 30)) size <<= 1;
+
+    fossil_net_pool_t *pool = calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    pool->nworkers = cfg.threads;
+    pool->spin = cfg.spin;
+    atomic_init(&pool->stopping, false);
+    fossil__pool_mutex_init(&pool->lock);
+    fossil__pool_cond_init(&pool->wake);
+    pool->workers = calloc(pool->nworkers, sizeof(*pool->workers));
+    if (!pool->workers) {
+        fossil_net_pool_destroy(pool);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < pool->nworkers; i++) {
+        fossil__pool_worker_t *w = calloc(1, sizeof(*w));
+        pool->workers[i] = w;
+        if (!w) {
+            fossil_net_pool_destroy(pool);
+            return NULL;
+        }
+        w->pool = pool;
+        w->index = i;
+        w->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        atomic_init(&w->inbox_stub.next, NULL);
+        atomic_init(&w->inbox_head, &w->inbox_stub);
+        w->inbox_tail = &w->inbox_stub;
+        atomic_init(&w->array, fossil__deque_array_new(size));
+        if (!atomic_load_explicit(&w->array, memory_order_relaxed)) {
+            fossil_net_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    for (uint32_t i = 0; i < pool->nworkers; i++) {
+        fossil__pool_worker_t *w = pool->workers[i];
+#if defined(_WIN32)
+        w->thread = CreateThread(NULL, 0, fossil__pool_thread, w, 0, NULL);
+        w->started = w->thread != NULL;
+#else
+        w->started = pthread_create(&w->thread, NULL, fossil__pool_thread, w) == 0;
+#endif
+        if (!w->started) {
+            fossil_net_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void fossil_net_pool_destroy(fossil_net_pool_t *pool) {
+    if (!pool) return;
+    fossil__pool_mutex_lock(&pool->lock);
+    atomic_store_explicit(&pool->stopping, true, memory_order_release);
+    fossil__pool_cond_broadcast(&pool->wake);
+    fossil__pool_mutex_unlock(&pool->lock);
+    if (pool->workers) {
+        for (uint32_t i = 0; i < pool->nworkers; i++) {
+            fossil__pool_worker_t *w = pool->workers[i];
+            if (!w || !w->started) continue;
+#if defined(_WIN32)
+            WaitForSingleObject(w->thread, INFINITE);
+            CloseHandle(w->thread);
+#else
+            pthread_join(w->thread, NULL);
+#endif
+        }
+        for (uint32_t i = 0; i < pool->nworkers; i++)
+            fossil__pool_worker_free(pool->workers[i]);
+    }
+    free(pool->workers);
+    fossil__pool_cond_destroy(&pool->wake);
+    fossil__pool_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+/*=============================================================================
+SUBMISSION
+=============================================================================*/
+
+static int fossil__pool_enqueue(fossil_net_pool_t *pool, fossil_net_pool_fn fn,
+                                fossil_net_loop_task_fn done, void *arg) {
+    if (!pool || !fn || atomic_load_explicit(&pool->stopping, memory_order_acquire)) return -1;
+    fossil__pool_task_t *t = malloc(sizeof(*t));
+    if (!t) return -1;
+    t->fn = fn;
+    t->done = done;
+    t->origin = done ? fossil_net_loop_current() : NULL;
+    t->arg = arg;
+
+    fossil__pool_worker_t *self = fossil__pool_self;
+    if (!self || self->pool != pool || fossil__deque_push(self, t) != 0) {
+        uint32_t i = atomic_fetch_add_explicit(&pool->next_inbox, 1, memory_order_relaxed) % pool->nworkers;
+        fossil__inbox_push(pool->workers[i], t);
+    }
+    atomic_fetch_add_explicit(&pool->submitted, 1, memory_order_relaxed);
+    fossil__pool_notify(pool);
+    return 0;
+}
+
+int fossil_net_pool_submit(fossil_net_pool_t *pool, fossil_net_pool_fn fn, void *arg) {
+    return fossil__pool_enqueue(pool, fn, NULL, arg);
+}
+
+int fossil_net_pool_submit_reply(fossil_net_pool_t *pool, fossil_net_pool_fn work,
+                                 fossil_net_loop_task_fn done, void *arg) {
+    if (!done) return -1;
+    return fossil__pool_enqueue(pool, work, done, arg);
+}
+
+int fossil_net_pool_worker_index(const fossil_net_pool_t *pool) {
+    fossil__pool_worker_t *self = fossil__pool_self;
+    return (pool && self && self->pool == pool) ? (int)self->index : -1;
+}
+
+uint32_t fossil_net_pool_thread_count(const fossil_net_pool_t *pool) {
+    return pool ? pool->nworkers : 0;
+}
+
+int fossil_net_pool_get_stats(fossil_net_pool_t *pool, fossil_net_pool_stats_t *stats) {
+    if (!pool || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    stats->submitted = atomic_load_explicit(&pool->submitted, memory_order_relaxed);
+    for (uint32_t i = 0; i < pool->nworkers; i++) {
+        fossil__pool_worker_t *w = pool->workers[i];
+        stats->executed += atomic_load_explicit(&w->executed, memory_order_relaxed);
+        stats->stolen += atomic_load_explicit(&w->stolen, memory_order_relaxed);
+        stats->replies += atomic_load_explicit(&w->replies, memory_order_relaxed);
+        stats->parks += atomic_load_explicit(&w->parks, memory_order_relaxed);
+    }
+    return 0;
+}
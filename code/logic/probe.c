@@ -0,0 +1,469 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+// Must be defined before any system header for sendmmsg/recvmmsg.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/probe.h"
+#include "fossil/network/checksum.h"
+#include "fossil/network/ratelimit.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <errno.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+/*=============================================================================
+HELPERS
+=============================================================================*/
+
+#define FOSSIL__PROBE_SEQ_SPACE 65536u
+#define FOSSIL__PROBE_FREE      0xffffffffu
+#define FOSSIL__PROBE_BATCH     64u
+#define FOSSIL__PROBE_ICMP_LEN  8u
+#define FOSSIL__PROBE_IP_MAX    60u   /* IPv4 header with options on raw reads */
+
+typedef struct fossil__probe_target {
+    fossil_net_probe_target_stats_t stats;
+    uint8_t addr[FOSSIL_NET_SOCKADDR_MAX];
+    uint32_t addr_len;
+} fossil__probe_target_t;
+
+struct fossil_net_probe {
+    fossil_net_socket_t *sock;
+    uint8_t ipv6;
+    uint8_t ping_socket;      /* kernel owns the identifier and demuxes replies */
+    uint16_t identifier;
+    uint32_t payload_size;
+    uint64_t timeout_ns;
+    uint32_t payload_sum;     /* partial checksum of the fixed payload */
+    uint8_t *payload;
+
+    fossil__probe_target_t *targets;
+    uint32_t target_count;
+    uint32_t target_max;
+
+    // Outstanding probes keyed by sequence; [oldest, next) is the live window
+    uint32_t *pending_target;
+    uint64_t *pending_ns;
+    uint32_t oldest;
+    uint32_t next;
+
+    uint8_t *rx;              /* FOSSIL__PROBE_BATCH receive buffers */
+    uint32_t rx_size;
+    fossil_net_probe_stats_t stats;
+};
+
+static void fossil__probe_put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static uint16_t fossil__probe_get16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/* Mark the probe in a sequence slot lost and free it. */
+static void fossil__probe_expire_slot(fossil_net_probe_t *p, uint32_t idx) {
+    uint32_t t = p->pending_target[idx];
+    if (t == FOSSIL__PROBE_FREE) return;
+    p->targets[t].stats.lost++;
+    p->stats.lost++;
+    p->pending_target[idx] = FOSSIL__PROBE_FREE;
+}
+
+static void fossil__probe_expire(fossil_net_probe_t *p, uint64_t now) {
+    while (p->oldest != p->next) {
+        uint32_t idx = p->oldest & (FOSSIL__PROBE_SEQ_SPACE - 1);
+        if (p->pending_target[idx] != FOSSIL__PROBE_FREE) {
+            if (now - p->pending_ns[idx] < p->timeout_ns) break;
+            fossil__probe_expire_slot(p, idx);
+        }
+        p->oldest++;
+    }
+}
+
+static void fossil__probe_record(fossil_net_probe_t *p, uint32_t t, uint64_t rtt) {
+    fossil_net_probe_target_stats_t *s = &p->targets[t].stats;
+    if (s->received == 0 || rtt < s->rtt_min_ns) s->rtt_min_ns = rtt;
+    if (rtt > s->rtt_max_ns) s->rtt_max_ns = rtt;
+    s->rtt_sum_ns += rtt;
+    s->received++;
+    uint64_t us = rtt / 1000u;
+    uint32_t b = 0;
+    while (us > 1 && b < FOSSIL_NET_PROBE_HIST_BUCKETS - 1) {
+        us >>= 1;
+        b++;
+    }
+    s->histogram[b]++;
+    p->stats.received++;
+}
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+fossil_net_probe_t *fossil_net_probe_create(fossil_net_socket_t *sock, const fossil_net_probe_config_t *config) {
+    if (!sock || sock->fd < 0) return NULL;
+    if (sock->type != FOSSIL_NET_SOCKET_TYPE_RAW && sock->type != FOSSIL_NET_SOCKET_TYPE_ICMP) return NULL;
+    if (sock->family != FOSSIL_NET_SOCKET_FAMILY_IPV4 && sock->family != FOSSIL_NET_SOCKET_FAMILY_IPV6) return NULL;
+
+    fossil_net_probe_config_t cfg = { 1024, 1000, 56, 0 };
+    if (config) {
+        if (config->max_targets) cfg.max_targets = config->max_targets;
+        if (config->timeout_ms) cfg.timeout_ms = config->timeout_ms;
+        if (config->payload_size) cfg.payload_size = config->payload_size;
+        cfg.identifier = config->identifier;
+    }
+    if (cfg.payload_size > 65000) return NULL;
+
+    fossil_net_probe_t *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->sock = sock;
+    p->ipv6 = sock->family == FOSSIL_NET_SOCKET_FAMILY_IPV6;
+    p->ping_socket = sock->type == FOSSIL_NET_SOCKET_TYPE_ICMP;
+    p->identifier = cfg.identifier ? cfg.identifier : (uint16_t)(fossil_net_socket_clock_ns() >> 10);
+    p->payload_size = cfg.payload_size;
+    p->timeout_ns = (uint64_t)cfg.timeout_ms * 1000000u;
+    p->target_max = cfg.max_targets;
+    p->rx_size = FOSSIL__PROBE_IP_MAX + FOSSIL__PROBE_ICMP_LEN + cfg.payload_size;
+
+    p->payload = malloc(cfg.payload_size ? cfg.payload_size : 1);
+    p->targets = calloc(cfg.max_targets, sizeof(*p->targets));
+    p->pending_target = malloc(FOSSIL__PROBE_SEQ_SPACE * sizeof(uint32_t));
+    p->pending_ns = calloc(FOSSIL__PROBE_SEQ_SPACE, sizeof(uint64_t));
+    p->rx = malloc((size_t)FOSSIL__PROBE_BATCH * p->rx_size);
+    if (!p->payload || !p->targets || !p->pending_target || !p->pending_ns || !p->rx ||
+        fossil_net_socket_set_blocking(sock, false) != 0) {
+        fossil_net_probe_destroy(p);
+        return NULL;
+    }
+    memset(p->pending_target, 0xff, FOSSIL__PROBE_SEQ_SPACE * sizeof(uint32_t));
+
+    // Replies to a whole batch arrive at once; best effort, capped by the system
+    int rcvbuf = 4 << 20;
+#if defined(_WIN32)
+    setsockopt((SOCKET)(intptr_t)sock->fd, SOL_SOCKET, SO_RCVBUF, (const char*)&rcvbuf, sizeof(rcvbuf));
+#else
+    setsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+#endif
+
+    // Fixed payload: its checksum contribution is computed once
+    for (uint32_t i = 0; i < cfg.payload_size; ++i) p->payload[i] = (uint8_t)(0x10 + i);
+    p->payload_sum = fossil_net_checksum_partial(p->payload, cfg.payload_size, 0);
+    return p;
+}
+
+void fossil_net_probe_destroy(fossil_net_probe_t *probe) {
+    if (!probe) return;
+    free(probe->payload);
+    free(probe->targets);
+    free(probe->pending_target);
+    free(probe->pending_ns);
+    free(probe->rx);
+    free(probe);
+}
+
+int fossil_net_probe_add_target(fossil_net_probe_t *probe, const fossil_net_endpoint_t *target) {
+    if (!probe || !target || probe->target_count == probe->target_max) return -1;
+    uint8_t want = probe->ipv6 ? FOSSIL_NET_SOCKET_FAMILY_IPV6 : FOSSIL_NET_SOCKET_FAMILY_IPV4;
+    if (target->family != want) return -1;
+
+    fossil__probe_target_t *t = &probe->targets[probe->target_count];
+    memset(t, 0, sizeof(*t));
+    t->stats.target = *target;
+    t->stats.target.port = 0;
+    t->addr_len = fossil_net_endpoint_to_sockaddr(&t->stats.target, t->addr);
+    if (t->addr_len == 0) return -1;
+    return (int)probe->target_count++;
+}
+
+uint32_t fossil_net_probe_target_count(const fossil_net_probe_t *probe) {
+    return probe ? probe->target_count : 0;
+}
+
+/*=============================================================================
+PROBING
+=============================================================================*/
+
+/* Write an echo request for target t into buf; returns the sequence used. */
+static uint16_t fossil__probe_build(fossil_net_probe_t *p, uint8_t *buf, uint32_t t, uint64_t now) {
+    uint32_t seq_slot = p->next & (FOSSIL__PROBE_SEQ_SPACE - 1);
+    // Window full: the oldest probe is written off to reuse its sequence
+    if (p->next - p->oldest == FOSSIL__PROBE_SEQ_SPACE) {
+        fossil__probe_expire_slot(p, seq_slot);
+        p->oldest++;
+    }
+    uint16_t seq = (uint16_t)seq_slot;
+    buf[0] = p->ipv6 ? 128 : 8;
+    buf[1] = 0;
+    fossil__probe_put16(buf + 2, 0);
+    fossil__probe_put16(buf + 4, p->identifier);
+    fossil__probe_put16(buf + 6, seq);
+    // ICMPv6 checksums need the pseudo-header and are filled in by the kernel
+    if (!p->ipv6)
+        fossil__probe_put16(buf + 2, fossil_net_checksum_finish(fossil_net_checksum_partial(buf, FOSSIL__PROBE_ICMP_LEN, p->payload_sum)));
+    p->pending_target[seq_slot] = t;
+    p->pending_ns[seq_slot] = now;
+    p->next++;
+    return seq;
+}
+
+/* Undo the newest builds that never left (they are always at the window's end). */
+static void fossil__probe_unbuild(fossil_net_probe_t *p, uint32_t count) {
+    while (count--) {
+        p->next--;
+        p->pending_target[p->next & (FOSSIL__PROBE_SEQ_SPACE - 1)] = FOSSIL__PROBE_FREE;
+    }
+}
+
+static void fossil__probe_sent(fossil_net_probe_t *p, uint32_t t) {
+    p->targets[t].stats.sent++;
+    p->stats.sent++;
+}
+
+static void fossil__probe_refused(fossil_net_probe_t *p, uint16_t seq) {
+    p->pending_target[seq] = FOSSIL__PROBE_FREE;
+    p->stats.send_errors++;
+}
+
+/* Socket rate limit: how many of count packets may go now. */
+static uint32_t fossil__probe_tokens(fossil_net_probe_t *p, uint32_t count, uint32_t len) {
+    if (!(p->sock->flags & FOSSIL_NET_SOCKET_FLAG_RATELIMIT)) return count;
+    fossil_net_ratelimit_t *lim = fossil_net_socket_get_ratelimit(p->sock);
+    if (!lim) return count;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t wait = fossil_net_ratelimit_acquire(lim, len);
+        if (wait) {
+            fossil_net_ratelimit_record_throttle(lim, wait);
+            return i;
+        }
+    }
+    return count;
+}
+
+int fossil_net_probe_send(fossil_net_probe_t *probe, uint32_t first, uint32_t count, uint32_t *processed) {
+    if (processed) *processed = 0;
+    if (!probe || first > probe->target_count) return -1;
+    if (count > probe->target_count - first) count = probe->target_count - first;
+
+    uint32_t len = FOSSIL__PROBE_ICMP_LEN + probe->payload_size;
+    uint32_t done = 0;
+    while (done < count) {
+        uint32_t batch = count - done;
+        if (batch > FOSSIL__PROBE_BATCH) batch = FOSSIL__PROBE_BATCH;
+        batch = fossil__probe_tokens(probe, batch, len);
+        if (batch == 0) break;
+
+        uint8_t hdr[FOSSIL__PROBE_BATCH][FOSSIL__PROBE_ICMP_LEN];
+        uint16_t seqs[FOSSIL__PROBE_BATCH];
+        uint64_t now = fossil_net_socket_clock_ns();
+        for (uint32_t i = 0; i < batch; ++i)
+            seqs[i] = fossil__probe_build(probe, hdr[i], first + done + i, now);
+
+        uint32_t i = 0;
+        int blocked = 0;
+#if defined(__linux__)
+        struct mmsghdr msgs[FOSSIL__PROBE_BATCH];
+        struct iovec iov[FOSSIL__PROBE_BATCH][2];
+        memset(msgs, 0, sizeof(msgs[0]) * batch);
+        for (uint32_t k = 0; k < batch; ++k) {
+            fossil__probe_target_t *t = &probe->targets[first + done + k];
+            iov[k][0].iov_base = hdr[k];
+            iov[k][0].iov_len = FOSSIL__PROBE_ICMP_LEN;
+            iov[k][1].iov_base = probe->payload;
+            iov[k][1].iov_len = probe->payload_size;
+            msgs[k].msg_hdr.msg_name = t->addr;
+            msgs[k].msg_hdr.msg_namelen = t->addr_len;
+            msgs[k].msg_hdr.msg_iov = iov[k];
+            msgs[k].msg_hdr.msg_iovlen = 2;
+        }
+        while (i < batch) {
+            int n = sendmmsg(probe->sock->fd, msgs + i, batch - i, MSG_DONTWAIT);
+            if (n > 0) {
+                for (int k = 0; k < n; ++k) fossil__probe_sent(probe, first + done + i + (uint32_t)k);
+                i += (uint32_t)n;
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)) {
+                blocked = 1;
+                break;
+            }
+            // Message i was refused (unreachable, bad address): skip it
+            fossil__probe_refused(probe, seqs[i]);
+            i++;
+        }
+#else
+        uint8_t *pkt = probe->rx; // reuse rx storage to linearize header + payload
+        for (; i < batch; ++i) {
+            memcpy(pkt, hdr[i], FOSSIL__PROBE_ICMP_LEN);
+            memcpy(pkt + FOSSIL__PROBE_ICMP_LEN, probe->payload, probe->payload_size);
+            uint32_t sent = 0;
+            if (fossil_net_socket_send_to(probe->sock, pkt, len, &probe->targets[first + done + i].stats.target, &sent) == 0) {
+                fossil__probe_sent(probe, first + done + i);
+                continue;
+            }
+#if defined(_WIN32)
+            if (WSAGetLastError() == WSAEWOULDBLOCK) { blocked = 1; break; }
+#else
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) { blocked = 1; break; }
+#endif
+            fossil__probe_refused(probe, seqs[i]);
+        }
+#endif
+        if (i < batch) fossil__probe_unbuild(probe, batch - i);
+        done += i;
+        if (blocked) break;
+    }
+    if (processed) *processed = done;
+    return 0;
+}
+
+/* Match one received datagram against the outstanding table. */
+static int fossil__probe_match(fossil_net_probe_t *p, const uint8_t *data, uint32_t len,
+                               const fossil_net_endpoint_t *from, uint64_t now) {
+    // IPv4 raw sockets deliver the IP header too
+    if (!p->ipv6 && !p->ping_socket) {
+        if (len < 20 || (data[0] >> 4) != 4) return 0;
+        uint32_t ihl = (uint32_t)(data[0] & 0x0f) * 4u;
+        if (ihl < 20 || ihl > len) return 0;
+        data += ihl;
+        len -= ihl;
+    }
+    if (len < FOSSIL__PROBE_ICMP_LEN || data[0] != (p->ipv6 ? 129 : 0) || data[1] != 0) {
+        p->stats.ignored++;
+        return 0;
+    }
+    if (!p->ping_socket && fossil__probe_get16(data + 4) != p->identifier) {
+        p->stats.ignored++;
+        return 0;
+    }
+    uint16_t seq = fossil__probe_get16(data + 6);
+    uint32_t t = p->pending_target[seq];
+    if (t == FOSSIL__PROBE_FREE) {
+        p->stats.late++;
+        return 0;
+    }
+    const fossil_net_endpoint_t *want = &p->targets[t].stats.target;
+    if (from->family != want->family || memcmp(from->ip, want->ip, p->ipv6 ? 16 : 4) != 0) {
+        p->stats.ignored++;
+        return 0;
+    }
+    p->pending_target[seq] = FOSSIL__PROBE_FREE;
+    fossil__probe_record(p, t, now - p->pending_ns[seq]);
+    return 1;
+}
+
+int fossil_net_probe_poll(fossil_net_probe_t *probe, uint32_t *replies) {
+    if (replies) *replies = 0;
+    if (!probe) return -1;
+    uint32_t matched = 0;
+    int rc = 0;
+
+    for (;;) {
+#if defined(__linux__)
+        struct mmsghdr msgs[FOSSIL__PROBE_BATCH];
+        struct iovec iov[FOSSIL__PROBE_BATCH];
+        struct sockaddr_storage from[FOSSIL__PROBE_BATCH];
+        for (uint32_t k = 0; k < FOSSIL__PROBE_BATCH; ++k) {
+            iov[k].iov_base = probe->rx + (size_t)k * probe->rx_size;
+            iov[k].iov_len = probe->rx_size;
+            memset(&msgs[k], 0, sizeof(msgs[k]));
+            msgs[k].msg_hdr.msg_name = &from[k];
+            msgs[k].msg_hdr.msg_namelen = sizeof(from[k]);
+            msgs[k].msg_hdr.msg_iov = &iov[k];
+            msgs[k].msg_hdr.msg_iovlen = 1;
+        }
+        int n = recvmmsg(probe->sock->fd, msgs, FOSSIL__PROBE_BATCH, MSG_DONTWAIT, NULL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) rc = -1;
+            break;
+        }
+        uint64_t now = fossil_net_socket_clock_ns();
+        for (int k = 0; k < n; ++k) {
+            fossil_net_endpoint_t ep;
+            if (fossil_net_endpoint_from_sockaddr(&ep, &from[k]) != 0) continue;
+            matched += (uint32_t)fossil__probe_match(probe, iov[k].iov_base, msgs[k].msg_len, &ep, now);
+        }
+        if ((uint32_t)n < FOSSIL__PROBE_BATCH) break;
+#else
+        uint32_t got = 0;
+        fossil_net_endpoint_t ep;
+        if (fossil_net_socket_receive_from(probe->sock, probe->rx, probe->rx_size, &got, &ep) != 0) break;
+        matched += (uint32_t)fossil__probe_match(probe, probe->rx, got, &ep, fossil_net_socket_clock_ns());
+#endif
+    }
+
+    fossil__probe_expire(probe, fossil_net_socket_clock_ns());
+    if (replies) *replies = matched;
+    return rc;
+}
+
+/*=============================================================================
+RESULTS
+=============================================================================*/
+
+int fossil_net_probe_target_stats(const fossil_net_probe_t *probe, uint32_t index, fossil_net_probe_target_stats_t *stats) {
+    if (!probe || !stats || index >= probe->target_count) return -1;
+    *stats = probe->targets[index].stats;
+    return 0;
+}
+
+int fossil_net_probe_get_stats(const fossil_net_probe_t *probe, fossil_net_probe_stats_t *stats) {
+    if (!probe || !stats) return -1;
+    *stats = probe->stats;
+    return 0;
+}
+
+uint64_t fossil_net_probe_rtt_quantile_ns(const fossil_net_probe_target_stats_t *stats, double quantile) {
+    if (!stats || stats->received == 0) return 0;
+    if (quantile < 0.0) quantile = 0.0;
+    if (quantile > 1.0) quantile = 1.0;
+    uint64_t rank = (uint64_t)(quantile * (double)stats->received);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < FOSSIL_NET_PROBE_HIST_BUCKETS; ++b) {
+        seen += stats->histogram[b];
+        if (seen >= rank) {
+            uint64_t bound = (2ull << b) * 1000u;
+            return bound < stats->rtt_max_ns ? bound : stats->rtt_max_ns;
+        }
+    }
+    return stats->rtt_max_ns;
+}
@@ -0,0 +1,192 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/ratelimit.h"
+
+#include <stdlib.h>
+#include <stdatomic.h>
+
+/*
+ * The bucket is kept as a GCRA "theoretical arrival time": one 64-bit
+ * timestamp that advances by the cost of every grant. A request is granted
+ * while that time stays within one burst of now. This is equivalent to a
+ * token bucket but needs a single CAS, so a limiter can be shared by many
+ * sockets and threads without a lock.
+ */
+struct fossil_net_ratelimit {
+    _Atomic uint64_t tat;              /* theoretical arrival time, ns */
+    _Atomic uint64_t rate;             /* bytes per second */
+    _Atomic uint64_t burst;            /* bytes */
+    _Atomic uint64_t bytes_granted;
+    _Atomic uint64_t throttle_events;
+    _Atomic uint64_t throttled_ns;
+};
+
+#define FOSSIL__NS_PER_SEC 1000000000ull
+
+static uint64_t fossil__cost_ns(uint64_t bytes, uint64_t rate)
+{
+    /* bytes is bounded by UINT32_MAX, so bytes * 1e9 fits in 64 bits */
+    return (bytes * FOSSIL__NS_PER_SEC + rate - 1) / rate;
+}
+
+fossil_net_ratelimit_t *fossil_net_ratelimit_create(
+    uint64_t rate,
+    uint64_t burst)
+{
+    if (rate == 0 || burst == 0)
+        return NULL;
+
+    fossil_net_ratelimit_t *limiter = calloc(1, sizeof(*limiter));
+    if (!limiter)
+        return NULL;
+    fossil_net_ratelimit_set_rate(limiter, rate, burst);
+    return limiter;
+}
+
+void fossil_net_ratelimit_destroy(fossil_net_ratelimit_t *limiter)
+{
+    free(limiter);
+}
+
+int fossil_net_ratelimit_set_rate(
+    fossil_net_ratelimit_t *limiter,
+    uint64_t rate,
+    uint64_t burst)
+{
+    if (!limiter || rate == 0 || burst == 0)
+        return -1;
+    if (burst > UINT32_MAX)
+        burst = UINT32_MAX;
+    atomic_store_explicit(&limiter->rate, rate, memory_order_relaxed);
+    atomic_store_explicit(&limiter->burst, burst, memory_order_relaxed);
+    return 0;
+}
+
+uint64_t fossil_net_ratelimit_burst(const fossil_net_ratelimit_t *limiter)
+{
+    if (!limiter)
+        return 0;
+    return atomic_load_explicit(&((fossil_net_ratelimit_t *)limiter)->burst, memory_order_relaxed);
+}
+
+/* Nanoseconds until `bytes` fit, given the current arrival time. */
+static uint64_t fossil__wait_ns(uint64_t tat, uint64_t now, uint64_t cost, uint64_t burst_ns)
+{
+    uint64_t base = tat > now ? tat : now;
+    uint64_t next = base + cost;
+    return next > now + burst_ns ? next - now - burst_ns : 0;
+}
+
+uint64_t fossil_net_ratelimit_acquire(
+    fossil_net_ratelimit_t *limiter,
+    uint32_t bytes)
+{
+    if (!limiter)
+        return 0;
+
+    uint64_t rate = atomic_load_explicit(&limiter->rate, memory_order_relaxed);
+    uint64_t burst = atomic_load_explicit(&limiter->burst, memory_order_relaxed);
+    if (bytes > burst)
+        return UINT64_MAX;
+
+    uint64_t cost = fossil__cost_ns(bytes, rate);
+    uint64_t burst_ns = fossil__cost_ns(burst, rate);
+    uint64_t now = fossil_net_socket_clock_ns();
+    uint64_t tat = atomic_load_explicit(&limiter->tat, memory_order_relaxed);
+
+    for (;;) {
+        uint64_t wait = fossil__wait_ns(tat, now, cost, burst_ns);
+        if (wait)
+            return wait;
+        uint64_t next = (tat > now ? tat : now) + cost;
+        if (atomic_compare_exchange_weak_explicit(&limiter->tat, &tat, next,
+                                                  memory_order_relaxed, memory_order_relaxed))
+            break;
+    }
+    atomic_fetch_add_explicit(&limiter->bytes_granted, bytes, memory_order_relaxed);
+    return 0;
+}
+
+void fossil_net_ratelimit_release(
+    fossil_net_ratelimit_t *limiter,
+    uint32_t bytes)
+{
+    if (!limiter || bytes == 0)
+        return;
+
+    uint64_t rate = atomic_load_explicit(&limiter->rate, memory_order_relaxed);
+    uint64_t cost = fossil__cost_ns(bytes, rate);
+    uint64_t tat = atomic_load_explicit(&limiter->tat, memory_order_relaxed);
+    uint64_t next;
+    do {
+        next = tat > cost ? tat - cost : 0;
+    } while (!atomic_compare_exchange_weak_explicit(&limiter->tat, &tat, next,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    atomic_fetch_sub_explicit(&limiter->bytes_granted, bytes, memory_order_relaxed);
+}
+
+uint32_t fossil_net_ratelimit_delay_ms(
+    const fossil_net_ratelimit_t *limiter,
+    uint32_t bytes)
+{
+    if (!limiter)
+        return 0;
+
+    fossil_net_ratelimit_t *l = (fossil_net_ratelimit_t *)limiter;
+    uint64_t rate = atomic_load_explicit(&l->rate, memory_order_relaxed);
+    uint64_t burst = atomic_load_explicit(&l->burst, memory_order_relaxed);
+    if (bytes > burst)
+        bytes = (uint32_t)burst;
+
+    uint64_t wait = fossil__wait_ns(atomic_load_explicit(&l->tat, memory_order_relaxed),
+                                    fossil_net_socket_clock_ns(),
+                                    fossil__cost_ns(bytes, rate),
+                                    fossil__cost_ns(burst, rate));
+    uint64_t ms = (wait + 999999) / 1000000;
+    return ms > UINT32_MAX ? UINT32_MAX : (uint32_t)ms;
+}
+
+void fossil_net_ratelimit_record_throttle(
+    fossil_net_ratelimit_t *limiter,
+    uint64_t ns)
+{
+    if (!limiter)
+        return;
+    atomic_fetch_add_explicit(&limiter->throttle_events, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&limiter->throttled_ns, ns, memory_order_relaxed);
+}
+
+int fossil_net_ratelimit_get_stats(
+    const fossil_net_ratelimit_t *limiter,
+    fossil_net_ratelimit_stats_t *stats)
+{
+    if (!limiter || !stats)
+        return -1;
+    fossil_net_ratelimit_t *l = (fossil_net_ratelimit_t *)limiter;
+    stats->bytes_granted = atomic_load_explicit(&l->bytes_granted, memory_order_relaxed);
+    stats->throttle_events = atomic_load_explicit(&l->throttle_events, memory_order_relaxed);
+    stats->throttled_ns = atomic_load_explicit(&l->throttled_ns, memory_order_relaxed);
+    return 0;
+}
@@ -0,0 +1,1843 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+// Must be defined before any system header to expose accept4, recvmmsg & co.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/reactor.h"
+#include "fossil/network/conntable.h"
+#include "fossil/network/filter.h"
+#include "fossil/network/ratelimit.h"
+#include "fossil/network/tap.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define FOSSIL__REACTOR_EPOLL 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <sys/event.h>
+#define FOSSIL__REACTOR_KQUEUE 1
+#endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+PLATFORM
+=============================================================================*/
+
+#if defined(_WIN32)
+#define FOSSIL__REACTOR_TLS __declspec(thread)
+typedef HANDLE fossil__reactor_thread_t;
+#define fossil__reactor_closesocket(fd) closesocket((SOCKET)(intptr_t)(fd))
+#define fossil__reactor_shutdown_write(fd) shutdown((SOCKET)(intptr_t)(fd), SD_SEND)
+#else
+#define FOSSIL__REACTOR_TLS _Thread_local
+typedef pthread_t fossil__reactor_thread_t;
+#define fossil__reactor_closesocket(fd) close(fd)
+#define fossil__reactor_shutdown_write(fd) shutdown(fd, SHUT_WR)
+#endif
+
+#if defined(MSG_NOSIGNAL)
+#define FOSSIL__REACTOR_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define FOSSIL__REACTOR_SEND_FLAGS 0
+#endif
+
+#define FOSSIL__EV_READ  0x1u
+#define FOSSIL__EV_WRITE 0x2u
+#define FOSSIL__EV_HUP   0x4u
+
+#define FOSSIL__REACTOR_TASK_BUDGET 4096u  /* tasks per round before polling again */
+#define FOSSIL__REACTOR_MAX_CONNS   (1u << 24) /* per loop; the slot index fills 24 bits of an ID */
+#define FOSSIL__REACTOR_ACCEPT_PAUSE_NS 100000000ull
+#define FOSSIL__REACTOR_DGRAM_ROUNDS 4u  /* full receive batches per wakeup before polling again */
+
+static uint32_t fossil__reactor_cpus(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors ? (uint32_t)si.dwNumberOfProcessors : 1u;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1u;
+#endif
+}
+
+/* CPUs the process may run on, in order; at most max of them. */
+static uint32_t fossil__reactor_allowed_cpus(int32_t *out, uint32_t max) {
+    uint32_t n = 0;
+#if defined(__linux__)
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE && n < max; c++)
+            if (CPU_ISSET(c, &set)) out[n++] = c;
+    }
+    if (n) return n;
+#endif
+    uint32_t cpus = fossil__reactor_cpus();
+    for (; n < cpus && n < max; n++)
+        out[n] = (int32_t)n;
+    return n;
+}
+
+/* true if the last socket call failed only because it would block */
+static bool fossil__reactor_would_block(void) {
+#if defined(_WIN32)
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+/*=============================================================================
+POLLER
+=============================================================================*/
+
+/* One readiness report: the token given at registration and FOSSIL__EV_* bits. */
+typedef struct fossil__ready {
+    void *ptr;
+    uint32_t events;
+} fossil__ready_t;
+
+typedef struct fossil__poller {
+#if defined(FOSSIL__REACTOR_EPOLL)
+    int fd;
+    struct epoll_event *buf;
+#elif defined(FOSSIL__REACTOR_KQUEUE)
+    int fd;
+    struct kevent *buf;
+#else
+#if defined(_WIN32)
+    WSAPOLLFD *fds;
+#else
+    struct pollfd *fds;
+#endif
+    void **ptrs;
+    uint32_t count;
+    uint32_t capacity;
+#endif
+    uint32_t max;
+} fossil__poller_t;
+
+#if defined(FOSSIL__REACTOR_EPOLL)
+
+static int fossil__poller_open(fossil__poller_t *p, uint32_t max) {
+    p->max = max;
+    p->buf = calloc(max, sizeof(*p->buf));
+    p->fd = epoll_create1(EPOLL_CLOEXEC);
+    if (!p->buf || p->fd < 0) {
+        free(p->buf);
+        if (p->fd >= 0) close(p->fd);
+        return -1;
+    }
+    return 0;
+}
+
+static void fossil__poller_close(fossil__poller_t *p) {
+    close(p->fd);
+    free(p->buf);
+}
+
+static int fossil__poller_ctl(fossil__poller_t *p, int op, int32_t fd, uint32_t events, void *ptr) {
+    struct epoll_event e;
+    memset(&e, 0, sizeof(e));
+    e.events = ((events & FOSSIL__EV_READ) ? EPOLLIN : 0u) | ((events & FOSSIL__EV_WRITE) ? EPOLLOUT : 0u);
+    e.data.ptr = ptr;
+    return epoll_ctl(p->fd, op, fd, &e);
+}
+
+static int fossil__poller_add(fossil__poller_t *p, int32_t fd, uint32_t events, void *ptr) {
+    return fossil__poller_ctl(p, EPOLL_CTL_ADD, fd, events, ptr);
+}
+
+static int fossil__poller_mod(fossil__poller_t *p, int32_t fd, uint32_t events, void *ptr) {
+    return fossil__poller_ctl(p, EPOLL_CTL_MOD, fd, events, ptr);
+}
+
+static void fossil__poller_del(fossil__poller_t *p, int32_t fd) {
+    struct epoll_event e;
+    memset(&e, 0, sizeof(e));
+    epoll_ctl(p->fd, EPOLL_CTL_DEL, fd, &e);
+}
+
+static int fossil__poller_wait(fossil__poller_t *p, fossil__ready_t *out, int timeout_ms) {
+    int n = epoll_wait(p->fd, p->buf, (int)p->max, timeout_ms);
+    if (n <= 0) return 0;
+    for (int i = 0; i < n; i++) {
+        uint32_t e = p->buf[i].events;
+        out[i].ptr = p->buf[i].data.ptr;
+        out[i].events = ((e & EPOLLIN) ? FOSSIL__EV_READ : 0u) |
+                        ((e & EPOLLOUT) ? FOSSIL__EV_WRITE : 0u) |
+                        ((e & (EPOLLHUP | EPOLLERR)) ? FOSSIL__EV_HUP : 0u);
+    }
+    return n;
+}
+
+#elif defined(FOSSIL__REACTOR_KQUEUE)
+
+static int fossil__poller_open(fossil__poller_t *p, uint32_t max) {
+    p->max = max;
+    p->buf = calloc(max, sizeof(*p->buf));
+    p->fd = kqueue();
+    if (!p->buf || p->fd < 0) {
+        free(p->buf);
+        if (p->fd >= 0) close(p->fd);
+        return -1;
+    }
+    fcntl(p->fd, F_SETFD, FD_CLOEXEC);
+    return 0;
+}
+
+static void fossil__poller_close(fossil__poller_t *p) {
+    close(p->fd);
+    free(p->buf);
+}
+
+static int fossil__poller_add(fossil__poller_t *p, int32_t fd, uint32_t events, void *ptr) {
+    struct kevent kev[2];
+    EV_SET(&kev[0], fd, EVFILT_READ, EV_ADD | ((events & FOSSIL__EV_READ) ? EV_ENABLE : EV_DISABLE), 0, 0, ptr);
+    EV_SET(&kev[1], fd, EVFILT_WRITE, EV_ADD | ((events & FOSSIL__EV_WRITE) ? EV_ENABLE : EV_DISABLE), 0, 0, ptr);
+    return kevent(p->fd, kev, 2, NULL, 0, NULL) < 0 ? -1 : 0;
+}
+
+static int fossil__poller_mod(fossil__poller_t *p, int32_t fd, uint32_t events, void *ptr) {
+    return fossil__poller_add(p, fd, events, ptr);
+}
+
+static void fossil__poller_del(fossil__poller_t *p, int32_t fd) {
+    struct kevent kev[2];
+    EV_SET(&kev[0], fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    EV_SET(&kev[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    kevent(p->fd, kev, 2, NULL, 0, NULL);
+}
+
+static int fossil__poller_wait(fossil__poller_t *p, fossil__ready_t *out, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    int n = kevent(p->fd, NULL, 0, p->buf, (int)p->max, timeout_ms < 0 ? NULL : &ts);
+    if (n <= 0) return 0;
+    for (int i = 0; i < n; i++) {
+        out[i].ptr = p->buf[i].udata;
+        out[i].events = (p->buf[i].filter == EVFILT_WRITE ? FOSSIL__EV_WRITE : FOSSIL__EV_READ) |
+                        ((p->buf[i].flags & (EV_EOF | EV_ERROR)) ? FOSSIL__EV_HUP : 0u);
+    }
+    return n;
+}
+
+#else /* poll(2) / WSAPoll */
+
+static int fossil__poller_open(fossil__poller_t *p, uint32_t max) {
+    memset(p, 0, sizeof(*p));
+    p->max = max;
+    return 0;
+}
+
+static void fossil__poller_close(fossil__poller_t *p) {
+    free(p->fds);
+    free(p->ptrs);
+}
+
+static short fossil__poller_mask(uint32_t events) {
+    return (short)(((events & FOSSIL__EV_READ) ? POLLIN : 0) | ((events & FOSSIL__EV_WRITE) ? POLLOUT : 0));
+}
+
+static int fossil__poller_find(const fossil__poller_t *p, int32_t fd) {
+    for (uint32_t i = 0; i < p->count; i++)
+        if ((int32_t)(intptr_t)p->fds[i].fd == fd) return (int)i;
+    return -1;
+}
+
+static int fossil__poller_add(fossil__poller_t *p, int32_t fd, uint32_t events, void *ptr) {
+    if (p->count == p->capacity) {
+        uint32_t cap = p->capacity ? p->capacity * 2u : 64u;
+        void *fds = realloc(p->fds, cap * sizeof(*p->fds));
+        if (!fds) return -1;
+        p->fds = fds;
+        void **ptrs = realloc(p->ptrs, cap * sizeof(*p->ptrs));
+        if (!ptrs) return -1;
+        p->ptrs = ptrs;
+        p->capacity = cap;
+    }
+#if defined(_WIN32)
+    p->fds[p->count].fd = (SOCKET)(intptr_t)fd;
+#else
+    p->fds[p->count].fd = fd;
+#endif
+    p->fds[p->count].events = fossil__poller_mask(events);
+    p->fds[p->count].revents = 0;
+    p->ptrs[p->count++] = ptr;
+    return 0;
+}
+
+static int fossil__poller_mod(fossil__poller_t *p, int32_t fd, uint32_t events, void *ptr) {
+    int i = fossil__poller_find(p, fd);
+    if (i < 0) return -1;
+    p->fds[i].events = fossil__poller_mask(events);
+    p->ptrs[i] = ptr;
+    return 0;
+}
+
+static void fossil__poller_del(fossil__poller_t *p, int32_t fd) {
+    int i = fossil__poller_find(p, fd);
+    if (i < 0) return;
+    p->count--;
+    p->fds[i] = p->fds[p->count];
+    p->ptrs[i] = p->ptrs[p->count];
+}
+
+static int fossil__poller_wait(fossil__poller_t *p, fossil__ready_t *out, int timeout_ms) {
+#if defined(_WIN32)
+    int n = WSAPoll(p->fds, (ULONG)p->count, timeout_ms);
+#else
+    int n = poll(p->fds, (nfds_t)p->count, timeout_ms);
+#endif
+    if (n <= 0) return 0;
+    int k = 0;
+    for (uint32_t i = 0; i < p->count && (uint32_t)k < p->max; i++) {
+        short re = p->fds[i].revents;
+        if (!re) continue;
+        out[k].ptr = p->ptrs[i];
+        out[k].events = ((re & POLLIN) ? FOSSIL__EV_READ : 0u) |
+                        ((re & POLLOUT) ? FOSSIL__EV_WRITE : 0u) |
+                        ((re & (POLLHUP | POLLERR)) ? FOSSIL__EV_HUP : 0u);
+        k++;
+    }
+    return k;
+}
+
+#endif
+
+/*=============================================================================
+WAKEUP
+=============================================================================*/
+
+/*
+ * Cross-thread wakeup: an eventfd on Linux, a pipe on other POSIX systems and
+ * a loopback UDP socket connected to itself on Windows (WSAPoll only takes
+ * sockets).
+ */
+typedef struct fossil__wake {
+    int32_t rfd;
+    int32_t wfd;
+} fossil__wake_t;
+
+static int fossil__wake_open(fossil__wake_t *w) {
+#if defined(FOSSIL__REACTOR_EPOLL)
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) return -1;
+    w->rfd = w->wfd = fd;
+#elif defined(_WIN32)
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) return -1;
+    struct sockaddr_in sa;
+    int salen = sizeof(sa);
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    u_long mode = 1;
+    if (bind(s, (struct sockaddr*)&sa, sizeof(sa)) != 0 ||
+        getsockname(s, (struct sockaddr*)&sa, &salen) != 0 ||
+        connect(s, (struct sockaddr*)&sa, sizeof(sa)) != 0 ||
+        ioctlsocket(s, FIONBIO, &mode) != 0) {
+        closesocket(s);
+        return -1;
+    }
+    w->rfd = w->wfd = (int32_t)(intptr_t)s;
+#else
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    w->rfd = fds[0];
+    w->wfd = fds[1];
+#endif
+    return 0;
+}
+
+static void fossil__wake_close(fossil__wake_t *w) {
+#if defined(_WIN32)
+    closesocket((SOCKET)(intptr_t)w->rfd);
+#else
+    close(w->rfd);
+    if (w->wfd != w->rfd) close(w->wfd);
+#endif
+}
+
+static void fossil__wake_signal(fossil__wake_t *w) {
+#if defined(FOSSIL__REACTOR_EPOLL)
+    uint64_t one = 1;
+    ssize_t r = write(w->wfd, &one, sizeof(one));
+    (void)r;
+#elif defined(_WIN32)
+    char one = 1;
+    send((SOCKET)(intptr_t)w->wfd, &one, 1, 0);
+#else
+    char one = 1;
+    ssize_t r = write(w->wfd, &one, 1);
+    (void)r;
+#endif
+}
+
+static void fossil__wake_drain(fossil__wake_t *w) {
+#if defined(FOSSIL__REACTOR_EPOLL)
+    uint64_t v;
+    ssize_t r = read(w->rfd, &v, sizeof(v));
+    (void)r;
+#elif defined(_WIN32)
+    char buf[64];
+    while (recv((SOCKET)(intptr_t)w->rfd, buf, sizeof(buf), 0) > 0) { }
+#else
+    char buf[64];
+    while (read(w->rfd, buf, sizeof(buf)) > 0) { }
+#endif
+}
+
+/*=============================================================================
+TASK QUEUE
+=============================================================================*/
+
+/*
+ * Intrusive multi-producer single-consumer queue (Vyukov): a push is one
+ * atomic exchange plus a store, the owning loop pops without atomics RMW.
+ * A task runs fn(arg), runs conn_fn on the connection conn_id names, or,
+ * when fd >= 0, adopts a connection handed off by the accepting loop.
+ */
+typedef struct fossil__task {
+    _Atomic(struct fossil__task *) next;
+    fossil_net_loop_task_fn fn;
+    fossil_net_conn_task_fn conn_fn;
+    uint64_t queued_ns;             /* accept handoff: estimated accept-queue entry */
+    fossil_net_conn_id_t conn_id;
+    void *arg;
+    int32_t fd;
+    fossil_net_endpoint_t peer;
+} fossil__task_t;
+
+typedef struct fossil__task_queue {
+    _Atomic(fossil__task_t *) head;
+    fossil__task_t *tail;
+    fossil__task_t stub;
+} fossil__task_queue_t;
+
+static void fossil__queue_init(fossil__task_queue_t *q) {
+    atomic_init(&q->stub.next, NULL);
+    atomic_init(&q->head, &q->stub);
+    q->tail = &q->stub;
+}
+
+static void fossil__queue_push(fossil__task_queue_t *q, fossil__task_t *t) {
+    atomic_store_explicit(&t->next, NULL, memory_order_relaxed);
+    fossil__task_t *prev = atomic_exchange_explicit(&q->head, t, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, t, memory_order_release);
+}
+
+/* Returns NULL when empty or when a producer is between its two steps. */
+static fossil__task_t *fossil__queue_pop(fossil__task_queue_t *q) {
+    fossil__task_t *tail = q->tail;
+    fossil__task_t *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (tail == &q->stub) {
+        if (!next) return NULL;
+        q->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+    if (tail != atomic_load_explicit(&q->head, memory_order_acquire)) return NULL;
+    fossil__queue_push(q, &q->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next) {
+        q->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+/*
+ * Lives in its loop's slab table. The slot is released only after the
+ * round in which the connection closed, so readiness events still queued
+ * for it see closed != 0 instead of a reused slot.
+ */
+struct fossil_net_conn {
+    fossil_net_socket_t sock;
+    uint32_t interest;              /* FOSSIL__EV_* registered with the poller */
+    uint8_t closed;
+    uint8_t want_write;             /* on_writable requested */
+    uint8_t read_paused;            /* fossil_net_conn_want_read(conn, false) */
+    uint8_t linger;                 /* close once the write queue drains */
+    uint64_t active_ns;             /* last read activity, tracked while shedding */
+    fossil_net_writeq_t *wq;        /* created on first buffered write */
+    fossil_net_conn_id_t id;
+    fossil_net_loop_t *loop;
+    void *user;
+    fossil_net_conn_t *next_closed; /* graveyard chain */
+    fossil_net_endpoint_t peer;
+};
+
+/*
+ * Datagram mode receive batch. Slot i owns 2 * max_datagram bytes of
+ * slab, received bytes then reply_buf, and peers[i], which is both where
+ * the datagram came from and where its reply goes.
+ */
+typedef struct fossil__dgram_batch {
+    uint32_t cap;
+    uint32_t max;
+    uint8_t *slab;
+    fossil_net_datagram_t *dgrams;
+    struct sockaddr_storage *peers;
+    socklen_t *peer_lens;
+#if defined(__linux__)
+    struct mmsghdr *in;
+    struct mmsghdr *out;
+    struct iovec *iov;              /* cap receive vectors, then cap reply vectors */
+#endif
+} fossil__dgram_batch_t;
+
+/* Conn IDs: generation in the high 32 bits, loop index in bits 24-31. */
+#define FOSSIL__CONN_ID_LOOP(id)   ((uint32_t)((id) >> 24) & 0xffu)
+#define FOSSIL__CONN_ID_HANDLE(id) ((id) & ~((fossil_net_conn_id_t)0xffu << 24))
+
+struct fossil_net_loop {
+    fossil_net_reactor_t *reactor;
+    uint32_t index;
+    fossil__poller_t poller;
+    fossil__ready_t *ready;
+    fossil__wake_t wake;
+    atomic_bool wake_pending;       /* a wakeup is already in flight */
+    fossil__task_queue_t tasks;
+    bool tasks_left;                /* budget ran out, poll without blocking */
+
+    fossil_net_socket_t listener;   /* fd -1 when this loop does not accept */
+    bool owns_listener;
+    bool accepting;                 /* listener is registered with the poller */
+    bool draining;                  /* accepting stopped for good */
+    uint64_t accept_resume_ns;      /* accepting paused until then, 0 if not */
+    uint32_t next_target;           /* round-robin handoff cursor */
+    uint64_t ready_ns;              /* earliest arrival of what this round's poll reported */
+    uint64_t polled_ns;             /* when the previous poll returned */
+    uint64_t sweep_ns;              /* next idle sweep */
+
+    fossil_net_conntable_t *conns;  /* connection slab */
+    fossil_net_conn_t *graveyard;   /* closed during this round, released after it */
+    fossil__dgram_batch_t *dgram;   /* datagram mode only */
+    int32_t cpu;                    /* CPU to pin the thread to, -1 if none */
+    _Atomic int32_t bound_cpu;      /* cpu while the thread runs pinned, else -1 */
+
+    fossil__reactor_thread_t thread;
+    bool started;
+    char tag_listener;              /* addresses used as poller tokens */
+    char tag_wake;
+
+    /* written by the owning thread only, read by get_stats */
+    _Atomic uint64_t accepted;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t closed;
+    _Atomic uint64_t handoffs;
+    _Atomic uint64_t accept_errors;
+    _Atomic uint64_t tasks_run;
+    _Atomic uint64_t wakeups;
+    _Atomic uint64_t shed;
+    _Atomic uint64_t idle_closed;
+    _Atomic uint64_t datagrams;
+    _Atomic uint64_t recv_calls;
+    _Atomic uint64_t replies;
+    _Atomic uint64_t reply_drops;
+    _Atomic uint64_t truncated;
+    _Atomic uint64_t bytes_in;
+    _Atomic uint64_t bytes_out;
+};
+
+struct fossil_net_reactor {
+    fossil_net_server_t *server;
+    fossil_net_reactor_config_t config;
+    fossil_net_reactor_callbacks_t cb;
+    void *user;
+    uint32_t nloops;
+    fossil_net_loop_t **loops;
+    atomic_bool stopping;
+    atomic_bool draining;
+    fossil_net_conn_task_fn drain_fn; /* set before the drain tasks are posted */
+    void *drain_arg;
+    bool running;
+    bool datagram;                  /* UDP server: on_datagram instead of connections */
+    bool joined_group;              /* server socket had SO_REUSEPORT before create */
+    fossil_net_shed_t *shed;
+    fossil_net_shed_config_t shed_config;
+    _Atomic uint64_t live;          /* open connections over all loops */
+};
+
+static FOSSIL__REACTOR_TLS fossil_net_loop_t *fossil__loop_tls;
+
+static inline void fossil__count(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+/*=============================================================================
+CONNECTION LIFECYCLE
+=============================================================================*/
+
+static void fossil__conn_close(fossil_net_conn_t *conn) {
+    if (conn->closed) return;
+    conn->closed = 1;
+    fossil_net_loop_t *loop = conn->loop;
+    fossil_net_reactor_t *r = loop->reactor;
+    if (r->cb.on_close) r->cb.on_close(conn, r->user);
+
+    fossil__poller_del(&loop->poller, conn->sock.fd);
+    fossil__reactor_closesocket(conn->sock.fd);
+    conn->sock.fd = -1;
+    conn->sock.flags &= (uint16_t)~FOSSIL_NET_SOCKET_FLAG_CONNECTED;
+    conn->next_closed = loop->graveyard;
+    loop->graveyard = conn;
+    fossil__count(&loop->closed, 1);
+    atomic_fetch_sub_explicit(&r->live, 1, memory_order_relaxed);
+}
+
+/* Graceful close: FIN after the last queued byte, then release. */
+static void fossil__conn_linger_close(fossil_net_conn_t *conn) {
+    if (conn->closed) return;
+    fossil__reactor_shutdown_write(conn->sock.fd);
+    fossil__conn_close(conn);
+}
+
+/* Poll for writability while the user asked for it or buffered bytes wait. */
+static int fossil__conn_update_interest(fossil_net_conn_t *conn) {
+    bool read = !conn->read_paused && !conn->linger;
+    bool write = conn->want_write || fossil_net_writeq_pending(conn->wq) != 0;
+    uint32_t interest = (read ? FOSSIL__EV_READ : 0u) | (write ? FOSSIL__EV_WRITE : 0u);
+    if (interest == conn->interest) return 0;
+    if (fossil__poller_mod(&conn->loop->poller, conn->sock.fd, interest, conn) != 0) return -1;
+    conn->interest = interest;
+    return 0;
+}
+
+static void fossil__loop_reap(fossil_net_loop_t *loop) {
+    while (loop->graveyard) {
+        fossil_net_conn_t *c = loop->graveyard;
+        loop->graveyard = c->next_closed;
+        /* Freed here, not in close: on_watermark may close from inside a write. */
+        fossil_net_writeq_destroy(c->wq);
+        fossil_net_conntable_release(loop->conns, FOSSIL__CONN_ID_HANDLE(c->id));
+    }
+}
+
+static void fossil__loop_adopt(fossil_net_loop_t *loop, int32_t fd, const fossil_net_endpoint_t *peer, uint64_t queued_ns) {
+    fossil_net_reactor_t *r = loop->reactor;
+    fossil_net_handle_t h;
+    fossil_net_conn_t *conn = fossil_net_conntable_alloc(loop->conns, &h);
+    if (!conn || fossil__poller_add(&loop->poller, fd, FOSSIL__EV_READ, conn) != 0) {
+        if (conn) fossil_net_conntable_release(loop->conns, h);
+        fossil__reactor_closesocket(fd);
+        fossil__count(&loop->accept_errors, 1);
+        fossil__count(&loop->closed, 1);
+        return;
+    }
+    conn->sock.fd = fd;
+    conn->sock.type = FOSSIL_NET_SOCKET_TYPE_TCP;
+    conn->sock.family = fossil_net_server_socket(r->server)->family;
+    conn->sock.flags = FOSSIL_NET_SOCKET_FLAG_CONNECTED;
+    conn->interest = FOSSIL__EV_READ;
+    conn->id = h | ((fossil_net_conn_id_t)loop->index << 24);
+    conn->loop = loop;
+    conn->peer = *peer;
+    atomic_fetch_add_explicit(&r->live, 1, memory_order_relaxed);
+    if (r->shed) {
+        uint64_t now = fossil_net_socket_clock_ns();
+        conn->active_ns = now;
+        fossil_net_shed_record(r->shed, FOSSIL_NET_SHED_ACCEPT, now > queued_ns ? now - queued_ns : 0, now);
+    }
+
+    if (r->cb.on_accept && r->cb.on_accept(conn, r->user) != 0 && !conn->closed) {
+        fossil__count(&loop->rejected, 1);
+        fossil__conn_close(conn);
+        return;
+    }
+    /* A handoff that was queued before this loop started draining. */
+    if (loop->draining && r->drain_fn && !conn->closed) r->drain_fn(conn, r->drain_arg);
+}
+
+/*=============================================================================
+ACCEPTING
+=============================================================================*/
+
+/* With pinned loops, the loop on the CPU that received the connection's packets, if any. */
+static fossil_net_loop_t *fossil__loop_rx_target(fossil_net_reactor_t *r, int32_t fd) {
+#if defined(__linux__) && defined(SO_INCOMING_CPU)
+    if (!r->config.pin_cpus) return NULL;
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) != 0 || cpu < 0) return NULL;
+    for (uint32_t i = 0; i < r->nloops; i++)
+        if (r->loops[i]->cpu == cpu) return r->loops[i];
+#else
+    (void)r;
+    (void)fd;
+#endif
+    return NULL;
+}
+
+/* 0 with a new descriptor, 1 when the queue is empty, -1 on a hard error. */
+static int fossil__loop_accept_one(fossil_net_loop_t *loop, int32_t *fd, fossil_net_endpoint_t *peer) {
+    struct sockaddr_storage sa;
+    socklen_t salen = sizeof(sa);
+    for (;;) {
+#if defined(_WIN32)
+        SOCKET s = accept((SOCKET)(intptr_t)loop->listener.fd, (struct sockaddr*)&sa, &salen);
+        if (s == INVALID_SOCKET) {
+            int e = WSAGetLastError();
+            if (e == WSAEWOULDBLOCK) return 1;
+            if (e == WSAECONNRESET || e == WSAEINTR) continue;
+            return -1;
+        }
+        u_long mode = 1;
+        ioctlsocket(s, FIONBIO, &mode);
+        *fd = (int32_t)(intptr_t)s;
+#else
+#if defined(__linux__)
+        int s = accept4(loop->listener.fd, (struct sockaddr*)&sa, &salen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int s = accept(loop->listener.fd, (struct sockaddr*)&sa, &salen);
+#endif
+        if (s < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) continue;
+            return -1;
+        }
+#if !defined(__linux__)
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+        fcntl(s, F_SETFD, FD_CLOEXEC);
+#endif
+#if defined(SO_NOSIGPIPE)
+        int one = 1;
+        setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        *fd = s;
+#endif
+        if (fossil_net_endpoint_from_sockaddr(peer, &sa) != 0)
+            memset(peer, 0, sizeof(*peer));
+        return 0;
+    }
+}
+
+static void fossil__loop_set_accepting(fossil_net_loop_t *loop, bool on) {
+    if (loop->accepting == on || (on && loop->draining)) return;
+    if (on) {
+        if (fossil__poller_add(&loop->poller, loop->listener.fd, FOSSIL__EV_READ, &loop->tag_listener) != 0)
+            return;
+    } else {
+        fossil__poller_del(&loop->poller, loop->listener.fd);
+    }
+    loop->accepting = on;
+}
+
+/* Answer with the canned response and close; the handshake is already paid for. */
+static void fossil__loop_refuse(fossil_net_loop_t *loop, int32_t fd) {
+    const fossil_net_shed_config_t *c = &loop->reactor->shed_config;
+#if defined(_WIN32)
+    send((SOCKET)(intptr_t)fd, (const char*)c->canned, (int)c->canned_len, 0);
+#else
+    (void)!send(fd, c->canned, c->canned_len, FOSSIL__REACTOR_SEND_FLAGS);
+#endif
+    /* Count first: the peer may read the stats as soon as it sees EOF. */
+    fossil__count(&loop->shed, 1);
+    fossil__count(&loop->closed, 1);
+    fossil__reactor_closesocket(fd);
+}
+
+/* Accept one batch; true if the queue may hold more. */
+static bool fossil__loop_accept(fossil_net_loop_t *loop) {
+    fossil_net_reactor_t *r = loop->reactor;
+    bool rejecting = r->shed && fossil_net_shed_level(r->shed, loop->polled_ns) >= FOSSIL_NET_SHED_REJECT;
+    for (uint32_t i = 0; i < r->config.accept_batch; i++) {
+        int32_t fd;
+        fossil_net_endpoint_t peer;
+        int rc = fossil__loop_accept_one(loop, &fd, &peer);
+        if (rc == 1) return false;
+        if (rc < 0) {
+            /* Usually EMFILE: the listener would stay readable, so back off. */
+            fossil__count(&loop->accept_errors, 1);
+            fossil__loop_set_accepting(loop, false);
+            loop->accept_resume_ns = fossil_net_socket_clock_ns() + FOSSIL__REACTOR_ACCEPT_PAUSE_NS;
+            return false;
+        }
+        fossil__count(&loop->accepted, 1);
+        if (r->shed && (rejecting || (r->shed_config.max_connections &&
+                                      atomic_load_explicit(&r->live, memory_order_relaxed) >= r->shed_config.max_connections))) {
+            fossil__loop_refuse(loop, fd);
+            continue;
+        }
+        if (r->config.tcp_nodelay) {
+            int one = 1;
+#if defined(_WIN32)
+            setsockopt((SOCKET)(intptr_t)fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+#else
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#endif
+        }
+
+        fossil_net_loop_t *target = loop;
+        if (!r->config.reuseport && r->nloops > 1) {
+            target = fossil__loop_rx_target(r, fd);
+            if (!target) target = r->loops[loop->next_target++ % r->nloops];
+        }
+        if (target == loop) {
+            fossil__loop_adopt(loop, fd, &peer, loop->ready_ns);
+            continue;
+        }
+        fossil__task_t *t = malloc(sizeof(*t));
+        if (!t) {
+            fossil__reactor_closesocket(fd);
+            fossil__count(&loop->accept_errors, 1);
+            fossil__count(&loop->closed, 1);
+            continue;
+        }
+        memset(t, 0, sizeof(*t));
+        t->fd = fd;
+        t->queued_ns = loop->ready_ns;
+        t->peer = peer;
+        fossil__queue_push(&target->tasks, t);
+        if (!atomic_exchange_explicit(&target->wake_pending, true, memory_order_acq_rel))
+            fossil__wake_signal(&target->wake);
+        fossil__count(&loop->handoffs, 1);
+    }
+    return true;
+}
+
+/*=============================================================================
+DATAGRAMS
+=============================================================================*/
+
+static void fossil__dgram_batch_free(fossil__dgram_batch_t *b) {
+    if (!b) return;
+#if defined(__linux__)
+    free(b->in);
+    free(b->out);
+    free(b->iov);
+#endif
+    free(b->slab);
+    free(b->dgrams);
+    free(b->peers);
+    free(b->peer_lens);
+    free(b);
+}
+
+static fossil__dgram_batch_t *fossil__dgram_batch_new(uint32_t cap, uint32_t max) {
+    fossil__dgram_batch_t *b = calloc(1, sizeof(*b));
+    if (!b) return NULL;
+    b->cap = cap;
+    b->max = max;
+    b->slab = malloc((size_t)cap * max * 2);
+    b->dgrams = calloc(cap, sizeof(*b->dgrams));
+    b->peers = calloc(cap, sizeof(*b->peers));
+    b->peer_lens = calloc(cap, sizeof(*b->peer_lens));
+    bool ok = b->slab && b->dgrams && b->peers && b->peer_lens;
+#if defined(__linux__)
+    b->in = calloc(cap, sizeof(*b->in));
+    b->out = calloc(cap, sizeof(*b->out));
+    b->iov = calloc((size_t)cap * 2, sizeof(*b->iov));
+    ok = ok && b->in && b->out && b->iov;
+    for (uint32_t i = 0; ok && i < cap; i++) {
+        b->iov[i].iov_base = b->slab + (size_t)i * max * 2;
+        b->iov[i].iov_len = max;
+        b->in[i].msg_hdr.msg_name = &b->peers[i];
+        b->in[i].msg_hdr.msg_iov = &b->iov[i];
+        b->in[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+    if (!ok) {
+        fossil__dgram_batch_free(b);
+        return NULL;
+    }
+    return b;
+}
+
+/* Limited or tapped sockets go one datagram at a time through the socket layer. */
+#define FOSSIL__DGRAM_SLOW (FOSSIL_NET_SOCKET_FLAG_RATELIMIT | FOSSIL_NET_SOCKET_FLAG_TAP)
+
+static uint32_t fossil__dgram_receive_slow(fossil_net_loop_t *loop) {
+    fossil__dgram_batch_t *b = loop->dgram;
+    uint32_t n = 0;
+    while (n < b->cap) {
+        /* One byte past max into the slot's reply half shows truncation. */
+        uint8_t *slot = b->slab + (size_t)n * b->max * 2;
+        uint32_t got = 0;
+        fossil_net_endpoint_t from;
+        if (fossil_net_socket_receive_from(&loop->listener, slot, b->max + 1, &got, &from) != 0) break;
+        b->dgrams[n].truncated = got > b->max;
+        b->dgrams[n].size = got > b->max ? b->max : got;
+        b->peer_lens[n] = (socklen_t)fossil_net_endpoint_to_sockaddr(&from, &b->peers[n]);
+        n++;
+    }
+    return n;
+}
+
+/* Fill the batch without blocking; returns the number of datagrams. */
+static uint32_t fossil__dgram_receive(fossil_net_loop_t *loop) {
+    fossil__dgram_batch_t *b = loop->dgram;
+    if (loop->listener.flags & FOSSIL__DGRAM_SLOW) return fossil__dgram_receive_slow(loop);
+#if defined(__linux__)
+    for (uint32_t i = 0; i < b->cap; i++)
+        b->in[i].msg_hdr.msg_namelen = sizeof(b->peers[i]);
+    int n;
+    do n = recvmmsg(loop->listener.fd, b->in, b->cap, MSG_DONTWAIT, NULL);
+    while (n < 0 && errno == EINTR);
+    if (n <= 0) return 0;
+    for (int i = 0; i < n; i++) {
+        b->dgrams[i].size = b->in[i].msg_len;
+        b->dgrams[i].truncated = (b->in[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        b->peer_lens[i] = b->in[i].msg_hdr.msg_namelen;
+    }
+    return (uint32_t)n;
+#else
+    uint32_t n = 0;
+    while (n < b->cap) {
+        uint8_t *slot = b->slab + (size_t)n * b->max * 2;
+        socklen_t len = sizeof(b->peers[n]);
+        uint8_t truncated = 0;
+#if defined(_WIN32)
+        int got = recvfrom((SOCKET)(intptr_t)loop->listener.fd, (char*)slot, (int)b->max, 0,
+                           (struct sockaddr*)&b->peers[n], &len);
+        if (got < 0) {
+            if (WSAGetLastError() != WSAEMSGSIZE) break;
+            got = (int)b->max;
+            truncated = 1;
+        }
+#else
+        ssize_t got = recvfrom(loop->listener.fd, slot, b->max, 0, (struct sockaddr*)&b->peers[n], &len);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+#endif
+        b->dgrams[n].size = (uint32_t)got;
+        b->dgrams[n].truncated = truncated;
+        b->peer_lens[n] = len;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/* Send the replies of the first n datagrams; a full socket buffer drops the rest, as UDP would. */
+static void fossil__dgram_send_replies(fossil_net_loop_t *loop, uint32_t n) {
+    fossil__dgram_batch_t *b = loop->dgram;
+    uint32_t sent = 0, dropped = 0;
+    uint64_t bytes = 0;
+    if (loop->listener.flags & FOSSIL__DGRAM_SLOW) {
+        /* A limiter out of tokens refuses the reply: it is dropped like a full buffer. */
+        for (uint32_t i = 0; i < n; i++) {
+            fossil_net_datagram_t *d = &b->dgrams[i];
+            if (!d->reply || !d->reply_size) continue;
+            uint32_t s = 0;
+            if (fossil_net_socket_send_to(&loop->listener, d->reply, d->reply_size, &d->peer, &s) == 0) {
+                sent++;
+                bytes += s;
+            } else {
+                dropped++;
+            }
+        }
+        n = 0; /* nothing left for the batched path below */
+    }
+#if defined(__linux__)
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        fossil_net_datagram_t *d = &b->dgrams[i];
+        if (!d->reply || !d->reply_size) continue;
+        struct iovec *v = &b->iov[b->cap + k];
+        v->iov_base = (void*)d->reply;
+        v->iov_len = d->reply_size;
+        struct msghdr *h = &b->out[k++].msg_hdr;
+        h->msg_name = &b->peers[i];
+        h->msg_namelen = b->peer_lens[i];
+        h->msg_iov = v;
+        h->msg_iovlen = 1;
+    }
+    uint32_t at = 0;
+    while (at < k) {
+        int m = sendmmsg(loop->listener.fd, b->out + at, k - at, MSG_DONTWAIT | FOSSIL__REACTOR_SEND_FLAGS);
+        if (m > 0) {
+            for (int j = 0; j < m; j++)
+                bytes += b->out[at + (uint32_t)j].msg_len;
+            at += (uint32_t)m;
+            sent += (uint32_t)m;
+        } else if (m < 0 && errno == EINTR) {
+            continue;
+        } else if (m < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            dropped += k - at;
+            break;
+        } else {
+            /* The message at the head failed on its own (e.g. EMSGSIZE); skip it. */
+            at++;
+            dropped++;
+        }
+    }
+#else
+    for (uint32_t i = 0; i < n; i++) {
+        fossil_net_datagram_t *d = &b->dgrams[i];
+        if (!d->reply || !d->reply_size) continue;
+#if defined(_WIN32)
+        int rc = sendto((SOCKET)(intptr_t)loop->listener.fd, (const char*)d->reply, (int)d->reply_size, 0,
+                        (const struct sockaddr*)&b->peers[i], b->peer_lens[i]);
+#else
+        ssize_t rc;
+        do rc = sendto(loop->listener.fd, d->reply, d->reply_size, FOSSIL__REACTOR_SEND_FLAGS,
+                       (const struct sockaddr*)&b->peers[i], b->peer_lens[i]);
+        while (rc < 0 && errno == EINTR);
+#endif
+        if (rc >= 0) {
+            sent++;
+            bytes += (uint64_t)rc;
+        } else {
+            dropped++;
+        }
+    }
+#endif
+    if (sent) fossil__count(&loop->replies, sent);
+    if (bytes) fossil__count(&loop->bytes_out, bytes);
+    if (dropped) fossil__count(&loop->reply_drops, dropped);
+}
+
+/* Serve a few batches; true if the socket may hold more. */
+static bool fossil__loop_datagrams(fossil_net_loop_t *loop) {
+    fossil_net_reactor_t *r = loop->reactor;
+    fossil__dgram_batch_t *b = loop->dgram;
+    for (uint32_t round = 0; round < FOSSIL__REACTOR_DGRAM_ROUNDS; round++) {
+        uint32_t n = fossil__dgram_receive(loop);
+        if (!n) return false;
+        uint32_t truncated = 0;
+        uint64_t bytes = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            truncated += b->dgrams[i].truncated;
+            bytes += b->dgrams[i].size;
+        }
+        fossil__count(&loop->recv_calls, 1);
+        fossil__count(&loop->datagrams, n);
+        fossil__count(&loop->bytes_in, bytes);
+        if (truncated) fossil__count(&loop->truncated, truncated);
+
+        if (r->shed && fossil_net_shed_level(r->shed, loop->polled_ns) >= FOSSIL_NET_SHED_REJECT) {
+            fossil__count(&loop->shed, n);
+        } else {
+            for (uint32_t i = 0; i < n; i++) {
+                fossil_net_datagram_t *d = &b->dgrams[i];
+                d->data = b->slab + (size_t)i * b->max * 2;
+                d->reply_buf = d->data + b->max;
+                d->reply_capacity = b->max;
+                d->reply = NULL;
+                d->reply_size = 0;
+                if (fossil_net_endpoint_from_sockaddr(&d->peer, &b->peers[i]) != 0)
+                    memset(&d->peer, 0, sizeof(d->peer));
+                r->cb.on_datagram(loop, d, r->user);
+            }
+            fossil__dgram_send_replies(loop, n);
+        }
+        if (n < b->cap) return false;
+    }
+    return true;
+}
+
+/*=============================================================================
+EVENT LOOP
+=============================================================================*/
+
+static void fossil__loop_run_tasks(fossil_net_loop_t *loop) {
+    uint32_t n = 0;
+    fossil__task_t *t;
+    loop->tasks_left = false;
+    while ((t = fossil__queue_pop(&loop->tasks)) != NULL) {
+        if (t->fd >= 0) fossil__loop_adopt(loop, t->fd, &t->peer, t->queued_ns);
+        else if (t->conn_fn) t->conn_fn(fossil_net_loop_find_conn(loop, t->conn_id), t->arg);
+        else t->fn(loop, t->arg);
+        free(t);
+        if (++n == FOSSIL__REACTOR_TASK_BUDGET) {
+            loop->tasks_left = true;
+            break;
+        }
+    }
+    if (n) fossil__count(&loop->tasks_run, n);
+}
+
+static void fossil__loop_discard(fossil_net_conn_t *conn) {
+    char buf[4096];
+    uint32_t got;
+    int rc;
+    while ((rc = fossil_net_conn_receive(conn, buf, sizeof(buf), &got)) == 0 && got > 0) { }
+    if (rc != 1) fossil__conn_close(conn);
+}
+
+static void fossil__loop_dispatch(fossil_net_loop_t *loop, const fossil__ready_t *ev) {
+    fossil_net_reactor_t *r = loop->reactor;
+    if (ev->ptr == &loop->tag_wake) {
+        /* Drain before re-arming: a signal sent after the clear must survive. */
+        fossil__wake_drain(&loop->wake);
+        atomic_store_explicit(&loop->wake_pending, false, memory_order_seq_cst);
+        fossil__count(&loop->wakeups, 1);
+        return;
+    }
+    if (ev->ptr == &loop->tag_listener) {
+        if (loop->dgram) fossil__loop_datagrams(loop);
+        else fossil__loop_accept(loop);
+        return;
+    }
+    fossil_net_conn_t *conn = ev->ptr;
+    if (conn->closed) return;
+    if (ev->events & (FOSSIL__EV_READ | FOSSIL__EV_HUP)) {
+        if (!conn->read_paused && !conn->linger) {
+            conn->active_ns = loop->polled_ns;
+            if (r->cb.on_readable) r->cb.on_readable(conn, r->user);
+            else fossil__loop_discard(conn);
+        } else if (ev->events & FOSSIL__EV_HUP) {
+            /* Hangups are reported whatever the interest; nobody will read. */
+            fossil__conn_close(conn);
+            return;
+        }
+    }
+    if (conn->closed || !(ev->events & FOSSIL__EV_WRITE)) return;
+    if (conn->wq && fossil_net_writeq_pending(conn->wq)) {
+        if (fossil_net_writeq_flush(conn->wq) < 0) {
+            fossil__conn_close(conn);
+            return;
+        }
+        if (conn->linger && fossil_net_writeq_pending(conn->wq) == 0) {
+            fossil__conn_linger_close(conn);
+            return;
+        }
+        if (conn->closed || fossil__conn_update_interest(conn) != 0) return;
+    }
+    if (conn->want_write && r->cb.on_writable)
+        r->cb.on_writable(conn, r->user);
+}
+
+/* Close up to batch connections idle since cutoff, oldest first. */
+static void fossil__loop_sweep_idle(fossil_net_loop_t *loop, uint64_t cutoff, uint32_t batch) {
+    fossil_net_conn_t *oldest[64];
+    uint32_t n = 0;
+    if (batch > 64) batch = 64;
+    uint32_t count = fossil_net_conntable_count(loop->conns);
+    for (uint32_t i = 0; i < count; i++) {
+        fossil_net_conn_t *c = fossil_net_conntable_at(loop->conns, i, NULL);
+        if (c->closed || c->active_ns > cutoff || fossil_net_writeq_pending(c->wq)) continue;
+        if (n == batch && c->active_ns >= oldest[n - 1]->active_ns) continue;
+        uint32_t j = n < batch ? n++ : n - 1;
+        while (j > 0 && oldest[j - 1]->active_ns > c->active_ns) {
+            oldest[j] = oldest[j - 1];
+            j--;
+        }
+        oldest[j] = c;
+    }
+    if (n) fossil__count(&loop->idle_closed, n);
+    for (uint32_t i = 0; i < n; i++)
+        fossil__conn_close(oldest[i]);
+}
+
+/* Apply the shed level to this loop; returns when to look again, 0 for never. */
+static uint64_t fossil__loop_shed(fossil_net_loop_t *loop, uint64_t now) {
+    fossil_net_reactor_t *r = loop->reactor;
+    int level = fossil_net_shed_level(r->shed, now);
+    if (level == FOSSIL_NET_SHED_NONE) return 0;
+    uint64_t interval = r->shed_config.interval_ns;
+    if (level >= FOSSIL_NET_SHED_PAUSE_ACCEPT && loop->listener.fd >= 0) {
+        fossil__loop_set_accepting(loop, false);
+        if (loop->accept_resume_ns < now + interval) loop->accept_resume_ns = now + interval;
+    }
+    if (level >= FOSSIL_NET_SHED_CLOSE_IDLE && now >= loop->sweep_ns) {
+        fossil__loop_sweep_idle(loop, now - interval, r->shed_config.close_batch);
+        loop->sweep_ns = now + interval;
+    }
+    /* Keep re-reading the level so it can decay while the loop is quiet. */
+    return now + interval;
+}
+
+/* Bind the thread to the loop's CPU, then allocate the loop's buffers again from there. */
+static void fossil__loop_pin(fossil_net_loop_t *loop) {
+    if (loop->cpu < 0) return;
+    bool bound = false;
+#if defined(_WIN32)
+    if (loop->cpu < (int32_t)(sizeof(DWORD_PTR) * 8))
+        bound = SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << loop->cpu) != 0;
+#elif defined(__linux__)
+    if (loop->cpu < CPU_SETSIZE) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(loop->cpu, &set);
+        bound = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+#endif
+    if (!bound) return;
+    atomic_store_explicit(&loop->bound_cpu, loop->cpu, memory_order_relaxed);
+
+    /* Pages are placed on the node of the CPU that first touches them. */
+    fossil_net_reactor_t *r = loop->reactor;
+    void *ready = calloc(r->config.max_events, sizeof(*loop->ready));
+    if (ready) {
+        free(loop->ready);
+        loop->ready = ready;
+    }
+    if (loop->dgram) {
+        fossil__dgram_batch_t *b = fossil__dgram_batch_new(r->config.recv_batch, r->config.max_datagram);
+        if (b) {
+            fossil__dgram_batch_free(loop->dgram);
+            loop->dgram = b;
+        }
+    }
+}
+
+static void fossil__loop_main(fossil_net_loop_t *loop) {
+    fossil_net_reactor_t *r = loop->reactor;
+    fossil__loop_tls = loop;
+    fossil__loop_pin(loop);
+    loop->polled_ns = fossil_net_socket_clock_ns();
+    while (!atomic_load_explicit(&r->stopping, memory_order_acquire)) {
+        int timeout = loop->tasks_left ? 0 : -1;
+        uint64_t now = 0, wake_at = 0;
+        if (r->shed) {
+            now = fossil_net_socket_clock_ns();
+            wake_at = fossil__loop_shed(loop, now);
+        }
+        if (loop->accept_resume_ns) {
+            if (!now) now = fossil_net_socket_clock_ns();
+            if (now >= loop->accept_resume_ns) {
+                loop->accept_resume_ns = 0;
+                fossil__loop_set_accepting(loop, true);
+            } else if (!wake_at || loop->accept_resume_ns < wake_at) {
+                wake_at = loop->accept_resume_ns;
+            }
+        }
+        if (wake_at && timeout != 0)
+            timeout = (int)((wake_at - now) / 1000000ull) + 1;
+        int n = fossil__poller_wait(&loop->poller, loop->ready, timeout);
+        if (r->shed) {
+            /*
+             * The kernel does not timestamp accept-queue entries. A poll that
+             * slept reports arrivals from its wait; one that returned at once
+             * reports work that piled up since the previous poll returned.
+             */
+            uint64_t polled = fossil_net_socket_clock_ns();
+            loop->ready_ns = polled - now >= 1000000ull ? polled : loop->polled_ns;
+            loop->polled_ns = polled;
+        }
+        for (int i = 0; i < n; i++)
+            fossil__loop_dispatch(loop, &loop->ready[i]);
+        fossil__loop_run_tasks(loop);
+        fossil__loop_reap(loop);
+    }
+    do fossil__loop_run_tasks(loop); while (loop->tasks_left);
+    for (uint32_t i = fossil_net_conntable_count(loop->conns); i-- > 0;)
+        fossil__conn_close(fossil_net_conntable_at(loop->conns, i, NULL));
+    fossil__loop_reap(loop);
+    atomic_store_explicit(&loop->bound_cpu, -1, memory_order_relaxed);
+    fossil__loop_tls = NULL;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI fossil__loop_thread(LPVOID arg) {
+    fossil__loop_main((fossil_net_loop_t*)arg);
+    return 0;
+}
+#else
+static void *fossil__loop_thread(void *arg) {
+    fossil__loop_main((fossil_net_loop_t*)arg);
+    return NULL;
+}
+#endif
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+static void fossil__loop_free(fossil_net_loop_t *loop) {
+    if (!loop) return;
+    fossil__task_t *t;
+    while ((t = fossil__queue_pop(&loop->tasks)) != NULL) {
+        if (t->fd >= 0) fossil__reactor_closesocket(t->fd);
+        free(t);
+    }
+    if (loop->owns_listener && loop->listener.fd >= 0)
+        fossil_net_socket_close(&loop->listener);
+    if (loop->ready) {
+        fossil__poller_close(&loop->poller);
+        fossil__wake_close(&loop->wake);
+    }
+    fossil_net_conntable_destroy(loop->conns);
+    fossil__dgram_batch_free(loop->dgram);
+    free(loop->ready);
+    free(loop);
+}
+
+static fossil_net_loop_t *fossil__loop_new(fossil_net_reactor_t *r, uint32_t index) {
+    fossil_net_loop_t *loop = calloc(1, sizeof(*loop));
+    if (!loop) return NULL;
+    loop->reactor = r;
+    loop->index = index;
+    loop->listener.fd = -1;
+    loop->cpu = -1;
+    atomic_init(&loop->bound_cpu, -1);
+    fossil__queue_init(&loop->tasks);
+    atomic_init(&loop->wake_pending, false);
+    if (fossil__poller_open(&loop->poller, r->config.max_events) != 0) {
+        free(loop);
+        return NULL;
+    }
+    if (fossil__wake_open(&loop->wake) != 0) {
+        fossil__poller_close(&loop->poller);
+        free(loop);
+        return NULL;
+    }
+    loop->ready = calloc(r->config.max_events, sizeof(*loop->ready));
+    if (loop->ready)
+        loop->conns = fossil_net_conntable_create(sizeof(fossil_net_conn_t), FOSSIL__REACTOR_MAX_CONNS);
+    if (loop->ready && r->datagram)
+        loop->dgram = fossil__dgram_batch_new(r->config.recv_batch, r->config.max_datagram);
+    if (!loop->ready || !loop->conns || (r->datagram && !loop->dgram) ||
+        fossil__poller_add(&loop->poller, loop->wake.rfd, FOSSIL__EV_READ, &loop->tag_wake) != 0) {
+        if (!loop->ready) {
+            fossil__poller_close(&loop->poller);
+            fossil__wake_close(&loop->wake);
+            free(loop);
+            return NULL;
+        }
+        fossil__loop_free(loop);
+        return NULL;
+    }
+    return loop;
+}
+
+/*
+ * Give a loop its listener: the server socket, or a new SO_REUSEPORT twin.
+ * In datagram mode the "listener" is the loop's bound UDP socket.
+ */
+static int fossil__loop_listen(fossil_net_loop_t *loop, fossil_net_socket_t *server_sock,
+                               const fossil_net_endpoint_t *local) {
+    fossil_net_reactor_t *r = loop->reactor;
+    if (loop->index == 0) {
+        if (r->config.reuseport && fossil_net_socket_set_reuseport(server_sock, true) != 0) return -1;
+        if (fossil_net_socket_set_blocking(server_sock, false) != 0 ||
+            (!r->datagram && fossil_net_socket_listen(server_sock, r->config.backlog) != 0)) return -1;
+        loop->listener = *server_sock;
+    } else {
+        fossil_net_socket_t *s = &loop->listener;
+        if (fossil_net_socket_create(s, r->datagram ? "udp" : "tcp", fossil_net_socket_family_id(server_sock)) != 0) {
+            s->fd = -1;
+            return -1;
+        }
+        loop->owns_listener = true;
+        if (fossil_net_socket_set_reuseaddr(s, true) != 0 ||
+            fossil_net_socket_set_reuseport(s, true) != 0 ||
+            fossil_net_socket_bind_endpoint(s, local) != 0 ||
+            fossil_net_socket_set_blocking(s, false) != 0 ||
+            (!r->datagram && fossil_net_socket_listen(s, r->config.backlog) != 0)) return -1;
+        /* The server socket's limiter and tap cover the whole port. */
+        if (r->datagram) {
+            fossil_net_ratelimit_t *lim = fossil_net_socket_get_ratelimit(server_sock);
+            fossil_net_tap_t *tap = fossil_net_socket_get_tap(server_sock);
+            if ((lim && fossil_net_socket_set_ratelimit(s, lim) != 0) ||
+                (tap && fossil_net_socket_set_tap(s, tap) != 0)) return -1;
+        }
+    }
+    fossil__loop_set_accepting(loop, true);
+    return loop->accepting ? 0 : -1;
+}
+
+/*
+ * True if the socket already had SO_REUSEPORT, as an inherited listener of
+ * a reuseport predecessor does: its group may hold sockets we do not own.
+ */
+static bool fossil__reactor_reuseport_set(const fossil_net_socket_t *sock) {
+#if defined(SO_REUSEPORT) && !defined(_WIN32)
+    int on = 0;
+    socklen_t len = sizeof(on);
+    return getsockopt(sock->fd, SOL_SOCKET, SO_REUSEPORT, &on, &len) == 0 && on;
+#else
+    (void)sock;
+    return false;
+#endif
+}
+
+/* Give each loop its CPU and steer the SO_REUSEPORT group to the loops by CPU. */
+static int fossil__reactor_place(fossil_net_reactor_t *r) {
+    int32_t *cpus = calloc(r->nloops, sizeof(*cpus));
+    if (!cpus) return -1;
+    const int32_t *list = r->config.cpus;
+    uint32_t n = r->config.cpu_count;
+    if (!list || !n) {
+        n = fossil__reactor_allowed_cpus(cpus, r->nloops);
+        list = cpus;
+    }
+    r->config.cpus = NULL; /* the caller's array need not outlive create */
+    int rc = n ? 0 : -1;
+    for (uint32_t i = 0; i < r->nloops && rc == 0; i++) {
+        r->loops[i]->cpu = list[i % n];
+        if (r->loops[i]->cpu < 0) rc = -1;
+    }
+    /*
+     * The program answers with a position in the group, and position i is
+     * loop i only in a group this reactor created: an inherited one starts
+     * with the predecessor's sockets.
+     */
+    if (rc == 0 && r->config.reuseport && r->nloops > 1 && !r->joined_group) {
+        for (uint32_t i = 0; i < r->nloops; i++)
+            cpus[i] = r->loops[i]->cpu;
+        /* Best effort: without it (before Linux 4.5) the kernel hashes flows over the group. */
+        fossil_net_filter_t *f = fossil_net_filter_reuseport_cpu(cpus, r->nloops);
+        if (f) fossil_net_filter_attach_reuseport(&r->loops[0]->listener, f);
+        fossil_net_filter_destroy(f);
+    }
+    free(cpus);
+    return rc;
+}
+
+fossil_net_reactor_t *fossil_net_reactor_create(
+    fossil_net_server_t *server,
+    const fossil_net_reactor_config_t *config,
+    const fossil_net_reactor_callbacks_t *callbacks,
+    void *user)
+{
+    fossil_net_socket_t *sock = fossil_net_server_socket(server);
+    if (!sock || !callbacks) return NULL;
+    bool datagram = sock->type == FOSSIL_NET_SOCKET_TYPE_UDP;
+    if (datagram ? !callbacks->on_datagram : sock->type != FOSSIL_NET_SOCKET_TYPE_TCP) return NULL;
+
+    fossil_net_reactor_t *r = calloc(1, sizeof(*r));
+    if (!r) return NULL;
+    if (config) r->config = *config;
+    if (!r->config.threads) r->config.threads = fossil__reactor_cpus();
+    if (r->config.threads > FOSSIL_NET_REACTOR_MAX_LOOPS) r->config.threads = FOSSIL_NET_REACTOR_MAX_LOOPS;
+    if (!r->config.max_events) r->config.max_events = 256;
+    if (!r->config.accept_batch) r->config.accept_batch = 64;
+    if (r->config.backlog <= 0) r->config.backlog = 1024;
+    if (!r->config.recv_batch) r->config.recv_batch = 32;
+    if (r->config.recv_batch > 1024) r->config.recv_batch = 1024; /* recvmmsg vector limit */
+    if (!r->config.max_datagram) r->config.max_datagram = 2048;
+    if (r->config.max_datagram > 65536) r->config.max_datagram = 65536;
+    if (datagram) r->config.reuseport = 1; /* nothing to hand off: each loop reads its own socket */
+    r->datagram = datagram;
+    r->joined_group = fossil__reactor_reuseport_set(sock);
+    r->server = server;
+    r->cb = *callbacks;
+    r->user = user;
+    r->nloops = r->config.threads;
+    atomic_init(&r->stopping, false);
+    atomic_init(&r->draining, false);
+    atomic_init(&r->live, 0);
+
+    fossil_net_endpoint_t local;
+    r->loops = calloc(r->nloops, sizeof(*r->loops));
+    if (!r->loops || fossil_net_socket_get_local_endpoint(sock, &local) != 0) {
+        fossil_net_reactor_destroy(r);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < r->nloops; i++) {
+        r->loops[i] = fossil__loop_new(r, i);
+        if (!r->loops[i] ||
+            ((i == 0 || r->config.reuseport) && fossil__loop_listen(r->loops[i], sock, &local) != 0)) {
+            fossil_net_reactor_destroy(r);
+            return NULL;
+        }
+    }
+    if (r->config.pin_cpus && fossil__reactor_place(r) != 0) {
+        fossil_net_reactor_destroy(r);
+        return NULL;
+    }
+    return r;
+}
+
+void fossil_net_reactor_destroy(fossil_net_reactor_t *reactor) {
+    if (!reactor) return;
+    fossil_net_reactor_stop(reactor);
+    if (reactor->loops) {
+        for (uint32_t i = 0; i < reactor->nloops; i++)
+            fossil__loop_free(reactor->loops[i]);
+    }
+    free(reactor->loops);
+    free(reactor);
+}
+
+static void fossil__reactor_join(fossil_net_loop_t *loop) {
+    if (!loop->started) return;
+#if defined(_WIN32)
+    WaitForSingleObject(loop->thread, INFINITE);
+    CloseHandle(loop->thread);
+#else
+    pthread_join(loop->thread, NULL);
+#endif
+    loop->started = false;
+}
+
+int fossil_net_reactor_start(fossil_net_reactor_t *reactor) {
+    if (!reactor) return -1;
+    if (reactor->running) return 0;
+    atomic_store_explicit(&reactor->stopping, false, memory_order_release);
+    for (uint32_t i = 0; i < reactor->nloops; i++) {
+        fossil_net_loop_t *loop = reactor->loops[i];
+#if defined(_WIN32)
+        loop->thread = CreateThread(NULL, 0, fossil__loop_thread, loop, 0, NULL);
+        loop->started = loop->thread != NULL;
+#else
+        loop->started = pthread_create(&loop->thread, NULL, fossil__loop_thread, loop) == 0;
+#endif
+        if (!loop->started) {
+            reactor->running = true;
+            fossil_net_reactor_stop(reactor);
+            return -1;
+        }
+    }
+    reactor->running = true;
+    return 0;
+}
+
+int fossil_net_reactor_stop(fossil_net_reactor_t *reactor) {
+    if (!reactor) return -1;
+    if (!reactor->running) return 0;
+    if (fossil__loop_tls && fossil__loop_tls->reactor == reactor) return -1;
+    atomic_store_explicit(&reactor->stopping, true, memory_order_release);
+    for (uint32_t i = 0; i < reactor->nloops; i++)
+        if (reactor->loops[i]->started) fossil__wake_signal(&reactor->loops[i]->wake);
+    for (uint32_t i = 0; i < reactor->nloops; i++)
+        fossil__reactor_join(reactor->loops[i]);
+    reactor->running = false;
+    return 0;
+}
+
+uint32_t fossil_net_reactor_loop_count(const fossil_net_reactor_t *reactor) {
+    return reactor ? reactor->nloops : 0;
+}
+
+fossil_net_loop_t *fossil_net_reactor_loop(fossil_net_reactor_t *reactor, uint32_t index) {
+    if (!reactor || index >= reactor->nloops) return NULL;
+    return reactor->loops[index];
+}
+
+int fossil_net_reactor_set_shed(fossil_net_reactor_t *reactor, fossil_net_shed_t *shed) {
+    if (!reactor || reactor->running) return -1;
+    if (shed && fossil_net_shed_get_config(shed, &reactor->shed_config) != 0) return -1;
+    reactor->shed = shed;
+    return 0;
+}
+
+static void fossil__loop_drain(fossil_net_loop_t *loop, void *arg) {
+    (void)arg;
+    fossil_net_reactor_t *r = loop->reactor;
+    fossil__loop_set_accepting(loop, false);
+    /*
+     * A reuseport twin cannot be handed to a successor. Serve what is queued
+     * on it, then close it so the kernel sends new peers to the rest of the
+     * group. Accepted here, the connections get drain_fn below like the rest.
+     * The twin stays in the group until the close, so under load its queue
+     * never empties: take at most about one backlog's worth.
+     */
+    if (loop->owns_listener && loop->listener.fd >= 0) {
+        uint32_t batch = loop->dgram ? r->config.recv_batch * FOSSIL__REACTOR_DGRAM_ROUNDS : r->config.accept_batch;
+        uint32_t rounds = (uint32_t)r->config.backlog / batch + 1;
+        while (rounds-- && (loop->dgram ? fossil__loop_datagrams(loop) : fossil__loop_accept(loop))) { }
+        fossil_net_socket_close(&loop->listener);
+    }
+    loop->draining = true;
+    loop->accept_resume_ns = 0;
+    if (r->drain_fn) fossil_net_loop_foreach_conn(loop, r->drain_fn, r->drain_arg);
+}
+
+int fossil_net_reactor_drain(fossil_net_reactor_t *reactor, fossil_net_conn_task_fn fn, void *arg) {
+    if (!reactor) return -1;
+    if (atomic_exchange_explicit(&reactor->draining, true, memory_order_acq_rel)) return 0;
+    reactor->drain_fn = fn;
+    reactor->drain_arg = arg;
+    int rc = 0;
+    for (uint32_t i = 0; i < reactor->nloops; i++)
+        if (fossil_net_loop_post(reactor->loops[i], fossil__loop_drain, NULL) != 0) rc = -1;
+    return rc;
+}
+
+int fossil_net_reactor_wait_drained(fossil_net_reactor_t *reactor, uint64_t timeout_ns) {
+    if (!reactor || !atomic_load_explicit(&reactor->draining, memory_order_acquire)) return -1;
+    uint64_t deadline = fossil_net_socket_clock_ns() + timeout_ns;
+    for (;;) {
+        if (atomic_load_explicit(&reactor->live, memory_order_relaxed) == 0) return 0;
+        if (fossil_net_socket_clock_ns() >= deadline) return 1;
+#if defined(_WIN32)
+        Sleep(1);
+#else
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+#endif
+    }
+}
+
+int fossil_net_reactor_get_stats(fossil_net_reactor_t *reactor, fossil_net_reactor_stats_t *stats) {
+    if (!reactor || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    for (uint32_t i = 0; i < reactor->nloops; i++) {
+        fossil_net_loop_t *l = reactor->loops[i];
+        stats->accepted += atomic_load_explicit(&l->accepted, memory_order_relaxed);
+        stats->rejected += atomic_load_explicit(&l->rejected, memory_order_relaxed);
+        stats->closed += atomic_load_explicit(&l->closed, memory_order_relaxed);
+        stats->handoffs += atomic_load_explicit(&l->handoffs, memory_order_relaxed);
+        stats->accept_errors += atomic_load_explicit(&l->accept_errors, memory_order_relaxed);
+        stats->tasks += atomic_load_explicit(&l->tasks_run, memory_order_relaxed);
+        stats->wakeups += atomic_load_explicit(&l->wakeups, memory_order_relaxed);
+        stats->shed += atomic_load_explicit(&l->shed, memory_order_relaxed);
+        stats->idle_closed += atomic_load_explicit(&l->idle_closed, memory_order_relaxed);
+        stats->datagrams += atomic_load_explicit(&l->datagrams, memory_order_relaxed);
+        stats->recv_calls += atomic_load_explicit(&l->recv_calls, memory_order_relaxed);
+        stats->replies += atomic_load_explicit(&l->replies, memory_order_relaxed);
+        stats->reply_drops += atomic_load_explicit(&l->reply_drops, memory_order_relaxed);
+        stats->truncated += atomic_load_explicit(&l->truncated, memory_order_relaxed);
+        stats->bytes_in += atomic_load_explicit(&l->bytes_in, memory_order_relaxed);
+        stats->bytes_out += atomic_load_explicit(&l->bytes_out, memory_order_relaxed);
+    }
+    stats->active = stats->accepted > stats->closed ? stats->accepted - stats->closed : 0;
+    return 0;
+}
+
+/*=============================================================================
+LOOPS
+=============================================================================*/
+
+static void fossil__loop_push(fossil_net_loop_t *loop, fossil__task_t *t) {
+    fossil__queue_push(&loop->tasks, t);
+    /* The loop drains its queue after every round, so self-posts need no wakeup. */
+    if (fossil__loop_tls != loop &&
+        !atomic_exchange_explicit(&loop->wake_pending, true, memory_order_seq_cst))
+        fossil__wake_signal(&loop->wake);
+}
+
+int fossil_net_loop_post(fossil_net_loop_t *loop, fossil_net_loop_task_fn fn, void *arg) {
+    if (!loop || !fn || atomic_load_explicit(&loop->reactor->stopping, memory_order_acquire)) return -1;
+    fossil__task_t *t = calloc(1, sizeof(*t));
+    if (!t) return -1;
+    t->fn = fn;
+    t->arg = arg;
+    t->fd = -1;
+    fossil__loop_push(loop, t);
+    return 0;
+}
+
+fossil_net_conn_t *fossil_net_loop_find_conn(fossil_net_loop_t *loop, fossil_net_conn_id_t id) {
+    if (!loop || FOSSIL__CONN_ID_LOOP(id) != loop->index) return NULL;
+    fossil_net_conn_t *conn = fossil_net_conntable_get(loop->conns, FOSSIL__CONN_ID_HANDLE(id));
+    return (conn && !conn->closed) ? conn : NULL;
+}
+
+uint32_t fossil_net_loop_conn_count(const fossil_net_loop_t *loop) {
+    if (!loop) return 0;
+    uint32_t n = 0;
+    for (const fossil_net_conn_t *c = loop->graveyard; c; c = c->next_closed) n++;
+    return fossil_net_conntable_count(loop->conns) - n;
+}
+
+int fossil_net_loop_foreach_conn(fossil_net_loop_t *loop, fossil_net_conn_task_fn fn, void *arg) {
+    if (!loop || !fn) return -1;
+    /* Closing only queues the slot for release, so positions stay put. */
+    uint32_t n = fossil_net_conntable_count(loop->conns);
+    for (uint32_t i = 0; i < n; i++) {
+        fossil_net_conn_t *conn = fossil_net_conntable_at(loop->conns, i, NULL);
+        if (!conn->closed) fn(conn, arg);
+    }
+    return 0;
+}
+
+int fossil_net_reactor_post_conn(fossil_net_reactor_t *reactor, fossil_net_conn_id_t id,
+                                 fossil_net_conn_task_fn fn, void *arg) {
+    if (!reactor || !fn || FOSSIL__CONN_ID_LOOP(id) >= reactor->nloops) return -1;
+    fossil_net_loop_t *loop = reactor->loops[FOSSIL__CONN_ID_LOOP(id)];
+    if (atomic_load_explicit(&reactor->stopping, memory_order_acquire)) return -1;
+    fossil__task_t *t = calloc(1, sizeof(*t));
+    if (!t) return -1;
+    t->conn_fn = fn;
+    t->conn_id = id;
+    t->arg = arg;
+    t->fd = -1;
+    fossil__loop_push(loop, t);
+    return 0;
+}
+
+fossil_net_loop_t *fossil_net_loop_current(void) {
+    return fossil__loop_tls;
+}
+
+uint32_t fossil_net_loop_index(const fossil_net_loop_t *loop) {
+    return loop ? loop->index : 0;
+}
+
+int32_t fossil_net_loop_cpu(const fossil_net_loop_t *loop) {
+    return loop ? atomic_load_explicit(&loop->bound_cpu, memory_order_relaxed) : -1;
+}
+
+fossil_net_reactor_t *fossil_net_loop_reactor(fossil_net_loop_t *loop) {
+    return loop ? loop->reactor : NULL;
+}
+
+/*=============================================================================
+CONNECTIONS
+=============================================================================*/
+
+int fossil_net_conn_receive(fossil_net_conn_t *conn, void *buffer, uint32_t size, uint32_t *received) {
+    if (received) *received = 0;
+    if (!conn || !buffer || conn->closed) return -1;
+#if defined(_WIN32)
+    int r = recv((SOCKET)(intptr_t)conn->sock.fd, (char*)buffer, (int)size, 0);
+#else
+    ssize_t r = recv(conn->sock.fd, buffer, size, 0);
+#endif
+    if (r < 0) return fossil__reactor_would_block() ? 1 : -1;
+    if (received) *received = (uint32_t)r;
+    fossil__count(&conn->loop->bytes_in, (uint64_t)r);
+    return 0;
+}
+
+int fossil_net_conn_send(fossil_net_conn_t *conn, const void *data, uint32_t size, uint32_t *sent) {
+    if (sent) *sent = 0;
+    if (!conn || (!data && size) || conn->closed) return -1;
+#if defined(_WIN32)
+    int s = send((SOCKET)(intptr_t)conn->sock.fd, (const char*)data, (int)size, 0);
+#else
+    ssize_t s = send(conn->sock.fd, data, size, FOSSIL__REACTOR_SEND_FLAGS);
+#endif
+    if (s < 0) return fossil__reactor_would_block() ? 1 : -1;
+    if (sent) *sent = (uint32_t)s;
+    fossil__count(&conn->loop->bytes_out, (uint64_t)s);
+    return 0;
+}
+
+int fossil_net_conn_want_read(fossil_net_conn_t *conn, bool enabled) {
+    if (!conn || conn->closed) return -1;
+    conn->read_paused = !enabled;
+    return fossil__conn_update_interest(conn);
+}
+
+int fossil_net_conn_want_write(fossil_net_conn_t *conn, bool enabled) {
+    if (!conn || conn->closed) return -1;
+    conn->want_write = enabled;
+    return fossil__conn_update_interest(conn);
+}
+
+static void fossil__conn_watermark(fossil_net_writeq_t *queue, bool above, void *arg) {
+    (void)queue;
+    fossil_net_conn_t *conn = arg;
+    fossil_net_reactor_t *r = conn->loop->reactor;
+    if (r->cb.on_watermark) r->cb.on_watermark(conn, above, r->user);
+}
+
+static fossil_net_writeq_t *fossil__conn_writeq(fossil_net_conn_t *conn) {
+    if (!conn->wq) {
+        const fossil_net_reactor_config_t *c = &conn->loop->reactor->config;
+        fossil_net_writeq_config_t wc = {0};
+        wc.high_watermark = c->write_high_watermark;
+        wc.low_watermark = c->write_low_watermark;
+        wc.limit = c->write_limit;
+        conn->wq = fossil_net_writeq_create(&conn->sock, &wc, fossil__conn_watermark, conn);
+    }
+    return conn->wq;
+}
+
+int fossil_net_conn_write(fossil_net_conn_t *conn, const void *data, uint32_t size) {
+    if (!conn || conn->closed || !fossil__conn_writeq(conn)) return -1;
+    if (fossil_net_writeq_write(conn->wq, data, size) != 0 || conn->closed) return -1;
+    fossil__count(&conn->loop->bytes_out, size);
+    return fossil__conn_update_interest(conn);
+}
+
+int fossil_net_conn_write_buf(fossil_net_conn_t *conn, fossil_net_buf_t *buf, uint32_t offset, uint32_t size) {
+    if (!conn || conn->closed || !fossil__conn_writeq(conn)) return -1;
+    if (fossil_net_writeq_append(conn->wq, buf, offset, size) != 0 || conn->closed) return -1;
+    fossil__count(&conn->loop->bytes_out, size);
+    return fossil__conn_update_interest(conn);
+}
+
+int fossil_net_conn_write_file(fossil_net_conn_t *conn, fossil_net_buf_t *owner, int32_t fd, uint64_t offset, uint64_t size) {
+    if (!conn || conn->closed || !fossil__conn_writeq(conn)) return -1;
+    if (fossil_net_writeq_append_file(conn->wq, owner, fd, offset, size) != 0 || conn->closed) return -1;
+    fossil__count(&conn->loop->bytes_out, size);
+    return fossil__conn_update_interest(conn);
+}
+
+uint64_t fossil_net_conn_pending(const fossil_net_conn_t *conn) {
+    return conn ? fossil_net_writeq_pending(conn->wq) : 0;
+}
+
+void fossil_net_conn_close(fossil_net_conn_t *conn) {
+    if (conn) fossil__conn_close(conn);
+}
+
+void fossil_net_conn_close_flushed(fossil_net_conn_t *conn) {
+    if (!conn || conn->closed) return;
+    conn->linger = 1;
+    if (fossil_net_writeq_pending(conn->wq) == 0) fossil__conn_linger_close(conn);
+    else if (fossil__conn_update_interest(conn) != 0) fossil__conn_close(conn);
+}
+
+fossil_net_conn_id_t fossil_net_conn_id(const fossil_net_conn_t *conn) {
+    return conn ? conn->id : 0;
+}
+
+fossil_net_socket_t *fossil_net_conn_socket(fossil_net_conn_t *conn) {
+    return conn ? &conn->sock : NULL;
+}
+
+const fossil_net_endpoint_t *fossil_net_conn_peer(const fossil_net_conn_t *conn) {
+    return conn ? &conn->peer : NULL;
+}
+
+fossil_net_loop_t *fossil_net_conn_loop(fossil_net_conn_t *conn) {
+    return conn ? conn->loop : NULL;
+}
+
+void fossil_net_conn_set_user(fossil_net_conn_t *conn, void *data) {
+    if (conn) conn->user = data;
+}
+
+void *fossil_net_conn_get_user(const fossil_net_conn_t *conn) {
+    return conn ? conn->user : NULL;
+}
@@ -23,7 +23,9 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/network/request.h"
+#include "fossil/network/parser.h"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,6 +39,16 @@ static int fossil__str_eq(const char *a, const char *b)
     return a && b && strcmp(a, b) == 0;
 }
 
+static int fossil__str_ieq(const char *a, const char *b)
+{
+    if (!a || !b) return 0;
+    while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
 static void fossil__safe_copy(char *dst, const char *src, size_t size)
 {
     if (!dst || size == 0) return;
@@ -278,23 +290,25 @@ static int fossil__http_build_request(
         }
     }
 
-    /* Request line */
+    /* Request line; methods are case-sensitive on the wire */
+    char method[sizeof(req->method)];
+    for (size_t i = 0; i < sizeof(method); i++)
+        method[i] = (char)toupper((unsigned char)req->method[i]);
+    method[sizeof(method) - 1] = '\0';
+
     int n = snprintf(buffer + offset, size - offset,
-        "%s %s HTTP/1.1\r\n", req->method, path);
+        "%s %s HTTP/1.1\r\n", method, path);
     if (n < 0 || (uint32_t)n >= size - offset)
         return -1;
     offset += (uint32_t)n;
 
     /* Detect required headers */
     int has_host = 0;
-    int has_connection = 0;
 
     for (uint32_t i = 0; i < req->header_count; i++)
     {
         if (strcmp(req->headers[i].key, "Host") == 0)
             has_host = 1;
-        if (strcmp(req->headers[i].key, "Connection") == 0)
-            has_connection = 1;
     }
 
     /* Add Host */
@@ -326,15 +340,11 @@ static int fossil__http_build_request(
         offset += (uint32_t)n;
     }
 
-    /* Add Connection */
-    if (!has_connection)
-    {
-        n = snprintf(buffer + offset, size - offset,
-            "Connection: close\r\n");
-        if (n < 0 || (uint32_t)n >= size - offset)
-            return -1;
-        offset += (uint32_t)n;
-    }
+    /*
+     * No Connection header unless the caller sets one: HTTP/1.1 connections
+     * are persistent by default, and the response is read by its framing so
+     * the socket can carry the next request.
+     */
 
     /* User headers */
     for (uint32_t i = 0; i < req->header_count; i++)
@@ -430,12 +440,22 @@ static int fossil__http_parse_response(
         headers += 2;
     }
 
-    /* Body */
-    const char *body = strstr(headers, "\r\n\r\n");
-    if (!body) return 0;
-    body += 4;
+    /* Body: headers now points at the blank line ending the head */
+    if (!headers || headers[0] != '\r' || headers[1] != '\n') return 0;
+    const char *body = headers + 2;
 
     uint32_t body_size = size - (uint32_t)(body - buffer);
+    for (uint32_t i = 0; i < res->header_count; i++)
+    {
+        /* Do not swallow bytes past the declared length */
+        if (fossil__str_ieq(res->headers[i].key, "Content-Length"))
+        {
+            unsigned long declared = strtoul(res->headers[i].value, NULL, 10);
+            if (declared < body_size)
+                body_size = (uint32_t)declared;
+        }
+    }
+    if (body_size == 0) return 0;
 
     res->body = malloc(body_size);
     if (!res->body) return -1;
@@ -450,6 +470,75 @@ static int fossil__http_parse_response(
 EXECUTION
 =============================================================================*/
 
+enum
+{
+    FOSSIL__FRAME_PENDING,  /* head not complete yet */
+    FOSSIL__FRAME_NONE,     /* no body: HEAD, 204, 304 */
+    FOSSIL__FRAME_LENGTH,   /* Content-Length */
+    FOSSIL__FRAME_CHUNKED,  /* Transfer-Encoding: chunked */
+    FOSSIL__FRAME_CLOSE     /* ends when the server closes */
+};
+
+/* Value of a header in a response head ending at end, or NULL. key is lower case with its colon. */
+static const char *fossil__http_head_value(const char *buffer, const char *end, const char *key)
+{
+    for (const char *line = strstr(buffer, "\r\n"); line && line < end; line = strstr(line + 2, "\r\n"))
+    {
+        uint32_t k = 0;
+        while (key[k] && tolower((unsigned char)line[2 + k]) == key[k])
+            k++;
+        if (!key[k])
+            return line + 2 + k;
+    }
+    return NULL;
+}
+
+/* How the response in buffer is framed; sets *head and, for FRAME_LENGTH, *length. */
+static int fossil__http_response_framing(
+    const fossil_net_request_t *req,
+    const char *buffer,
+    uint32_t *head,
+    unsigned long *length)
+{
+    const char *end = strstr(buffer, "\r\n\r\n");
+    if (!end)
+        return FOSSIL__FRAME_PENDING;
+    *head = (uint32_t)(end - buffer) + 4;
+
+    int status = 0;
+    sscanf(buffer, "HTTP/%*s %d", &status);
+    if (fossil__str_eq(req->method, "head") || status == 204 || status == 304)
+        return FOSSIL__FRAME_NONE;
+
+    /* Transfer-Encoding wins over Content-Length; only a final "chunked" frames the body */
+    const char *te = fossil__http_head_value(buffer, end, "transfer-encoding:");
+    if (te)
+    {
+        const char *stop = strstr(te, "\r\n");
+        while (stop > te && (stop[-1] == ' ' || stop[-1] == '\t'))
+            stop--;
+        if (stop - te >= 7)
+        {
+            static const char chunked[] = "chunked";
+            const char *tail = stop - 7;
+            uint32_t k = 0;
+            while (k < 7 && tolower((unsigned char)tail[k]) == chunked[k])
+                k++;
+            if (k == 7)
+                return FOSSIL__FRAME_CHUNKED;
+        }
+        return FOSSIL__FRAME_CLOSE;
+    }
+
+    const char *cl = fossil__http_head_value(buffer, end, "content-length:");
+    if (cl)
+    {
+        *length = strtoul(cl, NULL, 10);
+        return FOSSIL__FRAME_LENGTH;
+    }
+    return FOSSIL__FRAME_CLOSE;
+}
+
 int fossil_net_request_send(
     fossil_net_socket_t *sock,
     const fossil_net_request_t *req,
@@ -470,8 +559,47 @@ int fossil_net_request_send(
 
     char recv_buf[16384];
     uint32_t received = 0;
-
-    if (fossil_net_socket_receive(sock, recv_buf, sizeof(recv_buf), &received) != 0)
+    uint32_t head = 0;
+    unsigned long length = 0;
+    int framing = FOSSIL__FRAME_PENDING;
+    int chunks_done = 0;
+    fossil_net_parser_t chunks;
+    fossil_net_parser_init(&chunks, 0);
+
+    /* Read until the response is complete, the peer closes, or the buffer fills. */
+    for (;;)
+    {
+        uint32_t got = 0;
+        if (fossil_net_socket_receive(sock, recv_buf + received,
+                (uint32_t)sizeof(recv_buf) - 1 - received, &got) != 0)
+            return -1;
+        uint32_t fresh = received;
+        received += got;
+        recv_buf[received] = '\0';
+        if (framing == FOSSIL__FRAME_PENDING)
+        {
+            framing = fossil__http_response_framing(req, recv_buf, &head, &length);
+            if (framing == FOSSIL__FRAME_CHUNKED)
+                fresh = head;
+        }
+        if (framing == FOSSIL__FRAME_CHUNKED && received > fresh)
+        {
+            /* Decode as it arrives so the buffer only ever holds the decoded body */
+            uint32_t n = received - fresh;
+            int rc = fossil_net_parser_decode_chunked(&chunks, recv_buf + fresh, &n);
+            if (rc == -1)
+                return -1;
+            received = fresh + n;
+            recv_buf[received] = '\0';
+            chunks_done = rc >= 0;
+        }
+        if (got == 0 || received == sizeof(recv_buf) - 1 || chunks_done ||
+            framing == FOSSIL__FRAME_NONE ||
+            (framing == FOSSIL__FRAME_LENGTH && received - head >= length))
+            break;
+    }
+    /* A chunked body cut short by the peer closing is an error, not a response */
+    if (received == 0 || (framing == FOSSIL__FRAME_CHUNKED && !chunks_done && received < sizeof(recv_buf) - 1))
         return -1;
 
     return fossil__http_parse_response(res, recv_buf, received);
@@ -0,0 +1,396 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/router.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+typedef struct fossil__route_node fossil__route_node_t;
+
+/*
+ * A static node owns a compressed run of literal text. Its static
+ * children are keyed by their first byte in `indices`, so picking the
+ * branch is one memchr. A parameter node consumes one path segment and
+ * a wildcard node the rest of the path; both have an empty prefix.
+ */
+struct fossil__route_node
+{
+    char *prefix;
+    uint32_t prefix_len;
+    char *name;                         /* parameter name, param/wildcard only */
+    uint32_t name_len;
+    char *indices;
+    fossil__route_node_t **children;
+    uint32_t child_count;
+    fossil__route_node_t *param;
+    fossil__route_node_t *wildcard;
+    char *pattern;
+    uint32_t allowed;
+    void *handlers[FOSSIL_NET_HTTP_METHODS];
+};
+
+struct fossil_net_router
+{
+    fossil__route_node_t root;
+    uint32_t count;
+};
+
+static fossil__route_node_t *fossil__node_new(const char *prefix, uint32_t len)
+{
+    fossil__route_node_t *n = calloc(1, sizeof(*n));
+    if (!n)
+        return NULL;
+    if (len) {
+        n->prefix = malloc(len);
+        if (!n->prefix) {
+            free(n);
+            return NULL;
+        }
+        memcpy(n->prefix, prefix, len);
+        n->prefix_len = len;
+    }
+    return n;
+}
+
+static void fossil__node_clear(fossil__route_node_t *n)
+{
+    for (uint32_t i = 0; i < n->child_count; i++) {
+        fossil__node_clear(n->children[i]);
+        free(n->children[i]);
+    }
+    if (n->param) {
+        fossil__node_clear(n->param);
+        free(n->param);
+    }
+    if (n->wildcard) {
+        fossil__node_clear(n->wildcard);
+        free(n->wildcard);
+    }
+    free(n->children);
+    free(n->indices);
+    free(n->prefix);
+    free(n->name);
+    free(n->pattern);
+}
+
+static int fossil__node_attach(fossil__route_node_t *n, fossil__route_node_t *child)
+{
+    fossil__route_node_t **children = realloc(n->children, (n->child_count + 1) * sizeof(*children));
+    if (!children)
+        return -1;
+    n->children = children;
+    char *indices = realloc(n->indices, n->child_count + 1);
+    if (!indices)
+        return -1;
+    n->indices = indices;
+    n->children[n->child_count] = child;
+    n->indices[n->child_count] = child->prefix[0];
+    n->child_count++;
+    return 0;
+}
+
+static fossil__route_node_t *fossil__node_child(const fossil__route_node_t *n, char c)
+{
+    if (!n->child_count)
+        return NULL;
+    const char *at = memchr(n->indices, c, n->child_count);
+    return at ? n->children[at - n->indices] : NULL;
+}
+
+/* Parameter-bearing child: create it or check the name agrees. */
+static fossil__route_node_t *fossil__node_dynamic(fossil__route_node_t **slot, const char *name, uint32_t len)
+{
+    if (*slot) {
+        if ((*slot)->name_len != len || memcmp((*slot)->name, name, len) != 0)
+            return NULL;
+        return *slot;
+    }
+    fossil__route_node_t *n = fossil__node_new(NULL, 0);
+    if (!n)
+        return NULL;
+    n->name = malloc(len + 1);
+    if (!n->name) {
+        free(n);
+        return NULL;
+    }
+    memcpy(n->name, name, len);
+    n->name[len] = '\0';
+    n->name_len = len;
+    *slot = n;
+    return n;
+}
+
+/* Descend by literal text, splitting nodes on a partial prefix match. */
+static fossil__route_node_t *fossil__node_literal(fossil__route_node_t *n, const char *s, uint32_t len)
+{
+    while (len) {
+        fossil__route_node_t *child = fossil__node_child(n, s[0]);
+        if (!child) {
+            child = fossil__node_new(s, len);
+            if (!child || fossil__node_attach(n, child) != 0) {
+                if (child)
+                    fossil__node_clear(child);
+                free(child);
+                return NULL;
+            }
+            return child;
+        }
+
+        uint32_t c = 0;
+        while (c < len && c < child->prefix_len && s[c] == child->prefix[c])
+            c++;
+        if (c < child->prefix_len) {
+            /* split: a new lower node takes the tail and everything below */
+            uint32_t rest = child->prefix_len - c;
+            char *tail = malloc(rest);
+            fossil__route_node_t *lower = malloc(sizeof(*lower));
+            fossil__route_node_t **kids = malloc(sizeof(*kids));
+            char *idx = malloc(1);
+            if (!tail || !lower || !kids || !idx) {
+                free(tail);
+                free(lower);
+                free(kids);
+                free(idx);
+                return NULL;
+            }
+            memcpy(tail, child->prefix + c, rest);
+            *lower = *child;
+            lower->prefix = tail;
+            lower->prefix_len = rest;
+
+            char *head = child->prefix;
+            memset(child, 0, sizeof(*child));
+            child->prefix = head;
+            child->prefix_len = c;
+            child->children = kids;
+            child->indices = idx;
+            kids[0] = lower;
+            idx[0] = tail[0];
+            child->child_count = 1;
+        }
+        n = child;
+        s += c;
+        len -= c;
+    }
+    return n;
+}
+
+static uint32_t fossil__method_bit(fossil_net_http_method_t method)
+{
+    return 1u << (unsigned)method;
+}
+
+/*
+ * Walk one candidate branch. Returns 1 on a match for the method; on a
+ * path match for other methods only, ORs their bits into match->allowed
+ * and keeps backtracking for a better branch.
+ */
+static int fossil__node_match(
+    const fossil__route_node_t *n,
+    fossil_net_http_method_t method,
+    const char *path,
+    uint32_t len,
+    uint32_t pos,
+    fossil_net_route_match_t *m)
+{
+    if (pos == len && n->allowed) {
+        void *h = n->handlers[method];
+        if (!h && method == FOSSIL_NET_HTTP_HEAD)
+            h = n->handlers[FOSSIL_NET_HTTP_GET];
+        if (h) {
+            m->handler = h;
+            m->pattern = n->pattern;
+            return 1;
+        }
+        m->allowed |= n->allowed;
+    }
+
+    if (pos < len) {
+        const fossil__route_node_t *child = fossil__node_child(n, path[pos]);
+        if (child && len - pos >= child->prefix_len &&
+            memcmp(path + pos, child->prefix, child->prefix_len) == 0 &&
+            fossil__node_match(child, method, path, len, pos + child->prefix_len, m))
+            return 1;
+    }
+
+    if (n->param && pos < len && path[pos] != '/' && m->param_count < FOSSIL_NET_ROUTER_MAX_PARAMS) {
+        const char *slash = memchr(path + pos, '/', len - pos);
+        uint32_t end = slash ? (uint32_t)(slash - path) : len;
+        fossil_net_route_param_t *p = &m->params[m->param_count++];
+        p->name.ptr = n->param->name;
+        p->name.len = n->param->name_len;
+        p->value.ptr = path + pos;
+        p->value.len = end - pos;
+        if (fossil__node_match(n->param, method, path, len, end, m))
+            return 1;
+        m->param_count--;
+    }
+
+    if (n->wildcard && m->param_count < FOSSIL_NET_ROUTER_MAX_PARAMS) {
+        const fossil__route_node_t *w = n->wildcard;
+        void *h = w->handlers[method];
+        if (!h && method == FOSSIL_NET_HTTP_HEAD)
+            h = w->handlers[FOSSIL_NET_HTTP_GET];
+        if (h) {
+            fossil_net_route_param_t *p = &m->params[m->param_count++];
+            p->name.ptr = w->name;
+            p->name.len = w->name_len;
+            p->value.ptr = path + pos;
+            p->value.len = len - pos;
+            m->handler = h;
+            m->pattern = w->pattern;
+            return 1;
+        }
+        m->allowed |= w->allowed;
+    }
+    return 0;
+}
+
+/*=============================================================================
+ROUTER
+=============================================================================*/
+
+fossil_net_router_t *fossil_net_router_create(void)
+{
+    return calloc(1, sizeof(fossil_net_router_t));
+}
+
+void fossil_net_router_destroy(fossil_net_router_t *router)
+{
+    if (!router)
+        return;
+    fossil__node_clear(&router->root);
+    free(router);
+}
+
+int fossil_net_router_add(
+    fossil_net_router_t *router,
+    fossil_net_http_method_t method,
+    const char *pattern,
+    void *handler)
+{
+    if (!router || !pattern || pattern[0] != '/' || !handler || (unsigned)method >= FOSSIL_NET_HTTP_METHODS)
+        return -1;
+
+    fossil__route_node_t *n = &router->root;
+    const char *s = pattern;
+    uint32_t params = 0;
+
+    while (*s) {
+        if (s != pattern && s[-1] == '/' && (*s == ':' || *s == '*')) {
+            const char *name = s + 1;
+            const char *e = name;
+            while (*e && *e != '/')
+                e++;
+            if (++params > FOSSIL_NET_ROUTER_MAX_PARAMS)
+                return -1;
+            if (*s == '*') {
+                if (*e)
+                    return -1; /* wildcard must be last */
+                n = fossil__node_dynamic(&n->wildcard, name, (uint32_t)(e - name));
+            } else {
+                if (e == name)
+                    return -1;
+                n = fossil__node_dynamic(&n->param, name, (uint32_t)(e - name));
+            }
+            if (!n)
+                return -1;
+            s = e;
+            continue;
+        }
+
+        /* literal run up to the next segment that starts with ':' or '*' */
+        const char *e = s;
+        while (*e && !(e[0] == '/' && (e[1] == ':' || e[1] == '*')))
+            e++;
+        if (*e)
+            e++; /* keep the '/' with the literal */
+        n = fossil__node_literal(n, s, (uint32_t)(e - s));
+        if (!n)
+            return -1;
+        s = e;
+    }
+
+    if (n->handlers[method])
+        return -1;
+    if (!n->pattern) {
+        size_t plen = strlen(pattern);
+        n->pattern = malloc(plen + 1);
+        if (!n->pattern)
+            return -1;
+        memcpy(n->pattern, pattern, plen + 1);
+    }
+    n->handlers[method] = handler;
+    n->allowed |= fossil__method_bit(method);
+    if (method == FOSSIL_NET_HTTP_GET)
+        n->allowed |= fossil__method_bit(FOSSIL_NET_HTTP_HEAD);
+    router->count++;
+    return 0;
+}
+
+int fossil_net_router_match(
+    const fossil_net_router_t *router,
+    fossil_net_http_method_t method,
+    const char *path,
+    uint32_t len,
+    fossil_net_route_match_t *match)
+{
+    if (!router || !match || (!path && len) || (unsigned)method >= FOSSIL_NET_HTTP_METHODS)
+        return FOSSIL_NET_ROUTER_NOT_FOUND;
+
+    match->handler = NULL;
+    match->pattern = NULL;
+    match->param_count = 0;
+    match->allowed = 0;
+    if (fossil__node_match(&router->root, method, path, len, 0, match))
+        return 0;
+    return match->allowed ? FOSSIL_NET_ROUTER_NOT_ALLOWED : FOSSIL_NET_ROUTER_NOT_FOUND;
+}
+
+bool fossil_net_route_param(
+    const fossil_net_route_match_t *match,
+    const char *name,
+    fossil_net_slice_t *value)
+{
+    if (!match || !name)
+        return false;
+    for (uint32_t i = 0; i < match->param_count; i++) {
+        if (fossil_net_slice_eq(match->params[i].name, name)) {
+            if (value)
+                *value = match->params[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t fossil_net_router_count(const fossil_net_router_t *router)
+{
+    return router ? router->count : 0;
+}
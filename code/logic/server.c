@@ -22,7 +22,27 @@
  * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+#if defined(__linux__)
+// Must be defined before any system header for struct ucred & co.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
 #include "fossil/network/server.h"
+#include "fossil/network/inet.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#endif
 
 #include <stdlib.h>
 #include <string.h>
@@ -132,3 +152,271 @@ int fossil_net_server_set_blocking(
         return -1;
     return fossil_net_socket_set_blocking(&server->sock, blocking);
 }
+
+fossil_net_socket_t *fossil_net_server_socket(
+    fossil_net_server_t *server)
+{
+    if (!server)
+        return NULL;
+    return &server->sock;
+}
+
+/*=============================================================================
+INHERITED LISTENERS
+=============================================================================*/
+
+fossil_net_server_t *fossil_net_server_adopt(int32_t fd)
+{
+    if (fd < 0)
+        return NULL;
+    struct sockaddr_storage sa;
+    socklen_t salen = sizeof(sa);
+    int type = 0, listening = 0;
+    socklen_t optlen = sizeof(type);
+    fossil_net_endpoint_t ep;
+    memset(&sa, 0, sizeof(sa));
+#if defined(_WIN32)
+    SOCKET s = (SOCKET)(intptr_t)fd;
+#else
+    int s = fd;
+#endif
+    if (getsockname(s, (struct sockaddr *)&sa, &salen) != 0 ||
+        getsockopt(s, SOL_SOCKET, SO_TYPE, (char *)&type, &optlen) != 0 ||
+        fossil_net_endpoint_from_sockaddr(&ep, &sa) != 0 ||
+        (type != SOCK_STREAM && type != SOCK_DGRAM))
+        return NULL;
+    optlen = sizeof(listening);
+    if (type == SOCK_STREAM && getsockopt(s, SOL_SOCKET, SO_ACCEPTCONN, (char *)&listening, &optlen) != 0)
+        listening = 0;
+
+    fossil_net_server_t *server = calloc(1, sizeof(fossil_net_server_t));
+    if (!server)
+        return NULL;
+    if (fossil_net_endpoint_to_address(&ep, &server->addr) != 0) {
+        free(server);
+        return NULL;
+    }
+    server->sock.fd = fd;
+    server->sock.type = type == SOCK_STREAM ? FOSSIL_NET_SOCKET_TYPE_TCP : FOSSIL_NET_SOCKET_TYPE_UDP;
+    server->sock.family = ep.family;
+    server->sock.flags = FOSSIL_NET_SOCKET_FLAG_BOUND;
+    if (listening)
+        server->sock.flags |= FOSSIL_NET_SOCKET_FLAG_LISTENING;
+#if defined(_WIN32)
+    server->sock.flags |= FOSSIL_NET_SOCKET_FLAG_BLOCKING; /* the mode cannot be queried */
+#else
+    if (!(fcntl(fd, F_GETFL, 0) & O_NONBLOCK))
+        server->sock.flags |= FOSSIL_NET_SOCKET_FLAG_BLOCKING;
+#endif
+    return server;
+}
+
+#if defined(_WIN32)
+
+int fossil_net_server_listen_fds(fossil_net_server_t **servers, uint32_t max)
+{
+    (void)servers;
+    (void)max;
+    return 0;
+}
+
+int fossil_net_server_handoff(const char *path, fossil_net_server_t *const *servers,
+                              uint32_t count, uint32_t timeout_ms)
+{
+    (void)path;
+    (void)servers;
+    (void)count;
+    (void)timeout_ms;
+    return -1;
+}
+
+int fossil_net_server_inherit(const char *path, fossil_net_server_t **servers, uint32_t max)
+{
+    (void)path;
+    (void)servers;
+    (void)max;
+    return -1;
+}
+
+#else
+
+#define FOSSIL__SERVER_LISTEN_FDS_START 3
+
+int fossil_net_server_listen_fds(fossil_net_server_t **servers, uint32_t max)
+{
+    const char *pid = getenv("LISTEN_PID");
+    const char *fds = getenv("LISTEN_FDS");
+    if (!servers || !pid || !fds)
+        return 0;
+    char *end;
+    unsigned long owner = strtoul(pid, &end, 10);
+    if (*end || owner != (unsigned long)getpid())
+        return 0;
+    unsigned long n = strtoul(fds, &end, 10);
+    unsetenv("LISTEN_PID");
+    unsetenv("LISTEN_FDS");
+    unsetenv("LISTEN_FDNAMES");
+    if (*end || n > 4096)
+        return 0;
+
+    uint32_t count = 0;
+    for (unsigned long i = 0; i < n; i++) {
+        int fd = FOSSIL__SERVER_LISTEN_FDS_START + (int)i;
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        if (count < max)
+            servers[count++] = fossil_net_server_adopt(fd);
+    }
+    return (int)count;
+}
+
+static int fossil__server_unix_addr(struct sockaddr_un *sun, const char *path)
+{
+    size_t len = path ? strlen(path) : 0;
+    if (len == 0 || len >= sizeof(sun->sun_path))
+        return -1;
+    memset(sun, 0, sizeof(*sun));
+    sun->sun_family = AF_UNIX;
+    memcpy(sun->sun_path, path, len + 1);
+    return 0;
+}
+
+int fossil_net_server_handoff(const char *path, fossil_net_server_t *const *servers,
+                              uint32_t count, uint32_t timeout_ms)
+{
+    struct sockaddr_un sun;
+    if (!servers || count == 0 || count > FOSSIL_NET_SERVER_MAX_INHERIT ||
+        fossil__server_unix_addr(&sun, path) != 0)
+        return -1;
+    int fds[FOSSIL_NET_SERVER_MAX_INHERIT];
+    for (uint32_t i = 0; i < count; i++) {
+        if (!servers[i] || servers[i]->sock.fd < 0)
+            return -1;
+        fds[i] = servers[i]->sock.fd;
+    }
+
+    int ls = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ls < 0)
+        return -1;
+    fcntl(ls, F_SETFD, FD_CLOEXEC);
+    unlink(path);
+    int rc = -1, c = -1;
+    struct pollfd pfd = { ls, POLLIN, 0 };
+    if (bind(ls, (struct sockaddr *)&sun, sizeof(sun)) != 0)
+        goto out;
+    if (listen(ls, 1) != 0 || poll(&pfd, 1, (int)timeout_ms) != 1 || (c = accept(ls, NULL, NULL)) < 0)
+        goto unlink_out;
+#if defined(SO_PEERCRED)
+    {
+        struct ucred cred;
+        socklen_t len = sizeof(cred);
+        if (getsockopt(c, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0 || cred.uid != geteuid())
+            goto unlink_out;
+    }
+#endif
+    {
+        /* The payload carries the count so the receiver can spot a truncated control message. */
+        uint32_t n = count;
+        struct iovec iov = { &n, sizeof(n) };
+        union {
+            struct cmsghdr align;
+            char buf[CMSG_SPACE(sizeof(int) * FOSSIL_NET_SERVER_MAX_INHERIT)];
+        } ctrl;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        memset(&ctrl, 0, sizeof(ctrl));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl.buf;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+        cm->cmsg_level = SOL_SOCKET;
+        cm->cmsg_type = SCM_RIGHTS;
+        cm->cmsg_len = CMSG_LEN(sizeof(int) * count);
+        memcpy(CMSG_DATA(cm), fds, sizeof(int) * count);
+        ssize_t sent;
+        do sent = sendmsg(c, &msg, 0);
+        while (sent < 0 && errno == EINTR);
+        rc = sent == (ssize_t)sizeof(n) ? 0 : -1;
+    }
+unlink_out:
+    unlink(path);
+out:
+    if (c >= 0)
+        close(c);
+    close(ls);
+    return rc;
+}
+
+int fossil_net_server_inherit(const char *path, fossil_net_server_t **servers, uint32_t max)
+{
+    struct sockaddr_un sun;
+    if (!servers || fossil__server_unix_addr(&sun, path) != 0)
+        return -1;
+    int c = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (c < 0)
+        return -1;
+    fcntl(c, F_SETFD, FD_CLOEXEC);
+    if (connect(c, (struct sockaddr *)&sun, sizeof(sun)) != 0) {
+        close(c);
+        return -1;
+    }
+
+    uint32_t n = 0;
+    struct iovec iov = { &n, sizeof(n) };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int) * FOSSIL_NET_SERVER_MAX_INHERIT)];
+    } ctrl;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+#if defined(MSG_CMSG_CLOEXEC)
+    int flags = MSG_CMSG_CLOEXEC;
+#else
+    int flags = 0;
+#endif
+    ssize_t got;
+    do got = recvmsg(c, &msg, flags);
+    while (got < 0 && errno == EINTR);
+    close(c);
+    if (got < 0)
+        return -1;
+
+    int fds[FOSSIL_NET_SERVER_MAX_INHERIT];
+    uint32_t nfds = 0;
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS)
+            continue;
+        uint32_t k = (uint32_t)((cm->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        if (k > FOSSIL_NET_SERVER_MAX_INHERIT - nfds)
+            k = FOSSIL_NET_SERVER_MAX_INHERIT - nfds;
+        memcpy(fds + nfds, CMSG_DATA(cm), sizeof(int) * k);
+        nfds += k;
+    }
+    if (got != (ssize_t)sizeof(n) || n != nfds || (msg.msg_flags & MSG_CTRUNC)) {
+        for (uint32_t i = 0; i < nfds; i++)
+            close(fds[i]);
+        return -1;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < nfds; i++) {
+#if !defined(MSG_CMSG_CLOEXEC)
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+#endif
+        if (count == max) {
+            close(fds[i]);
+            continue;
+        }
+        servers[count] = fossil_net_server_adopt(fds[i]);
+        if (!servers[count])
+            close(fds[i]);
+        count++;
+    }
+    return (int)count;
+}
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/shed.h"
+#include "fossil/network/socket.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+#define FOSSIL__SHED_TARGET_NS   5000000ull
+#define FOSSIL__SHED_INTERVAL_NS 100000000ull
+#define FOSSIL__SHED_CLOSE_BATCH 16u
+
+static const char fossil__shed_503[] =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Content-Length: 0\r\n"
+    "Retry-After: 1\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+typedef struct fossil__shed_queue {
+    _Atomic uint64_t above_since;  /* first sample of the current run above target, 0 if below */
+    _Atomic uint64_t last_ns;      /* time of the latest sample */
+    _Atomic uint64_t samples;
+    _Atomic uint64_t above;
+    _Atomic uint64_t max_ns;
+} fossil__shed_queue_t;
+
+struct fossil_net_shed {
+    fossil_net_shed_config_t config;
+    uint8_t *canned;
+    atomic_int level;
+    atomic_int forced;             /* -1 when detection is automatic */
+    _Atomic uint64_t changed_ns;   /* last level change */
+    _Atomic uint64_t escalations;
+    _Atomic uint64_t deescalations;
+    _Atomic uint64_t admitted;
+    _Atomic uint64_t rejected;
+    fossil__shed_queue_t queues[FOSSIL_NET_SHED_QUEUES];
+};
+
+/*
+ * A queue counts as overloaded only while its samples are recent. Threads
+ * read the clock independently, so "now" may trail a stamp slightly.
+ */
+static bool fossil__shed_overloaded(fossil_net_shed_t *s, uint64_t now) {
+    for (int i = 0; i < FOSSIL_NET_SHED_QUEUES; i++) {
+        fossil__shed_queue_t *q = &s->queues[i];
+        uint64_t last = atomic_load_explicit(&q->last_ns, memory_order_relaxed);
+        if (atomic_load_explicit(&q->above_since, memory_order_relaxed) != 0 &&
+            (last > now || now - last < s->config.interval_ns))
+            return true;
+    }
+    return false;
+}
+
+/* Move one level up or down, at most once per interval across all threads. */
+static void fossil__shed_step(fossil_net_shed_t *s, uint64_t now, int delta) {
+    uint64_t changed = atomic_load_explicit(&s->changed_ns, memory_order_relaxed);
+    if (now < changed || now - changed < s->config.interval_ns) return;
+    int level = atomic_load_explicit(&s->level, memory_order_relaxed);
+    int next = level + delta;
+    if (next < FOSSIL_NET_SHED_NONE || next > FOSSIL_NET_SHED_CLOSE_IDLE) return;
+    if (!atomic_compare_exchange_strong_explicit(&s->changed_ns, &changed, now,
+                                                 memory_order_relaxed, memory_order_relaxed))
+        return;
+    atomic_store_explicit(&s->level, next, memory_order_relaxed);
+    atomic_fetch_add_explicit(delta > 0 ? &s->escalations : &s->deescalations, 1, memory_order_relaxed);
+}
+
+static void fossil__shed_decay(fossil_net_shed_t *s, uint64_t now) {
+    if (atomic_load_explicit(&s->level, memory_order_relaxed) > FOSSIL_NET_SHED_NONE &&
+        !fossil__shed_overloaded(s, now))
+        fossil__shed_step(s, now, -1);
+}
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+fossil_net_shed_t *fossil_net_shed_create(const fossil_net_shed_config_t *config) {
+    fossil_net_shed_t *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    if (config) s->config = *config;
+    if (!s->config.target_ns) s->config.target_ns = FOSSIL__SHED_TARGET_NS;
+    if (!s->config.interval_ns) s->config.interval_ns = FOSSIL__SHED_INTERVAL_NS;
+    if (!s->config.close_batch) s->config.close_batch = FOSSIL__SHED_CLOSE_BATCH;
+    if (!s->config.canned || !s->config.canned_len) {
+        s->config.canned = fossil__shed_503;
+        s->config.canned_len = (uint32_t)(sizeof(fossil__shed_503) - 1);
+    }
+    s->canned = malloc(s->config.canned_len);
+    if (!s->canned) {
+        free(s);
+        return NULL;
+    }
+    memcpy(s->canned, s->config.canned, s->config.canned_len);
+    s->config.canned = s->canned;
+    atomic_init(&s->level, FOSSIL_NET_SHED_NONE);
+    atomic_init(&s->forced, -1);
+    return s;
+}
+
+void fossil_net_shed_destroy(fossil_net_shed_t *shed) {
+    if (!shed) return;
+    free(shed->canned);
+    free(shed);
+}
+
+/*=============================================================================
+DETECTION
+=============================================================================*/
+
+void fossil_net_shed_record(fossil_net_shed_t *shed, fossil_net_shed_queue_t queue, uint64_t sojourn_ns, uint64_t now_ns) {
+    if (!shed || (unsigned)queue >= FOSSIL_NET_SHED_QUEUES) return;
+    uint64_t now = now_ns ? now_ns : fossil_net_socket_clock_ns();
+    fossil__shed_queue_t *q = &shed->queues[queue];
+    atomic_fetch_add_explicit(&q->samples, 1, memory_order_relaxed);
+    atomic_store_explicit(&q->last_ns, now, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&q->max_ns, memory_order_relaxed);
+    while (sojourn_ns > max &&
+           !atomic_compare_exchange_weak_explicit(&q->max_ns, &max, sojourn_ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) { }
+
+    if (sojourn_ns < shed->config.target_ns) {
+        atomic_store_explicit(&q->above_since, 0, memory_order_relaxed);
+        fossil__shed_decay(shed, now);
+        return;
+    }
+    atomic_fetch_add_explicit(&q->above, 1, memory_order_relaxed);
+    uint64_t since = atomic_load_explicit(&q->above_since, memory_order_relaxed);
+    if (since == 0) {
+        atomic_compare_exchange_strong_explicit(&q->above_since, &since, now,
+                                                memory_order_relaxed, memory_order_relaxed);
+        return;
+    }
+    /* Above target for a whole interval: a standing queue, not a burst. */
+    if (now > since && now - since >= shed->config.interval_ns)
+        fossil__shed_step(shed, now, +1);
+}
+
+int fossil_net_shed_level(fossil_net_shed_t *shed, uint64_t now_ns) {
+    if (!shed) return FOSSIL_NET_SHED_NONE;
+    int forced = atomic_load_explicit(&shed->forced, memory_order_relaxed);
+    if (forced >= 0) return forced;
+    fossil__shed_decay(shed, now_ns ? now_ns : fossil_net_socket_clock_ns());
+    return atomic_load_explicit(&shed->level, memory_order_relaxed);
+}
+
+int fossil_net_shed_force(fossil_net_shed_t *shed, int level) {
+    if (!shed || level < -1 || level > FOSSIL_NET_SHED_CLOSE_IDLE) return -1;
+    atomic_store_explicit(&shed->forced, level, memory_order_relaxed);
+    return 0;
+}
+
+/*=============================================================================
+ADMISSION
+=============================================================================*/
+
+bool fossil_net_shed_admit(fossil_net_shed_t *shed) {
+    if (!shed) return true;
+    if (fossil_net_shed_level(shed, 0) >= FOSSIL_NET_SHED_REJECT) {
+        atomic_fetch_add_explicit(&shed->rejected, 1, memory_order_relaxed);
+        return false;
+    }
+    atomic_fetch_add_explicit(&shed->admitted, 1, memory_order_relaxed);
+    return true;
+}
+
+const void *fossil_net_shed_canned(const fossil_net_shed_t *shed, uint32_t *len) {
+    if (len) *len = shed ? shed->config.canned_len : 0;
+    return shed ? shed->canned : NULL;
+}
+
+int fossil_net_shed_get_config(const fossil_net_shed_t *shed, fossil_net_shed_config_t *config) {
+    if (!shed || !config) return -1;
+    *config = shed->config;
+    return 0;
+}
+
+int fossil_net_shed_get_stats(const fossil_net_shed_t *shed, fossil_net_shed_stats_t *stats) {
+    if (!shed || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    fossil_net_shed_t *s = (fossil_net_shed_t *)shed;
+    int forced = atomic_load_explicit(&s->forced, memory_order_relaxed);
+    stats->level = (uint32_t)(forced >= 0 ? forced : atomic_load_explicit(&s->level, memory_order_relaxed));
+    for (int i = 0; i < FOSSIL_NET_SHED_QUEUES; i++) {
+        stats->samples[i] = atomic_load_explicit(&s->queues[i].samples, memory_order_relaxed);
+        stats->above_target[i] = atomic_load_explicit(&s->queues[i].above, memory_order_relaxed);
+        stats->max_sojourn_ns[i] = atomic_load_explicit(&s->queues[i].max_ns, memory_order_relaxed);
+    }
+    stats->escalations = atomic_load_explicit(&s->escalations, memory_order_relaxed);
+    stats->deescalations = atomic_load_explicit(&s->deescalations, memory_order_relaxed);
+    stats->admitted = atomic_load_explicit(&s->admitted, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&s->rejected, memory_order_relaxed);
+    return 0;
+}
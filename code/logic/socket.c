@@ -22,7 +22,17 @@
  * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+#if defined(__linux__)
+// Must be defined before any system header to expose SO_MAX_PACING_RATE & co.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
 #include "fossil/network/socket.h"
+#include "fossil/network/inet.h"
+#include "fossil/network/ratelimit.h"
+#include "fossil/network/tap.h"
 
 #if defined(__APPLE__)
 // Must define this **before including any headers** to get getloadavg
@@ -50,13 +60,17 @@
 #include <netdb.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 #if defined(__linux__)
 #include <netpacket/packet.h>
+#include <net/ethernet.h>
 #endif
 #endif
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
 
 /*=============================================================================
 ERROR HANDLING
@@ -104,49 +118,226 @@ int fossil_net_socket_shutdown(void) {
 SOCKET MANAGEMENT
 =============================================================================*/
 
-static int family_from_string(const char *family) {
-    if (!strcmp(family, "ipv4")) return AF_INET;
-    if (!strcmp(family, "ipv6")) return AF_INET6;
-    return AF_UNSPEC;
+static const char *const fossil__type_ids[] = { "", "tcp", "udp", "raw", "icmp" };
+static const char *const fossil__family_ids[] = { "", "ipv4", "ipv6", "packet" };
+
+static fossil_net_socket_family_t family_from_string(const char *family) {
+    if (!family) return FOSSIL_NET_SOCKET_FAMILY_NONE;
+    if (!strcmp(family, "ipv4")) return FOSSIL_NET_SOCKET_FAMILY_IPV4;
+    if (!strcmp(family, "ipv6")) return FOSSIL_NET_SOCKET_FAMILY_IPV6;
+    if (!strcmp(family, "packet")) return FOSSIL_NET_SOCKET_FAMILY_PACKET;
+    return FOSSIL_NET_SOCKET_FAMILY_NONE;
 }
 
-static int type_from_string(const char *type) {
-    if (!strcmp(type, "tcp")) return SOCK_STREAM;
-    if (!strcmp(type, "udp")) return SOCK_DGRAM;
-    if (!strcmp(type, "raw")) return SOCK_RAW;
-    return SOCK_STREAM;
+static fossil_net_socket_type_t type_from_string(const char *type) {
+    if (type && !strcmp(type, "udp")) return FOSSIL_NET_SOCKET_TYPE_UDP;
+    if (type && !strcmp(type, "raw")) return FOSSIL_NET_SOCKET_TYPE_RAW;
+    if (type && !strcmp(type, "icmp")) return FOSSIL_NET_SOCKET_TYPE_ICMP;
+    return FOSSIL_NET_SOCKET_TYPE_TCP;
+}
+
+static int family_to_native(uint8_t family) {
+    switch (family) {
+        case FOSSIL_NET_SOCKET_FAMILY_IPV4: return AF_INET;
+        case FOSSIL_NET_SOCKET_FAMILY_IPV6: return AF_INET6;
+#if defined(__linux__)
+        case FOSSIL_NET_SOCKET_FAMILY_PACKET: return AF_PACKET;
+#endif
+        default: return AF_UNSPEC;
+    }
+}
+
+static int protocol_to_native(uint8_t type, uint8_t family) {
+#if defined(__linux__)
+    // Packet sockets name the EtherType to capture; take everything
+    if (family == FOSSIL_NET_SOCKET_FAMILY_PACKET) return (int)htons(ETH_P_ALL);
+#endif
+    // IP-level raw and ping sockets carry ICMP
+    if (type == FOSSIL_NET_SOCKET_TYPE_RAW || type == FOSSIL_NET_SOCKET_TYPE_ICMP) {
+        if (family == FOSSIL_NET_SOCKET_FAMILY_IPV4) return IPPROTO_ICMP;
+        if (family == FOSSIL_NET_SOCKET_FAMILY_IPV6) return IPPROTO_ICMPV6;
+    }
+    return 0;
+}
+
+static int type_to_native(uint8_t type) {
+    switch (type) {
+        case FOSSIL_NET_SOCKET_TYPE_UDP: return SOCK_DGRAM;
+        case FOSSIL_NET_SOCKET_TYPE_RAW: return SOCK_RAW;
+        case FOSSIL_NET_SOCKET_TYPE_ICMP: return SOCK_DGRAM;
+        default: return SOCK_STREAM;
+    }
+}
+
+/*
+ * Cold side table: per-descriptor data that is rarely touched (currently the
+ * user-defined ID). Open addressing keyed by fd, allocated on first use and
+ * guarded by a spinlock since it is never on the I/O path.
+ */
+typedef struct fossil__socket_cold {
+    int32_t fd;      /* -1 marks an empty slot */
+    char id[64];
+} fossil__socket_cold_t;
+
+static fossil__socket_cold_t *fossil__cold_slots = NULL;
+static uint32_t fossil__cold_capacity = 0;
+static atomic_uint fossil__cold_count = 0;
+static atomic_flag fossil__cold_lock = ATOMIC_FLAG_INIT;
+
+static void fossil__cold_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&fossil__cold_lock, memory_order_acquire)) { }
+}
+
+static void fossil__cold_release(void) {
+    atomic_flag_clear_explicit(&fossil__cold_lock, memory_order_release);
+}
+
+static uint32_t fossil__cold_hash(int32_t fd) {
+    return ((uint32_t)fd * 2654435761u);
+}
+
+/* Caller holds the lock. Returns the slot for fd, or NULL if absent. */
+static fossil__socket_cold_t *fossil__cold_find(int32_t fd) {
+    if (!fossil__cold_capacity) return NULL;
+    uint32_t mask = fossil__cold_capacity - 1;
+    for (uint32_t i = fossil__cold_hash(fd) & mask;; i = (i + 1) & mask) {
+        if (fossil__cold_slots[i].fd == fd) return &fossil__cold_slots[i];
+        if (fossil__cold_slots[i].fd < 0) return NULL;
+    }
+}
+
+/* Caller holds the lock. Grows the table to keep the load factor under 1/2. */
+static fossil__socket_cold_t *fossil__cold_insert(int32_t fd) {
+    fossil__socket_cold_t *slot = fossil__cold_find(fd);
+    if (slot) return slot;
+
+    uint32_t count = atomic_load_explicit(&fossil__cold_count, memory_order_relaxed);
+    if ((count + 1) * 2 > fossil__cold_capacity) {
+        uint32_t capacity = fossil__cold_capacity ? fossil__cold_capacity * 2 : 64;
+        fossil__socket_cold_t *slots = malloc(capacity * sizeof(*slots));
+        if (!slots) return NULL;
+        for (uint32_t i = 0; i < capacity; ++i) slots[i].fd = -1;
+        for (uint32_t i = 0; i < fossil__cold_capacity; ++i) {
+            if (fossil__cold_slots[i].fd < 0) continue;
+            uint32_t j = fossil__cold_hash(fossil__cold_slots[i].fd) & (capacity - 1);
+            while (slots[j].fd >= 0) j = (j + 1) & (capacity - 1);
+            slots[j] = fossil__cold_slots[i];
+        }
+        free(fossil__cold_slots);
+        fossil__cold_slots = slots;
+        fossil__cold_capacity = capacity;
+    }
+
+    uint32_t mask = fossil__cold_capacity - 1;
+    uint32_t i = fossil__cold_hash(fd) & mask;
+    while (fossil__cold_slots[i].fd >= 0) i = (i + 1) & mask;
+    memset(&fossil__cold_slots[i], 0, sizeof(fossil__cold_slots[i]));
+    fossil__cold_slots[i].fd = fd;
+    atomic_fetch_add_explicit(&fossil__cold_count, 1, memory_order_relaxed);
+    return &fossil__cold_slots[i];
+}
+
+/* Caller holds the lock. Backward-shift deletion keeps probe chains intact. */
+static void fossil__cold_erase(int32_t fd) {
+    fossil__socket_cold_t *slot = fossil__cold_find(fd);
+    if (!slot) return;
+    uint32_t mask = fossil__cold_capacity - 1;
+    uint32_t hole = (uint32_t)(slot - fossil__cold_slots);
+    for (uint32_t i = (hole + 1) & mask; fossil__cold_slots[i].fd >= 0; i = (i + 1) & mask) {
+        uint32_t home = fossil__cold_hash(fossil__cold_slots[i].fd) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            fossil__cold_slots[hole] = fossil__cold_slots[i];
+            hole = i;
+        }
+    }
+    fossil__cold_slots[hole].fd = -1;
+    atomic_fetch_sub_explicit(&fossil__cold_count, 1, memory_order_relaxed);
+}
+
+/*
+ * Attachment table: optional per-descriptor objects consulted on the I/O
+ * path (the rate limiter and the pcapng tap). Two-level and indexed directly by fd so
+ * lookups are a couple of loads without a lock; pages are never freed. Only
+ * sockets whose flags say something is attached pay for the lookup.
+ */
+#define FOSSIL__ATTACH_PAGE_SIZE 1024
+#define FOSSIL__ATTACH_PAGES     1024 /* descriptors below 1M */
+
+typedef struct fossil__socket_attach {
+    _Atomic(fossil_net_ratelimit_t *) limiter;
+    _Atomic(fossil_net_tap_t *) tap;
+    fossil_net_endpoint_t tap_local;   /* endpoints cached when the tap was attached */
+    fossil_net_endpoint_t tap_remote;
+} fossil__socket_attach_t;
+
+static _Atomic(fossil__socket_attach_t *) fossil__attach_pages[FOSSIL__ATTACH_PAGES];
+
+static fossil__socket_attach_t *fossil__attach_get(int32_t fd, bool create) {
+    if (fd < 0 || fd >= FOSSIL__ATTACH_PAGE_SIZE * FOSSIL__ATTACH_PAGES) return NULL;
+    _Atomic(fossil__socket_attach_t *) *slot = &fossil__attach_pages[fd / FOSSIL__ATTACH_PAGE_SIZE];
+    fossil__socket_attach_t *page = atomic_load_explicit(slot, memory_order_acquire);
+    if (!page) {
+        if (!create) return NULL;
+        fossil__socket_attach_t *fresh = calloc(FOSSIL__ATTACH_PAGE_SIZE, sizeof(*fresh));
+        if (!fresh) return NULL;
+        if (atomic_compare_exchange_strong_explicit(slot, &page, fresh,
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            page = fresh;
+        } else {
+            free(fresh);
+        }
+    }
+    return &page[fd % FOSSIL__ATTACH_PAGE_SIZE];
+}
+
+static void fossil__attach_clear(int32_t fd) {
+    fossil__socket_attach_t *att = fossil__attach_get(fd, false);
+    if (!att) return;
+    atomic_store_explicit(&att->limiter, NULL, memory_order_release);
+    atomic_store_explicit(&att->tap, NULL, memory_order_release);
 }
 
 int fossil_net_socket_create(fossil_net_socket_t *sock, const char *type, const char *family) {
     if (!sock) return -1;
     memset(sock, 0, sizeof(*sock));
+    sock->fd = -1;
 
-    int af   = family_from_string(family);
-    int stype = type_from_string(type);
+    fossil_net_socket_type_t stype = type_from_string(type);
+    fossil_net_socket_family_t sfamily = family_from_string(family);
 
 #if defined(_WIN32)
-    sock->handle = (void*)socket(af, stype, 0);
-    if ((SOCKET)sock->handle == INVALID_SOCKET) return -1;
+    SOCKET s = socket(family_to_native(sfamily), type_to_native(stype), protocol_to_native(stype, sfamily));
+    if (s == INVALID_SOCKET) return -1;
+    sock->fd = (int32_t)(intptr_t)s;
 #else
-    sock->handle = (void*)(intptr_t)socket(af, stype, 0);
-    if ((intptr_t)sock->handle < 0) return -1;
+    int s = socket(family_to_native(sfamily), type_to_native(stype), protocol_to_native(stype, sfamily));
+    if (s < 0) return -1;
+    sock->fd = s;
 #endif
 
-    strncpy(sock->type, type, sizeof(sock->type)-1);
-    strncpy(sock->family, family, sizeof(sock->family)-1);
-    sock->blocking = true;
+    sock->type = (uint8_t)stype;
+    sock->family = (uint8_t)sfamily;
+    sock->flags = FOSSIL_NET_SOCKET_FLAG_BLOCKING;
 
     return 0;
 }
 
 int fossil_net_socket_close(fossil_net_socket_t *sock) {
     if (!sock) return -1;
+    if (sock->fd < 0) return 0;
+    if (atomic_load_explicit(&fossil__cold_count, memory_order_relaxed) != 0) {
+        fossil__cold_acquire();
+        fossil__cold_erase(sock->fd);
+        fossil__cold_release();
+    }
+    fossil__attach_clear(sock->fd);
 #if defined(_WIN32)
-    closesocket((SOCKET)sock->handle);
+    closesocket((SOCKET)(intptr_t)sock->fd);
 #else
-    close((int)(intptr_t)sock->handle);
+    close(sock->fd);
 #endif
-    sock->handle = NULL;
+    sock->fd = -1;
+    sock->flags = 0;
     return 0;
 }
 
@@ -154,142 +345,333 @@ int fossil_net_socket_set_blocking(fossil_net_socket_t *sock, bool blocking) {
     if (!sock) return -1;
 #if defined(_WIN32)
     u_long mode = blocking ? 0 : 1;
-    ioctlsocket((SOCKET)sock->handle, FIONBIO, &mode);
+    ioctlsocket((SOCKET)(intptr_t)sock->fd, FIONBIO, &mode);
 #else
-    int flags = fcntl((int)(intptr_t)sock->handle, F_GETFL, 0);
+    int flags = fcntl(sock->fd, F_GETFL, 0);
     if (!blocking) flags |= O_NONBLOCK;
     else flags &= ~O_NONBLOCK;
-    fcntl((int)(intptr_t)sock->handle, F_SETFL, flags);
+    fcntl(sock->fd, F_SETFL, flags);
 #endif
-    sock->blocking = blocking;
+    if (blocking) sock->flags |= FOSSIL_NET_SOCKET_FLAG_BLOCKING;
+    else sock->flags &= (uint16_t)~FOSSIL_NET_SOCKET_FLAG_BLOCKING;
     return 0;
 }
 
+bool fossil_net_socket_is_blocking(const fossil_net_socket_t *sock) {
+    return sock && (sock->flags & FOSSIL_NET_SOCKET_FLAG_BLOCKING) != 0;
+}
+
 /*=============================================================================
-CONNECTION
+STRING ID ACCESSORS
 =============================================================================*/
 
-int fossil_net_socket_bind(fossil_net_socket_t *sock, const fossil_net_address_t *addr) {
-    if (!sock || !addr) return -1;
-    struct sockaddr_storage sa;
-    socklen_t salen;
+const char *fossil_net_socket_type_id(const fossil_net_socket_t *sock) {
+    if (!sock || sock->type > FOSSIL_NET_SOCKET_TYPE_ICMP) return "";
+    return fossil__type_ids[sock->type];
+}
 
-    memset(&sa, 0, sizeof(sa));
+const char *fossil_net_socket_family_id(const fossil_net_socket_t *sock) {
+    if (!sock || sock->family > FOSSIL_NET_SOCKET_FAMILY_PACKET) return "";
+    return fossil__family_ids[sock->family];
+}
+
+int fossil_net_socket_set_id(fossil_net_socket_t *sock, const char *id) {
+    if (!sock || sock->fd < 0) return -1;
+    int rc = 0;
+    fossil__cold_acquire();
+    if (!id || !id[0]) {
+        fossil__cold_erase(sock->fd);
+    } else {
+        fossil__socket_cold_t *slot = fossil__cold_insert(sock->fd);
+        if (slot) {
+            strncpy(slot->id, id, sizeof(slot->id) - 1);
+            slot->id[sizeof(slot->id) - 1] = '\0';
+        } else {
+            rc = -1;
+        }
+    }
+    fossil__cold_release();
+    return rc;
+}
+
+int fossil_net_socket_get_id(const fossil_net_socket_t *sock, char *buffer, uint32_t size) {
+    if (!sock || !buffer || size == 0) return -1;
+    buffer[0] = '\0';
+    if (atomic_load_explicit(&fossil__cold_count, memory_order_relaxed) == 0) return 0;
+    fossil__cold_acquire();
+    const fossil__socket_cold_t *slot = fossil__cold_find(sock->fd);
+    if (slot) {
+        strncpy(buffer, slot->id, size - 1);
+        buffer[size - 1] = '\0';
+    }
+    fossil__cold_release();
+    return 0;
+}
+
+/*=============================================================================
+CONNECTION
+=============================================================================*/
+
+/*
+ * Conversions between the public address types and sockaddr. These use the
+ * table-driven routines from inet.c so no per-call inet_ntop/inet_pton work
+ * is done on the connection paths.
+ */
+static int fossil__address_to_endpoint(const fossil_net_address_t *addr, fossil_net_endpoint_t *ep) {
+    memset(ep, 0, sizeof(*ep));
+    ep->port = addr->port;
+    /* an unparsable ip leaves the wildcard address, as inet_pton did */
     if (!strcmp(addr->family, "ipv4")) {
-        struct sockaddr_in *s4 = (struct sockaddr_in*)&sa;
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+        fossil_net_inet_ipv4_parse(addr->ip, ep->ip);
+        return 0;
+    }
+    if (!strcmp(addr->family, "ipv6")) {
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        fossil_net_inet_ipv6_parse(addr->ip, ep->ip);
+        return 0;
+    }
+    return -1;
+}
+
+uint32_t fossil_net_endpoint_to_sockaddr(const fossil_net_endpoint_t *ep, void *native) {
+    if (!ep || !native) return 0;
+    struct sockaddr_storage *sa = (struct sockaddr_storage*)native;
+    memset(sa, 0, sizeof(*sa));
+    if (ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV4) {
+        struct sockaddr_in *s4 = (struct sockaddr_in*)sa;
         s4->sin_family = AF_INET;
-        s4->sin_port = htons(addr->port);
-        inet_pton(AF_INET, addr->ip, &s4->sin_addr);
-        salen = sizeof(*s4);
-    } else if (!strcmp(addr->family, "ipv6")) {
-        struct sockaddr_in6 *s6 = (struct sockaddr_in6*)&sa;
+        s4->sin_port = htons(ep->port);
+        memcpy(&s4->sin_addr, ep->ip, 4);
+        return (uint32_t)sizeof(*s4);
+    }
+    if (ep->family == FOSSIL_NET_SOCKET_FAMILY_IPV6) {
+        struct sockaddr_in6 *s6 = (struct sockaddr_in6*)sa;
         s6->sin6_family = AF_INET6;
-        s6->sin6_port = htons(addr->port);
-        inet_pton(AF_INET6, addr->ip, &s6->sin6_addr);
-        salen = sizeof(*s6);
-    } else {
-        return -1;
+        s6->sin6_port = htons(ep->port);
+        s6->sin6_scope_id = ep->scope_id;
+        memcpy(&s6->sin6_addr, ep->ip, 16);
+        return (uint32_t)sizeof(*s6);
     }
+    return 0;
+}
+
+int fossil_net_endpoint_from_sockaddr(fossil_net_endpoint_t *ep, const void *native) {
+    if (!ep || !native) return -1;
+    const struct sockaddr_storage *sa = (const struct sockaddr_storage*)native;
+    memset(ep, 0, sizeof(*ep));
+    if (sa->ss_family == AF_INET) {
+        const struct sockaddr_in *s4 = (const struct sockaddr_in*)sa;
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+        ep->port = ntohs(s4->sin_port);
+        memcpy(ep->ip, &s4->sin_addr, 4);
+        return 0;
+    }
+    if (sa->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *s6 = (const struct sockaddr_in6*)sa;
+        ep->family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+        ep->port = ntohs(s6->sin6_port);
+        ep->scope_id = s6->sin6_scope_id;
+        memcpy(ep->ip, &s6->sin6_addr, 16);
+        return 0;
+    }
+    return -1;
+}
+
+int fossil_net_socket_bind(fossil_net_socket_t *sock, const fossil_net_address_t *addr) {
+    if (!sock || !addr) return -1;
+    fossil_net_endpoint_t ep;
+    if (fossil__address_to_endpoint(addr, &ep) != 0) return -1;
+    return fossil_net_socket_bind_endpoint(sock, &ep);
+}
+
+int fossil_net_socket_bind_endpoint(fossil_net_socket_t *sock, const fossil_net_endpoint_t *ep) {
+    if (!sock || !ep) return -1;
+    struct sockaddr_storage sa;
+    socklen_t salen = (socklen_t)fossil_net_endpoint_to_sockaddr(ep, &sa);
+    if (salen == 0) return -1;
 
 #if defined(_WIN32)
-    return bind((SOCKET)sock->handle, (struct sockaddr*)&sa, salen);
+    int rc = bind((SOCKET)(intptr_t)sock->fd, (struct sockaddr*)&sa, salen);
 #else
-    return bind((int)(intptr_t)sock->handle, (struct sockaddr*)&sa, salen);
+    int rc = bind(sock->fd, (struct sockaddr*)&sa, salen);
 #endif
+    if (rc == 0) sock->flags |= FOSSIL_NET_SOCKET_FLAG_BOUND;
+    return rc;
 }
 
 int fossil_net_socket_listen(fossil_net_socket_t *sock, int backlog) {
     if (!sock) return -1;
 #if defined(_WIN32)
-    return listen((SOCKET)sock->handle, backlog);
+    int rc = listen((SOCKET)(intptr_t)sock->fd, backlog);
 #else
-    return listen((int)(intptr_t)sock->handle, backlog);
+    int rc = listen(sock->fd, backlog);
 #endif
+    if (rc == 0) sock->flags |= FOSSIL_NET_SOCKET_FLAG_LISTENING;
+    return rc;
 }
 
-int fossil_net_socket_accept(fossil_net_socket_t *server, fossil_net_socket_t *client, fossil_net_address_t *addr) {
-    if (!server || !client) return -1;
-
-    struct sockaddr_storage sa;
-    socklen_t salen = sizeof(sa);
+static int fossil__socket_accept(fossil_net_socket_t *server, fossil_net_socket_t *client, struct sockaddr_storage *sa) {
+    socklen_t salen = sizeof(*sa);
 
 #if defined(_WIN32)
     u_long mode = 1;
-    ioctlsocket((SOCKET)server->handle, FIONBIO, &mode); // set non-blocking
-    SOCKET s = accept((SOCKET)server->handle, (struct sockaddr*)&sa, &salen);
-    mode = server->blocking ? 0 : 1;
-    ioctlsocket((SOCKET)server->handle, FIONBIO, &mode); // restore blocking mode
+    ioctlsocket((SOCKET)(intptr_t)server->fd, FIONBIO, &mode); // set non-blocking
+    SOCKET s = accept((SOCKET)(intptr_t)server->fd, (struct sockaddr*)sa, &salen);
+    mode = (server->flags & FOSSIL_NET_SOCKET_FLAG_BLOCKING) ? 0 : 1;
+    ioctlsocket((SOCKET)(intptr_t)server->fd, FIONBIO, &mode); // restore blocking mode
     if (s == INVALID_SOCKET) return -1;
-    client->handle = (void*)s;
+    client->fd = (int32_t)(intptr_t)s;
 #else
-    int flags = fcntl((int)(intptr_t)server->handle, F_GETFL, 0);
-    fcntl((int)(intptr_t)server->handle, F_SETFL, flags | O_NONBLOCK); // set non-blocking
-    int s = accept((int)(intptr_t)server->handle, (struct sockaddr*)&sa, &salen);
-    fcntl((int)(intptr_t)server->handle, F_SETFL, flags); // restore original flags
+    int flags = fcntl(server->fd, F_GETFL, 0);
+    fcntl(server->fd, F_SETFL, flags | O_NONBLOCK); // set non-blocking
+    int s = accept(server->fd, (struct sockaddr*)sa, &salen);
+    fcntl(server->fd, F_SETFL, flags); // restore original flags
     if (s < 0) return -1;
-    client->handle = (void*)(intptr_t)s;
+    client->fd = s;
 #endif
+    client->type = server->type;
+    client->family = server->family;
+    client->flags = FOSSIL_NET_SOCKET_FLAG_BLOCKING | FOSSIL_NET_SOCKET_FLAG_CONNECTED;
+    return 0;
+}
+
+int fossil_net_socket_accept(fossil_net_socket_t *server, fossil_net_socket_t *client, fossil_net_address_t *addr) {
+    if (!server || !client) return -1;
+
+    struct sockaddr_storage sa;
+    if (fossil__socket_accept(server, client, &sa) != 0) return -1;
 
     if (addr) {
-        memset(addr, 0, sizeof(*addr));
-        if (sa.ss_family == AF_INET) {
-            struct sockaddr_in *s4 = (struct sockaddr_in*)&sa;
-            inet_ntop(AF_INET, &s4->sin_addr, addr->ip, sizeof(addr->ip));
-            addr->port = ntohs(s4->sin_port);
-            strncpy(addr->family, "ipv4", sizeof(addr->family)-1);
-        }
-#if defined(AF_INET6)
-        else if (sa.ss_family == AF_INET6) {
-            struct sockaddr_in6 *s6 = (struct sockaddr_in6*)&sa;
-            inet_ntop(AF_INET6, &s6->sin6_addr, addr->ip, sizeof(addr->ip));
-            addr->port = ntohs(s6->sin6_port);
-            strncpy(addr->family, "ipv6", sizeof(addr->family)-1);
-        }
-#endif
+        fossil_net_endpoint_t ep;
+        if (fossil_net_endpoint_from_sockaddr(&ep, &sa) == 0)
+            fossil_net_endpoint_to_address(&ep, addr);
+        else
+            memset(addr, 0, sizeof(*addr));
     }
     return 0;
 }
 
+int fossil_net_socket_accept_endpoint(fossil_net_socket_t *server, fossil_net_socket_t *client, fossil_net_endpoint_t *peer) {
+    if (!server || !client) return -1;
+
+    struct sockaddr_storage sa;
+    if (fossil__socket_accept(server, client, &sa) != 0) return -1;
+
+    if (peer && fossil_net_endpoint_from_sockaddr(peer, &sa) != 0)
+        memset(peer, 0, sizeof(*peer));
+    return 0;
+}
+
 int fossil_net_socket_connect(fossil_net_socket_t *sock, const fossil_net_address_t *addr) {
     if (!sock || !addr) return -1;
-    struct sockaddr_storage sa;
-    socklen_t salen;
+    fossil_net_endpoint_t ep;
+    if (fossil__address_to_endpoint(addr, &ep) != 0) return -1;
+    return fossil_net_socket_connect_endpoint(sock, &ep);
+}
 
-    memset(&sa, 0, sizeof(sa));
-    if (!strcmp(addr->family, "ipv4")) {
-        struct sockaddr_in *s4 = (struct sockaddr_in*)&sa;
-        s4->sin_family = AF_INET;
-        s4->sin_port = htons(addr->port);
-        inet_pton(AF_INET, addr->ip, &s4->sin_addr);
-        salen = sizeof(*s4);
-    } else if (!strcmp(addr->family, "ipv6")) {
-        struct sockaddr_in6 *s6 = (struct sockaddr_in6*)&sa;
-        s6->sin6_family = AF_INET6;
-        s6->sin6_port = htons(addr->port);
-        inet_pton(AF_INET6, addr->ip, &s6->sin6_addr);
-        salen = sizeof(*s6);
-    } else {
-        return -1;
-    }
+int fossil_net_socket_connect_endpoint(fossil_net_socket_t *sock, const fossil_net_endpoint_t *ep) {
+    if (!sock || !ep) return -1;
+    struct sockaddr_storage sa;
+    socklen_t salen = (socklen_t)fossil_net_endpoint_to_sockaddr(ep, &sa);
+    if (salen == 0) return -1;
 
 #if defined(_WIN32)
-    return connect((SOCKET)sock->handle, (struct sockaddr*)&sa, salen);
+    int rc = connect((SOCKET)(intptr_t)sock->fd, (struct sockaddr*)&sa, salen);
 #else
-    return connect((int)(intptr_t)sock->handle, (struct sockaddr*)&sa, salen);
+    int rc = connect(sock->fd, (struct sockaddr*)&sa, salen);
 #endif
+    if (rc == 0) sock->flags |= FOSSIL_NET_SOCKET_FLAG_CONNECTED;
+    return rc;
 }
 
 /*=============================================================================
 DATA TRANSFER
 =============================================================================*/
 
+static void fossil__sleep_ns(uint64_t ns) {
+#if defined(_WIN32)
+    Sleep((DWORD)((ns + 999999) / 1000000));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ull);
+    ts.tv_nsec = (long)(ns % 1000000000ull);
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) { }
+#endif
+}
+
+/*
+ * Wait for (or refuse) rate-limit tokens before a send. On success *size is
+ * clamped to the burst size and *limiter is the bucket that was charged.
+ */
+static int fossil__socket_throttle(const fossil_net_socket_t *sock, uint32_t *size, fossil_net_ratelimit_t **limiter) {
+    fossil__socket_attach_t *att = fossil__attach_get(sock->fd, false);
+    fossil_net_ratelimit_t *lim = att ? atomic_load_explicit(&att->limiter, memory_order_acquire) : NULL;
+    *limiter = lim;
+    if (!lim) return 0;
+
+    uint64_t burst = fossil_net_ratelimit_burst(lim);
+    if (*size > burst) {
+        /* A stream write can be split; a datagram must be charged whole and never fits. */
+        if (sock->type != FOSSIL_NET_SOCKET_TYPE_TCP) {
+#if defined(_WIN32)
+            WSASetLastError(WSAEMSGSIZE);
+#else
+            errno = EMSGSIZE;
+#endif
+            return -1;
+        }
+        *size = (uint32_t)burst;
+    }
+    for (;;) {
+        uint64_t wait = fossil_net_ratelimit_acquire(lim, *size);
+        if (wait == 0) return 0;
+        fossil_net_ratelimit_record_throttle(lim, wait);
+        if (!(sock->flags & FOSSIL_NET_SOCKET_FLAG_BLOCKING)) {
+#if defined(_WIN32)
+            WSASetLastError(WSAEWOULDBLOCK);
+#else
+            errno = EAGAIN;
+#endif
+            return -1;
+        }
+        fossil__sleep_ns(wait);
+    }
+}
+
+/* Copy a completed transfer into the attached pcapng tap. */
+static void fossil__socket_tap(const fossil_net_socket_t *sock, fossil_net_tap_direction_t dir,
+                               const void *data, int len, const fossil_net_endpoint_t *peer) {
+    if (len <= 0) return;
+    fossil__socket_attach_t *att = fossil__attach_get(sock->fd, false);
+    fossil_net_tap_t *tap = att ? atomic_load_explicit(&att->tap, memory_order_acquire) : NULL;
+    if (!tap) return;
+    if (sock->family == FOSSIL_NET_SOCKET_FAMILY_PACKET) {
+        fossil_net_tap_record_frame(tap, dir, data, (uint32_t)len);
+        return;
+    }
+    uint8_t proto = sock->type == FOSSIL_NET_SOCKET_TYPE_TCP ? 6 : sock->type == FOSSIL_NET_SOCKET_TYPE_UDP ? 17 : 0;
+    if (proto)
+        fossil_net_tap_record(tap, dir, proto, &att->tap_local, peer ? peer : &att->tap_remote, data, (uint32_t)len);
+}
+
 int fossil_net_socket_send(fossil_net_socket_t *sock, const void *data, uint32_t size, uint32_t *sent) {
     if (!sock || !data) return -1;
+    fossil_net_ratelimit_t *lim = NULL;
+    if ((sock->flags & FOSSIL_NET_SOCKET_FLAG_RATELIMIT) &&
+        fossil__socket_throttle(sock, &size, &lim) != 0) {
+        if (sent) *sent = 0;
+        return -1;
+    }
 #if defined(_WIN32)
-    int s = send((SOCKET)sock->handle, (const char*)data, size, 0);
+    int s = send((SOCKET)(intptr_t)sock->fd, (const char*)data, size, 0);
 #else
-    int s = send((int)(intptr_t)sock->handle, data, size, 0);
+    int s = send(sock->fd, data, size, 0);
 #endif
+    if (lim && (s < 0 || (uint32_t)s < size))
+        fossil_net_ratelimit_release(lim, size - (s < 0 ? 0 : (uint32_t)s));
+    if (sock->flags & FOSSIL_NET_SOCKET_FLAG_TAP)
+        fossil__socket_tap(sock, FOSSIL_NET_TAP_OUTBOUND, data, s, NULL);
     if (sent) *sent = s < 0 ? 0 : (uint32_t)s;
     return s < 0 ? -1 : 0;
 }
@@ -297,14 +679,64 @@ int fossil_net_socket_send(fossil_net_socket_t *sock, const void *data, uint32_t
 int fossil_net_socket_receive(fossil_net_socket_t *sock, void *buffer, uint32_t size, uint32_t *received) {
     if (!sock || !buffer) return -1;
 #if defined(_WIN32)
-    int r = recv((SOCKET)sock->handle, (char*)buffer, size, 0);
+    int r = recv((SOCKET)(intptr_t)sock->fd, (char*)buffer, size, 0);
 #else
-    int r = recv((int)(intptr_t)sock->handle, buffer, size, 0);
+    int r = recv(sock->fd, buffer, size, 0);
 #endif
+    if (sock->flags & FOSSIL_NET_SOCKET_FLAG_TAP)
+        fossil__socket_tap(sock, FOSSIL_NET_TAP_INBOUND, buffer, r, NULL);
     if (received) *received = r < 0 ? 0 : (uint32_t)r;
     return r < 0 ? -1 : 0;
 }
 
+int fossil_net_socket_send_to(fossil_net_socket_t *sock, const void *data, uint32_t size,
+                              const fossil_net_endpoint_t *to, uint32_t *sent) {
+    if (!sock || !data || !to) return -1;
+    struct sockaddr_storage sa;
+    socklen_t salen = (socklen_t)fossil_net_endpoint_to_sockaddr(to, &sa);
+    if (salen == 0) return -1;
+    fossil_net_ratelimit_t *lim = NULL;
+    if ((sock->flags & FOSSIL_NET_SOCKET_FLAG_RATELIMIT) &&
+        fossil__socket_throttle(sock, &size, &lim) != 0) {
+        if (sent) *sent = 0;
+        return -1;
+    }
+#if defined(_WIN32)
+    int s = sendto((SOCKET)(intptr_t)sock->fd, (const char*)data, size, 0, (struct sockaddr*)&sa, salen);
+#else
+    int s = sendto(sock->fd, data, size, 0, (struct sockaddr*)&sa, salen);
+#endif
+    if (lim && (s < 0 || (uint32_t)s < size))
+        fossil_net_ratelimit_release(lim, size - (s < 0 ? 0 : (uint32_t)s));
+    if (sock->flags & FOSSIL_NET_SOCKET_FLAG_TAP)
+        fossil__socket_tap(sock, FOSSIL_NET_TAP_OUTBOUND, data, s, to);
+    if (sent) *sent = s < 0 ? 0 : (uint32_t)s;
+    return s < 0 ? -1 : 0;
+}
+
+int fossil_net_socket_receive_from(fossil_net_socket_t *sock, void *buffer, uint32_t size,
+                                   uint32_t *received, fossil_net_endpoint_t *from) {
+    if (!sock || !buffer) return -1;
+    struct sockaddr_storage sa;
+    socklen_t salen = sizeof(sa);
+    memset(&sa, 0, sizeof(sa));
+#if defined(_WIN32)
+    int r = recvfrom((SOCKET)(intptr_t)sock->fd, (char*)buffer, size, 0, (struct sockaddr*)&sa, &salen);
+#else
+    int r = recvfrom(sock->fd, buffer, size, 0, (struct sockaddr*)&sa, &salen);
+#endif
+    if (received) *received = r < 0 ? 0 : (uint32_t)r;
+    if (r < 0) return -1;
+    if (from && fossil_net_endpoint_from_sockaddr(from, &sa) != 0)
+        memset(from, 0, sizeof(*from));
+    if (sock->flags & FOSSIL_NET_SOCKET_FLAG_TAP) {
+        fossil_net_endpoint_t peer;
+        if (fossil_net_endpoint_from_sockaddr(&peer, &sa) == 0)
+            fossil__socket_tap(sock, FOSSIL_NET_TAP_INBOUND, buffer, r, &peer);
+    }
+    return 0;
+}
+
 /*=============================================================================
 ADDRESS UTILITIES
 =============================================================================*/
@@ -329,19 +761,15 @@ int fossil_net_socket_address_parse(
     strncpy(addr->ip, ip, sizeof(addr->ip) - 1);
     addr->port = port;
 
-    // Try IPv4 first
-    struct in_addr ipv4;
-    if (inet_pton(AF_INET, ip, &ipv4) == 1) {
-        strncpy(addr->family, "ipv4", sizeof(addr->family) - 1);
+    uint8_t bytes[16];
+    if (fossil_net_inet_ipv4_parse(ip, bytes) == 0) {
+        memcpy(addr->family, "ipv4", 5);
         return 0;
     }
-#if defined(AF_INET6)
-    struct in6_addr ipv6;
-    if (inet_pton(AF_INET6, ip, &ipv6) == 1) {
-        strncpy(addr->family, "ipv6", sizeof(addr->family) - 1);
+    if (fossil_net_inet_ipv6_parse(ip, bytes) == 0) {
+        memcpy(addr->family, "ipv6", 5);
         return 0;
     }
-#endif
     return -1;
 }
 
@@ -354,22 +782,31 @@ int fossil_net_socket_address_to_string(
 
     // Prefer addr->addr if set, otherwise use addr->ip
     const char *ipstr = addr->addr[0] ? addr->addr : addr->ip;
-
-    if (!strcmp(addr->family, "ipv4")) {
-        // IPv4: "x.x.x.x:port"
-        int n = snprintf(buffer, size, "%s:%u", ipstr, addr->port);
-        if (n < 0 || (uint32_t)n >= size) return -1;
-        return 0;
-    }
-#if defined(AF_INET6)
-    else if (!strcmp(addr->family, "ipv6")) {
-        // IPv6: "[addr]:port"
-        int n = snprintf(buffer, size, "[%s]:%u", ipstr, addr->port);
-        if (n < 0 || (uint32_t)n >= size) return -1;
-        return 0;
-    }
-#endif
-    return -1;
+    const char *nul = memchr(ipstr, '\0', sizeof(addr->ip));
+    size_t iplen = nul ? (size_t)(nul - ipstr) : sizeof(addr->ip);
+
+    // IPv4: "x.x.x.x:port", IPv6: "[addr]:port"
+    bool v6;
+    if (!strcmp(addr->family, "ipv4")) v6 = false;
+    else if (!strcmp(addr->family, "ipv6")) v6 = true;
+    else return -1;
+
+    char port[6];
+    uint32_t plen = 0;
+    uint16_t p = addr->port;
+    do { port[plen++] = (char)('0' + p % 10); p /= 10; } while (p);
+
+    size_t total = iplen + (v6 ? 2 : 0) + 1 + plen;
+    if (total >= size) return -1;
+    char *out = buffer;
+    if (v6) *out++ = '[';
+    memcpy(out, ipstr, iplen);
+    out += iplen;
+    if (v6) *out++ = ']';
+    *out++ = ':';
+    while (plen) *out++ = port[--plen];
+    *out = '\0';
+    return 0;
 }
 
 int fossil_net_socket_get_local_address(
@@ -378,39 +815,104 @@ int fossil_net_socket_get_local_address(
 {
     if (!sock || !addr) return -1;
 
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_get_local_endpoint(sock, &ep) != 0)
+        return -1;
+    return fossil_net_endpoint_to_address(&ep, addr);
+}
+
+int fossil_net_socket_get_local_endpoint(
+    fossil_net_socket_t *sock,
+    fossil_net_endpoint_t *ep)
+{
+    if (!sock || !ep) return -1;
+
     struct sockaddr_storage sa;
     socklen_t salen = sizeof(sa);
     memset(&sa, 0, sizeof(sa));
 
 #if defined(_WIN32)
-    int fd = (int)(intptr_t)sock->handle;
+    SOCKET fd = (SOCKET)(intptr_t)sock->fd;
 #else
-    int fd = (int)(intptr_t)sock->handle;
+    int fd = sock->fd;
 #endif
 
     if (getsockname(fd, (struct sockaddr *)&sa, &salen) != 0)
         return -1;
+    return fossil_net_endpoint_from_sockaddr(ep, &sa);
+}
 
-    memset(addr, 0, sizeof(*addr));
-    if (sa.ss_family == AF_INET) {
-        struct sockaddr_in *s4 = (struct sockaddr_in *)&sa;
-        inet_ntop(AF_INET, &s4->sin_addr, addr->ip, sizeof(addr->ip));
-        inet_ntop(AF_INET, &s4->sin_addr, addr->addr, sizeof(addr->addr));
-        addr->port = ntohs(s4->sin_port);
-        strncpy(addr->family, "ipv4", sizeof(addr->family) - 1);
-        return 0;
-    }
-#if defined(AF_INET6)
-    else if (sa.ss_family == AF_INET6) {
-        struct sockaddr_in6 *s6 = (struct sockaddr_in6 *)&sa;
-        inet_ntop(AF_INET6, &s6->sin6_addr, addr->ip, sizeof(addr->ip));
-        inet_ntop(AF_INET6, &s6->sin6_addr, addr->addr, sizeof(addr->addr));
-        addr->port = ntohs(s6->sin6_port);
-        strncpy(addr->family, "ipv6", sizeof(addr->family) - 1);
-        return 0;
+/*=============================================================================
+RATE LIMITING
+=============================================================================*/
+
+int fossil_net_socket_set_ratelimit(fossil_net_socket_t *sock, fossil_net_ratelimit_t *limiter) {
+    if (!sock || sock->fd < 0) return -1;
+    fossil__socket_attach_t *att = fossil__attach_get(sock->fd, limiter != NULL);
+    if (!att) return limiter ? -1 : 0;
+    atomic_store_explicit(&att->limiter, limiter, memory_order_release);
+    if (limiter) sock->flags |= FOSSIL_NET_SOCKET_FLAG_RATELIMIT;
+    else sock->flags &= (uint16_t)~FOSSIL_NET_SOCKET_FLAG_RATELIMIT;
+    return 0;
+}
+
+fossil_net_ratelimit_t *fossil_net_socket_get_ratelimit(const fossil_net_socket_t *sock) {
+    if (!sock || !(sock->flags & FOSSIL_NET_SOCKET_FLAG_RATELIMIT)) return NULL;
+    fossil__socket_attach_t *att = fossil__attach_get(sock->fd, false);
+    return att ? atomic_load_explicit(&att->limiter, memory_order_acquire) : NULL;
+}
+
+int fossil_net_socket_set_pacing_rate(fossil_net_socket_t *sock, uint64_t rate) {
+    if (!sock) return -1;
+#if defined(__linux__) && defined(SO_MAX_PACING_RATE)
+    if (rate != 0 && rate >= UINT32_MAX) {
+        // 64-bit rates are accepted by newer kernels on 64-bit builds
+        if (setsockopt(sock->fd, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)) == 0)
+            return 0;
     }
-#endif
+    uint32_t val = (rate == 0 || rate >= UINT32_MAX) ? ~0u : (uint32_t)rate;
+    if (setsockopt(sock->fd, SOL_SOCKET, SO_MAX_PACING_RATE, &val, sizeof(val)) != 0)
+        return -1;
+    return 0;
+#else
+    (void)rate;
+    // Not supported on this platform
     return -1;
+#endif
+}
+
+/*=============================================================================
+TRAFFIC TAP
+=============================================================================*/
+
+int fossil_net_socket_set_tap(fossil_net_socket_t *sock, fossil_net_tap_t *tap) {
+    if (!sock || sock->fd < 0) return -1;
+    fossil__socket_attach_t *att = fossil__attach_get(sock->fd, tap != NULL);
+    if (!att) return tap ? -1 : 0;
+    if (tap) {
+        // Resolved once so the I/O path only copies; unconnected peers stay empty
+        struct sockaddr_storage sa;
+        socklen_t salen = sizeof(sa);
+        memset(&att->tap_local, 0, sizeof(att->tap_local));
+        memset(&att->tap_remote, 0, sizeof(att->tap_remote));
+        fossil_net_socket_get_local_endpoint(sock, &att->tap_local);
+#if defined(_WIN32)
+        if (getpeername((SOCKET)(intptr_t)sock->fd, (struct sockaddr*)&sa, &salen) == 0)
+#else
+        if (getpeername(sock->fd, (struct sockaddr*)&sa, &salen) == 0)
+#endif
+            fossil_net_endpoint_from_sockaddr(&att->tap_remote, &sa);
+    }
+    atomic_store_explicit(&att->tap, tap, memory_order_release);
+    if (tap) sock->flags |= FOSSIL_NET_SOCKET_FLAG_TAP;
+    else sock->flags &= (uint16_t)~FOSSIL_NET_SOCKET_FLAG_TAP;
+    return 0;
+}
+
+fossil_net_tap_t *fossil_net_socket_get_tap(const fossil_net_socket_t *sock) {
+    if (!sock || !(sock->flags & FOSSIL_NET_SOCKET_FLAG_TAP)) return NULL;
+    fossil__socket_attach_t *att = fossil__attach_get(sock->fd, false);
+    return att ? atomic_load_explicit(&att->tap, memory_order_acquire) : NULL;
 }
 
 /*=============================================================================
@@ -426,6 +928,20 @@ int fossil_net_socket_sleep(uint32_t ms) {
     return 0;
 }
 
+uint64_t fossil_net_socket_clock_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
 /*=============================================================================
 MAC ADDRESS
 =============================================================================*/
@@ -439,8 +955,7 @@ int fossil_net_socket_mac_get(fossil_net_mac_t *mac) {
     adapters = (IP_ADAPTER_ADDRESSES*)malloc(outBufLen);
     if (GetAdaptersAddresses(AF_UNSPEC, 0, NULL, adapters, &outBufLen) != 0) { free(adapters); return -1; }
     memcpy(mac->bytes, adapters->PhysicalAddress, 6);
-    sprintf(mac->string,"%02X:%02X:%02X:%02X:%02X:%02X",
-        mac->bytes[0],mac->bytes[1],mac->bytes[2],mac->bytes[3],mac->bytes[4],mac->bytes[5]);
+    fossil_net_inet_mac_format(mac->bytes, mac->string, sizeof(mac->string));
     free(adapters);
 #else
 #if defined(__linux__)
@@ -451,8 +966,7 @@ int fossil_net_socket_mac_get(fossil_net_mac_t *mac) {
         struct sockaddr_ll *s = (struct sockaddr_ll*)ifa->ifa_addr;
         if (s->sll_halen == 6) {
             memcpy(mac->bytes, s->sll_addr, 6);
-            sprintf(mac->string,"%02X:%02X:%02X:%02X:%02X:%02X",
-                mac->bytes[0],mac->bytes[1],mac->bytes[2],mac->bytes[3],mac->bytes[4],mac->bytes[5]);
+            fossil_net_inet_mac_format(mac->bytes, mac->string, sizeof(mac->string));
             break;
         }
     }
@@ -478,16 +992,8 @@ int fossil_net_socket_mac_parse(
     const char *string)
 {
     if (!mac || !string) return -1;
-    unsigned int b[6];
-    int n = sscanf(string, "%2x:%2x:%2x:%2x:%2x:%2x",
-                   &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]);
-    if (n != 6) return -1;
-    for (int i = 0; i < 6; ++i)
-        mac->bytes[i] = (uint8_t)b[i];
-    snprintf(mac->string, sizeof(mac->string),
-             "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac->bytes[0], mac->bytes[1], mac->bytes[2],
-             mac->bytes[3], mac->bytes[4], mac->bytes[5]);
+    if (fossil_net_inet_mac_parse(string, mac->bytes) != 0) return -1;
+    fossil_net_inet_mac_format(mac->bytes, mac->string, sizeof(mac->string));
     return 0;
 }
 
@@ -509,8 +1015,8 @@ int fossil_net_socket_resolve(const char *hostname, fossil_net_address_t *out_ad
     memset(out_addr, 0, sizeof(*out_addr));
 
     // Try IPv4 first
-    struct in_addr ipv4;
-    if (inet_pton(AF_INET, hostname, &ipv4) == 1) {
+    uint8_t literal[16];
+    if (fossil_net_inet_ipv4_parse(hostname, literal) == 0) {
         strncpy(out_addr->ip, hostname, sizeof(out_addr->ip) - 1);
         strncpy(out_addr->addr, hostname, sizeof(out_addr->addr) - 1);
         out_addr->port = 0;
@@ -518,8 +1024,7 @@ int fossil_net_socket_resolve(const char *hostname, fossil_net_address_t *out_ad
         return 0;
     }
 #if defined(AF_INET6)
-    struct in6_addr ipv6;
-    if (inet_pton(AF_INET6, hostname, &ipv6) == 1) {
+    if (fossil_net_inet_ipv6_parse(hostname, literal) == 0) {
         strncpy(out_addr->ip, hostname, sizeof(out_addr->ip) - 1);
         strncpy(out_addr->addr, hostname, sizeof(out_addr->addr) - 1);
         out_addr->port = 0;
@@ -533,7 +1038,7 @@ int fossil_net_socket_resolve(const char *hostname, fossil_net_address_t *out_ad
     if (he && he->h_addrtype == AF_INET && he->h_length == 4) {
         struct in_addr *addr_in = (struct in_addr *)he->h_addr_list[0];
         if (addr_in) {
-            inet_ntop(AF_INET, addr_in, out_addr->ip, sizeof(out_addr->ip));
+            fossil_net_inet_ipv4_format((const uint8_t *)addr_in, out_addr->ip, sizeof(out_addr->ip));
             strncpy(out_addr->addr, out_addr->ip, sizeof(out_addr->addr) - 1);
             out_addr->addr[sizeof(out_addr->addr) - 1] = '\0';
             out_addr->port = 0;
@@ -562,54 +1067,62 @@ int fossil_net_socket_set_reuseaddr(
     if (!sock) return -1;
     int optval = enabled ? 1 : 0;
 #if defined(_WIN32)
-    if (setsockopt((SOCKET)sock->handle, SOL_SOCKET, SO_REUSEADDR, (const char*)&optval, sizeof(optval)) != 0)
+    if (setsockopt((SOCKET)(intptr_t)sock->fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&optval, sizeof(optval)) != 0)
         return -1;
 #else
-    if (setsockopt((int)(intptr_t)sock->handle, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) != 0)
+    if (setsockopt(sock->fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) != 0)
         return -1;
 #endif
     return 0;
 }
 
+int fossil_net_socket_set_reuseport(
+    fossil_net_socket_t *sock,
+    bool enabled)
+{
+    if (!sock) return -1;
+#if defined(SO_REUSEPORT) && !defined(_WIN32)
+    int optval = enabled ? 1 : 0;
+    if (setsockopt(sock->fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) != 0)
+        return -1;
+    return 0;
+#else
+    (void)enabled;
+    return -1;
+#endif
+}
+
 int fossil_net_socket_get_peer_address(
     fossil_net_socket_t *sock,
     fossil_net_address_t *addr)
 {
     if (!sock || !addr) return -1;
 
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_get_peer_endpoint(sock, &ep) != 0)
+        return -1;
+    return fossil_net_endpoint_to_address(&ep, addr);
+}
+
+int fossil_net_socket_get_peer_endpoint(
+    fossil_net_socket_t *sock,
+    fossil_net_endpoint_t *ep)
+{
+    if (!sock || !ep) return -1;
+
     struct sockaddr_storage sa;
     socklen_t salen = sizeof(sa);
     memset(&sa, 0, sizeof(sa));
 
 #if defined(_WIN32)
-    SOCKET fd = (SOCKET)sock->handle;
+    SOCKET fd = (SOCKET)(intptr_t)sock->fd;
 #else
-    int fd = (int)(intptr_t)sock->handle;
+    int fd = sock->fd;
 #endif
 
     if (getpeername(fd, (struct sockaddr *)&sa, &salen) != 0)
         return -1;
-
-    memset(addr, 0, sizeof(*addr));
-    if (sa.ss_family == AF_INET) {
-        struct sockaddr_in *s4 = (struct sockaddr_in *)&sa;
-        inet_ntop(AF_INET, &s4->sin_addr, addr->ip, sizeof(addr->ip));
-        inet_ntop(AF_INET, &s4->sin_addr, addr->addr, sizeof(addr->addr));
-        addr->port = ntohs(s4->sin_port);
-        strncpy(addr->family, "ipv4", sizeof(addr->family) - 1);
-        return 0;
-    }
-#if defined(AF_INET6)
-    else if (sa.ss_family == AF_INET6) {
-        struct sockaddr_in6 *s6 = (struct sockaddr_in6 *)&sa;
-        inet_ntop(AF_INET6, &s6->sin6_addr, addr->ip, sizeof(addr->ip));
-        inet_ntop(AF_INET6, &s6->sin6_addr, addr->addr, sizeof(addr->addr));
-        addr->port = ntohs(s6->sin6_port);
-        strncpy(addr->family, "ipv6", sizeof(addr->family) - 1);
-        return 0;
-    }
-#endif
-    return -1;
+    return fossil_net_endpoint_from_sockaddr(ep, &sa);
 }
 
 /*=============================================================================
@@ -624,8 +1137,8 @@ int fossil_net_socket_poll(fossil_net_socket_t **sockets, uint32_t count, uint32
     FD_ZERO(&readfds);
     SOCKET max_fd = 0;
     for (uint32_t i=0;i<count;i++) {
-        FD_SET((SOCKET)sockets[i]->handle,&readfds);
-        if ((SOCKET)sockets[i]->handle>max_fd) max_fd = (SOCKET)sockets[i]->handle;
+        FD_SET((SOCKET)(intptr_t)sockets[i]->fd,&readfds);
+        if ((SOCKET)(intptr_t)sockets[i]->fd>max_fd) max_fd = (SOCKET)(intptr_t)sockets[i]->fd;
     }
     struct timeval tv = {timeout_ms/1000, (timeout_ms%1000)*1000};
     int r = select(max_fd+1, &readfds, NULL, NULL, &tv);
@@ -635,7 +1148,7 @@ int fossil_net_socket_poll(fossil_net_socket_t **sockets, uint32_t count, uint32
     FD_ZERO(&readfds);
     int max_fd = 0;
     for (uint32_t i=0;i<count;i++) {
-        int fd = (int)(intptr_t)sockets[i]->handle;
+        int fd = sockets[i]->fd;
         FD_SET(fd,&readfds);
         if (fd>max_fd) max_fd = fd;
     }
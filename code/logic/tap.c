@@ -0,0 +1,565 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/tap.h"
+#include "fossil/network/builder.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+PLATFORM
+=============================================================================*/
+
+#if defined(_WIN32)
+#define FOSSIL__TAP_TLS __declspec(thread)
+typedef HANDLE fossil__tap_thread_t;
+typedef CRITICAL_SECTION fossil__tap_mutex_t;
+#define fossil__tap_mutex_init(m)    InitializeCriticalSection(m)
+#define fossil__tap_mutex_destroy(m) DeleteCriticalSection(m)
+#define fossil__tap_mutex_lock(m)    EnterCriticalSection(m)
+#define fossil__tap_mutex_unlock(m)  LeaveCriticalSection(m)
+#else
+#define FOSSIL__TAP_TLS _Thread_local
+typedef pthread_t fossil__tap_thread_t;
+typedef pthread_mutex_t fossil__tap_mutex_t;
+#define fossil__tap_mutex_init(m)    pthread_mutex_init(m, NULL)
+#define fossil__tap_mutex_destroy(m) pthread_mutex_destroy(m)
+#define fossil__tap_mutex_lock(m)    pthread_mutex_lock(m)
+#define fossil__tap_mutex_unlock(m)  pthread_mutex_unlock(m)
+#endif
+
+static void fossil__tap_sleep_ms(uint32_t ms) {
+#if defined(_WIN32)
+    Sleep(ms);
+#else
+    struct timespec ts = { (time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) { }
+#endif
+}
+
+/* Wall-clock nanoseconds since the Unix epoch, as pcapng expects. */
+static uint64_t fossil__tap_wall_ns(void) {
+#if defined(_WIN32)
+    FILETIME ft;
+    GetSystemTimePreciseAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000ull) * 100u;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/*=============================================================================
+RINGS
+=============================================================================*/
+
+enum {
+    FOSSIL__TAP_PAD = 0,
+    FOSSIL__TAP_PAYLOAD = 1,
+    FOSSIL__TAP_FRAME = 2
+};
+
+typedef struct fossil__tap_rec {
+    uint32_t size;          /* whole record, multiple of 8 */
+    uint8_t kind;
+    uint8_t direction;
+    uint8_t proto;
+    uint8_t reserved;
+    uint64_t ts_ns;
+    uint32_t length;        /* bytes kept */
+    uint32_t orig_length;   /* bytes seen */
+    fossil_net_endpoint_t local;
+    fossil_net_endpoint_t remote;
+} fossil__tap_rec_t;
+
+/*
+ * Single-producer/single-consumer byte ring. head and tail count bytes
+ * forever and are masked on use; each sits on its own cache line so the
+ * recording thread and the writer never share one.
+ */
+typedef struct fossil__tap_ring {
+    _Atomic uint64_t head;
+    char pad0[56];
+    _Atomic uint64_t tail;
+    char pad1[56];
+    _Atomic uint64_t records;
+    const void *owner;      /* address of the owning thread's TLS */
+    uint32_t size;
+    uint8_t *data;
+} fossil__tap_ring_t;
+
+struct fossil_net_tap {
+    uint64_t id;            /* unique, so stale thread-local caches never match */
+    FILE *file;
+    uint32_t ring_size;
+    uint32_t snaplen;
+    uint32_t max_threads;
+    uint64_t flush_ns;
+
+    fossil__tap_mutex_t lock;      /* ring registration only */
+    fossil__tap_ring_t **rings;
+    _Atomic uint32_t ring_count;
+
+    fossil__tap_thread_t thread;
+    _Atomic int stop;
+    _Atomic uint64_t flush_req;
+    _Atomic uint64_t flush_ack;
+
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t packets;
+    _Atomic uint64_t bytes;
+    _Atomic uint64_t write_errors;
+
+    // Writer-only state
+    uint8_t *out;
+    uint32_t out_len;
+    uint64_t last_write_ns;
+    uint8_t *scratch;
+    struct { uint64_t key; uint32_t next_seq; } seq[1024];
+};
+
+#define FOSSIL__TAP_OUT_SIZE  (1u << 20)
+#define FOSSIL__TAP_SEGMENT   65000u    /* payload per synthetic packet */
+#define FOSSIL__TAP_EPB_MAX   (32u + 60u + FOSSIL__TAP_SEGMENT + 20u)
+
+typedef struct fossil__tap_tls_entry {
+    uint64_t tap_id;
+    fossil__tap_ring_t *ring;
+} fossil__tap_tls_entry_t;
+
+static FOSSIL__TAP_TLS fossil__tap_tls_entry_t fossil__tap_tls[4];
+static FOSSIL__TAP_TLS uint32_t fossil__tap_tls_next;
+static _Atomic uint64_t fossil__tap_ids = 1;
+
+static uint32_t fossil__tap_align8(uint32_t v) {
+    return (v + 7u) & ~7u;
+}
+
+static fossil__tap_ring_t *fossil__tap_ring_new(uint32_t size, const void *owner) {
+    fossil__tap_ring_t *r = calloc(1, sizeof(*r));
+    if (!r) return NULL;
+    r->data = malloc(size);
+    if (!r->data) {
+        free(r);
+        return NULL;
+    }
+    r->size = size;
+    r->owner = owner;
+    return r;
+}
+
+/* The calling thread's ring for this tap; registration is the only locked step. */
+static fossil__tap_ring_t *fossil__tap_ring(fossil_net_tap_t *tap) {
+    for (uint32_t i = 0; i < 4; ++i)
+        if (fossil__tap_tls[i].tap_id == tap->id) return fossil__tap_tls[i].ring;
+
+    const void *me = (const void*)fossil__tap_tls;
+    fossil__tap_ring_t *ring = NULL;
+    fossil__tap_mutex_lock(&tap->lock);
+    uint32_t count = atomic_load_explicit(&tap->ring_count, memory_order_relaxed);
+    for (uint32_t i = 0; i < count && !ring; ++i)
+        if (tap->rings[i]->owner == me) ring = tap->rings[i];
+    if (!ring && count < tap->max_threads && (ring = fossil__tap_ring_new(tap->ring_size, me)) != NULL) {
+        tap->rings[count] = ring;
+        atomic_store_explicit(&tap->ring_count, count + 1, memory_order_release);
+    }
+    fossil__tap_mutex_unlock(&tap->lock);
+
+    if (ring) {
+        fossil__tap_tls_entry_t *e = &fossil__tap_tls[fossil__tap_tls_next++ & 3u];
+        e->tap_id = tap->id;
+        e->ring = ring;
+    }
+    return ring;
+}
+
+/* Reserve a contiguous record; returns NULL when the ring is full. */
+static fossil__tap_rec_t *fossil__tap_reserve(fossil__tap_ring_t *r, uint32_t need, uint64_t *head_out) {
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    uint32_t off = (uint32_t)(head % r->size);
+    uint32_t contiguous = r->size - off;
+    if (contiguous < need) {
+        // Pad to the end and start the record at offset 0
+        if (head + contiguous + need - tail > r->size) return NULL;
+        fossil__tap_rec_t *pad = (fossil__tap_rec_t*)(r->data + off);
+        pad->size = contiguous;
+        pad->kind = FOSSIL__TAP_PAD;
+        head += contiguous;
+        off = 0;
+    } else if (head + need - tail > r->size) {
+        return NULL;
+    }
+    *head_out = head + need;
+    return (fossil__tap_rec_t*)(r->data + off);
+}
+
+static int fossil__tap_push(fossil_net_tap_t *tap, uint8_t kind, uint8_t direction, uint8_t proto,
+                            const fossil_net_endpoint_t *local, const fossil_net_endpoint_t *remote,
+                            const void *data, uint32_t length) {
+    fossil__tap_ring_t *r = fossil__tap_ring(tap);
+    uint32_t keep = length < tap->snaplen ? length : tap->snaplen;
+    uint32_t need = fossil__tap_align8((uint32_t)sizeof(fossil__tap_rec_t) + keep);
+    uint64_t head;
+    fossil__tap_rec_t *rec = r && need <= r->size / 2 ? fossil__tap_reserve(r, need, &head) : NULL;
+    if (!rec) {
+        atomic_fetch_add_explicit(&tap->dropped, 1, memory_order_relaxed);
+        return -1;
+    }
+    rec->size = need;
+    rec->kind = kind;
+    rec->direction = direction;
+    rec->proto = proto;
+    rec->reserved = 0;
+    rec->ts_ns = fossil__tap_wall_ns();
+    rec->length = keep;
+    rec->orig_length = length;
+    if (local) rec->local = *local;
+    if (remote) rec->remote = *remote;
+    memcpy(rec + 1, data, keep);
+    atomic_store_explicit(&r->head, head, memory_order_release);
+    atomic_store_explicit(&r->records, atomic_load_explicit(&r->records, memory_order_relaxed) + 1, memory_order_relaxed);
+    return 0;
+}
+
+/*=============================================================================
+PCAPNG WRITER
+=============================================================================*/
+
+#define FOSSIL__PCAPNG_SHB 0x0A0D0D0Au
+#define FOSSIL__PCAPNG_IDB 0x00000001u
+#define FOSSIL__PCAPNG_EPB 0x00000006u
+
+static void fossil__tap_put32(uint8_t *p, uint32_t v) {
+    memcpy(p, &v, 4); // pcapng is written in host order; the SHB magic says which
+}
+
+static void fossil__tap_put16(uint8_t *p, uint16_t v) {
+    memcpy(p, &v, 2);
+}
+
+static void fossil__tap_write_out(fossil_net_tap_t *tap) {
+    if (tap->out_len == 0) return;
+    if (fwrite(tap->out, 1, tap->out_len, tap->file) != tap->out_len)
+        atomic_fetch_add_explicit(&tap->write_errors, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tap->bytes, tap->out_len, memory_order_relaxed);
+    tap->out_len = 0;
+    tap->last_write_ns = fossil_net_socket_clock_ns();
+}
+
+static int fossil__tap_write_headers(fossil_net_tap_t *tap) {
+    uint8_t b[28 + 2 * 32];
+    uint32_t n = 0;
+    // Section header: magic, version 1.0, unknown section length
+    fossil__tap_put32(b + n, FOSSIL__PCAPNG_SHB);
+    fossil__tap_put32(b + n + 4, 28);
+    fossil__tap_put32(b + n + 8, 0x1A2B3C4Du);
+    fossil__tap_put16(b + n + 12, 1);
+    fossil__tap_put16(b + n + 14, 0);
+    memset(b + n + 16, 0xff, 8);
+    fossil__tap_put32(b + n + 24, 28);
+    n += 28;
+    // Interface 0: raw IP, interface 1: Ethernet; both with if_tsresol = 9 (ns)
+    const uint16_t links[2] = { 101, 1 };
+    for (int i = 0; i < 2; ++i) {
+        fossil__tap_put32(b + n, FOSSIL__PCAPNG_IDB);
+        fossil__tap_put32(b + n + 4, 32);
+        fossil__tap_put16(b + n + 8, links[i]);
+        fossil__tap_put16(b + n + 10, 0);
+        fossil__tap_put32(b + n + 12, 0);
+        fossil__tap_put16(b + n + 16, 9);
+        fossil__tap_put16(b + n + 18, 1);
+        b[n + 20] = 9;
+        b[n + 21] = b[n + 22] = b[n + 23] = 0;
+        fossil__tap_put32(b + n + 24, 0); // opt_endofopt
+        fossil__tap_put32(b + n + 28, 32);
+        n += 32;
+    }
+    return fwrite(b, 1, n, tap->file) == n ? 0 : -1;
+}
+
+/* Append an enhanced packet block around len bytes already placed at out + 28. */
+static void fossil__tap_epb(fossil_net_tap_t *tap, uint32_t iface, uint64_t ts, uint32_t len, uint32_t orig, uint8_t direction) {
+    uint8_t *p = tap->out + tap->out_len;
+    uint32_t padded = (len + 3u) & ~3u;
+    uint32_t total = 28 + padded + 12 + 4;
+    memset(p + 28 + len, 0, padded - len);
+    fossil__tap_put32(p, FOSSIL__PCAPNG_EPB);
+    fossil__tap_put32(p + 4, total);
+    fossil__tap_put32(p + 8, iface);
+    fossil__tap_put32(p + 12, (uint32_t)(ts >> 32));
+    fossil__tap_put32(p + 16, (uint32_t)ts);
+    fossil__tap_put32(p + 20, len);
+    fossil__tap_put32(p + 24, orig);
+    uint8_t *o = p + 28 + padded;
+    fossil__tap_put16(o, 2);   // epb_flags: inbound = 1, outbound = 2 in bits 0-1
+    fossil__tap_put16(o + 2, 4);
+    fossil__tap_put32(o + 4, direction);
+    fossil__tap_put32(o + 8, 0);
+    fossil__tap_put32(p + total - 4, total);
+    tap->out_len += total;
+    atomic_fetch_add_explicit(&tap->packets, 1, memory_order_relaxed);
+}
+
+static uint64_t fossil__tap_flow_key(const fossil_net_endpoint_t *src, const fossil_net_endpoint_t *dst) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    const uint8_t *parts[2] = { (const uint8_t*)src, (const uint8_t*)dst };
+    for (int k = 0; k < 2; ++k)
+        for (size_t i = 0; i < sizeof(fossil_net_endpoint_t); ++i)
+            h = (h ^ parts[k][i]) * 0x100000001b3ull;
+    return h | 1u;
+}
+
+/* Writer-side TCP sequence per direction so analyzers see a coherent stream. */
+static uint32_t *fossil__tap_seq(fossil_net_tap_t *tap, uint64_t key, int create) {
+    uint32_t i = (uint32_t)(key % 1024u);
+    if (tap->seq[i].key != key) {
+        if (!create) return NULL;
+        tap->seq[i].key = key;
+        tap->seq[i].next_seq = 1;
+    }
+    return &tap->seq[i].next_seq;
+}
+
+static void fossil__tap_emit_payload(fossil_net_tap_t *tap, const fossil__tap_rec_t *rec) {
+    const fossil_net_endpoint_t *src = rec->direction == FOSSIL_NET_TAP_OUTBOUND ? &rec->local : &rec->remote;
+    const fossil_net_endpoint_t *dst = rec->direction == FOSSIL_NET_TAP_OUTBOUND ? &rec->remote : &rec->local;
+    const uint8_t *data = (const uint8_t*)(rec + 1);
+    uint32_t left = rec->length;
+    uint32_t missing = rec->orig_length - rec->length;
+    uint64_t key = fossil__tap_flow_key(src, dst);
+
+    do {
+        uint32_t chunk = left < FOSSIL__TAP_SEGMENT ? left : FOSSIL__TAP_SEGMENT;
+        if (tap->out_len + FOSSIL__TAP_EPB_MAX > FOSSIL__TAP_OUT_SIZE) fossil__tap_write_out(tap);
+
+        fossil_net_builder_t b;
+        uint32_t len = 0;
+        fossil_net_builder_init(&b, tap->out + tap->out_len + 28, FOSSIL__TAP_EPB_MAX - 44);
+        if (fossil_net_builder_ip(&b, src, dst, rec->proto, 64) != 0) return;
+        if (rec->proto == 6) {
+            uint32_t *seq = fossil__tap_seq(tap, key, 1);
+            uint32_t *ack = fossil__tap_seq(tap, fossil__tap_flow_key(dst, src), 0);
+            fossil_net_builder_tcp(&b, src->port, dst->port, *seq, ack ? *ack : 0,
+                                   FOSSIL_NET_BUILDER_TCP_PSH | FOSSIL_NET_BUILDER_TCP_ACK, 65535);
+            *seq += chunk + (left == chunk ? missing : 0);
+        } else {
+            fossil_net_builder_udp(&b, src->port, dst->port);
+        }
+        fossil_net_builder_payload(&b, data, chunk);
+        fossil_net_builder_finish(&b, &len);
+        // Bytes beyond the snaplen were seen but not kept
+        fossil__tap_epb(tap, 0, rec->ts_ns, len, len + (left == chunk ? missing : 0), rec->direction);
+        data += chunk;
+        left -= chunk;
+    } while (left > 0);
+}
+
+static void fossil__tap_emit_frame(fossil_net_tap_t *tap, const fossil__tap_rec_t *rec) {
+    if (tap->out_len + 44 + fossil__tap_align8(rec->length) > FOSSIL__TAP_OUT_SIZE) fossil__tap_write_out(tap);
+    if (44 + rec->length > FOSSIL__TAP_OUT_SIZE) return;
+    memcpy(tap->out + tap->out_len + 28, rec + 1, rec->length);
+    fossil__tap_epb(tap, 1, rec->ts_ns, rec->length, rec->orig_length, rec->direction);
+}
+
+static uint32_t fossil__tap_drain(fossil_net_tap_t *tap) {
+    uint32_t handled = 0;
+    uint32_t count = atomic_load_explicit(&tap->ring_count, memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+        fossil__tap_ring_t *r = tap->rings[i];
+        uint64_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        while (tail != head) {
+            const fossil__tap_rec_t *rec = (const fossil__tap_rec_t*)(r->data + tail % r->size);
+            if (rec->kind == FOSSIL__TAP_PAYLOAD) fossil__tap_emit_payload(tap, rec);
+            else if (rec->kind == FOSSIL__TAP_FRAME) fossil__tap_emit_frame(tap, rec);
+            if (rec->kind != FOSSIL__TAP_PAD) handled++;
+            tail += rec->size;
+            atomic_store_explicit(&r->tail, tail, memory_order_release);
+        }
+    }
+    return handled;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI fossil__tap_main(LPVOID arg)
+#else
+static void *fossil__tap_main(void *arg)
+#endif
+{
+    fossil_net_tap_t *tap = arg;
+    for (;;) {
+        uint64_t req = atomic_load(&tap->flush_req);
+        int stopping = atomic_load(&tap->stop);
+        uint32_t handled = fossil__tap_drain(tap);
+
+        uint64_t now = fossil_net_socket_clock_ns();
+        if (tap->out_len && (req != atomic_load_explicit(&tap->flush_ack, memory_order_relaxed) ||
+                             stopping || now - tap->last_write_ns >= tap->flush_ns))
+            fossil__tap_write_out(tap);
+        if (req != atomic_load_explicit(&tap->flush_ack, memory_order_relaxed)) {
+            if (fflush(tap->file) != 0) atomic_fetch_add_explicit(&tap->write_errors, 1, memory_order_relaxed);
+            atomic_store(&tap->flush_ack, req);
+        }
+        if (stopping && handled == 0) break;
+        if (handled == 0) fossil__tap_sleep_ms(1);
+    }
+    fossil__tap_write_out(tap);
+    fflush(tap->file);
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+fossil_net_tap_t *fossil_net_tap_create(const char *path, const fossil_net_tap_config_t *config) {
+    if (!path) return NULL;
+    fossil_net_tap_config_t cfg = { 1u << 20, 65535, 64, 200 };
+    if (config) {
+        if (config->ring_size) cfg.ring_size = config->ring_size;
+        if (config->snaplen) cfg.snaplen = config->snaplen;
+        if (config->max_threads) cfg.max_threads = config->max_threads;
+        if (config->flush_ms) cfg.flush_ms = config->flush_ms;
+    }
+    cfg.ring_size = fossil__tap_align8(cfg.ring_size);
+    if (cfg.ring_size < 4096) cfg.ring_size = 4096;
+    if (cfg.snaplen > cfg.ring_size / 2 - sizeof(fossil__tap_rec_t)) cfg.snaplen = cfg.ring_size / 2 - (uint32_t)sizeof(fossil__tap_rec_t);
+
+    fossil_net_tap_t *tap = calloc(1, sizeof(*tap));
+    if (!tap) return NULL;
+    tap->id = atomic_fetch_add(&fossil__tap_ids, 1);
+    tap->ring_size = cfg.ring_size;
+    tap->snaplen = cfg.snaplen;
+    tap->max_threads = cfg.max_threads;
+    tap->flush_ns = (uint64_t)cfg.flush_ms * 1000000u;
+    tap->rings = calloc(cfg.max_threads, sizeof(*tap->rings));
+    tap->out = malloc(FOSSIL__TAP_OUT_SIZE);
+    tap->file = fopen(path, "wb");
+    if (!tap->rings || !tap->out || !tap->file || fossil__tap_write_headers(tap) != 0) {
+        if (tap->file) fclose(tap->file);
+        free(tap->rings);
+        free(tap->out);
+        free(tap);
+        return NULL;
+    }
+    fossil__tap_mutex_init(&tap->lock);
+    tap->last_write_ns = fossil_net_socket_clock_ns();
+
+#if defined(_WIN32)
+    tap->thread = CreateThread(NULL, 0, fossil__tap_main, tap, 0, NULL);
+    int started = tap->thread != NULL;
+#else
+    int started = pthread_create(&tap->thread, NULL, fossil__tap_main, tap) == 0;
+#endif
+    if (!started) {
+        fossil__tap_mutex_destroy(&tap->lock);
+        fclose(tap->file);
+        free(tap->rings);
+        free(tap->out);
+        free(tap);
+        return NULL;
+    }
+    return tap;
+}
+
+void fossil_net_tap_destroy(fossil_net_tap_t *tap) {
+    if (!tap) return;
+    atomic_store(&tap->stop, 1);
+#if defined(_WIN32)
+    WaitForSingleObject(tap->thread, INFINITE);
+    CloseHandle(tap->thread);
+#else
+    pthread_join(tap->thread, NULL);
+#endif
+    uint32_t count = atomic_load(&tap->ring_count);
+    for (uint32_t i = 0; i < count; ++i) {
+        free(tap->rings[i]->data);
+        free(tap->rings[i]);
+    }
+    fossil__tap_mutex_destroy(&tap->lock);
+    fclose(tap->file);
+    free(tap->rings);
+    free(tap->out);
+    free(tap);
+}
+
+int fossil_net_tap_flush(fossil_net_tap_t *tap) {
+    if (!tap) return -1;
+    uint64_t req = atomic_fetch_add(&tap->flush_req, 1) + 1;
+    while (atomic_load(&tap->flush_ack) < req) fossil__tap_sleep_ms(1);
+    return atomic_load_explicit(&tap->write_errors, memory_order_relaxed) ? -1 : 0;
+}
+
+/*=============================================================================
+RECORDING
+=============================================================================*/
+
+int fossil_net_tap_record(fossil_net_tap_t *tap, fossil_net_tap_direction_t direction, uint8_t proto,
+                          const fossil_net_endpoint_t *local, const fossil_net_endpoint_t *remote,
+                          const void *data, uint32_t length) {
+    if (!tap || !local || !remote || (!data && length)) return -1;
+    if ((proto != 6 && proto != 17) || local->family != remote->family ||
+        (local->family != FOSSIL_NET_SOCKET_FAMILY_IPV4 && local->family != FOSSIL_NET_SOCKET_FAMILY_IPV6)) {
+        atomic_fetch_add_explicit(&tap->dropped, 1, memory_order_relaxed);
+        return -1;
+    }
+    return fossil__tap_push(tap, FOSSIL__TAP_PAYLOAD, (uint8_t)direction, proto, local, remote, data, length);
+}
+
+int fossil_net_tap_record_frame(fossil_net_tap_t *tap, fossil_net_tap_direction_t direction, const void *frame, uint32_t length) {
+    if (!tap || !frame || length == 0) return -1;
+    return fossil__tap_push(tap, FOSSIL__TAP_FRAME, (uint8_t)direction, 0, NULL, NULL, frame, length);
+}
+
+int fossil_net_tap_get_stats(fossil_net_tap_t *tap, fossil_net_tap_stats_t *stats) {
+    if (!tap || !stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    uint32_t count = atomic_load_explicit(&tap->ring_count, memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i)
+        stats->records += atomic_load_explicit(&tap->rings[i]->records, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&tap->dropped, memory_order_relaxed);
+    stats->packets = atomic_load_explicit(&tap->packets, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&tap->bytes, memory_order_relaxed);
+    stats->write_errors = atomic_load_explicit(&tap->write_errors, memory_order_relaxed);
+    return 0;
+}
@@ -0,0 +1,509 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+// Must be defined before any system header to expose pread & MSG_MORE.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/writeq.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*=============================================================================
+PLATFORM
+=============================================================================*/
+
+#if defined(_WIN32)
+typedef WSABUF fossil__wq_iov_t;
+#define FOSSIL__WQ_IOV_SET(v, p, n) ((v).buf = (CHAR *)(p), (v).len = (ULONG)(n))
+#else
+typedef struct iovec fossil__wq_iov_t;
+#define FOSSIL__WQ_IOV_SET(v, p, n) ((v).iov_base = (void *)(p), (v).iov_len = (size_t)(n))
+#endif
+
+#if defined(MSG_NOSIGNAL)
+#define FOSSIL__WQ_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define FOSSIL__WQ_SEND_FLAGS 0
+#endif
+
+/* Headers followed by a file body: let the kernel pack them together. */
+#if defined(MSG_MORE)
+#define FOSSIL__WQ_MORE_FLAG MSG_MORE
+#else
+#define FOSSIL__WQ_MORE_FLAG 0
+#endif
+
+#define FOSSIL__WQ_IOV_MAX     64u  /* segments per gathered send */
+#define FOSSIL__WQ_HIGH        (1ull << 20)
+#define FOSSIL__WQ_BLOCK       (16u * 1024u)
+#define FOSSIL__WQ_MIN_SEGS    8u
+#define FOSSIL__WQ_FILE_SEG    (1u << 30) /* file ranges are split to fit a segment */
+#define FOSSIL__WQ_BOUNCE      (16u * 1024u)
+
+static bool fossil__wq_would_block(void) {
+#if defined(_WIN32)
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+/*=============================================================================
+INTERNAL STATE
+=============================================================================*/
+
+#define FOSSIL__BUF_INLINE 0x1u /* storage follows the header */
+#define FOSSIL__BUF_BLOCK  0x2u /* copy block private to one queue */
+
+struct fossil_net_buf {
+    atomic_uint refs;
+    uint32_t flags;
+    uint32_t size;
+    uint32_t capacity;
+    uint8_t *data;
+    fossil_net_buf_free_fn free_fn;
+    void *ctx;
+};
+
+typedef struct fossil__wq_seg {
+    fossil_net_buf_t *buf;      /* data, or the owner of fd */
+    uint32_t offset;
+    uint32_t len;
+    int32_t fd;                 /* -1 for memory segments */
+    uint64_t file_off;
+} fossil__wq_seg_t;
+
+struct fossil_net_writeq {
+    fossil_net_socket_t *sock;
+    fossil__wq_seg_t *segs;  /* ring, capacity is a power of two */
+    uint32_t cap;
+    uint32_t head;
+    uint32_t count;
+    bool above;
+    bool failed;
+    uint64_t high;
+    uint64_t low;
+    uint64_t limit;
+    uint32_t block_size;
+    fossil_net_writeq_watermark_fn fn;
+    void *arg;
+    fossil_net_writeq_stats_t stats; /* pending doubles as the byte count */
+};
+
+/*=============================================================================
+BUFFERS
+=============================================================================*/
+
+fossil_net_buf_t *fossil_net_buf_create(uint32_t capacity) {
+    fossil_net_buf_t *b = malloc(sizeof(*b) + capacity);
+    if (!b) return NULL;
+    atomic_init(&b->refs, 1);
+    b->flags = FOSSIL__BUF_INLINE;
+    b->size = 0;
+    b->capacity = capacity;
+    b->data = (uint8_t *)(b + 1);
+    b->free_fn = NULL;
+    b->ctx = NULL;
+    return b;
+}
+
+fossil_net_buf_t *fossil_net_buf_wrap(const void *data, uint32_t size, fossil_net_buf_free_fn free_fn, void *ctx) {
+    if (!data && size) return NULL;
+    fossil_net_buf_t *b = malloc(sizeof(*b));
+    if (!b) return NULL;
+    atomic_init(&b->refs, 1);
+    b->flags = 0;
+    b->size = size;
+    b->capacity = size;
+    b->data = (uint8_t *)data;
+    b->free_fn = free_fn;
+    b->ctx = ctx;
+    return b;
+}
+
+fossil_net_buf_t *fossil_net_buf_ref(fossil_net_buf_t *buf) {
+    if (buf) atomic_fetch_add_explicit(&buf->refs, 1, memory_order_relaxed);
+    return buf;
+}
+
+void fossil_net_buf_unref(fossil_net_buf_t *buf) {
+    if (!buf || atomic_fetch_sub_explicit(&buf->refs, 1, memory_order_acq_rel) != 1) return;
+    if (buf->free_fn) buf->free_fn(buf->data, buf->ctx);
+    free(buf);
+}
+
+void *fossil_net_buf_data(fossil_net_buf_t *buf) {
+    return buf ? buf->data : NULL;
+}
+
+uint32_t fossil_net_buf_size(const fossil_net_buf_t *buf) {
+    return buf ? buf->size : 0;
+}
+
+int fossil_net_buf_set_size(fossil_net_buf_t *buf, uint32_t size) {
+    if (!buf || !(buf->flags & FOSSIL__BUF_INLINE) || size > buf->capacity) return -1;
+    buf->size = size;
+    return 0;
+}
+
+/*=============================================================================
+SEND PATH
+=============================================================================*/
+
+/*
+ * One gathered send. Returns 0 with *sent set, 1 if the socket is full,
+ * -1 on error. Rate-limited or tapped sockets go through
+ * fossil_net_socket_send with the first segment only.
+ */
+static int fossil__wq_sendv(fossil_net_writeq_t *q, const fossil__wq_iov_t *iov, uint32_t n, bool more, uint32_t *sent) {
+    *sent = 0;
+    if (q->sock->flags & (FOSSIL_NET_SOCKET_FLAG_RATELIMIT | FOSSIL_NET_SOCKET_FLAG_TAP)) {
+#if defined(_WIN32)
+        if (fossil_net_socket_send(q->sock, iov[0].buf, (uint32_t)iov[0].len, sent) == 0) return 0;
+#else
+        if (fossil_net_socket_send(q->sock, iov[0].iov_base, (uint32_t)iov[0].iov_len, sent) == 0) return 0;
+#endif
+        return fossil__wq_would_block() ? 1 : -1;
+    }
+#if defined(_WIN32)
+    (void)more;
+    DWORD s = 0;
+    if (WSASend((SOCKET)(intptr_t)q->sock->fd, (LPWSABUF)iov, n, &s, 0, NULL, NULL) != 0)
+        return fossil__wq_would_block() ? 1 : -1;
+#else
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec *)iov;
+    msg.msg_iovlen = n;
+    ssize_t s = sendmsg(q->sock->fd, &msg, FOSSIL__WQ_SEND_FLAGS | (more ? FOSSIL__WQ_MORE_FLAG : 0));
+    if (s < 0) return fossil__wq_would_block() ? 1 : -1;
+#endif
+    *sent = (uint32_t)s;
+    return 0;
+}
+
+/* Write straight to the socket; used while nothing is queued. */
+static int fossil__wq_direct(fossil_net_writeq_t *q, const uint8_t *data, uint32_t size, uint32_t *sent) {
+    fossil__wq_iov_t iov;
+    FOSSIL__WQ_IOV_SET(iov, data, size);
+    if (fossil__wq_sendv(q, &iov, 1, false, sent) < 0) {
+        q->failed = true;
+        return -1;
+    }
+    q->stats.direct += *sent;
+    return 0;
+}
+
+/*
+ * Send from a file at an absolute offset; same returns as
+ * fossil__wq_sendv. sendfile(2) where available, otherwise (and for
+ * rate-limited or tapped sockets) a bounce through a stack buffer.
+ */
+static int fossil__wq_sendfile(fossil_net_writeq_t *q, int32_t fd, uint64_t off, uint32_t len, uint32_t *sent) {
+    *sent = 0;
+#if defined(__linux__)
+    if (!(q->sock->flags & (FOSSIL_NET_SOCKET_FLAG_RATELIMIT | FOSSIL_NET_SOCKET_FLAG_TAP))) {
+        off_t o = (off_t)off;
+        ssize_t s = sendfile(q->sock->fd, fd, &o, len);
+        if (s < 0) return fossil__wq_would_block() ? 1 : -1;
+        if (s == 0) return -1; /* file shrank under us */
+        *sent = (uint32_t)s;
+        return 0;
+    }
+#endif
+    uint8_t tmp[FOSSIL__WQ_BOUNCE];
+    uint32_t n = len < sizeof(tmp) ? len : (uint32_t)sizeof(tmp);
+#if defined(_WIN32)
+    if (_lseeki64(fd, (__int64)off, SEEK_SET) < 0) return -1;
+    int r = _read(fd, tmp, n);
+#else
+    ssize_t r = pread(fd, tmp, n, (off_t)off);
+#endif
+    if (r <= 0) return -1;
+    fossil__wq_iov_t iov;
+    FOSSIL__WQ_IOV_SET(iov, tmp, (uint32_t)r);
+    return fossil__wq_sendv(q, &iov, 1, false, sent);
+}
+
+/*=============================================================================
+SEGMENTS
+=============================================================================*/
+
+static inline fossil__wq_seg_t *fossil__wq_at(fossil_net_writeq_t *q, uint32_t i) {
+    return &q->segs[(q->head + i) & (q->cap - 1u)];
+}
+
+static int fossil__wq_reserve(fossil_net_writeq_t *q) {
+    if (q->count < q->cap) return 0;
+    uint32_t cap = q->cap ? q->cap * 2u : FOSSIL__WQ_MIN_SEGS;
+    fossil__wq_seg_t *segs = malloc((size_t)cap * sizeof(*segs));
+    if (!segs) return -1;
+    for (uint32_t i = 0; i < q->count; i++)
+        segs[i] = *fossil__wq_at(q, i);
+    free(q->segs);
+    q->segs = segs;
+    q->cap = cap;
+    q->head = 0;
+    return 0;
+}
+
+static void fossil__wq_grew(fossil_net_writeq_t *q, uint32_t size) {
+    q->stats.pending += size;
+    if (q->stats.pending > q->stats.peak) q->stats.peak = q->stats.pending;
+    if (!q->above && q->stats.pending >= q->high) {
+        q->above = true;
+        q->stats.high_events++;
+        if (q->fn) q->fn(q, true, q->arg);
+    }
+}
+
+static bool fossil__wq_admit(fossil_net_writeq_t *q, uint32_t size) {
+    if (q->limit && q->stats.pending + size > q->limit) {
+        q->stats.rejected++;
+        return false;
+    }
+    return true;
+}
+
+/*=============================================================================
+LIFECYCLE
+=============================================================================*/
+
+fossil_net_writeq_t *fossil_net_writeq_create(fossil_net_socket_t *sock, const fossil_net_writeq_config_t *config,
+                                              fossil_net_writeq_watermark_fn fn, void *arg) {
+    if (!sock) return NULL;
+    fossil_net_writeq_t *q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    fossil_net_writeq_config_t cfg = {0};
+    if (config) cfg = *config;
+    q->sock = sock;
+    q->high = cfg.high_watermark ? cfg.high_watermark : FOSSIL__WQ_HIGH;
+    q->low = cfg.low_watermark ? cfg.low_watermark : q->high / 4u;
+    if (q->low >= q->high) q->low = q->high - 1u;
+    q->limit = cfg.limit;
+    q->block_size = cfg.block_size ? cfg.block_size : FOSSIL__WQ_BLOCK;
+    q->fn = fn;
+    q->arg = arg;
+    return q;
+}
+
+void fossil_net_writeq_destroy(fossil_net_writeq_t *queue) {
+    if (!queue) return;
+    for (uint32_t i = 0; i < queue->count; i++)
+        fossil_net_buf_unref(fossil__wq_at(queue, i)->buf);
+    free(queue->segs);
+    free(queue);
+}
+
+/*=============================================================================
+WRITING
+=============================================================================*/
+
+int fossil_net_writeq_write(fossil_net_writeq_t *queue, const void *data, uint32_t size) {
+    if (!queue || (!data && size) || queue->failed) return -1;
+    if (size == 0) return 0;
+    if (!fossil__wq_admit(queue, size)) return -1;
+    const uint8_t *p = data;
+    queue->stats.written += size;
+    if (queue->count == 0) {
+        uint32_t sent;
+        if (fossil__wq_direct(queue, p, size, &sent) != 0) return -1;
+        p += sent;
+        size -= sent;
+    }
+    while (size) {
+        fossil__wq_seg_t *tail = queue->count ? fossil__wq_at(queue, queue->count - 1u) : NULL;
+        if (!tail || !(tail->buf->flags & FOSSIL__BUF_BLOCK) || tail->buf->size == tail->buf->capacity) {
+            if (fossil__wq_reserve(queue) != 0) return -1;
+            fossil_net_buf_t *b = fossil_net_buf_create(size > queue->block_size ? size : queue->block_size);
+            if (!b) return -1;
+            b->flags |= FOSSIL__BUF_BLOCK;
+            tail = fossil__wq_at(queue, queue->count++);
+            tail->buf = b;
+            tail->offset = 0;
+            tail->len = 0;
+            tail->fd = -1;
+        }
+        /* Blocks are appended to only at the tail, so size is the segment end. */
+        uint32_t room = tail->buf->capacity - tail->buf->size;
+        uint32_t n = size < room ? size : room;
+        memcpy(tail->buf->data + tail->buf->size, p, n);
+        tail->buf->size += n;
+        tail->len += n;
+        fossil__wq_grew(queue, n);
+        p += n;
+        size -= n;
+    }
+    return 0;
+}
+
+int fossil_net_writeq_append(fossil_net_writeq_t *queue, fossil_net_buf_t *buf, uint32_t offset, uint32_t size) {
+    if (!queue || !buf || queue->failed || offset > buf->size || size > buf->size - offset) return -1;
+    if (size == 0) return 0;
+    if (!fossil__wq_admit(queue, size)) return -1;
+    queue->stats.written += size;
+    if (queue->count == 0) {
+        uint32_t sent;
+        if (fossil__wq_direct(queue, buf->data + offset, size, &sent) != 0) return -1;
+        offset += sent;
+        size -= sent;
+        if (size == 0) return 0;
+    }
+    if (fossil__wq_reserve(queue) != 0) return -1;
+    fossil__wq_seg_t *seg = fossil__wq_at(queue, queue->count++);
+    seg->buf = fossil_net_buf_ref(buf);
+    seg->offset = offset;
+    seg->len = size;
+    seg->fd = -1;
+    fossil__wq_grew(queue, size);
+    return 0;
+}
+
+int fossil_net_writeq_append_file(fossil_net_writeq_t *queue, fossil_net_buf_t *owner, int32_t fd, uint64_t offset, uint64_t size) {
+    if (!queue || fd < 0 || queue->failed) return -1;
+    if (size == 0) return 0;
+    queue->stats.written += size;
+    if (queue->count == 0) {
+        uint32_t sent;
+        uint32_t n = size < FOSSIL__WQ_FILE_SEG ? (uint32_t)size : FOSSIL__WQ_FILE_SEG;
+        if (fossil__wq_sendfile(queue, fd, offset, n, &sent) < 0) {
+            queue->failed = true;
+            return -1;
+        }
+        queue->stats.direct += sent;
+        queue->stats.file_bytes += sent;
+        offset += sent;
+        size -= sent;
+    }
+    while (size) {
+        if (fossil__wq_reserve(queue) != 0) return -1;
+        uint32_t n = size < FOSSIL__WQ_FILE_SEG ? (uint32_t)size : FOSSIL__WQ_FILE_SEG;
+        fossil__wq_seg_t *seg = fossil__wq_at(queue, queue->count++);
+        seg->buf = fossil_net_buf_ref(owner);
+        seg->offset = 0;
+        seg->len = n;
+        seg->fd = fd;
+        seg->file_off = offset;
+        fossil__wq_grew(queue, n);
+        offset += n;
+        size -= n;
+    }
+    return 0;
+}
+
+int fossil_net_writeq_flush(fossil_net_writeq_t *queue) {
+    if (!queue || queue->failed) return -1;
+    int rc;
+    while (queue->count) {
+        fossil__wq_seg_t *first = fossil__wq_at(queue, 0);
+        uint64_t want = 0;
+        uint32_t sent;
+        queue->stats.syscalls++;
+        if (first->fd >= 0) {
+            want = first->len;
+            rc = fossil__wq_sendfile(queue, first->fd, first->file_off, first->len, &sent);
+            if (rc == 0) queue->stats.file_bytes += sent;
+        } else {
+            /* Gather memory segments up to the next file segment. */
+            fossil__wq_iov_t iov[FOSSIL__WQ_IOV_MAX];
+            uint32_t n = 0;
+            bool more = false;
+            while (n < queue->count && n < FOSSIL__WQ_IOV_MAX) {
+                fossil__wq_seg_t *seg = fossil__wq_at(queue, n);
+                if (seg->fd >= 0) {
+                    more = true;
+                    break;
+                }
+                FOSSIL__WQ_IOV_SET(iov[n], seg->buf->data + seg->offset, seg->len);
+                want += seg->len;
+                n++;
+            }
+            rc = fossil__wq_sendv(queue, iov, n, more, &sent);
+        }
+        if (rc < 0) {
+            queue->failed = true;
+            return -1;
+        }
+        /* A short send means the socket buffer is full; skip the EAGAIN round trip. */
+        if (sent < want) rc = 1;
+        queue->stats.sent += sent;
+        queue->stats.pending -= sent;
+        while (sent) {
+            fossil__wq_seg_t *seg = fossil__wq_at(queue, 0);
+            if (sent < seg->len) {
+                if (seg->fd >= 0) seg->file_off += sent;
+                else seg->offset += sent;
+                seg->len -= sent;
+                break;
+            }
+            sent -= seg->len;
+            fossil_net_buf_unref(seg->buf);
+            queue->head = (queue->head + 1u) & (queue->cap - 1u);
+            queue->count--;
+        }
+        if (rc == 1) break;
+    }
+    if (queue->above && queue->stats.pending <= queue->low) {
+        queue->above = false;
+        queue->stats.low_events++;
+        if (queue->fn) queue->fn(queue, false, queue->arg);
+    }
+    return queue->count ? 1 : 0;
+}
+
+uint64_t fossil_net_writeq_pending(const fossil_net_writeq_t *queue) {
+    return queue ? queue->stats.pending : 0;
+}
+
+bool fossil_net_writeq_is_above(const fossil_net_writeq_t *queue) {
+    return queue && queue->above;
+}
+
+int fossil_net_writeq_get_stats(const fossil_net_writeq_t *queue, fossil_net_writeq_stats_t *stats) {
+    if (!queue || !stats) return -1;
+    *stats = queue->stats;
+    return 0;
+}
@@ -0,0 +1,198 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include "fossil/network/zerocopy.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__linux__) && !defined(TCP_ZEROCOPY_RECEIVE)
+#define TCP_ZEROCOPY_RECEIVE 35
+#endif
+
+#define FOSSIL__ZC_DEFAULT_WINDOW (256u * 1024u)
+#define FOSSIL__ZC_DEFAULT_COPY   (64u * 1024u)
+
+/*
+ * Leading fields of the kernel's struct tcp_zerocopy_receive. Declared here
+ * so the build does not depend on the installed kernel headers; 4.18 only
+ * knows the first three fields and insists on that exact size.
+ */
+typedef struct fossil__tcp_zc {
+    uint64_t address;
+    uint32_t length;
+    uint32_t recv_skip_hint;
+    uint32_t inq;
+    int32_t err;
+} fossil__tcp_zc_t;
+
+struct fossil_net_zerocopy {
+    fossil_net_socket_t *sock;
+    uint8_t *window;      /* NULL when only copying */
+    uint32_t window_len;
+    uint32_t optlen;      /* sizeof(fossil__tcp_zc_t) or the 4.18 size */
+    uint8_t *copy;
+    uint32_t copy_len;
+    fossil_net_zerocopy_stats_t stats;
+};
+
+fossil_net_zerocopy_t *fossil_net_zerocopy_create(fossil_net_socket_t *sock, uint32_t window, uint32_t copy_size) {
+    if (!sock || sock->fd < 0 || sock->type != FOSSIL_NET_SOCKET_TYPE_TCP) return NULL;
+    fossil_net_zerocopy_t *zc = calloc(1, sizeof(*zc));
+    if (!zc) return NULL;
+    zc->sock = sock;
+    zc->copy_len = copy_size ? copy_size : FOSSIL__ZC_DEFAULT_COPY;
+    zc->copy = malloc(zc->copy_len);
+    if (!zc->copy) {
+        free(zc);
+        return NULL;
+    }
+    zc->optlen = (uint32_t)sizeof(fossil__tcp_zc_t);
+
+#if defined(__linux__)
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) page = 4096;
+    uint64_t len = window ? window : FOSSIL__ZC_DEFAULT_WINDOW;
+    len = (len + (uint64_t)page - 1) / (uint64_t)page * (uint64_t)page;
+    if (len <= UINT32_MAX) {
+        void *map = mmap(NULL, (size_t)len, PROT_READ, MAP_SHARED, sock->fd, 0);
+        if (map != MAP_FAILED) {
+            zc->window = map;
+            zc->window_len = (uint32_t)len;
+        }
+    }
+#else
+    (void)window;
+#endif
+    return zc;
+}
+
+void fossil_net_zerocopy_destroy(fossil_net_zerocopy_t *zc) {
+    if (!zc) return;
+#if defined(__linux__)
+    if (zc->window) munmap(zc->window, zc->window_len);
+#endif
+    free(zc->copy);
+    free(zc);
+}
+
+bool fossil_net_zerocopy_is_mapped(const fossil_net_zerocopy_t *zc) {
+    return zc && zc->window != NULL;
+}
+
+static int fossil__zc_copy(fossil_net_zerocopy_t *zc, uint32_t want, fossil_net_zerocopy_chunk_t *chunk) {
+    if (want == 0 || want > zc->copy_len) want = zc->copy_len;
+#if defined(_WIN32)
+    int r = recv((SOCKET)(intptr_t)zc->sock->fd, (char*)zc->copy, (int)want, 0);
+#else
+    ssize_t r;
+    do {
+        r = recv(zc->sock->fd, zc->copy, want, 0);
+    } while (r < 0 && errno == EINTR);
+#endif
+    if (r < 0) return chunk->mapped_len ? 0 : -1;
+    chunk->copied = r > 0 ? zc->copy : NULL;
+    chunk->copied_len = (uint32_t)r;
+    zc->stats.bytes_copied += (uint64_t)r;
+    return 0;
+}
+
+#if defined(__linux__)
+/* 4.18 kernels only know address, length and recv_skip_hint. */
+#define FOSSIL__ZC_V1_LEN (sizeof(uint64_t) + 2 * sizeof(uint32_t))
+
+static int fossil__zc_map(fossil_net_zerocopy_t *zc, fossil__tcp_zc_t *req) {
+    memset(req, 0, sizeof(*req));
+    req->address = (uint64_t)(uintptr_t)zc->window;
+    req->length = zc->window_len;
+    socklen_t len = (socklen_t)zc->optlen;
+    if (getsockopt(zc->sock->fd, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE, req, &len) == 0) return 0;
+    if (errno == EINVAL && zc->optlen != FOSSIL__ZC_V1_LEN) {
+        zc->optlen = (uint32_t)FOSSIL__ZC_V1_LEN;
+        return fossil__zc_map(zc, req);
+    }
+    return -1;
+}
+#endif
+
+int fossil_net_zerocopy_receive(fossil_net_zerocopy_t *zc, fossil_net_zerocopy_chunk_t *chunk) {
+    if (!zc || !chunk) return -1;
+    memset(chunk, 0, sizeof(*chunk));
+
+#if defined(__linux__)
+    if (zc->window) {
+        fossil__tcp_zc_t req;
+        if (fossil__zc_map(zc, &req) != 0) {
+            if (errno == EINVAL || errno == EOPNOTSUPP || errno == ENOPROTOOPT) {
+                // Not supported for this socket or kernel: copy from now on
+                munmap(zc->window, zc->window_len);
+                zc->window = NULL;
+            }
+            // A normal read reports EOF and socket errors the usual way
+            return fossil__zc_copy(zc, 0, chunk);
+        }
+        if (req.err != 0 && req.length == 0) {
+            errno = -req.err; // kernel reports a negative errno
+            return -1;
+        }
+        if (req.length > 0) {
+            chunk->mapped = zc->window;
+            chunk->mapped_len = req.length;
+            zc->stats.bytes_mapped += req.length;
+            zc->stats.map_calls++;
+        }
+        // Data the kernel could not map (not page aligned) must be read normally
+        if (req.recv_skip_hint > 0) return fossil__zc_copy(zc, req.recv_skip_hint, chunk);
+        if (req.length > 0) return 0;
+        // Nothing queued: wait (or report EAGAIN / EOF) through an ordinary read
+    }
+#endif
+    return fossil__zc_copy(zc, 0, chunk);
+}
+
+int fossil_net_zerocopy_get_stats(const fossil_net_zerocopy_t *zc, fossil_net_zerocopy_stats_t *stats) {
+    if (!zc || !stats) return -1;
+    *stats = zc->stats;
+    return 0;
+}
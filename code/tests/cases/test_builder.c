@@ -0,0 +1,178 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_builder_fixture);
+
+FOSSIL_SETUP(c_builder_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_builder_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static uint16_t c_builder_get16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+// Verify a transport checksum from scratch, independent of the builder
+static int c_builder_l4_valid(const fossil_net_packet_t *p) {
+    const uint8_t *ip = fossil_net_packet_l3(p);
+    const uint8_t *l4 = fossil_net_packet_l4(p);
+    uint32_t l4_len = p->length - p->l4_offset;
+    uint32_t sum = 0;
+    if (p->layers & FOSSIL_NET_PACKET_HAS_IPV4) {
+        if (p->ip_proto != 1) sum = fossil_net_checksum_pseudo_ipv4(ip + 12, ip + 16, p->ip_proto, (uint16_t)l4_len);
+    } else {
+        sum = fossil_net_checksum_pseudo_ipv6(ip + 8, ip + 24, p->ip_proto, l4_len);
+    }
+    return fossil_net_checksum_finish(fossil_net_checksum_partial(l4, l4_len, sum)) == 0;
+}
+
+FOSSIL_TEST(c_builder_test_eth_ipv4_udp) {
+    uint8_t frame[256];
+    fossil_net_builder_t b;
+    fossil_net_mac_t src = { { 0x02, 0, 0, 0, 0, 1 }, "" }, dst = { { 0x02, 0, 0, 0, 0, 2 }, "" };
+    fossil_net_endpoint_t s, d;
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&s, "10.0.0.1", 0) == 0);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&d, "10.0.0.2", 0) == 0);
+
+    ASSUME_ITS_TRUE(fossil_net_builder_init(&b, frame, sizeof(frame)) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_ethernet(&b, &src, &dst, 0) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_ip(&b, &s, &d, 17, 64) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_udp(&b, 4000, 53) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_payload(&b, "hello", 5) != NULL);
+    uint32_t len = 0;
+    ASSUME_ITS_TRUE(fossil_net_builder_finish(&b, &len) == 0 && len == 14 + 20 + 8 + 5);
+
+    fossil_net_packet_t p;
+    ASSUME_ITS_TRUE(fossil_net_packet_decode(frame, len, FOSSIL_NET_PACKET_LINK_ETHERNET, &p) == 0);
+    ASSUME_ITS_TRUE(p.layers == (FOSSIL_NET_PACKET_HAS_ETH | FOSSIL_NET_PACKET_HAS_IPV4 | FOSSIL_NET_PACKET_HAS_UDP));
+    ASSUME_ITS_TRUE(p.src_port == 4000 && p.dst_port == 53 && p.payload_length == 5);
+    ASSUME_ITS_TRUE(fossil_net_checksum(frame + 14, 20) == 0);
+    ASSUME_ITS_TRUE(c_builder_l4_valid(&p));
+}
+
+FOSSIL_TEST(c_builder_test_ipv6_tcp_and_icmpv6) {
+    uint8_t frame[256];
+    fossil_net_builder_t b;
+    fossil_net_endpoint_t s, d;
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&s, "2001:db8::1", 0) == 0);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&d, "2001:db8::2", 0) == 0);
+
+    fossil_net_builder_init(&b, frame, sizeof(frame));
+    ASSUME_ITS_TRUE(fossil_net_builder_ip(&b, &s, &d, 6, 64) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_tcp(&b, 1234, 80, 1000, 0, FOSSIL_NET_BUILDER_TCP_SYN, 65535) == 0);
+    uint32_t len = 0;
+    ASSUME_ITS_TRUE(fossil_net_builder_finish(&b, &len) == 0 && len == 60);
+    fossil_net_packet_t p;
+    ASSUME_ITS_TRUE(fossil_net_packet_decode(frame, len, FOSSIL_NET_PACKET_LINK_IP, &p) == 0);
+    ASSUME_ITS_TRUE((p.layers & FOSSIL_NET_PACKET_HAS_TCP) && p.tcp_flags == 0x02);
+    ASSUME_ITS_TRUE(c_builder_l4_valid(&p));
+
+    fossil_net_builder_init(&b, frame, sizeof(frame));
+    ASSUME_ITS_TRUE(fossil_net_builder_ip(&b, &s, &d, 0, 64) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_icmp(&b, 128, 0, 7, 1) == 0);
+    fossil_net_builder_payload(&b, "ping", 4);
+    ASSUME_ITS_TRUE(fossil_net_builder_finish(&b, &len) == 0);
+    ASSUME_ITS_TRUE(fossil_net_packet_decode(frame, len, FOSSIL_NET_PACKET_LINK_IP, &p) == 0);
+    ASSUME_ITS_TRUE((p.layers & FOSSIL_NET_PACKET_HAS_ICMPV6) && p.icmp_type == 128);
+    ASSUME_ITS_TRUE(c_builder_l4_valid(&p));
+}
+
+FOSSIL_TEST(c_builder_test_patch_incremental) {
+    uint8_t frame[256];
+    uint8_t payload[33];
+    fossil_net_builder_t b;
+    fossil_net_endpoint_t s, d;
+    fossil_net_endpoint_parse(&s, "192.168.1.1", 0);
+    fossil_net_endpoint_parse(&d, "192.168.1.2", 0);
+    for (size_t i = 0; i < sizeof(payload); ++i) payload[i] = (uint8_t)i;
+
+    fossil_net_builder_init(&b, frame, sizeof(frame));
+    fossil_net_builder_ip(&b, &s, &d, 17, 64);
+    fossil_net_builder_udp(&b, 1000, 2000);
+    fossil_net_builder_payload(&b, payload, sizeof(payload));
+    uint32_t len = 0;
+    ASSUME_ITS_TRUE(fossil_net_builder_finish(&b, &len) == 0);
+
+    // Source port, IPv4 id, destination address and an odd-aligned payload word
+    ASSUME_ITS_TRUE(fossil_net_builder_patch16(&b, 20, 1001) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_patch16(&b, 4, 0xbeef) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_patch16(&b, 18, 0x0909) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_patch16(&b, 29, 0xabcd) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_patch16(&b, 24, 1) != 0); // UDP length
+
+    uint16_t ip_check = c_builder_get16(frame + 10);
+    uint16_t udp_check = c_builder_get16(frame + 26);
+    ASSUME_ITS_TRUE(fossil_net_builder_finish(&b, NULL) == 0);
+    ASSUME_ITS_TRUE(c_builder_get16(frame + 10) == ip_check);
+    ASSUME_ITS_TRUE(c_builder_get16(frame + 26) == udp_check);
+    ASSUME_ITS_TRUE(c_builder_get16(frame + 20) == 1001 && frame[19] == 0x09);
+}
+
+FOSSIL_TEST(c_builder_test_rejects_bad_order) {
+    uint8_t frame[30];
+    fossil_net_builder_t b;
+    fossil_net_endpoint_t s, d;
+    fossil_net_endpoint_parse(&s, "10.0.0.1", 0);
+    fossil_net_endpoint_parse(&d, "::1", 0);
+    fossil_net_builder_init(&b, frame, sizeof(frame));
+    ASSUME_ITS_TRUE(fossil_net_builder_udp(&b, 1, 2) != 0);      // no IP yet
+    ASSUME_ITS_TRUE(fossil_net_builder_ip(&b, &s, &d, 17, 64) != 0); // family mismatch
+    ASSUME_ITS_TRUE(fossil_net_builder_ip(&b, &s, &s, 6, 64) == 0);
+    ASSUME_ITS_TRUE(fossil_net_builder_tcp(&b, 1, 2, 0, 0, 0, 0) != 0); // out of space
+    ASSUME_ITS_TRUE(fossil_net_builder_patch16(&b, 4, 1) != 0);      // not finished
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_builder_tests) {
+    FOSSIL_ADD_TEST(c_builder_fixture, c_builder_test_eth_ipv4_udp);
+    FOSSIL_ADD_TEST(c_builder_fixture, c_builder_test_ipv6_tcp_and_icmpv6);
+    FOSSIL_ADD_TEST(c_builder_fixture, c_builder_test_patch_incremental);
+    FOSSIL_ADD_TEST(c_builder_fixture, c_builder_test_rejects_bad_order);
+
+    FOSSIL_ADD_SUITE(c_builder_fixture);
+} // end of tests
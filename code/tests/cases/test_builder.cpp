@@ -0,0 +1,92 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_builder_fixture);
+
+FOSSIL_SETUP(cpp_builder_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_builder_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_builder_test_class_ipv4_icmp) {
+    uint8_t frame[128];
+    fossil_net_endpoint_t s, d;
+    fossil_net_endpoint_parse(&s, "10.1.1.1", 0);
+    fossil_net_endpoint_parse(&d, "10.1.1.2", 0);
+    fossil::net::Builder b(frame, sizeof(frame));
+    ASSUME_ITS_TRUE(b.ip(s, d, 1));
+    ASSUME_ITS_TRUE(b.icmp(8, 0, 42, 1));
+    ASSUME_ITS_TRUE(b.payload("abc", 3) != nullptr);
+    uint32_t len = b.finish();
+    ASSUME_ITS_TRUE(len == 20 + 8 + 3);
+    ASSUME_ITS_TRUE(fossil::net::Checksum::compute(frame, 20) == 0);
+    ASSUME_ITS_TRUE(fossil::net::Checksum::compute(frame + 20, len - 20) == 0);
+
+    fossil::net::Packet p(frame, len, FOSSIL_NET_PACKET_LINK_IP);
+    ASSUME_ITS_TRUE(p.has(FOSSIL_NET_PACKET_HAS_ICMP));
+}
+
+FOSSIL_TEST(cpp_builder_test_class_patch) {
+    uint8_t frame[128];
+    fossil_net_endpoint_t s, d;
+    fossil_net_endpoint_parse(&s, "10.1.1.1", 0);
+    fossil_net_endpoint_parse(&d, "10.1.1.2", 0);
+    fossil::net::Builder b(frame, sizeof(frame));
+    b.ip(s, d, 1);
+    b.icmp(8, 0, 42, 1);
+    uint32_t len = b.finish();
+    ASSUME_ITS_TRUE(b.patch16(26, 2)); // ICMP sequence
+    ASSUME_ITS_TRUE(fossil::net::Checksum::compute(frame + 20, len - 20) == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_builder_tests) {
+    FOSSIL_ADD_TEST(cpp_builder_fixture, cpp_builder_test_class_ipv4_icmp);
+    FOSSIL_ADD_TEST(cpp_builder_fixture, cpp_builder_test_class_patch);
+
+    FOSSIL_ADD_SUITE(cpp_builder_fixture);
+} // end of tests
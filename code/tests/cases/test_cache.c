@@ -0,0 +1,340 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_cache_fixture);
+
+FOSSIL_SETUP(c_cache_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_cache_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+/* Parse a raw request head; the text must outlive req. */
+static int c_cache_parse(const char *raw, fossil_net_http_request_t *req) {
+    fossil_net_parser_t p;
+    fossil_net_parser_init(&p, 0);
+    return fossil_net_parser_parse(&p, raw, (uint32_t)strlen(raw), req) > 0 ? 0 : -1;
+}
+
+static const char *c_cache_text(const fossil_net_cache_hit_t *hit, uint32_t off, uint32_t len, char *out, size_t size) {
+    snprintf(out, size, "%.*s", (int)len, (const char *)fossil_net_buf_data(hit->buf) + off);
+    return out;
+}
+
+FOSSIL_TEST(c_cache_test_keys) {
+    fossil_net_cache_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.vary = "Accept-Encoding, Accept-Language";
+    fossil_net_cache_t *cache = fossil_net_cache_create(&cfg);
+    ASSUME_ITS_TRUE(cache != NULL);
+    fossil_net_http_request_t req;
+    char a[256], b[256];
+
+    ASSUME_ITS_TRUE(c_cache_parse("GET /x?q=1 HTTP/1.1\r\nHost: h\r\nAccept-Encoding: gzip\r\n\r\n", &req) == 0);
+    uint32_t na = fossil_net_cache_key(cache, &req, a, sizeof(a));
+    ASSUME_ITS_TRUE(na > 0);
+    ASSUME_ITS_TRUE(memcmp(a, "GET h /x?q=1\ngzip\n", na) == 0);
+
+    /* HEAD shares GET's key; other methods and credentials are not cached. */
+    ASSUME_ITS_TRUE(c_cache_parse("HEAD /x?q=1 HTTP/1.1\r\nHost: h\r\nAccept-Encoding: gzip\r\n\r\n", &req) == 0);
+    uint32_t nb = fossil_net_cache_key(cache, &req, b, sizeof(b));
+    ASSUME_ITS_TRUE(na == nb && memcmp(a, b, na) == 0);
+    ASSUME_ITS_TRUE(c_cache_parse("GET /x?q=1 HTTP/1.1\r\nHost: h\r\n\r\n", &req) == 0);
+    nb = fossil_net_cache_key(cache, &req, b, sizeof(b));
+    ASSUME_ITS_TRUE(nb > 0 && (na != nb || memcmp(a, b, na) != 0));
+    ASSUME_ITS_TRUE(fossil_net_cache_key(cache, &req, b, 4) == 0);
+    ASSUME_ITS_TRUE(c_cache_parse("POST /x HTTP/1.1\r\nHost: h\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_key(cache, &req, b, sizeof(b)) == 0);
+    ASSUME_ITS_TRUE(c_cache_parse("GET /x HTTP/1.1\r\nHost: h\r\nAuthorization: Basic eA==\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_key(cache, &req, b, sizeof(b)) == 0);
+    ASSUME_ITS_TRUE(c_cache_parse("GET /x HTTP/1.1\r\nHost: h\r\nCache-Control: no-store\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_key(cache, &req, b, sizeof(b)) == 0);
+    fossil_net_cache_destroy(cache);
+}
+
+FOSSIL_TEST(c_cache_test_store_and_revalidate) {
+    fossil_net_cache_t *cache = fossil_net_cache_create(NULL);
+    ASSUME_ITS_TRUE(cache != NULL);
+    fossil_net_http_request_t req;
+    fossil_net_cache_hit_t hit;
+    char key[256], text[512];
+    ASSUME_ITS_TRUE(c_cache_parse("GET /a HTTP/1.1\r\nHost: h\r\n\r\n", &req) == 0);
+    uint32_t n = fossil_net_cache_key(cache, &req, key, sizeof(key));
+    ASSUME_ITS_TRUE(!fossil_net_cache_lookup(cache, key, n, &req, &hit));
+
+    const char *headers = "Cache-Control: max-age=60\r\nLast-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\nX-A: 1\r\n";
+    ASSUME_ITS_TRUE(fossil_net_cache_store(cache, key, n, 200, "text/plain", headers, (uint32_t)strlen(headers), "hello", 5) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_lookup(cache, key, n, &req, &hit));
+    ASSUME_ITS_TRUE(!hit.not_modified);
+    c_cache_text(&hit, hit.head_off, hit.head_len, text, sizeof(text));
+    ASSUME_ITS_TRUE(strncmp(text, "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n", 36) == 0);
+    ASSUME_ITS_TRUE(strstr(text, "Content-Type: text/plain\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "X-A: 1\r\n") != NULL);
+    char etag[64];
+    const char *tag = strstr(text, "ETag: ");
+    ASSUME_ITS_TRUE(tag != NULL);
+    snprintf(etag, sizeof(etag), "%.*s", (int)(strstr(tag, "\r\n") - tag - 6), tag + 6);
+    ASSUME_ITS_TRUE(strcmp(c_cache_text(&hit, hit.body_off, hit.body_len, text, sizeof(text)), "hello") == 0);
+    fossil_net_cache_release(&hit);
+    ASSUME_ITS_TRUE(hit.buf == NULL);
+
+    /* Conditionals become 304s carrying the validators. */
+    char raw[256];
+    snprintf(raw, sizeof(raw), "GET /a HTTP/1.1\r\nHost: h\r\nIf-None-Match: %s\r\n\r\n", etag);
+    ASSUME_ITS_TRUE(c_cache_parse(raw, &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_lookup(cache, key, n, &req, &hit));
+    ASSUME_ITS_TRUE(hit.not_modified && hit.body_len == 0);
+    c_cache_text(&hit, hit.head_off, hit.head_len, text, sizeof(text));
+    ASSUME_ITS_TRUE(strncmp(text, "HTTP/1.1 304 Not Modified\r\n", 27) == 0);
+    ASSUME_ITS_TRUE(strstr(text, etag) != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "Cache-Control: max-age=60\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "X-A") == NULL);
+    fossil_net_cache_release(&hit);
+
+    ASSUME_ITS_TRUE(c_cache_parse("GET /a HTTP/1.1\r\nHost: h\r\nIf-Modified-Since: Sun, 06 Nov 1994 08:49:37 GMT\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_lookup(cache, key, n, &req, &hit));
+    ASSUME_ITS_TRUE(hit.not_modified);
+    fossil_net_cache_release(&hit);
+    ASSUME_ITS_TRUE(c_cache_parse("GET /a HTTP/1.1\r\nHost: h\r\nIf-None-Match: \"x\"\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_lookup(cache, key, n, &req, &hit));
+    ASSUME_ITS_TRUE(!hit.not_modified && hit.body_len == 5);
+    fossil_net_cache_release(&hit);
+
+    /* The client can insist on a fresh response. */
+    ASSUME_ITS_TRUE(c_cache_parse("GET /a HTTP/1.1\r\nHost: h\r\nCache-Control: max-age=0\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(!fossil_net_cache_lookup(cache, key, n, &req, &hit));
+
+    fossil_net_cache_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_cache_get_stats(cache, &st) == 0);
+    ASSUME_ITS_TRUE(st.hits == 4 && st.not_modified == 2 && st.misses == 2);
+    ASSUME_ITS_TRUE(st.stores == 1 && st.entries == 1 && st.bytes > 5);
+    fossil_net_cache_clear(cache);
+    ASSUME_ITS_TRUE(fossil_net_cache_get_stats(cache, &st) == 0);
+    ASSUME_ITS_TRUE(st.entries == 0 && st.bytes == 0);
+    fossil_net_cache_destroy(cache);
+}
+
+FOSSIL_TEST(c_cache_test_uncacheable_and_expiry) {
+    fossil_net_cache_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.default_ttl_ns = 300000000; /* 300 ms, far above scheduler jitter */
+    cfg.vary = "Accept-Encoding";
+    fossil_net_cache_t *cache = fossil_net_cache_create(&cfg);
+    ASSUME_ITS_TRUE(cache != NULL);
+    const char *key = "GET h /b";
+    uint32_t n = (uint32_t)strlen(key);
+    const char *refused[] = {
+        "Cache-Control: no-store\r\n",
+        "Cache-Control: public, private\r\n",
+        "Cache-Control: max-age=0\r\n",
+        "Set-Cookie: s=1\r\n",
+        "Vary: *\r\n",
+        "Vary: Accept-Encoding, Cookie\r\n"
+    };
+    for (size_t i = 0; i < sizeof(refused) / sizeof(refused[0]); i++)
+        ASSUME_ITS_TRUE(fossil_net_cache_store(cache, key, n, 200, NULL, refused[i], (uint32_t)strlen(refused[i]), "x", 1) == 1);
+    ASSUME_ITS_TRUE(fossil_net_cache_store(cache, key, n, 404, NULL, NULL, 0, "x", 1) == 1);
+    ASSUME_ITS_TRUE(fossil_net_cache_store(cache, key, n, 200, NULL, "Vary: accept-encoding\r\n", 23, "x", 1) == 0);
+
+    fossil_net_http_request_t req;
+    fossil_net_cache_hit_t hit;
+    ASSUME_ITS_TRUE(c_cache_parse("GET /b HTTP/1.1\r\nHost: h\r\n\r\n", &req) == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_lookup(cache, key, n, &req, &hit));
+    fossil_net_cache_release(&hit);
+    struct timespec ts = { 0, 400000000 };
+    nanosleep(&ts, NULL);
+    ASSUME_ITS_TRUE(!fossil_net_cache_lookup(cache, key, n, &req, &hit));
+
+    fossil_net_cache_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_cache_get_stats(cache, &st) == 0);
+    ASSUME_ITS_TRUE(st.uncacheable == 6 && st.expired == 1 && st.entries == 0);
+    ASSUME_ITS_TRUE(fossil_net_cache_store(NULL, key, n, 200, NULL, NULL, 0, "x", 1) == -1);
+    ASSUME_ITS_TRUE(!fossil_net_cache_lookup(cache, NULL, 0, &req, &hit));
+    fossil_net_cache_destroy(cache);
+}
+
+FOSSIL_TEST(c_cache_test_admission) {
+    /* One shard with room for about three 1 KiB responses. */
+    fossil_net_cache_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.shards = 1;
+    cfg.max_bytes = 4000;
+    cfg.default_ttl_ns = 60000000000ull;
+    fossil_net_cache_t *cache = fossil_net_cache_create(&cfg);
+    ASSUME_ITS_TRUE(cache != NULL);
+    static char body[1000];
+    memset(body, 'b', sizeof(body));
+    fossil_net_http_request_t req;
+    fossil_net_cache_hit_t hit;
+    ASSUME_ITS_TRUE(c_cache_parse("GET / HTTP/1.1\r\nHost: h\r\n\r\n", &req) == 0);
+
+    const char *hot[] = { "GET h /1", "GET h /2", "GET h /3" };
+    for (int k = 0; k < 3; k++) {
+        for (int i = 0; i < 4; i++)
+            fossil_net_cache_lookup(cache, hot[k], 8, &req, &hit);
+        ASSUME_ITS_TRUE(fossil_net_cache_store(cache, hot[k], 8, 200, NULL, NULL, 0, body, sizeof(body)) == 0);
+    }
+    /* A one-off URL cannot push out keys asked for more often. */
+    ASSUME_ITS_TRUE(!fossil_net_cache_lookup(cache, "GET h /4", 8, &req, &hit));
+    ASSUME_ITS_TRUE(fossil_net_cache_store(cache, "GET h /4", 8, 200, NULL, NULL, 0, body, sizeof(body)) == 1);
+    /* A popular one can. */
+    for (int i = 0; i < 8; i++)
+        fossil_net_cache_lookup(cache, "GET h /5", 8, &req, &hit);
+    ASSUME_ITS_TRUE(fossil_net_cache_store(cache, "GET h /5", 8, 200, NULL, NULL, 0, body, sizeof(body)) == 0);
+    ASSUME_ITS_TRUE(!fossil_net_cache_lookup(cache, hot[0], 8, &req, &hit)); /* the LRU victim */
+    ASSUME_ITS_TRUE(fossil_net_cache_lookup(cache, "GET h /5", 8, &req, &hit));
+    fossil_net_cache_release(&hit);
+
+    fossil_net_cache_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_cache_get_stats(cache, &st) == 0);
+    ASSUME_ITS_TRUE(st.rejected == 1);
+    ASSUME_ITS_TRUE(st.evictions == 1);
+    ASSUME_ITS_TRUE(st.entries == 3 && st.bytes <= cfg.max_bytes);
+    fossil_net_cache_destroy(cache);
+}
+
+static atomic_int c_cache_calls;
+
+static void c_cache_page(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    uint32_t size = (uint32_t)(uintptr_t)user;
+    static char big[64 * 1024];
+    memset(big, 'z', sizeof(big));
+    atomic_fetch_add(&c_cache_calls, 1);
+    fossil_net_http_add_header(ex, "Cache-Control", "max-age=60");
+    fossil_net_http_respond(ex, 200, "text/plain", size ? big : "page", size ? size : 4);
+}
+
+static uint32_t c_cache_get(fossil_net_server_t *server, const char *raw, char *out, uint32_t size) {
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    uint32_t sent = 0, total = 0, got = 0;
+    if (fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) != 0 ||
+        fossil_net_socket_create(&c, "tcp", "ipv4") != 0)
+        return 0;
+    if (fossil_net_socket_connect_endpoint(&c, &ep) != 0) {
+        fossil_net_socket_close(&c);
+        return 0;
+    }
+    fossil_net_socket_send(&c, raw, (uint32_t)strlen(raw), &sent);
+    while (total < size - 1 && fossil_net_socket_receive(&c, out + total, size - 1 - total, &got) == 0 && got > 0)
+        total += got;
+    out[total] = '\0';
+    fossil_net_socket_close(&c);
+    return total;
+}
+
+FOSSIL_TEST(c_cache_test_httpd_hits) {
+    fossil_net_cache_t *cache = fossil_net_cache_create(NULL);
+    ASSUME_ITS_TRUE(cache != NULL);
+    fossil_net_httpd_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reactor.threads = 1;
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_httpd_t *h = fossil_net_httpd_create(server, &cfg);
+    ASSUME_ITS_TRUE(h != NULL);
+    ASSUME_ITS_TRUE(fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/page", c_cache_page, NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/big", c_cache_page, (void *)(uintptr_t)40000) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_set_cache(h, cache) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_start(h) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_set_cache(h, NULL) != 0);
+    atomic_store(&c_cache_calls, 0);
+    static char out[128 * 1024];
+
+    /* Pipelined: the first fills the cache, the others are hits, in order. */
+    ASSUME_ITS_TRUE(c_cache_get(server,
+        "GET /page HTTP/1.1\r\nHost: t\r\n\r\n"
+        "GET /page HTTP/1.1\r\nHost: t\r\n\r\n"
+        "HEAD /page HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(atomic_load(&c_cache_calls) == 1);
+    const char *second = strstr(out + 1, "HTTP/1.1 200 OK");
+    const char *third = second ? strstr(second + 1, "HTTP/1.1 200 OK") : NULL;
+    ASSUME_ITS_TRUE(second && third);
+    ASSUME_ITS_TRUE(strstr(second, "Age: ") != NULL && strstr(second, "\r\n\r\npage") != NULL);
+    ASSUME_ITS_TRUE(strstr(third, "Connection: close\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(third, "Content-Length: 4\r\n") != NULL);
+    ASSUME_ITS_TRUE(strcmp(strstr(third, "\r\n\r\n"), "\r\n\r\n") == 0);
+
+    char etag[64], raw[256];
+    const char *tag = strstr(out, "ETag: ");
+    ASSUME_ITS_TRUE(tag != NULL);
+    snprintf(etag, sizeof(etag), "%.*s", (int)(strstr(tag, "\r\n") - tag - 6), tag + 6);
+    snprintf(raw, sizeof(raw), "GET /page HTTP/1.1\r\nHost: t\r\nIf-None-Match: %s\r\nConnection: close\r\n\r\n", etag);
+    ASSUME_ITS_TRUE(c_cache_get(server, raw, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 304 Not Modified\r\n", 27) == 0);
+    ASSUME_ITS_TRUE(atomic_load(&c_cache_calls) == 1);
+
+    /* Large bodies are sent by reference. */
+    for (int i = 0; i < 2; i++) {
+        ASSUME_ITS_TRUE(c_cache_get(server, "GET /big HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n", out, sizeof(out)) > 0);
+        const char *body = strstr(out, "\r\n\r\n");
+        ASSUME_ITS_TRUE(body && strlen(body + 4) == 40000 && body[4] == 'z' && body[40003] == 'z');
+    }
+    ASSUME_ITS_TRUE(atomic_load(&c_cache_calls) == 2);
+
+    fossil_net_cache_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_cache_get_stats(cache, &st) == 0);
+    ASSUME_ITS_TRUE(st.hits == 4 && st.stores == 2 && st.not_modified == 1);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_cache_destroy(cache);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_cache_tests) {
+    FOSSIL_ADD_TEST(c_cache_fixture, c_cache_test_keys);
+    FOSSIL_ADD_TEST(c_cache_fixture, c_cache_test_store_and_revalidate);
+    FOSSIL_ADD_TEST(c_cache_fixture, c_cache_test_uncacheable_and_expiry);
+    FOSSIL_ADD_TEST(c_cache_fixture, c_cache_test_admission);
+    FOSSIL_ADD_TEST(c_cache_fixture, c_cache_test_httpd_hits);
+
+    FOSSIL_ADD_SUITE(c_cache_fixture);
+} // end of tests
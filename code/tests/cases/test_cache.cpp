@@ -0,0 +1,128 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <atomic>
+#include <string>
+#include <utility>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_cache_fixture);
+
+FOSSIL_SETUP(cpp_cache_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_cache_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::net::Cache;
+using fossil::net::Httpd;
+
+static std::atomic<int> cpp_cache_calls{0};
+
+static void cpp_cache_page(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    (void)user;
+    cpp_cache_calls++;
+    fossil_net_http_add_header(ex, "Cache-Control", "max-age=60");
+    Httpd::respond(ex, 200, "text/plain", "cached page");
+}
+
+FOSSIL_TEST(cpp_cache_test_class_serve) {
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != nullptr);
+    fossil_net_httpd_config_t cfg{};
+    cfg.reactor.threads = 1;
+    cpp_cache_calls = 0;
+    {
+        Cache cache;
+        ASSUME_ITS_TRUE(cache.native_handle() != nullptr);
+        Httpd httpd(server, &cfg);
+        ASSUME_ITS_TRUE(httpd.route(FOSSIL_NET_HTTP_GET, "/page", cpp_cache_page));
+        ASSUME_ITS_TRUE(httpd.set_cache(cache.native_handle()) == 0);
+        ASSUME_ITS_TRUE(httpd.start() == 0);
+
+        fossil_net_endpoint_t ep;
+        fossil_net_socket_t c;
+        ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+        fossil::net::Request req = fossil::net::Request::get("/page");
+        for (int i = 0; i < 3; i++) {
+            fossil_net_response_t res{};
+            ASSUME_ITS_TRUE(fossil_net_request_send(&c, req.native_handle(), &res) == 0);
+            ASSUME_ITS_TRUE(res.status == 200);
+            ASSUME_ITS_TRUE(std::string(static_cast<char *>(res.body), res.body_size) == "cached page");
+            fossil_net_response_free(&res);
+        }
+        fossil_net_socket_close(&c);
+        ASSUME_ITS_TRUE(cpp_cache_calls == 1);
+
+        fossil_net_cache_stats_t st = cache.stats();
+        ASSUME_ITS_TRUE(st.hits == 2);
+        ASSUME_ITS_TRUE(st.entries == 1);
+        ASSUME_ITS_TRUE(httpd.stop() == 0);
+        cache.clear();
+        ASSUME_ITS_TRUE(cache.stats().entries == 0);
+    }
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(cpp_cache_test_class_move) {
+    Cache a;
+    Cache b(std::move(a));
+    ASSUME_ITS_TRUE(a.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(b.native_handle() != nullptr);
+    Cache c;
+    c = std::move(b);
+    ASSUME_ITS_TRUE(c.native_handle() != nullptr);
+    ASSUME_ITS_TRUE(b.native_handle() == nullptr);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_cache_tests) {
+    FOSSIL_ADD_TEST(cpp_cache_fixture, cpp_cache_test_class_serve);
+    FOSSIL_ADD_TEST(cpp_cache_fixture, cpp_cache_test_class_move);
+
+    FOSSIL_ADD_SUITE(cpp_cache_fixture);
+} // end of tests
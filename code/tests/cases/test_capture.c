@@ -0,0 +1,131 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_capture_fixture);
+
+FOSSIL_SETUP(c_capture_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_capture_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_capture_test_packet_family_id) {
+    fossil_net_socket_t sock;
+    if (fossil_net_socket_create(&sock, "raw", "packet") != 0) {
+        // Needs Linux and CAP_NET_RAW
+        return;
+    }
+    ASSUME_ITS_TRUE(strcmp(fossil_net_socket_family_id(&sock), "packet") == 0);
+    ASSUME_ITS_TRUE(strcmp(fossil_net_socket_type_id(&sock), "raw") == 0);
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(c_capture_test_rejects_non_packet_socket) {
+    fossil_net_socket_t sock;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&sock, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_capture_create(&sock, NULL) == NULL);
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(c_capture_test_loopback_ring_roundtrip) {
+    fossil_net_socket_t raw;
+    if (fossil_net_socket_create(&raw, "raw", "packet") != 0) return;
+
+    fossil_net_capture_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.iface = "lo";
+    cfg.block_size = 1u << 16;
+    cfg.block_count = 8;
+    cfg.retire_ms = 10;
+    cfg.tx_frame_count = 8;
+    fossil_net_capture_t *cap = fossil_net_capture_create(&raw, &cfg);
+    ASSUME_ITS_TRUE(cap != NULL);
+    ASSUME_ITS_TRUE(fossil_net_capture_set_fanout(cap, 0x4242, FOSSIL_NET_CAPTURE_FANOUT_HASH) == 0);
+
+    // Inject a frame with an experimental EtherType through the TX ring
+    uint8_t frame[64];
+    memset(frame, 0, sizeof(frame));
+    frame[12] = 0x88;
+    frame[13] = 0xb5;
+    memcpy(frame + 14, "fossil-ring", 11);
+    ASSUME_ITS_TRUE(fossil_net_capture_send(cap, frame, sizeof(frame)) == 0);
+    ASSUME_ITS_TRUE(fossil_net_capture_flush(cap) == 1);
+
+    int found = 0;
+    for (int tries = 0; tries < 50 && !found; ++tries) {
+        fossil_net_capture_block_t block;
+        int rc = fossil_net_capture_next_block(cap, &block, 100);
+        ASSUME_ITS_TRUE(rc >= 0);
+        if (rc == 0) continue;
+        fossil_net_capture_frame_t f;
+        while (fossil_net_capture_next_frame(&block, &f)) {
+            if (f.caplen >= 25 && f.protocol == 0x88b5 && memcmp(f.data + 14, "fossil-ring", 11) == 0) {
+                ASSUME_ITS_TRUE(f.len == sizeof(frame));
+                ASSUME_ITS_TRUE(f.timestamp_ns > 0);
+                found = 1;
+            }
+        }
+        fossil_net_capture_release_block(cap, &block);
+    }
+    ASSUME_ITS_TRUE(found);
+
+    fossil_net_capture_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_capture_get_stats(cap, &st) == 0);
+    ASSUME_ITS_TRUE(st.packets >= 1);
+
+    fossil_net_capture_destroy(cap);
+    fossil_net_socket_close(&raw);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_capture_tests) {
+    FOSSIL_ADD_TEST(c_capture_fixture, c_capture_test_packet_family_id);
+    FOSSIL_ADD_TEST(c_capture_fixture, c_capture_test_rejects_non_packet_socket);
+    FOSSIL_ADD_TEST(c_capture_fixture, c_capture_test_loopback_ring_roundtrip);
+
+    FOSSIL_ADD_SUITE(c_capture_fixture);
+} // end of tests
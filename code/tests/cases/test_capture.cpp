@@ -0,0 +1,85 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_capture_fixture);
+
+FOSSIL_SETUP(cpp_capture_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_capture_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_capture_test_class_requires_packet_socket) {
+    fossil::net::Socket sock;
+    ASSUME_ITS_TRUE(sock.socket_create("tcp", "ipv4") == 0);
+    fossil::net::Capture cap(sock.native_handle());
+    ASSUME_ITS_TRUE(cap.native_handle() == nullptr);
+}
+
+FOSSIL_TEST(cpp_capture_test_class_ring) {
+    fossil::net::Socket sock;
+    if (sock.socket_create("raw", "packet") != 0) return;
+    fossil_net_capture_config_t cfg = {};
+    cfg.iface = "lo";
+    cfg.block_size = 1u << 16;
+    cfg.block_count = 4;
+    cfg.retire_ms = 5;
+    fossil::net::Capture cap(sock.native_handle(), &cfg);
+    ASSUME_ITS_TRUE(cap.native_handle() != nullptr);
+
+    // No TX ring configured
+    ASSUME_ITS_TRUE(cap.send("x", 1) != 0);
+    fossil_net_capture_block_t block;
+    ASSUME_ITS_TRUE(cap.next_block(&block, 0) >= 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_capture_tests) {
+    FOSSIL_ADD_TEST(cpp_capture_fixture, cpp_capture_test_class_requires_packet_socket);
+    FOSSIL_ADD_TEST(cpp_capture_fixture, cpp_capture_test_class_ring);
+
+    FOSSIL_ADD_SUITE(cpp_capture_fixture);
+} // end of tests
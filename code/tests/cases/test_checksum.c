@@ -0,0 +1,130 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_checksum_fixture);
+
+FOSSIL_SETUP(c_checksum_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_checksum_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static uint16_t c_checksum_reference(const uint8_t *p, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) sum += (uint32_t)((p[i] << 8) | p[i + 1]);
+    if (len & 1) sum += (uint32_t)(p[len - 1] << 8);
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+FOSSIL_TEST(c_checksum_test_rfc1071_example) {
+    // RFC 1071 section 3 example: one's-complement sum is 0xddf2
+    const uint8_t data[] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+    ASSUME_ITS_TRUE(fossil_net_checksum(data, sizeof(data)) == (uint16_t)~0xddf2);
+}
+
+FOSSIL_TEST(c_checksum_test_matches_reference) {
+    static uint8_t buf[4099];
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < sizeof(buf); ++i) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+    // Every length and misalignment through the SIMD and scalar paths
+    for (size_t off = 0; off < 4; ++off) {
+        for (size_t len = 0; len < 300; ++len)
+            ASSUME_ITS_TRUE(fossil_net_checksum(buf + off, len) == c_checksum_reference(buf + off, len));
+        ASSUME_ITS_TRUE(fossil_net_checksum(buf + off, 4095) == c_checksum_reference(buf + off, 4095));
+    }
+    memset(buf, 0xff, sizeof(buf));
+    ASSUME_ITS_TRUE(fossil_net_checksum(buf, sizeof(buf)) == c_checksum_reference(buf, sizeof(buf)));
+}
+
+FOSSIL_TEST(c_checksum_test_partial_chaining) {
+    uint8_t buf[1000];
+    for (size_t i = 0; i < sizeof(buf); ++i) buf[i] = (uint8_t)(i * 7);
+    uint32_t sum = fossil_net_checksum_partial(buf, 250, 0);
+    sum = fossil_net_checksum_partial(buf + 250, 500, sum);
+    sum = fossil_net_checksum_partial(buf + 750, 250, sum);
+    ASSUME_ITS_TRUE(fossil_net_checksum_finish(sum) == fossil_net_checksum(buf, sizeof(buf)));
+}
+
+FOSSIL_TEST(c_checksum_test_pseudo_ipv4) {
+    const uint8_t src[4] = { 192, 168, 0, 1 }, dst[4] = { 192, 168, 0, 199 };
+    uint8_t ph[12] = { 192, 168, 0, 1, 192, 168, 0, 199, 0, 17, 0, 28 };
+    uint32_t a = fossil_net_checksum_pseudo_ipv4(src, dst, 17, 28);
+    ASSUME_ITS_TRUE(fossil_net_checksum_finish(a) == c_checksum_reference(ph, sizeof(ph)));
+}
+
+FOSSIL_TEST(c_checksum_test_incremental_update) {
+    uint8_t hdr[20] = { 0x45, 0, 0, 0x54, 0x12, 0x34, 0x40, 0, 64, 1, 0, 0, 10, 0, 0, 1, 10, 0, 0, 2 };
+    uint16_t check = fossil_net_checksum(hdr, sizeof(hdr));
+
+    // TTL decrement (RFC 1624 section 4 use case)
+    uint16_t old_word = (uint16_t)((hdr[8] << 8) | hdr[9]);
+    hdr[8]--;
+    uint16_t new_word = (uint16_t)((hdr[8] << 8) | hdr[9]);
+    check = fossil_net_checksum_update16(check, old_word, new_word);
+    ASSUME_ITS_TRUE(check == fossil_net_checksum(hdr, sizeof(hdr)));
+
+    // Address rewrite
+    hdr[15] = 77;
+    hdr[14] = 3;
+    check = fossil_net_checksum_update32(check, 0x0a000001u, 0x0a00034du);
+    ASSUME_ITS_TRUE(check == fossil_net_checksum(hdr, sizeof(hdr)));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_checksum_tests) {
+    FOSSIL_ADD_TEST(c_checksum_fixture, c_checksum_test_rfc1071_example);
+    FOSSIL_ADD_TEST(c_checksum_fixture, c_checksum_test_matches_reference);
+    FOSSIL_ADD_TEST(c_checksum_fixture, c_checksum_test_partial_chaining);
+    FOSSIL_ADD_TEST(c_checksum_fixture, c_checksum_test_pseudo_ipv4);
+    FOSSIL_ADD_TEST(c_checksum_fixture, c_checksum_test_incremental_update);
+
+    FOSSIL_ADD_SUITE(c_checksum_fixture);
+} // end of tests
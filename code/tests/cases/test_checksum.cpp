@@ -0,0 +1,74 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_checksum_fixture);
+
+FOSSIL_SETUP(cpp_checksum_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_checksum_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_checksum_test_class) {
+    const uint8_t data[] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+    ASSUME_ITS_TRUE(fossil::net::Checksum::compute(data, sizeof(data)) == (uint16_t)~0xddf2);
+}
+
+FOSSIL_TEST(cpp_checksum_test_class_update) {
+    uint8_t data[8] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+    uint16_t check = fossil::net::Checksum::compute(data, sizeof(data));
+    data[2] = 0x12;
+    check = fossil::net::Checksum::update16(check, 0xf203, 0x1203);
+    ASSUME_ITS_TRUE(check == fossil::net::Checksum::compute(data, sizeof(data)));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_checksum_tests) {
+    FOSSIL_ADD_TEST(cpp_checksum_fixture, cpp_checksum_test_class);
+    FOSSIL_ADD_TEST(cpp_checksum_fixture, cpp_checksum_test_class_update);
+
+    FOSSIL_ADD_SUITE(cpp_checksum_fixture);
+} // end of tests
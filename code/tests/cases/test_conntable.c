@@ -0,0 +1,178 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_conntable_fixture);
+
+FOSSIL_SETUP(c_conntable_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_conntable_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+typedef struct c_conntable_obj {
+    uint32_t value;
+    uint8_t pad[20];
+} c_conntable_obj_t;
+
+FOSSIL_TEST(c_conntable_test_alloc_release) {
+    fossil_net_conntable_t *t = fossil_net_conntable_create(sizeof(c_conntable_obj_t), 0);
+    ASSUME_ITS_TRUE(t != NULL);
+    fossil_net_handle_t h = FOSSIL_NET_HANDLE_NONE;
+    c_conntable_obj_t *o = fossil_net_conntable_alloc(t, &h);
+    ASSUME_ITS_TRUE(o != NULL);
+    ASSUME_ITS_TRUE(h != FOSSIL_NET_HANDLE_NONE);
+    ASSUME_ITS_TRUE(o->value == 0);
+    o->value = 42;
+    ASSUME_ITS_TRUE(fossil_net_conntable_get(t, h) == o);
+    ASSUME_ITS_TRUE(fossil_net_conntable_handle_of(t, o) == h);
+    ASSUME_ITS_TRUE(fossil_net_conntable_count(t) == 1);
+
+    ASSUME_ITS_TRUE(fossil_net_conntable_release(t, h) == 0);
+    ASSUME_ITS_TRUE(fossil_net_conntable_get(t, h) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_conntable_release(t, h) != 0);
+
+    /* The slot is reused, zeroed, under a new generation. */
+    fossil_net_handle_t h2;
+    c_conntable_obj_t *o2 = fossil_net_conntable_alloc(t, &h2);
+    ASSUME_ITS_TRUE(o2 == o);
+    ASSUME_ITS_TRUE(o2->value == 0);
+    ASSUME_ITS_TRUE(FOSSIL_NET_HANDLE_INDEX(h2) == FOSSIL_NET_HANDLE_INDEX(h));
+    ASSUME_ITS_TRUE(h2 != h);
+    ASSUME_ITS_TRUE(fossil_net_conntable_get(t, h) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_conntable_get(t, h2) == o2);
+
+    fossil_net_conntable_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_conntable_get_stats(t, &st) == 0);
+    ASSUME_ITS_TRUE(st.live == 1);
+    ASSUME_ITS_TRUE(st.allocs == 2);
+    ASSUME_ITS_TRUE(st.releases == 1);
+    ASSUME_ITS_TRUE(st.stale == 3);
+    fossil_net_conntable_destroy(t);
+}
+
+FOSSIL_TEST(c_conntable_test_growth_and_iteration) {
+    enum { N = 3 * FOSSIL_NET_CONNTABLE_CHUNK + 7 };
+    fossil_net_conntable_t *t = fossil_net_conntable_create(sizeof(c_conntable_obj_t), 0);
+    ASSUME_ITS_TRUE(t != NULL);
+    static fossil_net_handle_t handles[N];
+    static c_conntable_obj_t *objs[N];
+    for (uint32_t i = 0; i < N; ++i) {
+        objs[i] = fossil_net_conntable_alloc(t, &handles[i]);
+        ASSUME_ITS_TRUE(objs[i] != NULL);
+        objs[i]->value = i;
+    }
+    /* Chunks never move, so earlier pointers survive growth. */
+    for (uint32_t i = 0; i < N; ++i)
+        ASSUME_ITS_TRUE(fossil_net_conntable_get(t, handles[i]) == objs[i]);
+
+    for (uint32_t i = 0; i < N; i += 2)
+        ASSUME_ITS_TRUE(fossil_net_conntable_release(t, handles[i]) == 0);
+    ASSUME_ITS_TRUE(fossil_net_conntable_count(t) == N / 2);
+
+    /* Dense iteration sees exactly the odd values, each once. */
+    uint64_t sum = 0;
+    uint32_t seen = 0;
+    for (uint32_t p = 0; p < fossil_net_conntable_count(t); ++p) {
+        fossil_net_handle_t h;
+        c_conntable_obj_t *o = fossil_net_conntable_at(t, p, &h);
+        ASSUME_ITS_TRUE(o != NULL);
+        ASSUME_ITS_TRUE(fossil_net_conntable_get(t, h) == o);
+        ASSUME_ITS_TRUE(o->value % 2 == 1);
+        sum += o->value;
+        seen++;
+    }
+    ASSUME_ITS_TRUE(seen == N / 2);
+    ASSUME_ITS_TRUE(sum == (uint64_t)(N / 2) * (N / 2));
+    ASSUME_ITS_TRUE(fossil_net_conntable_at(t, seen, NULL) == NULL);
+
+    fossil_net_conntable_stats_t st;
+    fossil_net_conntable_get_stats(t, &st);
+    ASSUME_ITS_TRUE(st.chunks == 4);
+    ASSUME_ITS_TRUE(st.capacity == 4 * FOSSIL_NET_CONNTABLE_CHUNK);
+    fossil_net_conntable_destroy(t);
+}
+
+FOSSIL_TEST(c_conntable_test_capacity_limit) {
+    fossil_net_conntable_t *t = fossil_net_conntable_create(8, 10);
+    ASSUME_ITS_TRUE(t != NULL);
+    fossil_net_handle_t h = FOSSIL_NET_HANDLE_NONE, last = FOSSIL_NET_HANDLE_NONE;
+    uint32_t n = 0;
+    while (fossil_net_conntable_alloc(t, &h) != NULL) {
+        last = h;
+        n++;
+    }
+    /* The limit rounds up to a whole chunk. */
+    ASSUME_ITS_TRUE(n == FOSSIL_NET_CONNTABLE_CHUNK);
+    ASSUME_ITS_TRUE(h == FOSSIL_NET_HANDLE_NONE);
+    ASSUME_ITS_TRUE(fossil_net_conntable_release(t, last) == 0);
+    ASSUME_ITS_TRUE(fossil_net_conntable_alloc(t, &h) != NULL);
+    fossil_net_conntable_destroy(t);
+}
+
+FOSSIL_TEST(c_conntable_test_invalid) {
+    ASSUME_ITS_TRUE(fossil_net_conntable_create(0, 0) == NULL);
+    fossil_net_conntable_t *t = fossil_net_conntable_create(16, 0);
+    ASSUME_ITS_TRUE(t != NULL);
+    ASSUME_ITS_TRUE(fossil_net_conntable_get(t, FOSSIL_NET_HANDLE_NONE) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_conntable_get(t, 0x10000000000ull | 5u) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_conntable_release(t, FOSSIL_NET_HANDLE_NONE) != 0);
+    ASSUME_ITS_TRUE(fossil_net_conntable_handle_of(t, NULL) == FOSSIL_NET_HANDLE_NONE);
+    ASSUME_ITS_TRUE(fossil_net_conntable_alloc(NULL, NULL) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_conntable_count(NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_conntable_get_stats(t, NULL) != 0);
+    fossil_net_conntable_destroy(t);
+    fossil_net_conntable_destroy(NULL);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_conntable_tests) {
+    FOSSIL_ADD_TEST(c_conntable_fixture, c_conntable_test_alloc_release);
+    FOSSIL_ADD_TEST(c_conntable_fixture, c_conntable_test_growth_and_iteration);
+    FOSSIL_ADD_TEST(c_conntable_fixture, c_conntable_test_capacity_limit);
+    FOSSIL_ADD_TEST(c_conntable_fixture, c_conntable_test_invalid);
+
+    FOSSIL_ADD_SUITE(c_conntable_fixture);
+} // end of tests
@@ -0,0 +1,99 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_conntable_fixture);
+
+FOSSIL_SETUP(cpp_conntable_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_conntable_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace {
+
+struct CppConnTableObj {
+    int fd;
+    uint64_t bytes;
+};
+
+} // namespace
+
+FOSSIL_TEST(cpp_conntable_test_class_basic) {
+    fossil::net::ConnTable table(sizeof(CppConnTableObj));
+    ASSUME_ITS_TRUE(table.native_handle() != nullptr);
+    fossil_net_handle_t a = FOSSIL_NET_HANDLE_NONE;
+    fossil_net_handle_t b = FOSSIL_NET_HANDLE_NONE;
+    CppConnTableObj *oa = table.alloc<CppConnTableObj>(&a);
+    CppConnTableObj *ob = table.alloc<CppConnTableObj>(&b);
+    ASSUME_ITS_TRUE(oa != nullptr && ob != nullptr && oa != ob);
+    oa->fd = 7;
+    ASSUME_ITS_TRUE(table.get<CppConnTableObj>(a)->fd == 7);
+    ASSUME_ITS_TRUE(table.count() == 2);
+    ASSUME_ITS_TRUE(table.release(a) == 0);
+    ASSUME_ITS_TRUE(table.get<CppConnTableObj>(a) == nullptr);
+    ASSUME_ITS_TRUE(table.get<CppConnTableObj>(b) == ob);
+    ASSUME_ITS_TRUE(table.stats().stale == 1);
+}
+
+FOSSIL_TEST(cpp_conntable_test_class_move) {
+    fossil::net::ConnTable table(sizeof(CppConnTableObj), 64);
+    fossil_net_handle_t h;
+    ASSUME_ITS_TRUE(table.alloc<CppConnTableObj>(&h) != nullptr);
+    fossil::net::ConnTable moved(std::move(table));
+    ASSUME_ITS_TRUE(table.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.count() == 1);
+    ASSUME_ITS_TRUE(moved.get<CppConnTableObj>(h) != nullptr);
+    moved = fossil::net::ConnTable(sizeof(CppConnTableObj));
+    ASSUME_ITS_TRUE(moved.count() == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_conntable_tests) {
+    FOSSIL_ADD_TEST(cpp_conntable_fixture, cpp_conntable_test_class_basic);
+    FOSSIL_ADD_TEST(cpp_conntable_fixture, cpp_conntable_test_class_move);
+
+    FOSSIL_ADD_SUITE(cpp_conntable_fixture);
+} // end of tests
@@ -0,0 +1,417 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+#include <direct.h>
+#define c_files_mkdir(p) _mkdir(p)
+#else
+#define c_files_mkdir(p) mkdir(p, 0755)
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_files_fixture);
+
+FOSSIL_SETUP(c_files_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_files_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+#define C_FILES_ROOT "fossil_files_c"
+#define C_FILES_BIG  (1024u * 1024u + 17u)
+
+static void c_files_write(const char *name, const void *data, size_t len) {
+    char path[256];
+    snprintf(path, sizeof(path), C_FILES_ROOT "/%s", name);
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return;
+    fwrite(data, 1, len, f);
+    fclose(f);
+}
+
+static void c_files_tree(void) {
+    c_files_mkdir(C_FILES_ROOT);
+    c_files_mkdir(C_FILES_ROOT "/sub");
+    c_files_write("index.html", "<h1>home</h1>", 13);
+    c_files_write("hello.txt", "0123456789", 10);
+    c_files_write("sub/index.html", "sub", 3);
+    c_files_write("other.css", "b{}", 3);
+    char *big = malloc(C_FILES_BIG);
+    if (big) {
+        for (uint32_t i = 0; i < C_FILES_BIG; i++)
+            big[i] = (char)('a' + i % 26u);
+        c_files_write("big.bin", big, C_FILES_BIG);
+        free(big);
+    }
+}
+
+static void c_files_cleanup(void) {
+    remove(C_FILES_ROOT "/index.html");
+    remove(C_FILES_ROOT "/hello.txt");
+    remove(C_FILES_ROOT "/other.css");
+    remove(C_FILES_ROOT "/big.bin");
+    remove(C_FILES_ROOT "/sub/index.html");
+    remove(C_FILES_ROOT "/sub");
+    remove(C_FILES_ROOT);
+}
+
+static fossil_net_httpd_t *c_files_start(fossil_net_server_t **server, fossil_net_files_t *files) {
+    fossil_net_httpd_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reactor.threads = 1;
+    *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    if (!*server)
+        return NULL;
+    fossil_net_httpd_t *h = fossil_net_httpd_create(*server, &cfg);
+    if (!h)
+        return NULL;
+    fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/static/*path", fossil_net_files_handler, files);
+    if (fossil_net_httpd_start(h) != 0) {
+        fossil_net_httpd_destroy(h);
+        return NULL;
+    }
+    return h;
+}
+
+/* Send one request with Connection: close and read the whole response. */
+static uint32_t c_files_get(fossil_net_server_t *server, const char *target, const char *headers,
+                            char *out, uint32_t size) {
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    char raw[512];
+    uint32_t sent = 0, total = 0, got = 0;
+    if (fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) != 0 ||
+        fossil_net_socket_create(&c, "tcp", "ipv4") != 0)
+        return 0;
+    if (fossil_net_socket_connect_endpoint(&c, &ep) != 0) {
+        fossil_net_socket_close(&c);
+        return 0;
+    }
+    int n = snprintf(raw, sizeof(raw), "%s HTTP/1.1\r\nHost: t\r\n%sConnection: close\r\n\r\n", target, headers);
+    fossil_net_socket_send(&c, raw, (uint32_t)n, &sent);
+    while (total < size - 1 && fossil_net_socket_receive(&c, out + total, size - 1 - total, &got) == 0 && got > 0)
+        total += got;
+    out[total] = '\0';
+    fossil_net_socket_close(&c);
+    return total;
+}
+
+static const char *c_files_body(const char *out) {
+    const char *p = strstr(out, "\r\n\r\n");
+    return p ? p + 4 : "";
+}
+
+/* Copy a header value out of a response. */
+static int c_files_header(const char *out, const char *name, char *value, size_t size) {
+    const char *p = strstr(out, name);
+    const char *e = p ? strstr(p, "\r\n") : NULL;
+    if (!p || !e)
+        return -1;
+    p += strlen(name);
+    snprintf(value, size, "%.*s", (int)(e - p), p);
+    return 0;
+}
+
+FOSSIL_TEST(c_files_test_serves_files) {
+    c_files_tree();
+    fossil_net_files_config_t fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.root = C_FILES_ROOT;
+    fc.cache_control = "max-age=60";
+    fossil_net_files_t *files = fossil_net_files_create(&fc);
+    ASSUME_ITS_TRUE(files != NULL);
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_files_start(&server, files);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[2048];
+
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 200 OK\r\n", 17) == 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Length: 10\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Type: text/plain; charset=utf-8\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "Accept-Ranges: bytes\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "Cache-Control: max-age=60\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "ETag: \"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, " GMT\r\n") != NULL);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "0123456789") == 0);
+
+    /* Index for a trailing slash, redirect without one. */
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Type: text/html; charset=utf-8\r\n") != NULL);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "<h1>home</h1>") == 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/sub?x=1", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 301 ", 13) == 0);
+    ASSUME_ITS_TRUE(strstr(out, "Location: /static/sub/?x=1\r\n") != NULL);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/sub/", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "sub") == 0);
+
+    /* HEAD: same headers, no body. */
+    ASSUME_ITS_TRUE(c_files_get(server, "HEAD /static/hello.txt", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Length: 10\r\n") != NULL);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "") == 0);
+
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_files_destroy(files);
+    c_files_cleanup();
+}
+
+FOSSIL_TEST(c_files_test_rejects_escapes) {
+    c_files_tree();
+    fossil_net_files_config_t fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.root = C_FILES_ROOT "/sub";
+    fossil_net_files_t *files = fossil_net_files_create(&fc);
+    ASSUME_ITS_TRUE(files != NULL);
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_files_start(&server, files);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[2048];
+
+    const char *bad[] = {
+        "GET /static/../hello.txt",
+        "GET /static/%2e%2e/hello.txt",
+        "GET /static/..%2fhello.txt",
+        "GET /static/%5c..%5chello.txt",
+        "GET /static/a%00b",
+        "GET /static/missing.txt"
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        ASSUME_ITS_TRUE(c_files_get(server, bad[i], "", out, sizeof(out)) > 0);
+        ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 404 ", 13) == 0);
+    }
+    fossil_net_files_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_files_get_stats(files, &st) == 0);
+    ASSUME_ITS_TRUE(st.not_found == 6);
+    ASSUME_ITS_TRUE(fossil_net_files_create(NULL) == NULL);
+
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_files_destroy(files);
+    c_files_cleanup();
+}
+
+FOSSIL_TEST(c_files_test_ranges) {
+    c_files_tree();
+    fossil_net_files_config_t fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.root = C_FILES_ROOT;
+    fossil_net_files_t *files = fossil_net_files_create(&fc);
+    ASSUME_ITS_TRUE(files != NULL);
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_files_start(&server, files);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[2048];
+
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=2-5\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 206 Partial Content\r\n", 30) == 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Range: bytes 2-5/10\r\n") != NULL);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "2345") == 0);
+
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=-3\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "789") == 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=7-\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "789") == 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=8-100\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Range: bytes 8-9/10\r\n") != NULL);
+
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=10-\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 416 ", 13) == 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Range: bytes */10\r\n") != NULL);
+
+    /* Several ranges, bad syntax and a stale If-Range get the whole file. */
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=0-1,4-5\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "0123456789") == 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=5-2\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "0123456789") == 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "Range: bytes=0-1\r\nIf-Range: \"old\"\r\n",
+                                out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 200 OK\r\n", 17) == 0);
+
+    char etag[64], headers[160];
+    ASSUME_ITS_TRUE(c_files_header(out, "ETag: ", etag, sizeof(etag)) == 0);
+    snprintf(headers, sizeof(headers), "Range: bytes=0-1\r\nIf-Range: %s\r\n", etag);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", headers, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "01") == 0);
+
+    fossil_net_files_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_files_get_stats(files, &st) == 0);
+    ASSUME_ITS_TRUE(st.partial == 5);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_files_destroy(files);
+    c_files_cleanup();
+}
+
+FOSSIL_TEST(c_files_test_conditional) {
+    c_files_tree();
+    fossil_net_files_config_t fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.root = C_FILES_ROOT;
+    fossil_net_files_t *files = fossil_net_files_create(&fc);
+    ASSUME_ITS_TRUE(files != NULL);
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_files_start(&server, files);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[2048], etag[64], modified[64], headers[160];
+
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(c_files_header(out, "ETag: ", etag, sizeof(etag)) == 0);
+    ASSUME_ITS_TRUE(c_files_header(out, "Last-Modified: ", modified, sizeof(modified)) == 0);
+
+    snprintf(headers, sizeof(headers), "If-None-Match: \"x\", W/%s\r\n", etag);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", headers, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 304 Not Modified\r\n", 27) == 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Length") == NULL);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Type") == NULL);
+    ASSUME_ITS_TRUE(strstr(out, etag) != NULL);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "") == 0);
+
+    snprintf(headers, sizeof(headers), "If-Modified-Since: %s\r\n", modified);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", headers, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 304 ", 13) == 0);
+
+    /* If-None-Match wins over If-Modified-Since; an old date does not match. */
+    snprintf(headers, sizeof(headers), "If-None-Match: \"x\"\r\nIf-Modified-Since: %s\r\n", modified);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", headers, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 200 ", 13) == 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt",
+                                "If-Modified-Since: Sun, 06 Nov 1994 08:49:37 GMT\r\n", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strncmp(out, "HTTP/1.1 200 ", 13) == 0);
+
+    fossil_net_files_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_files_get_stats(files, &st) == 0);
+    ASSUME_ITS_TRUE(st.not_modified == 2);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_files_destroy(files);
+    c_files_cleanup();
+}
+
+FOSSIL_TEST(c_files_test_descriptor_cache) {
+    c_files_tree();
+    fossil_net_files_config_t fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.root = C_FILES_ROOT;
+    fc.max_open = 1;
+    fc.revalidate_ns = 1; /* stat on every hit */
+    fossil_net_files_t *files = fossil_net_files_create(&fc);
+    ASSUME_ITS_TRUE(files != NULL);
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_files_start(&server, files);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[2048];
+
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/hello.txt", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/other.css", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Type: text/css; charset=utf-8\r\n") != NULL);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "b{}") == 0);
+
+    fossil_net_files_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_files_get_stats(files, &st) == 0);
+    ASSUME_ITS_TRUE(st.misses == 2);
+    ASSUME_ITS_TRUE(st.hits == 1);
+    ASSUME_ITS_TRUE(st.revalidations == 1);
+    ASSUME_ITS_TRUE(st.evictions == 1);
+
+    /* A replaced file is noticed on the next revalidation. */
+    c_files_write("other.css", "i{}p{}", 6);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/other.css", "", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strcmp(c_files_body(out), "i{}p{}") == 0);
+
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_files_destroy(files);
+    c_files_cleanup();
+}
+
+FOSSIL_TEST(c_files_test_large_file) {
+    c_files_tree();
+    fossil_net_files_config_t fc;
+    memset(&fc, 0, sizeof(fc));
+    fc.root = C_FILES_ROOT;
+    fossil_net_files_t *files = fossil_net_files_create(&fc);
+    ASSUME_ITS_TRUE(files != NULL);
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_files_start(&server, files);
+    ASSUME_ITS_TRUE(h != NULL);
+
+    uint32_t size = C_FILES_BIG + 1024u;
+    char *out = malloc(size);
+    ASSUME_ITS_TRUE(out != NULL);
+    ASSUME_ITS_TRUE(c_files_get(server, "GET /static/big.bin", "", out, size) > C_FILES_BIG);
+    const char *body = c_files_body(out);
+    ASSUME_ITS_TRUE(strlen(body) == C_FILES_BIG);
+    int ok = 1;
+    for (uint32_t i = 0; i < C_FILES_BIG && ok; i++)
+        ok = body[i] == (char)('a' + i % 26u);
+    ASSUME_ITS_TRUE(ok);
+    free(out);
+
+    fossil_net_files_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_files_get_stats(files, &st) == 0);
+    ASSUME_ITS_TRUE(st.bytes == C_FILES_BIG);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+    fossil_net_files_destroy(files);
+    c_files_cleanup();
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_files_tests) {
+    FOSSIL_ADD_TEST(c_files_fixture, c_files_test_serves_files);
+    FOSSIL_ADD_TEST(c_files_fixture, c_files_test_rejects_escapes);
+    FOSSIL_ADD_TEST(c_files_fixture, c_files_test_ranges);
+    FOSSIL_ADD_TEST(c_files_fixture, c_files_test_conditional);
+    FOSSIL_ADD_TEST(c_files_fixture, c_files_test_descriptor_cache);
+    FOSSIL_ADD_TEST(c_files_fixture, c_files_test_large_file);
+
+    FOSSIL_ADD_SUITE(c_files_fixture);
+} // end of tests
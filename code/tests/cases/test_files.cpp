@@ -0,0 +1,137 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <sys/stat.h>
+#if defined(_WIN32)
+#include <direct.h>
+#define cpp_files_mkdir(p) _mkdir(p)
+#else
+#define cpp_files_mkdir(p) mkdir(p, 0755)
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_files_fixture);
+
+FOSSIL_SETUP(cpp_files_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_files_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::net::Files;
+using fossil::net::Httpd;
+
+#define CPP_FILES_ROOT "fossil_files_cpp"
+
+FOSSIL_TEST(cpp_files_test_class_serve) {
+    cpp_files_mkdir(CPP_FILES_ROOT);
+    const std::string text = "static bytes";
+    FILE *f = std::fopen(CPP_FILES_ROOT "/a.txt", "wb");
+    ASSUME_ITS_TRUE(f != nullptr);
+    std::fwrite(text.data(), 1, text.size(), f);
+    std::fclose(f);
+
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != nullptr);
+    fossil_net_httpd_config_t cfg{};
+    cfg.reactor.threads = 1;
+    fossil_net_files_config_t fc{};
+    fc.root = CPP_FILES_ROOT;
+    {
+        Files files(fc);
+        ASSUME_ITS_TRUE(files.native_handle() != nullptr);
+        Httpd httpd(server, &cfg);
+        ASSUME_ITS_TRUE(files.mount(httpd, "/*path"));
+        ASSUME_ITS_TRUE(httpd.start() == 0);
+
+        fossil_net_endpoint_t ep;
+        fossil_net_socket_t c;
+        ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+        fossil::net::Request req = fossil::net::Request::get("/a.txt");
+        for (int i = 0; i < 2; i++) {
+            fossil_net_response_t res{};
+            ASSUME_ITS_TRUE(fossil_net_request_send(&c, req.native_handle(), &res) == 0);
+            ASSUME_ITS_TRUE(res.status == 200);
+            ASSUME_ITS_TRUE(std::string(static_cast<char *>(res.body), res.body_size) == text);
+            fossil_net_response_free(&res);
+        }
+        fossil_net_socket_close(&c);
+
+        fossil_net_files_stats_t st = files.stats();
+        ASSUME_ITS_TRUE(st.misses == 1);
+        ASSUME_ITS_TRUE(st.hits == 1);
+        ASSUME_ITS_TRUE(st.bytes == 2 * text.size());
+        ASSUME_ITS_TRUE(httpd.stop() == 0);
+    }
+    fossil_net_server_destroy(server);
+    std::remove(CPP_FILES_ROOT "/a.txt");
+    std::remove(CPP_FILES_ROOT);
+}
+
+FOSSIL_TEST(cpp_files_test_class_move) {
+    fossil_net_files_config_t fc{};
+    fc.root = ".";
+    Files a(fc);
+    Files b(std::move(a));
+    ASSUME_ITS_TRUE(a.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(b.native_handle() != nullptr);
+    Files c(fossil_net_files_config_t{});
+    ASSUME_ITS_TRUE(c.native_handle() == nullptr);
+    c = std::move(b);
+    ASSUME_ITS_TRUE(c.native_handle() != nullptr);
+    ASSUME_ITS_TRUE(b.native_handle() == nullptr);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_files_tests) {
+    FOSSIL_ADD_TEST(cpp_files_fixture, cpp_files_test_class_serve);
+    FOSSIL_ADD_TEST(cpp_files_fixture, cpp_files_test_class_move);
+
+    FOSSIL_ADD_SUITE(cpp_files_fixture);
+} // end of tests
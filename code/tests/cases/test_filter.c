@@ -0,0 +1,244 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+#include <stdio.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_filter_fixture);
+
+FOSSIL_SETUP(c_filter_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_filter_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+/* Ethernet + IPv4 + UDP 10.1.2.3:5000 -> 192.168.7.9:53 */
+static uint32_t c_filter_udp4(uint8_t *pkt) {
+    memset(pkt, 0, 64);
+    pkt[12] = 0x08;
+    uint8_t *ip = pkt + 14;
+    ip[0] = 0x45; ip[9] = 17;
+    ip[12] = 10; ip[13] = 1; ip[14] = 2; ip[15] = 3;
+    ip[16] = 192; ip[17] = 168; ip[18] = 7; ip[19] = 9;
+    uint8_t *udp = ip + 20;
+    udp[0] = 5000 >> 8; udp[1] = 5000 & 0xff;
+    udp[2] = 0; udp[3] = 53;
+    return 14 + 20 + 8 + 4;
+}
+
+/* Ethernet + IPv6 + TCP [2001:db8::1]:443 -> [2001:db8::2]:40000 */
+static uint32_t c_filter_tcp6(uint8_t *pkt) {
+    memset(pkt, 0, 96);
+    pkt[12] = 0x86; pkt[13] = 0xdd;
+    uint8_t *ip = pkt + 14;
+    ip[0] = 0x60; ip[6] = 6;
+    ip[8] = 0x20; ip[9] = 0x01; ip[10] = 0x0d; ip[11] = 0xb8; ip[23] = 1;
+    ip[24] = 0x20; ip[25] = 0x01; ip[26] = 0x0d; ip[27] = 0xb8; ip[39] = 2;
+    uint8_t *tcp = ip + 40;
+    tcp[0] = 443 >> 8; tcp[1] = 443 & 0xff;
+    tcp[2] = 40000 >> 8; tcp[3] = 40000 & 0xff;
+    return 14 + 40 + 20;
+}
+
+static bool c_filter_match(const char *expr, const uint8_t *pkt, uint32_t len) {
+    fossil_net_filter_t *f = fossil_net_filter_compile(expr);
+    if (!f) return false;
+    bool hit = fossil_net_filter_run(f, pkt, len, 14) != 0;
+    fossil_net_filter_destroy(f);
+    return hit;
+}
+
+FOSSIL_TEST(c_filter_test_protocol_and_port) {
+    uint8_t pkt[96];
+    uint32_t len = c_filter_udp4(pkt);
+    ASSUME_ITS_TRUE(c_filter_match("udp", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("ip", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("tcp", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("ip6", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("udp and dst port 53", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("udp port 5000", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("src port 53", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("tcp || port 53", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("not udp", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("", pkt, len));
+
+    // Non-first fragments have no ports to match
+    pkt[14 + 7] = 0x10;
+    ASSUME_ITS_TRUE(!c_filter_match("port 53", pkt, len));
+}
+
+FOSSIL_TEST(c_filter_test_host_and_net) {
+    uint8_t pkt[96];
+    uint32_t len = c_filter_udp4(pkt);
+    ASSUME_ITS_TRUE(c_filter_match("host 10.1.2.3", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("src host 10.1.2.3", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("dst host 10.1.2.3", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("dst net 192.168.0.0/16", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("net 172.16.0.0/12", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("net 0.0.0.0/0", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("(net 172.16.0.0/12 or net 10.0.0.0/8) and udp", pkt, len));
+
+    len = c_filter_tcp6(pkt);
+    ASSUME_ITS_TRUE(c_filter_match("ip6 and tcp", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("src port 443", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("dst host 2001:db8::2", pkt, len));
+    ASSUME_ITS_TRUE(c_filter_match("net 2001:db8::/32", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("host 10.1.2.3", pkt, len));
+    ASSUME_ITS_TRUE(!c_filter_match("icmp6", pkt, len));
+}
+
+FOSSIL_TEST(c_filter_test_syntax_errors) {
+    ASSUME_ITS_TRUE(fossil_net_filter_compile("port") == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_compile("port 70000") == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_compile("host 10.0.0.0/8") == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_compile("(udp") == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_compile("udp and") == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_compile("bogus") == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_compile(NULL) == NULL);
+}
+
+FOSSIL_TEST(c_filter_test_attach_udp_socket) {
+    fossil_net_socket_t rx, a, b;
+    fossil_net_endpoint_t ep, a_ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&rx, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&a, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&b, "udp", "ipv4") == 0);
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    fossil_net_socket_bind_endpoint(&rx, &ep);
+    fossil_net_socket_bind_endpoint(&a, &ep);
+    fossil_net_socket_get_local_endpoint(&rx, &ep);
+    fossil_net_socket_get_local_endpoint(&a, &a_ep);
+
+    char expr[64];
+    snprintf(expr, sizeof(expr), "udp and src port %u", (unsigned)a_ep.port);
+    fossil_net_filter_t *f = fossil_net_filter_compile(expr);
+    ASSUME_ITS_TRUE(f != NULL);
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(fossil_net_filter_attach(&rx, f) == 0);
+    fossil_net_socket_send_to(&b, "drop", 4, &ep, NULL);
+    fossil_net_socket_send_to(&a, "keep", 4, &ep, NULL);
+
+    // The datagram from b never reaches the socket
+    char buf[8];
+    uint32_t got = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_receive(&rx, buf, sizeof(buf), &got) == 0);
+    ASSUME_ITS_TRUE(got == 4 && memcmp(buf, "keep", 4) == 0);
+    ASSUME_ITS_TRUE(fossil_net_filter_detach(&rx) == 0);
+#endif
+    fossil_net_filter_destroy(f);
+    fossil_net_socket_close(&a);
+    fossil_net_socket_close(&b);
+    fossil_net_socket_close(&rx);
+}
+
+FOSSIL_TEST(c_filter_test_reuseport_cpu) {
+    const int32_t cpus[2] = { 3, 1 };
+    fossil_net_filter_t *f = fossil_net_filter_reuseport_cpu(cpus, 2);
+    ASSUME_ITS_TRUE(f != NULL);
+    uint32_t count = 0;
+    const fossil_net_filter_insn_t *insns = fossil_net_filter_program(f, &count);
+    ASSUME_ITS_TRUE(count == 7);
+    ASSUME_ITS_TRUE(insns[0].code == 0x20 && insns[0].k == 0xfffff024u); // ld cpu
+    ASSUME_ITS_TRUE(insns[1].k == 3 && insns[1].jt == 3);                // jeq 3 -> ret 0
+    ASSUME_ITS_TRUE(insns[2].k == 1 && insns[2].jt == 3);                // jeq 1 -> ret 1
+    ASSUME_ITS_TRUE(insns[3].code == 0x94 && insns[3].k == 2);           // cpu % 2
+    ASSUME_ITS_TRUE(insns[5].code == 0x06 && insns[5].k == 0);
+    ASSUME_ITS_TRUE(insns[6].code == 0x06 && insns[6].k == 1);
+    ASSUME_ITS_TRUE(fossil_net_filter_run(f, "x", 1, 0) == 0);
+
+    const int32_t bad[1] = { -1 };
+    ASSUME_ITS_TRUE(fossil_net_filter_reuseport_cpu(bad, 1) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_reuseport_cpu(cpus, 0) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_filter_reuseport_cpu(cpus, 255) == NULL);
+
+    // Two sockets in one group; every datagram reaches one of them
+    fossil_net_socket_t rx[2], tx;
+    fossil_net_endpoint_t ep;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&rx[0], "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&rx[1], "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&tx, "udp", "ipv4") == 0);
+    fossil_net_socket_set_reuseport(&rx[0], true);
+    fossil_net_socket_set_reuseport(&rx[1], true);
+    fossil_net_socket_bind_endpoint(&rx[0], &ep);
+    fossil_net_socket_get_local_endpoint(&rx[0], &ep);
+    fossil_net_socket_bind_endpoint(&rx[1], &ep);
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(fossil_net_filter_attach_reuseport(&rx[1], f) == 0);
+    for (int i = 0; i < 4; i++)
+        fossil_net_socket_send_to(&tx, "cpu", 3, &ep, NULL);
+    fossil_net_socket_set_blocking(&rx[0], false);
+    fossil_net_socket_set_blocking(&rx[1], false);
+    fossil_net_socket_t *set[2] = { &rx[0], &rx[1] };
+    int received = 0;
+    for (int round = 0; round < 50 && received < 4; round++) {
+        fossil_net_socket_poll(set, 2, 20);
+        for (int i = 0; i < 2; i++) {
+            char buf[8];
+            uint32_t got = 0;
+            while (fossil_net_socket_receive(&rx[i], buf, sizeof(buf), &got) == 0 && got == 3)
+                received++;
+        }
+    }
+    ASSUME_ITS_TRUE(received == 4);
+#else
+    ASSUME_ITS_TRUE(fossil_net_filter_attach_reuseport(&rx[1], f) != 0);
+#endif
+    fossil_net_filter_destroy(f);
+    fossil_net_socket_close(&tx);
+    fossil_net_socket_close(&rx[0]);
+    fossil_net_socket_close(&rx[1]);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_filter_tests) {
+    FOSSIL_ADD_TEST(c_filter_fixture, c_filter_test_protocol_and_port);
+    FOSSIL_ADD_TEST(c_filter_fixture, c_filter_test_host_and_net);
+    FOSSIL_ADD_TEST(c_filter_fixture, c_filter_test_syntax_errors);
+    FOSSIL_ADD_TEST(c_filter_fixture, c_filter_test_attach_udp_socket);
+    FOSSIL_ADD_TEST(c_filter_fixture, c_filter_test_reuseport_cpu);
+
+    FOSSIL_ADD_SUITE(c_filter_fixture);
+} // end of tests
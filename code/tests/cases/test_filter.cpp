@@ -0,0 +1,87 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_filter_fixture);
+
+FOSSIL_SETUP(cpp_filter_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_filter_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_filter_test_class_compile_and_run) {
+    fossil::net::Filter ok("tcp and dst port 80");
+    ASSUME_ITS_TRUE(ok.valid());
+    fossil::net::Filter bad("tcp and and");
+    ASSUME_ITS_TRUE(!bad.valid());
+
+    // Bare IPv4/TCP header (no link layer) to port 80
+    uint8_t pkt[40] = {0};
+    pkt[0] = 0x45; pkt[9] = 6; pkt[22] = 0; pkt[23] = 80;
+    ASSUME_ITS_TRUE(ok.run(pkt, sizeof(pkt), 0) != 0);
+    pkt[23] = 81;
+    ASSUME_ITS_TRUE(ok.run(pkt, sizeof(pkt), 0) == 0);
+}
+
+FOSSIL_TEST(cpp_filter_test_class_program_access) {
+    fossil::net::Filter all("");
+    uint32_t count = 0;
+    const fossil_net_filter_insn_t *insns = fossil_net_filter_program(all.native_handle(), &count);
+    ASSUME_ITS_TRUE(insns != nullptr && count == 1);
+    ASSUME_ITS_TRUE(insns[0].k == 0xffffffffu);
+
+    fossil_net_filter_t *copy = fossil_net_filter_create(insns, count);
+    ASSUME_ITS_TRUE(copy != nullptr);
+    fossil_net_filter_destroy(copy);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_filter_tests) {
+    FOSSIL_ADD_TEST(cpp_filter_fixture, cpp_filter_test_class_compile_and_run);
+    FOSSIL_ADD_TEST(cpp_filter_fixture, cpp_filter_test_class_program_access);
+
+    FOSSIL_ADD_SUITE(cpp_filter_fixture);
+} // end of tests
@@ -0,0 +1,178 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_flow_fixture);
+
+FOSSIL_SETUP(c_flow_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_flow_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static fossil_net_flow_key_t c_flow_key(uint32_t n) {
+    fossil_net_flow_key_t k;
+    memset(&k, 0, sizeof(k));
+    k.family = FOSSIL_NET_SOCKET_FAMILY_IPV4;
+    k.src[0] = 10; k.src[2] = (uint8_t)(n >> 8); k.src[3] = (uint8_t)n;
+    k.dst[0] = 10; k.dst[3] = 1;
+    k.src_port = (uint16_t)(1024 + n);
+    k.dst_port = 443;
+    k.proto = 6;
+    return k;
+}
+
+FOSSIL_TEST(c_flow_test_update_and_lookup) {
+    fossil_net_flow_table_t *t = fossil_net_flow_create(1024, 8);
+    ASSUME_ITS_TRUE(t != NULL);
+    fossil_net_flow_key_t a = c_flow_key(1), b = c_flow_key(2);
+
+    ASSUME_ITS_TRUE(fossil_net_flow_update(t, &a, 100, 0x02, 1000) == 0);
+    ASSUME_ITS_TRUE(fossil_net_flow_update(t, &a, 60, 0x10, 2000) == 0);
+    ASSUME_ITS_TRUE(fossil_net_flow_update(t, &b, 40, 0x01, 1500) == 0);
+
+    fossil_net_flow_record_t r;
+    ASSUME_ITS_TRUE(fossil_net_flow_lookup(t, &a, &r) == 0);
+    ASSUME_ITS_TRUE(r.packets == 2 && r.bytes == 160 && r.tcp_flags == 0x12);
+    ASSUME_ITS_TRUE(r.first_ns == 1000 && r.last_ns == 2000);
+    ASSUME_ITS_TRUE(memcmp(&r.key, &a, sizeof(a)) == 0);
+
+    fossil_net_flow_key_t missing = c_flow_key(3);
+    ASSUME_ITS_TRUE(fossil_net_flow_lookup(t, &missing, &r) != 0);
+
+    fossil_net_flow_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_flow_get_stats(t, &st) == 0);
+    ASSUME_ITS_TRUE(st.flows == 2 && st.inserts == 2);
+    fossil_net_flow_destroy(t);
+}
+
+FOSSIL_TEST(c_flow_test_account_packet) {
+    uint8_t frame[128];
+    fossil_net_builder_t b;
+    fossil_net_endpoint_t s, d;
+    fossil_net_endpoint_parse(&s, "192.0.2.1", 0);
+    fossil_net_endpoint_parse(&d, "192.0.2.2", 0);
+    fossil_net_builder_init(&b, frame, sizeof(frame));
+    fossil_net_builder_ip(&b, &s, &d, 6, 64);
+    fossil_net_builder_tcp(&b, 5000, 80, 1, 0, FOSSIL_NET_BUILDER_TCP_SYN, 1024);
+    fossil_net_builder_payload(&b, NULL, 12);
+    uint32_t len = 0;
+    fossil_net_builder_finish(&b, &len);
+
+    fossil_net_packet_t p;
+    ASSUME_ITS_TRUE(fossil_net_packet_decode(frame, len, FOSSIL_NET_PACKET_LINK_IP, &p) == 0);
+    fossil_net_flow_table_t *t = fossil_net_flow_create(64, 0);
+    ASSUME_ITS_TRUE(fossil_net_flow_account(t, &p, 0) == 0);
+    // A truncated capture still counts the full IP length
+    p.length = 40;
+    ASSUME_ITS_TRUE(fossil_net_flow_account(t, &p, 0) == 0);
+
+    fossil_net_flow_key_t k;
+    ASSUME_ITS_TRUE(fossil_net_flow_key_from_packet(&p, &k) == 0);
+    ASSUME_ITS_TRUE(k.src_port == 5000 && k.dst_port == 80 && k.proto == 6 && k.src[3] == 1);
+    fossil_net_flow_record_t r;
+    ASSUME_ITS_TRUE(fossil_net_flow_lookup(t, &k, &r) == 0);
+    ASSUME_ITS_TRUE(r.packets == 2 && r.bytes == 2u * 52u && r.tcp_flags == 0x02);
+    fossil_net_flow_destroy(t);
+}
+
+FOSSIL_TEST(c_flow_test_expire_and_snapshot) {
+    fossil_net_flow_table_t *t = fossil_net_flow_create(4096, 4);
+    for (uint32_t i = 0; i < 3000; ++i) {
+        fossil_net_flow_key_t k = c_flow_key(i);
+        ASSUME_ITS_TRUE(fossil_net_flow_update(t, &k, 10, 0, (i & 1) ? 5000 : 100) == 0);
+    }
+
+    static fossil_net_flow_record_t recs[4096];
+    ASSUME_ITS_TRUE(fossil_net_flow_snapshot(t, recs, 4096) == 3000);
+
+    // Even flows are idle; collect them in two bounded passes
+    uint32_t first = fossil_net_flow_expire(t, 6000, 2000, recs, 1000);
+    uint32_t second = fossil_net_flow_expire(t, 6000, 2000, recs + 1000, 1000);
+    ASSUME_ITS_TRUE(first == 1000 && second == 500);
+    for (uint32_t i = 0; i < 1500; ++i) ASSUME_ITS_TRUE(recs[i].last_ns == 100);
+
+    // Survivors remain reachable after backward-shift deletion
+    fossil_net_flow_record_t r;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        fossil_net_flow_key_t k = c_flow_key(i);
+        ASSUME_ITS_TRUE((fossil_net_flow_lookup(t, &k, &r) == 0) == ((i & 1) != 0));
+    }
+    ASSUME_ITS_TRUE(fossil_net_flow_snapshot(t, recs, 4096) == 1500);
+
+    fossil_net_flow_stats_t st;
+    fossil_net_flow_get_stats(t, &st);
+    ASSUME_ITS_TRUE(st.flows == 1500 && st.expired == 1500);
+    fossil_net_flow_destroy(t);
+}
+
+FOSSIL_TEST(c_flow_test_full_shard_drops) {
+    fossil_net_flow_table_t *t = fossil_net_flow_create(16, 1);
+    uint32_t ok = 0;
+    for (uint32_t i = 0; i < 32; ++i) {
+        fossil_net_flow_key_t k = c_flow_key(i);
+        if (fossil_net_flow_update(t, &k, 1, 0, 1) == 0) ok++;
+    }
+    fossil_net_flow_stats_t st;
+    fossil_net_flow_get_stats(t, &st);
+    ASSUME_ITS_TRUE(ok == 16 && st.dropped == 16);
+
+    // Existing flows still update when full
+    fossil_net_flow_key_t k = c_flow_key(0);
+    ASSUME_ITS_TRUE(fossil_net_flow_update(t, &k, 1, 0, 2) == 0);
+    ASSUME_ITS_TRUE(fossil_net_flow_expire(t, 100, 1, NULL, 0) == 16);
+    fossil_net_flow_destroy(t);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_flow_tests) {
+    FOSSIL_ADD_TEST(c_flow_fixture, c_flow_test_update_and_lookup);
+    FOSSIL_ADD_TEST(c_flow_fixture, c_flow_test_account_packet);
+    FOSSIL_ADD_TEST(c_flow_fixture, c_flow_test_expire_and_snapshot);
+    FOSSIL_ADD_TEST(c_flow_fixture, c_flow_test_full_shard_drops);
+
+    FOSSIL_ADD_SUITE(c_flow_fixture);
+} // end of tests
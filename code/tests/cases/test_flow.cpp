@@ -0,0 +1,90 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <cstring>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_flow_fixture);
+
+FOSSIL_SETUP(cpp_flow_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_flow_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_flow_test_class) {
+    fossil::net::FlowTable table(256);
+    ASSUME_ITS_TRUE(table.native_handle() != nullptr);
+    fossil_net_flow_key_t k{};
+    k.family = FOSSIL_NET_SOCKET_FAMILY_IPV6;
+    k.src[15] = 1;
+    k.dst[15] = 2;
+    k.proto = 17;
+    k.src_port = 53;
+    k.dst_port = 5353;
+    ASSUME_ITS_TRUE(table.update(k, 100, 0, 10));
+    ASSUME_ITS_TRUE(table.update(k, 100, 0, 20));
+    fossil_net_flow_record_t r{};
+    ASSUME_ITS_TRUE(table.lookup(k, r));
+    ASSUME_ITS_TRUE(r.packets == 2 && r.bytes == 200);
+    ASSUME_ITS_TRUE(table.stats().flows == 1);
+    ASSUME_ITS_TRUE(table.expire(100, 50) == 1);
+    ASSUME_ITS_TRUE(table.stats().flows == 0);
+}
+
+FOSSIL_TEST(cpp_flow_test_class_move) {
+    fossil::net::FlowTable a(64, 2);
+    fossil::net::FlowTable b(std::move(a));
+    ASSUME_ITS_TRUE(a.native_handle() == nullptr && b.native_handle() != nullptr);
+    fossil_net_flow_record_t recs[4];
+    ASSUME_ITS_TRUE(b.snapshot(recs, 4) == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_flow_tests) {
+    FOSSIL_ADD_TEST(cpp_flow_fixture, cpp_flow_test_class);
+    FOSSIL_ADD_TEST(cpp_flow_fixture, cpp_flow_test_class_move);
+
+    FOSSIL_ADD_SUITE(cpp_flow_fixture);
+} // end of tests
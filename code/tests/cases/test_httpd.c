@@ -0,0 +1,389 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_httpd_fixture);
+
+FOSSIL_SETUP(c_httpd_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_httpd_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+typedef struct c_httpd_deferred {
+    fossil_net_reactor_t *reactor;
+    fossil_net_http_exchange_t *ex;
+} c_httpd_deferred_t;
+
+static void c_httpd_echo(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    (void)user;
+    fossil_net_slice_t word;
+    fossil_net_http_param(ex, "word", &word);
+    fossil_net_http_add_header(ex, "X-Echo", "1");
+    fossil_net_http_respond(ex, 200, "text/plain", word.ptr, word.len);
+}
+
+static void c_httpd_length(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    (void)user;
+    char out[32];
+    fossil_net_slice_t body = fossil_net_http_body(ex);
+    int n = snprintf(out, sizeof(out), "%u:%.*s", body.len, (int)body.len, body.ptr);
+    fossil_net_http_respond(ex, 200, "text/plain", out, (uint32_t)n);
+}
+
+static void c_httpd_resume(fossil_net_conn_t *conn, void *arg) {
+    if (conn)
+        fossil_net_http_respond((fossil_net_http_exchange_t *)arg, 200, "text/plain", "slow", 4);
+}
+
+/* Defers: the response is sent from a task after the current batch. */
+static void c_httpd_slow(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    fossil_net_reactor_t *reactor = (fossil_net_reactor_t *)user;
+    fossil_net_reactor_post_conn(reactor, fossil_net_conn_id(fossil_net_http_conn(ex)), c_httpd_resume, ex);
+}
+
+static fossil_net_httpd_t *c_httpd_start(fossil_net_server_t **server, uint32_t max_requests) {
+    fossil_net_httpd_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reactor.threads = 1;
+    cfg.max_requests = max_requests;
+    *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    if (!*server)
+        return NULL;
+    fossil_net_httpd_t *h = fossil_net_httpd_create(*server, &cfg);
+    if (!h)
+        return NULL;
+    fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/echo/:word", c_httpd_echo, NULL);
+    fossil_net_httpd_route(h, FOSSIL_NET_HTTP_POST, "/length", c_httpd_length, NULL);
+    fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/slow", c_httpd_slow, fossil_net_httpd_reactor(h));
+    if (fossil_net_httpd_start(h) != 0) {
+        fossil_net_httpd_destroy(h);
+        return NULL;
+    }
+    return h;
+}
+
+static int c_httpd_connect(fossil_net_server_t *server, fossil_net_socket_t *c) {
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) != 0 ||
+        fossil_net_socket_create(c, "tcp", "ipv4") != 0)
+        return -1;
+    return fossil_net_socket_connect_endpoint(c, &ep);
+}
+
+/* Send raw bytes, then read until the server closes. */
+static uint32_t c_httpd_exchange(fossil_net_server_t *server, const char *raw, char *out, uint32_t size) {
+    fossil_net_socket_t c;
+    uint32_t sent = 0, total = 0, got = 0;
+    if (c_httpd_connect(server, &c) != 0)
+        return 0;
+    fossil_net_socket_send(&c, raw, (uint32_t)strlen(raw), &sent);
+    while (total < size - 1 && fossil_net_socket_receive(&c, out + total, size - 1 - total, &got) == 0 && got > 0)
+        total += got;
+    out[total] = '\0';
+    fossil_net_socket_close(&c);
+    return total;
+}
+
+static int c_httpd_count(const char *s, const char *needle) {
+    int n = 0;
+    for (const char *p = strstr(s, needle); p; p = strstr(p + 1, needle))
+        n++;
+    return n;
+}
+
+FOSSIL_TEST(c_httpd_test_pipelined_in_order) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 0);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[4096];
+    const char *raw =
+        "GET /echo/one HTTP/1.1\r\nHost: t\r\n\r\n"
+        "GET /echo/two HTTP/1.1\r\nHost: t\r\n\r\n"
+        "GET /echo/three HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n";
+    ASSUME_ITS_TRUE(c_httpd_exchange(server, raw, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(c_httpd_count(out, "HTTP/1.1 200 OK\r\n") == 3);
+    const char *one = strstr(out, "\r\n\r\none");
+    const char *two = strstr(out, "\r\n\r\ntwo");
+    const char *three = strstr(out, "\r\n\r\nthree");
+    ASSUME_ITS_TRUE(one && two && three && one < two && two < three);
+    ASSUME_ITS_TRUE(c_httpd_count(out, "Connection: close") == 1);
+    ASSUME_ITS_TRUE(strstr(three, "Connection: close") == NULL); /* only on the last */
+
+    fossil_net_httpd_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_httpd_get_stats(h, &st) == 0);
+    ASSUME_ITS_TRUE(st.requests == 3);
+    ASSUME_ITS_TRUE(st.reused == 2);
+    ASSUME_ITS_TRUE(st.pipelined == 2);
+    ASSUME_ITS_TRUE(st.flushes == 1);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_deferred_keeps_order) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 0);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[4096];
+    const char *raw =
+        "GET /slow HTTP/1.1\r\nHost: t\r\n\r\n"
+        "GET /echo/fast HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n";
+    ASSUME_ITS_TRUE(c_httpd_exchange(server, raw, out, sizeof(out)) > 0);
+    const char *slow = strstr(out, "\r\n\r\nslow");
+    const char *fast = strstr(out, "\r\n\r\nfast");
+    ASSUME_ITS_TRUE(slow && fast && slow < fast);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_keepalive_client) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 0);
+    ASSUME_ITS_TRUE(h != NULL);
+    fossil_net_socket_t c;
+    ASSUME_ITS_TRUE(c_httpd_connect(server, &c) == 0);
+
+    /* Several requests over one socket with the stock client. */
+    fossil_net_request_t req;
+    fossil_net_response_t res;
+    const char *words[] = { "alpha", "beta", "gamma" };
+    for (int i = 0; i < 3; i++) {
+        char url[64];
+        snprintf(url, sizeof(url), "/echo/%s", words[i]);
+        fossil_net_request_init(&req, "get", url);
+        ASSUME_ITS_TRUE(fossil_net_request_send(&c, &req, &res) == 0);
+        ASSUME_ITS_TRUE(res.status == 200);
+        ASSUME_ITS_TRUE(res.body_size == strlen(words[i]) && memcmp(res.body, words[i], res.body_size) == 0);
+        fossil_net_response_free(&res);
+    }
+
+    fossil_net_request_init(&req, "post", "/echo/x");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&c, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.status == 405);
+    char allow[64];
+    ASSUME_ITS_TRUE(fossil_net_response_get_header(&res, "Allow", allow, sizeof(allow)) == 0);
+    ASSUME_ITS_TRUE(strcmp(allow, "GET, HEAD") == 0);
+    fossil_net_response_free(&res);
+
+    fossil_net_request_init(&req, "get", "/missing");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&c, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.status == 404);
+    fossil_net_response_free(&res);
+
+    fossil_net_httpd_stats_t st;
+    fossil_net_httpd_get_stats(h, &st);
+    ASSUME_ITS_TRUE(st.requests == 5);
+    ASSUME_ITS_TRUE(st.reused == 4);
+    fossil_net_socket_close(&c);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_bodies_and_head) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 0);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[4096];
+    const char *raw =
+        "POST /length HTTP/1.1\r\nHost: t\r\nContent-Length: 5\r\n\r\nhello"
+        "POST /length HTTP/1.1\r\nHost: t\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n"
+        "HEAD /echo/body HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n";
+    ASSUME_ITS_TRUE(c_httpd_exchange(server, raw, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "\r\n\r\n5:hello") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "\r\n\r\n5:abcde") != NULL);
+    /* HEAD: Content-Length of the GET body, but no body bytes */
+    const char *head = strstr(out, "Content-Length: 4\r\n");
+    ASSUME_ITS_TRUE(head != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "body") == NULL);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_errors_close) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 0);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[4096];
+    const char *raw =
+        "GET /echo/ok HTTP/1.1\r\nHost: t\r\n\r\n"
+        "POST /length HTTP/1.1\r\nHost: t\r\nContent-Length: 1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "GET /echo/never HTTP/1.1\r\nHost: t\r\n\r\n";
+    ASSUME_ITS_TRUE(c_httpd_exchange(server, raw, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "HTTP/1.1 200 OK") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "HTTP/1.1 400 Bad Request") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "never") == NULL);
+
+    fossil_net_httpd_stats_t st;
+    fossil_net_httpd_get_stats(h, &st);
+    ASSUME_ITS_TRUE(st.errors == 1);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_max_requests) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 2);
+    ASSUME_ITS_TRUE(h != NULL);
+    char out[4096];
+    const char *raw =
+        "GET /echo/a HTTP/1.1\r\nHost: t\r\n\r\n"
+        "GET /echo/b HTTP/1.1\r\nHost: t\r\n\r\n"
+        "GET /echo/c HTTP/1.1\r\nHost: t\r\n\r\n";
+    ASSUME_ITS_TRUE(c_httpd_exchange(server, raw, out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(c_httpd_count(out, "HTTP/1.1 200 OK") == 2);
+    ASSUME_ITS_TRUE(c_httpd_count(out, "Connection: close") == 1);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_shed_rejects_requests) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reactor.threads = 1;
+    server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_httpd_t *h = fossil_net_httpd_create(server, &cfg);
+    fossil_net_shed_t *shed = fossil_net_shed_create(NULL);
+    ASSUME_ITS_TRUE(h != NULL && shed != NULL);
+    ASSUME_ITS_TRUE(fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/echo/:word", c_httpd_echo, NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_set_shed(h, shed) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_start(h) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_set_shed(h, NULL) != 0);
+
+    fossil_net_socket_t c;
+    fossil_net_request_t req;
+    fossil_net_response_t res;
+    ASSUME_ITS_TRUE(c_httpd_connect(server, &c) == 0);
+    fossil_net_request_init(&req, "get", "/echo/x");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&c, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.status == 200);
+    fossil_net_response_free(&res);
+
+    /* Already-open connections are shed per request. */
+    fossil_net_shed_force(shed, FOSSIL_NET_SHED_REJECT);
+    ASSUME_ITS_TRUE(fossil_net_request_send(&c, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.status == 503);
+    fossil_net_response_free(&res);
+    fossil_net_socket_close(&c);
+
+    fossil_net_httpd_stats_t st;
+    fossil_net_httpd_get_stats(h, &st);
+    ASSUME_ITS_TRUE(st.shed == 1);
+    fossil_net_httpd_destroy(h);
+    fossil_net_shed_destroy(shed);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_drain) {
+    fossil_net_server_t *server = NULL;
+    fossil_net_httpd_t *h = c_httpd_start(&server, 0);
+    ASSUME_ITS_TRUE(h != NULL);
+
+    /* An idle keep-alive connection and one halfway through a request. */
+    fossil_net_socket_t idle, busy;
+    fossil_net_request_t req;
+    fossil_net_response_t res;
+    ASSUME_ITS_TRUE(c_httpd_connect(server, &idle) == 0);
+    fossil_net_request_init(&req, "get", "/echo/idle");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&idle, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.status == 200);
+    fossil_net_response_free(&res);
+    ASSUME_ITS_TRUE(c_httpd_connect(server, &busy) == 0);
+    const char *head = "GET /echo/busy HTTP/1.1\r\nHost: x\r\n";
+    uint32_t sent = 0, got = 0, total = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&busy, head, (uint32_t)strlen(head), &sent) == 0);
+    struct timespec ts = { 0, 50000000L };
+    nanosleep(&ts, NULL);
+
+    ASSUME_ITS_TRUE(fossil_net_httpd_drain(h) == 0);
+    char out[1024];
+    ASSUME_ITS_TRUE(fossil_net_socket_receive(&idle, out, sizeof(out), &got) == 0);
+    ASSUME_ITS_TRUE(got == 0);
+
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&busy, "\r\n", 2, &sent) == 0);
+    while (total < sizeof(out) - 1 &&
+           fossil_net_socket_receive(&busy, out + total, sizeof(out) - 1 - total, &got) == 0 && got > 0)
+        total += got;
+    out[total] = '\0';
+    ASSUME_ITS_TRUE(strstr(out, "HTTP/1.1 200") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "Connection: close") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "\r\n\r\nbusy") != NULL);
+
+    ASSUME_ITS_TRUE(fossil_net_reactor_wait_drained(fossil_net_httpd_reactor(h), 2000000000ull) == 0);
+    fossil_net_socket_close(&idle);
+    fossil_net_socket_close(&busy);
+    fossil_net_httpd_destroy(h);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_httpd_test_invalid) {
+    ASSUME_ITS_TRUE(fossil_net_httpd_create(NULL, NULL) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_httpd_route(NULL, FOSSIL_NET_HTTP_GET, "/", c_httpd_echo, NULL) == -1);
+    ASSUME_ITS_TRUE(fossil_net_http_respond(NULL, 200, NULL, NULL, 0) == -1);
+    ASSUME_ITS_TRUE(strcmp(fossil_net_http_reason(404), "Not Found") == 0);
+    ASSUME_ITS_TRUE(strcmp(fossil_net_http_reason(799), "Unknown") == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_httpd_tests) {
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_pipelined_in_order);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_deferred_keeps_order);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_keepalive_client);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_bodies_and_head);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_errors_close);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_max_requests);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_shed_rejects_requests);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_drain);
+    FOSSIL_ADD_TEST(c_httpd_fixture, c_httpd_test_invalid);
+
+    FOSSIL_ADD_SUITE(c_httpd_fixture);
+} // end of tests
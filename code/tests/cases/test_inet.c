@@ -0,0 +1,212 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_inet_fixture);
+
+FOSSIL_SETUP(c_inet_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_inet_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_inet_test_ipv4_parse_and_format) {
+    uint8_t ip[4];
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_parse("192.168.0.255", ip) == 0);
+    ASSUME_ITS_TRUE(ip[0] == 192 && ip[1] == 168 && ip[2] == 0 && ip[3] == 255);
+
+    char buf[FOSSIL_NET_INET_IPV4_STRLEN];
+    int n = fossil_net_inet_ipv4_format(ip, buf, sizeof(buf));
+    ASSUME_ITS_TRUE(n == 13 && strcmp(buf, "192.168.0.255") == 0);
+
+    // Same rules as inet_pton: no leading zeros, no overflow, exactly 4 parts
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_parse("256.1.1.1", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_parse("01.1.1.1", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_parse("1.1.1", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_parse("1.1.1.1.", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_parse("", ip) != 0);
+
+    // Too small a buffer is rejected rather than truncated
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv4_format(ip, buf, 8) == -1);
+}
+
+FOSSIL_TEST(c_inet_test_ipv6_parse_and_format) {
+    static const char *cases[][2] = {
+        { "::", "::" },
+        { "::1", "::1" },
+        { "2001:DB8:0:0:0:0:2:1", "2001:db8::2:1" },
+        { "2001:db8:0:1:1:1:1:1", "2001:db8:0:1:1:1:1:1" },
+        { "2001:0:0:1:0:0:0:1", "2001:0:0:1::1" },
+        { "fe80::", "fe80::" },
+        { "::ffff:10.0.0.1", "::ffff:10.0.0.1" },
+        { "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7:8" },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        uint8_t ip[16];
+        char buf[FOSSIL_NET_INET_IPV6_STRLEN];
+        ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse(cases[i][0], ip) == 0);
+        ASSUME_ITS_TRUE(fossil_net_inet_ipv6_format(ip, buf, sizeof(buf)) > 0);
+        ASSUME_ITS_TRUE(strcmp(buf, cases[i][1]) == 0);
+    }
+
+    uint8_t ip[16];
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse(":1", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse("1::2::3", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse("12345::", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse("1:2:3:4:5:6:7:8:9", ip) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse("1:", ip) != 0);
+}
+
+FOSSIL_TEST(c_inet_test_matches_libc) {
+#if !defined(_WIN32)
+    uint32_t seed = 12345;
+    for (int i = 0; i < 2000; ++i) {
+        uint8_t ip[16];
+        for (int b = 0; b < 16; ++b) {
+            seed = seed * 1103515245u + 12345u;
+            // bias towards zero groups so "::" compression is exercised
+            ip[b] = (seed >> 24) & 1 ? 0 : (uint8_t)(seed >> 16);
+        }
+        char ours[FOSSIL_NET_INET_IPV6_STRLEN], libc[INET6_ADDRSTRLEN];
+        fossil_net_inet_ipv6_format(ip, ours, sizeof(ours));
+        inet_ntop(AF_INET6, ip, libc, sizeof(libc));
+        ASSUME_ITS_TRUE(strcmp(ours, libc) == 0);
+
+        uint8_t back[16];
+        ASSUME_ITS_TRUE(fossil_net_inet_ipv6_parse(libc, back) == 0);
+        ASSUME_ITS_TRUE(memcmp(back, ip, 16) == 0);
+
+        fossil_net_inet_ipv4_format(ip, ours, sizeof(ours));
+        inet_ntop(AF_INET, ip, libc, sizeof(libc));
+        ASSUME_ITS_TRUE(strcmp(ours, libc) == 0);
+    }
+#endif
+}
+
+FOSSIL_TEST(c_inet_test_mac_parse_and_format) {
+    uint8_t mac[6];
+    ASSUME_ITS_TRUE(fossil_net_inet_mac_parse("aa:BB:0c:d:EE:ff", mac) == 0);
+    ASSUME_ITS_TRUE(mac[0] == 0xaa && mac[2] == 0x0c && mac[3] == 0x0d && mac[5] == 0xff);
+
+    char buf[FOSSIL_NET_INET_MAC_STRLEN];
+    ASSUME_ITS_TRUE(fossil_net_inet_mac_format(mac, buf, sizeof(buf)) == 17);
+    ASSUME_ITS_TRUE(strcmp(buf, "AA:BB:0C:0D:EE:FF") == 0);
+
+    ASSUME_ITS_TRUE(fossil_net_inet_mac_parse("00-11-22-33-44-55", mac) == 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_mac_parse("00:11:22:33:44", mac) != 0);
+    ASSUME_ITS_TRUE(fossil_net_inet_mac_parse("000:11:22:33:44:55", mac) != 0);
+
+    fossil_net_mac_t m;
+    ASSUME_ITS_TRUE(fossil_net_socket_mac_parse(&m, "de:ad:be:ef:00:01") == 0);
+    ASSUME_ITS_TRUE(strcmp(m.string, "DE:AD:BE:EF:00:01") == 0);
+}
+
+FOSSIL_TEST(c_inet_test_endpoint_roundtrip) {
+    fossil_net_endpoint_t ep;
+    char buf[FOSSIL_NET_INET_ENDPOINT_STRLEN];
+
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&ep, "10.1.2.3", 8080) == 0);
+    ASSUME_ITS_TRUE(ep.family == FOSSIL_NET_SOCKET_FAMILY_IPV4);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_format(&ep, buf, sizeof(buf)) > 0);
+    ASSUME_ITS_TRUE(strcmp(buf, "10.1.2.3:8080") == 0);
+
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&ep, "::1", 0) == 0);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_format(&ep, buf, sizeof(buf)) > 0);
+    ASSUME_ITS_TRUE(strcmp(buf, "[::1]:0") == 0);
+
+    fossil_net_address_t addr;
+    ASSUME_ITS_TRUE(fossil_net_endpoint_to_address(&ep, &addr) == 0);
+    ASSUME_ITS_TRUE(strcmp(addr.ip, "::1") == 0 && strcmp(addr.family, "ipv6") == 0);
+
+    fossil_net_endpoint_t back;
+    ASSUME_ITS_TRUE(fossil_net_endpoint_from_address(&back, &addr) == 0);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_equal(&ep, &back));
+}
+
+FOSSIL_TEST(c_inet_test_accept_endpoint_loopback) {
+    fossil_net_socket_t server, client, accepted;
+    fossil_net_endpoint_t ep, peer, local;
+    int rc = fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(rc == 0);
+
+    rc = fossil_net_socket_create(&server, "tcp", "ipv4");
+    ASSUME_ITS_TRUE(rc == 0);
+    rc = fossil_net_socket_bind_endpoint(&server, &ep);
+    ASSUME_ITS_TRUE(rc == 0);
+    rc = fossil_net_socket_listen(&server, 1);
+    ASSUME_ITS_TRUE(rc == 0);
+    rc = fossil_net_socket_get_local_endpoint(&server, &ep);
+    ASSUME_ITS_TRUE(rc == 0 && ep.port != 0);
+
+    rc = fossil_net_socket_create(&client, "tcp", "ipv4");
+    ASSUME_ITS_TRUE(rc == 0);
+    rc = fossil_net_socket_connect_endpoint(&client, &ep);
+    ASSUME_ITS_TRUE(rc == 0);
+
+    rc = fossil_net_socket_accept_endpoint(&server, &accepted, &peer);
+    ASSUME_ITS_TRUE(rc == 0);
+    rc = fossil_net_socket_get_local_endpoint(&client, &local);
+    ASSUME_ITS_TRUE(rc == 0);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_equal(&peer, &local));
+
+    fossil_net_socket_close(&accepted);
+    fossil_net_socket_close(&client);
+    fossil_net_socket_close(&server);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_inet_tests) {
+    FOSSIL_ADD_TEST(c_inet_fixture, c_inet_test_ipv4_parse_and_format);
+    FOSSIL_ADD_TEST(c_inet_fixture, c_inet_test_ipv6_parse_and_format);
+    FOSSIL_ADD_TEST(c_inet_fixture, c_inet_test_matches_libc);
+    FOSSIL_ADD_TEST(c_inet_fixture, c_inet_test_mac_parse_and_format);
+    FOSSIL_ADD_TEST(c_inet_fixture, c_inet_test_endpoint_roundtrip);
+    FOSSIL_ADD_TEST(c_inet_fixture, c_inet_test_accept_endpoint_loopback);
+
+    FOSSIL_ADD_SUITE(c_inet_fixture);
+} // end of tests
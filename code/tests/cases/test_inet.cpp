@@ -0,0 +1,85 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_inet_fixture);
+
+FOSSIL_SETUP(cpp_inet_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_inet_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_inet_test_format_helpers) {
+    using fossil::net::Inet;
+
+    uint8_t v4[4];
+    ASSUME_ITS_TRUE(Inet::ipv4_parse("127.0.0.1", v4) == 0);
+    ASSUME_ITS_TRUE(Inet::ipv4_format(v4) == "127.0.0.1");
+
+    uint8_t v6[16];
+    ASSUME_ITS_TRUE(Inet::ipv6_parse("fe80:0:0:0:0:0:0:1", v6) == 0);
+    ASSUME_ITS_TRUE(Inet::ipv6_format(v6) == "fe80::1");
+
+    uint8_t mac[6];
+    ASSUME_ITS_TRUE(Inet::mac_parse("01:23:45:67:89:ab", mac) == 0);
+    ASSUME_ITS_TRUE(Inet::mac_format(mac) == "01:23:45:67:89:AB");
+}
+
+FOSSIL_TEST(cpp_inet_test_endpoint_format) {
+    using fossil::net::Inet;
+
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_endpoint_parse(&ep, "2001:db8::1", 443) == 0);
+    ASSUME_ITS_TRUE(Inet::endpoint_format(ep) == "[2001:db8::1]:443");
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_inet_tests) {
+    FOSSIL_ADD_TEST(cpp_inet_fixture, cpp_inet_test_format_helpers);
+    FOSSIL_ADD_TEST(cpp_inet_fixture, cpp_inet_test_endpoint_format);
+
+    FOSSIL_ADD_SUITE(cpp_inet_fixture);
+} // end of tests
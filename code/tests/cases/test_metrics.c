@@ -0,0 +1,312 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_metrics_fixture);
+
+FOSSIL_SETUP(c_metrics_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_metrics_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+typedef struct c_metrics_work {
+    fossil_net_metric_t *counter;
+    fossil_net_metric_t *histogram;
+} c_metrics_work_t;
+
+static void c_metrics_record(void *arg) {
+    c_metrics_work_t *w = (c_metrics_work_t *)arg;
+    for (uint64_t i = 1; i <= 5000; i++) {
+        fossil_net_metric_add(w->counter, 2);
+        fossil_net_metric_observe(w->histogram, i * 1000);
+    }
+}
+
+static void c_metrics_collect(fossil_net_metrics_sink_t *sink, void *arg) {
+    fossil_net_metrics_emit(sink, FOSSIL_NET_METRIC_GAUGE, "app_queue_depth", "Jobs waiting.", NULL, *(double *)arg);
+    fossil_net_metrics_emit(sink, FOSSIL_NET_METRIC_COUNTER, "app_runs_total", "Runs.", "kind=\"x\"", 1);
+}
+
+static void c_metrics_echo(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    (void)user;
+    fossil_net_slice_t word;
+    fossil_net_http_param(ex, "word", &word);
+    fossil_net_http_respond(ex, 200, "text/plain", word.ptr, word.len);
+}
+
+/* Send one request with Connection: close and read the whole response. */
+static uint32_t c_metrics_get(fossil_net_server_t *server, const char *path, char *out, uint32_t size) {
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    char raw[256];
+    uint32_t sent = 0, total = 0, got = 0;
+    if (fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) != 0 ||
+        fossil_net_socket_create(&c, "tcp", "ipv4") != 0)
+        return 0;
+    if (fossil_net_socket_connect_endpoint(&c, &ep) != 0) {
+        fossil_net_socket_close(&c);
+        return 0;
+    }
+    snprintf(raw, sizeof(raw), "GET %s HTTP/1.1\r\nHost: t\r\nConnection: close\r\n\r\n", path);
+    fossil_net_socket_send(&c, raw, (uint32_t)strlen(raw), &sent);
+    while (total < size - 1 && fossil_net_socket_receive(&c, out + total, size - 1 - total, &got) == 0 && got > 0)
+        total += got;
+    out[total] = '\0';
+    fossil_net_socket_close(&c);
+    return total;
+}
+
+static int c_metrics_count(const char *s, const char *needle) {
+    int n = 0;
+    for (const char *p = strstr(s, needle); p; p = strstr(p + 1, needle))
+        n++;
+    return n;
+}
+
+FOSSIL_TEST(c_metrics_test_register) {
+    fossil_net_metrics_t *m = fossil_net_metrics_create(NULL);
+    ASSUME_ITS_TRUE(m != NULL);
+    fossil_net_metric_t *c = fossil_net_metrics_counter(m, "app_jobs_total", "Jobs run.", "queue=\"io\"");
+    ASSUME_ITS_TRUE(c != NULL);
+    ASSUME_ITS_TRUE(fossil_net_metrics_counter(m, "app_jobs_total", NULL, "queue=\"io\"") == c);
+    ASSUME_ITS_TRUE(fossil_net_metrics_counter(m, "app_jobs_total", NULL, "queue=\"cpu\"") != c);
+    ASSUME_ITS_TRUE(fossil_net_metrics_gauge(m, "app_jobs_total", NULL, NULL) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_metrics_counter(m, "9bad", NULL, NULL) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_metrics_counter(m, "bad-name", NULL, NULL) == NULL);
+
+    fossil_net_metric_add(c, 3);
+    fossil_net_metric_add(c, 4);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(c) == 7);
+
+    fossil_net_metric_t *g = fossil_net_metrics_gauge(m, "app_inflight", "In flight.", NULL);
+    ASSUME_ITS_TRUE(g != NULL);
+    fossil_net_metric_set(g, 10);
+    fossil_net_metric_gauge_add(g, -12);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(g) == -2);
+    /* Updates of the wrong kind are ignored. */
+    fossil_net_metric_add(g, 5);
+    fossil_net_metric_set(c, 100);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(g) == -2);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(c) == 7);
+
+    char labels[32] = "";
+    ASSUME_ITS_TRUE(fossil_net_metrics_label(labels, sizeof(labels), "path", "/a\"b\\") == 0);
+    ASSUME_ITS_TRUE(strcmp(labels, "path=\"/a\\\"b\\\\\"") == 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_label(labels, sizeof(labels), "m", "GET") == 0);
+    ASSUME_ITS_TRUE(strcmp(labels, "path=\"/a\\\"b\\\\\",m=\"GET\"") == 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_label(labels, sizeof(labels), "long", "0123456789") != 0);
+    ASSUME_ITS_TRUE(strcmp(labels, "path=\"/a\\\"b\\\\\",m=\"GET\"") == 0);
+    fossil_net_metrics_destroy(m);
+}
+
+FOSSIL_TEST(c_metrics_test_histogram_quantiles) {
+    fossil_net_metrics_t *m = fossil_net_metrics_create(NULL);
+    ASSUME_ITS_TRUE(m != NULL);
+    fossil_net_metric_t *h = fossil_net_metrics_histogram(m, "app_latency_seconds", "Latency.", NULL);
+    ASSUME_ITS_TRUE(h != NULL);
+    ASSUME_ITS_TRUE(fossil_net_metric_quantile(h, 0.5) == 0);
+    for (uint64_t us = 1; us <= 1000; us++)
+        fossil_net_metric_observe(h, us * 1000);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(h) == 1000);
+
+    /* Log-linear buckets keep every estimate within 1/16 of the true value. */
+    uint64_t p50 = fossil_net_metric_quantile(h, 0.5);
+    uint64_t p99 = fossil_net_metric_quantile(h, 0.99);
+    ASSUME_ITS_TRUE(p50 >= 500000 - 500000 / 16 && p50 <= 500000 + 500000 / 16);
+    ASSUME_ITS_TRUE(p99 >= 990000 - 990000 / 16 && p99 <= 990000 + 990000 / 16);
+    ASSUME_ITS_TRUE(fossil_net_metric_quantile(h, 0.0) <= 1100);
+    ASSUME_ITS_TRUE(fossil_net_metric_quantile(h, 1.0) >= 1000000 - 1000000 / 16);
+
+    /* Small values are exact, huge ones land in the last bucket. */
+    fossil_net_metric_t *e = fossil_net_metrics_histogram(m, "app_tiny_seconds", "Tiny.", NULL);
+    fossil_net_metric_observe(e, 5);
+    ASSUME_ITS_TRUE(fossil_net_metric_quantile(e, 0.5) == 5);
+    fossil_net_metric_observe(e, UINT64_MAX);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(e) == 2);
+    ASSUME_ITS_TRUE(fossil_net_metric_quantile(e, 1.0) > (1ull << 40));
+    fossil_net_metrics_destroy(m);
+}
+
+FOSSIL_TEST(c_metrics_test_threads) {
+    fossil_net_metrics_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.shards = 3;
+    fossil_net_metrics_t *m = fossil_net_metrics_create(&cfg);
+    ASSUME_ITS_TRUE(m != NULL);
+    c_metrics_work_t w;
+    w.counter = fossil_net_metrics_counter(m, "app_ops_total", "Ops.", NULL);
+    w.histogram = fossil_net_metrics_histogram(m, "app_op_seconds", "Op latency.", NULL);
+    ASSUME_ITS_TRUE(w.counter != NULL && w.histogram != NULL);
+
+    fossil_net_pool_config_t pc;
+    memset(&pc, 0, sizeof(pc));
+    pc.threads = 4;
+    fossil_net_pool_t *pool = fossil_net_pool_create(&pc);
+    ASSUME_ITS_TRUE(pool != NULL);
+    for (int i = 0; i < 16; i++)
+        ASSUME_ITS_TRUE(fossil_net_pool_submit(pool, c_metrics_record, &w) == 0);
+    fossil_net_pool_destroy(pool);
+
+    ASSUME_ITS_TRUE(fossil_net_metric_value(w.counter) == 16 * 5000 * 2);
+    ASSUME_ITS_TRUE(fossil_net_metric_value(w.histogram) == 16 * 5000);
+    uint64_t p50 = fossil_net_metric_quantile(w.histogram, 0.5);
+    ASSUME_ITS_TRUE(p50 >= 2500000 - 2500000 / 16 && p50 <= 2500000 + 2500000 / 16);
+    fossil_net_metrics_destroy(m);
+}
+
+FOSSIL_TEST(c_metrics_test_render) {
+    fossil_net_metrics_t *m = fossil_net_metrics_create(NULL);
+    ASSUME_ITS_TRUE(m != NULL);
+    char *text = NULL;
+    uint32_t len = 1;
+    ASSUME_ITS_TRUE(fossil_net_metrics_render(m, &text, &len) == 0);
+    ASSUME_ITS_TRUE(text != NULL && len == 0 && text[0] == '\0');
+    free(text);
+
+    fossil_net_metric_add(fossil_net_metrics_counter(m, "app_jobs_total", "Jobs\nrun.", "queue=\"io\""), 3);
+    fossil_net_metric_set(fossil_net_metrics_gauge(m, "app_inflight", "In flight.", NULL), -4);
+    fossil_net_metric_t *h = fossil_net_metrics_histogram(m, "app_latency_seconds", "Latency.", "op=\"read\"");
+    fossil_net_metric_observe(h, 1500);         /* 1.5 us */
+    fossil_net_metric_observe(h, 2000000000);   /* 2 s */
+    double depth = 12, other = 5;
+    ASSUME_ITS_TRUE(fossil_net_metrics_add_collector(m, "shard=\"a\"", c_metrics_collect, &depth) == 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_add_collector(m, NULL, c_metrics_collect, &other) == 0);
+
+    ASSUME_ITS_TRUE(fossil_net_metrics_render(m, &text, &len) == 0);
+    ASSUME_ITS_TRUE(strlen(text) == len);
+    ASSUME_ITS_TRUE(strstr(text, "# HELP app_jobs_total Jobs\\nrun.\n# TYPE app_jobs_total counter\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_jobs_total{queue=\"io\"} 3\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "# TYPE app_inflight gauge\napp_inflight -4\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "# TYPE app_latency_seconds histogram\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_latency_seconds_bucket{op=\"read\",le=\"1.024e-06\"} 0\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_latency_seconds_bucket{op=\"read\",le=\"2.048e-06\"} 1\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_latency_seconds_bucket{op=\"read\",le=\"2.147483648\"} 2\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_latency_seconds_bucket{op=\"read\",le=\"+Inf\"} 2\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_latency_seconds_sum{op=\"read\"} 2.000001500\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_latency_seconds_count{op=\"read\"} 2\n") != NULL);
+    /* Collector samples are grouped by name under one header. */
+    ASSUME_ITS_TRUE(c_metrics_count(text, "# TYPE app_queue_depth gauge\n") == 1);
+    ASSUME_ITS_TRUE(strstr(text, "app_queue_depth{shard=\"a\"} 12\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(text, "app_runs_total{shard=\"a\",kind=\"x\"} 1\napp_runs_total{kind=\"x\"} 1\n") != NULL);
+    free(text);
+
+    ASSUME_ITS_TRUE(fossil_net_metrics_remove_collector(m, c_metrics_collect, &depth) == 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_remove_collector(m, c_metrics_collect, &depth) != 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_render(m, &text, &len) == 0);
+    ASSUME_ITS_TRUE(strstr(text, "shard=\"a\"") == NULL);
+    ASSUME_ITS_TRUE(strstr(text, "\napp_queue_depth 5\n") != NULL);
+    free(text);
+    fossil_net_metrics_destroy(m);
+}
+
+FOSSIL_TEST(c_metrics_test_httpd_serve) {
+    fossil_net_server_t *app = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_server_t *admin = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(app != NULL && admin != NULL);
+    fossil_net_metrics_t *m = fossil_net_metrics_create(NULL);
+    ASSUME_ITS_TRUE(m != NULL);
+    fossil_net_httpd_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.reactor.threads = 2;
+    fossil_net_httpd_t *h = fossil_net_httpd_create(app, &cfg);
+    ASSUME_ITS_TRUE(h != NULL);
+    ASSUME_ITS_TRUE(fossil_net_httpd_route(h, FOSSIL_NET_HTTP_GET, "/echo/:word", c_metrics_echo, NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_set_metrics(h, m, "app=\"demo\"") == 0);
+    /* Routes added later get their histogram too. */
+    ASSUME_ITS_TRUE(fossil_net_httpd_route(h, FOSSIL_NET_HTTP_POST, "/echo/:word", c_metrics_echo, NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_httpd_start(h) == 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_serve(m, admin) == 0);
+    ASSUME_ITS_TRUE(fossil_net_metrics_serve(m, admin) != 0);
+
+    char out[32768];
+    for (int i = 0; i < 3; i++) {
+        ASSUME_ITS_TRUE(c_metrics_get(app, "/echo/hi", out, sizeof(out)) > 0);
+        ASSUME_ITS_TRUE(strstr(out, "\r\n\r\nhi") != NULL);
+    }
+    ASSUME_ITS_TRUE(c_metrics_get(app, "/nowhere", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, " 404 ") != NULL);
+
+    ASSUME_ITS_TRUE(c_metrics_get(admin, "/metrics", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "HTTP/1.1 200 ") == out);
+    ASSUME_ITS_TRUE(strstr(out, "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_http_request_duration_seconds_count{app=\"demo\",method=\"GET\",route=\"/echo/:word\"} 3\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_http_request_duration_seconds_count{app=\"demo\",method=\"POST\",route=\"/echo/:word\"} 0\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_http_request_duration_seconds_count{app=\"demo\",method=\"\",route=\"\"} 1\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_http_requests_total{app=\"demo\"} 4\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_accepted_total{app=\"demo\"} 4\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "# TYPE fossil_net_connections_active gauge\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_shed_total{app=\"demo\"} 0\n") != NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_received_bytes_total{app=\"demo\"} 0\n") == NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_sent_bytes_total{app=\"demo\"} 0\n") == NULL);
+
+    fossil_net_reactor_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_reactor_get_stats(fossil_net_httpd_reactor(h), &st) == 0);
+    ASSUME_ITS_TRUE(st.bytes_in > 4 * 40 && st.bytes_out > 4 * 40);
+
+    /* Destroying the server takes its series out of the registry's output. */
+    fossil_net_httpd_destroy(h);
+    ASSUME_ITS_TRUE(c_metrics_get(admin, "/metrics", out, sizeof(out)) > 0);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_accepted_total") == NULL);
+    ASSUME_ITS_TRUE(strstr(out, "fossil_net_http_request_duration_seconds_count{app=\"demo\",method=\"GET\",route=\"/echo/:word\"} 3\n") != NULL);
+    fossil_net_metrics_destroy(m);
+    fossil_net_server_destroy(app);
+    fossil_net_server_destroy(admin);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_metrics_tests) {
+    FOSSIL_ADD_TEST(c_metrics_fixture, c_metrics_test_register);
+    FOSSIL_ADD_TEST(c_metrics_fixture, c_metrics_test_histogram_quantiles);
+    FOSSIL_ADD_TEST(c_metrics_fixture, c_metrics_test_threads);
+    FOSSIL_ADD_TEST(c_metrics_fixture, c_metrics_test_render);
+    FOSSIL_ADD_TEST(c_metrics_fixture, c_metrics_test_httpd_serve);
+
+    FOSSIL_ADD_SUITE(c_metrics_fixture);
+} // end of tests
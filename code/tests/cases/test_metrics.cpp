@@ -0,0 +1,138 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string>
+#include <utility>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_metrics_fixture);
+
+FOSSIL_SETUP(cpp_metrics_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_metrics_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::net::Metrics;
+
+static void cpp_metrics_hello(fossil_net_http_exchange_t *ex, const fossil_net_http_request_t *req, void *user) {
+    (void)req;
+    (void)user;
+    fossil_net_http_respond(ex, 200, "text/plain", "hello", 5);
+}
+
+static std::string cpp_metrics_get(fossil_net_server_t *server, const std::string &path) {
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    std::string body;
+    if (fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) != 0 ||
+        fossil_net_socket_create(&c, "tcp", "ipv4") != 0)
+        return body;
+    if (fossil_net_socket_connect_endpoint(&c, &ep) == 0) {
+        fossil::net::Request req = fossil::net::Request::get(path);
+        fossil_net_response_t res{};
+        if (fossil_net_request_send(&c, req.native_handle(), &res) == 0 && res.status == 200)
+            body.assign(static_cast<char *>(res.body), res.body_size);
+        fossil_net_response_free(&res);
+    }
+    fossil_net_socket_close(&c);
+    return body;
+}
+
+FOSSIL_TEST(cpp_metrics_test_class_render) {
+    Metrics m;
+    ASSUME_ITS_TRUE(m.native_handle() != nullptr);
+    fossil_net_metric_t *c = m.counter("app_jobs_total", "Jobs run.", "queue=\"io\"");
+    fossil_net_metric_t *h = m.histogram("app_latency_seconds", "Latency.");
+    ASSUME_ITS_TRUE(c != nullptr && h != nullptr);
+    ASSUME_ITS_TRUE(m.counter("app_jobs_total", "", "queue=\"io\"") == c);
+    ASSUME_ITS_TRUE(m.gauge("app_latency_seconds", "") == nullptr);
+    fossil_net_metric_add(c, 5);
+    for (uint64_t i = 0; i < 100; i++)
+        fossil_net_metric_observe(h, 1000000);
+
+    std::string text = m.render();
+    ASSUME_ITS_TRUE(text.find("app_jobs_total{queue=\"io\"} 5\n") != std::string::npos);
+    ASSUME_ITS_TRUE(text.find("app_latency_seconds_bucket{le=\"0.001048576\"} 100\n") != std::string::npos);
+    ASSUME_ITS_TRUE(text.find("app_latency_seconds_count 100\n") != std::string::npos);
+    ASSUME_ITS_TRUE(fossil_net_metric_quantile(h, 0.9) >= 1000000 - 1000000 / 16);
+
+    Metrics moved(std::move(m));
+    ASSUME_ITS_TRUE(m.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.render() == text);
+}
+
+FOSSIL_TEST(cpp_metrics_test_class_serve) {
+    fossil_net_server_t *app = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_server_t *admin = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(app != nullptr && admin != nullptr);
+    {
+        Metrics m;
+        fossil_net_httpd_config_t cfg{};
+        cfg.reactor.threads = 1;
+        fossil::net::Httpd httpd(app, &cfg);
+        ASSUME_ITS_TRUE(httpd.route(FOSSIL_NET_HTTP_GET, "/hello", cpp_metrics_hello));
+        ASSUME_ITS_TRUE(httpd.set_metrics(m.native_handle()) == 0);
+        ASSUME_ITS_TRUE(httpd.start() == 0);
+        ASSUME_ITS_TRUE(m.serve(admin) == 0);
+
+        ASSUME_ITS_TRUE(cpp_metrics_get(app, "/hello") == "hello");
+        ASSUME_ITS_TRUE(cpp_metrics_get(app, "/hello") == "hello");
+        std::string text = cpp_metrics_get(admin, "/metrics");
+        ASSUME_ITS_TRUE(text.find("fossil_net_http_request_duration_seconds_count{method=\"GET\",route=\"/hello\"} 2\n") != std::string::npos);
+        ASSUME_ITS_TRUE(text.find("fossil_net_http_requests_total 2\n") != std::string::npos);
+        ASSUME_ITS_TRUE(text.find("fossil_net_accepted_total 2\n") != std::string::npos);
+        ASSUME_ITS_TRUE(httpd.stop() == 0);
+    }
+    fossil_net_server_destroy(app);
+    fossil_net_server_destroy(admin);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_metrics_tests) {
+    FOSSIL_ADD_TEST(cpp_metrics_fixture, cpp_metrics_test_class_render);
+    FOSSIL_ADD_TEST(cpp_metrics_fixture, cpp_metrics_test_class_serve);
+
+    FOSSIL_ADD_SUITE(cpp_metrics_fixture);
+} // end of tests
@@ -0,0 +1,179 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_multicast_fixture);
+
+FOSSIL_SETUP(c_multicast_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_multicast_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static int c_multicast_bound_udp(fossil_net_socket_t *sock, fossil_net_endpoint_t *local) {
+    if (fossil_net_socket_create(sock, "udp", "ipv4") != 0) return -1;
+    fossil_net_endpoint_parse(local, "127.0.0.1", 0);
+    if (fossil_net_socket_bind_endpoint(sock, local) != 0) return -1;
+    return fossil_net_socket_get_local_endpoint(sock, local);
+}
+
+FOSSIL_TEST(c_multicast_test_send_to_receive_from) {
+    fossil_net_socket_t rx, tx;
+    fossil_net_endpoint_t rx_ep, tx_ep, from;
+    ASSUME_ITS_TRUE(c_multicast_bound_udp(&rx, &rx_ep) == 0);
+    ASSUME_ITS_TRUE(c_multicast_bound_udp(&tx, &tx_ep) == 0);
+
+    uint32_t sent = 0, got = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_send_to(&tx, "ping", 4, &rx_ep, &sent) == 0);
+    ASSUME_ITS_TRUE(sent == 4);
+
+    char buf[16];
+    ASSUME_ITS_TRUE(fossil_net_socket_receive_from(&rx, buf, sizeof(buf), &got, &from) == 0);
+    ASSUME_ITS_TRUE(got == 4 && memcmp(buf, "ping", 4) == 0);
+    ASSUME_ITS_TRUE(fossil_net_endpoint_equal(&from, &tx_ep));
+
+    fossil_net_socket_close(&tx);
+    fossil_net_socket_close(&rx);
+}
+
+FOSSIL_TEST(c_multicast_test_batch_receive_with_pktinfo) {
+    fossil_net_socket_t rx, tx;
+    fossil_net_endpoint_t rx_ep, tx_ep;
+    ASSUME_ITS_TRUE(c_multicast_bound_udp(&rx, &rx_ep) == 0);
+    ASSUME_ITS_TRUE(c_multicast_bound_udp(&tx, &tx_ep) == 0);
+#if !defined(_WIN32)
+    ASSUME_ITS_TRUE(fossil_net_multicast_enable_pktinfo(&rx, true) == 0);
+#endif
+
+    for (int i = 0; i < 3; ++i) {
+        char c = (char)('a' + i);
+        ASSUME_ITS_TRUE(fossil_net_socket_send_to(&tx, &c, 1, &rx_ep, NULL) == 0);
+    }
+
+    char bufs[4][8];
+    fossil_net_multicast_msg_t msgs[4];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < 4; ++i) {
+        msgs[i].buffer = bufs[i];
+        msgs[i].size = sizeof(bufs[i]);
+    }
+    uint32_t total = 0;
+    while (total < 3) {
+        uint32_t n = 0;
+        ASSUME_ITS_TRUE(fossil_net_multicast_receive(&rx, msgs + total, 4 - total, &n) == 0);
+        ASSUME_ITS_TRUE(n > 0);
+        total += n;
+    }
+    ASSUME_ITS_TRUE(msgs[0].length == 1 && bufs[0][0] == 'a');
+    ASSUME_ITS_TRUE(msgs[2].length == 1 && bufs[2][0] == 'c');
+    ASSUME_ITS_TRUE(fossil_net_endpoint_equal(&msgs[1].source, &tx_ep));
+#if !defined(_WIN32)
+    // Destination address metadata is what separates groups on a shared socket
+    ASSUME_ITS_TRUE(msgs[0].group.family == FOSSIL_NET_SOCKET_FAMILY_IPV4);
+    ASSUME_ITS_TRUE(memcmp(msgs[0].group.ip, rx_ep.ip, 4) == 0);
+    ASSUME_ITS_TRUE(msgs[0].ifindex != 0);
+#endif
+
+    fossil_net_socket_close(&tx);
+    fossil_net_socket_close(&rx);
+}
+
+FOSSIL_TEST(c_multicast_test_join_leave_and_options) {
+    fossil_net_socket_t sock;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&sock, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_multicast_set_ttl(&sock, 1) == 0);
+    ASSUME_ITS_TRUE(fossil_net_multicast_set_loopback(&sock, true) == 0);
+
+    // Bad input is rejected before reaching the kernel
+    ASSUME_ITS_TRUE(fossil_net_multicast_join(&sock, "not-an-ip", NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_multicast_join(&sock, "239.1.2.3", "no-such-iface0") != 0);
+    ASSUME_ITS_TRUE(fossil_net_multicast_join_source(&sock, "232.1.2.3", "::1", NULL) != 0);
+
+    // Hosts without a multicast route may refuse the join; only check pairing
+    if (fossil_net_multicast_join(&sock, "239.1.2.3", "127.0.0.1") == 0) {
+        ASSUME_ITS_TRUE(fossil_net_multicast_leave(&sock, "239.1.2.3", "127.0.0.1") == 0);
+    }
+    if (fossil_net_multicast_join_source(&sock, "232.1.2.3", "127.0.0.1", "127.0.0.1") == 0) {
+        ASSUME_ITS_TRUE(fossil_net_multicast_leave_source(&sock, "232.1.2.3", "127.0.0.1", "127.0.0.1") == 0);
+    }
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(c_multicast_test_loopback_group_delivery) {
+    fossil_net_socket_t rx, tx;
+    fossil_net_endpoint_t any, group;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&rx, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&tx, "udp", "ipv4") == 0);
+    fossil_net_socket_set_reuseaddr(&rx, true);
+    fossil_net_endpoint_parse(&any, "0.0.0.0", 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_bind_endpoint(&rx, &any) == 0);
+    fossil_net_socket_get_local_endpoint(&rx, &any);
+    fossil_net_endpoint_parse(&group, "239.255.42.1", any.port);
+
+    if (fossil_net_multicast_join(&rx, "239.255.42.1", "127.0.0.1") == 0 &&
+        fossil_net_multicast_set_interface(&tx, "127.0.0.1") == 0 &&
+        fossil_net_multicast_set_loopback(&tx, true) == 0 &&
+        fossil_net_socket_send_to(&tx, "md", 2, &group, NULL) == 0) {
+        char buf[8];
+        uint32_t got = 0;
+        fossil_net_socket_set_blocking(&rx, false);
+        for (int i = 0; i < 50 && fossil_net_socket_receive(&rx, buf, sizeof(buf), &got) != 0; ++i)
+            fossil_net_socket_sleep(10);
+        ASSUME_ITS_TRUE(got == 2);
+    }
+    fossil_net_socket_close(&tx);
+    fossil_net_socket_close(&rx);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_multicast_tests) {
+    FOSSIL_ADD_TEST(c_multicast_fixture, c_multicast_test_send_to_receive_from);
+    FOSSIL_ADD_TEST(c_multicast_fixture, c_multicast_test_batch_receive_with_pktinfo);
+    FOSSIL_ADD_TEST(c_multicast_fixture, c_multicast_test_join_leave_and_options);
+    FOSSIL_ADD_TEST(c_multicast_fixture, c_multicast_test_loopback_group_delivery);
+
+    FOSSIL_ADD_SUITE(c_multicast_fixture);
+} // end of tests
@@ -0,0 +1,89 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_multicast_fixture);
+
+FOSSIL_SETUP(cpp_multicast_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_multicast_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_multicast_test_class_options) {
+    fossil::net::Socket sock;
+    ASSUME_ITS_TRUE(sock.socket_create("udp", "ipv6") == 0);
+    ASSUME_ITS_TRUE(fossil::net::Multicast::set_ttl(sock.native_handle(), 4) == 0);
+    ASSUME_ITS_TRUE(fossil::net::Multicast::set_loopback(sock.native_handle(), false) == 0);
+    ASSUME_ITS_TRUE(fossil::net::Multicast::enable_pktinfo(sock.native_handle()) == 0);
+
+    // IPv4 interface addresses cannot select an IPv6 interface
+    ASSUME_ITS_TRUE(fossil::net::Multicast::set_interface(sock.native_handle(), "127.0.0.1") != 0);
+    ASSUME_ITS_TRUE(fossil::net::Multicast::join(sock.native_handle(), "ff15::1", "127.0.0.1") != 0);
+}
+
+FOSSIL_TEST(cpp_multicast_test_class_send_to) {
+    fossil::net::Socket rx, tx;
+    fossil_net_endpoint_t ep, from;
+    ASSUME_ITS_TRUE(rx.socket_create("udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(tx.socket_create("udp", "ipv4") == 0);
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_bind_endpoint(rx.native_handle(), &ep) == 0);
+    fossil_net_socket_get_local_endpoint(rx.native_handle(), &ep);
+
+    uint32_t sent = 0, got = 0;
+    ASSUME_ITS_TRUE(tx.socket_send_to("hey", 3, &ep, &sent) == 0 && sent == 3);
+    char buf[8];
+    ASSUME_ITS_TRUE(rx.socket_receive_from(buf, sizeof(buf), &got, &from) == 0);
+    ASSUME_ITS_TRUE(got == 3 && from.family == FOSSIL_NET_SOCKET_FAMILY_IPV4);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_multicast_tests) {
+    FOSSIL_ADD_TEST(cpp_multicast_fixture, cpp_multicast_test_class_options);
+    FOSSIL_ADD_TEST(cpp_multicast_fixture, cpp_multicast_test_class_send_to);
+
+    FOSSIL_ADD_SUITE(cpp_multicast_fixture);
+} // end of tests
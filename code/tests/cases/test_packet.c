@@ -0,0 +1,221 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_packet_fixture);
+
+FOSSIL_SETUP(c_packet_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_packet_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static uint32_t c_packet_eth(uint8_t *f, uint16_t ethertype, bool vlan) {
+    memset(f, 0, 256);
+    for (int i = 0; i < 6; ++i) { f[i] = (uint8_t)(0xa0 + i); f[6 + i] = (uint8_t)(0xb0 + i); }
+    uint32_t off = 12;
+    if (vlan) {
+        f[12] = 0x81; f[13] = 0x00; f[14] = 0x00; f[15] = 0x2a;
+        off = 16;
+    }
+    f[off] = (uint8_t)(ethertype >> 8);
+    f[off + 1] = (uint8_t)ethertype;
+    return off + 2;
+}
+
+static uint32_t c_packet_ipv4(uint8_t *ip, uint8_t proto, uint32_t opt, uint32_t l4len) {
+    uint32_t hlen = 20 + opt, total = hlen + l4len;
+    ip[0] = (uint8_t)(0x40 | (hlen / 4));
+    ip[2] = (uint8_t)(total >> 8); ip[3] = (uint8_t)total;
+    ip[8] = 64; ip[9] = proto;
+    ip[12] = 10; ip[15] = 1; ip[16] = 10; ip[19] = 2;
+    return hlen;
+}
+
+static void c_packet_ports(uint8_t *l4, uint16_t sp, uint16_t dp) {
+    l4[0] = (uint8_t)(sp >> 8); l4[1] = (uint8_t)sp;
+    l4[2] = (uint8_t)(dp >> 8); l4[3] = (uint8_t)dp;
+}
+
+FOSSIL_TEST(c_packet_test_ipv4_udp) {
+    uint8_t f[256];
+    uint32_t off = c_packet_eth(f, 0x0800, false);
+    uint32_t hlen = c_packet_ipv4(f + off, 17, 0, 8 + 5);
+    c_packet_ports(f + off + hlen, 1234, 53);
+    memcpy(f + off + hlen + 8, "hello", 5);
+    uint32_t len = off + hlen + 13 + 4; // trailing padding is ignored
+
+    fossil_net_packet_t p;
+    ASSUME_ITS_TRUE(fossil_net_packet_decode(f, len, FOSSIL_NET_PACKET_LINK_ETHERNET, &p) == 0);
+    ASSUME_ITS_TRUE(p.layers == (FOSSIL_NET_PACKET_HAS_ETH | FOSSIL_NET_PACKET_HAS_IPV4 | FOSSIL_NET_PACKET_HAS_UDP));
+    ASSUME_ITS_TRUE(p.src_port == 1234 && p.dst_port == 53 && p.ttl == 64);
+
+    uint32_t plen = 0;
+    const uint8_t *payload = fossil_net_packet_payload(&p, &plen);
+    ASSUME_ITS_TRUE(plen == 5 && memcmp(payload, "hello", 5) == 0);
+    ASSUME_ITS_TRUE(payload == f + off + hlen + 8); // a view, not a copy
+
+    fossil_net_mac_t src, dst;
+    ASSUME_ITS_TRUE(fossil_net_packet_eth_addrs(&p, &src, &dst) == 0);
+    ASSUME_ITS_TRUE(strcmp(src.string, "B0:B1:B2:B3:B4:B5") == 0 && dst.bytes[0] == 0xa0);
+
+    fossil_net_endpoint_t se, de;
+    ASSUME_ITS_TRUE(fossil_net_packet_endpoints(&p, &se, &de) == 0);
+    ASSUME_ITS_TRUE(se.ip[0] == 10 && se.ip[3] == 1 && de.ip[3] == 2 && de.port == 53);
+}
+
+FOSSIL_TEST(c_packet_test_vlan_tcp_and_ipv6) {
+    uint8_t f[256];
+    uint32_t off = c_packet_eth(f, 0x0800, true);
+    uint32_t hlen = c_packet_ipv4(f + off, 6, 8, 24);
+    c_packet_ports(f + off + hlen, 80, 40000);
+    f[off + hlen + 12] = 6 << 4; // 24-byte TCP header
+    f[off + hlen + 13] = 0x12;   // SYN|ACK
+    fossil_net_packet_t p;
+    fossil_net_packet_decode(f, off + hlen + 24, FOSSIL_NET_PACKET_LINK_ETHERNET, &p);
+    ASSUME_ITS_TRUE(p.layers & FOSSIL_NET_PACKET_HAS_VLAN);
+    ASSUME_ITS_TRUE(p.vlan_tci == 42);
+    ASSUME_ITS_TRUE((p.layers & FOSSIL_NET_PACKET_HAS_TCP) && p.tcp_flags == 0x12);
+    ASSUME_ITS_TRUE(p.l4_offset == off + 28 && p.payload_length == 0);
+
+    // IPv6 with a hop-by-hop header in front of UDP
+    off = c_packet_eth(f, 0x86dd, false);
+    uint8_t *ip = f + off;
+    ip[0] = 0x60; ip[5] = 8 + 8; ip[6] = 0; ip[7] = 3;
+    ip[40] = 17; ip[41] = 0;
+    c_packet_ports(ip + 48, 5353, 5353);
+    fossil_net_packet_decode(f, off + 56, FOSSIL_NET_PACKET_LINK_ETHERNET, &p);
+    ASSUME_ITS_TRUE((p.layers & FOSSIL_NET_PACKET_HAS_IPV6) && (p.layers & FOSSIL_NET_PACKET_HAS_UDP));
+    ASSUME_ITS_TRUE(p.l4_offset == off + 48 && p.dst_port == 5353 && p.ttl == 3);
+}
+
+FOSSIL_TEST(c_packet_test_bounds_and_fragments) {
+    uint8_t f[256];
+    uint32_t off = c_packet_eth(f, 0x0800, false);
+    uint32_t hlen = c_packet_ipv4(f + off, 6, 0, 20);
+    fossil_net_packet_t p;
+
+    // TCP header cut short by the capture
+    fossil_net_packet_decode(f, off + hlen + 10, FOSSIL_NET_PACKET_LINK_ETHERNET, &p);
+    ASSUME_ITS_TRUE(p.layers & FOSSIL_NET_PACKET_TRUNCATED);
+    ASSUME_ITS_TRUE(!(p.layers & FOSSIL_NET_PACKET_HAS_TCP));
+    ASSUME_ITS_TRUE(fossil_net_packet_l4(&p) == NULL);
+
+    // Later fragments carry no transport header
+    f[off + 6] = 0x00; f[off + 7] = 0x10;
+    fossil_net_packet_decode(f, off + hlen + 20, FOSSIL_NET_PACKET_LINK_ETHERNET, &p);
+    ASSUME_ITS_TRUE((p.layers & FOSSIL_NET_PACKET_FRAGMENT) && !(p.layers & FOSSIL_NET_PACKET_HAS_TCP));
+
+    // Runt frame and raw-IP link type
+    fossil_net_packet_decode(f, 10, FOSSIL_NET_PACKET_LINK_ETHERNET, &p);
+    ASSUME_ITS_TRUE(p.layers == FOSSIL_NET_PACKET_TRUNCATED);
+    f[off + 7] = 0;
+    f[off + 9] = 1;
+    fossil_net_packet_decode(f + off, hlen + 20, FOSSIL_NET_PACKET_LINK_IP, &p);
+    ASSUME_ITS_TRUE(p.layers == (FOSSIL_NET_PACKET_HAS_IPV4 | FOSSIL_NET_PACKET_HAS_ICMP));
+    ASSUME_ITS_TRUE(fossil_net_packet_decode(NULL, 4, FOSSIL_NET_PACKET_LINK_IP, &p) != 0);
+}
+
+FOSSIL_TEST(c_packet_test_batch_matches_scalar) {
+    static uint8_t frames[8][256];
+    uint32_t lens[8];
+    uint32_t off;
+    // 0: udp, 1: vlan tcp, 2: ipv6 tcp, 3: fragment, 4: truncated, 5: arp, 6: ipv6 ext, 7: icmp
+    off = c_packet_eth(frames[0], 0x0800, false);
+    lens[0] = off + c_packet_ipv4(frames[0] + off, 17, 0, 12) + 12;
+    c_packet_ports(frames[0] + off + 20, 1, 2);
+    off = c_packet_eth(frames[1], 0x0800, true);
+    lens[1] = off + c_packet_ipv4(frames[1] + off, 6, 4, 30) + 30;
+    frames[1][off + 24 + 12] = 5 << 4;
+    off = c_packet_eth(frames[2], 0x86dd, false);
+    frames[2][off] = 0x60; frames[2][off + 5] = 20; frames[2][off + 6] = 6;
+    frames[2][off + 40 + 12] = 5 << 4;
+    c_packet_ports(frames[2] + off + 40, 443, 50000);
+    lens[2] = off + 60;
+    off = c_packet_eth(frames[3], 0x0800, false);
+    lens[3] = off + c_packet_ipv4(frames[3] + off, 17, 0, 8) + 8;
+    frames[3][off + 6] = 0x20; // more fragments, offset 0
+    off = c_packet_eth(frames[4], 0x0800, false);
+    c_packet_ipv4(frames[4] + off, 6, 0, 20);
+    lens[4] = off + 25;
+    lens[5] = c_packet_eth(frames[5], 0x0806, false) + 28;
+    off = c_packet_eth(frames[6], 0x86dd, false);
+    frames[6][off] = 0x60; frames[6][off + 5] = 16; frames[6][off + 6] = 60; frames[6][off + 40] = 17;
+    lens[6] = off + 56;
+    off = c_packet_eth(frames[7], 0x0800, false);
+    lens[7] = off + c_packet_ipv4(frames[7] + off, 1, 0, 8) + 8;
+
+    fossil_net_packet_batch_t batch;
+    batch.count = 8;
+    for (int i = 0; i < 8; ++i) { batch.data[i] = frames[i]; batch.length[i] = lens[i]; }
+    ASSUME_ITS_TRUE(fossil_net_packet_decode_batch(&batch, FOSSIL_NET_PACKET_LINK_ETHERNET) == 0);
+
+    for (int i = 0; i < 8; ++i) {
+        fossil_net_packet_t p;
+        fossil_net_packet_decode(frames[i], lens[i], FOSSIL_NET_PACKET_LINK_ETHERNET, &p);
+        ASSUME_ITS_TRUE(batch.layers[i] == p.layers);
+        ASSUME_ITS_TRUE(batch.ethertype[i] == p.ethertype);
+        ASSUME_ITS_TRUE(batch.l3_offset[i] == p.l3_offset);
+        ASSUME_ITS_TRUE(batch.l4_offset[i] == p.l4_offset);
+        ASSUME_ITS_TRUE(batch.payload_offset[i] == p.payload_offset);
+        ASSUME_ITS_TRUE(batch.payload_length[i] == p.payload_length);
+        ASSUME_ITS_TRUE(batch.ip_proto[i] == p.ip_proto);
+        ASSUME_ITS_TRUE(batch.src_port[i] == p.src_port && batch.dst_port[i] == p.dst_port);
+    }
+    ASSUME_ITS_TRUE(batch.dst_port[2] == 50000);
+    ASSUME_ITS_TRUE(batch.layers[3] & FOSSIL_NET_PACKET_FRAGMENT);
+    ASSUME_ITS_TRUE(batch.layers[6] & FOSSIL_NET_PACKET_HAS_UDP);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_packet_tests) {
+    FOSSIL_ADD_TEST(c_packet_fixture, c_packet_test_ipv4_udp);
+    FOSSIL_ADD_TEST(c_packet_fixture, c_packet_test_vlan_tcp_and_ipv6);
+    FOSSIL_ADD_TEST(c_packet_fixture, c_packet_test_bounds_and_fragments);
+    FOSSIL_ADD_TEST(c_packet_fixture, c_packet_test_batch_matches_scalar);
+
+    FOSSIL_ADD_SUITE(c_packet_fixture);
+} // end of tests
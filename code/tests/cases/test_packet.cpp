@@ -0,0 +1,80 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_packet_fixture);
+
+FOSSIL_SETUP(cpp_packet_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_packet_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_packet_test_class_view) {
+    uint8_t ip[28] = {0};
+    ip[0] = 0x45; ip[3] = 28; ip[9] = 17;
+    ip[20] = 0x1f; ip[21] = 0x90; ip[22] = 0x00; ip[23] = 0x35;
+    fossil::net::Packet pkt(ip, sizeof(ip), FOSSIL_NET_PACKET_LINK_IP);
+    ASSUME_ITS_TRUE(pkt.has(FOSSIL_NET_PACKET_HAS_UDP));
+    ASSUME_ITS_TRUE(!pkt.has(FOSSIL_NET_PACKET_HAS_ETH));
+    ASSUME_ITS_TRUE(pkt.src_port() == 8080 && pkt.dst_port() == 53);
+    uint32_t len = 99;
+    ASSUME_ITS_TRUE(pkt.payload(&len) == ip + 28 && len == 0);
+}
+
+FOSSIL_TEST(cpp_packet_test_class_invalid) {
+    fossil::net::Packet pkt(nullptr, 16);
+    ASSUME_ITS_TRUE(pkt.native_handle()->layers == 0);
+    fossil_net_endpoint_t a, b;
+    ASSUME_ITS_TRUE(pkt.endpoints(&a, &b) != 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_packet_tests) {
+    FOSSIL_ADD_TEST(cpp_packet_fixture, cpp_packet_test_class_view);
+    FOSSIL_ADD_TEST(cpp_packet_fixture, cpp_packet_test_class_invalid);
+
+    FOSSIL_ADD_SUITE(cpp_packet_fixture);
+} // end of tests
@@ -0,0 +1,212 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_parser_fixture);
+
+FOSSIL_SETUP(c_parser_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_parser_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static int c_parser_feed(fossil_net_parser_t *p, const char *s, fossil_net_http_request_t *req) {
+    return fossil_net_parser_parse(p, s, (uint32_t)strlen(s), req);
+}
+
+FOSSIL_TEST(c_parser_test_request_line_and_headers) {
+    const char *raw = "\r\nGET /items/42?sort=asc HTTP/1.1\r\nHost: example.com\r\nX-Trace:  abc \r\n\r\nBODY";
+    fossil_net_parser_t p;
+    fossil_net_http_request_t req;
+    fossil_net_parser_init(&p, 0);
+    int n = c_parser_feed(&p, raw, &req);
+    ASSUME_ITS_TRUE(n == (int)(strlen(raw) - 4));
+    ASSUME_ITS_TRUE(req.method == FOSSIL_NET_HTTP_GET);
+    ASSUME_ITS_TRUE(fossil_net_slice_eq(req.path, "/items/42"));
+    ASSUME_ITS_TRUE(fossil_net_slice_eq(req.query, "sort=asc"));
+    ASSUME_ITS_TRUE(fossil_net_slice_eq(req.target, "/items/42?sort=asc"));
+    ASSUME_ITS_TRUE(req.version_minor == 1);
+    ASSUME_ITS_TRUE(req.keep_alive);
+    ASSUME_ITS_TRUE(req.header_count == 2);
+    fossil_net_slice_t v;
+    ASSUME_ITS_TRUE(fossil_net_http_request_header(&req, "x-trace", &v));
+    ASSUME_ITS_TRUE(fossil_net_slice_eq(v, "abc"));
+    ASSUME_ITS_TRUE(!fossil_net_http_request_header(&req, "missing", NULL));
+}
+
+FOSSIL_TEST(c_parser_test_incremental) {
+    const char *raw = "POST /upload HTTP/1.0\nContent-Length: 5\nConnection: keep-alive\n\nhello";
+    fossil_net_parser_t p;
+    fossil_net_http_request_t req;
+    fossil_net_parser_init(&p, 0);
+    uint32_t total = (uint32_t)strlen(raw);
+    int n = 0;
+    uint32_t len = 0;
+    /* One byte at a time, as from a slow client. */
+    while (len < total && (n = fossil_net_parser_parse(&p, raw, ++len, &req)) == 0)
+        ;
+    ASSUME_ITS_TRUE(n > 0);
+    ASSUME_ITS_TRUE((uint32_t)n == len);
+    ASSUME_ITS_TRUE(req.method == FOSSIL_NET_HTTP_POST);
+    ASSUME_ITS_TRUE(req.version_minor == 0);
+    ASSUME_ITS_TRUE(req.keep_alive);
+    ASSUME_ITS_TRUE(req.content_length == 5);
+    ASSUME_ITS_TRUE(p.scanned < (uint32_t)n);
+}
+
+FOSSIL_TEST(c_parser_test_rejects) {
+    static const struct { const char *raw; int status; } cases[] = {
+        { "GET / HTTP/2.0\r\nHost: a\r\n\r\n", 505 },
+        { "GET / HTTP/1.1\r\n\r\n", 400 },
+        { "GET / HTTP/1.1\r\nHost : a\r\n\r\n", 400 },
+        { "GET / HTTP/1.1\r\nHost: a\r\nX: 1\r\n  folded\r\n\r\n", 400 },
+        { "POST / HTTP/1.1\r\nHost: a\r\nContent-Length: 3\r\nContent-Length: 4\r\n\r\n", 400 },
+        { "POST / HTTP/1.1\r\nHost: a\r\nContent-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n", 400 },
+        { "POST / HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: gzip\r\n\r\n", 501 },
+        { "POST / HTTP/1.1\r\nHost: a\r\nContent-Length: -1\r\n\r\n", 400 },
+        { "G@T / HTTP/1.1\r\nHost: a\r\n\r\n", 400 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        fossil_net_parser_t p;
+        fossil_net_http_request_t req;
+        fossil_net_parser_init(&p, 0);
+        ASSUME_ITS_TRUE(c_parser_feed(&p, cases[i].raw, &req) == -1);
+        ASSUME_ITS_TRUE(p.status == cases[i].status);
+    }
+}
+
+FOSSIL_TEST(c_parser_test_limits) {
+    char big[300];
+    fossil_net_parser_t p;
+    fossil_net_http_request_t req;
+
+    memset(big, 'a', sizeof(big));
+    memcpy(big, "GET /", 5);
+    fossil_net_parser_init(&p, 256);
+    ASSUME_ITS_TRUE(fossil_net_parser_parse(&p, big, sizeof(big), &req) == -1);
+    ASSUME_ITS_TRUE(p.status == 414);
+
+    const char *head = "GET / HTTP/1.1\r\nHost: a\r\nX-Big: ";
+    memcpy(big, head, strlen(head));
+    fossil_net_parser_init(&p, 256);
+    ASSUME_ITS_TRUE(fossil_net_parser_parse(&p, big, sizeof(big), &req) == -1);
+    ASSUME_ITS_TRUE(p.status == 431);
+}
+
+FOSSIL_TEST(c_parser_test_chunked) {
+    const char *head = "POST /c HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\nExpect: 100-continue\r\n\r\n";
+    fossil_net_parser_t p;
+    fossil_net_http_request_t req;
+    fossil_net_parser_init(&p, 0);
+    ASSUME_ITS_TRUE(c_parser_feed(&p, head, &req) > 0);
+    ASSUME_ITS_TRUE(req.chunked);
+    ASSUME_ITS_TRUE(req.expect_continue);
+
+    char a[] = "5;ext=1\r\nhel";
+    char b[] = "lo\r\n6\r\n world\r\n0\r\nTrailer: x\r\n\r\nGET";
+    char body[32];
+    uint32_t len = (uint32_t)strlen(a);
+    ASSUME_ITS_TRUE(fossil_net_parser_decode_chunked(&p, a, &len) == -2);
+    ASSUME_ITS_TRUE(len == 3);
+    memcpy(body, a, len);
+    uint32_t got = len;
+    len = (uint32_t)strlen(b);
+    int rest = fossil_net_parser_decode_chunked(&p, b, &len);
+    ASSUME_ITS_TRUE(rest == 3);
+    memcpy(body + got, b, len);
+    got += len;
+    ASSUME_ITS_TRUE(got == 11 && memcmp(body, "hello world", 11) == 0);
+    ASSUME_ITS_TRUE(memcmp(b + len, "GET", 3) == 0);
+
+    char bad[] = "zz\r\n";
+    fossil_net_parser_reset(&p);
+    len = (uint32_t)strlen(bad);
+    ASSUME_ITS_TRUE(fossil_net_parser_decode_chunked(&p, bad, &len) == -1);
+}
+
+FOSSIL_TEST(c_parser_test_connection_tokens) {
+    fossil_net_parser_t p;
+    fossil_net_http_request_t req;
+    fossil_net_parser_init(&p, 0);
+    ASSUME_ITS_TRUE(c_parser_feed(&p, "GET /ws HTTP/1.1\r\nHost: a\r\nConnection: Upgrade, close\r\n\r\n", &req) > 0);
+    ASSUME_ITS_TRUE(req.upgrade);
+    ASSUME_ITS_TRUE(!req.keep_alive);
+
+    fossil_net_parser_reset(&p);
+    ASSUME_ITS_TRUE(c_parser_feed(&p, "BREW /pot HTTP/1.0\r\n\r\n", &req) > 0);
+    ASSUME_ITS_TRUE(req.method == FOSSIL_NET_HTTP_OTHER);
+    ASSUME_ITS_TRUE(fossil_net_slice_eq(req.method_name, "BREW"));
+    ASSUME_ITS_TRUE(!req.keep_alive);
+    ASSUME_ITS_TRUE(strcmp(fossil_net_http_method_name(FOSSIL_NET_HTTP_OPTIONS), "OPTIONS") == 0);
+    ASSUME_ITS_TRUE(fossil_net_http_method_parse("DELETE", 6) == FOSSIL_NET_HTTP_DELETE);
+}
+
+FOSSIL_TEST(c_parser_test_etag_match) {
+    const char *tags = "\"a\", W/\"b\" ,\"c\"";
+    fossil_net_slice_t list = { tags, (uint32_t)strlen(tags) };
+    ASSUME_ITS_TRUE(fossil_net_http_etag_match(list, "\"a\""));
+    ASSUME_ITS_TRUE(fossil_net_http_etag_match(list, "\"b\""));
+    ASSUME_ITS_TRUE(fossil_net_http_etag_match(list, "\"c\""));
+    ASSUME_ITS_TRUE(!fossil_net_http_etag_match(list, "\"d\""));
+    fossil_net_slice_t any = { " * ", 3 };
+    ASSUME_ITS_TRUE(fossil_net_http_etag_match(any, "\"d\""));
+    fossil_net_slice_t none = { "", 0 };
+    ASSUME_ITS_TRUE(!fossil_net_http_etag_match(none, "\"d\""));
+    ASSUME_ITS_TRUE(!fossil_net_http_etag_match(list, NULL));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_parser_tests) {
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_request_line_and_headers);
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_incremental);
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_rejects);
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_limits);
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_chunked);
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_connection_tokens);
+    FOSSIL_ADD_TEST(c_parser_fixture, c_parser_test_etag_match);
+
+    FOSSIL_ADD_SUITE(c_parser_fixture);
+} // end of tests
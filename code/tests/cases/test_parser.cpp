@@ -0,0 +1,112 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_parser_fixture);
+
+FOSSIL_SETUP(cpp_parser_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_parser_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::net::Parser;
+
+FOSSIL_TEST(cpp_parser_test_parse) {
+    Parser parser;
+    fossil_net_http_request_t req;
+    std::string raw = "PUT /doc/7 HTTP/1.1\r\nHost: h\r\nContent-Length: 2\r\n\r\nok";
+    int n = parser.parse(raw.data(), static_cast<uint32_t>(raw.size()), &req);
+    ASSUME_ITS_TRUE(n == static_cast<int>(raw.size()) - 2);
+    ASSUME_ITS_TRUE(req.method == FOSSIL_NET_HTTP_PUT);
+    ASSUME_ITS_TRUE(Parser::str(req.path) == "/doc/7");
+    ASSUME_ITS_TRUE(req.content_length == 2);
+}
+
+FOSSIL_TEST(cpp_parser_test_error_status) {
+    Parser parser;
+    fossil_net_http_request_t req;
+    std::string raw = "GET / HTTP/3.0\r\nHost: h\r\n\r\n";
+    ASSUME_ITS_TRUE(parser.parse(raw.data(), static_cast<uint32_t>(raw.size()), &req) == -1);
+    ASSUME_ITS_TRUE(parser.status() == 505);
+    parser.reset();
+    ASSUME_ITS_TRUE(parser.status() == 0);
+}
+
+FOSSIL_TEST(cpp_parser_test_pipelined) {
+    Parser parser;
+    fossil_net_http_request_t req;
+    std::string raw = "GET /a HTTP/1.1\r\nHost: h\r\n\r\nGET /b HTTP/1.1\r\nHost: h\r\n\r\n";
+    int first = parser.parse(raw.data(), static_cast<uint32_t>(raw.size()), &req);
+    ASSUME_ITS_TRUE(first > 0);
+    ASSUME_ITS_TRUE(Parser::str(req.path) == "/a");
+    parser.reset();
+    const char *next = raw.data() + first;
+    int second = parser.parse(next, static_cast<uint32_t>(raw.size()) - first, &req);
+    ASSUME_ITS_TRUE(first + second == static_cast<int>(raw.size()));
+    ASSUME_ITS_TRUE(Parser::str(req.path) == "/b");
+}
+
+FOSSIL_TEST(cpp_parser_test_chunked) {
+    Parser parser;
+    fossil_net_http_request_t req;
+    std::string raw = "POST / HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: chunked\r\n\r\n";
+    ASSUME_ITS_TRUE(parser.parse(raw.data(), static_cast<uint32_t>(raw.size()), &req) > 0);
+    char body[] = "3\r\nabc\r\n0\r\n\r\n";
+    uint32_t len = sizeof(body) - 1;
+    ASSUME_ITS_TRUE(parser.decode_chunked(body, &len) == 0);
+    ASSUME_ITS_TRUE(std::string(body, len) == "abc");
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_parser_tests) {
+    FOSSIL_ADD_TEST(cpp_parser_fixture, cpp_parser_test_parse);
+    FOSSIL_ADD_TEST(cpp_parser_fixture, cpp_parser_test_error_status);
+    FOSSIL_ADD_TEST(cpp_parser_fixture, cpp_parser_test_pipelined);
+    FOSSIL_ADD_TEST(cpp_parser_fixture, cpp_parser_test_chunked);
+
+    FOSSIL_ADD_SUITE(cpp_parser_fixture);
+} // end of tests
@@ -0,0 +1,211 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdatomic.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_pool_fixture);
+
+FOSSIL_SETUP(c_pool_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_pool_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static void c_pool_sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static atomic_uint c_pool_count;
+
+static void c_pool_incr(void *arg) {
+    (void)arg;
+    atomic_fetch_add(&c_pool_count, 1);
+}
+
+FOSSIL_TEST(c_pool_test_submit_and_drain) {
+    fossil_net_pool_config_t cfg = {0};
+    cfg.threads = 4;
+    cfg.deque_size = 16; /* force the deques to grow */
+    fossil_net_pool_t *pool = fossil_net_pool_create(&cfg);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_TRUE(fossil_net_pool_thread_count(pool) == 4);
+    ASSUME_ITS_TRUE(fossil_net_pool_worker_index(pool) == -1);
+    atomic_store(&c_pool_count, 0);
+    for (int i = 0; i < 20000; ++i)
+        ASSUME_ITS_TRUE(fossil_net_pool_submit(pool, c_pool_incr, NULL) == 0);
+    fossil_net_pool_stats_t st;
+    for (int i = 0; i < 500 && atomic_load(&c_pool_count) < 20000; ++i)
+        c_pool_sleep_ms(10);
+    ASSUME_ITS_TRUE(fossil_net_pool_get_stats(pool, &st) == 0);
+    ASSUME_ITS_TRUE(st.submitted == 20000);
+    ASSUME_ITS_TRUE(st.executed == 20000);
+    fossil_net_pool_destroy(pool);
+    ASSUME_ITS_TRUE(atomic_load(&c_pool_count) == 20000);
+}
+
+typedef struct c_pool_tree {
+    fossil_net_pool_t *pool;
+    atomic_uint leaves;
+    atomic_uint bad_index;
+} c_pool_tree_t;
+
+static void c_pool_leaf(void *arg) {
+    c_pool_tree_t *tree = (c_pool_tree_t *)arg;
+    int idx = fossil_net_pool_worker_index(tree->pool);
+    if (idx < 0 || (uint32_t)idx >= fossil_net_pool_thread_count(tree->pool))
+        atomic_fetch_add(&tree->bad_index, 1);
+    volatile uint64_t x = 0;
+    for (int i = 0; i < 20000; ++i)
+        x += (uint64_t)i * 2654435761u;
+    atomic_fetch_add(&tree->leaves, 1);
+}
+
+/* One task fans out into many: the others can only get them by stealing. */
+static void c_pool_root(void *arg) {
+    c_pool_tree_t *tree = (c_pool_tree_t *)arg;
+    for (int i = 0; i < 2000; ++i)
+        fossil_net_pool_submit(tree->pool, c_pool_leaf, tree);
+}
+
+FOSSIL_TEST(c_pool_test_nested_steal) {
+    c_pool_tree_t tree = {0};
+    fossil_net_pool_config_t cfg = {0};
+    cfg.threads = 4;
+    tree.pool = fossil_net_pool_create(&cfg);
+    ASSUME_ITS_TRUE(tree.pool != NULL);
+    ASSUME_ITS_TRUE(fossil_net_pool_submit(tree.pool, c_pool_root, &tree) == 0);
+    for (int i = 0; i < 1000 && atomic_load(&tree.leaves) < 2000; ++i)
+        c_pool_sleep_ms(10);
+    ASSUME_ITS_TRUE(atomic_load(&tree.leaves) == 2000);
+    ASSUME_ITS_TRUE(atomic_load(&tree.bad_index) == 0);
+    fossil_net_pool_stats_t st;
+    fossil_net_pool_get_stats(tree.pool, &st);
+    ASSUME_ITS_TRUE(st.executed == 2001);
+    ASSUME_ITS_TRUE(st.stolen > 0);
+    fossil_net_pool_destroy(tree.pool);
+}
+
+typedef struct c_pool_reply {
+    fossil_net_pool_t *pool;
+    fossil_net_loop_t *expect;
+    atomic_uint done;
+    atomic_uint on_wrong_loop;
+    uint64_t result;
+} c_pool_reply_t;
+
+static void c_pool_work(void *arg) {
+    c_pool_reply_t *r = (c_pool_reply_t *)arg;
+    if (fossil_net_loop_current() != NULL)
+        atomic_fetch_add(&r->on_wrong_loop, 1);
+    r->result = 42;
+}
+
+static void c_pool_done(fossil_net_loop_t *loop, void *arg) {
+    c_pool_reply_t *r = (c_pool_reply_t *)arg;
+    if (loop != r->expect || fossil_net_loop_current() != r->expect || r->result != 42)
+        atomic_fetch_add(&r->on_wrong_loop, 1);
+    atomic_fetch_add(&r->done, 1);
+}
+
+static void c_pool_offload(fossil_net_loop_t *loop, void *arg) {
+    (void)loop;
+    c_pool_reply_t *r = (c_pool_reply_t *)arg;
+    fossil_net_pool_submit_reply(r->pool, c_pool_work, c_pool_done, r);
+}
+
+FOSSIL_TEST(c_pool_test_reply_on_loop) {
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_callbacks_t cb = {0};
+    fossil_net_reactor_config_t rcfg = {0};
+    rcfg.threads = 2;
+    fossil_net_reactor_t *reactor = fossil_net_reactor_create(server, &rcfg, &cb, NULL);
+    ASSUME_ITS_TRUE(reactor != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(reactor) == 0);
+
+    c_pool_reply_t r = {0};
+    r.pool = fossil_net_pool_create(NULL);
+    r.expect = fossil_net_reactor_loop(reactor, 1);
+    ASSUME_ITS_TRUE(fossil_net_loop_post(r.expect, c_pool_offload, &r) == 0);
+    for (int i = 0; i < 500 && atomic_load(&r.done) == 0; ++i)
+        c_pool_sleep_ms(10);
+    ASSUME_ITS_TRUE(atomic_load(&r.done) == 1);
+    ASSUME_ITS_TRUE(atomic_load(&r.on_wrong_loop) == 0);
+
+    /* Outside a loop the completion runs on the worker with no loop. */
+    c_pool_reply_t plain = {0};
+    plain.pool = r.pool;
+    plain.expect = NULL;
+    ASSUME_ITS_TRUE(fossil_net_pool_submit_reply(plain.pool, c_pool_work, c_pool_done, &plain) == 0);
+    fossil_net_pool_destroy(r.pool);
+    ASSUME_ITS_TRUE(atomic_load(&plain.done) == 1);
+    ASSUME_ITS_TRUE(atomic_load(&plain.on_wrong_loop) == 0);
+
+    fossil_net_reactor_destroy(reactor);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_pool_test_invalid) {
+    ASSUME_ITS_TRUE(fossil_net_pool_submit(NULL, c_pool_incr, NULL) != 0);
+    fossil_net_pool_t *pool = fossil_net_pool_create(NULL);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_TRUE(fossil_net_pool_submit(pool, NULL, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_pool_submit_reply(pool, c_pool_incr, NULL, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_pool_get_stats(pool, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_pool_worker_index(NULL) == -1);
+    fossil_net_pool_destroy(pool);
+    fossil_net_pool_destroy(NULL);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_pool_tests) {
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_test_submit_and_drain);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_test_nested_steal);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_test_reply_on_loop);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_test_invalid);
+
+    FOSSIL_ADD_SUITE(c_pool_fixture);
+} // end of tests
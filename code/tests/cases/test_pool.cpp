@@ -0,0 +1,102 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <atomic>
+#include <vector>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_pool_fixture);
+
+FOSSIL_SETUP(cpp_pool_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_pool_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace {
+
+std::atomic<uint64_t> cpp_pool_sum{0};
+
+void cpp_pool_add(void *arg) {
+    cpp_pool_sum += reinterpret_cast<uintptr_t>(arg);
+}
+
+} // namespace
+
+FOSSIL_TEST(cpp_pool_test_class_sum) {
+    cpp_pool_sum = 0;
+    {
+        fossil_net_pool_config_t cfg{};
+        cfg.threads = 3;
+        fossil::net::Pool pool(&cfg);
+        ASSUME_ITS_TRUE(pool.native_handle() != nullptr);
+        ASSUME_ITS_TRUE(pool.thread_count() == 3);
+        for (uintptr_t i = 1; i <= 1000; ++i)
+            ASSUME_ITS_TRUE(pool.submit(cpp_pool_add, reinterpret_cast<void *>(i)) == 0);
+    } // destroy runs everything still queued
+    ASSUME_ITS_TRUE(cpp_pool_sum == 500500);
+}
+
+FOSSIL_TEST(cpp_pool_test_class_move_and_stats) {
+    fossil::net::Pool pool;
+    static std::atomic<int> ran;
+    ran = 0;
+    ASSUME_ITS_TRUE(pool.submit([](void *) { ran++; }, nullptr) == 0);
+    fossil::net::Pool moved(std::move(pool));
+    ASSUME_ITS_TRUE(pool.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.submit_reply([](void *) { ran++; },
+                                       [](fossil_net_loop_t *loop, void *) { if (!loop) ran++; },
+                                       nullptr) == 0);
+    moved = fossil::net::Pool();
+    ASSUME_ITS_TRUE(ran == 3);
+    ASSUME_ITS_TRUE(moved.stats().executed == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_pool_tests) {
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_test_class_sum);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_test_class_move_and_stats);
+
+    FOSSIL_ADD_SUITE(cpp_pool_fixture);
+} // end of tests
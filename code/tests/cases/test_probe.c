@@ -0,0 +1,177 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_probe_fixture);
+
+FOSSIL_SETUP(c_probe_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_probe_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static void c_probe_sleep_ms(long ms) {
+    struct timespec ts = { 0, ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// Raw sockets need privileges and ping sockets a permissive ping_group_range
+static int c_probe_socket(fossil_net_socket_t *sock, const char *family) {
+    if (fossil_net_socket_create(sock, "raw", family) == 0) return 0;
+    return fossil_net_socket_create(sock, "icmp", family);
+}
+
+static uint32_t c_probe_wait(fossil_net_probe_t *p, uint32_t want) {
+    uint32_t total = 0;
+    for (int i = 0; i < 200 && total < want; ++i) {
+        uint32_t r = 0;
+        fossil_net_probe_poll(p, &r);
+        total += r;
+        if (total < want) c_probe_sleep_ms(5);
+    }
+    return total;
+}
+
+FOSSIL_TEST(c_probe_test_loopback_ipv4) {
+    fossil_net_socket_t sock;
+    if (c_probe_socket(&sock, "ipv4") != 0) return;
+    fossil_net_probe_config_t cfg = { 16, 2000, 32, 0x4242 };
+    fossil_net_probe_t *p = fossil_net_probe_create(&sock, &cfg);
+    ASSUME_ITS_TRUE(p != NULL);
+
+    const char *addrs[] = { "127.0.0.1", "127.0.0.2", "127.0.0.1" };
+    for (int i = 0; i < 3; ++i) {
+        fossil_net_endpoint_t ep;
+        fossil_net_endpoint_parse(&ep, addrs[i], 0);
+        ASSUME_ITS_TRUE(fossil_net_probe_add_target(p, &ep) == i);
+    }
+    fossil_net_endpoint_t v6;
+    fossil_net_endpoint_parse(&v6, "::1", 0);
+    ASSUME_ITS_TRUE(fossil_net_probe_add_target(p, &v6) == -1);
+
+    for (int round = 0; round < 2; ++round) {
+        uint32_t processed = 0;
+        ASSUME_ITS_TRUE(fossil_net_probe_send(p, 0, 3, &processed) == 0 && processed == 3);
+        ASSUME_ITS_TRUE(c_probe_wait(p, 3) == 3);
+    }
+
+    fossil_net_probe_target_stats_t ts;
+    ASSUME_ITS_TRUE(fossil_net_probe_target_stats(p, 1, &ts) == 0);
+    ASSUME_ITS_TRUE(ts.sent == 2 && ts.received == 2 && ts.lost == 0);
+    ASSUME_ITS_TRUE(ts.rtt_min_ns > 0 && ts.rtt_min_ns <= ts.rtt_max_ns);
+    uint32_t hist = 0;
+    for (int b = 0; b < FOSSIL_NET_PROBE_HIST_BUCKETS; ++b) hist += ts.histogram[b];
+    ASSUME_ITS_TRUE(hist == 2);
+    uint64_t p99 = fossil_net_probe_rtt_quantile_ns(&ts, 0.99);
+    ASSUME_ITS_TRUE(p99 > 0 && p99 <= ts.rtt_max_ns);
+
+    fossil_net_probe_stats_t st;
+    fossil_net_probe_get_stats(p, &st);
+    ASSUME_ITS_TRUE(st.sent == 6 && st.received == 6);
+    fossil_net_probe_destroy(p);
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(c_probe_test_loopback_ipv6) {
+    fossil_net_socket_t sock;
+    if (c_probe_socket(&sock, "ipv6") != 0) return;
+    fossil_net_probe_t *p = fossil_net_probe_create(&sock, NULL);
+    ASSUME_ITS_TRUE(p != NULL);
+    fossil_net_endpoint_t ep;
+    fossil_net_endpoint_parse(&ep, "::1", 0);
+    ASSUME_ITS_TRUE(fossil_net_probe_add_target(p, &ep) == 0);
+    uint32_t processed = 0;
+    ASSUME_ITS_TRUE(fossil_net_probe_send(p, 0, 1, &processed) == 0);
+    // ::1 may be absent in minimal network namespaces
+    if (processed == 1 && c_probe_wait(p, 1) == 1) {
+        fossil_net_probe_target_stats_t ts;
+        fossil_net_probe_target_stats(p, 0, &ts);
+        ASSUME_ITS_TRUE(ts.received == 1);
+    }
+    fossil_net_probe_destroy(p);
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(c_probe_test_timeout) {
+    fossil_net_socket_t sock;
+    if (c_probe_socket(&sock, "ipv4") != 0) return;
+    fossil_net_probe_config_t cfg = { 4, 20, 8, 0 };
+    fossil_net_probe_t *p = fossil_net_probe_create(&sock, &cfg);
+    fossil_net_endpoint_t ep;
+    fossil_net_endpoint_parse(&ep, "198.51.100.1", 0); // TEST-NET-2, should not answer
+    fossil_net_probe_add_target(p, &ep);
+    uint32_t processed = 0;
+    fossil_net_probe_send(p, 0, 1, &processed);
+    c_probe_sleep_ms(40);
+    fossil_net_probe_poll(p, NULL);
+
+    fossil_net_probe_stats_t st;
+    fossil_net_probe_get_stats(p, &st);
+    // Past the deadline the probe is resolved one way or another: timed out,
+    // refused for lack of a route, or (on an odd network) answered in time
+    ASSUME_ITS_TRUE(st.lost + st.send_errors + st.received == 1);
+    fossil_net_probe_destroy(p);
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(c_probe_test_rejects_non_icmp) {
+    fossil_net_socket_t sock;
+    if (fossil_net_socket_create(&sock, "udp", "ipv4") != 0) return;
+    ASSUME_ITS_TRUE(fossil_net_probe_create(&sock, NULL) == NULL);
+    ASSUME_ITS_TRUE(strcmp(fossil_net_socket_type_id(&sock), "udp") == 0);
+    fossil_net_socket_close(&sock);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_probe_tests) {
+    FOSSIL_ADD_TEST(c_probe_fixture, c_probe_test_loopback_ipv4);
+    FOSSIL_ADD_TEST(c_probe_fixture, c_probe_test_loopback_ipv6);
+    FOSSIL_ADD_TEST(c_probe_fixture, c_probe_test_timeout);
+    FOSSIL_ADD_TEST(c_probe_fixture, c_probe_test_rejects_non_icmp);
+
+    FOSSIL_ADD_SUITE(c_probe_fixture);
+} // end of tests
@@ -0,0 +1,94 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <chrono>
+#include <thread>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_probe_fixture);
+
+FOSSIL_SETUP(cpp_probe_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_probe_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_probe_test_class_loopback) {
+    fossil_net_socket_t sock;
+    if (fossil_net_socket_create(&sock, "raw", "ipv4") != 0 &&
+        fossil_net_socket_create(&sock, "icmp", "ipv4") != 0)
+        return;
+    {
+        fossil::net::Probe probe(&sock);
+        ASSUME_ITS_TRUE(probe.native_handle() != nullptr);
+        fossil_net_endpoint_t ep;
+        fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+        ASSUME_ITS_TRUE(probe.add_target(ep) == 0);
+        ASSUME_ITS_TRUE(probe.send_all() == 1);
+        uint32_t got = 0;
+        for (int i = 0; i < 200 && got == 0; ++i) {
+            got = probe.poll();
+            if (!got) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSUME_ITS_TRUE(got == 1);
+        ASSUME_ITS_TRUE(probe.target_stats(0).received == 1);
+        ASSUME_ITS_TRUE(probe.stats().sent == 1);
+    }
+    fossil_net_socket_close(&sock);
+}
+
+FOSSIL_TEST(cpp_probe_test_class_invalid) {
+    fossil::net::Probe probe(nullptr);
+    ASSUME_ITS_TRUE(probe.native_handle() == nullptr);
+    fossil::net::Probe moved(std::move(probe));
+    ASSUME_ITS_TRUE(moved.native_handle() == nullptr);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_probe_tests) {
+    FOSSIL_ADD_TEST(cpp_probe_fixture, cpp_probe_test_class_loopback);
+    FOSSIL_ADD_TEST(cpp_probe_fixture, cpp_probe_test_class_invalid);
+
+    FOSSIL_ADD_SUITE(cpp_probe_fixture);
+} // end of tests
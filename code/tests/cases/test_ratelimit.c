@@ -0,0 +1,207 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <errno.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_ratelimit_fixture);
+
+FOSSIL_SETUP(c_ratelimit_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_ratelimit_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static int c_ratelimit_udp_pair(fossil_net_socket_t *rx, fossil_net_socket_t *tx) {
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_create(rx, "udp", "ipv4") != 0) return -1;
+    if (fossil_net_socket_create(tx, "udp", "ipv4") != 0) return -1;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    if (fossil_net_socket_bind_endpoint(rx, &ep) != 0) return -1;
+    if (fossil_net_socket_get_local_endpoint(rx, &ep) != 0) return -1;
+    return fossil_net_socket_connect_endpoint(tx, &ep);
+}
+
+FOSSIL_TEST(c_ratelimit_test_acquire_within_burst) {
+    fossil_net_ratelimit_t *rl = fossil_net_ratelimit_create(1000, 4000);
+    ASSUME_ITS_TRUE(rl != NULL);
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_burst(rl) == 4000);
+
+    // The full burst is available immediately, then the bucket is empty
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_acquire(rl, 3000) == 0);
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_acquire(rl, 1000) == 0);
+    uint64_t wait = fossil_net_ratelimit_acquire(rl, 1000);
+    ASSUME_ITS_TRUE(wait > 0);
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_delay_ms(rl, 1000) > 0);
+
+    // Larger than the burst can never be granted
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_acquire(rl, 5000) == UINT64_MAX);
+    fossil_net_ratelimit_destroy(rl);
+}
+
+FOSSIL_TEST(c_ratelimit_test_release_and_stats) {
+    fossil_net_ratelimit_t *rl = fossil_net_ratelimit_create(100, 1000);
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_acquire(rl, 1000) == 0);
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_acquire(rl, 500) > 0);
+
+    // Returning unused tokens makes them available again
+    fossil_net_ratelimit_release(rl, 500);
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_acquire(rl, 500) == 0);
+
+    fossil_net_ratelimit_record_throttle(rl, 1234);
+    fossil_net_ratelimit_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_ratelimit_get_stats(rl, &st) == 0);
+    ASSUME_ITS_TRUE(st.bytes_granted == 1000);
+    ASSUME_ITS_TRUE(st.throttle_events == 1);
+    ASSUME_ITS_TRUE(st.throttled_ns == 1234);
+    fossil_net_ratelimit_destroy(rl);
+}
+
+FOSSIL_TEST(c_ratelimit_test_nonblocking_send_throttled) {
+    fossil_net_socket_t rx, tx;
+    ASSUME_ITS_TRUE(c_ratelimit_udp_pair(&rx, &tx) == 0);
+    fossil_net_socket_set_blocking(&tx, false);
+
+    fossil_net_ratelimit_t *rl = fossil_net_ratelimit_create(10, 64);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_ratelimit(&tx, rl) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_get_ratelimit(&tx) == rl);
+
+    char buf[64] = {0};
+    uint32_t sent = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&tx, buf, sizeof(buf), &sent) == 0);
+    ASSUME_ITS_TRUE(sent == sizeof(buf));
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&tx, buf, sizeof(buf), &sent) == -1);
+    ASSUME_ITS_TRUE(sent == 0);
+#if !defined(_WIN32)
+    ASSUME_ITS_TRUE(errno == EAGAIN);
+#endif
+
+    fossil_net_ratelimit_stats_t st;
+    fossil_net_ratelimit_get_stats(rl, &st);
+    ASSUME_ITS_TRUE(st.throttle_events == 1);
+
+    // Detaching restores the unthrottled path
+    ASSUME_ITS_TRUE(fossil_net_socket_set_ratelimit(&tx, NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_get_ratelimit(&tx) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&tx, buf, sizeof(buf), &sent) == 0);
+
+    fossil_net_socket_close(&tx);
+    fossil_net_socket_close(&rx);
+    fossil_net_ratelimit_destroy(rl);
+}
+
+FOSSIL_TEST(c_ratelimit_test_datagram_over_burst) {
+    fossil_net_socket_t rx, tx;
+    ASSUME_ITS_TRUE(c_ratelimit_udp_pair(&rx, &tx) == 0);
+    fossil_net_ratelimit_t *rl = fossil_net_ratelimit_create(1000000, 100);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_ratelimit(&tx, rl) == 0);
+
+    // A datagram over the burst is refused whole, never cut short
+    char buf[500] = {0};
+    uint32_t sent = 1;
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(&rx, &ep) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_send_to(&tx, buf, sizeof(buf), &ep, &sent) == -1);
+    ASSUME_ITS_TRUE(sent == 0);
+#if !defined(_WIN32)
+    ASSUME_ITS_TRUE(errno == EMSGSIZE);
+#endif
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&tx, buf, sizeof(buf), &sent) == -1);
+
+    // One within the burst is charged and delivered in full
+    ASSUME_ITS_TRUE(fossil_net_socket_send_to(&tx, buf, 80, &ep, &sent) == 0);
+    ASSUME_ITS_TRUE(sent == 80);
+    char back[512];
+    uint32_t got = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_receive(&rx, back, sizeof(back), &got) == 0);
+    ASSUME_ITS_TRUE(got == 80);
+
+    fossil_net_socket_close(&tx);
+    fossil_net_socket_close(&rx);
+    fossil_net_ratelimit_destroy(rl);
+}
+
+FOSSIL_TEST(c_ratelimit_test_group_limiter_shared) {
+    fossil_net_socket_t a, b;
+    fossil_net_socket_create(&a, "udp", "ipv4");
+    fossil_net_socket_create(&b, "udp", "ipv4");
+    fossil_net_ratelimit_t *group = fossil_net_ratelimit_create(1, 100);
+    fossil_net_socket_set_ratelimit(&a, group);
+    fossil_net_socket_set_ratelimit(&b, group);
+    ASSUME_ITS_TRUE(fossil_net_socket_get_ratelimit(&a) == fossil_net_socket_get_ratelimit(&b));
+
+    // Closing clears the attachment so a reused descriptor starts clean
+    fossil_net_socket_close(&a);
+    fossil_net_socket_t c;
+    fossil_net_socket_create(&c, "udp", "ipv4");
+    ASSUME_ITS_TRUE(fossil_net_socket_get_ratelimit(&c) == NULL);
+
+    fossil_net_socket_close(&c);
+    fossil_net_socket_close(&b);
+    fossil_net_ratelimit_destroy(group);
+}
+
+FOSSIL_TEST(c_ratelimit_test_pacing_rate) {
+    fossil_net_socket_t sock;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&sock, "tcp", "ipv4") == 0);
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(fossil_net_socket_set_pacing_rate(&sock, 1000000) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_pacing_rate(&sock, 0) == 0);
+#else
+    (void)fossil_net_socket_set_pacing_rate(&sock, 1000000);
+#endif
+    fossil_net_socket_close(&sock);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_ratelimit_tests) {
+    FOSSIL_ADD_TEST(c_ratelimit_fixture, c_ratelimit_test_acquire_within_burst);
+    FOSSIL_ADD_TEST(c_ratelimit_fixture, c_ratelimit_test_release_and_stats);
+    FOSSIL_ADD_TEST(c_ratelimit_fixture, c_ratelimit_test_nonblocking_send_throttled);
+    FOSSIL_ADD_TEST(c_ratelimit_fixture, c_ratelimit_test_datagram_over_burst);
+    FOSSIL_ADD_TEST(c_ratelimit_fixture, c_ratelimit_test_group_limiter_shared);
+    FOSSIL_ADD_TEST(c_ratelimit_fixture, c_ratelimit_test_pacing_rate);
+
+    FOSSIL_ADD_SUITE(c_ratelimit_fixture);
+} // end of tests
@@ -0,0 +1,82 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_ratelimit_fixture);
+
+FOSSIL_SETUP(cpp_ratelimit_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_ratelimit_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_ratelimit_test_class_acquire) {
+    fossil::net::RateLimit rl(1000, 2000);
+    ASSUME_ITS_TRUE(rl.native_handle() != nullptr);
+    ASSUME_ITS_TRUE(rl.acquire(2000) == 0);
+    ASSUME_ITS_TRUE(rl.acquire(1) > 0);
+    ASSUME_ITS_TRUE(rl.delay_ms(1000) > 0);
+
+    // Raising the rate keeps the limiter usable
+    ASSUME_ITS_TRUE(rl.set_rate(1000000, 2000) == 0);
+    ASSUME_ITS_TRUE(rl.stats().bytes_granted == 2000);
+}
+
+FOSSIL_TEST(cpp_ratelimit_test_class_attach) {
+    fossil::net::Socket sock;
+    ASSUME_ITS_TRUE(sock.socket_create("udp", "ipv4") == 0);
+    fossil::net::RateLimit rl(100, 1000);
+    ASSUME_ITS_TRUE(rl.attach(sock.native_handle()) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_get_ratelimit(sock.native_handle()) == rl.native_handle());
+    fossil_net_socket_set_ratelimit(sock.native_handle(), nullptr);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_ratelimit_tests) {
+    FOSSIL_ADD_TEST(cpp_ratelimit_fixture, cpp_ratelimit_test_class_acquire);
+    FOSSIL_ADD_TEST(cpp_ratelimit_fixture, cpp_ratelimit_test_class_attach);
+
+    FOSSIL_ADD_SUITE(cpp_ratelimit_fixture);
+} // end of tests
@@ -0,0 +1,932 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_reactor_fixture);
+
+FOSSIL_SETUP(c_reactor_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_reactor_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+typedef struct c_reactor_state {
+    atomic_uint accepts;
+    atomic_uint closes;
+    atomic_uint loops_seen; /* bit per loop index */
+    int reject;
+} c_reactor_state_t;
+
+static int c_reactor_on_accept(fossil_net_conn_t *conn, void *user) {
+    c_reactor_state_t *st = (c_reactor_state_t *)user;
+    atomic_fetch_add(&st->accepts, 1);
+    atomic_fetch_or(&st->loops_seen, 1u << fossil_net_loop_index(fossil_net_conn_loop(conn)));
+    return st->reject;
+}
+
+static void c_reactor_on_readable(fossil_net_conn_t *conn, void *user) {
+    (void)user;
+    char buf[512];
+    uint32_t n = 0, sent = 0;
+    int rc = fossil_net_conn_receive(conn, buf, sizeof(buf), &n);
+    if (rc == 1)
+        return;
+    if (rc != 0 || n == 0) {
+        fossil_net_conn_close(conn);
+        return;
+    }
+    fossil_net_conn_send(conn, buf, n, &sent);
+}
+
+static void c_reactor_on_close(fossil_net_conn_t *conn, void *user) {
+    (void)conn;
+    atomic_fetch_add(&((c_reactor_state_t *)user)->closes, 1);
+}
+
+static const fossil_net_reactor_callbacks_t c_reactor_callbacks = {
+    c_reactor_on_accept, c_reactor_on_readable, NULL, c_reactor_on_close, NULL, NULL
+};
+
+static void c_reactor_sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static bool c_reactor_wait(atomic_uint *counter, unsigned target) {
+    for (int i = 0; i < 500 && atomic_load(counter) < target; ++i)
+        c_reactor_sleep_ms(10);
+    return atomic_load(counter) >= target;
+}
+
+/* Connect count clients, echo one message over each, then close them. */
+static int c_reactor_echo_round(fossil_net_server_t *server, int count) {
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) != 0)
+        return -1;
+    int ok = 0;
+    for (int i = 0; i < count; ++i) {
+        fossil_net_socket_t c;
+        char msg[32], back[32];
+        uint32_t sent = 0, got = 0;
+        if (fossil_net_socket_create(&c, "tcp", "ipv4") != 0)
+            continue;
+        snprintf(msg, sizeof(msg), "hello %d", i);
+        if (fossil_net_socket_connect_endpoint(&c, &ep) == 0 &&
+            fossil_net_socket_send(&c, msg, (uint32_t)strlen(msg), &sent) == 0 &&
+            fossil_net_socket_receive(&c, back, sizeof(back), &got) == 0 &&
+            got == strlen(msg) && memcmp(msg, back, got) == 0)
+            ok++;
+        fossil_net_socket_close(&c);
+    }
+    return ok;
+}
+
+FOSSIL_TEST(c_reactor_test_echo_handoff) {
+    c_reactor_state_t st = {0};
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 4;
+    cfg.tcp_nodelay = 1;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_loop_count(r) == 4);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    ASSUME_ITS_TRUE(c_reactor_echo_round(server, 16) == 16);
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.closes, 16));
+    ASSUME_ITS_TRUE(atomic_load(&st.loops_seen) == 0xFu);
+
+    fossil_net_reactor_stats_t s;
+    ASSUME_ITS_TRUE(fossil_net_reactor_get_stats(r, &s) == 0);
+    ASSUME_ITS_TRUE(s.accepted == 16);
+    ASSUME_ITS_TRUE(s.closed == 16);
+    ASSUME_ITS_TRUE(s.active == 0);
+    ASSUME_ITS_TRUE(s.handoffs == 12);
+    ASSUME_ITS_TRUE(fossil_net_reactor_stop(r) == 0);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_reactor_test_echo_reuseport) {
+    c_reactor_state_t st = {0};
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 2;
+    cfg.reuseport = 1;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(r != NULL);
+#endif
+    if (r) {
+        ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+        ASSUME_ITS_TRUE(c_reactor_echo_round(server, 32) == 32);
+        ASSUME_ITS_TRUE(c_reactor_wait(&st.closes, 32));
+        fossil_net_reactor_stats_t s;
+        fossil_net_reactor_get_stats(r, &s);
+        ASSUME_ITS_TRUE(s.accepted == 32);
+        ASSUME_ITS_TRUE(s.handoffs == 0);
+        fossil_net_reactor_destroy(r);
+    }
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_reactor_test_reject_and_stop) {
+    c_reactor_state_t st = {0};
+    st.reject = 1;
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 1;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep);
+    fossil_net_socket_t c;
+    char buf[8];
+    uint32_t got = 1;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+    fossil_net_socket_receive(&c, buf, sizeof(buf), &got);
+    ASSUME_ITS_TRUE(got == 0);
+    fossil_net_socket_close(&c);
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.closes, 1));
+
+    /* Connections still open at stop are closed on their loop. */
+    st.reject = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.accepts, 2));
+    ASSUME_ITS_TRUE(fossil_net_reactor_stop(r) == 0);
+    ASSUME_ITS_TRUE(atomic_load(&st.closes) == 2);
+    fossil_net_socket_close(&c);
+
+    fossil_net_reactor_stats_t s;
+    fossil_net_reactor_get_stats(r, &s);
+    ASSUME_ITS_TRUE(s.rejected == 1);
+    ASSUME_ITS_TRUE(s.active == 0);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+typedef struct c_reactor_post_state {
+    fossil_net_reactor_t *reactor;
+    atomic_uint ran;
+    atomic_uint wrong_thread;
+} c_reactor_post_state_t;
+
+static void c_reactor_task(fossil_net_loop_t *loop, void *arg) {
+    c_reactor_post_state_t *ps = (c_reactor_post_state_t *)arg;
+    if (fossil_net_loop_current() != loop || fossil_net_loop_reactor(loop) != ps->reactor)
+        atomic_fetch_add(&ps->wrong_thread, 1);
+    atomic_fetch_add(&ps->ran, 1);
+}
+
+FOSSIL_TEST(c_reactor_test_post) {
+    c_reactor_state_t st = {0};
+    c_reactor_post_state_t ps = {0};
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 3;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ps.reactor = r;
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+    ASSUME_ITS_TRUE(fossil_net_loop_current() == NULL);
+    for (int i = 0; i < 3000; ++i)
+        ASSUME_ITS_TRUE(fossil_net_loop_post(fossil_net_reactor_loop(r, (uint32_t)(i % 3)), c_reactor_task, &ps) == 0);
+    ASSUME_ITS_TRUE(c_reactor_wait(&ps.ran, 3000));
+    ASSUME_ITS_TRUE(atomic_load(&ps.wrong_thread) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_loop(r, 3) == NULL);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+static _Atomic uint64_t c_reactor_last_id;
+
+static int c_reactor_on_accept_id(fossil_net_conn_t *conn, void *user) {
+    atomic_store(&c_reactor_last_id, fossil_net_conn_id(conn));
+    return c_reactor_on_accept(conn, user);
+}
+
+typedef struct c_reactor_conn_probe {
+    atomic_uint ran;
+    atomic_uint found;
+    atomic_uint count;
+} c_reactor_conn_probe_t;
+
+static void c_reactor_count_conn(fossil_net_conn_t *conn, void *arg) {
+    (void)conn;
+    (*(uint32_t *)arg)++;
+}
+
+static void c_reactor_conn_task(fossil_net_conn_t *conn, void *arg) {
+    c_reactor_conn_probe_t *pr = (c_reactor_conn_probe_t *)arg;
+    if (conn) {
+        uint32_t visited = 0, sent = 0;
+        fossil_net_loop_t *loop = fossil_net_conn_loop(conn);
+        fossil_net_loop_foreach_conn(loop, c_reactor_count_conn, &visited);
+        if (fossil_net_loop_current() == loop &&
+            fossil_net_loop_find_conn(loop, fossil_net_conn_id(conn)) == conn &&
+            fossil_net_loop_conn_count(loop) == visited)
+            atomic_store(&pr->count, visited);
+        fossil_net_conn_send(conn, "ping", 4, &sent);
+        atomic_fetch_add(&pr->found, 1);
+    }
+    atomic_fetch_add(&pr->ran, 1);
+}
+
+FOSSIL_TEST(c_reactor_test_post_conn) {
+    static const fossil_net_reactor_callbacks_t cbs = {
+        c_reactor_on_accept_id, c_reactor_on_readable, NULL, c_reactor_on_close, NULL, NULL
+    };
+    c_reactor_state_t st = {0};
+    c_reactor_conn_probe_t pr = {0};
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 2;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cbs, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    char buf[8];
+    uint32_t got = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.accepts, 1));
+    fossil_net_conn_id_t id = atomic_load(&c_reactor_last_id);
+    ASSUME_ITS_TRUE(id != 0);
+
+    /* A live ID reaches the connection on its own loop. */
+    ASSUME_ITS_TRUE(fossil_net_reactor_post_conn(r, id, c_reactor_conn_task, &pr) == 0);
+    ASSUME_ITS_TRUE(c_reactor_wait(&pr.ran, 1));
+    ASSUME_ITS_TRUE(atomic_load(&pr.found) == 1);
+    ASSUME_ITS_TRUE(atomic_load(&pr.count) == 1);
+    ASSUME_ITS_TRUE(fossil_net_socket_receive(&c, buf, sizeof(buf), &got) == 0);
+    ASSUME_ITS_TRUE(got == 4 && memcmp(buf, "ping", 4) == 0);
+
+    /* Once closed, the same ID resolves to nothing. */
+    fossil_net_socket_close(&c);
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.closes, 1));
+    ASSUME_ITS_TRUE(fossil_net_reactor_post_conn(r, id, c_reactor_conn_task, &pr) == 0);
+    ASSUME_ITS_TRUE(c_reactor_wait(&pr.ran, 2));
+    ASSUME_ITS_TRUE(atomic_load(&pr.found) == 1);
+    ASSUME_ITS_TRUE(fossil_net_reactor_post_conn(r, id | (0xffull << 24), c_reactor_conn_task, &pr) != 0);
+
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+#define C_REACTOR_BULK (32u << 20)
+
+static atomic_uint c_reactor_marks_high;
+static atomic_uint c_reactor_marks_low;
+static atomic_uint c_reactor_bulk_queued;
+
+static void c_reactor_on_readable_bulk(fossil_net_conn_t *conn, void *user) {
+    (void)user;
+    char cmd[8];
+    uint32_t n = 0;
+    int rc = fossil_net_conn_receive(conn, cmd, sizeof(cmd), &n);
+    if (rc == 1)
+        return;
+    if (rc != 0 || n == 0) {
+        fossil_net_conn_close(conn);
+        return;
+    }
+    /* Queue far more than the socket holds; the loop flushes the rest. */
+    static uint8_t chunk[65536];
+    for (uint32_t off = 0; off < C_REACTOR_BULK; off += sizeof(chunk)) {
+        for (uint32_t i = 0; i < sizeof(chunk); ++i)
+            chunk[i] = (uint8_t)((off + i) % 251u);
+        if (fossil_net_conn_write(conn, chunk, sizeof(chunk)) != 0) {
+            fossil_net_conn_close(conn);
+            return;
+        }
+    }
+    atomic_store(&c_reactor_bulk_queued, 1);
+}
+
+static void c_reactor_on_watermark(fossil_net_conn_t *conn, bool above, void *user) {
+    (void)conn;
+    (void)user;
+    atomic_fetch_add(above ? &c_reactor_marks_high : &c_reactor_marks_low, 1);
+}
+
+FOSSIL_TEST(c_reactor_test_buffered_write) {
+    static const fossil_net_reactor_callbacks_t cbs = {
+        c_reactor_on_accept, c_reactor_on_readable_bulk, NULL, c_reactor_on_close, c_reactor_on_watermark, NULL
+    };
+    c_reactor_state_t st = {0};
+    atomic_store(&c_reactor_marks_high, 0);
+    atomic_store(&c_reactor_marks_low, 0);
+    atomic_store(&c_reactor_bulk_queued, 0);
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 1;
+    cfg.write_high_watermark = 64u * 1024u;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cbs, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+    uint32_t sent = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&c, "GO", 2, &sent) == 0);
+    /* Read only once everything is queued, so the watermark must trip. */
+    ASSUME_ITS_TRUE(c_reactor_wait(&c_reactor_bulk_queued, 1));
+
+    static uint8_t buf[65536];
+    uint64_t got = 0;
+    int bad = 0;
+    uint32_t n = 0;
+    while (got < C_REACTOR_BULK && fossil_net_socket_receive(&c, buf, sizeof(buf), &n) == 0 && n) {
+        for (uint32_t i = 0; i < n; ++i)
+            if (buf[i] != (uint8_t)((got + i) % 251u)) bad++;
+        got += n;
+    }
+    ASSUME_ITS_TRUE(got == C_REACTOR_BULK);
+    ASSUME_ITS_TRUE(bad == 0);
+    ASSUME_ITS_TRUE(atomic_load(&c_reactor_marks_high) == 1);
+    ASSUME_ITS_TRUE(c_reactor_wait(&c_reactor_marks_low, 1));
+    fossil_net_socket_close(&c);
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.closes, 1));
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+static void c_reactor_on_datagram_echo(fossil_net_loop_t *loop, fossil_net_datagram_t *dgram, void *user) {
+    c_reactor_state_t *st = (c_reactor_state_t *)user;
+    atomic_fetch_or(&st->loops_seen, 1u << fossil_net_loop_index(loop));
+    if (dgram->size + 3 > dgram->reply_capacity)
+        return;
+    memcpy(dgram->reply_buf, "re:", 3);
+    memcpy(dgram->reply_buf + 3, dgram->data, dgram->size);
+    dgram->reply = dgram->reply_buf;
+    dgram->reply_size = dgram->size + 3;
+}
+
+/* Uppercase in place and answer with the received bytes themselves. */
+static void c_reactor_on_datagram_upper(fossil_net_loop_t *loop, fossil_net_datagram_t *dgram, void *user) {
+    (void)loop;
+    (void)user;
+    if (dgram->truncated)
+        return;
+    for (uint32_t i = 0; i < dgram->size; i++)
+        if (dgram->data[i] >= 'a' && dgram->data[i] <= 'z')
+            dgram->data[i] = (uint8_t)(dgram->data[i] - 'a' + 'A');
+    dgram->reply = dgram->data;
+    dgram->reply_size = dgram->size;
+}
+
+/* Wait up to a second for a datagram; returns its length or -1. */
+static int c_reactor_recv_dgram(fossil_net_socket_t *s, char *buf, uint32_t size) {
+    fossil_net_socket_t *set[1] = { s };
+    uint32_t got = 0;
+    if (fossil_net_socket_poll(set, 1, 1000) <= 0 || fossil_net_socket_receive_from(s, buf, size, &got, NULL) != 0)
+        return -1;
+    return (int)got;
+}
+
+/* Replies are counted after sendmmsg returns, which can be after the peer has them. */
+static fossil_net_reactor_stats_t c_reactor_dgram_stats(fossil_net_reactor_t *r, uint64_t replies) {
+    fossil_net_reactor_stats_t stats;
+    for (int i = 0; i < 500; ++i) {
+        fossil_net_reactor_get_stats(r, &stats);
+        if (stats.replies + stats.reply_drops >= replies)
+            break;
+        c_reactor_sleep_ms(10);
+    }
+    return stats;
+}
+
+FOSSIL_TEST(c_reactor_test_datagram_echo) {
+    c_reactor_state_t st = {0};
+    fossil_net_server_t *server = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_callbacks_t cb = {0};
+    cb.on_datagram = c_reactor_on_datagram_echo;
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 2;
+    cfg.recv_batch = 4;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cb, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    enum { CLIENTS = 8, PER = 6 };
+    fossil_net_socket_t c[CLIENTS];
+    int answered = 0;
+    for (int i = 0; i < CLIENTS; i++) {
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c[i], "udp", "ipv4") == 0);
+        for (int j = 0; j < PER; j++) {
+            char msg[32];
+            int len = snprintf(msg, sizeof(msg), "ping %d.%d", i, j);
+            ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c[i], msg, (uint32_t)len, &ep, NULL) == 0);
+        }
+    }
+    for (int i = 0; i < CLIENTS; i++) {
+        for (int j = 0; j < PER; j++) {
+            char back[64];
+            int got = c_reactor_recv_dgram(&c[i], back, sizeof(back));
+            if (got > 3 && memcmp(back, "re:ping ", 8) == 0)
+                answered++;
+        }
+        fossil_net_socket_close(&c[i]);
+    }
+    ASSUME_ITS_TRUE(answered == CLIENTS * PER);
+
+    fossil_net_reactor_stats_t stats = c_reactor_dgram_stats(r, CLIENTS * PER);
+    ASSUME_ITS_TRUE(stats.datagrams == CLIENTS * PER);
+    ASSUME_ITS_TRUE(stats.replies == CLIENTS * PER);
+    ASSUME_ITS_TRUE(stats.reply_drops == 0);
+    ASSUME_ITS_TRUE(stats.recv_calls >= (CLIENTS * PER) / cfg.recv_batch);
+    ASSUME_ITS_TRUE(stats.accepted == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_stop(r) == 0);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_reactor_test_datagram_in_place) {
+    fossil_net_server_t *server = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_callbacks_t cb = {0};
+    cb.on_datagram = c_reactor_on_datagram_upper;
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 1;
+    cfg.max_datagram = 16;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cb, NULL);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    char back[64];
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "udp", "ipv4") == 0);
+    const char *big = "this datagram is longer than sixteen bytes";
+    ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c, big, (uint32_t)strlen(big), &ep, NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c, "abc", 3, &ep, NULL) == 0);
+    ASSUME_ITS_TRUE(c_reactor_recv_dgram(&c, back, sizeof(back)) == 3);
+    ASSUME_ITS_TRUE(memcmp(back, "ABC", 3) == 0);
+    fossil_net_socket_close(&c);
+
+    fossil_net_reactor_stats_t stats = c_reactor_dgram_stats(r, 1);
+    ASSUME_ITS_TRUE(stats.datagrams == 2);
+    ASSUME_ITS_TRUE(stats.truncated == 1);
+    ASSUME_ITS_TRUE(stats.replies == 1);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+static void c_reactor_drain_close(fossil_net_conn_t *conn, void *arg) {
+    atomic_fetch_add((atomic_uint *)arg, 1);
+    fossil_net_conn_close(conn);
+}
+
+FOSSIL_TEST(c_reactor_test_datagram_limited) {
+    c_reactor_state_t st = {0};
+    const char *path = "fossil_reactor_dgram.pcapng";
+    fossil_net_server_t *server = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    /* Room for three 7-byte replies, shared by both loops; the tap sees every datagram. */
+    fossil_net_ratelimit_t *rl = fossil_net_ratelimit_create(1, 21);
+    fossil_net_tap_t *tap = fossil_net_tap_create(path, NULL);
+    ASSUME_ITS_TRUE(rl != NULL && tap != NULL);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_ratelimit(fossil_net_server_socket(server), rl) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_tap(fossil_net_server_socket(server), tap) == 0);
+    fossil_net_reactor_callbacks_t cb = {0};
+    cb.on_datagram = c_reactor_on_datagram_echo;
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 2;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cb, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    enum { PEERS = 6 };
+    fossil_net_socket_t c[PEERS];
+    for (int i = 0; i < PEERS; i++) {
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c[i], "udp", "ipv4") == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c[i], "ping", 4, &ep, NULL) == 0);
+    }
+    fossil_net_reactor_stats_t stats = c_reactor_dgram_stats(r, PEERS);
+    ASSUME_ITS_TRUE(stats.datagrams == PEERS && stats.bytes_in == PEERS * 4);
+    ASSUME_ITS_TRUE(stats.replies == 3 && stats.reply_drops == 3);
+    int answered = 0;
+    for (int i = 0; i < PEERS; i++) {
+        char back[16];
+        fossil_net_socket_t *set[1] = { &c[i] };
+        uint32_t got = 0;
+        if (fossil_net_socket_poll(set, 1, 0) > 0 &&
+            fossil_net_socket_receive_from(&c[i], back, sizeof(back), &got, NULL) == 0 && got == 7)
+            answered++;
+        fossil_net_socket_close(&c[i]);
+    }
+    ASSUME_ITS_TRUE(answered == 3);
+    fossil_net_tap_stats_t ts;
+    ASSUME_ITS_TRUE(fossil_net_tap_get_stats(tap, &ts) == 0);
+    ASSUME_ITS_TRUE(ts.records == PEERS + 3);
+
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+    fossil_net_tap_destroy(tap);
+    fossil_net_ratelimit_destroy(rl);
+    remove(path);
+}
+
+FOSSIL_TEST(c_reactor_test_drain) {
+    c_reactor_state_t st = {0};
+    atomic_uint drained = 0;
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 2;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_wait_drained(r, 0) == -1);
+
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c[3], late;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    for (int i = 0; i < 3; i++) {
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c[i], "tcp", "ipv4") == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c[i], &ep) == 0);
+    }
+    ASSUME_ITS_TRUE(c_reactor_wait(&st.accepts, 3));
+
+    ASSUME_ITS_TRUE(fossil_net_reactor_drain(r, c_reactor_drain_close, &drained) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_wait_drained(r, 2000000000ull) == 0);
+    ASSUME_ITS_TRUE(atomic_load(&drained) == 3);
+    for (int i = 0; i < 3; i++) {
+        char buf[8];
+        uint32_t got = 1;
+        ASSUME_ITS_TRUE(fossil_net_socket_receive(&c[i], buf, sizeof(buf), &got) == 0 && got == 0);
+        fossil_net_socket_close(&c[i]);
+    }
+
+    /* The listener stays open: a late client waits in the backlog, unaccepted. */
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&late, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&late, &ep) == 0);
+    c_reactor_sleep_ms(50);
+    fossil_net_reactor_stats_t stats;
+    ASSUME_ITS_TRUE(fossil_net_reactor_get_stats(r, &stats) == 0);
+    ASSUME_ITS_TRUE(stats.accepted == 3);
+    fossil_net_socket_close(&late);
+    ASSUME_ITS_TRUE(fossil_net_reactor_stop(r) == 0);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+static void c_reactor_count_task(fossil_net_loop_t *loop, void *arg) {
+    (void)loop;
+    atomic_fetch_add((atomic_uint *)arg, 1);
+}
+
+/* Run a task on every loop and wait for all of them: earlier posts have run. */
+static bool c_reactor_settle(fossil_net_reactor_t *r) {
+    atomic_uint ran = 0;
+    uint32_t loops = fossil_net_reactor_loop_count(r);
+    for (uint32_t i = 0; i < loops; i++)
+        if (fossil_net_loop_post(fossil_net_reactor_loop(r, i), c_reactor_count_task, &ran) != 0)
+            return false;
+    return c_reactor_wait(&ran, loops);
+}
+
+FOSSIL_TEST(c_reactor_test_drain_reuseport) {
+    c_reactor_state_t st = {0};
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 3;
+    cfg.reuseport = 1;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_drain(r, NULL, NULL) == 0);
+    ASSUME_ITS_TRUE(c_reactor_settle(r));
+
+    /* Only the server's socket is left in the group: every new peer waits there for a successor. */
+    fossil_net_socket_t *lst = fossil_net_server_socket(server);
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(lst, &ep) == 0);
+    enum { PEERS = 12 };
+    fossil_net_socket_t c[PEERS];
+    for (int i = 0; i < PEERS; i++) {
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c[i], "tcp", "ipv4") == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c[i], &ep) == 0);
+    }
+    int taken = 0;
+    for (int round = 0; round < 100 && taken < PEERS; round++) {
+        fossil_net_socket_t *set[1] = { lst };
+        fossil_net_socket_t a;
+        if (fossil_net_socket_poll(set, 1, 20) > 0 && fossil_net_socket_accept(lst, &a, NULL) == 0) {
+            fossil_net_socket_close(&a);
+            taken++;
+        }
+    }
+    ASSUME_ITS_TRUE(taken == PEERS);
+    for (int i = 0; i < PEERS; i++)
+        fossil_net_socket_close(&c[i]);
+    ASSUME_ITS_TRUE(atomic_load(&st.accepts) == 0);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+
+    /* Datagram reactors always use reuseport; draining hands the port to the server's socket alone. */
+    server = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_callbacks_t cb = {0};
+    cb.on_datagram = c_reactor_on_datagram_echo;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.threads = 3;
+    r = fossil_net_reactor_create(server, &cfg, &cb, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_drain(r, NULL, NULL) == 0);
+    ASSUME_ITS_TRUE(c_reactor_settle(r));
+    lst = fossil_net_server_socket(server);
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(lst, &ep) == 0);
+    int arrived = 0;
+    for (int i = 0; i < PEERS; i++) {
+        char buf[16];
+        ASSUME_ITS_TRUE(fossil_net_socket_create(&c[i], "udp", "ipv4") == 0);
+        ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c[i], "late", 4, &ep, NULL) == 0);
+        if (c_reactor_recv_dgram(lst, buf, sizeof(buf)) == 4)
+            arrived++;
+        fossil_net_socket_close(&c[i]);
+    }
+    ASSUME_ITS_TRUE(arrived == PEERS);
+    fossil_net_reactor_stats_t stats;
+    fossil_net_reactor_get_stats(r, &stats);
+    ASSUME_ITS_TRUE(stats.datagrams == 0);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+/* Peers that open more peers of their own while the reactor drains. */
+#define C_REACTOR_LOAD_MAX 512
+
+typedef struct c_reactor_load {
+    fossil_net_endpoint_t ep;
+    const char *type;
+    atomic_bool on;
+    atomic_uint made;
+    atomic_uint served;
+    fossil_net_socket_t peers[C_REACTOR_LOAD_MAX];
+} c_reactor_load_t;
+
+static void c_reactor_load_more(c_reactor_load_t *l) {
+    for (int i = 0; i < 4; i++) {
+        unsigned at = atomic_fetch_add(&l->made, 1);
+        if (at >= C_REACTOR_LOAD_MAX)
+            return;
+        fossil_net_socket_t *p = &l->peers[at];
+        if (fossil_net_socket_create(p, l->type, "ipv4") != 0) {
+            p->fd = -1;
+            continue;
+        }
+        fossil_net_socket_set_blocking(p, false);
+        if (strcmp(l->type, "udp") == 0)
+            fossil_net_socket_send_to(p, "more", 4, &l->ep, NULL);
+        else
+            fossil_net_socket_connect_endpoint(p, &l->ep);
+    }
+}
+
+static int c_reactor_load_accept(fossil_net_conn_t *conn, void *user) {
+    (void)conn;
+    c_reactor_load_t *l = (c_reactor_load_t *)user;
+    atomic_fetch_add(&l->served, 1);
+    if (atomic_load(&l->on))
+        c_reactor_load_more(l);
+    return 0;
+}
+
+static void c_reactor_load_datagram(fossil_net_loop_t *loop, fossil_net_datagram_t *dgram, void *user) {
+    (void)loop;
+    (void)dgram;
+    c_reactor_load_accept(NULL, user);
+}
+
+FOSSIL_TEST(c_reactor_test_drain_under_load) {
+    static c_reactor_load_t load;
+    for (int mode = 0; mode < 2; ++mode) {
+        memset(&load, 0, sizeof(load));
+        load.type = mode ? "udp" : "tcp";
+        fossil_net_server_t *server = fossil_net_server_create(load.type, "ipv4", "127.0.0.1", 0);
+        ASSUME_ITS_TRUE(server != NULL);
+        fossil_net_reactor_callbacks_t cb = {0};
+        cb.on_accept = c_reactor_load_accept;
+        cb.on_readable = c_reactor_on_readable;
+        cb.on_datagram = c_reactor_load_datagram;
+        fossil_net_reactor_config_t cfg = {0};
+        cfg.threads = 3;
+        cfg.reuseport = 1;
+        cfg.backlog = 64;
+        fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cb, &load);
+        ASSUME_ITS_TRUE(r != NULL);
+        ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &load.ep) == 0);
+        ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+
+        /* Each peer the draining loops serve brings four more: their queues never empty by themselves. */
+        atomic_uint drained = 0;
+        atomic_store(&load.on, true);
+        ASSUME_ITS_TRUE(fossil_net_reactor_drain(r, c_reactor_drain_close, &drained) == 0);
+        c_reactor_load_more(&load);
+        ASSUME_ITS_TRUE(c_reactor_settle(r));
+        atomic_store(&load.on, false);
+        ASSUME_ITS_TRUE(fossil_net_reactor_wait_drained(r, 5000000000ull) == 0);
+        if (!mode)
+            ASSUME_ITS_TRUE(atomic_load(&drained) == atomic_load(&load.served));
+
+        fossil_net_reactor_destroy(r);
+        fossil_net_server_destroy(server);
+        unsigned made = atomic_load(&load.made);
+        for (unsigned i = 0; i < made && i < C_REACTOR_LOAD_MAX; i++)
+            fossil_net_socket_close(&load.peers[i]);
+    }
+}
+
+/* Wait until every loop runs bound to a CPU. */
+static bool c_reactor_wait_pinned(fossil_net_reactor_t *r) {
+    uint32_t loops = fossil_net_reactor_loop_count(r);
+    for (int i = 0; i < 500; ++i) {
+        uint32_t pinned = 0;
+        for (uint32_t l = 0; l < loops; ++l)
+            pinned += fossil_net_loop_cpu(fossil_net_reactor_loop(r, l)) >= 0;
+        if (pinned == loops)
+            return true;
+        c_reactor_sleep_ms(10);
+    }
+    return false;
+}
+
+FOSSIL_TEST(c_reactor_test_pinned_loops) {
+    /* Handoff, reuseport, and reuseport on a socket that already had it, as an inherited one does. */
+    for (int mode = 0; mode < 3; ++mode) {
+        c_reactor_state_t st = {0};
+        fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+        ASSUME_ITS_TRUE(server != NULL);
+        if (mode == 2)
+            fossil_net_socket_set_reuseport(fossil_net_server_socket(server), true);
+        fossil_net_reactor_config_t cfg = {0};
+        cfg.threads = 3;
+        cfg.reuseport = mode != 0;
+        cfg.pin_cpus = 1;
+        fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, &st);
+        ASSUME_ITS_TRUE(r != NULL);
+        ASSUME_ITS_TRUE(fossil_net_loop_cpu(fossil_net_reactor_loop(r, 0)) == -1);
+        ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+#if defined(__linux__)
+        ASSUME_ITS_TRUE(c_reactor_wait_pinned(r));
+#endif
+        /* Steered by receiving CPU or not, every connection is served once. */
+        ASSUME_ITS_TRUE(c_reactor_echo_round(server, 24) == 24);
+        ASSUME_ITS_TRUE(c_reactor_wait(&st.closes, 24));
+        fossil_net_reactor_stats_t s;
+        fossil_net_reactor_get_stats(r, &s);
+        ASSUME_ITS_TRUE(s.accepted == 24 && s.active == 0);
+        ASSUME_ITS_TRUE(fossil_net_reactor_stop(r) == 0);
+        ASSUME_ITS_TRUE(fossil_net_loop_cpu(fossil_net_reactor_loop(r, 0)) == -1);
+        fossil_net_reactor_destroy(r);
+        fossil_net_server_destroy(server);
+    }
+
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_config_t cfg = {0};
+    const int32_t cpus[2] = { 0, -1 };
+    cfg.threads = 2;
+    cfg.pin_cpus = 1;
+    cfg.cpus = cpus;
+    cfg.cpu_count = 2;
+    ASSUME_ITS_TRUE(fossil_net_reactor_create(server, &cfg, &c_reactor_callbacks, NULL) == NULL);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_reactor_test_pinned_datagram) {
+    c_reactor_state_t st = {0};
+    fossil_net_server_t *server = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_reactor_callbacks_t cb = {0};
+    cb.on_datagram = c_reactor_on_datagram_echo;
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 2;
+    cfg.pin_cpus = 1;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cb, &st);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(c_reactor_wait_pinned(r));
+#endif
+    /* The receive batches were allocated again on the pinned threads. */
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_t c;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "udp", "ipv4") == 0);
+    int answered = 0;
+    for (int i = 0; i < 8; i++) {
+        char back[64];
+        ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c, "ping", 4, &ep, NULL) == 0);
+        if (c_reactor_recv_dgram(&c, back, sizeof(back)) == 7 && memcmp(back, "re:ping", 7) == 0)
+            answered++;
+    }
+    fossil_net_socket_close(&c);
+    ASSUME_ITS_TRUE(answered == 8);
+    fossil_net_reactor_stats_t stats = c_reactor_dgram_stats(r, 8);
+    ASSUME_ITS_TRUE(stats.bytes_in == 8 * 4 && stats.bytes_out == 8 * 7);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+}
+
+FOSSIL_TEST(c_reactor_test_invalid) {
+    c_reactor_state_t st = {0};
+    ASSUME_ITS_TRUE(fossil_net_reactor_create(NULL, NULL, &c_reactor_callbacks, &st) == NULL);
+    fossil_net_server_t *udp = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(udp != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_create(udp, NULL, &c_reactor_callbacks, &st) == NULL);
+    fossil_net_server_destroy(udp);
+    ASSUME_ITS_TRUE(fossil_net_loop_post(NULL, c_reactor_task, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_conn_want_write(NULL, true) != 0);
+    ASSUME_ITS_TRUE(fossil_net_conn_write(NULL, "x", 1) != 0);
+    ASSUME_ITS_TRUE(fossil_net_conn_pending(NULL) == 0);
+    fossil_net_reactor_destroy(NULL);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_reactor_tests) {
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_echo_handoff);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_echo_reuseport);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_reject_and_stop);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_post);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_post_conn);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_buffered_write);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_datagram_echo);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_datagram_in_place);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_datagram_limited);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_drain);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_drain_reuseport);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_drain_under_load);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_pinned_loops);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_pinned_datagram);
+    FOSSIL_ADD_TEST(c_reactor_fixture, c_reactor_test_invalid);
+
+    FOSSIL_ADD_SUITE(c_reactor_fixture);
+} // end of tests
@@ -0,0 +1,225 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_reactor_fixture);
+
+FOSSIL_SETUP(cpp_reactor_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_reactor_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace {
+
+struct CppReactorCounters {
+    std::atomic<unsigned> writable{0};
+    std::atomic<unsigned> closes{0};
+};
+
+// Reply with a fixed greeting once the socket reports writable, then close.
+void cpp_reactor_on_writable(fossil_net_conn_t *conn, void *user) {
+    static const char greeting[] = "welcome";
+    uint32_t sent = 0;
+    fossil_net_conn_send(conn, greeting, sizeof(greeting) - 1, &sent);
+    static_cast<CppReactorCounters *>(user)->writable++;
+    fossil_net_conn_want_write(conn, false);
+}
+
+int cpp_reactor_on_accept(fossil_net_conn_t *conn, void *) {
+    return fossil_net_conn_want_write(conn, true);
+}
+
+void cpp_reactor_on_readable(fossil_net_conn_t *conn, void *) {
+    char buf[64];
+    uint32_t n = 0;
+    int rc = fossil_net_conn_receive(conn, buf, sizeof(buf), &n);
+    if (rc == -1 || (rc == 0 && n == 0))
+        fossil_net_conn_close(conn);
+}
+
+void cpp_reactor_on_close(fossil_net_conn_t *, void *user) {
+    static_cast<CppReactorCounters *>(user)->closes++;
+}
+
+} // namespace
+
+FOSSIL_TEST(cpp_reactor_test_class_writable) {
+    fossil::net::Server server("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server.is_valid());
+    CppReactorCounters counters;
+    fossil_net_reactor_callbacks_t cb{cpp_reactor_on_accept, cpp_reactor_on_readable,
+                                      cpp_reactor_on_writable, cpp_reactor_on_close, nullptr, nullptr};
+    fossil_net_reactor_config_t cfg{};
+    cfg.threads = 2;
+    fossil::net::Reactor reactor(server.native_handle(), cb, &counters, &cfg);
+    ASSUME_ITS_TRUE(reactor.native_handle() != nullptr);
+    ASSUME_ITS_TRUE(reactor.loop_count() == 2);
+    ASSUME_ITS_TRUE(reactor.start() == 0);
+
+    fossil_net_endpoint_t ep{};
+    fossil_net_socket_get_local_endpoint(server.socket(), &ep);
+    std::vector<std::thread> clients;
+    std::atomic<int> greeted{0};
+    for (int t = 0; t < 8; ++t)
+        clients.emplace_back([&] {
+            fossil_net_socket_t c;
+            if (fossil_net_socket_create(&c, "tcp", "ipv4") != 0)
+                return;
+            char buf[16] = {};
+            uint32_t got = 0;
+            if (fossil_net_socket_connect_endpoint(&c, &ep) == 0 &&
+                fossil_net_socket_receive(&c, buf, sizeof(buf), &got) == 0 &&
+                std::string(buf, got) == "welcome")
+                greeted++;
+            fossil_net_socket_close(&c);
+        });
+    for (auto &c : clients) c.join();
+    ASSUME_ITS_TRUE(greeted == 8);
+    for (int i = 0; i < 500 && counters.closes < 8; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSUME_ITS_TRUE(counters.closes == 8);
+    ASSUME_ITS_TRUE(counters.writable == 8);
+
+    fossil_net_reactor_stats_t s = reactor.stats();
+    ASSUME_ITS_TRUE(s.accepted == 8);
+    ASSUME_ITS_TRUE(s.active == 0);
+    ASSUME_ITS_TRUE(reactor.stop() == 0);
+}
+
+FOSSIL_TEST(cpp_reactor_test_class_post) {
+    fossil::net::Server server("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_callbacks_t cb{};
+    fossil::net::Reactor reactor(server.native_handle(), cb);
+    ASSUME_ITS_TRUE(reactor.start() == 0);
+    static std::atomic<int> ran;
+    ran = 0;
+    for (uint32_t i = 0; i < reactor.loop_count(); ++i)
+        ASSUME_ITS_TRUE(reactor.post(i, [](fossil_net_loop_t *, void *) { ran++; }, nullptr) == 0);
+    for (int i = 0; i < 500 && ran < (int)reactor.loop_count(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSUME_ITS_TRUE(ran == (int)reactor.loop_count());
+
+    fossil::net::Reactor moved(std::move(reactor));
+    ASSUME_ITS_TRUE(reactor.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.stop() == 0);
+}
+
+FOSSIL_TEST(cpp_reactor_test_class_datagram) {
+    fossil::net::Server server("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(server.is_valid());
+    fossil_net_reactor_callbacks_t cb{};
+    cb.on_datagram = [](fossil_net_loop_t *, fossil_net_datagram_t *dgram, void *) {
+        static const char pong[] = "pong";
+        dgram->reply = pong;
+        dgram->reply_size = sizeof(pong) - 1;
+    };
+    fossil_net_reactor_config_t cfg{};
+    cfg.threads = 2;
+    fossil::net::Reactor reactor(server.native_handle(), cb, nullptr, &cfg);
+    ASSUME_ITS_TRUE(reactor.native_handle() != nullptr);
+    ASSUME_ITS_TRUE(reactor.start() == 0);
+
+    fossil_net_endpoint_t ep{};
+    fossil_net_socket_get_local_endpoint(server.socket(), &ep);
+    fossil_net_socket_t c;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_send_to(&c, "ping", 4, &ep, nullptr) == 0);
+    fossil_net_socket_t *set[1] = {&c};
+    char buf[16] = {};
+    uint32_t got = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_poll(set, 1, 1000) == 1);
+    ASSUME_ITS_TRUE(fossil_net_socket_receive_from(&c, buf, sizeof(buf), &got, nullptr) == 0);
+    ASSUME_ITS_TRUE(std::string(buf, got) == "pong");
+    fossil_net_socket_close(&c);
+
+    fossil_net_reactor_stats_t s = reactor.stats();
+    for (int i = 0; i < 500 && s.replies == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        s = reactor.stats();
+    }
+    ASSUME_ITS_TRUE(s.datagrams == 1);
+    ASSUME_ITS_TRUE(s.replies == 1);
+    ASSUME_ITS_TRUE(reactor.stop() == 0);
+}
+
+FOSSIL_TEST(cpp_reactor_test_class_pinned) {
+    fossil::net::Server server("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_callbacks_t cb{};
+    fossil_net_reactor_config_t cfg{};
+    cfg.threads = 2;
+    cfg.pin_cpus = 1;
+    fossil::net::Reactor reactor(server.native_handle(), cb, nullptr, &cfg);
+    ASSUME_ITS_TRUE(reactor.native_handle() != nullptr);
+    ASSUME_ITS_TRUE(reactor.start() == 0);
+    static std::atomic<int> pinned;
+    pinned = 0;
+    for (uint32_t i = 0; i < reactor.loop_count(); ++i)
+        ASSUME_ITS_TRUE(reactor.post(i, [](fossil_net_loop_t *loop, void *) {
+            if (fossil_net_loop_cpu(loop) >= 0)
+                pinned++;
+        }, nullptr) == 0);
+    for (int i = 0; i < 500 && pinned < (int)reactor.loop_count(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(pinned == (int)reactor.loop_count());
+#endif
+    ASSUME_ITS_TRUE(reactor.stop() == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_reactor_tests) {
+    FOSSIL_ADD_TEST(cpp_reactor_fixture, cpp_reactor_test_class_writable);
+    FOSSIL_ADD_TEST(cpp_reactor_fixture, cpp_reactor_test_class_post);
+    FOSSIL_ADD_TEST(cpp_reactor_fixture, cpp_reactor_test_class_datagram);
+    FOSSIL_ADD_TEST(cpp_reactor_fixture, cpp_reactor_test_class_pinned);
+
+    FOSSIL_ADD_SUITE(cpp_reactor_fixture);
+} // end of tests
@@ -186,6 +186,56 @@ FOSSIL_TEST(c_request_test_response_free) {
     ASSUME_ITS_TRUE(res.header_count == 0);
 }
 
+/* Connected pair over loopback; the test plays the server on *srv. */
+static int c_request_pair(fossil_net_socket_t *cli, fossil_net_socket_t *srv) {
+    fossil_net_socket_t lst;
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_create(&lst, "tcp", "ipv4") != 0) return -1;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    int rc = fossil_net_socket_bind_endpoint(&lst, &ep) == 0 &&
+             fossil_net_socket_listen(&lst, 1) == 0 &&
+             fossil_net_socket_get_local_endpoint(&lst, &ep) == 0 &&
+             fossil_net_socket_create(cli, "tcp", "ipv4") == 0 &&
+             fossil_net_socket_connect_endpoint(cli, &ep) == 0 &&
+             fossil_net_socket_accept(&lst, srv, NULL) == 0 ? 0 : -1;
+    fossil_net_socket_close(&lst);
+    return rc;
+}
+
+FOSSIL_TEST(c_request_test_send_chunked_keepalive) {
+    fossil_net_socket_t cli, srv;
+    ASSUME_ITS_TRUE(c_request_pair(&cli, &srv) == 0);
+
+    /* The server never closes: each response must end by its own framing. */
+    static const char chunked[] =
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "5\r\nhello\r\n7;ext=1\r\n, world\r\n0\r\nTrailer: x\r\n\r\n";
+    uint32_t sent = 0;
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&srv, chunked, sizeof(chunked) - 1, &sent) == 0);
+    fossil_net_request_t req;
+    fossil_net_response_t res;
+    fossil_net_request_init(&req, "get", "/a");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&cli, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.status == 200);
+    ASSUME_ITS_TRUE(res.body_size == 12 && memcmp(res.body, "hello, world", 12) == 0);
+    fossil_net_response_free(&res);
+
+    static const char sized[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&srv, sized, sizeof(sized) - 1, &sent) == 0);
+    fossil_net_request_init(&req, "get", "/b");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&cli, &req, &res) == 0);
+    ASSUME_ITS_TRUE(res.body_size == 2 && memcmp(res.body, "ok", 2) == 0);
+    fossil_net_response_free(&res);
+
+    /* Closing in the middle of a chunked body is an error. */
+    static const char cut[] = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhel";
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&srv, cut, sizeof(cut) - 1, &sent) == 0);
+    fossil_net_socket_close(&srv);
+    fossil_net_request_init(&req, "get", "/c");
+    ASSUME_ITS_TRUE(fossil_net_request_send(&cli, &req, &res) != 0);
+    fossil_net_socket_close(&cli);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -204,6 +254,7 @@ FOSSIL_TEST_GROUP(c_request_tests) {
     FOSSIL_ADD_TEST(c_request_fixture, c_request_test_response_get_header_not_found);
     FOSSIL_ADD_TEST(c_request_fixture, c_request_test_request_free);
     FOSSIL_ADD_TEST(c_request_fixture, c_request_test_response_free);
+    FOSSIL_ADD_TEST(c_request_fixture, c_request_test_send_chunked_keepalive);
 
     FOSSIL_ADD_SUITE(c_request_fixture);
 } // end of tests
@@ -0,0 +1,169 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_router_fixture);
+
+FOSSIL_SETUP(c_router_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_router_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static int c_router_h_users, c_router_h_user, c_router_h_me, c_router_h_files, c_router_h_post, c_router_h_tree;
+
+static int c_router_find(fossil_net_router_t *r, fossil_net_http_method_t m, const char *path, fossil_net_route_match_t *match) {
+    return fossil_net_router_match(r, m, path, (uint32_t)strlen(path), match);
+}
+
+FOSSIL_TEST(c_router_test_static_and_params) {
+    fossil_net_router_t *r = fossil_net_router_create();
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/users", &c_router_h_users) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/users/:id", &c_router_h_user) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/users/me", &c_router_h_me) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/users/:id/posts/:post", &c_router_h_post) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_count(r) == 4);
+
+    fossil_net_route_match_t m;
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/users", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_users && m.param_count == 0);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/users/me", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_me);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/users/mel", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_user);
+
+    fossil_net_slice_t v;
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/users/42/posts/7", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_post);
+    ASSUME_ITS_TRUE(strcmp(m.pattern, "/users/:id/posts/:post") == 0);
+    ASSUME_ITS_TRUE(fossil_net_route_param(&m, "id", &v) && fossil_net_slice_eq(v, "42"));
+    ASSUME_ITS_TRUE(fossil_net_route_param(&m, "post", &v) && fossil_net_slice_eq(v, "7"));
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/users/42/posts", &m) == FOSSIL_NET_ROUTER_NOT_FOUND);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/nope", &m) == FOSSIL_NET_ROUTER_NOT_FOUND);
+    fossil_net_router_destroy(r);
+}
+
+FOSSIL_TEST(c_router_test_backtracking_and_wildcard) {
+    fossil_net_router_t *r = fossil_net_router_create();
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/files/static/index", &c_router_h_me) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/files/:dir/list", &c_router_h_user) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/files/*path", &c_router_h_files) == 0);
+
+    fossil_net_route_match_t m;
+    fossil_net_slice_t v;
+    /* static branch dead-ends, the parameter branch matches */
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/files/static/list", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_user);
+    ASSUME_ITS_TRUE(fossil_net_route_param(&m, "dir", &v) && fossil_net_slice_eq(v, "static"));
+    /* both dead-end, the wildcard takes the rest */
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/files/static/a/b.txt", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_files);
+    ASSUME_ITS_TRUE(m.param_count == 1);
+    ASSUME_ITS_TRUE(fossil_net_route_param(&m, "path", &v) && fossil_net_slice_eq(v, "static/a/b.txt"));
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/files/", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_files);
+    ASSUME_ITS_TRUE(fossil_net_route_param(&m, "path", &v) && v.len == 0);
+    fossil_net_router_destroy(r);
+}
+
+FOSSIL_TEST(c_router_test_methods) {
+    fossil_net_router_t *r = fossil_net_router_create();
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/tree", &c_router_h_tree) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_POST, "/tree", &c_router_h_post) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/tree", &c_router_h_user) == -1);
+
+    fossil_net_route_match_t m;
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_HEAD, "/tree", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_tree);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_POST, "/tree", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &c_router_h_post);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_DELETE, "/tree", &m) == FOSSIL_NET_ROUTER_NOT_ALLOWED);
+    ASSUME_ITS_TRUE(m.allowed & (1u << FOSSIL_NET_HTTP_GET));
+    ASSUME_ITS_TRUE(m.allowed & (1u << FOSSIL_NET_HTTP_HEAD));
+    ASSUME_ITS_TRUE(m.allowed & (1u << FOSSIL_NET_HTTP_POST));
+    ASSUME_ITS_TRUE(!(m.allowed & (1u << FOSSIL_NET_HTTP_DELETE)));
+    fossil_net_router_destroy(r);
+}
+
+FOSSIL_TEST(c_router_test_invalid_patterns) {
+    fossil_net_router_t *r = fossil_net_router_create();
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "nope", &c_router_h_me) == -1);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/a/*rest/more", &c_router_h_me) == -1);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/a/:/b", &c_router_h_me) == -1);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, "/a/:id", &c_router_h_me) == 0);
+    ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_PUT, "/a/:name", &c_router_h_me) == -1);
+    ASSUME_ITS_TRUE(fossil_net_router_count(r) == 1);
+    fossil_net_router_destroy(r);
+}
+
+FOSSIL_TEST(c_router_test_prefix_split) {
+    static const char *paths[] = { "/search", "/support", "/supplies", "/s", "/", "/sup/:id" };
+    fossil_net_router_t *r = fossil_net_router_create();
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+        ASSUME_ITS_TRUE(fossil_net_router_add(r, FOSSIL_NET_HTTP_GET, paths[i], (void *)paths[i]) == 0);
+    fossil_net_route_match_t m;
+    for (size_t i = 0; i < 5; i++) {
+        ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, paths[i], &m) == 0);
+        ASSUME_ITS_TRUE(m.handler == paths[i]);
+    }
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/sup/9", &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == paths[5]);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/sup", &m) == FOSSIL_NET_ROUTER_NOT_FOUND);
+    ASSUME_ITS_TRUE(c_router_find(r, FOSSIL_NET_HTTP_GET, "/supports", &m) == FOSSIL_NET_ROUTER_NOT_FOUND);
+    fossil_net_router_destroy(r);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_router_tests) {
+    FOSSIL_ADD_TEST(c_router_fixture, c_router_test_static_and_params);
+    FOSSIL_ADD_TEST(c_router_fixture, c_router_test_backtracking_and_wildcard);
+    FOSSIL_ADD_TEST(c_router_fixture, c_router_test_methods);
+    FOSSIL_ADD_TEST(c_router_fixture, c_router_test_invalid_patterns);
+    FOSSIL_ADD_TEST(c_router_fixture, c_router_test_prefix_split);
+
+    FOSSIL_ADD_SUITE(c_router_fixture);
+} // end of tests
@@ -0,0 +1,110 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string>
+#include <utility>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_router_fixture);
+
+FOSSIL_SETUP(cpp_router_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_router_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::net::Parser;
+using fossil::net::Router;
+
+static int cpp_router_h_item, cpp_router_h_any;
+
+FOSSIL_TEST(cpp_router_test_add_and_match) {
+    Router router;
+    ASSUME_ITS_TRUE(router.add(FOSSIL_NET_HTTP_GET, "/items/:id", &cpp_router_h_item));
+    ASSUME_ITS_TRUE(router.add(FOSSIL_NET_HTTP_GET, "/*rest", &cpp_router_h_any));
+    ASSUME_ITS_TRUE(router.count() == 2);
+
+    // Parameters point into the path, so it must outlive the match
+    const std::string item = "/items/9";
+    const std::string other = "/other/x";
+    fossil_net_route_match_t m;
+    ASSUME_ITS_TRUE(router.match(FOSSIL_NET_HTTP_GET, item, &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &cpp_router_h_item);
+    ASSUME_ITS_TRUE(router.match(FOSSIL_NET_HTTP_GET, other, &m) == 0);
+    ASSUME_ITS_TRUE(m.handler == &cpp_router_h_any);
+    fossil_net_slice_t v;
+    ASSUME_ITS_TRUE(fossil_net_route_param(&m, "rest", &v));
+    ASSUME_ITS_TRUE(Parser::str(v) == "other/x");
+}
+
+FOSSIL_TEST(cpp_router_test_match_request) {
+    Router router;
+    ASSUME_ITS_TRUE(router.add(FOSSIL_NET_HTTP_POST, "/items", &cpp_router_h_item));
+    Parser parser;
+    fossil_net_http_request_t req;
+    std::string raw = "GET /items?x=1 HTTP/1.1\r\nHost: h\r\n\r\n";
+    ASSUME_ITS_TRUE(parser.parse(raw.data(), static_cast<uint32_t>(raw.size()), &req) > 0);
+    fossil_net_route_match_t m;
+    ASSUME_ITS_TRUE(router.match(req, &m) == FOSSIL_NET_ROUTER_NOT_ALLOWED);
+    ASSUME_ITS_TRUE(m.allowed == (1u << FOSSIL_NET_HTTP_POST));
+}
+
+FOSSIL_TEST(cpp_router_test_move) {
+    Router a;
+    ASSUME_ITS_TRUE(a.add(FOSSIL_NET_HTTP_GET, "/", &cpp_router_h_item));
+    Router b(std::move(a));
+    ASSUME_ITS_TRUE(a.native_handle() == nullptr);
+    const std::string root = "/";
+    fossil_net_route_match_t m;
+    ASSUME_ITS_TRUE(b.match(FOSSIL_NET_HTTP_GET, root, &m) == 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_router_tests) {
+    FOSSIL_ADD_TEST(cpp_router_fixture, cpp_router_test_add_and_match);
+    FOSSIL_ADD_TEST(cpp_router_fixture, cpp_router_test_match_request);
+    FOSSIL_ADD_TEST(cpp_router_fixture, cpp_router_test_move);
+
+    FOSSIL_ADD_SUITE(cpp_router_fixture);
+} // end of tests
@@ -24,6 +24,11 @@
  */
 #include "fossil/network/framework.h"
 #include <fossil/maip/framework.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -97,6 +102,69 @@ FOSSIL_TEST(c_server_test_server_accept_fail) {
     fossil_net_server_destroy(server);
 }
 
+FOSSIL_TEST(c_server_test_server_adopt) {
+    fossil_net_server_t *orig = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(orig != NULL);
+    ASSUME_ITS_TRUE(fossil_net_server_listen(orig, 8) == 0);
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(orig), &ep) == 0);
+    /* Take the descriptor over as if it had been inherited across exec. */
+    int32_t fd = fossil_net_server_socket(orig)->fd;
+    fossil_net_server_socket(orig)->fd = -1;
+    fossil_net_server_destroy(orig);
+
+    fossil_net_server_t *server = fossil_net_server_adopt(fd);
+    ASSUME_ITS_TRUE(server != NULL);
+    fossil_net_socket_t *sock = fossil_net_server_socket(server);
+    ASSUME_ITS_TRUE(sock->type == FOSSIL_NET_SOCKET_TYPE_TCP);
+    ASSUME_ITS_TRUE((sock->flags & FOSSIL_NET_SOCKET_FLAG_LISTENING) != 0);
+    fossil_net_address_t addr;
+    ASSUME_ITS_TRUE(fossil_net_server_get_address(server, &addr) == 0);
+    ASSUME_ITS_TRUE(addr.port == ep.port);
+    ASSUME_ITS_TRUE(strcmp(addr.ip, "127.0.0.1") == 0);
+
+    fossil_net_socket_t c, a;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+    ASSUME_ITS_TRUE(fossil_net_server_accept(server, &a, NULL) == 0);
+    fossil_net_socket_close(&a);
+    fossil_net_socket_close(&c);
+    fossil_net_server_destroy(server);
+    ASSUME_ITS_TRUE(fossil_net_server_adopt(-1) == NULL);
+}
+
+FOSSIL_TEST(c_server_test_server_listen_fds) {
+#if !defined(_WIN32)
+    fossil_net_server_t *orig = fossil_net_server_create("udp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(orig != NULL);
+    fossil_net_endpoint_t ep;
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(fossil_net_server_socket(orig), &ep) == 0);
+    /* Socket activation passes listeners from descriptor 3 up. */
+    int saved = dup(3);
+    ASSUME_ITS_TRUE(dup2(fossil_net_server_socket(orig)->fd, 3) == 3);
+    char pid[32];
+    snprintf(pid, sizeof(pid), "%ld", (long)getpid());
+    setenv("LISTEN_PID", pid, 1);
+    setenv("LISTEN_FDS", "1", 1);
+
+    fossil_net_server_t *got[2] = { NULL, NULL };
+    ASSUME_ITS_TRUE(fossil_net_server_listen_fds(got, 2) == 1);
+    ASSUME_ITS_TRUE(got[0] != NULL);
+    ASSUME_ITS_TRUE(getenv("LISTEN_FDS") == NULL);
+    fossil_net_address_t addr;
+    ASSUME_ITS_TRUE(fossil_net_server_get_address(got[0], &addr) == 0);
+    ASSUME_ITS_TRUE(addr.port == ep.port);
+    ASSUME_ITS_TRUE(fossil_net_server_socket(got[0])->type == FOSSIL_NET_SOCKET_TYPE_UDP);
+    fossil_net_server_destroy(got[0]);
+    if (saved >= 0) {
+        dup2(saved, 3);
+        close(saved);
+    }
+    ASSUME_ITS_TRUE(fossil_net_server_listen_fds(got, 2) == 0);
+    fossil_net_server_destroy(orig);
+#endif
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -106,6 +174,8 @@ FOSSIL_TEST_GROUP(c_server_tests) {
     FOSSIL_ADD_TEST(c_server_fixture, c_server_test_server_listen_and_get_address);
     FOSSIL_ADD_TEST(c_server_fixture, c_server_test_server_set_blocking);
     FOSSIL_ADD_TEST(c_server_fixture, c_server_test_server_accept_fail);
+    FOSSIL_ADD_TEST(c_server_fixture, c_server_test_server_adopt);
+    FOSSIL_ADD_TEST(c_server_fixture, c_server_test_server_listen_fds);
 
     FOSSIL_ADD_SUITE(c_server_fixture);
 } // end of tests
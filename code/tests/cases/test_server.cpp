@@ -24,6 +24,12 @@
  */
 #include "fossil/network/framework.h"
 #include <fossil/maip/framework.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -96,6 +102,50 @@ FOSSIL_TEST(cpp_server_test_server_accept_fail) {
     ASSUME_ITS_TRUE(rc != 0);
 }
 
+FOSSIL_TEST(cpp_server_test_server_handoff) {
+#if !defined(_WIN32)
+    Server old("tcp", "ipv4", "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(old.is_valid());
+    ASSUME_ITS_TRUE(old.listen(8) == 0);
+    fossil_net_endpoint_t ep{};
+    ASSUME_ITS_TRUE(fossil_net_socket_get_local_endpoint(old.socket(), &ep) == 0);
+
+    // Queued before the handoff: the successor must still accept it.
+    fossil_net_socket_t c;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&c, "tcp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_connect_endpoint(&c, &ep) == 0);
+
+    std::string path = "/tmp/fossil_handoff_" + std::to_string(getpid()) + ".sock";
+    fossil_net_server_t *const list[1] = {old.native_handle()};
+    int sent = -1;
+    std::thread giver([&] { sent = fossil_net_server_handoff(path.c_str(), list, 1, 5000); });
+    fossil_net_server_t *got[4] = {};
+    int n = -1;
+    for (int i = 0; i < 500 && n < 0; ++i) {
+        n = fossil_net_server_inherit(path.c_str(), got, 4);
+        if (n < 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    giver.join();
+    ASSUME_ITS_TRUE(sent == 0);
+    ASSUME_ITS_TRUE(n == 1);
+    Server successor(got[0]);
+    ASSUME_ITS_TRUE(successor.is_valid());
+    old = Server(nullptr); // the old process exits; the socket lives on
+
+    fossil_net_socket_t a;
+    ASSUME_ITS_TRUE(successor.accept(&a) == 0);
+    uint32_t wrote = 0, read = 0;
+    char buf[8] = {};
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&a, "hi", 2, &wrote) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_receive(&c, buf, sizeof(buf), &read) == 0);
+    ASSUME_ITS_TRUE(std::string(buf, read) == "hi");
+    fossil_net_socket_close(&a);
+    fossil_net_socket_close(&c);
+    ASSUME_ITS_TRUE(fossil_net_server_inherit(path.c_str(), got, 4) == -1);
+#endif
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -105,6 +155,7 @@ FOSSIL_TEST_GROUP(cpp_server_tests) {
     FOSSIL_ADD_TEST(cpp_server_fixture, cpp_server_test_server_listen_and_get_address);
     FOSSIL_ADD_TEST(cpp_server_fixture, cpp_server_test_server_set_blocking);
     FOSSIL_ADD_TEST(cpp_server_fixture, cpp_server_test_server_accept_fail);
+    FOSSIL_ADD_TEST(cpp_server_fixture, cpp_server_test_server_handoff);
 
     FOSSIL_ADD_SUITE(cpp_server_fixture);
 } // end of tests
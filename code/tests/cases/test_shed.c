@@ -0,0 +1,264 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_shed_fixture);
+
+FOSSIL_SETUP(c_shed_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_shed_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+#define C_SHED_MS 1000000ull
+#define C_SHED_BASE 1000000000000ull
+
+FOSSIL_TEST(c_shed_test_escalate_and_decay) {
+    fossil_net_shed_t *s = fossil_net_shed_create(NULL);
+    ASSUME_ITS_TRUE(s != NULL);
+    const uint64_t t0 = C_SHED_BASE;
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_ACCEPT, 1 * C_SHED_MS, t0);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0) == FOSSIL_NET_SHED_NONE);
+
+    /* A standing queue escalates one level per interval. */
+    for (uint64_t t = 0; t <= 400; t += 50)
+        fossil_net_shed_record(s, FOSSIL_NET_SHED_REQUEST, 20 * C_SHED_MS, t0 + t * C_SHED_MS);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 400 * C_SHED_MS) == FOSSIL_NET_SHED_CLOSE_IDLE);
+
+    /* Below target again: one step down per interval. */
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_REQUEST, 1 * C_SHED_MS, t0 + 450 * C_SHED_MS);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 450 * C_SHED_MS) == FOSSIL_NET_SHED_PAUSE_ACCEPT);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 500 * C_SHED_MS) == FOSSIL_NET_SHED_PAUSE_ACCEPT);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 560 * C_SHED_MS) == FOSSIL_NET_SHED_REJECT);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 700 * C_SHED_MS) == FOSSIL_NET_SHED_NONE);
+
+    fossil_net_shed_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_shed_get_stats(s, &st) == 0);
+    ASSUME_ITS_TRUE(st.escalations == 3);
+    ASSUME_ITS_TRUE(st.deescalations == 3);
+    ASSUME_ITS_TRUE(st.samples[FOSSIL_NET_SHED_ACCEPT] == 1);
+    ASSUME_ITS_TRUE(st.samples[FOSSIL_NET_SHED_REQUEST] == 10);
+    ASSUME_ITS_TRUE(st.above_target[FOSSIL_NET_SHED_REQUEST] == 9);
+    ASSUME_ITS_TRUE(st.max_sojourn_ns[FOSSIL_NET_SHED_REQUEST] == 20 * C_SHED_MS);
+    fossil_net_shed_destroy(s);
+}
+
+FOSSIL_TEST(c_shed_test_burst_and_silence) {
+    fossil_net_shed_t *s = fossil_net_shed_create(NULL);
+    const uint64_t t0 = C_SHED_BASE;
+    /* A burst that drains within the interval triggers nothing. */
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_ACCEPT, 50 * C_SHED_MS, t0);
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_ACCEPT, 30 * C_SHED_MS, t0 + 60 * C_SHED_MS);
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_ACCEPT, 1 * C_SHED_MS, t0 + 90 * C_SHED_MS);
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_ACCEPT, 30 * C_SHED_MS, t0 + 120 * C_SHED_MS);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 150 * C_SHED_MS) == FOSSIL_NET_SHED_NONE);
+
+    /* Escalated, then the queue goes quiet (e.g. accepting paused): decay anyway. */
+    fossil_net_shed_record(s, FOSSIL_NET_SHED_ACCEPT, 30 * C_SHED_MS, t0 + 250 * C_SHED_MS);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 250 * C_SHED_MS) == FOSSIL_NET_SHED_REJECT);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 300 * C_SHED_MS) == FOSSIL_NET_SHED_REJECT);
+    ASSUME_ITS_TRUE(fossil_net_shed_level(s, t0 + 400 * C_SHED_MS) == FOSSIL_NET_SHED_NONE);
+    fossil_net_shed_destroy(s);
+}
+
+FOSSIL_TEST(c_shed_test_admit_and_canned) {
+    static const char busy[] = "BUSY\n";
+    fossil_net_shed_config_t cfg = {0};
+    cfg.canned = busy;
+    cfg.canned_len = 5;
+    fossil_net_shed_t *s = fossil_net_shed_create(&cfg);
+    ASSUME_ITS_TRUE(s != NULL);
+    ASSUME_ITS_TRUE(fossil_net_shed_admit(s));
+    ASSUME_ITS_TRUE(fossil_net_shed_force(s, FOSSIL_NET_SHED_REJECT) == 0);
+    ASSUME_ITS_TRUE(!fossil_net_shed_admit(s));
+    ASSUME_ITS_TRUE(fossil_net_shed_force(s, -1) == 0);
+    ASSUME_ITS_TRUE(fossil_net_shed_admit(s));
+    ASSUME_ITS_TRUE(fossil_net_shed_force(s, 4) != 0);
+
+    uint32_t len = 0;
+    const char *canned = (const char *)fossil_net_shed_canned(s, &len);
+    ASSUME_ITS_TRUE(len == 5 && canned != busy && memcmp(canned, busy, 5) == 0);
+    fossil_net_shed_stats_t st;
+    fossil_net_shed_get_stats(s, &st);
+    ASSUME_ITS_TRUE(st.admitted == 2 && st.rejected == 1);
+    fossil_net_shed_config_t eff;
+    ASSUME_ITS_TRUE(fossil_net_shed_get_config(s, &eff) == 0);
+    ASSUME_ITS_TRUE(eff.target_ns == 5 * C_SHED_MS && eff.interval_ns == 100 * C_SHED_MS);
+    fossil_net_shed_destroy(s);
+
+    s = fossil_net_shed_create(NULL);
+    canned = (const char *)fossil_net_shed_canned(s, &len);
+    ASSUME_ITS_TRUE(len > 12 && memcmp(canned, "HTTP/1.1 503", 12) == 0);
+    fossil_net_shed_destroy(s);
+}
+
+static void c_shed_sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static atomic_uint c_shed_accepts;
+static atomic_uint c_shed_closes;
+
+static int c_shed_on_accept(fossil_net_conn_t *conn, void *user) {
+    (void)conn;
+    (void)user;
+    atomic_fetch_add(&c_shed_accepts, 1);
+    return 0;
+}
+
+static void c_shed_on_close(fossil_net_conn_t *conn, void *user) {
+    (void)conn;
+    (void)user;
+    atomic_fetch_add(&c_shed_closes, 1);
+}
+
+static void c_shed_noop(fossil_net_loop_t *loop, void *arg) {
+    (void)loop;
+    (void)arg;
+}
+
+static bool c_shed_wait(atomic_uint *counter, unsigned target) {
+    for (int i = 0; i < 500 && atomic_load(counter) < target; ++i)
+        c_shed_sleep_ms(10);
+    return atomic_load(counter) >= target;
+}
+
+/* Connect, then read until EOF; returns bytes read into buf. */
+static int c_shed_connect(const fossil_net_endpoint_t *ep, fossil_net_socket_t *c) {
+    if (fossil_net_socket_create(c, "tcp", "ipv4") != 0) return -1;
+    return fossil_net_socket_connect_endpoint(c, ep);
+}
+
+static uint32_t c_shed_read_all(fossil_net_socket_t *c, char *buf, uint32_t size) {
+    uint32_t total = 0, n = 0;
+    while (total < size && fossil_net_socket_receive(c, buf + total, size - total, &n) == 0 && n)
+        total += n;
+    return total;
+}
+
+FOSSIL_TEST(c_shed_test_reactor_admission) {
+    static const fossil_net_reactor_callbacks_t cbs = { c_shed_on_accept, NULL, NULL, c_shed_on_close, NULL, NULL };
+    atomic_store(&c_shed_accepts, 0);
+    atomic_store(&c_shed_closes, 0);
+    fossil_net_shed_config_t scfg = {0};
+    scfg.max_connections = 2;
+    scfg.interval_ns = 50 * C_SHED_MS;
+    fossil_net_shed_t *shed = fossil_net_shed_create(&scfg);
+    fossil_net_server_t *server = fossil_net_server_create("tcp", "ipv4", "127.0.0.1", 0);
+    fossil_net_reactor_config_t cfg = {0};
+    cfg.threads = 1;
+    fossil_net_reactor_t *r = fossil_net_reactor_create(server, &cfg, &cbs, NULL);
+    ASSUME_ITS_TRUE(r != NULL);
+    ASSUME_ITS_TRUE(fossil_net_reactor_set_shed(r, shed) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_start(r) == 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_set_shed(r, NULL) != 0);
+
+    fossil_net_endpoint_t ep;
+    fossil_net_socket_get_local_endpoint(fossil_net_server_socket(server), &ep);
+    fossil_net_socket_t a, b, c, d;
+    char buf[256];
+    ASSUME_ITS_TRUE(c_shed_connect(&ep, &a) == 0);
+    ASSUME_ITS_TRUE(c_shed_connect(&ep, &b) == 0);
+    ASSUME_ITS_TRUE(c_shed_wait(&c_shed_accepts, 2));
+
+    /* Over max_connections: canned response, then EOF. */
+    ASSUME_ITS_TRUE(c_shed_connect(&ep, &c) == 0);
+    uint32_t n = c_shed_read_all(&c, buf, sizeof(buf));
+    ASSUME_ITS_TRUE(n > 12 && memcmp(buf, "HTTP/1.1 503", 12) == 0);
+    fossil_net_socket_close(&c);
+
+    /* Idle sweep closes the two open connections. */
+    c_shed_sleep_ms(120);
+    fossil_net_shed_force(shed, FOSSIL_NET_SHED_CLOSE_IDLE);
+    fossil_net_loop_post(fossil_net_reactor_loop(r, 0), c_shed_noop, NULL);
+    ASSUME_ITS_TRUE(c_shed_wait(&c_shed_closes, 2));
+    ASSUME_ITS_TRUE(c_shed_read_all(&a, buf, sizeof(buf)) == 0);
+    fossil_net_socket_close(&a);
+    fossil_net_socket_close(&b);
+
+    /* Rejecting: new connections are answered without reaching on_accept. */
+    fossil_net_shed_force(shed, FOSSIL_NET_SHED_REJECT);
+    ASSUME_ITS_TRUE(c_shed_connect(&ep, &d) == 0);
+    n = c_shed_read_all(&d, buf, sizeof(buf));
+    ASSUME_ITS_TRUE(n > 12 && memcmp(buf, "HTTP/1.1 503", 12) == 0);
+    fossil_net_socket_close(&d);
+    ASSUME_ITS_TRUE(atomic_load(&c_shed_accepts) == 2);
+
+    fossil_net_reactor_stats_t st;
+    fossil_net_reactor_get_stats(r, &st);
+    ASSUME_ITS_TRUE(st.shed == 2);
+    ASSUME_ITS_TRUE(st.idle_closed == 2);
+    fossil_net_shed_stats_t ss;
+    fossil_net_shed_get_stats(shed, &ss);
+    ASSUME_ITS_TRUE(ss.samples[FOSSIL_NET_SHED_ACCEPT] == 2);
+    fossil_net_reactor_destroy(r);
+    fossil_net_server_destroy(server);
+    fossil_net_shed_destroy(shed);
+}
+
+FOSSIL_TEST(c_shed_test_invalid) {
+    ASSUME_ITS_TRUE(fossil_net_shed_level(NULL, 0) == FOSSIL_NET_SHED_NONE);
+    ASSUME_ITS_TRUE(fossil_net_shed_admit(NULL));
+    ASSUME_ITS_TRUE(fossil_net_shed_force(NULL, 1) != 0);
+    ASSUME_ITS_TRUE(fossil_net_shed_get_stats(NULL, NULL) != 0);
+    fossil_net_shed_record(NULL, FOSSIL_NET_SHED_ACCEPT, 1, 0);
+    ASSUME_ITS_TRUE(fossil_net_reactor_set_shed(NULL, NULL) != 0);
+    fossil_net_shed_destroy(NULL);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_shed_tests) {
+    FOSSIL_ADD_TEST(c_shed_fixture, c_shed_test_escalate_and_decay);
+    FOSSIL_ADD_TEST(c_shed_fixture, c_shed_test_burst_and_silence);
+    FOSSIL_ADD_TEST(c_shed_fixture, c_shed_test_admit_and_canned);
+    FOSSIL_ADD_TEST(c_shed_fixture, c_shed_test_reactor_admission);
+    FOSSIL_ADD_TEST(c_shed_fixture, c_shed_test_invalid);
+
+    FOSSIL_ADD_SUITE(c_shed_fixture);
+} // end of tests
@@ -0,0 +1,86 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_shed_fixture);
+
+FOSSIL_SETUP(cpp_shed_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_shed_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_shed_test_class_levels) {
+    fossil::net::Shed shed;
+    ASSUME_ITS_TRUE(shed.native_handle() != nullptr);
+    const uint64_t t0 = fossil_net_socket_clock_ns(), ms = 1000000ull;
+    for (uint64_t t = 0; t <= 100; t += 25)
+        shed.record(FOSSIL_NET_SHED_ACCEPT, 10 * ms, t0 + t * ms);
+    ASSUME_ITS_TRUE(shed.level(t0 + 100 * ms) == FOSSIL_NET_SHED_REJECT);
+    ASSUME_ITS_TRUE(!shed.admit());
+    ASSUME_ITS_TRUE(shed.force(FOSSIL_NET_SHED_NONE) == 0);
+    ASSUME_ITS_TRUE(shed.admit());
+    ASSUME_ITS_TRUE(shed.stats().escalations == 1);
+}
+
+FOSSIL_TEST(cpp_shed_test_class_move) {
+    fossil_net_shed_config_t cfg{};
+    cfg.target_ns = 1000;
+    fossil::net::Shed shed(&cfg);
+    shed.force(FOSSIL_NET_SHED_PAUSE_ACCEPT);
+    fossil::net::Shed moved(std::move(shed));
+    ASSUME_ITS_TRUE(shed.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.level() == FOSSIL_NET_SHED_PAUSE_ACCEPT);
+    moved = fossil::net::Shed();
+    ASSUME_ITS_TRUE(moved.level() == FOSSIL_NET_SHED_NONE);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_shed_tests) {
+    FOSSIL_ADD_TEST(cpp_shed_fixture, cpp_shed_test_class_levels);
+    FOSSIL_ADD_TEST(cpp_shed_fixture, cpp_shed_test_class_move);
+
+    FOSSIL_ADD_SUITE(cpp_shed_fixture);
+} // end of tests
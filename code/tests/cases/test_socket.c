@@ -156,6 +156,38 @@ FOSSIL_TEST(c_socket_test_socket_error_string) {
     ASSUME_ITS_TRUE(msg != NULL);
 }
 
+FOSSIL_TEST(c_socket_test_socket_compact_layout_and_ids) {
+    ASSUME_ITS_TRUE(sizeof(fossil_net_socket_t) == 8);
+
+    fossil_net_socket_t sock;
+    int rc = fossil_net_socket_create(&sock, "udp", "ipv6");
+    if (rc != 0) return;
+    ASSUME_ITS_TRUE(strcmp(fossil_net_socket_type_id(&sock), "udp") == 0);
+    ASSUME_ITS_TRUE(strcmp(fossil_net_socket_family_id(&sock), "ipv6") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_is_blocking(&sock));
+
+    char id[64];
+    rc = fossil_net_socket_get_id(&sock, id, sizeof(id));
+    ASSUME_ITS_TRUE(rc == 0 && id[0] == '\0');
+    rc = fossil_net_socket_set_id(&sock, "replica-7");
+    ASSUME_ITS_TRUE(rc == 0);
+    rc = fossil_net_socket_get_id(&sock, id, sizeof(id));
+    ASSUME_ITS_TRUE(rc == 0 && strcmp(id, "replica-7") == 0);
+
+    // Closing drops the side-table entry so a reused descriptor starts clean
+    int32_t fd = sock.fd;
+    fossil_net_socket_close(&sock);
+    ASSUME_ITS_TRUE(sock.fd == -1);
+    fossil_net_socket_t again;
+    rc = fossil_net_socket_create(&again, "tcp", "ipv4");
+    if (rc != 0) return;
+    if (again.fd == fd) {
+        rc = fossil_net_socket_get_id(&again, id, sizeof(id));
+        ASSUME_ITS_TRUE(rc == 0 && id[0] == '\0');
+    }
+    fossil_net_socket_close(&again);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -168,6 +200,7 @@ FOSSIL_TEST_GROUP(c_socket_tests) {
     FOSSIL_ADD_TEST(c_socket_fixture, c_socket_test_socket_resolve_and_hostname);
     FOSSIL_ADD_TEST(c_socket_fixture, c_socket_test_socket_poll_timeout);
     FOSSIL_ADD_TEST(c_socket_fixture, c_socket_test_socket_error_string);
+    FOSSIL_ADD_TEST(c_socket_fixture, c_socket_test_socket_compact_layout_and_ids);
 
     FOSSIL_ADD_SUITE(c_socket_fixture);
 } // end of tests
@@ -136,6 +136,22 @@ FOSSIL_TEST(cpp_socket_test_socket_error_string) {
     ASSUME_ITS_TRUE(msg != NULL);
 }
 
+FOSSIL_TEST(cpp_socket_test_socket_string_ids) {
+    fossil::net::Socket sock;
+    int rc = sock.socket_create("tcp", "ipv4");
+    ASSUME_ITS_TRUE(rc == 0);
+    ASSUME_ITS_TRUE(sock.socket_type() == "tcp");
+    ASSUME_ITS_TRUE(sock.socket_family() == "ipv4");
+    ASSUME_ITS_TRUE(sock.socket_id().empty());
+    rc = sock.socket_set_id("edge-listener");
+    ASSUME_ITS_TRUE(rc == 0);
+    ASSUME_ITS_TRUE(sock.socket_id() == "edge-listener");
+    rc = sock.socket_set_blocking(false);
+    ASSUME_ITS_TRUE(rc == 0);
+    ASSUME_ITS_TRUE(!sock.socket_is_blocking());
+    sock.socket_close();
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -147,6 +163,7 @@ FOSSIL_TEST_GROUP(cpp_socket_tests) {
     FOSSIL_ADD_TEST(cpp_socket_fixture, cpp_socket_test_socket_resolve_and_hostname);
     FOSSIL_ADD_TEST(cpp_socket_fixture, cpp_socket_test_socket_poll_timeout);
     FOSSIL_ADD_TEST(cpp_socket_fixture, cpp_socket_test_socket_error_string);
+    FOSSIL_ADD_TEST(cpp_socket_fixture, cpp_socket_test_socket_string_ids);
 
     FOSSIL_ADD_SUITE(cpp_socket_fixture);
 } // end of tests
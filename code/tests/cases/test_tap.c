@@ -0,0 +1,181 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_tap_fixture);
+
+FOSSIL_SETUP(c_tap_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_tap_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static uint32_t c_tap_get32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// Walk a pcapng file: returns the number of EPBs, decoding the first on iface 0
+static int c_tap_read(const char *path, uint32_t *epbs, uint32_t *frames, fossil_net_packet_t *first, uint8_t *store) {
+    static uint8_t buf[1 << 16];
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    size_t n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (n < 28 || c_tap_get32(buf) != 0x0A0D0D0Au || c_tap_get32(buf + 8) != 0x1A2B3C4Du) return -1;
+    *epbs = *frames = 0;
+    int idbs = 0;
+    for (size_t off = 0; off + 12 <= n;) {
+        uint32_t type = c_tap_get32(buf + off), len = c_tap_get32(buf + off + 4);
+        if (len < 12 || off + len > n || c_tap_get32(buf + off + len - 4) != len) return -1;
+        if (type == 1) idbs++;
+        if (type == 6) {
+            uint32_t iface = c_tap_get32(buf + off + 8), cap = c_tap_get32(buf + off + 20);
+            if (iface == 1) (*frames)++;
+            if (iface == 0 && (*epbs)++ == 0) {
+                memcpy(store, buf + off + 28, cap);
+                if (fossil_net_packet_decode(store, cap, FOSSIL_NET_PACKET_LINK_IP, first) != 0) return -1;
+            }
+        }
+        off += len;
+    }
+    return idbs == 2 ? 0 : -1;
+}
+
+FOSSIL_TEST(c_tap_test_udp_socket) {
+    const char *path = "fossil_tap_udp.pcapng";
+    fossil_net_tap_t *tap = fossil_net_tap_create(path, NULL);
+    ASSUME_ITS_TRUE(tap != NULL);
+
+    fossil_net_socket_t a, b;
+    fossil_net_endpoint_t ep, a_ep, b_ep;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&a, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&b, "udp", "ipv4") == 0);
+    fossil_net_socket_bind_endpoint(&a, &ep);
+    fossil_net_socket_bind_endpoint(&b, &ep);
+    fossil_net_socket_get_local_endpoint(&a, &a_ep);
+    fossil_net_socket_get_local_endpoint(&b, &b_ep);
+    fossil_net_socket_connect_endpoint(&a, &b_ep);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_tap(&a, tap) == 0);
+    ASSUME_ITS_TRUE(fossil_net_socket_set_tap(&b, tap) == 0);
+
+    uint32_t sent = 0, got = 0;
+    char buf[64];
+    fossil_net_endpoint_t from;
+    ASSUME_ITS_TRUE(fossil_net_socket_send(&a, "hello", 5, &sent) == 0 && sent == 5);
+    ASSUME_ITS_TRUE(fossil_net_socket_receive_from(&b, buf, sizeof(buf), &got, &from) == 0 && got == 5);
+    ASSUME_ITS_TRUE(fossil_net_tap_flush(tap) == 0);
+
+    fossil_net_tap_stats_t st;
+    fossil_net_tap_get_stats(tap, &st);
+    ASSUME_ITS_TRUE(st.records == 2 && st.packets == 2 && st.dropped == 0);
+
+    uint32_t epbs = 0, frames = 0;
+    fossil_net_packet_t p;
+    static uint8_t store[1 << 16];
+    ASSUME_ITS_TRUE(c_tap_read(path, &epbs, &frames, &p, store) == 0);
+    ASSUME_ITS_TRUE(epbs == 2 && frames == 0);
+    ASSUME_ITS_TRUE((p.layers & FOSSIL_NET_PACKET_HAS_UDP) && p.src_port == a_ep.port && p.dst_port == b_ep.port);
+    uint32_t plen = 0;
+    const uint8_t *payload = fossil_net_packet_payload(&p, &plen);
+    ASSUME_ITS_TRUE(plen == 5 && memcmp(payload, "hello", 5) == 0);
+
+    fossil_net_socket_set_tap(&a, NULL);
+    fossil_net_socket_set_tap(&b, NULL);
+    ASSUME_ITS_TRUE((a.flags & FOSSIL_NET_SOCKET_FLAG_TAP) == 0);
+    fossil_net_socket_close(&a);
+    fossil_net_socket_close(&b);
+    fossil_net_tap_destroy(tap);
+    remove(path);
+}
+
+FOSSIL_TEST(c_tap_test_frames_and_snaplen) {
+    const char *path = "fossil_tap_frames.pcapng";
+    fossil_net_tap_config_t cfg = { 8192, 100, 0, 0 };
+    fossil_net_tap_t *tap = fossil_net_tap_create(path, &cfg);
+    ASSUME_ITS_TRUE(tap != NULL);
+
+    uint8_t frame[300];
+    memset(frame, 0xab, sizeof(frame));
+    ASSUME_ITS_TRUE(fossil_net_tap_record_frame(tap, FOSSIL_NET_TAP_INBOUND, frame, sizeof(frame)) == 0);
+
+    fossil_net_endpoint_t l, r;
+    fossil_net_endpoint_parse(&l, "10.0.0.1", 1000);
+    fossil_net_endpoint_parse(&r, "::1", 2000);
+    ASSUME_ITS_TRUE(fossil_net_tap_record(tap, FOSSIL_NET_TAP_OUTBOUND, 6, &l, &r, "x", 1) != 0); // family mismatch
+
+    // A small ring drops instead of blocking the recording thread
+    uint32_t dropped = 0;
+    for (int i = 0; i < 1000; ++i)
+        if (fossil_net_tap_record_frame(tap, FOSSIL_NET_TAP_OUTBOUND, frame, sizeof(frame)) != 0) dropped++;
+    fossil_net_tap_flush(tap);
+    fossil_net_tap_stats_t st;
+    fossil_net_tap_get_stats(tap, &st);
+    ASSUME_ITS_TRUE(st.records + st.dropped == 1002 && st.packets == st.records);
+    fossil_net_tap_destroy(tap);
+    (void)dropped;
+
+    // Frames are cut to the snaplen but keep their original length
+    FILE *f = fopen(path, "rb");
+    uint8_t hdr[28 + 64 + 28];
+    ASSUME_ITS_TRUE(f != NULL && fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr));
+    fclose(f);
+    ASSUME_ITS_TRUE(c_tap_get32(hdr + 92) == 6 && c_tap_get32(hdr + 100) == 1);
+    ASSUME_ITS_TRUE(c_tap_get32(hdr + 112) == 100 && c_tap_get32(hdr + 116) == 300);
+    remove(path);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_tap_tests) {
+    FOSSIL_ADD_TEST(c_tap_fixture, c_tap_test_udp_socket);
+    FOSSIL_ADD_TEST(c_tap_fixture, c_tap_test_frames_and_snaplen);
+
+    FOSSIL_ADD_SUITE(c_tap_fixture);
+} // end of tests
@@ -0,0 +1,92 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_tap_fixture);
+
+FOSSIL_SETUP(cpp_tap_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_tap_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_tap_test_class_threads) {
+    const char *path = "fossil_tap_threads.pcapng";
+    {
+        fossil::net::Tap tap(path);
+        ASSUME_ITS_TRUE(tap.native_handle() != nullptr);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t)
+            workers.emplace_back([&tap] {
+                uint8_t frame[64] = {};
+                for (int i = 0; i < 500; ++i)
+                    tap.record_frame(FOSSIL_NET_TAP_OUTBOUND, frame, sizeof(frame));
+            });
+        for (auto &w : workers) w.join();
+        ASSUME_ITS_TRUE(tap.flush() == 0);
+        fossil_net_tap_stats_t st = tap.stats();
+        ASSUME_ITS_TRUE(st.records + st.dropped == 2000);
+        ASSUME_ITS_TRUE(st.packets == st.records);
+    }
+    std::remove(path);
+}
+
+FOSSIL_TEST(cpp_tap_test_class_invalid) {
+    fossil::net::Tap tap(nullptr);
+    ASSUME_ITS_TRUE(tap.native_handle() == nullptr);
+    fossil::net::Tap moved(std::move(tap));
+    ASSUME_ITS_TRUE(moved.native_handle() == nullptr);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_tap_tests) {
+    FOSSIL_ADD_TEST(cpp_tap_fixture, cpp_tap_test_class_threads);
+    FOSSIL_ADD_TEST(cpp_tap_fixture, cpp_tap_test_class_invalid);
+
+    FOSSIL_ADD_SUITE(cpp_tap_fixture);
+} // end of tests
@@ -0,0 +1,295 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <stdio.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_writeq_fixture);
+
+FOSSIL_SETUP(c_writeq_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_writeq_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static int c_writeq_pair(fossil_net_socket_t *srv, fossil_net_socket_t *cli, fossil_net_socket_t *peer) {
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_create(srv, "tcp", "ipv4") != 0) return -1;
+    if (fossil_net_socket_create(cli, "tcp", "ipv4") != 0) return -1;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    if (fossil_net_socket_bind_endpoint(srv, &ep) != 0) return -1;
+    if (fossil_net_socket_listen(srv, 1) != 0) return -1;
+    fossil_net_socket_get_local_endpoint(srv, &ep);
+    if (fossil_net_socket_connect_endpoint(cli, &ep) != 0) return -1;
+    if (fossil_net_socket_accept_endpoint(srv, peer, NULL) != 0) return -1;
+    return fossil_net_socket_set_blocking(cli, false);
+}
+
+static void c_writeq_close(fossil_net_socket_t *srv, fossil_net_socket_t *cli, fossil_net_socket_t *peer) {
+    fossil_net_socket_close(peer);
+    fossil_net_socket_close(cli);
+    fossil_net_socket_close(srv);
+}
+
+typedef struct c_writeq_marks {
+    int high;
+    int low;
+} c_writeq_marks_t;
+
+static void c_writeq_on_mark(fossil_net_writeq_t *q, bool above, void *arg) {
+    c_writeq_marks_t *m = (c_writeq_marks_t *)arg;
+    (void)q;
+    if (above) m->high++;
+    else m->low++;
+}
+
+/* Drain the peer while flushing; returns bytes read, checking the pattern. */
+static uint64_t c_writeq_drain(fossil_net_writeq_t *q, fossil_net_socket_t *peer, uint64_t total, int *bad) {
+    static uint8_t buf[65536];
+    uint64_t got = 0;
+    while (got < total) {
+        if (fossil_net_writeq_flush(q) < 0) break;
+        uint32_t n = 0;
+        if (fossil_net_socket_receive(peer, buf, sizeof(buf), &n) != 0 || n == 0) break;
+        for (uint32_t i = 0; i < n; ++i)
+            if (buf[i] != (uint8_t)((got + i) % 251u)) (*bad)++;
+        got += n;
+    }
+    return got;
+}
+
+FOSSIL_TEST(c_writeq_test_backpressure) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(c_writeq_pair(&srv, &cli, &peer) == 0);
+    c_writeq_marks_t marks = {0, 0};
+    fossil_net_writeq_config_t cfg = {0};
+    cfg.high_watermark = 64 * 1024;
+    cfg.block_size = 4096;
+    fossil_net_writeq_t *q = fossil_net_writeq_create(&cli, &cfg, c_writeq_on_mark, &marks);
+    ASSUME_ITS_TRUE(q != NULL);
+
+    /* Write until the reader falls far enough behind to trip the watermark. */
+    static uint8_t chunk[8192];
+    uint64_t written = 0;
+    while (!fossil_net_writeq_is_above(q) && written < (256u << 20)) {
+        for (uint32_t i = 0; i < sizeof(chunk); ++i)
+            chunk[i] = (uint8_t)((written + i) % 251u);
+        ASSUME_ITS_TRUE(fossil_net_writeq_write(q, chunk, sizeof(chunk)) == 0);
+        written += sizeof(chunk);
+    }
+    ASSUME_ITS_TRUE(marks.high == 1);
+    ASSUME_ITS_TRUE(fossil_net_writeq_pending(q) >= cfg.high_watermark);
+
+    int bad = 0;
+    ASSUME_ITS_TRUE(c_writeq_drain(q, &peer, written, &bad) == written);
+    ASSUME_ITS_TRUE(bad == 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_pending(q) == 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_flush(q) == 0);
+    ASSUME_ITS_TRUE(marks.low == 1);
+    ASSUME_ITS_TRUE(!fossil_net_writeq_is_above(q));
+
+    fossil_net_writeq_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_writeq_get_stats(q, &st) == 0);
+    ASSUME_ITS_TRUE(st.written == written);
+    ASSUME_ITS_TRUE(st.direct + st.sent == written);
+    ASSUME_ITS_TRUE(st.peak >= cfg.high_watermark);
+    fossil_net_writeq_destroy(q);
+    c_writeq_close(&srv, &cli, &peer);
+}
+
+static int c_writeq_freed;
+
+static void c_writeq_free(void *data, void *ctx) {
+    (void)data;
+    (void)ctx;
+    c_writeq_freed++;
+}
+
+FOSSIL_TEST(c_writeq_test_shared_buffers) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(c_writeq_pair(&srv, &cli, &peer) == 0);
+    fossil_net_writeq_t *a = fossil_net_writeq_create(&cli, NULL, NULL, NULL);
+    fossil_net_writeq_t *b = fossil_net_writeq_create(&cli, NULL, NULL, NULL);
+    ASSUME_ITS_TRUE(a != NULL && b != NULL);
+
+    static const char text[] = "shared-response";
+    c_writeq_freed = 0;
+    fossil_net_buf_t *buf = fossil_net_buf_wrap(text, (uint32_t)strlen(text), c_writeq_free, NULL);
+    ASSUME_ITS_TRUE(buf != NULL);
+    ASSUME_ITS_TRUE(fossil_net_buf_size(buf) == strlen(text));
+
+    /* An empty queue sends immediately and keeps no reference. */
+    ASSUME_ITS_TRUE(fossil_net_writeq_append(a, buf, 0, 6) == 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_pending(a) == 0);
+
+    /* The queue kept no reference, so the caller's is the last. */
+    fossil_net_buf_ref(buf);
+    fossil_net_buf_unref(buf);
+    fossil_net_buf_unref(buf);
+    ASSUME_ITS_TRUE(c_writeq_freed == 1);
+
+    fossil_net_buf_t *own = fossil_net_buf_create(32);
+    ASSUME_ITS_TRUE(own != NULL);
+    ASSUME_ITS_TRUE(fossil_net_buf_size(own) == 0);
+    memcpy(fossil_net_buf_data(own), "0123456789", 10);
+    ASSUME_ITS_TRUE(fossil_net_buf_set_size(own, 10) == 0);
+    ASSUME_ITS_TRUE(fossil_net_buf_set_size(own, 33) != 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_append(b, own, 2, 9) != 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_append(b, own, 2, 3) == 0);
+    fossil_net_buf_unref(own);
+
+    char got[16] = {0};
+    uint32_t n = 0, total = 0;
+    while (total < 9 && fossil_net_socket_receive(&peer, got + total, (uint32_t)(sizeof(got) - 1 - total), &n) == 0 && n)
+        total += n;
+    ASSUME_ITS_TRUE(total == 9);
+    ASSUME_ITS_TRUE(memcmp(got, "shared234", 9) == 0);
+
+    fossil_net_writeq_destroy(a);
+    fossil_net_writeq_destroy(b);
+    c_writeq_close(&srv, &cli, &peer);
+}
+
+FOSSIL_TEST(c_writeq_test_limit_and_errors) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(c_writeq_pair(&srv, &cli, &peer) == 0);
+    fossil_net_writeq_config_t cfg = {0};
+    cfg.high_watermark = 1024;
+    cfg.limit = 4096;
+    fossil_net_writeq_t *q = fossil_net_writeq_create(&cli, &cfg, NULL, NULL);
+    ASSUME_ITS_TRUE(q != NULL);
+    static uint8_t chunk[1024];
+    memset(chunk, 'x', sizeof(chunk));
+    /* Fill the socket, then the queue up to its limit. */
+    int refused = 0;
+    for (int i = 0; i < 100000 && !refused; ++i)
+        if (fossil_net_writeq_write(q, chunk, sizeof(chunk)) != 0)
+            refused = 1;
+    ASSUME_ITS_TRUE(refused == 1);
+    ASSUME_ITS_TRUE(fossil_net_writeq_pending(q) <= cfg.limit);
+    fossil_net_writeq_stats_t st;
+    fossil_net_writeq_get_stats(q, &st);
+    ASSUME_ITS_TRUE(st.rejected == 1);
+    ASSUME_ITS_TRUE(fossil_net_writeq_flush(q) == 1);
+
+    /* Once the peer is gone the error sticks. */
+    fossil_net_socket_close(&peer);
+    int rc = 0;
+    for (int i = 0; i < 1000 && rc >= 0; ++i)
+        rc = fossil_net_writeq_flush(q);
+    ASSUME_ITS_TRUE(rc == -1);
+    ASSUME_ITS_TRUE(fossil_net_writeq_write(q, chunk, 1) != 0);
+    fossil_net_writeq_destroy(q);
+    fossil_net_socket_close(&cli);
+    fossil_net_socket_close(&srv);
+}
+
+FOSSIL_TEST(c_writeq_test_file_segments) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(c_writeq_pair(&srv, &cli, &peer) == 0);
+    fossil_net_writeq_t *q = fossil_net_writeq_create(&cli, NULL, NULL, NULL);
+    ASSUME_ITS_TRUE(q != NULL);
+
+    enum { SIZE = 8 * 1024 * 1024, CHUNK = 64 * 1024, TAIL = 1000 };
+    static uint8_t pattern[SIZE];
+    for (uint32_t i = 0; i < SIZE; ++i)
+        pattern[i] = (uint8_t)(i % 251u);
+    FILE *f = fopen("fossil_writeq_file.bin", "wb");
+    ASSUME_ITS_TRUE(f != NULL);
+    fwrite(pattern, 1, SIZE, f);
+    fclose(f);
+    f = fopen("fossil_writeq_file.bin", "rb");
+    ASSUME_ITS_TRUE(f != NULL);
+
+    /* Memory, file, memory: the file range goes out in between, in order. */
+    c_writeq_freed = 0;
+    fossil_net_buf_t *owner = fossil_net_buf_wrap(f, 0, c_writeq_free, NULL);
+    uint32_t head = 0;
+    while (head < SIZE / 2 && fossil_net_writeq_pending(q) == 0) {
+        ASSUME_ITS_TRUE(fossil_net_writeq_write(q, pattern + head, CHUNK) == 0);
+        head += CHUNK;
+    }
+    ASSUME_ITS_TRUE(fossil_net_writeq_pending(q) > 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_append_file(q, owner, fileno(f), head, SIZE - head - TAIL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_write(q, pattern + SIZE - TAIL, TAIL) == 0);
+    fossil_net_buf_unref(owner);
+
+    int bad = 0;
+    ASSUME_ITS_TRUE(c_writeq_drain(q, &peer, SIZE, &bad) == SIZE);
+    ASSUME_ITS_TRUE(bad == 0);
+    ASSUME_ITS_TRUE(c_writeq_freed == 1);
+    fossil_net_writeq_stats_t st;
+    fossil_net_writeq_get_stats(q, &st);
+    ASSUME_ITS_TRUE(st.file_bytes == SIZE - head - TAIL);
+    ASSUME_ITS_TRUE(st.sent + st.direct == SIZE);
+    ASSUME_ITS_TRUE(fossil_net_writeq_append_file(q, NULL, -1, 0, 1) != 0);
+
+    fclose(f);
+    remove("fossil_writeq_file.bin");
+    fossil_net_writeq_destroy(q);
+    c_writeq_close(&srv, &cli, &peer);
+}
+
+FOSSIL_TEST(c_writeq_test_invalid) {
+    ASSUME_ITS_TRUE(fossil_net_writeq_create(NULL, NULL, NULL, NULL) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_writeq_write(NULL, "x", 1) != 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_flush(NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_net_writeq_pending(NULL) == 0);
+    ASSUME_ITS_TRUE(fossil_net_buf_wrap(NULL, 4, NULL, NULL) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_buf_ref(NULL) == NULL);
+    fossil_net_buf_unref(NULL);
+    fossil_net_writeq_destroy(NULL);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_writeq_tests) {
+    FOSSIL_ADD_TEST(c_writeq_fixture, c_writeq_test_backpressure);
+    FOSSIL_ADD_TEST(c_writeq_fixture, c_writeq_test_shared_buffers);
+    FOSSIL_ADD_TEST(c_writeq_fixture, c_writeq_test_limit_and_errors);
+    FOSSIL_ADD_TEST(c_writeq_fixture, c_writeq_test_file_segments);
+    FOSSIL_ADD_TEST(c_writeq_fixture, c_writeq_test_invalid);
+
+    FOSSIL_ADD_SUITE(c_writeq_fixture);
+} // end of tests
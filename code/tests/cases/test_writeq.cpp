@@ -0,0 +1,131 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <cstring>
+#include <vector>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_writeq_fixture);
+
+FOSSIL_SETUP(cpp_writeq_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_writeq_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+namespace {
+
+int cpp_writeq_pair(fossil_net_socket_t *srv, fossil_net_socket_t *cli, fossil_net_socket_t *peer) {
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_create(srv, "tcp", "ipv4") != 0) return -1;
+    if (fossil_net_socket_create(cli, "tcp", "ipv4") != 0) return -1;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    if (fossil_net_socket_bind_endpoint(srv, &ep) != 0) return -1;
+    if (fossil_net_socket_listen(srv, 1) != 0) return -1;
+    fossil_net_socket_get_local_endpoint(srv, &ep);
+    if (fossil_net_socket_connect_endpoint(cli, &ep) != 0) return -1;
+    if (fossil_net_socket_accept_endpoint(srv, peer, nullptr) != 0) return -1;
+    return fossil_net_socket_set_blocking(cli, false);
+}
+
+} // namespace
+
+FOSSIL_TEST(cpp_writeq_test_class_roundtrip) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(cpp_writeq_pair(&srv, &cli, &peer) == 0);
+    {
+        fossil::net::WriteQueue q(&cli);
+        ASSUME_ITS_TRUE(q.native_handle() != nullptr);
+        ASSUME_ITS_TRUE(q.write("hello ", 6) == 0);
+        fossil_net_buf_t *buf = fossil_net_buf_create(8);
+        std::memcpy(fossil_net_buf_data(buf), "world", 5);
+        fossil_net_buf_set_size(buf, 5);
+        ASSUME_ITS_TRUE(q.append(buf, 0, 5) == 0);
+        fossil_net_buf_unref(buf);
+        ASSUME_ITS_TRUE(q.flush() == 0);
+        ASSUME_ITS_TRUE(q.pending() == 0);
+        ASSUME_ITS_TRUE(!q.is_above());
+        ASSUME_ITS_TRUE(q.stats().written == 11);
+    }
+    char got[16] = {0};
+    uint32_t n = 0, total = 0;
+    while (total < 11 && fossil_net_socket_receive(&peer, got + total, 15 - total, &n) == 0 && n)
+        total += n;
+    ASSUME_ITS_TRUE(total == 11);
+    ASSUME_ITS_TRUE(std::memcmp(got, "hello world", 11) == 0);
+    fossil_net_socket_close(&peer);
+    fossil_net_socket_close(&cli);
+    fossil_net_socket_close(&srv);
+}
+
+FOSSIL_TEST(cpp_writeq_test_class_move) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(cpp_writeq_pair(&srv, &cli, &peer) == 0);
+    static int marks;
+    marks = 0;
+    fossil_net_writeq_config_t cfg{};
+    cfg.high_watermark = 16 * 1024;
+    fossil::net::WriteQueue q(&cli, &cfg, [](fossil_net_writeq_t *, bool above, void *) { if (above) marks++; });
+    std::vector<uint8_t> chunk(4096, 0x5a);
+    for (int i = 0; i < 100000 && !q.is_above(); ++i)
+        ASSUME_ITS_TRUE(q.write(chunk.data(), static_cast<uint32_t>(chunk.size())) == 0);
+    ASSUME_ITS_TRUE(marks == 1);
+    fossil::net::WriteQueue moved(std::move(q));
+    ASSUME_ITS_TRUE(q.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.is_above());
+    ASSUME_ITS_TRUE(moved.pending() >= cfg.high_watermark);
+    moved = fossil::net::WriteQueue(&cli);
+    ASSUME_ITS_TRUE(moved.pending() == 0);
+    fossil_net_socket_close(&peer);
+    fossil_net_socket_close(&cli);
+    fossil_net_socket_close(&srv);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_writeq_tests) {
+    FOSSIL_ADD_TEST(cpp_writeq_fixture, cpp_writeq_test_class_roundtrip);
+    FOSSIL_ADD_TEST(cpp_writeq_fixture, cpp_writeq_test_class_move);
+
+    FOSSIL_ADD_SUITE(cpp_writeq_fixture);
+} // end of tests
@@ -0,0 +1,127 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <string.h>
+#include <stdlib.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_zerocopy_fixture);
+
+FOSSIL_SETUP(c_zerocopy_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_zerocopy_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+static int c_zerocopy_pair(fossil_net_socket_t *srv, fossil_net_socket_t *cli, fossil_net_socket_t *peer) {
+    fossil_net_endpoint_t ep;
+    if (fossil_net_socket_create(srv, "tcp", "ipv4") != 0) return -1;
+    if (fossil_net_socket_create(cli, "tcp", "ipv4") != 0) return -1;
+    fossil_net_endpoint_parse(&ep, "127.0.0.1", 0);
+    if (fossil_net_socket_bind_endpoint(srv, &ep) != 0) return -1;
+    if (fossil_net_socket_listen(srv, 1) != 0) return -1;
+    fossil_net_socket_get_local_endpoint(srv, &ep);
+    if (fossil_net_socket_connect_endpoint(cli, &ep) != 0) return -1;
+    return fossil_net_socket_accept_endpoint(srv, peer, NULL);
+}
+
+FOSSIL_TEST(c_zerocopy_test_stream_integrity) {
+    fossil_net_socket_t srv, cli, peer;
+    ASSUME_ITS_TRUE(c_zerocopy_pair(&srv, &cli, &peer) == 0);
+
+    // Several pages plus an unaligned tail; small enough to sit in the buffers
+    const uint32_t total = 3 * 65536 + 123;
+    uint8_t *data = malloc(total);
+    for (uint32_t i = 0; i < total; ++i) data[i] = (uint8_t)(i * 31u + 7u);
+    uint32_t off = 0;
+    while (off < total) {
+        uint32_t sent = 0;
+        ASSUME_ITS_TRUE(fossil_net_socket_send(&cli, data + off, total - off, &sent) == 0);
+        off += sent;
+    }
+    fossil_net_socket_close(&cli);
+
+    fossil_net_zerocopy_t *zc = fossil_net_zerocopy_create(&peer, 0, 0);
+    ASSUME_ITS_TRUE(zc != NULL);
+    uint32_t got = 0;
+    int ok = 1;
+    for (;;) {
+        fossil_net_zerocopy_chunk_t chunk;
+        ASSUME_ITS_TRUE(fossil_net_zerocopy_receive(zc, &chunk) == 0);
+        if (chunk.mapped_len == 0 && chunk.copied_len == 0) break;
+        if (chunk.mapped_len && memcmp(chunk.mapped, data + got, chunk.mapped_len) != 0) ok = 0;
+        got += chunk.mapped_len;
+        if (chunk.copied_len && memcmp(chunk.copied, data + got, chunk.copied_len) != 0) ok = 0;
+        got += chunk.copied_len;
+        if (got > total) break;
+    }
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(got == total);
+
+    fossil_net_zerocopy_stats_t st;
+    ASSUME_ITS_TRUE(fossil_net_zerocopy_get_stats(zc, &st) == 0);
+    ASSUME_ITS_TRUE(st.bytes_mapped + st.bytes_copied == total);
+    if (!fossil_net_zerocopy_is_mapped(zc)) ASSUME_ITS_TRUE(st.bytes_mapped == 0);
+
+    fossil_net_zerocopy_destroy(zc);
+    fossil_net_socket_close(&peer);
+    fossil_net_socket_close(&srv);
+    free(data);
+}
+
+FOSSIL_TEST(c_zerocopy_test_rejects_non_tcp) {
+    fossil_net_socket_t sock;
+    ASSUME_ITS_TRUE(fossil_net_socket_create(&sock, "udp", "ipv4") == 0);
+    ASSUME_ITS_TRUE(fossil_net_zerocopy_create(&sock, 0, 0) == NULL);
+    ASSUME_ITS_TRUE(fossil_net_zerocopy_create(NULL, 0, 0) == NULL);
+    fossil_net_socket_close(&sock);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_zerocopy_tests) {
+    FOSSIL_ADD_TEST(c_zerocopy_fixture, c_zerocopy_test_stream_integrity);
+    FOSSIL_ADD_TEST(c_zerocopy_fixture, c_zerocopy_test_rejects_non_tcp);
+
+    FOSSIL_ADD_SUITE(c_zerocopy_fixture);
+} // end of tests
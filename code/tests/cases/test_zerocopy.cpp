@@ -0,0 +1,74 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/network/framework.h"
+#include <fossil/maip/framework.h>
+#include <utility>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_zerocopy_fixture);
+
+FOSSIL_SETUP(cpp_zerocopy_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_zerocopy_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(cpp_zerocopy_test_class_lifecycle) {
+    fossil::net::Socket sock;
+    ASSUME_ITS_TRUE(sock.socket_create("tcp", "ipv4") == 0);
+    fossil::net::ZeroCopy zc(sock.native_handle(), 4096, 1024);
+    ASSUME_ITS_TRUE(zc.native_handle() != nullptr);
+    fossil_net_zerocopy_stats_t st = zc.stats();
+    ASSUME_ITS_TRUE(st.bytes_mapped == 0 && st.bytes_copied == 0);
+
+    fossil::net::ZeroCopy moved(std::move(zc));
+    ASSUME_ITS_TRUE(zc.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.native_handle() != nullptr);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_zerocopy_tests) {
+    FOSSIL_ADD_TEST(cpp_zerocopy_fixture, cpp_zerocopy_test_class_lifecycle);
+
+    FOSSIL_ADD_SUITE(cpp_zerocopy_fixture);
+} // end of tests